@@ -0,0 +1,214 @@
+/**
+ * @file bench/bench_main.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief frqs_bench entry point: microbenchmarks, load generator, in-process end-to-end run
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "harness.hpp"
+#include "load_generator.hpp"
+#include "frqs-net.hpp"
+#include <charconv>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace {
+
+using namespace frqs;
+
+constexpr std::string_view USAGE = R"(usage:
+  frqs_bench [micro] [--filter=SUBSTR] [--min-time-ms=300] [--repetitions=5]
+      Run the microbenchmarks (request parsing, routing, response building, multipart).
+
+  frqs_bench load [--host=127.0.0.1] [--port=8080] [--path=/] [--connections=16]
+                  [--duration-s=10] [--rate=0] [--close]
+      Load an already running server. --rate=0 is closed loop (max throughput);
+      --rate=N offers N req/s in total and measures from the scheduled send time.
+
+  frqs_bench e2e [--port=18080] [--threads=4] [--reactor] [--reuse-port=0]
+                 [--io-uring] [--connections=16] [--duration-s=5] [--rate=0]
+      Start an in-process server with a small JSON route and load it.
+      --io-uring builds the reactor loops on io_uring (Linux 6.1+).
+)";
+
+/**
+ * @brief `--name=value` / `--flag` arguments
+ */
+class Args {
+public:
+    Args(int argc, char* argv[], int first) {
+        for (int i = first; i < argc; ++i) {
+            args_.emplace_back(argv[i]);
+        }
+    }
+
+    [[nodiscard]] std::optional<std::string_view> get(std::string_view name) const {
+        for (std::string_view arg : args_) {
+            if (!arg.starts_with("--")) continue;
+            arg.remove_prefix(2);
+            if (arg == name) return std::string_view("true");
+            if (arg.starts_with(name) && arg.size() > name.size() && arg[name.size()] == '=') {
+                return arg.substr(name.size() + 1);
+            }
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] std::string string(std::string_view name, std::string_view fallback) const {
+        return std::string(get(name).value_or(fallback));
+    }
+
+    template<typename T>
+    [[nodiscard]] T number(std::string_view name, T fallback) const {
+        auto value = get(name);
+        if (!value) return fallback;
+        T result{};
+        auto [ptr, ec] = std::from_chars(value->data(), value->data() + value->size(), result);
+        return ec == std::errc{} ? result : fallback;
+    }
+
+    [[nodiscard]] bool flag(std::string_view name) const {
+        auto value = get(name);
+        return value && *value != "false" && *value != "0";
+    }
+
+private:
+    std::vector<std::string_view> args_;
+};
+
+bench::LoadOptions loadOptions(const Args& args, uint16_t default_port, int default_seconds) {
+    bench::LoadOptions options;
+    options.host = args.string("host", options.host);
+    options.port = args.number<uint16_t>("port", default_port);
+    options.path = args.string("path", options.path);
+    options.connections = args.number<size_t>("connections", options.connections);
+    options.duration = std::chrono::milliseconds(args.number<int>("duration-s", default_seconds) * 1000);
+    options.rate = args.number<double>("rate", 0.0);
+    options.keep_alive = !args.flag("close");
+    return options;
+}
+
+int runMicro(const Args& args) {
+    bench::MicroOptions options;
+    options.filter = args.string("filter", "");
+    options.min_time = std::chrono::milliseconds(args.number<int>("min-time-ms", 300));
+    options.repetitions = args.number<int>("repetitions", options.repetitions);
+
+    if (bench::runMicro(options) == 0) {
+        std::fprintf(stderr, "no benchmark matches '%s'\n", options.filter.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+int runLoad(const Args& args) {
+    auto options = loadOptions(args, 8080, 10);
+    bench::LoadReport report;
+    bench::runLoad(options, report);
+    bench::printReport(options, report);
+    return report.requests.load() > 0 ? 0 : 1;
+}
+
+int runEndToEnd(const Args& args) {
+    auto options = loadOptions(args, 18080, 5);
+    options.host = "127.0.0.1";
+    if (!args.get("path")) {
+        options.path = "/bench";
+    }
+
+    core::ServerOptions server_options;
+    server_options.reactor = args.flag("reactor");
+    server_options.reuse_port_listeners = args.number<size_t>("reuse-port", 0);
+    server_options.io_uring = args.flag("io-uring");
+
+    core::Server server(options.port, args.number<size_t>("threads", 4));
+    server.setOptions(server_options);
+    server.router().get("/bench", [](core::Context& ctx) {
+        ctx.json(R"({"status":"ok","server":"frqs_bench"})");
+    });
+
+    std::exception_ptr failure;
+    std::thread server_thread([&] {
+        try {
+            server.start();
+        } catch (...) {
+            failure = std::current_exception();
+        }
+    });
+
+    // Wait for the listener
+    for (int i = 0; i < 200 && !server.isRunning() && !failure; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    bench::LoadReport report;
+    if (!failure) {
+        bench::runLoad(options, report);
+    }
+
+    server.stop();
+    server_thread.join();
+
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    std::printf("server      %s%s, %zu threads\n",
+        server_options.reuse_port_listeners > 0
+            ? std::format("{} SO_REUSEPORT loops", server_options.reuse_port_listeners).c_str()
+            : (server_options.reactor ? "reactor" : "blocking"),
+        server_options.io_uring ? " (io_uring requested)" : "",
+        args.number<size_t>("threads", 4));
+    bench::printReport(options, report);
+    return report.requests.load() > 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string_view command = argc > 1 ? argv[1] : "micro";
+    int first = 2;
+    if (command.starts_with("--")) {
+        command = "micro";
+        first = 1;
+    }
+
+    if (command == "help" || command == "-h") {
+        std::fputs(USAGE.data(), stdout);
+        return 0;
+    }
+
+    Args args(argc, argv, first);
+    if (args.flag("help")) {
+        std::fputs(USAGE.data(), stdout);
+        return 0;
+    }
+
+    // Keep the server's own logging out of the numbers
+    utils::LogOptions log_options;
+    log_options.min_level = utils::Level::WARN;
+    utils::configureLogging(log_options);
+
+    try {
+        net::NetworkInit network;
+
+        if (command == "micro") return runMicro(args);
+        if (command == "load") return runLoad(args);
+        if (command == "e2e") return runEndToEnd(args);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "frqs_bench: %s\n", e.what());
+        utils::flushLogs();
+        return 1;
+    }
+
+    std::fputs(USAGE.data(), stderr);
+    return 2;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file bench/harness.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Calibration and reporting for registered microbenchmarks
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "harness.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <format>
+
+namespace frqs::bench {
+
+namespace {
+
+struct Sample {
+    double ns_per_op;
+    uint64_t bytes_per_iteration;
+};
+
+Sample measure(const Benchmark& benchmark, uint64_t iterations) {
+    State state(iterations);
+    benchmark.fn(state);
+    auto elapsed = std::chrono::steady_clock::now() - state.startTime();
+    double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    return {ns / static_cast<double>(iterations), state.bytesPerIteration()};
+}
+
+// Grow the iteration count until one run lasts at least min_time
+uint64_t calibrate(const Benchmark& benchmark, std::chrono::milliseconds min_time) {
+    const double target_ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(min_time).count());
+    uint64_t iterations = 1;
+
+    while (true) {
+        Sample sample = measure(benchmark, iterations);
+        double total_ns = sample.ns_per_op * static_cast<double>(iterations);
+        if (total_ns >= target_ns || iterations >= (uint64_t(1) << 40)) {
+            return iterations;
+        }
+
+        // Aim 20% past the target, but never more than 100x per step
+        double factor = total_ns > 0 ? target_ns * 1.2 / total_ns : 100.0;
+        factor = std::clamp(factor, 2.0, 100.0);
+        iterations = static_cast<uint64_t>(static_cast<double>(iterations) * factor);
+    }
+}
+
+std::string formatTime(double ns) {
+    if (ns < 1e3) return std::format("{:.1f} ns", ns);
+    if (ns < 1e6) return std::format("{:.2f} us", ns / 1e3);
+    if (ns < 1e9) return std::format("{:.2f} ms", ns / 1e6);
+    return std::format("{:.2f} s", ns / 1e9);
+}
+
+} // namespace
+
+std::vector<Benchmark>& registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+size_t runMicro(const MicroOptions& options) {
+    auto benchmarks = registry();
+    std::sort(benchmarks.begin(), benchmarks.end(),
+        [](const Benchmark& a, const Benchmark& b) { return a.name < b.name; });
+
+    std::printf("%-40s %12s %12s %14s %12s\n", "benchmark", "median", "best", "ops/s", "MB/s");
+
+    size_t ran = 0;
+    for (const auto& benchmark : benchmarks) {
+        if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+
+        uint64_t iterations = calibrate(benchmark, options.min_time);
+
+        std::vector<double> runs;
+        uint64_t bytes = 0;
+        for (int i = 0; i < std::max(options.repetitions, 1); ++i) {
+            Sample sample = measure(benchmark, iterations);
+            runs.push_back(sample.ns_per_op);
+            bytes = sample.bytes_per_iteration;
+        }
+        std::sort(runs.begin(), runs.end());
+        double median = runs[runs.size() / 2];
+
+        std::string throughput = bytes > 0
+            ? std::format("{:.1f}", static_cast<double>(bytes) / median * 1e9 / (1024.0 * 1024.0))
+            : std::string("-");
+
+        std::printf("%-40s %12s %12s %14.0f %12s\n",
+            benchmark.name.c_str(),
+            formatTime(median).c_str(),
+            formatTime(runs.front()).c_str(),
+            1e9 / median,
+            throughput.c_str());
+        std::fflush(stdout);
+        ++ran;
+    }
+
+    return ran;
+}
+
+} // namespace frqs::bench
@@ -0,0 +1,115 @@
+#pragma once
+
+/**
+ * @file bench/harness.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Minimal microbenchmark harness for frqs_bench
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * Benchmarks register themselves with FRQS_BENCHMARK and receive a State
+ * holding the iteration count to run. The harness calibrates that count
+ * until a run takes at least the minimum time, repeats the measurement
+ * and reports the median and best ns/op (plus throughput when the
+ * benchmark declares how many bytes one iteration processes).
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace frqs::bench {
+
+/**
+ * @brief Per-run state handed to a benchmark body
+ *
+ * @example
+ * ```cpp
+ * FRQS_BENCHMARK("http/parse", [](bench::State& state) {
+ *     std::string raw = makeRequest();   // Setup, not timed
+ *     state.resetTimer();
+ *     for (uint64_t i = 0; i < state.iterations(); ++i) {
+ *         http::HTTPRequest request;
+ *         bench::doNotOptimize(request.parse(raw));
+ *     }
+ *     state.setBytesPerIteration(raw.size());
+ * });
+ * ```
+ */
+class State {
+public:
+    explicit State(uint64_t iterations) noexcept
+        : iterations_(iterations)
+        , start_(std::chrono::steady_clock::now()) {}
+
+    [[nodiscard]] uint64_t iterations() const noexcept { return iterations_; }
+
+    /// Exclude setup done so far from the measurement
+    void resetTimer() noexcept { start_ = std::chrono::steady_clock::now(); }
+
+    /// Enables MB/s reporting
+    void setBytesPerIteration(uint64_t bytes) noexcept { bytes_per_iteration_ = bytes; }
+
+    [[nodiscard]] std::chrono::steady_clock::time_point startTime() const noexcept { return start_; }
+    [[nodiscard]] uint64_t bytesPerIteration() const noexcept { return bytes_per_iteration_; }
+
+private:
+    uint64_t iterations_;
+    std::chrono::steady_clock::time_point start_;
+    uint64_t bytes_per_iteration_ = 0;
+};
+
+using BenchmarkFn = std::function<void(State&)>;
+
+struct Benchmark {
+    std::string name;
+    BenchmarkFn fn;
+};
+
+[[nodiscard]] std::vector<Benchmark>& registry();
+
+struct Registrar {
+    Registrar(std::string name, BenchmarkFn fn) {
+        registry().push_back({std::move(name), std::move(fn)});
+    }
+};
+
+struct MicroOptions {
+    std::string filter;                                 // Substring of the name; empty runs all
+    std::chrono::milliseconds min_time{300};            // Per measured run
+    int repetitions = 5;
+};
+
+/**
+ * @brief Run every registered benchmark matching the filter
+ * @return Number of benchmarks run
+ */
+size_t runMicro(const MicroOptions& options);
+
+/**
+ * @brief Keep the compiler from discarding a computed value
+ */
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+} // namespace frqs::bench
+
+#define FRQS_BENCH_CONCAT_INNER(a, b) a##b
+#define FRQS_BENCH_CONCAT(a, b) FRQS_BENCH_CONCAT_INNER(a, b)
+
+/// Register a benchmark: FRQS_BENCHMARK("group/name", [](frqs::bench::State& state) { ... });
+#define FRQS_BENCHMARK(name, ...) \
+    static ::frqs::bench::Registrar FRQS_BENCH_CONCAT(frqs_bench_registrar_, __LINE__){name, __VA_ARGS__}
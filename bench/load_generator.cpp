@@ -0,0 +1,311 @@
+/**
+ * @file bench/load_generator.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Closed-loop / open-loop HTTP/1.1 load generator
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "load_generator.hpp"
+#include "net/socket.hpp"
+#include "net/sockaddr.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <format>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace frqs::bench {
+
+namespace {
+
+constexpr int IO_TIMEOUT_MS = 5000;
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+/**
+ * @brief One client connection issuing requests back to back
+ */
+class Client {
+public:
+    Client(const LoadOptions& options, LoadReport& report)
+        : addr_(net::IPv4(std::string_view(options.host)), options.port)
+        , report_(report)
+    {
+        request_ = std::format("GET {} HTTP/1.1\r\nHost: {}:{}\r\nUser-Agent: frqs_bench\r\n{}\r\n",
+            options.path, options.host, options.port,
+            options.keep_alive ? "" : "Connection: close\r\n");
+    }
+
+    /**
+     * @brief Send one request and read the full response
+     * @return Status code, or nullopt on a connection / framing error
+     */
+    std::optional<int> roundTrip() {
+        try {
+            if (!socket_) {
+                socket_.emplace();
+                socket_->connect(addr_);
+                report_.connects.fetch_add(1, std::memory_order_relaxed);
+                buffer_.clear();
+            }
+
+            socket_->sendAll(request_);
+            auto status = readResponse();
+            if (!status || close_after_) {
+                socket_.reset();
+            }
+            return status;
+        } catch (const std::exception&) {
+            socket_.reset();
+            return std::nullopt;
+        }
+    }
+
+private:
+    net::SockAddr addr_;
+    LoadReport& report_;
+    std::string request_;
+    std::optional<net::Socket> socket_;
+    std::string buffer_;
+    bool close_after_ = false;
+
+    // Append at least one more byte to buffer_; false on EOF or timeout
+    bool fill() {
+        if (!socket_->waitReadable(IO_TIMEOUT_MS)) {
+            return false;
+        }
+        char chunk[16384];
+        size_t n = socket_->receive(chunk, sizeof(chunk));
+        if (n == 0) {
+            return false;
+        }
+        report_.bytes_received.fetch_add(n, std::memory_order_relaxed);
+        buffer_.append(chunk, n);
+        return true;
+    }
+
+    // Make buffer_ hold at least `size` bytes
+    bool fillTo(size_t size) {
+        while (buffer_.size() < size) {
+            if (!fill()) return false;
+        }
+        return true;
+    }
+
+    std::optional<int> readResponse() {
+        size_t header_end;
+        while ((header_end = buffer_.find("\r\n\r\n")) == std::string::npos) {
+            if (!fill()) return std::nullopt;
+        }
+
+        std::string_view head(buffer_.data(), header_end);
+        // "HTTP/1.1 200 OK"
+        if (head.size() < 12 || !head.starts_with("HTTP/1.")) {
+            return std::nullopt;
+        }
+        int status = 0;
+        std::from_chars(head.data() + 9, head.data() + 12, status);
+
+        std::optional<size_t> content_length;
+        bool chunked = false;
+        close_after_ = head.starts_with("HTTP/1.0");
+
+        size_t line_start = head.find("\r\n");
+        while (line_start != std::string_view::npos && line_start + 2 < head.size()) {
+            size_t line_end = head.find("\r\n", line_start + 2);
+            std::string_view line = head.substr(line_start + 2,
+                line_end == std::string_view::npos ? std::string_view::npos : line_end - line_start - 2);
+            line_start = line_end;
+
+            size_t colon = line.find(':');
+            if (colon == std::string_view::npos) continue;
+            std::string_view name = line.substr(0, colon);
+            std::string_view value = trim(line.substr(colon + 1));
+
+            if (equalsIgnoreCase(name, "Content-Length")) {
+                size_t length = 0;
+                std::from_chars(value.data(), value.data() + value.size(), length);
+                content_length = length;
+            } else if (equalsIgnoreCase(name, "Transfer-Encoding")) {
+                chunked = equalsIgnoreCase(value, "chunked");
+            } else if (equalsIgnoreCase(name, "Connection")) {
+                close_after_ = equalsIgnoreCase(value, "close");
+            }
+        }
+
+        size_t body_start = header_end + 4;
+        bool no_body = (status >= 100 && status < 200) || status == 204 || status == 304;
+
+        if (no_body) {
+            buffer_.erase(0, body_start);
+        } else if (chunked) {
+            if (!skipChunked(body_start)) return std::nullopt;
+        } else if (content_length) {
+            if (!fillTo(body_start + *content_length)) return std::nullopt;
+            buffer_.erase(0, body_start + *content_length);
+        } else {
+            // Delimited by close
+            while (fill()) {}
+            buffer_.clear();
+            close_after_ = true;
+        }
+
+        return status;
+    }
+
+    bool skipChunked(size_t pos) {
+        while (true) {
+            size_t line_end;
+            while ((line_end = buffer_.find("\r\n", pos)) == std::string::npos) {
+                if (!fill()) return false;
+            }
+
+            size_t size = 0;
+            auto [ptr, ec] = std::from_chars(buffer_.data() + pos, buffer_.data() + line_end, size, 16);
+            if (ec != std::errc{}) return false;
+            pos = line_end + 2;
+
+            if (size == 0) {
+                // Trailers end with an empty line
+                size_t end;
+                while ((end = buffer_.find("\r\n", pos)) == std::string::npos || end != pos) {
+                    if (end != std::string::npos) {
+                        pos = end + 2;
+                        continue;
+                    }
+                    if (!fill()) return false;
+                }
+                buffer_.erase(0, pos + 2);
+                return true;
+            }
+
+            if (!fillTo(pos + size + 2)) return false;
+            pos += size + 2;
+        }
+    }
+};
+
+void connectionLoop(const LoadOptions& options, LoadReport& report, size_t index,
+                    std::chrono::steady_clock::time_point start,
+                    std::chrono::steady_clock::time_point deadline) {
+    using clock = std::chrono::steady_clock;
+    Client client(options, report);
+
+    // Open loop: this connection's share of the rate, phase-shifted so
+    // connections do not fire in lockstep
+    std::optional<clock::duration> interval;
+    clock::time_point next_send = start;
+    if (options.rate > 0) {
+        double seconds = static_cast<double>(options.connections) / options.rate;
+        interval = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(seconds));
+        next_send += *interval * static_cast<int64_t>(index) / static_cast<int64_t>(options.connections);
+    }
+
+    while (true) {
+        clock::time_point issued;
+        if (interval) {
+            if (next_send >= deadline) break;
+            std::this_thread::sleep_until(next_send);
+            issued = next_send;
+            next_send += *interval;
+        } else {
+            issued = clock::now();
+            if (issued >= deadline) break;
+        }
+
+        auto status = client.roundTrip();
+        auto micros = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - issued).count();
+
+        if (!status) {
+            report.errors.fetch_add(1, std::memory_order_relaxed);
+            if (!interval) {
+                // Do not spin on a refused port
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            continue;
+        }
+
+        report.requests.fetch_add(1, std::memory_order_relaxed);
+        if (*status < 200 || *status >= 300) {
+            report.non_2xx.fetch_add(1, std::memory_order_relaxed);
+        }
+        report.latency.record(static_cast<uint64_t>(std::max<int64_t>(micros, 0)));
+    }
+}
+
+std::string formatMicros(uint64_t micros) {
+    if (micros < 1000) return std::format("{}us", micros);
+    if (micros < 1000000) return std::format("{:.2f}ms", static_cast<double>(micros) / 1e3);
+    return std::format("{:.2f}s", static_cast<double>(micros) / 1e6);
+}
+
+} // namespace
+
+void runLoad(const LoadOptions& options, LoadReport& report) {
+    using clock = std::chrono::steady_clock;
+    size_t connections = std::max<size_t>(options.connections, 1);
+
+    auto start = clock::now();
+    auto deadline = start + options.duration;
+
+    std::vector<std::thread> threads;
+    threads.reserve(connections);
+    for (size_t i = 0; i < connections; ++i) {
+        threads.emplace_back([&, i] { connectionLoop(options, report, i, start, deadline); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    report.elapsed_seconds = std::chrono::duration<double>(clock::now() - start).count();
+}
+
+void printReport(const LoadOptions& options, const LoadReport& report) {
+    uint64_t requests = report.requests.load();
+    double seconds = std::max(report.elapsed_seconds, 1e-9);
+
+    std::printf("target      http://%s:%u%s\n", options.host.c_str(), options.port, options.path.c_str());
+    std::printf("mode        %s, %zu connections, %.1fs\n",
+        options.rate > 0 ? std::format("open loop @ {:.0f} req/s", options.rate).c_str() : "closed loop",
+        options.connections, seconds);
+    std::printf("requests    %llu (%llu non-2xx, %llu errors, %llu connects)\n",
+        static_cast<unsigned long long>(requests),
+        static_cast<unsigned long long>(report.non_2xx.load()),
+        static_cast<unsigned long long>(report.errors.load()),
+        static_cast<unsigned long long>(report.connects.load()));
+    std::printf("throughput  %.0f req/s, %.2f MB/s received\n",
+        static_cast<double>(requests) / seconds,
+        static_cast<double>(report.bytes_received.load()) / seconds / (1024.0 * 1024.0));
+
+    if (report.latency.count() == 0) {
+        return;
+    }
+
+    // Bucket upper bounds: within 12.5% of the true value
+    std::printf("latency     mean %s  p50 %s  p90 %s  p99 %s  p999 %s  max %s\n",
+        formatMicros(report.latency.sumMicros() / report.latency.count()).c_str(),
+        formatMicros(report.latency.percentile(0.50)).c_str(),
+        formatMicros(report.latency.percentile(0.90)).c_str(),
+        formatMicros(report.latency.percentile(0.99)).c_str(),
+        formatMicros(report.latency.percentile(0.999)).c_str(),
+        formatMicros(report.latency.percentile(1.0)).c_str());
+}
+
+} // namespace frqs::bench
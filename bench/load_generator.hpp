@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+ * @file bench/load_generator.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Closed-loop / open-loop HTTP/1.1 load generator
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * Closed loop (rate = 0): every connection sends its next request as soon
+ * as the previous response arrives, which measures peak throughput.
+ *
+ * Open loop (rate > 0): requests are scheduled at a fixed aggregate rate
+ * and latency is taken from the *scheduled* send time, so a stalled
+ * server shows up as queueing delay instead of silently lowering the
+ * offered load (coordinated omission).
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "utils/metrics.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace frqs::bench {
+
+struct LoadOptions {
+    std::string host = "127.0.0.1";             // IPv4 literal
+    uint16_t port = 8080;
+    std::string path = "/";
+    size_t connections = 16;
+    std::chrono::milliseconds duration{10000};
+    double rate = 0;                            // Requests/s over all connections; 0 = closed loop
+    bool keep_alive = true;
+};
+
+struct LoadReport {
+    std::atomic<uint64_t> requests{0};          // Completed with any status
+    std::atomic<uint64_t> non_2xx{0};
+    std::atomic<uint64_t> errors{0};            // Connect/IO/framing failures
+    std::atomic<uint64_t> connects{0};
+    std::atomic<uint64_t> bytes_received{0};
+    double elapsed_seconds = 0;
+    utils::Histogram latency;                   // Microseconds
+};
+
+/**
+ * @brief Drive the target with one thread per connection until the duration ends
+ */
+void runLoad(const LoadOptions& options, LoadReport& report);
+
+/**
+ * @brief Print throughput and p50/p90/p99/p999 latency
+ */
+void printReport(const LoadOptions& options, const LoadReport& report);
+
+} // namespace frqs::bench
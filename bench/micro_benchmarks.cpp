@@ -0,0 +1,570 @@
+/**
+ * @file bench/micro_benchmarks.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Microbenchmarks for the request hot path
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * Inputs are shaped like real traffic: browser-style header sets, a
+ * route table in the hundreds, multi-megabyte multipart uploads.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "harness.hpp"
+#include "core/router.hpp"
+#include "http/hpack.hpp"
+#include "http/mime_types.hpp"
+#include "http/multipart_parser.hpp"
+#include "http/request.hpp"
+#include "http/request_parser.hpp"
+#include "http/response.hpp"
+#include "http/status.hpp"
+#include "net/ip_filter.hpp"
+#include "utils/arena.hpp"
+#include "utils/timer_wheel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace frqs::bench {
+
+namespace {
+
+// ========== INPUTS ==========
+
+constexpr std::string_view MINIMAL_REQUEST =
+    "GET / HTTP/1.1\r\n"
+    "Host: localhost\r\n"
+    "\r\n";
+
+// What a desktop browser sends for a same-origin XHR
+constexpr std::string_view BROWSER_REQUEST =
+    "GET /api/v1/users/12345/posts?page=2&sort=desc&filter=published HTTP/1.1\r\n"
+    "Host: app.example.com\r\n"
+    "Connection: keep-alive\r\n"
+    "sec-ch-ua: \"Chromium\";v=\"124\", \"Google Chrome\";v=\"124\", \"Not-A.Brand\";v=\"99\"\r\n"
+    "Accept: application/json, text/plain, */*\r\n"
+    "sec-ch-ua-mobile: ?0\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/124.0.0.0 Safari/537.36\r\n"
+    "sec-ch-ua-platform: \"Linux\"\r\n"
+    "Sec-Fetch-Site: same-origin\r\n"
+    "Sec-Fetch-Mode: cors\r\n"
+    "Sec-Fetch-Dest: empty\r\n"
+    "Referer: https://app.example.com/dashboard\r\n"
+    "Accept-Encoding: gzip, deflate, br, zstd\r\n"
+    "Accept-Language: en-US,en;q=0.9,id;q=0.8\r\n"
+    "Cookie: session=9f8e7d6c5b4a39281706f5e4d3c2b1a0; theme=dark; _ga=GA1.1.123456789.1700000000\r\n"
+    "If-None-Match: \"5d8c72a5edda8d6a\"\r\n"
+    "\r\n";
+
+std::string manyHeadersRequest(size_t count) {
+    std::string raw = "GET /search?q=frqs HTTP/1.1\r\nHost: localhost\r\n";
+    for (size_t i = 0; i < count; ++i) {
+        raw += std::format("X-Custom-Header-{}: value-{}-with-some-padding-to-look-real\r\n", i, i * 7919);
+    }
+    raw += "\r\n";
+    return raw;
+}
+
+struct MultipartBody {
+    std::string boundary = "----FrqsBenchBoundary7MA4YWxkTrZu0gW";
+    std::string body;
+};
+
+MultipartBody multipartBody(size_t files, size_t file_size) {
+    MultipartBody out;
+    for (int i = 0; i < 3; ++i) {
+        out.body += std::format(
+            "--{}\r\nContent-Disposition: form-data; name=\"field{}\"\r\n\r\nvalue {}\r\n",
+            out.boundary, i, i);
+    }
+    
+    std::string payload(file_size, '\0');
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<char>((i * 131 + 7) & 0xFF);  // Binary, boundary-free
+    }
+    
+    for (size_t i = 0; i < files; ++i) {
+        out.body += std::format(
+            "--{}\r\nContent-Disposition: form-data; name=\"upload{}\"; filename=\"file{}.bin\"\r\n"
+            "Content-Type: application/octet-stream\r\n\r\n",
+            out.boundary, i, i);
+        out.body += payload;
+        out.body += "\r\n";
+    }
+    out.body += std::format("--{}--\r\n", out.boundary);
+    return out;
+}
+
+// About 300 routes in the shape of a REST API plus a static catch-all
+std::unique_ptr<core::Router> routeTable() {
+    auto router = std::make_unique<core::Router>();
+    auto handler = [](core::Context& ctx) { ctx.response().setStatus(200); };
+    
+    constexpr std::string_view resources[] = {
+        "users", "posts", "comments", "orders", "products", "invoices", "carts", "reviews",
+        "sessions", "teams", "projects", "tasks", "files", "events", "alerts", "reports",
+        "tags", "groups", "roles", "tokens", "devices", "webhooks", "payments", "shipments",
+        "coupons", "articles", "pages", "menus", "settings", "logs"
+    };
+    
+    for (auto resource : resources) {
+        auto base = std::format("/api/v1/{}", resource);
+        router->get(base, handler);
+        router->post(base, handler);
+        router->get(base + "/search", handler);
+        router->get(base + "/:id", handler);
+        router->put(base + "/:id", handler);
+        router->del(base + "/:id", handler);
+        router->get(base + "/:id/history", handler);
+        router->get(base + "/:id/children/:child", handler);
+        router->patch(base + "/:id", handler);
+        router->get(std::format("/admin/{}", resource), handler);
+    }
+    router->get("/*", handler);
+    return router;
+}
+
+http::HTTPRequest parsedRequest(std::string_view raw) {
+    http::HTTPRequest request;
+    (void)request.parse(raw);
+    return request;
+}
+
+// ========== REQUEST PARSING ==========
+
+void parseOnce(State& state, std::string_view raw) {
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        http::HTTPRequest request;
+        doNotOptimize(request.parse(raw));
+        doNotOptimize(request);
+    }
+    state.setBytesPerIteration(raw.size());
+}
+
+FRQS_BENCHMARK("http/parse_minimal", [](State& state) {
+    parseOnce(state, MINIMAL_REQUEST);
+});
+
+FRQS_BENCHMARK("http/parse_browser", [](State& state) {
+    parseOnce(state, BROWSER_REQUEST);
+});
+
+FRQS_BENCHMARK("http/parse_64_headers", [](State& state) {
+    static const std::string raw = manyHeadersRequest(64);
+    parseOnce(state, raw);
+});
+
+// The server's path: a long-lived parser, reset between requests
+FRQS_BENCHMARK("http/parser_incremental_browser", [](State& state) {
+    http::RequestParser parser;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        parser.reset();
+        doNotOptimize(parser.feed(BROWSER_REQUEST));
+        doNotOptimize(parser.request());
+    }
+    state.setBytesPerIteration(BROWSER_REQUEST.size());
+});
+
+// Same request split across three reads, as a slow client would send it
+FRQS_BENCHMARK("http/parser_incremental_split", [](State& state) {
+    http::RequestParser parser;
+    constexpr size_t cut1 = 37, cut2 = 412;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        parser.reset();
+        (void)parser.feed(BROWSER_REQUEST.substr(0, cut1));
+        (void)parser.feed(BROWSER_REQUEST.substr(cut1, cut2 - cut1));
+        doNotOptimize(parser.feed(BROWSER_REQUEST.substr(cut2)));
+    }
+    state.setBytesPerIteration(BROWSER_REQUEST.size());
+});
+
+FRQS_BENCHMARK("http/parser_pipelined_16", [](State& state) {
+    std::string batch;
+    for (int i = 0; i < 16; ++i) {
+        batch += BROWSER_REQUEST;
+    }
+    http::RequestParser parser;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        parser.reset();
+        auto status = parser.feed(batch);
+        while (status == http::ParseStatus::Complete) {
+            doNotOptimize(parser.request());
+            status = parser.next();
+        }
+    }
+    state.setBytesPerIteration(batch.size());
+});
+
+// Upload received the way the server does it: recv() into prepare() space
+FRQS_BENCHMARK("http/parser_upload_512k", [](State& state) {
+    static const std::string raw = [] {
+        std::string body(512 * 1024, 'u');
+        return std::format("POST /upload HTTP/1.1\r\nHost: localhost\r\nContent-Type: application/octet-stream\r\n"
+                           "Content-Length: {}\r\n\r\n", body.size()) + body;
+    }();
+    constexpr size_t segment = 16 * 1024;
+    
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        http::RequestParser parser;    // Fresh connection: the buffer grows from empty
+        for (size_t offset = 0; offset < raw.size();) {
+            auto space = parser.prepare(4096);
+            size_t n = std::min({segment, space.size(), raw.size() - offset});
+            std::memcpy(space.data(), raw.data() + offset, n);
+            parser.commit(n);
+            offset += n;
+        }
+        doNotOptimize(parser.request().getBody().size());
+    }
+    state.setBytesPerIteration(raw.size());
+});
+
+// ========== ROUTING ==========
+
+void routeOnce(State& state, std::string_view raw) {
+    static const auto router = routeTable();
+    const http::HTTPRequest request = parsedRequest(raw);
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        http::HTTPResponse response;
+        core::Context ctx(request, response);
+        doNotOptimize(router->route(ctx));
+    }
+}
+
+FRQS_BENCHMARK("router/static_300", [](State& state) {
+    routeOnce(state, "GET /api/v1/payments/search HTTP/1.1\r\nHost: x\r\n\r\n");
+});
+
+FRQS_BENCHMARK("router/params_300", [](State& state) {
+    routeOnce(state, "GET /api/v1/projects/8812/children/77 HTTP/1.1\r\nHost: x\r\n\r\n");
+});
+
+FRQS_BENCHMARK("router/wildcard_fallback_300", [](State& state) {
+    routeOnce(state, "GET /assets/js/app.5d8c72a5.js HTTP/1.1\r\nHost: x\r\n\r\n");
+});
+
+FRQS_BENCHMARK("router/method_miss_300", [](State& state) {
+    routeOnce(state, "DELETE /admin/users HTTP/1.1\r\nHost: x\r\n\r\n");
+});
+
+// Six pass-through middlewares in front of a trivial handler
+FRQS_BENCHMARK("core/pipeline_6_middlewares", [](State& state) {
+    std::vector<core::Middleware> stages;
+    for (int i = 0; i < 6; ++i) {
+        stages.push_back([](core::Context& ctx, core::Next next) {
+            doNotOptimize(ctx.route());
+            next();
+        });
+    }
+    const core::Pipeline pipeline(std::move(stages), [](core::Context& ctx) { ctx.status(200); });
+    const http::HTTPRequest request = parsedRequest("GET / HTTP/1.1\r\nHost: x\r\n\r\n");
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        http::HTTPResponse response;
+        core::Context ctx(request, response);
+        pipeline.run(ctx);
+        doNotOptimize(response.getStatus());
+    }
+});
+
+// The same chain as coroutines: one frame per stage, none of them suspends
+FRQS_BENCHMARK("core/pipeline_6_async_middlewares", [](State& state) {
+    std::vector<core::PipelineStage> stages;
+    for (int i = 0; i < 6; ++i) {
+        stages.push_back(core::AsyncMiddleware([](core::Context& ctx, core::AsyncNext next) -> coro::Task<> {
+            doNotOptimize(ctx.route());
+            co_await next();
+        }));
+    }
+    const core::Pipeline pipeline(std::move(stages),
+        core::AsyncHandler([](core::Context& ctx) -> coro::Task<> { ctx.status(200); co_return; }));
+    const http::HTTPRequest request = parsedRequest("GET / HTTP/1.1\r\nHost: x\r\n\r\n");
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        http::HTTPResponse response;
+        core::Context ctx(request, response);
+        coro::spawn(pipeline.runAsync(ctx), [](std::exception_ptr) {});
+        doNotOptimize(response.getStatus());
+    }
+});
+
+// ========== RESPONSE BUILDING ==========
+
+FRQS_BENCHMARK("http/response_build_json", [](State& state) {
+    const std::string body = R"({"status":"healthy","version":"2.0.0"})";
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        http::HTTPResponse response;
+        response.setStatus(200)
+            .setContentType("application/json")
+            .setBody(body);
+        doNotOptimize(response.build());
+    }
+});
+
+FRQS_BENCHMARK("http/response_build_static_4k", [](State& state) {
+    const std::string body(4096, 'x');
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        http::HTTPResponse response;
+        response.setStatus(200)
+            .setContentType("text/css")
+            .setHeader("Cache-Control", "public, max-age=3600")
+            .setHeader("ETag", "\"5d8c72a5edda8d6a-1000\"")
+            .setHeader("Last-Modified", "Mon, 15 Dec 2025 08:00:00 GMT")
+            .setHeader("Vary", "Accept-Encoding")
+            .setHeader("X-Content-Type-Options", "nosniff")
+            .setHeader("X-Frame-Options", "DENY")
+            .setHeader("Referrer-Policy", "strict-origin-when-cross-origin")
+            .setBody(body);
+        doNotOptimize(response.build());
+    }
+    state.setBytesPerIteration(body.size());
+});
+
+// Headers only, into a reused buffer (what the server does)
+FRQS_BENCHMARK("http/response_serialize_headers", [](State& state) {
+    http::HTTPResponse response;
+    response.setStatus(200)
+        .setContentType("application/json")
+        .setHeader("Cache-Control", "no-store")
+        .setHeader("X-Request-Id", "7c9e6679-7425-40de-944b-e07fc1f90ae7")
+        .setBody(std::string(512, 'x'));
+    std::string out;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        out.clear();
+        response.serializeHeaders(out);
+        doNotOptimize(out);
+    }
+});
+
+// Handler-side allocations of a typical request: response headers,
+// string-keyed context state
+void requestScratch(State& state, utils::Arena* arena) {
+    static const http::HTTPRequest request = parsedRequest("GET /api/v1/users/42 HTTP/1.1\r\nHost: x\r\n\r\n");
+    std::pmr::memory_resource* resource = arena ? arena : std::pmr::get_default_resource();
+    std::string out;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        if (arena) {
+            arena->reset();
+        }
+        http::HTTPResponse response(resource);
+        core::Context ctx(request, response, resource);
+        ctx.set("session_user", std::string_view("alice"));
+        ctx.set("request_started_at", i);
+        ctx.status(200)
+           .header("Content-Type", "application/json")
+           .header("Cache-Control", "private, max-age=0, no-cache")
+           .header("X-Request-Id", "7c9e6679-7425-40de-944b-e07fc1f90ae7")
+           .header("Strict-Transport-Security", "max-age=63072000; includeSubDomains")
+           .header("Content-Security-Policy", "default-src 'self'; frame-ancestors 'none'")
+           .header("Connection", "keep-alive")
+           .header("Keep-Alive", "timeout=5")
+           .body(R"({"id":42,"name":"alice"})");
+        out.clear();
+        response.serializeHeaders(out);
+        doNotOptimize(out);
+    }
+}
+
+FRQS_BENCHMARK("core/request_scratch_heap", [](State& state) {
+    requestScratch(state, nullptr);
+});
+
+FRQS_BENCHMARK("core/request_scratch_arena", [](State& state) {
+    utils::Arena arena;
+    requestScratch(state, &arena);
+});
+
+// ========== MULTIPART ==========
+
+void multipartOnce(State& state, const MultipartBody& input) {
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        http::MultipartParser parser;
+        doNotOptimize(parser.parse(input.body, input.boundary));
+        doNotOptimize(parser.getParts());
+    }
+    state.setBytesPerIteration(input.body.size());
+}
+
+FRQS_BENCHMARK("multipart/1_file_1mb", [](State& state) {
+    static const MultipartBody input = multipartBody(1, 1024 * 1024);
+    multipartOnce(state, input);
+});
+
+FRQS_BENCHMARK("multipart/16_files_64k", [](State& state) {
+    static const MultipartBody input = multipartBody(16, 64 * 1024);
+    multipartOnce(state, input);
+});
+
+FRQS_BENCHMARK("multipart/1_file_8mb", [](State& state) {
+    static const MultipartBody input = multipartBody(1, 8 * 1024 * 1024);
+    multipartOnce(state, input);
+});
+
+// Streaming parser fed in receive-sized pieces; the sink only counts bytes
+FRQS_BENCHMARK("multipart/stream_8mb_16k_feeds", [](State& state) {
+    static const MultipartBody input = multipartBody(1, 8 * 1024 * 1024);
+    constexpr size_t segment = 16 * 1024;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        size_t received = 0;
+        http::MultipartStreamParser parser(input.boundary, [&received](const http::MultipartPart&) {
+            return http::PartSink([&received](std::string_view data, bool) {
+                received += data.size();
+                return true;
+            });
+        });
+        std::string_view body = input.body;
+        for (size_t offset = 0; offset < body.size(); offset += segment) {
+            parser.feed(body.substr(offset, segment));
+        }
+        doNotOptimize(received);
+    }
+    state.setBytesPerIteration(input.body.size());
+});
+
+// ========== HTTP/2 ==========
+
+// RFC 7541 appendix C.3 / C.4: three requests on one connection, without
+// and with Huffman coding. After each the dynamic table holds 57, 110 and
+// 164 bytes.
+constexpr std::string_view HPACK_C3[] = {
+    std::string_view("\x82\x86\x84\x41\x0f\x77\x77\x77\x2e\x65\x78\x61\x6d\x70\x6c\x65\x2e\x63\x6f\x6d", 20),
+    std::string_view("\x82\x86\x84\xbe\x58\x08\x6e\x6f\x2d\x63\x61\x63\x68\x65", 14),
+    std::string_view("\x82\x87\x85\xbf\x40\x0a\x63\x75\x73\x74\x6f\x6d\x2d\x6b\x65\x79\x0c\x63\x75\x73\x74\x6f\x6d\x2d\x76\x61\x6c\x75\x65", 29)
+};
+
+constexpr std::string_view HPACK_C4[] = {
+    std::string_view("\x82\x86\x84\x41\x8c\xf1\xe3\xc2\xe5\xf2\x3a\x6b\xa0\xab\x90\xf4\xff", 17),
+    std::string_view("\x82\x86\x84\xbe\x58\x86\xa8\xeb\x10\x64\x9c\xbf", 12),
+    std::string_view("\x82\x87\x85\xbf\x40\x88\x25\xa8\x49\xe9\x5b\xa9\x7d\x7f\x89\x25\xa8\x49\xe9\x5b\xb8\xe8\xb4\xbf", 24)
+};
+
+constexpr size_t HPACK_TABLE_SIZES[] = {57, 110, 164};
+
+// Decoding the examples must leave the table sizes the RFC lists, or the
+// peer and we disagree on which entries still exist
+void checkHpackExamples() {
+    for (const auto* blocks : {HPACK_C3, HPACK_C4}) {
+        http::hpack::Decoder decoder;
+        std::string bytes;
+        std::vector<http::hpack::Field> fields;
+        for (size_t i = 0; i < 3; ++i) {
+            auto result = decoder.decode(blocks[i], bytes, fields, 64 * 1024);
+            if (result != http::hpack::Decoder::Result::Ok || decoder.table().size() != HPACK_TABLE_SIZES[i]) {
+                throw std::runtime_error(std::format("HPACK: RFC 7541 example {} left a {}-byte table, expected {}",
+                                                     i + 1, decoder.table().size(), HPACK_TABLE_SIZES[i]));
+            }
+        }
+    }
+}
+
+FRQS_BENCHMARK("http2/hpack_decode_rfc7541_c4", [](State& state) {
+    checkHpackExamples();
+    std::string bytes;
+    std::vector<http::hpack::Field> fields;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        http::hpack::Decoder decoder;
+        for (auto block : HPACK_C4) {
+            bytes.clear();
+            fields.clear();
+            doNotOptimize(decoder.decode(block, bytes, fields, 64 * 1024));
+        }
+    }
+});
+
+// ========== PROTOCOL TABLES ==========
+
+FRQS_BENCHMARK("http/mime_from_path", [](State& state) {
+    const std::vector<std::filesystem::path> paths = {
+        "/var/www/html/index.html", "/var/www/html/assets/app.3f9a1c.js",
+        "/var/www/html/assets/site.css", "/var/www/html/img/Logo.PNG",
+        "/var/www/html/fonts/inter.woff2", "/var/www/html/media/intro.mp4",
+        "/var/www/html/data/report.json", "/var/www/html/LICENSE"
+    };
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        doNotOptimize(http::MimeTypes::fromPath(paths[i & 7]));
+    }
+});
+
+FRQS_BENCHMARK("http/method_and_status_lookup", [](State& state) {
+    const std::string_view methods[] = {"GET", "POST", "HEAD", "OPTIONS", "PUT", "DELETE", "PATCH", "BREW"};
+    const uint16_t codes[] = {200, 304, 404, 206, 500, 101, 418, 503};
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        doNotOptimize(http::parseMethod(methods[i & 7]));
+        doNotOptimize(http::statusLine(codes[i & 7]));
+    }
+});
+
+// ========== CONNECTION FILTER ==========
+
+// 1000 nested and disjoint blocks, as a deny list plus allow holes would be
+FRQS_BENCHMARK("net/ip_filter_admit_1k_rules", [](State& state) {
+    std::string rules;
+    for (uint32_t i = 0; i < 500; ++i) {
+        rules += std::format("deny {}.{}.0.0/16\n", 10 + i / 256, i % 256);
+        rules += std::format("allow {}.{}.{}.0/24\n", 10 + i / 256, i % 256, i % 200);
+    }
+    net::IpFilter filter(net::IpRuleSet::parse(rules));
+    
+    std::vector<net::IPv4> clients;
+    for (uint32_t i = 0; i < 1024; ++i) {
+        clients.emplace_back((10u << 24) + i * 2654435761u % (4u << 24));
+    }
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        doNotOptimize(filter.admit(clients[i & 1023]));
+    }
+});
+
+// ========== TIMERS ==========
+
+// Keep-alive churn: 10k connections each re-arm their timeout per request
+// while the wheel is advanced a tick at a time
+FRQS_BENCHMARK("utils/timer_wheel_rearm_10k", [](State& state) {
+    using clock = utils::TimerWheel::clock;
+    auto start = clock::now();
+    utils::TimerWheel wheel(std::chrono::milliseconds(1), start);
+    std::vector<utils::TimerWheel::Timer> timers(10'000);
+    for (size_t i = 0; i < timers.size(); ++i) {
+        wheel.schedule(timers[i], start + std::chrono::milliseconds(5000 + i % 1000));
+    }
+    
+    auto now = start;
+    size_t fired = 0;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        wheel.schedule(timers[(i * 7919) % timers.size()], now + std::chrono::milliseconds(5000));
+        if ((i & 63) == 0) {
+            now += std::chrono::milliseconds(1);
+            wheel.advance(now, [&fired](utils::TimerWheel::Timer&) { ++fired; });
+        }
+    }
+    doNotOptimize(fired);
+    wheel.clear();
+});
+
+} // namespace
+
+} // namespace frqs::bench
@@ -0,0 +1,138 @@
+#pragma once
+
+/**
+ * @file core/admission.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Overload protection: adaptive concurrency limit and load shedding
+ * @version 1.1.1
+ * @date 2025-12-15
+ * @copyright Copyright (c) 2025
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace frqs::core {
+
+/**
+ * @brief Admission control settings (ServerOptions::admission)
+ *
+ * Applies to the worker pool (blocking and single-reactor modes).
+ */
+struct AdmissionOptions {
+    bool enabled = false;
+    
+    /// Tasks waiting for a worker before new connections get the canned 503
+    /// straight from the accept loop. At twice this many the server stops
+    /// accepting until the queue is back under max_queue.
+    size_t max_queue = 1024;
+    
+    /// Bounds of the adaptive limit on tasks in flight (queued + running).
+    /// 0 = the worker count / the worker count plus max_queue.
+    size_t min_limit = 0;
+    size_t max_limit = 0;
+    
+    /// Queue time the limit steers towards (milliseconds)
+    int target_queue_ms = 10;
+    
+    /// Multiplicative decrease applied when the queue time overshoots
+    double backoff = 0.9;
+    
+    /// Never shed; a trailing '*' matches a prefix
+    std::vector<std::string> priority_paths{"/api/health", "/metrics"};
+    
+    /// Retry-After of the canned 503 (seconds)
+    int retry_after_s = 1;
+};
+
+/**
+ * @brief AIMD concurrency limiter driven by measured queue time
+ *
+ * The server counts every task it hands to the worker pool as in flight
+ * until the task returns. Each request reports how long its task waited
+ * for a worker; every WINDOW the limit is lowered by `backoff` if even the
+ * shortest wait in the window exceeded the target (a standing queue, as
+ * opposed to a burst), and raised by one if the window reached the limit.
+ * A request that arrives while more tasks are in flight than the limit
+ * allows is answered with the canned 503 instead of running its handler,
+ * unless its path is a priority path. The worker queue itself is bounded
+ * by max_queue, checked by the accept loops. A connection shed there is
+ * spared only if its request line has already arrived, which
+ * ServerBuilder::deferAccept() makes likely on Linux.
+ *
+ * All state is atomic; admit() costs a few relaxed atomic operations.
+ */
+class AdmissionController {
+public:
+    static constexpr std::chrono::milliseconds WINDOW{100};
+    
+    AdmissionController() = default;
+    
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+    
+    /// Apply options; `workers` sizes the default limit bounds
+    void configure(const AdmissionOptions& options, size_t workers);
+    
+    [[nodiscard]] bool enabled() const noexcept { return enabled_; }
+    
+    /// Task posted to / finished by the worker pool
+    void enqueued() noexcept { in_flight_.fetch_add(1, std::memory_order_relaxed); }
+    void finished() noexcept { in_flight_.fetch_sub(1, std::memory_order_relaxed); }
+    
+    /**
+     * @brief Decide whether a request runs
+     * @param path Request path (priority lanes)
+     * @param queue_delay How long the request's task waited for a worker
+     * @return false: answer with shedResponse() and close
+     */
+    [[nodiscard]] bool admit(std::string_view path, std::chrono::nanoseconds queue_delay) noexcept;
+    
+    /// Worker queue bounds for `queued` waiting tasks: room for a new
+    /// connection, time to stop accepting, time to resume
+    [[nodiscard]] bool queueHasRoom(size_t queued) const noexcept { return queued < max_queue_; }
+    [[nodiscard]] bool queueOverloaded(size_t queued) const noexcept { return queued >= 2 * max_queue_; }
+    [[nodiscard]] bool queueDrained(size_t queued) const noexcept { return queued < max_queue_; }
+    
+    [[nodiscard]] bool isPriority(std::string_view path) const noexcept;
+    
+    /// Whether raw request bytes (at least the request line) ask for a priority path
+    [[nodiscard]] bool isPriorityRequest(std::string_view head) const noexcept;
+    
+    /// Complete "503 Service Unavailable" response, connection closing
+    [[nodiscard]] std::string_view shedResponse() const noexcept { return shed_response_; }
+    
+    /// Retry-After of the shed response, for protocols that build their own
+    [[nodiscard]] int retryAfterSeconds() const noexcept { return retry_after_s_; }
+    
+    [[nodiscard]] size_t limit() const noexcept { return limit_.load(std::memory_order_relaxed); }
+    [[nodiscard]] size_t inFlight() const noexcept { return in_flight_.load(std::memory_order_relaxed); }
+
+private:
+    void record(std::chrono::nanoseconds queue_delay) noexcept;
+    
+    bool enabled_ = false;
+    size_t max_queue_ = 0;
+    size_t min_limit_ = 1;
+    size_t max_limit_ = 1;
+    int64_t target_ns_ = 0;
+    double backoff_ = 0.9;
+    std::vector<std::string> priority_paths_;
+    std::string shed_response_;
+    int retry_after_s_ = 0;
+    
+    std::atomic<size_t> limit_{1};
+    std::atomic<size_t> in_flight_{0};
+    
+    // Current window: start, shortest queue time, highest in-flight count
+    std::atomic<int64_t> window_start_{0};
+    std::atomic<int64_t> window_min_delay_{INT64_MAX};
+    std::atomic<size_t> window_peak_{0};
+};
+
+} // namespace frqs::core
@@ -0,0 +1,183 @@
+#pragma once
+
+/**
+ * @file core/connection.hpp
+ * @brief Per-connection state (request parser, keep-alive, reactor bookkeeping)
+ * @version 1.1.1
+ * @copyright Copyright (c) 2025
+ */
+
+#include "net/socket.hpp"
+#include "net/sockaddr.hpp"
+#include "http/request_parser.hpp"
+#include "http/http2.hpp"
+#include "utils/arena.hpp"
+#include "utils/timer_wheel.hpp"
+#include "context.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace frqs::core {
+
+/**
+ * @brief Request whose body is being streamed to a BodyStream
+ *
+ * Outlives the receive calls that deliver the body. The request is a copy,
+ * so its views stay valid while the parser reuses the buffer behind the
+ * headers; the response uses the default memory resource, not the
+ * per-request arena, which is rewound between receives.
+ */
+struct StreamedRequest {
+    explicit StreamedRequest(const http::HTTPRequest& req)
+        : request(req), context(request, response) {}
+    
+    http::HTTPRequest request;
+    http::HTTPResponse response;
+    Context context;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+};
+
+/**
+ * @brief Request served by a coroutine pipeline that may outlive the call
+ *
+ * Owns what serveRequest() otherwise keeps on the worker's stack: the
+ * arena, the response and the context, so the request can be suspended
+ * and finished on another worker. The request itself stays in the parser,
+ * which is not fed while the connection waits. Recycled between requests
+ * (the optionals are rebuilt in place).
+ */
+struct AsyncRequest {
+    utils::Arena arena;
+    std::optional<http::HTTPResponse> response;
+    std::optional<Context> context;
+    std::chrono::steady_clock::time_point started;
+    std::exception_ptr error;
+    
+    /// Exchanged by the code that started the pipeline once it returns and
+    /// by the completion; whichever finds it already set carries on with
+    /// the connection
+    std::atomic<bool> handoff{false};
+};
+
+/**
+ * @brief Client connection
+ *
+ * In reactor mode it is owned by the server's connection registry and armed
+ * in the event loop in one-shot mode, so at most one worker touches it at a
+ * time. In blocking mode it lives on the worker's stack for the lifetime of
+ * the keep-alive session.
+ */
+struct Connection : std::enable_shared_from_this<Connection> {
+    Connection(net::Socket sock, net::SockAddr addr)
+        : socket(std::move(sock)), address(addr) {}
+    
+    ~Connection() {
+        if (ws) {
+            ws->detach();  // Before the socket closes
+        }
+    }
+    
+    net::Socket socket;
+    net::SockAddr address;
+    
+    /// Incremental parser; owns the bytes received but not yet served
+    http::RequestParser parser;
+    
+    /// Set once the connection speaks HTTP/2 (ALPN "h2" or the h2c
+    /// preface); received bytes then go to the session, not the parser
+    std::unique_ptr<http::Http2Session> h2;
+    
+    /// Set once the connection was upgraded to WebSocket: received bytes go
+    /// to it, and other threads send on the socket through it
+    std::shared_ptr<WebSocket> ws;
+    
+    /// Listener of an accepted upgrade, until the 101 is out
+    std::unique_ptr<WebSocketListener> upgrade;
+    
+    /// Reactor mode, WebSocket only: orders re-arming for writes from
+    /// senders on other threads against the owner's re-arming and closing
+    std::mutex arm_mutex;
+    bool closed = false;  // Guarded by arm_mutex
+    
+    /// "100 Continue" already sent for the request being received
+    bool continue_sent = false;
+    
+    /// Set while a Router::stream() route is receiving its body
+    std::unique_ptr<StreamedRequest> stream;
+    
+    /// Set while a coroutine request runs (reactor mode); the connection is
+    /// not read again until it finishes
+    std::unique_ptr<AsyncRequest> pending;
+    
+    /// Requests served on this connection (keep-alive limit)
+    size_t requests_served = 0;
+    
+    /// Last time bytes arrived or a response completed (idle and body timeouts)
+    std::chrono::steady_clock::time_point last_activity = std::chrono::steady_clock::now();
+    
+    /// When the request being received began (header timeout): its first
+    /// byte, the previous response for pipelined bytes, or the accept
+    std::chrono::steady_clock::time_point request_started = last_activity;
+    
+    /// Phase tracing (ServerOptions::trace_sample_every): the accept, and
+    /// when the current request's first byte arrived (or the previous
+    /// response ended, for pipelined bytes) and its headers were parsed
+    std::chrono::steady_clock::time_point accepted_at = last_activity;
+    std::chrono::steady_clock::time_point first_byte = last_activity;
+    std::chrono::steady_clock::time_point headers_parsed;
+    
+    /// Set while a worker owns the connection; expired read timeouts skip busy connections
+    std::atomic<bool> busy{false};
+    
+    /// Reactor mode: the connection's timeout in its reactor's wheel,
+    /// guarded by the reactor's timers_mutex
+    utils::TimerWheel::Timer timer;
+    
+    /// When the connection was last handed to the worker pool, and how long
+    /// it waited there (admission control; reset once a request used it)
+    std::chrono::steady_clock::time_point queued_at;
+    std::chrono::nanoseconds queue_delay{0};
+    
+    /// Bytes arrived; call before commitReceived(), which may start a request
+    void markReceived(std::chrono::steady_clock::time_point now) noexcept {
+        bool between_requests = !ws && !h2 && !stream && 
+                                !parser.hasBufferedData() && !parser.headersComplete();
+        if (between_requests) {
+            first_byte = now;
+            if (requests_served > 0) {
+                request_started = now;
+            }
+        }
+        last_activity = now;
+    }
+    
+    /// Where the next receive goes, and marking it received
+    std::span<char> receiveSpace(size_t min_size) {
+        if (ws) {
+            return ws->prepare(min_size);
+        }
+        return h2 ? h2->prepare(min_size) : parser.prepare(min_size);
+    }
+    
+    void commitReceived(size_t n) {
+        if (ws) {
+            ws->commit(n);
+        } else if (h2) {
+            h2->commit(n);
+        } else {
+            parser.commit(n);
+        }
+    }
+    
+    /// Non-blocking receive; a WebSocket orders it with its senders
+    std::optional<size_t> tryReceive(std::span<char> out) {
+        return ws ? ws->tryReceive(out) : socket.tryReceive(out.data(), out.size());
+    }
+};
+
+} // namespace frqs::core
@@ -2,19 +2,148 @@
 
 #include "http/request.hpp"
 #include "http/response.hpp"
+#include "utils/metrics.hpp"
+#include "websocket.hpp"
+#include <algorithm>
 #include <any>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace frqs::net {
+    class IoService;
+}
 
 namespace frqs::core {
 
+namespace detail {
+
+/// Transparent hash so string-keyed lookups accept string_view without copying
+struct StringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view sv) const noexcept {
+        return std::hash<std::string_view>{}(sv);
+    }
+};
+
+inline size_t registerSlot() {
+    static std::atomic<size_t> next{0};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+/// Maximum number of registered context slots in a process
+inline constexpr size_t MAX_CONTEXT_SLOTS = 32;
+
+/// Inline storage per slot; larger values should be stored behind a pointer
+inline constexpr size_t CONTEXT_SLOT_SIZE = 48;
+
+/**
+ * @brief Typed per-request storage key
+ * 
+ * Each Slot gets a process-wide index when it is constructed, so reading or
+ * writing it through a Context is an array access: no hashing, no type
+ * erasure and no allocation. Declare slots once, next to the middleware
+ * that owns them.
+ * 
+ * @example
+ * ```cpp
+ * inline const core::Slot<int> user_id_slot;
+ * 
+ * server.use([](Context& ctx, Next next) {
+ *     ctx.set(user_id_slot, 42);
+ *     next();
+ * });
+ * 
+ * router.get("/me", [](Context& ctx) {
+ *     if (int* id = ctx.get(user_id_slot)) { ... }
+ * });
+ * ```
+ */
+template<typename T>
+class Slot {
+public:
+    static_assert(sizeof(T) <= CONTEXT_SLOT_SIZE, 
+                  "Slot value too large for inline storage; store a pointer instead");
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned slot value");
+    
+    Slot() : index_(detail::registerSlot()) {
+        if (index_ >= MAX_CONTEXT_SLOTS) {
+            throw std::length_error("Too many context slots registered");
+        }
+    }
+    
+    Slot(const Slot&) = delete;
+    Slot& operator=(const Slot&) = delete;
+    
+    [[nodiscard]] size_t index() const noexcept { return index_; }
+
+private:
+    size_t index_;
+};
+
+/**
+ * @brief A registered route and its statistics
+ * 
+ * Owned by the router; the context of a matched request points at it.
+ */
+struct RouteInfo {
+    http::Method method;
+    std::string pattern;            // Full pattern, group prefix included
+    utils::Histogram latency;       // Middleware + handler time, microseconds
+};
+
+class Context;
+
+/**
+ * @brief Consumer for a request body that is not buffered
+ * 
+ * Returned by a Router::stream() handler. The server hands it the body as
+ * it arrives, in pieces of any size, then calls onEnd() once; the response
+ * is built there. If the connection fails while the body is arriving, the
+ * stream is destroyed without onEnd(), so the destructor must clean up
+ * (remove partial files and the like).
+ */
+class BodyStream {
+public:
+    virtual ~BodyStream() = default;
+    
+    /// Next piece of the body; return false to stop reading it
+    virtual bool onData(std::string_view data) = 0;
+    
+    /// Body fully delivered (complete) or reading stopped early
+    virtual void onEnd(Context& ctx, bool complete) = 0;
+};
+
 /**
  * @brief Request context with state management
  * 
  * Context wraps request/response and provides:
  * - Easy access to request data
  * - Response builders
- * - State storage (for middleware)
+ * - State storage (for middleware): typed Slot<T> or string keys
  * - Path parameters
  * 
+ * Path parameters are views: names point into the router, values into the
+ * request buffer. Neither is copied.
+ * 
+ * The server gives each request an arena (see utils::Arena) that is rewound
+ * once the response is sent. String-keyed state lives in it, and handlers
+ * can use it for scratch memory through arena() or format(); anything
+ * allocated there must not be kept past the request.
+ * 
  * @example
  * ```cpp
  * router.get("/users/:id", [](Context& ctx) {
@@ -25,8 +154,23 @@ namespace frqs::core {
  */
 class Context {
 public:
-    Context(const http::HTTPRequest& req, http::HTTPResponse& resp)
-        : request_(req), response_(resp) {}
+    /// Maximum path parameters per request (matches the router's capture limit)
+    static constexpr size_t MAX_PARAMS = 16;
+    
+    Context(const http::HTTPRequest& req, http::HTTPResponse& resp,
+            std::pmr::memory_resource* arena = std::pmr::get_default_resource())
+        : request_(req), response_(resp), arena_(arena), state_(arena) {}
+    
+    Context(const Context&) = delete;
+    Context& operator=(const Context&) = delete;
+    
+    ~Context() {
+        for (size_t i = 0; i < slots_used_; ++i) {
+            if (slots_[i].destroy) {
+                slots_[i].destroy(slots_[i].storage);
+            }
+        }
+    }
     
     // ========== REQUEST ACCESS ==========
     
@@ -38,6 +182,91 @@ public:
         return response_;
     }
     
+    /// Route the router matched, or nullptr (not routed yet / 404)
+    [[nodiscard]] RouteInfo* route() const noexcept {
+        return route_;
+    }
+    
+    void setRoute(RouteInfo* route) noexcept {
+        route_ = route;
+    }
+    
+    /**
+     * @brief Memory that lives until the response has been sent
+     * @example std::pmr::vector<std::string_view> parts(ctx.arena());
+     */
+    [[nodiscard]] std::pmr::memory_resource* arena() const noexcept {
+        return arena_;
+    }
+    
+    /**
+     * @brief std::format into the request arena
+     * @example ctx.header("X-Request-Id", ctx.format("{}-{}", node, seq));
+     */
+    template<typename... Args>
+    [[nodiscard]] std::pmr::string format(std::format_string<Args...> fmt, Args&&... args) const {
+        std::pmr::string out(arena_);
+        std::format_to(std::back_inserter(out), fmt, std::forward<Args>(args)...);
+        return out;
+    }
+    
+    /// Consumer set by a Router::stream() handler, or nullptr
+    [[nodiscard]] BodyStream* bodyStream() const noexcept {
+        return body_stream_.get();
+    }
+    
+    void setBodyStream(std::unique_ptr<BodyStream> stream) noexcept {
+        body_stream_ = std::move(stream);
+    }
+    
+    /// Listener of a Router::websocket() route that accepted the upgrade, or nullptr
+    [[nodiscard]] WebSocketListener* webSocket() const noexcept {
+        return websocket_.get();
+    }
+    
+    void setWebSocket(std::unique_ptr<WebSocketListener> listener) noexcept {
+        websocket_ = std::move(listener);
+    }
+    
+    [[nodiscard]] std::unique_ptr<WebSocketListener> takeWebSocket() noexcept {
+        return std::move(websocket_);
+    }
+    
+    /**
+     * @brief I/O service for coroutine handlers to await on
+     * @throws std::runtime_error outside a server (none attached)
+     * @example co_await ctx.io().sleepFor(std::chrono::milliseconds(50));
+     */
+    [[nodiscard]] net::IoService& io() const {
+        if (!io_) {
+            throw std::runtime_error("Context has no I/O service");
+        }
+        return *io_;
+    }
+    
+    void setIo(net::IoService* io) noexcept {
+        io_ = io;
+    }
+    
+    /**
+     * @brief When the handler should have answered (ServerOptions::handler_timeout_ms)
+     * 
+     * The server does not interrupt a handler; long-running ones check
+     * expired() between steps and give up (with a 503, say). No deadline
+     * is time_point::max().
+     */
+    [[nodiscard]] std::chrono::steady_clock::time_point deadline() const noexcept {
+        return deadline_;
+    }
+    
+    [[nodiscard]] bool expired() const noexcept {
+        return std::chrono::steady_clock::now() >= deadline_;
+    }
+    
+    void setDeadline(std::chrono::steady_clock::time_point deadline) noexcept {
+        deadline_ = deadline;
+    }
+    
     // ========== PATH PARAMETERS ==========
     
     /**
@@ -45,16 +274,35 @@ public:
      * @param name Parameter name (from route like "/users/:id")
      * @return Parameter value if exists
      */
-    [[nodiscard]] std::optional<std::string_view> param(std::string_view name) const {
-        auto it = params_.find(std::string(name));
-        if (it != params_.end()) {
-            return it->second;
+    [[nodiscard]] std::optional<std::string_view> param(std::string_view name) const noexcept {
+        for (size_t i = 0; i < param_count_; ++i) {
+            if (params_[i].name == name) {
+                return params_[i].value;
+            }
         }
         return std::nullopt;
     }
     
-    void setParam(std::string name, std::string value) {
-        params_[std::move(name)] = std::move(value);
+    /**
+     * @brief Add a path parameter
+     * 
+     * Both views must outlive the context (the router passes its own pattern
+     * names and slices of the request path).
+     * 
+     * @return false if MAX_PARAMS parameters are already set
+     */
+    bool setParam(std::string_view name, std::string_view value) noexcept {
+        for (size_t i = 0; i < param_count_; ++i) {
+            if (params_[i].name == name) {
+                params_[i].value = value;
+                return true;
+            }
+        }
+        if (param_count_ == MAX_PARAMS) {
+            return false;
+        }
+        params_[param_count_++] = {name, value};
+        return true;
     }
     
     // ========== QUERY PARAMETERS ==========
@@ -104,18 +352,99 @@ public:
             .body(std::string(content));
     }
     
+    /**
+     * @brief Stream the response body as it is produced
+     * 
+     * The producer runs after the handler returns and writes through a
+     * BodyWriter; the body is sent chunked unless a Content-Length header
+     * is set. Capture by value: this Context is gone by then.
+     * 
+     * @example
+     * ```cpp
+     * router.get("/events", [](Context& ctx) {
+     *     ctx.stream("text/event-stream", [](http::BodyWriter& out) {
+     *         for (int i = 0; out.write(std::format("data: {}\n\n", i)) && out.flush(); ++i) {
+     *             std::this_thread::sleep_for(std::chrono::seconds(1));
+     *         }
+     *     });
+     * });
+     * ```
+     */
+    Context& stream(std::string_view content_type, http::StreamBody producer) {
+        response_.setStreamBody(std::move(producer));
+        return status(200).header("Content-Type", content_type);
+    }
+    
     Context& redirect(std::string_view url, int code = 302) {
         return status(code).header("Location", url);
     }
     
+    // ========== TYPED STATE (SLOTS) ==========
+    
+    /**
+     * @brief Construct a value in a slot, replacing any previous value
+     * @example ctx.emplace(user_slot, "alice")
+     */
+    template<typename T, typename... Args>
+    T& emplace(const Slot<T>& slot, Args&&... args) {
+        auto& entry = slots_[slot.index()];
+        if (entry.destroy) {
+            entry.destroy(entry.storage);
+            entry.destroy = nullptr;
+        }
+        
+        T* value = ::new (static_cast<void*>(entry.storage)) T(std::forward<Args>(args)...);
+        entry.destroy = [](void* p) noexcept { static_cast<T*>(p)->~T(); };
+        slots_used_ = std::max(slots_used_, slot.index() + 1);
+        return *value;
+    }
+    
+    /**
+     * @brief Store a value in a slot
+     * @example ctx.set(user_id_slot, 123)
+     */
+    template<typename T>
+    void set(const Slot<T>& slot, T value) {
+        emplace(slot, std::move(value));
+    }
+    
+    /**
+     * @brief Value stored in a slot, or nullptr if unset
+     * @example if (int* id = ctx.get(user_id_slot)) { ... }
+     */
+    template<typename T>
+    [[nodiscard]] T* get(const Slot<T>& slot) noexcept {
+        auto& entry = slots_[slot.index()];
+        return entry.destroy ? std::launder(reinterpret_cast<T*>(entry.storage)) : nullptr;
+    }
+    
+    template<typename T>
+    [[nodiscard]] const T* get(const Slot<T>& slot) const noexcept {
+        const auto& entry = slots_[slot.index()];
+        return entry.destroy ? std::launder(reinterpret_cast<const T*>(entry.storage)) : nullptr;
+    }
+    
+    template<typename T>
+    [[nodiscard]] bool has(const Slot<T>& slot) const noexcept {
+        return slots_[slot.index()].destroy != nullptr;
+    }
+    
     // ========== STATE MANAGEMENT ==========
     
     /**
      * @brief Store data in context (for middleware)
+     * 
+     * String-keyed, type-erased storage; prefer a Slot<T> on hot paths.
+     * 
      * @example ctx.set("user_id", 123)
      */
     void set(std::string_view key, std::any value) {
-        state_[std::string(key)] = std::move(value);
+        auto it = state_.find(key);
+        if (it != state_.end()) {
+            it->second = std::move(value);
+        } else {
+            state_.emplace(std::pmr::string(key, arena_), std::move(value));
+        }
     }
     
     /**
@@ -124,12 +453,10 @@ public:
      */
     template<typename T>
     [[nodiscard]] std::optional<T> get(std::string_view key) const {
-        auto it = state_.find(std::string(key));
+        auto it = state_.find(key);
         if (it != state_.end()) {
-            try {
-                return std::any_cast<T>(it->second);
-            } catch (const std::bad_any_cast&) {
-                return std::nullopt;
+            if (const T* value = std::any_cast<T>(&it->second)) {
+                return *value;
             }
         }
         return std::nullopt;
@@ -139,14 +466,36 @@ public:
      * @brief Check if key exists
      */
     [[nodiscard]] bool has(std::string_view key) const {
-        return state_.contains(std::string(key));
+        return state_.contains(key);
     }
 
 private:
+    struct Param {
+        std::string_view name;
+        std::string_view value;
+    };
+    
+    struct SlotEntry {
+        alignas(std::max_align_t) std::byte storage[CONTEXT_SLOT_SIZE];
+        void (*destroy)(void*) noexcept = nullptr;
+    };
+    
     const http::HTTPRequest& request_;
     http::HTTPResponse& response_;
-    std::unordered_map<std::string, std::string> params_;
-    std::unordered_map<std::string, std::any> state_;
+    RouteInfo* route_ = nullptr;
+    net::IoService* io_ = nullptr;
+    std::chrono::steady_clock::time_point deadline_ = std::chrono::steady_clock::time_point::max();
+    std::pmr::memory_resource* arena_;
+    
+    std::array<Param, MAX_PARAMS> params_;
+    size_t param_count_ = 0;
+    
+    std::array<SlotEntry, MAX_CONTEXT_SLOTS> slots_;  // Storage left uninitialized
+    size_t slots_used_ = 0;
+    
+    std::pmr::unordered_map<std::pmr::string, std::any, detail::StringHash, std::equal_to<>> state_;
+    std::unique_ptr<BodyStream> body_stream_;
+    std::unique_ptr<WebSocketListener> websocket_;
 };
 
 } // namespace frqs::core
\ No newline at end of file
@@ -1,10 +1,41 @@
 #pragma once
 
 #include "context.hpp"
+#include "utils/coro.hpp"
+#include <concepts>
+#include <cstddef>
 #include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace frqs::core {
 
+class Pipeline;
+
+/**
+ * @brief Continuation handed to a middleware
+ * 
+ * Calling it runs the rest of the pipeline: the next middleware, or the
+ * handler once every middleware has run. It is a cursor into the pipeline
+ * (pipeline, context, position), so passing it around allocates nothing.
+ * It is only valid while the middleware that received it is running.
+ */
+class Next {
+public:
+    void operator()() const;
+
+private:
+    friend class Pipeline;
+    
+    Next(const Pipeline& pipeline, Context& ctx, size_t index) noexcept
+        : pipeline_(&pipeline), ctx_(&ctx), index_(index) {}
+    
+    const Pipeline* pipeline_;
+    Context* ctx_;
+    size_t index_;
+};
+
 /**
  * @brief Middleware function signature
  * 
@@ -18,16 +49,188 @@ namespace frqs::core {
  * server.use([](Context& ctx, Next next) {
  *     // Before handler
  *     auto start = std::chrono::steady_clock::now();
- *     
+ * 
  *     next();  // Call next middleware or handler
- *     
+ * 
  *     // After handler
  *     auto duration = std::chrono::steady_clock::now() - start;
  *     log("Request took {}ms", duration.count());
  * });
  * ```
  */
-using Next = std::function<void()>;
 using Middleware = std::function<void(Context&, Next)>;
 
-} // namespace frqs::core
\ No newline at end of file
+/**
+ * @brief Continuation handed to a coroutine middleware
+ * 
+ * Like Next, but awaited: `co_await next();` runs the rest of the pipeline,
+ * suspending wherever a later stage or the handler waits.
+ */
+class AsyncNext {
+public:
+    [[nodiscard]] coro::Task<> operator()() const;
+
+private:
+    friend class Pipeline;
+    
+    AsyncNext(const Pipeline& pipeline, Context& ctx, size_t index) noexcept
+        : pipeline_(&pipeline), ctx_(&ctx), index_(index) {}
+    
+    const Pipeline* pipeline_;
+    Context* ctx_;
+    size_t index_;
+};
+
+/**
+ * @brief Coroutine middleware: may wait (on I/O, a timer) without holding a worker
+ * 
+ * @example
+ * ```cpp
+ * server.use([](Context& ctx, AsyncNext next) -> coro::Task<> {
+ *     auto start = std::chrono::steady_clock::now();
+ *     co_await next();
+ *     log("Request took {}ms", elapsedMs(start));
+ * });
+ * ```
+ */
+using AsyncMiddleware = std::function<coro::Task<>(Context&, AsyncNext)>;
+
+/**
+ * @brief Callable usable as a coroutine middleware
+ * 
+ * Checked against Next first, so a generic plain middleware
+ * (`[](auto& ctx, auto next) { ... }`) is never instantiated with
+ * AsyncNext. A coroutine middleware must name AsyncNext as its parameter.
+ */
+template<typename F>
+concept AsyncMiddlewareFunction = !std::invocable<F&, Context&, Next> &&
+                                  std::invocable<F&, Context&, AsyncNext> &&
+                                  std::same_as<std::invoke_result_t<F&, Context&, AsyncNext>, coro::Task<>>;
+
+/**
+ * @brief Coroutine route handler (see Router::get())
+ */
+using AsyncHandler = std::function<coro::Task<>(Context&)>;
+
+/**
+ * @brief One pipeline stage: a plain or a coroutine middleware
+ */
+struct PipelineStage {
+    PipelineStage(Middleware middleware) : sync(std::move(middleware)) {}
+    PipelineStage(AsyncMiddleware middleware) : async(std::move(middleware)) {}
+    
+    Middleware sync;
+    AsyncMiddleware async;
+};
+
+/**
+ * @brief Middleware list frozen in front of a final handler
+ * 
+ * Each stage is type-erased once, when the pipeline is built; running it
+ * walks the stages by index, so a request costs one indirect call per
+ * middleware and no allocation. The server builds its global pipeline in
+ * start(), the router one per route registered with group middleware.
+ * 
+ * Stages and the handler may be coroutines. runAsync() awaits them, and
+ * awaits straight through plain stages; run() blocks on a coroutine part
+ * with coro::syncWait(). So does a plain middleware whose next() leads to
+ * one: it cannot suspend, so the worker waits with it. Put plain
+ * middleware after the coroutine ones, or make it a coroutine, to keep a
+ * pipeline fully asynchronous.
+ */
+class Pipeline {
+public:
+    using Handler = std::function<void(Context&)>;
+    
+    Pipeline() = default;
+    
+    Pipeline(std::vector<Middleware> stages, Handler handler)
+        : Pipeline(std::vector<PipelineStage>(stages.begin(), stages.end()), std::move(handler)) {}
+    
+    Pipeline(std::vector<PipelineStage> stages, Handler handler)
+        : stages_(std::move(stages)), handler_(std::move(handler)) {
+        findAsync();
+    }
+    
+    Pipeline(std::vector<PipelineStage> stages, AsyncHandler handler)
+        : stages_(std::move(stages)), async_handler_(std::move(handler)) {
+        findAsync();
+    }
+    
+    void run(Context& ctx) const {
+        invoke(ctx, 0);
+    }
+    
+    [[nodiscard]] coro::Task<> runAsync(Context& ctx) const {
+        return invokeAsync(ctx, 0);
+    }
+    
+    /// Whether any stage or the handler is a coroutine
+    [[nodiscard]] bool async() const noexcept {
+        return asyncFrom(0);
+    }
+    
+    [[nodiscard]] size_t size() const noexcept {
+        return stages_.size();
+    }
+
+private:
+    friend class Next;
+    friend class AsyncNext;
+    
+    static constexpr size_t NONE = static_cast<size_t>(-1);
+    
+    void findAsync() noexcept {
+        last_async_ = async_handler_ ? stages_.size() : NONE;
+        for (size_t i = stages_.size(); last_async_ == NONE && i-- > 0;) {
+            if (stages_[i].async) {
+                last_async_ = i;
+            }
+        }
+    }
+    
+    // Whether stages [index, end) plus the handler include a coroutine
+    [[nodiscard]] bool asyncFrom(size_t index) const noexcept {
+        return last_async_ != NONE && index <= last_async_;
+    }
+    
+    void invoke(Context& ctx, size_t index) const {
+        if (asyncFrom(index)) {
+            coro::syncWait(invokeAsync(ctx, index));
+        } else if (index < stages_.size()) {
+            stages_[index].sync(ctx, Next(*this, ctx, index + 1));
+        } else if (handler_) {
+            handler_(ctx);
+        }
+    }
+    
+    coro::Task<> invokeAsync(Context& ctx, size_t index) const {
+        if (index < stages_.size()) {
+            const auto& stage = stages_[index];
+            if (stage.async) {
+                co_await stage.async(ctx, AsyncNext(*this, ctx, index + 1));
+            } else {
+                stage.sync(ctx, Next(*this, ctx, index + 1));
+            }
+        } else if (async_handler_) {
+            co_await async_handler_(ctx);
+        } else if (handler_) {
+            handler_(ctx);
+        }
+    }
+    
+    std::vector<PipelineStage> stages_;
+    Handler handler_;
+    AsyncHandler async_handler_;
+    size_t last_async_ = NONE;  // Last coroutine stage (stages_.size(): the handler)
+};
+
+inline void Next::operator()() const {
+    pipeline_->invoke(*ctx_, index_);
+}
+
+inline coro::Task<> AsyncNext::operator()() const {
+    return pipeline_->invokeAsync(*ctx_, index_);
+}
+
+} // namespace frqs::core
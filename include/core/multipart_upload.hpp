@@ -0,0 +1,75 @@
+#pragma once
+
+/**
+ * @file core/multipart_upload.hpp
+ * @brief BodyStream that parses multipart/form-data as it arrives
+ * @version 1.1.1
+ * @copyright Copyright (c) 2025
+ */
+
+#include "context.hpp"
+#include "http/multipart_parser.hpp"
+
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+namespace frqs::core {
+
+/**
+ * @brief Streams a multipart upload into per-part sinks
+ * 
+ * Each part goes to the sink the factory picks (a file, say), so an upload
+ * of any size costs a constant amount of memory. Once the body has ended,
+ * done() builds the response; ok is true only if the body arrived whole
+ * and the closing boundary was seen.
+ * 
+ * @example
+ * ```cpp
+ * router.stream(http::Method::POST, "/upload", [](Context& ctx) {
+ *     return MultipartUpload::create(ctx,
+ *         [](const http::MultipartPart& part) { return http::fileSink(dir / part.filename); },
+ *         [](Context& ctx, const http::MultipartStreamParser& parser, bool ok) {
+ *             ctx.text(ok ? "Stored" : parser.error()).status(ok ? 201 : 400);
+ *         });
+ * });
+ * ```
+ */
+class MultipartUpload : public BodyStream {
+public:
+    using Done = std::function<void(Context&, const http::MultipartStreamParser&, bool ok)>;
+    
+    MultipartUpload(std::string_view boundary, http::PartSinkFactory factory, Done done)
+        : parser_(boundary, std::move(factory)), done_(std::move(done)) {}
+    
+    /**
+     * @brief Upload for the request's Content-Type boundary
+     *
+     * Answers 415 and returns nullptr (the body is not read) if the request
+     * is not multipart/form-data.
+     */
+    [[nodiscard]] static std::unique_ptr<BodyStream> create(Context& ctx, http::PartSinkFactory factory, Done done) {
+        auto boundary = http::multipartBoundary(ctx.request().getHeader("Content-Type").value_or(""));
+        if (!boundary) {
+            ctx.status(415).body("Expected multipart/form-data");
+            return nullptr;
+        }
+        return std::make_unique<MultipartUpload>(*boundary, std::move(factory), std::move(done));
+    }
+    
+    bool onData(std::string_view data) override {
+        return parser_.feed(data) != http::MultipartStreamParser::Status::Error;
+    }
+    
+    void onEnd(Context& ctx, bool complete) override {
+        bool ok = complete && parser_.status() == http::MultipartStreamParser::Status::Complete;
+        done_(ctx, parser_, ok);
+    }
+
+private:
+    http::MultipartStreamParser parser_;
+    Done done_;
+};
+
+} // namespace frqs::core
@@ -8,11 +8,14 @@
  */
 
 #include "middleware.hpp"
+#include <array>
+#include <concepts>
 #include <functional>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
-#include <regex>
 
 namespace frqs::core {
 
@@ -21,14 +24,55 @@ namespace frqs::core {
  */
 using RouteHandler = std::function<void(Context&)>;
 
+/**
+ * @brief Callable usable as a coroutine route handler
+ */
+template<typename F>
+concept AsyncRouteHandler = std::invocable<F&, Context&> &&
+                            std::same_as<std::invoke_result_t<F&, Context&>, coro::Task<>>;
+
+/**
+ * @brief Handler for a route whose body is streamed, not buffered
+ * 
+ * Runs as soon as the headers are in (behind the usual middleware) and
+ * returns the consumer for the body. Returning nullptr, or answering from
+ * a middleware before the handler runs, sends the response right away
+ * without reading the body.
+ */
+using StreamHandler = std::function<std::unique_ptr<BodyStream>(Context&)>;
+
+/**
+ * @brief Handler for a WebSocket route
+ * 
+ * Runs behind the usual middleware once a valid upgrade request is in
+ * and returns the listener for the connection. Returning nullptr, or
+ * answering from a middleware before the handler runs, sends that
+ * response instead of upgrading (a 401, say).
+ */
+using WebSocketHandler = std::function<std::unique_ptr<WebSocketListener>(Context&)>;
+
 /**
  * @brief HTTP router with path parameters
  * 
  * Features:
  * - Path parameters (/users/:id)
+ * - Trailing wildcards (`*` or `*name` as the last segment)
  * - Method-specific routes
  * - Route groups (prefixes)
- * - Middleware per route
+ * - Middleware per group (runs only on the group's routes)
+ * 
+ * Routes live in one compressed radix tree per method, so a lookup costs
+ * O(path length) and allocates nothing.
+ * 
+ * Precedence when several patterns could match a segment:
+ * 1. Static text (`/users/new`)
+ * 2. Parameter (`/users/:id`), which captures one non-empty segment
+ * 3. Wildcard (`*`), which captures the rest of the path (may be empty)
+ * 
+ * If a more specific branch dead-ends further down the path, matching
+ * backtracks and tries the next kind, so `/users/new/edit` still reaches
+ * `/users/:id/edit` when no static `/users/new/edit` exists. Unnamed
+ * wildcards are captured as param "*".
  * 
  * @example
  * ```cpp
@@ -47,9 +91,16 @@ using RouteHandler = std::function<void(Context&)>;
  * 
  * // Route group
  * auto api = router.group("/api");
+ * api.use(requireApiKey);
  * api.get("/status", [](auto& ctx) {
  *     ctx.json({{"status", "ok"}});
  * });
+ * 
+ * // Coroutine handler: waits without holding a worker thread
+ * router.get("/slow", [](Context& ctx) -> coro::Task<> {
+ *     co_await ctx.io().sleepFor(std::chrono::milliseconds(100));
+ *     ctx.text("done");
+ * });
  * ```
  */
 class Router {
@@ -66,11 +117,63 @@ public:
     void options(std::string_view path, RouteHandler handler) ;
     void head(std::string_view path, RouteHandler handler) ;
     
+    /**
+     * @brief Coroutine handlers (any callable returning coro::Task<>)
+     * 
+     * The server awaits them in reactor mode, so a handler suspended on
+     * I/O frees its worker for other connections; in blocking mode the
+     * connection's worker waits for it.
+     */
+    template<AsyncRouteHandler F> void get(std::string_view path, F handler) { addAsyncRoute(http::Method::GET, path, std::move(handler)) ; }
+    template<AsyncRouteHandler F> void post(std::string_view path, F handler) { addAsyncRoute(http::Method::POST, path, std::move(handler)) ; }
+    template<AsyncRouteHandler F> void put(std::string_view path, F handler) { addAsyncRoute(http::Method::PUT, path, std::move(handler)) ; }
+    template<AsyncRouteHandler F> void del(std::string_view path, F handler) { addAsyncRoute(http::Method::DELETE, path, std::move(handler)) ; }
+    template<AsyncRouteHandler F> void patch(std::string_view path, F handler) { addAsyncRoute(http::Method::PATCH, path, std::move(handler)) ; }
+    template<AsyncRouteHandler F> void options(std::string_view path, F handler) { addAsyncRoute(http::Method::OPTIONS, path, std::move(handler)) ; }
+    template<AsyncRouteHandler F> void head(std::string_view path, F handler) { addAsyncRoute(http::Method::HEAD, path, std::move(handler)) ; }
+    
+    /**
+     * @brief Register a route that consumes its body as it arrives
+     * 
+     * The body is not held in memory and is not subject to the parser's
+     * body limit; ServerOptions::max_streamed_body_bytes applies instead.
+     * 
+     * @example
+     * ```cpp
+     * router.stream(http::Method::POST, "/upload", [](Context& ctx) {
+     *     return std::make_unique<DiskWriter>(ctx.param("name"));
+     * });
+     * ```
+     */
+    void stream(http::Method method, std::string_view path, StreamHandler handler) ;
+    
+    /**
+     * @brief Register a GET route that upgrades to WebSocket (RFC 6455)
+     * 
+     * Requests that are not a valid opening handshake get 426 Upgrade
+     * Required. On HTTP/2 connections, which have no Upgrade, it always
+     * answers 426 (clients fall back to HTTP/1.1).
+     * 
+     * @example
+     * ```cpp
+     * struct Echo : WebSocketListener {
+     *     void onMessage(WebSocket& socket, std::string_view data, bool binary) override {
+     *         binary ? socket.sendBinary(data) : socket.sendText(data);
+     *     }
+     * };
+     * router.websocket("/echo", [](Context&) { return std::make_unique<Echo>(); });
+     * ```
+     */
+    void websocket(std::string_view path, WebSocketHandler handler) ;
+    
     // ========== ROUTE GROUPS ==========
     
     /**
      * @brief Create route group with prefix
      * 
+     * Routes added to the group are registered in the root router, so the
+     * group object may go out of scope once its routes are added.
+     * 
      * @example
      * ```cpp
      * auto api = router.group("/api/v1");
@@ -79,6 +182,35 @@ public:
      */
     Router group(std::string_view prefix) ;
     
+    /**
+     * @brief Add middleware to this router's routes
+     * 
+     * Applies to routes registered through this router (or groups created
+     * from it) after the call, and runs after the server-wide middleware,
+     * only when one of those routes matched. Each route freezes its
+     * middleware at registration.
+     * 
+     * @example
+     * ```cpp
+     * auto admin = router.group("/admin");
+     * admin.use([](Context& ctx, Next next) {
+     *     if (!ctx.request().getHeader("Authorization")) {
+     *         ctx.status(401).body("Unauthorized");
+     *         return;
+     *     }
+     *     next();
+     * });
+     * admin.get("/stats", handler);  // Checked; /api/... routes are not
+     * ```
+     */
+    void use(Middleware middleware) ;
+    
+    // Coroutine middleware: `co_await next();` (see AsyncMiddleware)
+    template<AsyncMiddlewareFunction F>
+    void use(F middleware) {
+        middlewares_.push_back(AsyncMiddleware(std::move(middleware)));
+    }
+    
     // ========== ROUTE MATCHING ==========
     
     /**
@@ -89,20 +221,76 @@ public:
      */
     bool route(Context& ctx) ;
     
+    /// route() for coroutine routes and middleware: awaits instead of blocking
+    [[nodiscard]] coro::Task<bool> routeAsync(Context& ctx) ;
+    
+    /**
+     * @brief Visit every registered route (all methods)
+     * 
+     * Used to export per-route metrics. Not synchronized with registration;
+     * call it once routes are set up.
+     */
+    void forEachRoute(const std::function<void(const RouteInfo&)>& visit) const ;
+    
+    /// Whether a request for method + path would reach a stream() route
+    [[nodiscard]] bool streams(http::Method method, std::string_view path) const noexcept ;
+    
+    /// Whether any stream() route is registered (bodies must wait for routing)
+    [[nodiscard]] bool hasStreamRoutes() const noexcept ;
+    
+    /// Whether method + path reach a coroutine handler or group middleware
+    [[nodiscard]] bool isAsync(http::Method method, std::string_view path) const noexcept ;
+    
+    /// Whether any route involves a coroutine
+    [[nodiscard]] bool hasAsyncRoutes() const noexcept ;
+    
+    /// Maximum :param / wildcard captures in a single route
+    static constexpr size_t MAX_PARAMS = Context::MAX_PARAMS;
+
 private:
-    struct Route {
-        http::Method method;
-        std::string path;
-        std::regex pattern;
-        std::vector<std::string> param_names;
+    struct Node {
+        std::string label;                          // Compressed static edge
+        std::string indices;                        // First byte of each static child
+        std::vector<std::unique_ptr<Node>> children;
+        std::unique_ptr<Node> param;                // ":name" child
+        std::unique_ptr<Node> wildcard;             // "*name" child (always a leaf)
+        
+        // Set on nodes that terminate a route (one of the two handlers)
         RouteHandler handler;
+        AsyncHandler async_handler;
+        std::unique_ptr<Pipeline> pipeline;         // Group middleware + handler, if any
+        std::vector<std::string> param_names;       // In capture order
+        std::unique_ptr<RouteInfo> info;            // Pattern and latency stats
+        bool streams_body = false;                  // Registered with stream()
+        bool async = false;                         // Coroutine handler or middleware
+        
+        [[nodiscard]] bool terminal() const noexcept { return handler || async_handler; }
+    };
+    
+    struct Captures {
+        std::array<std::string_view, MAX_PARAMS> values;
+        size_t size = 0;
     };
     
-    std::vector<Route> routes_;
+    static constexpr size_t METHOD_COUNT = static_cast<size_t>(http::Method::UNKNOWN);
+    
+    std::array<std::unique_ptr<Node>, METHOD_COUNT> trees_;
     std::string prefix_;
-    Router* parent_ = nullptr;
+    std::vector<PipelineStage> middlewares_;  // Inherited by groups
+    Router* root_ = nullptr;  // Set on groups; routes are stored in the root
+    size_t stream_routes_ = 0;  // Root only
+    size_t async_routes_ = 0;   // Root only
+    
+    Node* addRoute(http::Method method, std::string_view path, RouteHandler handler) ;
+    void addAsyncRoute(http::Method method, std::string_view path, AsyncHandler handler) ;
+    Node* insert(http::Method method, std::string_view pattern, RouteHandler handler,
+                AsyncHandler async_handler, const std::vector<PipelineStage>& middlewares) ;
+    
+    // Match the request and fill in its params and route; nullptr: no route
+    const Node* find(Context& ctx) const noexcept ;
     
-    void addRoute(http::Method method, std::string_view path, RouteHandler handler) ;
+    static Node* insertStatic(Node* node, std::string_view text) ;
+    static const Node* match(const Node& node, std::string_view path, Captures& captures) noexcept ;
 };
 
 } // namespace frqs::core
\ No newline at end of file
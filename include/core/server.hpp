@@ -25,6 +25,10 @@
 
 #include "net/socket.hpp"
 #include "net/sockaddr.hpp"
+#include "net/event_loop.hpp"
+#include "net/io_service.hpp"
+#include "net/ip_filter.hpp"
+#include "net/tls.hpp"
 
 #ifdef DELETE
 	#undef DELETE
@@ -33,13 +37,25 @@
 #include "http/request.hpp"
 #include "http/response.hpp"
 #include "utils/thread_pool.hpp"
+#include "utils/metrics.hpp"
+#include "utils/timer_wheel.hpp"
+#include "utils/trace.hpp"
 #include "router.hpp"
 #include "context.hpp"
+#include "connection.hpp"
+#include "admission.hpp"
 
+#include <array>
 #include <memory>
 #include <atomic>
+#include <chrono>
+#include <string>
 #include <vector>
 #include <functional>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 // Forward declaration
 namespace frqs::plugins {
@@ -48,11 +64,186 @@ namespace frqs::plugins {
 
 namespace frqs::core {
 
+/**
+ * @brief Server tuning options
+ * 
+ * Must be set before start().
+ */
+struct ServerOptions {
+    /**
+     * Use the event-driven reactor instead of one blocking task per connection.
+     * 
+     * In reactor mode all sockets are non-blocking and registered with a
+     * net::EventLoop (epoll/kqueue/WSAPoll). A single reactor thread accepts
+     * connections and hands only *ready* connections to the worker pool, so
+     * slow or idle clients never pin a worker.
+     */
+    bool reactor = false;
+    
+    /// Maximum ready events drained per reactor wakeup
+    size_t max_events = 256;
+    
+    /**
+     * Build the reactor loops on io_uring instead of epoll (Linux 6.1+;
+     * elsewhere, or where the kernel refuses, the native backend is used
+     * and logged). Re-arming is batched into each loop's wait, which pays
+     * off most in shared-nothing mode, where the loop re-arms its own
+     * connections.
+     */
+    bool io_uring = false;
+    
+    /**
+     * Persistent connections (HTTP/1.1 keep-alive).
+     * 
+     * HTTP/1.1 connections stay open unless either side sends
+     * `Connection: close`; HTTP/1.0 clients must ask for `keep-alive`.
+     * Pipelined requests are served in order from the same receive buffer.
+     */
+    bool keep_alive = true;
+    
+    /// Close a connection after this long without a new request (milliseconds)
+    int keep_alive_timeout_ms = 5000;
+    
+    /**
+     * Close a connection whose request headers are not all in this long
+     * after the request's first byte (milliseconds). On a new connection
+     * it counts from accept, so it also bounds the TLS handshake and a
+     * client that connects and sends nothing (slowloris).
+     */
+    int header_timeout_ms = 10000;
+    
+    /// Close a connection whose request body stalls this long between reads (milliseconds)
+    int body_timeout_ms = 30000;
+    
+    /**
+     * Deadline for handlers, from when a worker takes the request
+     * (milliseconds, 0 = none). Handlers see it as Context::deadline();
+     * the server counts and logs the ones that run past it but does not
+     * cut them off.
+     */
+    int handler_timeout_ms = 0;
+    
+    /// Close a connection after this many requests (0 = unlimited)
+    size_t max_keep_alive_requests = 1000;
+    
+    /// Largest body a Router::stream() route accepts (0 = unlimited)
+    size_t max_streamed_body_bytes = 0;
+    
+    /**
+     * Shared-nothing mode: open this many listening sockets bound with
+     * SO_REUSEPORT, each owned by its own event loop thread that accepts
+     * and serves its connections inline (0 = off). The kernel spreads new
+     * connections over the listeners, so no single thread serializes
+     * accept(). Where SO_REUSEPORT is unavailable (Windows) the loops share
+     * one listener instead.
+     * 
+     * Handlers run on the loop thread, so they must not block for long.
+     */
+    size_t reuse_port_listeners = 0;
+    
+    /// Pin worker (or shared-nothing loop) thread i to CPU i (Linux/Windows)
+    bool pin_worker_threads = false;
+    
+    /**
+     * TCP options for the listening socket(s) and accepted connections:
+     * backlog, TCP_NODELAY, corking of file responses, TCP_FASTOPEN,
+     * TCP_DEFER_ACCEPT, socket buffer sizes and busy polling. Options the
+     * platform lacks are logged once at start and skipped.
+     */
+    net::SocketOptions socket;
+    
+    /**
+     * Sampled request phase tracing: each worker traces one HTTP/1.1
+     * request in this many (0 = off), recording accept, first byte,
+     * headers parsed, handler start and end, and last byte sent. The
+     * newest trace_capacity traces are rendered as Chrome trace JSON by
+     * Server::renderTrace() (MetricsPlugin serves them at /debug/trace).
+     */
+    uint32_t trace_sample_every = 0;
+    size_t trace_capacity = 4096;
+    
+    /**
+     * Checked for every accepted connection before it is queued or
+     * registered; rejected connections are closed at once, without a read.
+     * Rules can be swapped with IpFilter::reload() while the server runs.
+     */
+    std::shared_ptr<net::IpFilter> ip_filter;
+    
+    /**
+     * Overload protection for the worker pool: new connections get a
+     * canned 503 from the accept loop while the queue is full, accepting
+     * stops while it is far over, and requests beyond the adaptive
+     * concurrency limit get the 503 instead of running (see
+     * AdmissionController). Priority paths pass every check. Off by
+     * default; not used in shared-nothing mode, which has no queue.
+     */
+    AdmissionOptions admission;
+    
+    /**
+     * Serve HTTPS instead of plain HTTP on the listening port(s). The
+     * handshake is non-blocking: in reactor mode a connection waiting for
+     * handshake bytes is parked in the event loop like an idle keep-alive
+     * one (and swept by the same timeout), so it never holds a worker.
+     * Where kTLS is available the kernel takes the record encryption over
+     * after the handshake and static files still go out with sendfile().
+     */
+    std::shared_ptr<net::TlsContext> tls;
+    
+    /**
+     * HTTP/2: negotiated with ALPN over TLS (TlsOptions::alpn) or, on
+     * plain-text listeners, started by clients with prior knowledge (h2c,
+     * `cleartext`). Streams of a connection are served one after another
+     * by the worker that owns it, through the same middleware and routes;
+     * their responses are multiplexed by priority and flow control.
+     * Keep-alive limits apply per connection: after
+     * max_keep_alive_requests a GOAWAY ends it gracefully.
+     */
+    http::Http2Options http2;
+    
+    /**
+     * WebSocket connections (Router::websocket routes). In reactor mode an
+     * upgraded connection goes back to the event loop, and is woken for
+     * writes when a send from another thread had to queue. In blocking
+     * mode it keeps its worker until it closes.
+     */
+    WebSocketOptions websocket;
+};
+
+/**
+ * @brief Server-wide traffic statistics
+ * 
+ * Sharded counters and latency histograms; recording is a relaxed atomic
+ * add. Per-route latency lives in each route's RouteInfo. Rendered in
+ * Prometheus text format by Server::renderMetrics().
+ */
+struct ServerMetrics {
+    utils::Counter requests;
+    utils::Counter connections_accepted;
+    utils::Counter connections_rejected;   // By ServerOptions::ip_filter
+    utils::Counter requests_shed;          // Answered 503 by admission control
+    utils::Counter accept_pauses;          // Worker queue full, accepting paused
+    utils::Counter tls_handshakes;
+    utils::Counter tls_handshake_failures;
+    utils::Counter tls_resumed;            // Handshakes that resumed a session
+    utils::Counter tls_kernel_offload;     // Connections whose records the kernel encrypts
+    utils::Counter http2_connections;
+    utils::Counter websocket_connections;  // Upgrades completed
+    utils::Counter parse_errors;
+    utils::Counter read_timeouts;          // Connections closed waiting for a request's headers or body
+    utils::Counter handler_timeouts;       // Requests that ran past ServerOptions::handler_timeout_ms
+    utils::Counter bytes_received;
+    utils::Counter bytes_sent;
+    
+    /// Request latency by status class: [0] = 1xx ... [4] = 5xx
+    std::array<utils::Histogram, 5> latency_by_class;
+};
+
 /**
  * @brief Core HTTP server
  * 
  * Features:
  * - Async request handling with thread pool
+ * - Optional event-driven reactor (see ServerOptions::reactor)
  * - Plugin system for modularity
  * - Middleware pipeline
  * - Modern routing with path parameters
@@ -139,7 +330,10 @@ public:
     /**
      * @brief Add middleware to pipeline
      * 
-     * Middleware is executed in registration order for each request.
+     * Middleware is executed in registration order for each request. The
+     * list is frozen when start() is called; registering afterwards throws.
+     * Middleware that only some routes need belongs on a router group
+     * (Router::use), so other requests do not pay for it.
      * 
      * @param middleware Middleware function
      * 
@@ -166,6 +360,33 @@ public:
      */
     void use(Middleware middleware);
     
+    /**
+     * @brief Add coroutine middleware
+     * 
+     * In reactor mode a request whose pipeline awaits parks its connection
+     * instead of a worker: the worker serves other connections until the
+     * awaited I/O completes and the request resumes on the pool. Plain
+     * middleware registered ahead of it makes the worker wait again (see
+     * Pipeline).
+     * 
+     * @example
+     * ```cpp
+     * server.use([](Context& ctx, AsyncNext next) -> coro::Task<> {
+     *     co_await next();
+     *     ctx.header("X-Served-By", "frqs");
+     * });
+     * ```
+     */
+    template<AsyncMiddlewareFunction F>
+    void use(F middleware) {
+        addStage(AsyncMiddleware(std::move(middleware)));
+    }
+    
+    /// Awaitable waits and timers for coroutine handlers (also Context::io())
+    [[nodiscard]] net::IoService& io() noexcept {
+        return io_;
+    }
+    
     // ========== ROUTING ==========
     
     /**
@@ -189,6 +410,34 @@ public:
         return router_;
     }
     
+    // ========== CONFIGURATION ==========
+    
+    /**
+     * @brief Set tuning options (call before start())
+     */
+    void setOptions(const ServerOptions& options) {
+        options_ = options;
+    }
+    
+    [[nodiscard]] const ServerOptions& options() const noexcept {
+        return options_;
+    }
+    
+    /**
+     * @brief Change the number of worker threads, also while running
+     * 
+     * Before start() this sets the size the pool starts with. Afterwards
+     * the pool grows or shrinks in place, up to the larger of the starting
+     * size and the core count; retired workers finish their queued tasks
+     * first. Admission control keeps the limits it started with.
+     * Shared-nothing mode has no pool, so there it has no effect.
+     * 
+     * @return The worker count now in effect
+     */
+    size_t setThreadCount(size_t thread_count);
+    
+    [[nodiscard]] size_t threadCount() const;
+    
     // ========== SERVER CONTROL ==========
     
     /**
@@ -241,33 +490,173 @@ public:
     [[nodiscard]] uint64_t totalRequests() const noexcept {
         return total_requests_;
     }
+    
+    /**
+     * @brief Traffic counters and latency histograms
+     */
+    [[nodiscard]] const ServerMetrics& metrics() const noexcept {
+        return metrics_;
+    }
+    
+    /**
+     * @brief All metrics in Prometheus text exposition format (version 0.0.4)
+     * 
+     * Includes per-route latency histograms, status-class histograms,
+     * byte/connection counters and gauges for active connections and worker
+     * queue depth. Served by MetricsPlugin at /metrics.
+     */
+    [[nodiscard]] std::string renderMetrics() const;
+    
+    /**
+     * @brief Sampled request phase traces as Chrome trace JSON
+     * 
+     * Empty unless ServerOptions::trace_sample_every is set. Load it in
+     * chrome://tracing or ui.perfetto.dev: one row per connection, each
+     * request split into connect, read headers, read body and queue,
+     * handler and send.
+     */
+    [[nodiscard]] std::string renderTrace() const;
 
 private:
     // Server configuration
     uint16_t port_;
     size_t thread_count_;
+    mutable std::mutex pool_mutex_;  // thread_count_, and thread_pool_ being created
+    ServerOptions options_;
+    
+    /**
+     * @brief One event loop with the connections it owns
+     * 
+     * The default reactor has a single instance fed by server_socket_ that
+     * hands ready connections to the thread pool. Shared-nothing mode runs
+     * one per listener thread and serves on that thread.
+     */
+    struct Reactor {
+        net::Socket* listener = nullptr;
+        std::unique_ptr<net::Socket> own_listener;  // SO_REUSEPORT socket
+        std::unique_ptr<net::EventLoop> loop;
+        bool serve_inline = false;
+        bool accepting = true;                      // Listener armed (see waitWhileOverloaded)
+        
+        // Registry keeps connections alive while they are armed in the loop
+        std::mutex connections_mutex;
+        std::unordered_map<Connection*, std::shared_ptr<Connection>> connections;
+        
+        // One timer per connection: its read timeout while it waits in the
+        // loop, the handler deadline while a worker owns it. Fired by the
+        // loop thread; taken after connections_mutex and arm_mutex.
+        std::mutex timers_mutex;
+        utils::TimerWheel timers{std::chrono::milliseconds(10)};
+    };
     
     // Core components
     std::unique_ptr<net::Socket> server_socket_;
+    std::vector<std::unique_ptr<Reactor>> reactors_;
     std::unique_ptr<utils::ThreadPool> thread_pool_;
     Router router_;
     
     // Plugin system
     std::vector<std::unique_ptr<plugins::Plugin>> plugins_;
     
-    // Middleware pipeline
-    std::vector<Middleware> middlewares_;
+    // Middleware pipeline: registered list, frozen into pipeline_ by start()
+    std::vector<PipelineStage> middlewares_;
+    Pipeline pipeline_;
+    
+    // Coroutine requests: the same middleware awaiting the router. Waits
+    // park on io_; pool_executor_ resumes them on the worker pool.
+    struct PoolExecutor final : coro::Executor {
+        utils::ThreadPool* pool = nullptr;
+        void post(std::coroutine_handle<> handle) override;
+    };
+    
+    Pipeline async_pipeline_;
+    bool has_async_ = false;        // Any coroutine middleware or route
+    PoolExecutor pool_executor_;
+    net::IoService io_;             // Declared after thread_pool_: stops first
     
     // Server state
     std::atomic<bool> running_{false};
     std::atomic<size_t> active_connections_{0};
     std::atomic<uint64_t> total_requests_{0};
+    ServerMetrics metrics_;
+    utils::RequestTracer tracer_;
+    AdmissionController admission_;
+    
+    // Outcome of serving what a reactor connection has buffered
+    enum class Progress : uint8_t {
+        Continue,   // Served; read more
+        Parked,     // A coroutine request took the connection over
+        Close
+    };
     
     // Internal methods
+    void addStage(PipelineStage stage);
     void acceptLoop();
-    void handleClient(net::Socket client, net::SockAddr client_addr);
-    void processRequest(const http::HTTPRequest& request, http::HTTPResponse& response);
-    void executeMiddlewareChain(Context& ctx, size_t index);
+    [[nodiscard]] bool admitted(const net::SockAddr& client_addr);  // ServerOptions::ip_filter
+    void waitWhileOverloaded();
+    [[nodiscard]] bool shedAtAccept(net::Socket& client);
+    void countHandshake(const net::TlsStream& tls);
+    void handleClient(net::Socket client, net::SockAddr client_addr, 
+                      std::chrono::steady_clock::time_point queued_at);
+    [[nodiscard]] bool admitRequest(Connection& conn, std::string_view path);
+    bool serveBuffered(Connection& conn);
+    bool serveRequest(Connection& conn, const http::HTTPRequest& request);
+    bool startBody(Connection& conn);
+    bool pumpStream(Connection& conn);
+    bool finishRequest(Connection& conn, const http::HTTPRequest& request, http::HTTPResponse& response,
+                       RouteInfo* route, std::chrono::steady_clock::time_point started);
+    void countRequest(Connection& conn, const http::HTTPResponse& response, RouteInfo* route,
+                      std::chrono::steady_clock::time_point started);
+    void rejectRequest(Connection& conn);
+    bool sendResponse(Connection& conn, const http::HTTPResponse& response, bool head_only);
+    void traceRequest(const Connection& conn, const http::HTTPRequest& request, const http::HTTPResponse& response,
+                      std::chrono::steady_clock::time_point first_byte,
+                      std::chrono::steady_clock::time_point started,
+                      std::chrono::steady_clock::time_point handled);
+    
+    // Timeouts (see ServerOptions::header_timeout_ms)
+    [[nodiscard]] std::chrono::steady_clock::time_point readDeadline(const Connection& conn) const;
+    [[nodiscard]] std::chrono::steady_clock::time_point handlerDeadline() const noexcept;
+    
+    // HTTP/2 connections
+    void startHttp2(Connection& conn);
+    bool serveHttp2(Connection& conn);
+    void flushHttp2(Connection& conn);
+    bool streamHttp2(Connection& conn, uint32_t stream_id, const http::StreamBody& producer);
+    
+    // WebSocket connections
+    void startWebSocket(Connection& conn);
+    bool serveWebSocket(Connection& conn);
+    void runWebSocket(Connection& conn);
+    
+    // Binds and listens with ServerOptions::socket applied
+    void listenOn(net::Socket& socket, const net::SockAddr& bind_addr, bool report);
+    
+    // Reactor mode
+    void openReusePortListeners(const net::SockAddr& bind_addr);
+    void runReactors();
+    void reactorLoop(Reactor& reactor);
+    void acceptReady(Reactor& reactor);
+    void onReadable(Reactor& reactor, const std::shared_ptr<Connection>& conn);
+    void closeConnection(Reactor& reactor, const std::shared_ptr<Connection>& conn);
+    void park(Reactor& reactor, const std::shared_ptr<Connection>& conn, uint32_t events);
+    void watchHandler(Reactor& reactor, Connection& conn);
+    void fireTimers(Reactor& reactor);
+    void expireConnection(Reactor& reactor, const std::shared_ptr<Connection>& conn);
+    void parkWebSocket(Reactor& reactor, const std::shared_ptr<Connection>& conn);
+    
+    // Coroutine requests (reactor mode)
+    [[nodiscard]] bool needsAsync(const http::HTTPRequest& request) const noexcept;
+    [[nodiscard]] coro::Executor* executorFor(const Reactor& reactor) noexcept;
+    Progress serveReady(Reactor& reactor, const std::shared_ptr<Connection>& conn);
+    Progress runPending(Reactor& reactor, const std::shared_ptr<Connection>& conn);
+    bool finishPending(Connection& conn);
+    void completePending(Reactor& reactor, const std::shared_ptr<Connection>& conn);
+    
+    RouteInfo* processRequest(const http::HTTPRequest& request, http::HTTPResponse& response,
+                              std::pmr::memory_resource* arena, Connection* conn);
+    void routeOrNotFound(Context& ctx);
+    coro::Task<> routeOrNotFoundAsync(Context& ctx);
 };
 
 /**
@@ -306,6 +695,121 @@ public:
         return *this;
     }
     
+    ServerBuilder& options(const ServerOptions& o) {
+        options_ = o;
+        return *this;
+    }
+    
+    ServerBuilder& reactor(bool enabled = true) {
+        options_.reactor = enabled;
+        return *this;
+    }
+    
+    ServerBuilder& ioUring(bool enabled = true) {
+        options_.io_uring = enabled;
+        return *this;
+    }
+    
+    ServerBuilder& reusePort(size_t listeners) {
+        options_.reuse_port_listeners = listeners;
+        return *this;
+    }
+    
+    ServerBuilder& pinWorkers(bool enabled = true) {
+        options_.pin_worker_threads = enabled;
+        return *this;
+    }
+    
+    ServerBuilder& ipFilter(std::shared_ptr<net::IpFilter> filter) {
+        options_.ip_filter = std::move(filter);
+        return *this;
+    }
+    
+    ServerBuilder& tls(std::shared_ptr<net::TlsContext> context) {
+        options_.tls = std::move(context);
+        return *this;
+    }
+    
+    ServerBuilder& http2(const http::Http2Options& http2) {
+        options_.http2 = http2;
+        return *this;
+    }
+    
+    ServerBuilder& websocket(const WebSocketOptions& websocket) {
+        options_.websocket = websocket;
+        return *this;
+    }
+    
+    ServerBuilder& admission(const AdmissionOptions& admission) {
+        options_.admission = admission;
+        return *this;
+    }
+    
+    ServerBuilder& keepAlive(int timeout_ms, size_t max_requests = 1000) {
+        options_.keep_alive = timeout_ms > 0;
+        options_.keep_alive_timeout_ms = timeout_ms;
+        options_.max_keep_alive_requests = max_requests;
+        return *this;
+    }
+    
+    ServerBuilder& readTimeouts(int header_timeout_ms, int body_timeout_ms) {
+        options_.header_timeout_ms = header_timeout_ms;
+        options_.body_timeout_ms = body_timeout_ms;
+        return *this;
+    }
+    
+    ServerBuilder& handlerTimeout(int timeout_ms) {
+        options_.handler_timeout_ms = timeout_ms;
+        return *this;
+    }
+    
+    ServerBuilder& socketOptions(const net::SocketOptions& socket) {
+        options_.socket = socket;
+        return *this;
+    }
+    
+    ServerBuilder& backlog(int connections) {
+        options_.socket.backlog = connections;
+        return *this;
+    }
+    
+    ServerBuilder& noDelay(bool enabled = true) {
+        options_.socket.no_delay = enabled;
+        return *this;
+    }
+    
+    ServerBuilder& cork(bool enabled = true) {
+        options_.socket.cork = enabled;
+        return *this;
+    }
+    
+    ServerBuilder& fastOpen(int queue_length) {
+        options_.socket.fast_open_queue = queue_length;
+        return *this;
+    }
+    
+    ServerBuilder& deferAccept(int seconds) {
+        options_.socket.defer_accept_seconds = seconds;
+        return *this;
+    }
+    
+    ServerBuilder& socketBuffers(int receive_bytes, int send_bytes) {
+        options_.socket.receive_buffer = receive_bytes;
+        options_.socket.send_buffer = send_bytes;
+        return *this;
+    }
+    
+    ServerBuilder& busyPoll(int microseconds) {
+        options_.socket.busy_poll_us = microseconds;
+        return *this;
+    }
+    
+    ServerBuilder& trace(uint32_t sample_every, size_t capacity = 4096) {
+        options_.trace_sample_every = sample_every;
+        options_.trace_capacity = capacity;
+        return *this;
+    }
+    
     template<typename PluginT, typename... Args>
     ServerBuilder& plugin(Args&&... args) {
         plugins_.push_back([args...](Server& s) {
@@ -326,6 +830,7 @@ public:
     
     std::unique_ptr<Server> build() {
         auto server = std::make_unique<Server>(port_, threads_);
+        server->setOptions(options_);
         
         // Apply plugins
         for (auto& plugin_fn : plugins_) {
@@ -353,6 +858,7 @@ public:
 private:
     uint16_t port_ = 8080;
     size_t threads_ = std::thread::hardware_concurrency();
+    ServerOptions options_;
     std::vector<std::function<void(Server&)>> plugins_;
     std::vector<Middleware> middlewares_;
     std::vector<std::tuple<std::string, std::string, RouteHandler>> routes_;
@@ -0,0 +1,245 @@
+#pragma once
+
+/**
+ * @file core/websocket.hpp
+ * @brief WebSocket connections: listener, per-connection send queue, broadcast groups
+ * @version 1.1.1
+ * @copyright Copyright (c) 2025
+ */
+
+#include "net/socket.hpp"
+#include "net/sockaddr.hpp"
+#include "http/websocket.hpp"
+#include "utils/metrics.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace frqs::core {
+
+/**
+ * @brief WebSocket settings (ServerOptions::websocket)
+ */
+struct WebSocketOptions {
+    /// Largest message a client may send, fragments joined; over it: close 1009
+    size_t max_message_bytes = 16 * 1024 * 1024;
+    
+    /// Bytes a connection may have waiting to be sent. A send that does not
+    /// fit is dropped (and returns false), so a slow client misses frames
+    /// instead of piling up memory.
+    size_t max_queued_bytes = 8 * 1024 * 1024;
+    
+    /// Close after this long without bytes from the client (milliseconds).
+    /// A ping goes out once half of it passed, so a live but silent client
+    /// (a viewer, say) answers with a pong and stays connected.
+    int idle_timeout_ms = 60000;
+};
+
+class WebSocket;
+
+/**
+ * @brief Receiver of one WebSocket connection's events
+ *
+ * Returned by a Router::websocket() handler, one per connection. Callbacks
+ * run on the worker serving the connection, one at a time.
+ */
+class WebSocketListener {
+public:
+    virtual ~WebSocketListener() = default;
+    
+    /// The upgrade is done. Keep `socket` to send from elsewhere (or add it
+    /// to a WebSocketGroup); it stays valid after the connection closes.
+    virtual void onOpen(const std::shared_ptr<WebSocket>& socket) { (void)socket; }
+    
+    /// A complete text or binary message; `data` is valid during the call
+    virtual void onMessage(WebSocket& socket, std::string_view data, bool binary) = 0;
+    
+    /// Called once when the connection ends, with the client's close code
+    /// (WsCloseCode::Abnormal if it just went away). Sends fail from here on.
+    virtual void onClose(WebSocket& socket, uint16_t code) { (void)socket; (void)code; }
+};
+
+/**
+ * @brief Server end of a WebSocket connection
+ *
+ * Sending is thread-safe and never blocks: a frame is written straight to
+ * the socket when it can be, otherwise it waits in the connection's send
+ * queue, which the server drains as the socket becomes writable. Frames
+ * are serialized once into a shared Frame, so a broadcast hands the same
+ * bytes to every connection without copying them.
+ *
+ * @example
+ * ```cpp
+ * auto viewers = std::make_shared<WebSocketGroup>();
+ *
+ * struct Viewer : WebSocketListener {
+ *     std::shared_ptr<WebSocketGroup> group;
+ *     void onOpen(const std::shared_ptr<WebSocket>& socket) override { group->add(socket); }
+ *     void onMessage(WebSocket&, std::string_view, bool) override {}
+ * };
+ *
+ * router.websocket("/screen", [viewers](Context&) {
+ *     auto viewer = std::make_unique<Viewer>();
+ *     viewer->group = viewers;
+ *     return viewer;
+ * });
+ *
+ * // Capture thread, 30 times a second:
+ * viewers->broadcast(encoded_frame);
+ * ```
+ */
+class WebSocket : public std::enable_shared_from_this<WebSocket> {
+public:
+    /// A serialized frame, shareable between connections
+    using Frame = std::shared_ptr<const std::string>;
+    
+    [[nodiscard]] static Frame makeFrame(std::string_view payload, bool binary);
+    
+    // ========== SENDING (any thread) ==========
+    
+    /// False once the connection is closing, or when the frame was dropped
+    /// because the send queue is full (see WebSocketOptions)
+    bool sendText(std::string_view text);
+    bool sendBinary(std::string_view data);
+    bool send(Frame frame);
+    
+    /// Start the closing handshake; the connection ends once the client answers
+    void close(uint16_t code = http::WsCloseCode::Normal, std::string_view reason = {});
+    
+    [[nodiscard]] bool isOpen() const noexcept {
+        return open_.load(std::memory_order_acquire);
+    }
+    
+    [[nodiscard]] size_t queuedBytes() const noexcept {
+        return queued_bytes_.load(std::memory_order_relaxed);
+    }
+    
+    /// Frames refused because the send queue was full
+    [[nodiscard]] uint64_t droppedFrames() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+    
+    [[nodiscard]] const net::SockAddr& remoteAddress() const noexcept {
+        return address_;
+    }
+    
+    // ========== SERVER SIDE ==========
+    
+    WebSocket(net::Socket& socket, const net::SockAddr& address, std::unique_ptr<WebSocketListener> listener,
+              const WebSocketOptions& options, utils::Counter* bytes_sent);
+    
+    /// Hand the connection to the listener (onOpen)
+    void open();
+    
+    /// Where received bytes go; only the connection's owner calls these
+    [[nodiscard]] std::span<char> prepare(size_t min_size) { return parser_.prepare(min_size); }
+    void commit(size_t n) { parser_.commit(n); }
+    void feed(std::string_view data) { parser_.feed(data); }
+    
+    /// Receive without racing a sender on another thread (TLS state is shared)
+    [[nodiscard]] std::optional<size_t> tryReceive(std::span<char> out);
+    
+    /// Deliver the frames received so far. False once the connection is done.
+    bool process();
+    
+    /// Write what is queued without blocking; false if the socket failed
+    bool flush();
+    
+    /// Bytes are queued (the owner should wait for writability)
+    [[nodiscard]] bool wantsWrite() const noexcept {
+        return queued_bytes_.load(std::memory_order_acquire) > 0;
+    }
+    
+    /// Close handshake finished (or the socket failed) and nothing is left to send
+    [[nodiscard]] bool done() const;
+    
+    /// Called, under the send lock, when a send had to queue bytes: the
+    /// owner arranges a flush once the socket is writable. Unset, the owner
+    /// polls (blocking mode).
+    void setWriteWaiter(std::function<void()> waiter);
+    [[nodiscard]] bool hasWriteWaiter() const;
+    
+    /// Keep-alive probe for a silent client; sent once until bytes arrive
+    void ping();
+    
+    /// The connection is going away: best-effort close frame, then
+    /// onClose(). Sends fail afterwards. Idempotent.
+    void detach();
+
+private:
+    struct Queued {
+        Frame frame;
+        size_t offset = 0;
+    };
+    
+    net::SockAddr address_;
+    std::unique_ptr<WebSocketListener> listener_;
+    WebSocketOptions options_;
+    utils::Counter* bytes_sent_;
+    http::WebSocketParser parser_;
+    
+    // Send side; the socket is only touched with mutex_ held
+    mutable std::mutex mutex_;
+    net::Socket* socket_;
+    std::deque<Queued> queue_;
+    std::function<void()> write_waiter_;
+    bool write_waiting_ = false;        // Waiter called, no flush since
+    bool close_sent_ = false;
+    bool failed_ = false;
+    
+    std::atomic<bool> open_{true};
+    std::atomic<size_t> queued_bytes_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> ping_sent_{false};
+    
+    // Owner only
+    bool close_received_ = false;
+    uint16_t close_code_ = http::WsCloseCode::Abnormal;
+    
+    /// Queue and write a frame; `control` frames bypass the queue limit
+    bool enqueue(Frame frame, bool control);
+    
+    /// Write from the queue until it is empty or the socket would block
+    bool writeLocked();
+    
+    void sendClose(uint16_t code, std::string_view reason);
+};
+
+/**
+ * @brief Connections that receive the same messages
+ *
+ * broadcast() serializes the frame once and queues it on every member:
+ * one syscall per connection that keeps up, none for a slow one whose
+ * queue is full (it misses the frame). Membership is copy-on-write, so a
+ * broadcast does not block joins and leaves; closed connections are
+ * dropped on the next broadcast.
+ */
+class WebSocketGroup {
+public:
+    void add(std::shared_ptr<WebSocket> socket);
+    void remove(const WebSocket& socket);
+    
+    [[nodiscard]] size_t size() const;
+    
+    /// Members that accepted the frame
+    size_t broadcast(std::string_view payload, bool binary = true);
+    size_t broadcast(const WebSocket::Frame& frame);
+
+private:
+    using Members = std::vector<std::shared_ptr<WebSocket>>;
+    
+    mutable std::mutex mutex_;
+    std::shared_ptr<const Members> members_ = std::make_shared<const Members>();
+};
+
+} // namespace frqs::core
@@ -0,0 +1,64 @@
+#pragma once
+
+/**
+ * @file http/compression.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Content-Encoding negotiation and gzip/brotli encoders
+ * @version 1.0.0
+ * @date 2025-12-15
+ * 
+ * The encoders are compiled in when the build finds zlib (FRQS_HAVE_ZLIB)
+ * and brotli (FRQS_HAVE_BROTLI); without them only identity is offered.
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace frqs::http {
+
+enum class ContentEncoding : uint8_t {
+    Identity,
+    Gzip,
+    Brotli
+} ;
+
+// Content-Encoding token ("gzip", "br"; empty for identity)
+[[nodiscard]] constexpr std::string_view encodingToken(ContentEncoding encoding) noexcept {
+    switch (encoding) {
+        case ContentEncoding::Gzip: return "gzip" ;
+        case ContentEncoding::Brotli: return "br" ;
+        default: return "" ;
+    }
+}
+
+// Whether an encoder for `encoding` is compiled into this build
+[[nodiscard]] bool encoderAvailable(ContentEncoding encoding) noexcept ;
+
+/**
+ * @brief Pick the best encoding the client accepts (RFC 9110 section 12.5.3)
+ * 
+ * Honors q-values (q=0 forbids) and the "*" wildcard. On equal preference
+ * brotli wins over gzip. Encodings the caller does not allow are never
+ * chosen; pass encoderAvailable() when compressing on the fly.
+ */
+[[nodiscard]] ContentEncoding negotiateEncoding(std::string_view accept_encoding,
+                                                bool allow_gzip = true,
+                                                bool allow_brotli = true) noexcept ;
+
+/**
+ * @brief Compress `data`
+ * 
+ * @param level gzip: 1-9, brotli: 0-11
+ * @return Encoded bytes, or nullopt if the encoder is unavailable or fails
+ */
+[[nodiscard]] std::optional<std::string> compress(std::string_view data, ContentEncoding encoding, int level) ;
+
+// Entity tag of an encoded representation: "abc" -> "abc-gzip"
+[[nodiscard]] std::string encodedEtag(std::string_view etag, ContentEncoding encoding) ;
+
+} // namespace frqs::http
@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+ * @file http/date.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief HTTP-date formatting and parsing (RFC 9110 section 5.6.7)
+ * @version 1.0.0
+ * @date 2025-12-15
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace frqs::http {
+
+// IMF-fixdate, e.g. "Sun, 06 Nov 1994 08:49:37 GMT" (second precision)
+[[nodiscard]] std::string formatHttpDate(std::chrono::system_clock::time_point time) ;
+
+// Parses IMF-fixdate; the obsolete RFC 850 and asctime forms are rejected
+[[nodiscard]] std::optional<std::chrono::system_clock::time_point> parseHttpDate(std::string_view text) noexcept ;
+
+} // namespace frqs::http
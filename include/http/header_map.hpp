@@ -0,0 +1,225 @@
+#pragma once
+
+/**
+ * @file http/header_map.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Flat, case-insensitive request header table
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace frqs::http {
+
+/**
+ * @brief Headers the server itself looks at, resolved once while parsing
+ */
+enum class KnownHeader : uint8_t {
+    Unknown,
+    Host,
+    ContentLength,
+    ContentType,
+    TransferEncoding,
+    Connection,
+    Expect,
+    Authorization,
+    Accept,
+    AcceptEncoding,
+    AcceptLanguage,
+    CacheControl,
+    Cookie,
+    IfModifiedSince,
+    IfNoneMatch,
+    IfRange,
+    Origin,
+    Range,
+    Referer,
+    Upgrade,
+    UserAgent,
+    Count
+} ;
+
+[[nodiscard]] constexpr char asciiLower(char c) noexcept {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c ;
+}
+
+[[nodiscard]] constexpr bool equalsIgnoreCase(std::string_view a, std::string_view b) noexcept {
+    if (a.size() != b.size()) {
+        return false ;
+    }
+    for (size_t i = 0 ; i < a.size() ; ++i) {
+        if (asciiLower(a[i]) != asciiLower(b[i])) {
+            return false ;
+        }
+    }
+    return true ;
+}
+
+// FNV-1a over the lowercased name
+[[nodiscard]] constexpr uint32_t headerNameHash(std::string_view name) noexcept {
+    uint32_t hash = 2166136261u ;
+    for (char c : name) {
+        hash = (hash ^ static_cast<uint8_t>(asciiLower(c))) * 16777619u ;
+    }
+    return hash ;
+}
+
+[[nodiscard]] constexpr std::string_view knownHeaderName(KnownHeader id) noexcept {
+    switch (id) {
+        case KnownHeader::Host: return "Host" ;
+        case KnownHeader::ContentLength: return "Content-Length" ;
+        case KnownHeader::ContentType: return "Content-Type" ;
+        case KnownHeader::TransferEncoding: return "Transfer-Encoding" ;
+        case KnownHeader::Connection: return "Connection" ;
+        case KnownHeader::Expect: return "Expect" ;
+        case KnownHeader::Authorization: return "Authorization" ;
+        case KnownHeader::Accept: return "Accept" ;
+        case KnownHeader::AcceptEncoding: return "Accept-Encoding" ;
+        case KnownHeader::AcceptLanguage: return "Accept-Language" ;
+        case KnownHeader::CacheControl: return "Cache-Control" ;
+        case KnownHeader::Cookie: return "Cookie" ;
+        case KnownHeader::IfModifiedSince: return "If-Modified-Since" ;
+        case KnownHeader::IfNoneMatch: return "If-None-Match" ;
+        case KnownHeader::IfRange: return "If-Range" ;
+        case KnownHeader::Origin: return "Origin" ;
+        case KnownHeader::Range: return "Range" ;
+        case KnownHeader::Referer: return "Referer" ;
+        case KnownHeader::Upgrade: return "Upgrade" ;
+        case KnownHeader::UserAgent: return "User-Agent" ;
+        default: return {} ;
+    }
+}
+
+/**
+ * @brief Case-insensitive well-known header lookup
+ *
+ * Dispatches on length so a name is compared against at most a few
+ * candidates.
+ */
+[[nodiscard]] constexpr KnownHeader knownHeader(std::string_view name) noexcept {
+    auto is = [name](KnownHeader id) { return equalsIgnoreCase(name, knownHeaderName(id)) ; } ;
+
+    switch (name.size()) {
+        case 4:
+            return is(KnownHeader::Host) ? KnownHeader::Host : KnownHeader::Unknown ;
+        case 5:
+            return is(KnownHeader::Range) ? KnownHeader::Range : KnownHeader::Unknown ;
+        case 6:
+            if (is(KnownHeader::Accept)) return KnownHeader::Accept ;
+            if (is(KnownHeader::Cookie)) return KnownHeader::Cookie ;
+            if (is(KnownHeader::Expect)) return KnownHeader::Expect ;
+            if (is(KnownHeader::Origin)) return KnownHeader::Origin ;
+            return KnownHeader::Unknown ;
+        case 7:
+            if (is(KnownHeader::Referer)) return KnownHeader::Referer ;
+            if (is(KnownHeader::Upgrade)) return KnownHeader::Upgrade ;
+            return KnownHeader::Unknown ;
+        case 8:
+            return is(KnownHeader::IfRange) ? KnownHeader::IfRange : KnownHeader::Unknown ;
+        case 10:
+            if (is(KnownHeader::Connection)) return KnownHeader::Connection ;
+            if (is(KnownHeader::UserAgent)) return KnownHeader::UserAgent ;
+            return KnownHeader::Unknown ;
+        case 12:
+            return is(KnownHeader::ContentType) ? KnownHeader::ContentType : KnownHeader::Unknown ;
+        case 13:
+            if (is(KnownHeader::Authorization)) return KnownHeader::Authorization ;
+            if (is(KnownHeader::CacheControl)) return KnownHeader::CacheControl ;
+            if (is(KnownHeader::IfNoneMatch)) return KnownHeader::IfNoneMatch ;
+            return KnownHeader::Unknown ;
+        case 14:
+            return is(KnownHeader::ContentLength) ? KnownHeader::ContentLength : KnownHeader::Unknown ;
+        case 15:
+            if (is(KnownHeader::AcceptEncoding)) return KnownHeader::AcceptEncoding ;
+            if (is(KnownHeader::AcceptLanguage)) return KnownHeader::AcceptLanguage ;
+            return KnownHeader::Unknown ;
+        case 17:
+            if (is(KnownHeader::TransferEncoding)) return KnownHeader::TransferEncoding ;
+            if (is(KnownHeader::IfModifiedSince)) return KnownHeader::IfModifiedSince ;
+            return KnownHeader::Unknown ;
+        default:
+            return KnownHeader::Unknown ;
+    }
+}
+
+struct HeaderField {
+    std::string_view name ;
+    std::string_view value ;
+    uint32_t hash = 0 ;                     // headerNameHash(name)
+    KnownHeader id = KnownHeader::Unknown ;
+} ;
+
+/**
+ * @brief Header fields in arrival order, stored contiguously
+ *
+ * Names and values are views into the request buffer. Lookup of a
+ * well-known header is a table index; any other name is a scan that
+ * compares precomputed hashes before touching the bytes. clear() keeps the
+ * capacity, so a parser reused across requests stops allocating.
+ *
+ * With repeated fields, lookups return the first occurrence.
+ */
+class HeaderMap {
+public:
+    void clear() noexcept {
+        fields_.clear() ;
+        known_.fill(0) ;
+    }
+
+    void add(std::string_view name, std::string_view value, KnownHeader id) {
+        fields_.push_back({name, value, headerNameHash(name), id}) ;
+        auto& slot = known_[static_cast<size_t>(id)] ;
+        if (id != KnownHeader::Unknown && slot == 0) {
+            slot = static_cast<uint16_t>(fields_.size()) ;
+        }
+    }
+
+    void add(std::string_view name, std::string_view value) {
+        add(name, value, knownHeader(name)) ;
+    }
+
+    [[nodiscard]] std::optional<std::string_view> get(KnownHeader id) const noexcept {
+        auto slot = known_[static_cast<size_t>(id)] ;
+        if (id == KnownHeader::Unknown || slot == 0) {
+            return std::nullopt ;
+        }
+        return fields_[slot - 1].value ;
+    }
+
+    [[nodiscard]] std::optional<std::string_view> get(std::string_view name) const noexcept {
+        if (auto id = knownHeader(name) ; id != KnownHeader::Unknown) {
+            return get(id) ;
+        }
+        uint32_t hash = headerNameHash(name) ;
+        for (const auto& field : fields_) {
+            if (field.hash == hash && equalsIgnoreCase(field.name, name)) {
+                return field.value ;
+            }
+        }
+        return std::nullopt ;
+    }
+
+    [[nodiscard]] bool contains(std::string_view name) const noexcept { return get(name).has_value() ; }
+
+    [[nodiscard]] size_t size() const noexcept { return fields_.size() ; }
+    [[nodiscard]] bool empty() const noexcept { return fields_.empty() ; }
+    [[nodiscard]] auto begin() const noexcept { return fields_.begin() ; }
+    [[nodiscard]] auto end() const noexcept { return fields_.end() ; }
+
+private:
+    std::vector<HeaderField> fields_ ;
+
+    // Index + 1 into fields_ of the first occurrence; 0 = absent
+    std::array<uint16_t, static_cast<size_t>(KnownHeader::Count)> known_{} ;
+} ;
+
+} // namespace frqs::http
@@ -0,0 +1,161 @@
+#pragma once
+
+/**
+ * @file http/hpack.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief HPACK header compression for HTTP/2 (RFC 7541)
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace frqs::http::hpack {
+
+inline constexpr size_t DEFAULT_TABLE_SIZE = 4096 ;
+
+// Size an entry counts for in the dynamic table and in a header list
+inline constexpr size_t ENTRY_OVERHEAD = 32 ;
+
+// Entries 1..61 of the static table (RFC 7541 Appendix A)
+inline constexpr size_t STATIC_TABLE_SIZE = 61 ;
+
+// ========== HUFFMAN CODE (RFC 7541 Appendix B) ==========
+
+[[nodiscard]] size_t huffmanLength(std::string_view data) noexcept ;
+void huffmanEncode(std::string_view data, std::string& out) ;
+
+// Appends the decoded bytes; false on an invalid code, EOS or bad padding
+[[nodiscard]] bool huffmanDecode(std::string_view data, std::string& out) ;
+
+/**
+ * @brief Dynamic table shared by the encoder and the decoder side
+ *
+ * Newest entry first; index 1 is the newest (callers add the static
+ * table's 61 entries). Evicts from the back while over max size.
+ */
+class DynamicTable {
+public:
+    struct Entry {
+        std::string name ;
+        std::string value ;
+    } ;
+
+    explicit DynamicTable(size_t max_size) : max_size_(max_size) {}
+
+    void insert(std::string_view name, std::string_view value) ;
+    void setMaxSize(size_t max_size) ;
+
+    // 1-based, newest first; nullptr when out of range
+    [[nodiscard]] const Entry* get(size_t index) const noexcept {
+        return index >= 1 && index <= entries_.size() ? &entries_[index - 1] : nullptr ;
+    }
+
+    [[nodiscard]] size_t entries() const noexcept { return entries_.size() ; }
+    [[nodiscard]] size_t size() const noexcept { return size_ ; }
+    [[nodiscard]] size_t maxSize() const noexcept { return max_size_ ; }
+
+    // Insertions so far; the entry with absolute id `id` sits at index
+    // inserted() - id
+    [[nodiscard]] uint64_t inserted() const noexcept { return inserted_ ; }
+
+private:
+    // Drop the oldest entries until `room` more bytes fit (§4.4)
+    void evict(size_t room) ;
+
+    std::deque<Entry> entries_ ;
+    size_t size_ = 0 ;
+    size_t max_size_ ;
+    uint64_t inserted_ = 0 ;
+} ;
+
+// A decoded header, as offsets into the decoder's output bytes
+struct Field {
+    uint32_t name_offset ;
+    uint32_t name_length ;
+    uint32_t value_offset ;
+    uint32_t value_length ;
+} ;
+
+/**
+ * @brief Header block decoder (one per connection, blocks in order)
+ *
+ * Field bytes are copied out while decoding: an indexed field may be
+ * evicted by the next one in the same block.
+ */
+class Decoder {
+public:
+    enum class Result : uint8_t {
+        Ok,
+        Malformed,      // Connection error (COMPRESSION_ERROR)
+        TooLarge        // Decoded, but the header list is over the limit
+    } ;
+
+    explicit Decoder(size_t max_table_size = DEFAULT_TABLE_SIZE) : table_(max_table_size), limit_(max_table_size) {}
+
+    // Appends names and values to `bytes`, one Field each to `fields`.
+    // Past max_list_size, fields are dropped but the block is still
+    // decoded so the dynamic table stays in step with the peer's.
+    Result decode(std::string_view block, std::string& bytes, std::vector<Field>& fields, size_t max_list_size) ;
+
+    [[nodiscard]] const DynamicTable& table() const noexcept { return table_ ; }
+
+private:
+    DynamicTable table_ ;
+    size_t limit_ ;             // Our SETTINGS_HEADER_TABLE_SIZE
+} ;
+
+/**
+ * @brief Header block encoder
+ *
+ * Fields that exactly match the static table go out as a single index
+ * byte (":status: 200" is 0x88). Other fields are literals, with the
+ * name indexed when the static or dynamic table has it, and added to
+ * the dynamic table unless told otherwise. A repeated response header
+ * such as content-type or server then costs one byte per response.
+ * Literal strings are Huffman coded when that is shorter.
+ */
+class Encoder {
+public:
+    enum class Indexing : uint8_t {
+        Incremental,    // Add to the dynamic table
+        None,           // Value changes every time (content-length)
+        Never           // Sensitive; intermediaries must not index it either
+    } ;
+
+    explicit Encoder(size_t max_table_size = DEFAULT_TABLE_SIZE) : table_(max_table_size) {}
+
+    // The peer's SETTINGS_HEADER_TABLE_SIZE; announced in the next block
+    void setMaxTableSize(size_t size) ;
+
+    // Call at the start of each header block
+    void begin(std::string& out) ;
+
+    void encodeStatus(std::string& out, uint16_t status) ;
+
+    // `name` must be lowercase
+    void encode(std::string& out, std::string_view name, std::string_view value,
+                Indexing indexing = Indexing::Incremental) ;
+
+private:
+    void insert(std::string_view name, std::string_view value) ;
+
+    DynamicTable table_ ;
+    size_t pending_size_update_ = SIZE_MAX ;  // SIZE_MAX = none
+
+    // Absolute ids of the newest entry per "name\0value" and per name
+    std::unordered_map<std::string, uint64_t> by_field_ ;
+    std::unordered_map<std::string, uint64_t> by_name_ ;
+    std::string key_ ;
+} ;
+
+} // namespace frqs::http::hpack
@@ -0,0 +1,280 @@
+#pragma once
+
+/**
+ * @file http/http2.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief HTTP/2 connection state machine (RFC 9113) with RFC 9218 priorities
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "request.hpp"
+#include "response.hpp"
+#include "hpack.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace frqs::http {
+
+struct Http2Options {
+    // Accept "h2c" on plain-text listeners from clients that start with
+    // the connection preface (prior knowledge). Over TLS, HTTP/2 is
+    // negotiated with ALPN instead (net::TlsOptions::alpn).
+    bool cleartext = true ;
+
+    // Streams a client may have open at once; more are refused
+    uint32_t max_concurrent_streams = 128 ;
+
+    // How much request body the client may send ahead, per stream and in
+    // total, before it waits for a WINDOW_UPDATE
+    uint32_t initial_window_size = 1024 * 1024 ;
+    uint32_t connection_window_size = 16 * 1024 * 1024 ;
+
+    // Decoded header list (names + values + 32 per field); over it: 431
+    size_t max_header_list_size = 64 * 1024 ;
+
+    // Buffered request body per stream; over it: 413
+    size_t max_body_bytes = HTTPRequest::MAX_REQUEST_SIZE ;
+} ;
+
+// RST_STREAM and GOAWAY codes (RFC 9113 §7)
+enum class Http2Error : uint32_t {
+    NoError = 0x0,
+    ProtocolError = 0x1,
+    InternalError = 0x2,
+    FlowControlError = 0x3,
+    SettingsTimeout = 0x4,
+    StreamClosed = 0x5,
+    FrameSizeError = 0x6,
+    RefusedStream = 0x7,
+    Cancel = 0x8,
+    CompressionError = 0x9,
+    ConnectError = 0xa,
+    EnhanceYourCalm = 0xb,
+    InadequateSecurity = 0xc,
+    Http11Required = 0xd
+} ;
+
+/**
+ * @brief One HTTP/2 connection, without the socket
+ *
+ * The caller receives into prepare()/commit(), calls process(), serves
+ * every request nextRequest() hands out with respond(), and writes
+ * output() to the socket until it comes back empty. Control frames
+ * (SETTINGS, PING, WINDOW_UPDATE acknowledgements) are answered inside
+ * process() and go out with the next output().
+ *
+ * Requests come out complete, body included, as regular HTTPRequests
+ * (version "HTTP/2", :authority as Host), so routes and middleware serve
+ * them unchanged. Response bodies are sent in DATA frames within the
+ * peer's flow-control windows: file bodies as file ranges for sendfile(),
+ * memory bodies without a copy, and streamed bodies as they are produced,
+ * through a per-stream buffer of at most STREAM_BUFFER bytes.
+ *
+ * Stream priorities follow RFC 9218 (the `priority` header and
+ * PRIORITY_UPDATE frames; weights of the deprecated RFC 7540 scheme are
+ * mapped onto urgencies). Among the streams with data to send, the most
+ * urgent go first: the lowest stream id first when they are not
+ * incremental, one frame each in turn when they are.
+ *
+ * Not thread-safe; one owner at a time, like the rest of a Connection.
+ */
+class Http2Session {
+public:
+    static constexpr std::string_view PREFACE = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n" ;
+
+    // Streamed body a stream holds before its producer waits for DATA
+    // frames to take some (see streamBody())
+    static constexpr size_t STREAM_BUFFER = 64 * 1024 ;
+
+    // A piece of output: bytes, or `length` bytes of `file` at `offset`
+    struct Segment {
+        std::string_view bytes ;
+        const utils::FileHandle* file = nullptr ;
+        uint64_t offset = 0 ;
+        uint64_t length = 0 ;
+    } ;
+
+    struct Request {
+        uint32_t stream_id ;
+        HTTPRequest request ;
+    } ;
+
+    // Queues the server preface (SETTINGS and the connection window)
+    explicit Http2Session(const Http2Options& options = {}) ;
+
+    // ========== INPUT ==========
+
+    // Writable space of at least min_size bytes at the end of the input
+    [[nodiscard]] std::span<char> prepare(size_t min_size) ;
+    void commit(size_t n) ;
+
+    // Copy bytes in (what an HTTP/1 parser already received, say)
+    void feed(std::string_view data) ;
+
+    // Parse the frames received so far. False after a connection error:
+    // a GOAWAY is queued, write output() and close. Throws only bad_alloc.
+    bool process() ;
+
+    // Most urgent complete request, if any
+    [[nodiscard]] std::optional<Request> nextRequest() ;
+
+    // ========== OUTPUT ==========
+
+    // Answer a stream handed out by nextRequest(). Takes the body over
+    // (the response may live in an arena that goes away after the call).
+    // True when the body is streamed: the headers are queued, and the
+    // caller runs the producer into streamBody(), then calls endStream().
+    bool respond(uint32_t stream_id, HTTPResponse& response, bool head_only) ;
+
+    // Queue produced bytes of a streamed body. Once streamBuffered() reaches
+    // STREAM_BUFFER, write output() (and, with the windows spent, process
+    // the client's WINDOW_UPDATEs) before producing more. False once the
+    // stream is gone (the client reset it).
+    bool streamBody(uint32_t stream_id, std::string_view data) ;
+    [[nodiscard]] size_t streamBuffered(uint32_t stream_id) const ;
+    void endStream(uint32_t stream_id) ;
+
+    // Frames ready to send, in order. The segments stay valid until sent().
+    [[nodiscard]] std::span<const Segment> output() ;
+
+    // Everything from the last output() has been written
+    void sent() ;
+
+    // Close once output() is drained: after a connection error, or once a
+    // GOAWAY was exchanged and the open streams are done
+    [[nodiscard]] bool done() const noexcept ;
+
+    // Stop taking new streams; the ones already open are still served
+    void goAway() ;
+
+    [[nodiscard]] size_t openStreams() const noexcept { return streams_.size() ; }
+
+private:
+    static constexpr uint8_t NO_URGENCY = 0xFF ;
+
+    struct Stream {
+        // Request
+        std::string bytes ;                 // Decoded header names and values
+        std::vector<hpack::Field> fields ;
+        std::string body ;
+        bool headers_done = false ;
+        bool end_received = false ;         // Rest of the request (half-closed remote)
+        bool ready = false ;                // Waiting in ready_ for nextRequest()
+        int64_t receive_window = 0 ;
+
+        // Priority (RFC 9218)
+        uint8_t urgency = 3 ;
+        bool incremental = false ;
+        bool priority_set = false ;         // By a priority header or PRIORITY_UPDATE
+
+        // Response
+        int64_t send_window = 0 ;
+        bool responded = false ;
+        SharedBody body_out ;
+        std::optional<FileBody> file_out ;
+        std::string stream_out ;            // Streamed body, produced and not yet framed past out_offset
+        bool streamed = false ;             // The body comes from stream_out
+        bool producing = false ;            // Its producer may still add to it
+        uint64_t out_offset = 0 ;
+        uint64_t out_remaining = 0 ;
+    } ;
+
+    // Output pieces, converted to Segments by output(); `offset` indexes
+    // out_ when neither data nor file is set
+    struct Piece {
+        const char* data = nullptr ;
+        const utils::FileHandle* file = nullptr ;
+        uint64_t offset = 0 ;
+        uint64_t length = 0 ;
+    } ;
+
+    Http2Options options_ ;
+    hpack::Decoder decoder_ ;
+    hpack::Encoder encoder_ ;
+
+    // Input
+    std::string in_ ;
+    size_t in_start_ = 0 ;
+    size_t in_size_ = 0 ;
+    bool preface_received_ = false ;
+
+    // Header block being received across CONTINUATION frames (0 = none)
+    uint32_t continuation_stream_ = 0 ;
+    bool continuation_end_stream_ = false ;
+    uint8_t block_urgency_ = NO_URGENCY ;   // From the HEADERS priority fields
+    std::string header_block_ ;
+
+    // Header blocks of refused streams and trailers: decoded, then dropped
+    std::string discarded_ ;
+    std::vector<hpack::Field> discarded_fields_ ;
+
+    // Streams
+    std::unordered_map<uint32_t, Stream> streams_ ;
+    std::vector<uint32_t> ready_ ;
+    std::vector<uint32_t> sending_ ;        // With DATA left to send; incremental ones rotate
+    uint32_t last_stream_id_ = 0 ;          // Highest stream the client opened
+
+    // Peer settings and windows
+    uint32_t peer_max_frame_size_ = 16384 ;
+    uint32_t peer_initial_window_ = 65535 ;
+    int64_t send_window_ = 65535 ;
+    int64_t receive_window_ = 65535 ;
+
+    // Output
+    std::string out_ ;
+    std::vector<Piece> pieces_ ;
+    std::vector<Segment> segments_ ;
+    std::vector<std::shared_ptr<const void>> sending_bodies_ ;  // Held until sent()
+    std::string block_ ;                    // Response header block being encoded
+    std::string name_ ;                     // Lowercased response header name
+
+    bool going_away_ = false ;
+    bool goaway_received_ = false ;
+    bool failed_ = false ;
+
+    bool parseFrame(uint8_t type, uint8_t flags, uint32_t stream_id, std::string_view payload) ;
+    bool onData(uint8_t flags, uint32_t stream_id, std::string_view payload) ;
+    bool onHeaders(uint8_t flags, uint32_t stream_id, std::string_view payload) ;
+    bool onContinuation(uint8_t flags, uint32_t stream_id, std::string_view payload) ;
+    bool onHeaderBlock(uint32_t stream_id, bool end_stream) ;
+    bool onSettings(uint8_t flags, uint32_t stream_id, std::string_view payload) ;
+    bool onWindowUpdate(uint32_t stream_id, std::string_view payload) ;
+    bool onPriorityUpdate(std::string_view payload) ;
+    void onRequestEnd(uint32_t stream_id, Stream& stream) ;
+    bool discardHeaderBlock() ;
+
+    // Checks the request for RFC 9113 §8.3 and builds it; nullopt if malformed
+    [[nodiscard]] std::optional<HTTPRequest> buildRequest(Stream& stream) ;
+
+    // Answer a request the session refuses itself (413, 431)
+    void reject(uint32_t stream_id, uint16_t status) ;
+
+    bool connectionError(Http2Error error) ;
+    void resetStream(uint32_t stream_id, Http2Error error) ;
+    void closeStream(uint32_t stream_id) ;
+
+    // The response is out: close, or reset if the request is still arriving
+    void finishStream(uint32_t stream_id, const Stream& stream) ;
+
+    void writeFrameHeader(size_t length, uint8_t type, uint8_t flags, uint32_t stream_id) ;
+    void writeFrame(uint8_t type, uint8_t flags, uint32_t stream_id, std::string_view payload) ;
+    void writeHeaders(uint32_t stream_id, std::string_view block, bool end_stream) ;
+    void writeWindowUpdate(uint32_t stream_id, uint32_t increment) ;
+    void appendPiece(const Piece& piece) ;
+
+    // DATA frames for the most urgent streams, within the windows
+    void scheduleData() ;
+} ;
+
+} // namespace frqs::http
@@ -11,6 +11,7 @@
  * 
  */
 
+#include "static_map.hpp"
 #include <cstdint>
 #include <string_view>
 
@@ -27,15 +28,23 @@ enum class Method : uint8_t {
     UNKNOWN
 } ;
 
+namespace detail {
+
+// Method names are case-sensitive (RFC 9110 section 9.1)
+inline constexpr StaticMap<Method, 7> METHODS({{
+    {"GET", Method::GET},
+    {"POST", Method::POST},
+    {"PUT", Method::PUT},
+    {"DELETE", Method::DELETE},
+    {"HEAD", Method::HEAD},
+    {"OPTIONS", Method::OPTIONS},
+    {"PATCH", Method::PATCH}
+}}) ;
+
+} // namespace detail
+
 [[nodiscard]] constexpr Method parseMethod(std::string_view str) noexcept {
-    if (str == "GET") return Method::GET ;
-    if (str == "POST") return Method::POST ;
-    if (str == "PUT") return Method::PUT ;
-    if (str == "DELETE") return Method::DELETE ;
-    if (str == "HEAD") return Method::HEAD ;
-    if (str == "OPTIONS") return Method::OPTIONS ;
-    if (str == "PATCH") return Method::PATCH ;
-    return Method::UNKNOWN ;
+    return detail::METHODS.get(str, Method::UNKNOWN) ;
 }
 
 [[nodiscard]] constexpr std::string_view methodToString(Method method) noexcept {
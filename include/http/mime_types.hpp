@@ -20,6 +20,8 @@ class MimeTypes {
 public:
     [[nodiscard]] static std::string_view fromExtension(std::string_view ext) noexcept;
     [[nodiscard]] static std::string_view fromPath(const std::filesystem::path& path) noexcept;
+    // Whether responses of this type benefit from gzip/brotli (parameters ignored)
+    [[nodiscard]] static bool isCompressible(std::string_view mime_type) noexcept;
     [[nodiscard]] static constexpr std::string_view defaultType() noexcept {
         return "application/octet-stream";
     }
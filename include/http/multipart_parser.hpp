@@ -3,7 +3,7 @@
 /**
  * @file http/multipart_parser.hpp
  * @author zuudevs (zuudevs@gmail.com)
- * @brief 
+ * @brief
  * @version 1.0.0
  * @date 2025-12-09
  * 
@@ -11,6 +11,11 @@
  * 
  */
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -24,9 +29,132 @@ struct MultipartPart {
     std::string name;
     std::string filename;
     std::string content_type;
-    std::vector<uint8_t> data;
+    std::vector<uint8_t> data;  // Empty while streaming (the sink gets the bytes)
 };
 
+/**
+ * @brief Receives one part's body as it is parsed
+ * 
+ * Called with consecutive pieces of the body, then once with last = true
+ * (data may be empty) when the part ends. Return false to abort parsing.
+ */
+using PartSink = std::function<bool(std::string_view data, bool last)>;
+
+/**
+ * @brief Chooses where a part's body goes, given its headers
+ * 
+ * Return an empty PartSink to discard the body.
+ */
+using PartSinkFactory = std::function<PartSink(const MultipartPart& part)>;
+
+/**
+ * @brief Sink that writes a part to a new file
+ * 
+ * The file is created (or truncated) when the sink is made; if the part
+ * does not end normally, the partial file is removed. Returns an empty
+ * sink if the file cannot be created.
+ */
+[[nodiscard]] PartSink fileSink(const std::filesystem::path& path);
+
+/// Boundary parameter of a `multipart/form-data` Content-Type, unquoted
+[[nodiscard]] std::optional<std::string_view> multipartBoundary(std::string_view content_type) noexcept;
+
+/**
+ * @brief Incremental multipart/form-data parser
+ * 
+ * feed() accepts the body in pieces of any size and hands each part's
+ * bytes to the sink chosen for it, without collecting the body. Only a
+ * part's headers and a tail shorter than the boundary are kept between
+ * calls, so memory stays constant regardless of the upload size.
+ * 
+ * Boundaries are located with Boyer-Moore-Horspool, which skips ahead by
+ * up to the delimiter length (boundary + 4 bytes) per comparison.
+ * 
+ * @example
+ * ```cpp
+ * MultipartStreamParser parser(boundary, [](const MultipartPart& part) -> PartSink {
+ *     if (part.filename.empty()) return {};
+ *     return fileSink(upload_dir / safeName(part.filename));
+ * });
+ * while (auto chunk = nextBodyChunk()) {
+ *     if (parser.feed(*chunk) == MultipartStreamParser::Status::Error) break;
+ * }
+ * bool ok = parser.status() == MultipartStreamParser::Status::Complete;
+ * ```
+ */
+class MultipartStreamParser {
+public:
+    enum class Status : uint8_t {
+        NeedMore,   // Closing boundary not seen yet
+        Complete,   // Closing boundary seen; further input is ignored
+        Error       // Malformed, over a limit, or a sink aborted; see error()
+    };
+    
+    struct Limits {
+        size_t max_header_bytes = 16 * 1024;    // Per part
+        size_t max_parts = 1024;
+    };
+    
+    MultipartStreamParser(std::string_view boundary, PartSinkFactory factory);
+    MultipartStreamParser(std::string_view boundary, PartSinkFactory factory, Limits limits);
+    
+    // Parse the next piece of the body
+    Status feed(std::string_view data);
+    
+    [[nodiscard]] Status status() const noexcept { return status_; }
+    [[nodiscard]] std::string_view error() const noexcept { return error_; }
+    
+    // Parts whose headers have been parsed so far
+    [[nodiscard]] size_t partCount() const noexcept { return part_count_; }
+
+private:
+    enum class State : uint8_t {
+        Preamble,       // Before the first boundary (discarded)
+        AfterBoundary,  // "\r\n" (next part) or "--" (end) expected
+        Headers,
+        Body,
+        Done
+    };
+    
+    // Horspool searcher for the delimiter "\r\n--" + boundary
+    struct Searcher {
+        std::string pattern;
+        std::array<size_t, 256> skip{};
+        
+        void build(std::string_view needle);
+        [[nodiscard]] size_t find(std::string_view text) const noexcept;
+    };
+    
+    Searcher delimiter_;
+    PartSinkFactory factory_;
+    Limits limits_;
+    
+    State state_ = State::Preamble;
+    Status status_ = Status::NeedMore;
+    std::string_view error_;
+    
+    std::string carry_;         // Unemitted tail that may start a delimiter
+    std::string window_;        // carry_ + the start of the next piece
+    std::string header_buf_;    // Current part's header section
+    std::string after_;         // Bytes after a boundary, up to its CRLF
+    MultipartPart part_;
+    PartSink sink_;
+    size_t part_count_ = 0;
+    
+    std::string_view consumeBody(std::string_view data);
+    std::string_view consumeHeaders(std::string_view data);
+    std::string_view consumeAfterBoundary(std::string_view data);
+    bool emit(std::string_view data);
+    bool endPart();
+    Status fail(std::string_view message) noexcept;
+};
+
+/**
+ * @brief Buffered multipart parser
+ * 
+ * Collects every part in memory (built on MultipartStreamParser). Fine for
+ * form fields and small files; large uploads should stream instead.
+ */
 class MultipartParser {
 public:
     MultipartParser() = default;
@@ -35,22 +163,18 @@ public:
     [[nodiscard]] bool parse(std::string_view body, std::string_view boundary);
     
     // Get parsed parts
-    [[nodiscard]] const std::vector<MultipartPart>& getParts() const noexcept { 
-        return parts_; 
+    [[nodiscard]] const std::vector<MultipartPart>& getParts() const noexcept {
+        return parts_;
     }
     
-    // Find part by field name
-    [[nodiscard]] std::optional<MultipartPart> findPart(std::string_view name) const;
+    // Find part by field name; valid until the next parse()
+    [[nodiscard]] const MultipartPart* findPart(std::string_view name) const noexcept;
     
-    // Get all file parts
-    [[nodiscard]] std::vector<MultipartPart> getFileParts() const;
+    // Get all file parts; valid until the next parse()
+    [[nodiscard]] std::vector<const MultipartPart*> getFileParts() const;
 
 private:
     std::vector<MultipartPart> parts_;
-    
-    void parsePartHeaders(std::string_view header_section, MultipartPart& part);
-    void parseContentDisposition(std::string_view value, MultipartPart& part);
-    static std::string trim(std::string_view str);
 };
 
-} // namespace frqs::http
\ No newline at end of file
+} // namespace frqs::http
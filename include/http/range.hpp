@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+ * @file http/range.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Range requests: byte-range parsing and multipart/byteranges framing (RFC 9110 section 14)
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace frqs::http {
+
+struct ByteRange {
+    uint64_t offset = 0 ;
+    uint64_t length = 0 ;
+
+    [[nodiscard]] uint64_t last() const noexcept { return offset + length - 1 ; }
+} ;
+
+/**
+ * @brief Resolve `Range: bytes=...` against a representation of `size` bytes
+ *
+ * Handles `first-last`, `first-` and `-suffix` specs. Specs past the end
+ * are dropped; overlapping or adjacent ones are merged, so no byte is sent
+ * twice however the ranges are written.
+ *
+ * @return nullopt when the header is to be ignored (another unit, bad
+ *         syntax, more than max_ranges specs): send the whole
+ *         representation. An empty list when nothing is satisfiable: 416.
+ */
+[[nodiscard]] std::optional<std::vector<ByteRange>> parseRange(std::string_view header, uint64_t size,
+                                                               size_t max_ranges = 16) ;
+
+// "bytes 0-499/1234"
+[[nodiscard]] std::string contentRange(ByteRange range, uint64_t size) ;
+
+// "bytes */1234", for 416 responses
+[[nodiscard]] std::string unsatisfiedRange(uint64_t size) ;
+
+// A fresh boundary for a multipart/byteranges body
+[[nodiscard]] std::string byteRangesBoundary() ;
+
+// Delimiter and headers in front of one part of a multipart/byteranges body
+[[nodiscard]] std::string byteRangesPartHead(std::string_view boundary, std::string_view content_type,
+                                             ByteRange range, uint64_t size) ;
+
+// Closing delimiter of a multipart/byteranges body
+[[nodiscard]] std::string byteRangesTail(std::string_view boundary) ;
+
+} // namespace frqs::http
@@ -12,13 +12,19 @@
  */
 
 #include "method.hpp"
+#include "header_map.hpp"
+#include "utils/buffer_pool.hpp"
 #include <string>
 #include <string_view>
-#include <unordered_map>
 #include <optional>
+#include <utility>
+#include <vector>
 
 namespace frqs::http {
 
+class RequestParser ;
+class Http2Session ;
+
 class HTTPRequest {
 public:
     static constexpr size_t MAX_REQUEST_SIZE = 1024 * 1024 ; // 1MB limit
@@ -34,10 +40,17 @@ public:
     [[nodiscard]] std::string_view getQueryString() const noexcept { return query_string_ ; }
     [[nodiscard]] std::string_view getVersion() const noexcept { return version_ ; }
     
-    [[nodiscard]] std::optional<std::string_view> getHeader(std::string_view name) const noexcept ;
+    [[nodiscard]] std::optional<std::string_view> getHeader(std::string_view name) const noexcept {
+        return headers_.get(name) ;
+    }
+    [[nodiscard]] std::optional<std::string_view> getHeader(KnownHeader id) const noexcept {
+        return headers_.get(id) ;
+    }
+    // Value of the last `name` in the query string ("" for a bare `name`)
     [[nodiscard]] std::optional<std::string_view> getQueryParam(std::string_view name) const noexcept ;
     
-    [[nodiscard]] const auto& getHeaders() const noexcept { return headers_ ; }
+    [[nodiscard]] const HeaderMap& getHeaders() const noexcept { return headers_ ; }
+    // Every name/value pair in query string order, repeated names included
     [[nodiscard]] const auto& getQueryParams() const noexcept { return query_params_ ; }
     
     [[nodiscard]] std::string_view getBody() const noexcept { return body_ ; }
@@ -47,36 +60,31 @@ public:
     [[nodiscard]] std::string_view getError() const noexcept { return error_message_ ; }
 
 private:
-    // Backing storage for the raw request (owns the data)
-    std::string raw_request_ ;
+    // Pooled buffer the views below point into, shared with the parser
+    // that received the request (and with any copy of this request)
+    utils::SharedBuffer storage_ ;
     
-    // Zero-copy views into raw_request_
+    // Zero-copy views into storage_
     Method method_ = Method::UNKNOWN ;
     std::string_view path_ ;
     std::string_view query_string_ ;
     std::string_view version_ ;
     std::string_view body_ ;
     
-    // Headers and query params (keys/values are views into raw_request_)
-    std::unordered_map<std::string_view, std::string_view> headers_ ;
-    std::unordered_map<std::string_view, std::string_view> query_params_ ;
+    // Headers and query params (keys/values are views into storage_)
+    HeaderMap headers_ ;
+    // A handful per request: a linear scan beats hashing, and clear()
+    // keeps the capacity for the next request parsed into this object
+    std::vector<std::pair<std::string_view, std::string_view>> query_params_ ;
     
     bool is_valid_ = false ;
     std::string_view error_message_ ;
     
-    // Helper parsing functions
-    bool parseRequestLine(std::string_view line) noexcept ;
-    void parseHeaders(std::string_view header_section) noexcept ;
-    void parseQueryString() noexcept ;
-    
-    // Case-insensitive comparison for header names
-    struct CaseInsensitiveHash {
-        size_t operator()(std::string_view sv) const noexcept ;
-    } ;
+    // The incremental parser and HTTP/2 streams fill in the views directly
+    friend class RequestParser ;
+    friend class Http2Session ;
     
-    struct CaseInsensitiveEqual {
-        bool operator()(std::string_view a, std::string_view b) const noexcept ;
-    } ;
+    void parseQueryString() noexcept ;
 } ;
 
 } // namespace frqs::http
\ No newline at end of file
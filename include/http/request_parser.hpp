@@ -0,0 +1,244 @@
+#pragma once
+
+/**
+ * @file http/request_parser.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Incremental (resumable) HTTP/1.x request parser
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "request.hpp"
+#include "utils/buffer_pool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace frqs::http {
+
+enum class ParseStatus : uint8_t {
+    NeedMore,   // Message incomplete, feed more bytes
+    Complete,   // request() is ready
+    Error       // Malformed or over a limit, see error()/errorStatus()
+} ;
+
+/**
+ * @brief Resumable state-machine parser for HTTP/1.x requests
+ *
+ * Bytes are appended to an internal buffer either by feed() or, to avoid a
+ * copy, by receiving straight into prepare() and calling commit(). Each call
+ * continues from where the previous one stopped, so no byte is scanned
+ * twice regardless of how the request is split across TCP segments.
+ *
+ * Lines end in CRLF; a bare LF is accepted, a bare CR is rejected. Header
+ * lines are scanned once with a vectorized search for CR, LF and ':'.
+ *
+ * Supported framing:
+ * - `Content-Length`
+ * - `Transfer-Encoding: chunked` (decoded in place; trailers are skipped).
+ *   Other transfer codings are refused with 501, and a request with both
+ *   Content-Length and Transfer-Encoding with 400.
+ *
+ * Once a message is Complete, the bytes after it (pipelined requests) stay
+ * buffered; next() discards the finished message and parses them.
+ *
+ * With setPauseBeforeBody(true) the parser stops once the headers of a
+ * message with a body are in (bodyPending()), so the caller can either
+ * buffer the body as usual (resume()) or stream it (streamBody()). A
+ * streamed body is handed out through takeBody() as it is decoded and
+ * then dropped from the buffer, so it may be far larger than
+ * max_body_bytes without the buffer growing.
+ *
+ * The buffer comes from utils::BufferPool. The HTTPRequest returned by
+ * request() holds a reference to it, so a copy of the request stays valid
+ * after the parser moves on: next() only reuses the bytes in place when
+ * no such copy exists. The reference returned by request() itself is
+ * only valid until the next prepare()/feed()/next() call.
+ *
+ * @example
+ * ```cpp
+ * RequestParser parser;
+ * while (parser.status() == ParseStatus::NeedMore) {
+ *     auto space = parser.prepare(16384);
+ *     size_t n = socket.receive(space.data(), space.size());
+ *     parser.commit(n);
+ * }
+ * if (parser.status() == ParseStatus::Complete) {
+ *     handle(parser.request());
+ * }
+ * ```
+ */
+class RequestParser {
+public:
+    struct Limits {
+        size_t max_header_bytes = 64 * 1024 ;                   // Request line + headers
+        size_t max_body_bytes = HTTPRequest::MAX_REQUEST_SIZE ; // Decoded body
+    } ;
+
+    RequestParser() = default ;
+    explicit RequestParser(Limits limits) : limits_(limits) {}
+
+    // ========== INPUT ==========
+
+    // Copy bytes into the buffer and continue parsing
+    ParseStatus feed(std::string_view data) ;
+
+    // Writable space of at least min_size bytes at the end of the buffer
+    [[nodiscard]] std::span<char> prepare(size_t min_size) ;
+
+    // Mark n bytes written into prepare() space as received and continue parsing
+    ParseStatus commit(size_t n) ;
+
+    // Discard the completed message and parse any pipelined bytes after it
+    ParseStatus next() ;
+
+    // ========== PROGRESS ==========
+
+    [[nodiscard]] ParseStatus status() const noexcept { return status_ ; }
+    [[nodiscard]] bool headersComplete() const noexcept { return state_ > State::Headers ; }
+    [[nodiscard]] bool isChunked() const noexcept { return chunked_ ; }
+    [[nodiscard]] bool expectsContinue() const noexcept { return expect_continue_ ; }
+    [[nodiscard]] std::optional<size_t> contentLength() const noexcept { return content_length_ ; }
+
+    // Decoded body bytes received so far for the current message
+    [[nodiscard]] size_t bodyReceived() const noexcept { return body_length_ ; }
+
+    // True if bytes beyond the current message are buffered
+    [[nodiscard]] bool hasBufferedData() const noexcept { return size_ > message_end_ ; }
+
+    // Bytes received from the start of the current message on
+    [[nodiscard]] std::string_view buffered() const noexcept {
+        return {buffer_.data() + message_start_, size_ - message_start_} ;
+    }
+
+    // Request line of the current message, once headersComplete()
+    [[nodiscard]] Method method() const noexcept ;
+    [[nodiscard]] std::string_view path() const noexcept ;
+
+    // ========== BODY STREAMING ==========
+
+    // Stop after the headers of each message that has a body
+    void setPauseBeforeBody(bool pause) noexcept { pause_before_body_ = pause ; }
+
+    // Stopped after the headers; call resume() or streamBody()
+    [[nodiscard]] bool bodyPending() const noexcept { return paused_ ; }
+
+    // Buffer the pending body (max_body_bytes applies)
+    ParseStatus resume() ;
+
+    // Stream the pending body, up to max_bytes (0 = unlimited). request()
+    // is available right away, with an empty body.
+    ParseStatus streamBody(size_t max_bytes) ;
+
+    [[nodiscard]] bool isStreaming() const noexcept { return streaming_ ; }
+
+    // Body bytes decoded since the last call (streaming only); valid until
+    // the next prepare(), feed() or next()
+    [[nodiscard]] std::string_view takeBody() noexcept ;
+
+    // ========== RESULT ==========
+
+    [[nodiscard]] const HTTPRequest& request() const noexcept { return request_ ; }
+
+    [[nodiscard]] std::string_view error() const noexcept { return error_ ; }
+
+    // Suggested response status for the error (400, 413, 431, 501, 505)
+    [[nodiscard]] uint16_t errorStatus() const noexcept { return error_status_ ; }
+
+    void reset() noexcept ;
+
+    // Return the buffer to the pool if no bytes are pending (idle keep-alive)
+    void releaseBuffer() noexcept ;
+
+private:
+    friend class HTTPRequest ;
+
+    enum class State : uint8_t {
+        RequestLine,
+        Headers,
+        Body,
+        ChunkSize,
+        ChunkData,
+        ChunkTrailers,
+        Done
+    } ;
+
+    // Offsets into buffer_ (views are materialized once the message completes)
+    struct Span {
+        size_t offset = 0 ;
+        size_t length = 0 ;
+    } ;
+
+    struct FieldSpan {
+        Span name ;
+        Span value ;
+        KnownHeader id = KnownHeader::Unknown ;
+    } ;
+
+    // A complete line without its terminator
+    struct Line {
+        std::string_view text ;
+        size_t colon ;          // Offset of the first ':' (header lines only), or NO_COLON
+    } ;
+
+    static constexpr size_t NO_COLON = static_cast<size_t>(-1) ;
+
+    Limits limits_ ;
+    utils::SharedBuffer buffer_ ;
+    size_t size_ = 0 ;           // Bytes of buffer_ holding received data
+    size_t message_start_ = 0 ;  // Start of the current message
+    size_t message_end_ = 0 ;    // End of the complete message (Done only)
+    size_t scan_pos_ = 0 ;       // Next unparsed byte
+    size_t line_scan_ = 0 ;      // Resume point for the current line search
+    size_t line_colon_ = NO_COLON ;  // First ':' of the current line, once scanned past
+
+    State state_ = State::RequestLine ;
+    ParseStatus status_ = ParseStatus::NeedMore ;
+
+    Span method_ ;
+    Span target_ ;
+    Span version_ ;
+    std::vector<FieldSpan> headers_ ;
+
+    std::optional<size_t> content_length_ ;
+    bool chunked_ = false ;
+    bool expect_continue_ = false ;
+    size_t body_start_ = 0 ;
+    size_t body_length_ = 0 ;    // Decoded body bytes (streamed ones included)
+    size_t body_limit_ = limits_.max_body_bytes ;
+    size_t chunk_remaining_ = 0 ;
+    size_t trailer_bytes_ = 0 ;
+
+    bool pause_before_body_ = false ;
+    bool paused_ = false ;
+    bool streaming_ = false ;
+    size_t body_taken_ = 0 ;     // Streamed bytes handed out by takeBody()
+    size_t body_dropped_ = 0 ;   // Streamed bytes no longer in the buffer
+
+    HTTPRequest request_ ;
+    std::string_view error_ ;
+    uint16_t error_status_ = 400 ;
+
+    ParseStatus parse() ;
+    std::optional<Line> nextLine(bool find_colon) ;
+    bool onRequestLine(std::string_view line, size_t offset) ;
+    bool onHeaderLine(const Line& line, size_t offset) ;
+    bool onHeadersEnd() ;
+    bool onChunkSize(std::string_view line) ;
+    ParseStatus fail(std::string_view message, uint16_t status) noexcept ;
+    ParseStatus finish() ;
+    void regrow(size_t capacity) ;
+    void dropTakenBody() noexcept ;
+
+    // Bind the views of `out` to the current buffer and take a reference to it
+    void materialize(HTTPRequest& out) const ;
+} ;
+
+} // namespace frqs::http
@@ -11,21 +11,97 @@
  * 
  */
 
+#include "utils/filesystem_utils.hpp"
+#include <functional>
 #include <string>
 #include <string_view>
-#include <unordered_map>
+#include <memory_resource>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <memory>
 #include <cstdint>
 
 namespace frqs::http {
 
+/**
+ * @brief Body served directly from an open file (sendfile/TransmitFile)
+ */
+struct FileBody {
+    std::shared_ptr<const utils::FileHandle> file ;
+    uint64_t offset = 0 ;
+    uint64_t length = 0 ;
+} ;
+
+/**
+ * @brief Immutable body bytes kept alive by an owner (a cached string, a mapped file)
+ */
+struct SharedBody {
+    std::string_view bytes ;
+    std::shared_ptr<const void> owner ;
+} ;
+
+/**
+ * @brief Destination of a streamed response body
+ *
+ * Small writes are coalesced; a full buffer goes out as one chunk. write()
+ * blocks while the socket's send buffer is full, which paces the producer
+ * to the client. Both calls return false once the client is gone, after
+ * which the producer should stop.
+ */
+class BodyWriter {
+public:
+    virtual ~BodyWriter() = default ;
+
+    virtual bool write(std::string_view data) = 0 ;
+
+    // Send what is buffered now (e.g. after each server-sent event)
+    virtual bool flush() = 0 ;
+} ;
+
+/**
+ * @brief Producer of a streamed response body
+ *
+ * Called by the server after the handler has returned, with the headers
+ * already serialized; the body ends when it returns. The request is still
+ * valid then, the handler's Context is not, so capture by value.
+ */
+using StreamBody = std::function<void(BodyWriter& out)> ;
+
 class HTTPResponse {
 public:
     HTTPResponse() = default ;
     
+    // Header names and values (and a custom status message) are allocated
+    // from `resource`, e.g. the server's per-request arena. Such a response
+    // must not outlive the resource; copies use the default resource.
+    explicit HTTPResponse(std::pmr::memory_resource* resource) 
+        : status_message_("OK", resource), headers_(resource) {}
+    
     // Fluent API for building responses
     HTTPResponse& setStatus(uint16_t code, std::string_view message = "") ;
     HTTPResponse& setHeader(std::string_view name, std::string_view value) ;
+    
+    // Another field line with this name, after any already set; for fields
+    // that may repeat (Set-Cookie, Link, or headers relayed as received)
+    HTTPResponse& addHeader(std::string_view name, std::string_view value) ;
     HTTPResponse& setBody(std::string body) ;
+    
+    // File-backed body: the server sends it without copying it into memory.
+    // Replaces any string body (and vice versa).
+    HTTPResponse& setFileBody(std::shared_ptr<const utils::FileHandle> file,
+                              uint64_t offset, uint64_t length) ;
+    HTTPResponse& setFileBody(std::shared_ptr<const utils::FileHandle> file) ;
+    
+    // Shared immutable body (e.g. a cached asset), sent without copying
+    HTTPResponse& setSharedBody(std::shared_ptr<const std::string> body) ;
+    
+    // Bytes that `owner` keeps alive, e.g. a slice of a mapped asset bundle
+    HTTPResponse& setSharedBody(std::string_view bytes, std::shared_ptr<const void> owner) ;
+    
+    // Body produced while it is sent: chunked, unless a Content-Length
+    // header is set. Replaces any other body (and vice versa).
+    HTTPResponse& setStreamBody(StreamBody producer) ;
     HTTPResponse& setContentType(std::string_view type) ;
     
     // Common status codes
@@ -35,20 +111,58 @@ public:
     HTTPResponse& internalError(std::string body = "") ;
     HTTPResponse& forbidden(std::string body = "") ;
     
-    // Build the complete HTTP response
+    // Build the complete HTTP response (without a streamed body)
     [[nodiscard]] std::string build() const ;
     
+    // Append the status line and headers (through the blank line) to `out`.
+    // Pair with getBody() for a scatter-gather send without joining them;
+    // reusing `out` across responses avoids allocating per response.
+    void serializeHeaders(std::string& out) const ;
+    
     // Direct access
     [[nodiscard]] uint16_t getStatus() const noexcept { return status_code_ ; }
-    [[nodiscard]] const std::string& getBody() const noexcept { return body_ ; }
+    [[nodiscard]] std::string_view getStatusMessage() const noexcept { return status_message_ ; }
+    [[nodiscard]] std::string_view getBody() const noexcept { return shared_body_.owner ? shared_body_.bytes : body_ ; }
+    [[nodiscard]] const std::optional<FileBody>& getFileBody() const noexcept { return file_body_ ; }
+    [[nodiscard]] const StreamBody& getStreamBody() const noexcept { return stream_body_ ; }
+    [[nodiscard]] bool isStreaming() const noexcept { return static_cast<bool>(stream_body_) ; }
+    
+    // Hand the string body over (shared or not), leaving this response
+    // without one; for senders that outlive the response (HTTP/2)
+    [[nodiscard]] SharedBody releaseBody() ;
+    
+    // Length of whichever body is set (0 for a streamed body, not known up front)
+    [[nodiscard]] uint64_t bodySize() const noexcept {
+        return file_body_ ? file_body_->length : getBody().size() ;
+    }
+    // First header with this name (ignoring case)
+    [[nodiscard]] std::optional<std::string_view> getHeader(std::string_view name) const noexcept ;
+    
+    // All headers in insertion order (names unique ignoring case, except
+    // the ones repeated with addHeader())
+    [[nodiscard]] const auto& getHeaders() const noexcept { return headers_ ; }
+    
+    // Whether this status code allows a message body (not 1xx/204/304)
+    [[nodiscard]] static constexpr bool statusAllowsBody(uint16_t code) noexcept {
+        return code >= 200 && code != 204 && code != 304 ;
+    }
 
 private:
     uint16_t status_code_ = 200 ;
-    std::string status_message_ = "OK" ;
+    std::pmr::string status_message_ = std::pmr::string("OK") ;
     std::string body_ ;
-    std::unordered_map<std::string, std::string> headers_ ;
+    std::optional<FileBody> file_body_ ;
+    SharedBody shared_body_ ;
+    StreamBody stream_body_ ;
+    
+    // Insertion order, names unique ignoring case unless repeated with
+    // addHeader(); a handful per response, so a linear scan beats hashing
+    std::pmr::vector<std::pair<std::pmr::string, std::pmr::string>> headers_ ;
     
     [[nodiscard]] static std::string_view getDefaultStatusMessage(uint16_t code) noexcept ;
+    
+    // "HTTP/1.1 <code> <default message>\r\n" (http/status.hpp); empty if the code is unknown
+    [[nodiscard]] static std::string_view defaultStatusLine(uint16_t code) noexcept ;
 } ;
 
 } // namespace frqs::http
\ No newline at end of file
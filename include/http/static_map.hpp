@@ -0,0 +1,139 @@
+#pragma once
+
+/**
+ * @file http/static_map.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Compile-time perfect-hash maps for fixed protocol vocabularies
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace frqs::http {
+
+enum class KeyCase : uint8_t {
+    Sensitive,
+    Insensitive     // ASCII letters only, as tokens in HTTP are
+} ;
+
+/**
+ * @brief Immutable string-keyed map whose hash has no collisions
+ *
+ * The seed is searched at compile time until every key lands in its own
+ * slot, so a lookup is one hash over the key, one length check and one
+ * compare; nothing is allocated and nothing probes. Keys must be unique
+ * (ignoring case for KeyCase::Insensitive).
+ *
+ * @example
+ * ```cpp
+ * constexpr StaticMap<int, 2, KeyCase::Insensitive> sizes({{
+ *     {"small", 1}, {"large", 3}
+ * }}) ;
+ * static_assert(*sizes.find("LARGE") == 3) ;
+ * ```
+ */
+template<typename V, size_t N, KeyCase Case = KeyCase::Sensitive>
+class StaticMap {
+public:
+    struct Entry {
+        std::string_view key ;
+        V value{} ;
+    } ;
+
+    consteval explicit StaticMap(const std::array<Entry, N>& entries) {
+        for (uint32_t seed = 1 ; seed < MAX_SEED ; ++seed) {
+            if (tryBuild(entries, seed)) {
+                return ;
+            }
+        }
+        throw std::logic_error("StaticMap: no perfect hash seed (duplicate keys?)") ;
+    }
+
+    [[nodiscard]] constexpr const V* find(std::string_view key) const noexcept {
+        const auto& slot = slots_[indexOf(key, seed_)] ;
+        if (!slot.used || !equal(slot.key, key)) {
+            return nullptr ;
+        }
+        return &slot.value ;
+    }
+
+    [[nodiscard]] constexpr V get(std::string_view key, V fallback) const noexcept {
+        const V* value = find(key) ;
+        return value ? *value : fallback ;
+    }
+
+private:
+    // Four slots per key keeps the seed search short (tens of tries)
+    static constexpr size_t SLOTS = std::bit_ceil(N * 4) ;
+    static constexpr uint32_t MAX_SEED = 100000 ;
+
+    struct Slot {
+        std::string_view key ;
+        V value{} ;
+        bool used = false ;
+    } ;
+
+    std::array<Slot, SLOTS> slots_{} ;
+    uint32_t seed_ = 0 ;
+
+    static constexpr unsigned char fold(char c) noexcept {
+        auto byte = static_cast<unsigned char>(c) ;
+        if constexpr (Case == KeyCase::Insensitive) {
+            if (byte >= 'A' && byte <= 'Z') {
+                byte = static_cast<unsigned char>(byte | 0x20) ;
+            }
+        }
+        return byte ;
+    }
+
+    // FNV-1a, seeded; keys here are a few bytes long
+    static constexpr size_t indexOf(std::string_view key, uint32_t seed) noexcept {
+        uint32_t hash = 2166136261u ^ seed ^ static_cast<uint32_t>(key.size()) ;
+        for (char c : key) {
+            hash = (hash ^ fold(c)) * 16777619u ;
+        }
+        hash ^= hash >> 15 ;
+        return hash & (SLOTS - 1) ;
+    }
+
+    static constexpr bool equal(std::string_view a, std::string_view b) noexcept {
+        if (a.size() != b.size()) {
+            return false ;
+        }
+        if constexpr (Case == KeyCase::Sensitive) {
+            return a == b ;
+        } else {
+            for (size_t i = 0 ; i < a.size() ; ++i) {
+                if (fold(a[i]) != fold(b[i])) {
+                    return false ;
+                }
+            }
+            return true ;
+        }
+    }
+
+    constexpr bool tryBuild(const std::array<Entry, N>& entries, uint32_t seed) {
+        std::array<Slot, SLOTS> slots{} ;
+        for (const auto& entry : entries) {
+            auto& slot = slots[indexOf(entry.key, seed)] ;
+            if (slot.used) {
+                return false ;
+            }
+            slot = {entry.key, entry.value, true} ;
+        }
+        slots_ = slots ;
+        seed_ = seed ;
+        return true ;
+    }
+} ;
+
+} // namespace frqs::http
@@ -0,0 +1,151 @@
+#pragma once
+
+/**
+ * @file http/status.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Status reason phrases and preformatted HTTP/1.1 status lines
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace frqs::http {
+
+struct StatusReason {
+    uint16_t code ;
+    std::string_view reason ;
+} ;
+
+// Reason phrases the server knows (RFC 9110 section 15)
+inline constexpr std::array STATUS_REASONS = {
+    StatusReason{100, "Continue"},
+    StatusReason{101, "Switching Protocols"},
+    StatusReason{200, "OK"},
+    StatusReason{201, "Created"},
+    StatusReason{202, "Accepted"},
+    StatusReason{204, "No Content"},
+    StatusReason{206, "Partial Content"},
+    StatusReason{301, "Moved Permanently"},
+    StatusReason{302, "Found"},
+    StatusReason{303, "See Other"},
+    StatusReason{304, "Not Modified"},
+    StatusReason{307, "Temporary Redirect"},
+    StatusReason{308, "Permanent Redirect"},
+    StatusReason{400, "Bad Request"},
+    StatusReason{401, "Unauthorized"},
+    StatusReason{403, "Forbidden"},
+    StatusReason{404, "Not Found"},
+    StatusReason{405, "Method Not Allowed"},
+    StatusReason{408, "Request Timeout"},
+    StatusReason{409, "Conflict"},
+    StatusReason{410, "Gone"},
+    StatusReason{411, "Length Required"},
+    StatusReason{412, "Precondition Failed"},
+    StatusReason{413, "Content Too Large"},
+    StatusReason{414, "URI Too Long"},
+    StatusReason{415, "Unsupported Media Type"},
+    StatusReason{416, "Range Not Satisfiable"},
+    StatusReason{426, "Upgrade Required"},
+    StatusReason{429, "Too Many Requests"},
+    StatusReason{431, "Request Header Fields Too Large"},
+    StatusReason{500, "Internal Server Error"},
+    StatusReason{501, "Not Implemented"},
+    StatusReason{502, "Bad Gateway"},
+    StatusReason{503, "Service Unavailable"},
+    StatusReason{504, "Gateway Timeout"},
+    StatusReason{505, "HTTP Version Not Supported"}
+} ;
+
+namespace detail {
+
+inline constexpr uint16_t FIRST_STATUS = 100 ;
+inline constexpr uint16_t STATUS_RANGE = 500 ;   // 100..599
+
+constexpr size_t statusLineSize(const StatusReason& status) noexcept {
+    return std::string_view("HTTP/1.1 200 \r\n").size() + status.reason.size() ;
+}
+
+constexpr size_t statusLinesSize() noexcept {
+    size_t total = 0 ;
+    for (const auto& status : STATUS_REASONS) {
+        total += statusLineSize(status) ;
+    }
+    return total ;
+}
+
+/**
+ * @brief Every status line back to back, indexed by code
+ *
+ * The code is the index (a perfect hash with no hashing), so a lookup is
+ * two loads; the lines point into read-only data.
+ */
+struct StatusTable {
+    std::array<char, statusLinesSize()> text{} ;
+    std::array<uint16_t, STATUS_RANGE> offset{} ;
+    std::array<uint8_t, STATUS_RANGE> length{} ;     // 0: unknown code
+    std::array<uint8_t, STATUS_RANGE> reason{} ;     // Index into STATUS_REASONS
+} ;
+
+consteval StatusTable buildStatusTable() {
+    StatusTable table ;
+    size_t at = 0 ;
+    auto append = [&](std::string_view part) {
+        for (char c : part) {
+            table.text[at++] = c ;
+        }
+    } ;
+
+    for (size_t i = 0 ; i < STATUS_REASONS.size() ; ++i) {
+        const auto& status = STATUS_REASONS[i] ;
+        size_t index = status.code - FIRST_STATUS ;
+        if (index >= STATUS_RANGE || table.length[index] != 0) {
+            throw "STATUS_REASONS: code out of range or listed twice" ;
+        }
+        table.offset[index] = static_cast<uint16_t>(at) ;
+        table.length[index] = static_cast<uint8_t>(statusLineSize(status)) ;
+        table.reason[index] = static_cast<uint8_t>(i) ;
+
+        append("HTTP/1.1 ") ;
+        const char digits[] = {
+            static_cast<char>('0' + status.code / 100),
+            static_cast<char>('0' + status.code / 10 % 10),
+            static_cast<char>('0' + status.code % 10)
+        } ;
+        append(std::string_view(digits, 3)) ;
+        append(" ") ;
+        append(status.reason) ;
+        append("\r\n") ;
+    }
+    return table ;
+}
+
+inline constexpr StatusTable STATUS_TABLE = buildStatusTable() ;
+
+} // namespace detail
+
+// "HTTP/1.1 200 OK\r\n"; empty for codes without a known reason
+[[nodiscard]] constexpr std::string_view statusLine(uint16_t code) noexcept {
+    size_t index = static_cast<size_t>(code) - detail::FIRST_STATUS ;
+    if (code < detail::FIRST_STATUS || index >= detail::STATUS_RANGE || detail::STATUS_TABLE.length[index] == 0) {
+        return {} ;
+    }
+    return {detail::STATUS_TABLE.text.data() + detail::STATUS_TABLE.offset[index], detail::STATUS_TABLE.length[index]} ;
+}
+
+// "OK" for 200; empty for codes without a known reason
+[[nodiscard]] constexpr std::string_view statusReason(uint16_t code) noexcept {
+    size_t index = static_cast<size_t>(code) - detail::FIRST_STATUS ;
+    if (code < detail::FIRST_STATUS || index >= detail::STATUS_RANGE || detail::STATUS_TABLE.length[index] == 0) {
+        return {} ;
+    }
+    return STATUS_REASONS[detail::STATUS_TABLE.reason[index]].reason ;
+}
+
+} // namespace frqs::http
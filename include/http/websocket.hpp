@@ -0,0 +1,127 @@
+#pragma once
+
+/**
+ * @file http/websocket.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief WebSocket framing (RFC 6455): handshake key, frame parser, masking
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "request.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace frqs::http {
+
+enum class WsOpcode : uint8_t {
+    Continuation = 0x0,
+    Text = 0x1,
+    Binary = 0x2,
+    Close = 0x8,
+    Ping = 0x9,
+    Pong = 0xA
+} ;
+
+/**
+ * @brief Close status codes (RFC 6455 §7.4.1)
+ */
+struct WsCloseCode {
+    static constexpr uint16_t Normal          = 1000 ;
+    static constexpr uint16_t GoingAway       = 1001 ;
+    static constexpr uint16_t ProtocolError   = 1002 ;
+    static constexpr uint16_t UnsupportedData = 1003 ;
+    static constexpr uint16_t NoStatus        = 1005 ;  // Close frame without a code; never sent
+    static constexpr uint16_t Abnormal        = 1006 ;  // No close frame at all; never sent
+    static constexpr uint16_t InvalidPayload  = 1007 ;
+    static constexpr uint16_t PolicyViolation = 1008 ;
+    static constexpr uint16_t MessageTooBig   = 1009 ;
+    static constexpr uint16_t InternalError   = 1011 ;
+} ;
+
+// Whether the request is a valid WebSocket opening handshake (RFC 6455
+// §4.2.1): an HTTP/1.1 GET with Upgrade: websocket, Connection: upgrade,
+// version 13 and a 16-byte key
+[[nodiscard]] bool isWebSocketUpgrade(const HTTPRequest& request) noexcept ;
+
+// Sec-WebSocket-Accept for a Sec-WebSocket-Key: base64(SHA-1(key + GUID))
+[[nodiscard]] std::string webSocketAccept(std::string_view key) ;
+
+// XOR `size` bytes with a masking key, as if they started `phase` bytes
+// into the masked payload (so a payload can be unmasked in pieces)
+void applyWebSocketMask(char* data, size_t size, std::array<uint8_t, 4> key, size_t phase = 0) noexcept ;
+
+// Name of the masking implementation in use ("avx2", "sse2", "neon" or "scalar")
+[[nodiscard]] std::string_view webSocketMaskBackend() noexcept ;
+
+// Header of an unmasked (server) frame with a `length`-byte payload;
+// returns its size (2, 4 or 10)
+size_t writeWebSocketHeader(std::span<char, 10> out, WsOpcode opcode, uint64_t length, bool fin = true) noexcept ;
+
+// Header and payload of a complete unmasked frame
+[[nodiscard]] std::string encodeWebSocketFrame(WsOpcode opcode, std::string_view payload) ;
+
+/**
+ * @brief Incremental parser for the frames a client sends
+ *
+ * The caller receives into prepare()/commit() and calls next() until it
+ * returns NeedMore. Client frames must be masked; payloads are unmasked
+ * in the receive buffer and handed out as views, so an unfragmented
+ * message is never copied. Fragments are joined into one message, with
+ * control frames (Ping, Pong, Close) handed out as they arrive in
+ * between. Text messages are checked to be UTF-8.
+ */
+class WebSocketParser {
+public:
+    enum class Status : uint8_t {
+        NeedMore,
+        Message,
+        Error
+    } ;
+
+    struct Message {
+        WsOpcode opcode = WsOpcode::Binary ;   // Text, Binary, Close, Ping or Pong
+        std::string_view payload ;             // Valid until the next call to next() or prepare()
+    } ;
+
+    explicit WebSocketParser(size_t max_message_size = 16 * 1024 * 1024)
+        : max_message_size_(max_message_size) {}
+
+    // Writable space of at least min_size bytes at the end of the input
+    [[nodiscard]] std::span<char> prepare(size_t min_size) ;
+    void commit(size_t n) ;
+
+    // Copy bytes in (what the HTTP parser received after the handshake, say)
+    void feed(std::string_view data) ;
+
+    [[nodiscard]] Status next(Message& out) ;
+
+    // After Error: the close code to answer with (1002, 1007 or 1009) and why
+    [[nodiscard]] uint16_t errorCode() const noexcept { return error_code_ ; }
+    [[nodiscard]] std::string_view error() const noexcept { return error_ ; }
+
+private:
+    std::string in_ ;
+    size_t in_start_ = 0 ;
+    size_t in_size_ = 0 ;
+    size_t max_message_size_ ;
+
+    // Fragmented message being joined
+    std::string fragments_ ;
+    WsOpcode fragment_opcode_ = WsOpcode::Binary ;
+    bool fragmented_ = false ;
+
+    uint16_t error_code_ = 0 ;
+    std::string_view error_ ;
+
+    Status fail(uint16_t code, std::string_view why) noexcept ;
+} ;
+
+} // namespace frqs::http
@@ -0,0 +1,64 @@
+#pragma once
+
+/**
+ * @file net/dns_cache.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Host name resolution with a TTL cache
+ * @version 1.0.0
+ * @date 2025-12-15
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "ipv4.hpp"
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace frqs::net {
+
+/**
+ * @brief Caches getaddrinfo() results (IPv4) per host name
+ * 
+ * A hit is a map lookup under a mutex; a miss resolves outside the lock,
+ * so one slow lookup does not stall callers asking for other hosts.
+ * Failures are cached too, for a shorter time, so an unknown host does
+ * not turn every request into a resolver round trip. Literals and
+ * "localhost" go through the same path (getaddrinfo handles them).
+ */
+class DnsCache {
+public:
+    static constexpr std::chrono::milliseconds DEFAULT_TTL{60'000} ;
+    static constexpr std::chrono::milliseconds NEGATIVE_TTL{5'000} ;
+    
+    explicit DnsCache(std::chrono::milliseconds ttl = DEFAULT_TTL) noexcept : ttl_(ttl) {}
+    
+    DnsCache(const DnsCache&) = delete ;
+    DnsCache& operator=(const DnsCache&) = delete ;
+    
+    // First IPv4 address of `host`, or nullopt if it does not resolve
+    [[nodiscard]] std::optional<IPv4> resolve(std::string_view host) ;
+    
+    // Forget every entry (e.g. after a known address change)
+    void clear() ;
+    
+    [[nodiscard]] size_t size() const ;
+
+private:
+    struct Entry {
+        std::optional<IPv4> address ;
+        std::chrono::steady_clock::time_point expires ;
+    } ;
+    
+    [[nodiscard]] static std::optional<IPv4> lookup(const std::string& host) ;
+    
+    std::chrono::milliseconds ttl_ ;
+    mutable std::mutex mutex_ ;
+    std::unordered_map<std::string, Entry> entries_ ;
+} ;
+
+} // namespace frqs::net
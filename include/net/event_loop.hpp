@@ -0,0 +1,128 @@
+#pragma once
+
+/**
+ * @file net/event_loop.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Readiness-based I/O multiplexer (epoll / kqueue / WSAPoll)
+ * @version 1.0.0
+ * @date 2025-12-14
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "socket.hpp"
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#ifdef _WIN32
+    #include <mutex>
+    #include <vector>
+    #include <unordered_map>
+#endif
+
+namespace frqs::net {
+
+/**
+ * @brief Readiness flags reported by and registered with EventLoop
+ */
+struct IoEvent {
+    static constexpr uint32_t None   = 0 ;
+    static constexpr uint32_t Read   = 1u << 0 ;
+    static constexpr uint32_t Write  = 1u << 1 ;
+    static constexpr uint32_t Closed = 1u << 2 ;  // Hangup or socket error
+} ;
+
+/**
+ * @brief One ready handle returned by EventLoop::wait()
+ */
+struct ReadyEvent {
+    void* data = nullptr ;     // User pointer given at registration
+    uint32_t events = 0 ;      // IoEvent flags
+} ;
+
+/**
+ * @brief Kernel interface an EventLoop is built on
+ */
+enum class LoopBackend : uint8_t {
+    Native,     // epoll / kqueue / WSAPoll
+    IoUring,    // io_uring poll requests (Linux 6.1+), else Native
+} ;
+
+#if defined(__linux__)
+class UringPoller ;
+#endif
+
+/**
+ * @brief Thin wrapper over the platform readiness API
+ *
+ * Backends:
+ * - Linux: epoll (eventfd for wakeups), or io_uring when asked for and
+ *   available (see UringPoller)
+ * - BSD/macOS: kqueue (EVFILT_USER for wakeups)
+ * - Windows: WSAPoll (loopback UDP socket for wakeups)
+ *
+ * Handles registered with `oneshot = true` are disarmed after their first
+ * event and must be re-armed with rearm(). This lets a reactor hand a ready
+ * connection to exactly one worker at a time.
+ *
+ * add/rearm/remove are safe to call from any thread while another thread
+ * is blocked in wait().
+ */
+class EventLoop {
+public:
+    using native_handle_t = Socket::native_handle_t ;
+
+    explicit EventLoop(LoopBackend backend = LoopBackend::Native) ;
+    ~EventLoop() ;
+
+    EventLoop(const EventLoop&) = delete ;
+    EventLoop& operator=(const EventLoop&) = delete ;
+    EventLoop(EventLoop&&) = delete ;
+    EventLoop& operator=(EventLoop&&) = delete ;
+
+    void add(native_handle_t handle, uint32_t events, void* data, bool oneshot = false) ;
+    void rearm(native_handle_t handle, uint32_t events, void* data) ;
+    void remove(native_handle_t handle) noexcept ;
+
+    /**
+     * @brief Wait for ready handles
+     * @param out Destination for ready events
+     * @param timeout_ms Maximum wait (-1 = infinite)
+     * @return Number of events written to out (0 on timeout or wakeup)
+     */
+    size_t wait(std::span<ReadyEvent> out, int timeout_ms) ;
+
+    /**
+     * @brief Interrupt a concurrent wait() call
+     */
+    void wakeup() noexcept ;
+
+    // The backend in use: "epoll", "io_uring", "kqueue" or "wsapoll"
+    [[nodiscard]] std::string_view backend() const noexcept ;
+
+private:
+#ifdef _WIN32
+    struct Registration {
+        uint32_t events ;
+        void* data ;
+        bool oneshot ;
+        bool armed ;
+    } ;
+
+    std::mutex mutex_ ;
+    std::unordered_map<native_handle_t, Registration> registry_ ;
+    std::vector<WSAPOLLFD> poll_set_ ;
+    native_handle_t wakeup_socket_ = Socket::invalid_handle ;
+#else
+    int poll_fd_ = -1 ;
+    int wakeup_fd_ = -1 ;
+#endif
+#if defined(__linux__)
+    std::unique_ptr<UringPoller> uring_ ;  // Set: every call goes to it instead of epoll
+#endif
+} ;
+
+} // namespace frqs::net
@@ -12,30 +12,191 @@
  */
 
 #include "socket.hpp"
+#include "dns_cache.hpp"
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <string_view>
 #include <optional>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace frqs::net {
 
+/**
+ * @brief Upstream response as received
+ *
+ * `headers` keeps every field line in order, repeats included (several
+ * Set-Cookie lines stay apart). It used to be a map keyed by name: look
+ * headers up with header() / headerValues() instead of `headers[name]`.
+ */
 struct HttpResponse {
     int status_code;
     std::string status_message;
-    std::unordered_map<std::string, std::string> headers;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+
+    // First value of the header, name compared ignoring case
+    [[nodiscard]] std::optional<std::string_view> header(std::string_view name) const noexcept;
+
+    // Every value of the header, in the order received
+    [[nodiscard]] std::vector<std::string_view> headerValues(std::string_view name) const;
+};
+
+/**
+ * @brief Request for HttpClient::send() and the batch API
+ */
+struct ClientRequest {
+    std::string method = "GET";
+    std::string url;                    // http://host[:port]/path
     std::string body;
+    std::string content_type;           // Sent when the body is not empty
+    std::vector<std::pair<std::string, std::string>> headers;
 };
 
+class HttpClient;
+
+/**
+ * @brief One request on a pooled connection, with both bodies streamed
+ *
+ * Made by HttpClient::open(), which has already sent the request head.
+ * Write the request body (if the head announced one), then read the
+ * response head and its body piece by piece. Nothing is buffered beyond
+ * one receive. If the exchange ran to the end of the response and the
+ * connection is persistent, the destructor returns it to the pool;
+ * otherwise it is closed.
+ *
+ * Each call waits at most the client timeout for the socket.
+ */
+class HttpStream {
+public:
+    ~HttpStream();
+
+    HttpStream(const HttpStream&) = delete;
+    HttpStream& operator=(const HttpStream&) = delete;
+
+    // Next piece of the request body (framed as chunks if open() was told so)
+    [[nodiscard]] bool write(std::string_view data);
+
+    // End of the request body (the last chunk, when chunked)
+    [[nodiscard]] bool finish();
+
+    // Status and headers (body left empty), or nullptr on error
+    [[nodiscard]] const HttpResponse* response();
+
+    // Next piece of the response body, valid until the next call;
+    // empty at the end, nullopt on error
+    [[nodiscard]] std::optional<std::string_view> read();
+
+private:
+    friend class HttpClient;
+    using Clock = std::chrono::steady_clock;
+
+    enum class Body : uint8_t {
+        Unknown,        // Head not read yet
+        Length,         // Content-Length bytes
+        ChunkSize,      // Chunked: expecting a size line
+        ChunkData,
+        ChunkEnd,       // CRLF after chunk data
+        Trailers,
+        UntilClose,     // No framing: body ends at EOF
+        Done,
+        Failed
+    };
+
+    HttpStream(HttpClient& client, std::string key, Socket socket, bool reused,
+               bool chunked_body, Clock::time_point deadline);
+
+    HttpClient& client_;
+    std::string key_;
+    Socket socket_;
+    bool reused_;
+    bool head_request_ = false;
+    bool chunked_body_;
+    bool received_any_ = false;
+    bool persistent_ = false;
+    Clock::time_point deadline_;
+
+    std::string buffer_;
+    size_t begin_ = 0;          // Unconsumed bytes are [begin_, size_)
+    size_t size_ = 0;
+    Body body_ = Body::Unknown;
+    size_t remaining_ = 0;      // Of the Content-Length or the current chunk
+    HttpResponse response_{};
+
+    // Thrown by receiveMore() in async mode instead of waiting; the parse
+    // step that needed the bytes can simply be repeated once readable
+    struct WouldBlock {};
+    bool async_ = false;
+
+    void sendParts(std::span<const std::string_view> parts);
+    bool receiveMore();
+    std::optional<std::string_view> nextLine();
+    void readHead();
+    std::string_view readBody();
+    [[nodiscard]] int waitMs() const;
+};
+
+/**
+ * @brief HTTP/1.1 client with per-host keep-alive pools
+ * 
+ * Connections are kept open after a response whose end was known
+ * (Content-Length or chunked) and reused for the next request to the same
+ * host:port. An idle connection the server closed is detected before reuse;
+ * if a reused connection still fails before any response byte arrives, an
+ * idempotent request is retried once on a new connection. Host names go
+ * through a DnsCache.
+ * 
+ * A send() must finish within the timeout (connect, send and receive
+ * together); an open() stream waits at most the timeout per call. Tighter
+ * limits for the connect alone and for each wait on the server (a stalled
+ * peer) are optional and never extend the whole-request timeout. Receive
+ * buffers are recycled per thread, so steady-state reads do not allocate
+ * beyond the body.
+ * 
+ * Thread-safe: one client can serve many threads, and sendBatch() /
+ * sendAsync() use that to run requests in parallel over the pool.
+ * fetch() is the coroutine form of send(): it parks on an IoService while
+ * the connection is not ready instead of holding a thread.
+ * 
+ * @example
+ * ```cpp
+ * net::HttpClient client;
+ * auto health = client.get("http://backend:9000/health");
+ * 
+ * std::vector<net::ClientRequest> batch(64, {.url = "http://backend:9000/items"});
+ * auto results = client.sendBatch(batch, 16);  // 16 in flight at a time
+ * ```
+ */
 class HttpClient {
 public:
-    HttpClient() = default;
-    
+    struct Options {
+        int timeout_ms = 5000;                              // Whole request
+        int connect_timeout_ms = 0;                         // TCP connect; 0 = timeout_ms
+        int read_timeout_ms = 0;                            // Each wait for the server to send or accept bytes; 0 = timeout_ms
+        size_t max_idle_per_host = 8;
+        std::chrono::milliseconds idle_timeout{30'000};     // Idle connections older than this are closed
+        std::chrono::milliseconds dns_ttl = DnsCache::DEFAULT_TTL;
+        size_t max_response_bytes = 64 * 1024 * 1024;       // Headers + body
+    };
+
+    HttpClient();
+    explicit HttpClient(Options options);
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
     // Simple GET request
     [[nodiscard]] std::optional<HttpResponse> get(
         std::string_view url,
         std::string_view auth_token = ""
     );
-    
+
     // Simple POST request
     [[nodiscard]] std::optional<HttpResponse> post(
         std::string_view url,
@@ -43,28 +204,84 @@ public:
         std::string_view content_type = "application/json",
         std::string_view auth_token = ""
     );
-    
-    // Set timeout (milliseconds)
-    void setTimeout(int timeout_ms) { timeout_ms_ = timeout_ms; }
+
+    // Any method; nullopt on a bad URL, resolution failure, I/O error or timeout
+    [[nodiscard]] std::optional<HttpResponse> send(const ClientRequest& request);
+
+    /**
+     * @brief send() for coroutines: awaits connect, send and receive on `io`
+     *
+     * Same pooling, retry and timeout rules as send(). Host names still
+     * resolve synchronously (a DnsCache hit after the first request).
+     */
+    [[nodiscard]] coro::Task<std::optional<HttpResponse>> fetch(IoService& io, ClientRequest request);
+
+    // send() on another thread; the client must outlive the future
+    [[nodiscard]] std::future<std::optional<HttpResponse>> sendAsync(ClientRequest request);
+
+    // Run all requests, at most `parallelism` at a time; results in request order
+    [[nodiscard]] std::vector<std::optional<HttpResponse>> sendBatch(
+        std::span<const ClientRequest> requests, size_t parallelism = 8);
+
+    /**
+     * @brief Send a request head and stream the bodies (see HttpStream)
+     *
+     * @param origin "http://host[:port]"; any path is ignored
+     * @param head Request line, headers and the blank line, sent as is.
+     *             It must frame the body itself: Content-Length, or
+     *             Transfer-Encoding: chunked with chunked_body = true.
+     * @return nullptr if the origin does not resolve or the head cannot be sent
+     */
+    [[nodiscard]] std::unique_ptr<HttpStream> open(std::string_view origin, std::string_view head,
+                                                   bool chunked_body = false);
+
+    // Set timeout (milliseconds); configure before sharing the client
+    void setTimeout(int timeout_ms) { options_.timeout_ms = timeout_ms; }
+
+    // Pooled connections waiting for reuse (all hosts)
+    [[nodiscard]] size_t idleConnections() const;
+
+    // Close every pooled connection
+    void closeIdle();
 
 private:
-    int timeout_ms_ = 5000;
-    
+    friend class HttpStream;
+    using Clock = std::chrono::steady_clock;
+
     struct UrlParts {
         std::string host;
         uint16_t port;
         std::string path;
     };
-    
+
+    struct IdleConnection {
+        Socket socket;
+        Clock::time_point since;
+    };
+
+    Options options_;
+    DnsCache dns_;
+
+    mutable std::mutex pool_mutex_;
+    std::unordered_map<std::string, std::vector<IdleConnection>> idle_;  // By "host:port"
+
     [[nodiscard]] std::optional<UrlParts> parseUrl(std::string_view url);
-    [[nodiscard]] std::optional<HttpResponse> sendRequest(
-        std::string_view method,
-        const UrlParts& url_parts,
-        std::string_view body,
-        std::string_view content_type,
-        std::string_view auth_token
-    );
-    [[nodiscard]] std::optional<HttpResponse> parseResponse(std::string_view raw_response);
+
+    // Request line, headers and body of `request` appended to `out`
+    static void formatRequest(std::string& out, const ClientRequest& request, const UrlParts& url);
+    [[nodiscard]] std::optional<Socket> acquire(const std::string& key);
+    void release(const std::string& key, Socket socket);
+
+    // Connect (or reuse a pooled connection) and send `head`; throws on failure
+    [[nodiscard]] std::unique_ptr<HttpStream> start(const UrlParts& url, std::string_view head,
+                                                    bool chunked_body, Clock::time_point deadline);
+
+    // start() awaiting on `io`; the stream is left in async receive mode
+    [[nodiscard]] coro::Task<std::unique_ptr<HttpStream>> startAsync(IoService& io, const UrlParts& url,
+                                                                     std::string_view head, Clock::time_point deadline);
+
+    // Time a connect may take: the connect timeout, cut short by the request deadline
+    [[nodiscard]] int connectWaitMs(Clock::time_point deadline) const;
 };
 
-} // namespace frqs::net
\ No newline at end of file
+} // namespace frqs::net
@@ -0,0 +1,115 @@
+#pragma once
+
+/**
+ * @file net/io_service.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Awaitable readiness waits and timers for coroutines
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "event_loop.hpp"
+#include "utils/coro.hpp"
+#include "utils/timer_wheel.hpp"
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace frqs::net {
+
+/**
+ * @brief One I/O thread that resumes coroutines when a socket is ready
+ *
+ * `co_await io.readable(socket)` parks the coroutine until the socket can
+ * be read (or the timeout passes) without holding a thread: the wait is an
+ * entry in an EventLoop watched by the I/O thread, which hands the
+ * coroutine back to the executor that was current when it suspended (a
+ * worker pool, see coro::Executor), or resumes it itself when there was
+ * none. Thousands of parked requests cost a map entry and a coroutine
+ * frame each; their timeouts sit in a timer wheel, so arming and
+ * cancelling one is O(1) however many are pending.
+ *
+ * A socket can have one wait outstanding at a time. The thread starts with
+ * the first wait; stop() (or the destructor) ends every pending wait as a
+ * timeout.
+ *
+ * @example
+ * ```cpp
+ * coro::Task<size_t> readSome(net::IoService& io, net::Socket& socket, std::span<char> out) {
+ *     co_return co_await socket.asyncReceive(io, out.data(), out.size(), 5000) ;
+ * }
+ * ```
+ */
+class IoService {
+public:
+    using native_handle_t = Socket::native_handle_t ;
+    using clock = std::chrono::steady_clock ;
+
+    IoService() = default ;
+    ~IoService() ;
+
+    IoService(const IoService&) = delete ;
+    IoService& operator=(const IoService&) = delete ;
+
+    class WaitAwaiter ;
+
+    // Resumes with true once ready, false on timeout (-1 = no timeout)
+    [[nodiscard]] WaitAwaiter readable(const Socket& socket, int timeout_ms = -1) noexcept ;
+    [[nodiscard]] WaitAwaiter writable(const Socket& socket, int timeout_ms = -1) noexcept ;
+
+    // Resumes after `duration` (the result is always false)
+    [[nodiscard]] WaitAwaiter sleepFor(std::chrono::milliseconds duration) noexcept ;
+
+    void stop() ;
+
+    [[nodiscard]] size_t pendingWaits() const ;
+
+    /**
+     * @brief Awaiter returned by readable(), writable() and sleepFor()
+     *
+     * Lives in the awaiting coroutine's frame for the duration of the wait.
+     */
+    class WaitAwaiter {
+    public:
+        bool await_ready() const noexcept { return false ; }
+        bool await_suspend(std::coroutine_handle<> handle) ;
+        bool await_resume() const noexcept { return !timed_out_ ; }
+
+    private:
+        friend class IoService ;
+
+        WaitAwaiter(IoService& io, native_handle_t handle, uint32_t events, int timeout_ms) noexcept
+            : io_(io), handle_(handle), events_(events), timeout_ms_(timeout_ms) {}
+
+        IoService& io_ ;
+        native_handle_t handle_ ;       // invalid_handle: timer only
+        uint32_t events_ ;
+        int timeout_ms_ ;
+        coro::Executor* executor_ = nullptr ;
+        std::coroutine_handle<> coroutine_ ;
+        uint64_t id_ = 0 ;
+        utils::TimerWheel::Timer timer_ ;
+        bool timed_out_ = false ;
+    } ;
+
+private:
+    // false: the service is stopping and the wait ends at once
+    bool arm(WaitAwaiter& waiter) ;
+    void run() ;
+
+    mutable std::mutex mutex_ ;
+    EventLoop loop_ ;
+    std::thread thread_ ;
+    bool stopping_ = false ;
+    uint64_t next_id_ = 1 ;
+    std::unordered_map<uint64_t, WaitAwaiter*> pending_ ;
+    utils::TimerWheel timers_ ;     // Timeouts of the waits in pending_
+} ;
+
+} // namespace frqs::net
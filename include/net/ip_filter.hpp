@@ -0,0 +1,155 @@
+#pragma once
+
+/**
+ * @file net/ip_filter.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Allow/deny and rate-limit table of IPv4 CIDR blocks
+ * @version 1.0.0
+ * @date 2025-12-15
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "ipv4.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace frqs::net {
+
+/**
+ * @brief An IPv4 network in CIDR notation ("10.0.0.0/8", "192.0.2.7")
+ */
+struct CidrBlock {
+    IPv4 network ;          // Host bits cleared
+    uint8_t prefix = 32 ;
+    
+    // Strict parse: four decimal octets, optional "/0".."/32"
+    [[nodiscard]] static std::optional<CidrBlock> parse(std::string_view text) noexcept ;
+    
+    [[nodiscard]] uint32_t first() const noexcept { return network.toUint32() ; }
+    [[nodiscard]] uint32_t last() const noexcept { return network.toUint32() | ~IPv4::mask(prefix).toUint32() ; }
+    [[nodiscard]] bool contains(const IPv4& address) const noexcept {
+        return (address & IPv4::mask(prefix)) == network ;
+    }
+    
+    [[nodiscard]] std::string toString() const ;
+} ;
+
+enum class IpAction : uint8_t {
+    Allow,
+    Deny,
+    Limit       // Allow up to a rate of new connections for the whole block
+} ;
+
+struct IpRule {
+    CidrBlock block ;
+    IpAction action = IpAction::Allow ;
+    double rate = 0 ;       // Limit: connections per second
+    double burst = 0 ;      // Limit: bucket size (defaults to the rate)
+} ;
+
+/**
+ * @brief Compiled, immutable rule table
+ * 
+ * The most specific (longest prefix) block containing an address decides;
+ * between identical blocks the later rule wins. Blocks are flattened into
+ * sorted disjoint intervals when the set is built, so a lookup is one
+ * binary search over them however the rules nest. Each Limit rule owns a
+ * token bucket, shared by every address in its block.
+ * 
+ * Text form, one rule per line (`#` starts a comment):
+ * ```
+ * deny  203.0.113.0/24
+ * allow 10.0.0.0/8
+ * limit 0.0.0.0/0 50 100      # 50 new connections/s, bursts of 100
+ * default deny                # For addresses no block matches
+ * ```
+ */
+class IpRuleSet {
+public:
+    explicit IpRuleSet(std::vector<IpRule> rules, IpAction default_action = IpAction::Allow) ;
+    
+    IpRuleSet(const IpRuleSet&) = delete ;
+    IpRuleSet& operator=(const IpRuleSet&) = delete ;
+    
+    // nullptr on a syntax error; `error` (if given) names the line
+    [[nodiscard]] static std::shared_ptr<const IpRuleSet> parse(std::string_view text, std::string* error = nullptr) ;
+    [[nodiscard]] static std::shared_ptr<const IpRuleSet> load(const std::filesystem::path& path, std::string* error = nullptr) ;
+    
+    // Deciding rule for `address`, or nullptr (the default action applies)
+    [[nodiscard]] const IpRule* match(const IPv4& address) const noexcept ;
+    
+    // Whether a new connection from `address` may proceed (takes a token for Limit rules)
+    [[nodiscard]] bool admit(const IPv4& address) const noexcept ;
+    
+    [[nodiscard]] IpAction defaultAction() const noexcept { return default_action_ ; }
+    [[nodiscard]] const std::vector<IpRule>& rules() const noexcept { return rules_ ; }
+
+private:
+    struct Interval {
+        uint32_t first ;
+        uint32_t last ;
+        uint32_t rule ;
+    } ;
+    
+    // Lock-free; under contention a refill may be lost, never duplicated
+    struct TokenBucket {
+        std::atomic<int64_t> tokens{0} ;        // Millitokens
+        std::atomic<int64_t> refilled_at{0} ;   // Steady clock, nanoseconds
+        int64_t capacity = 0 ;
+        int64_t per_second = 0 ;
+        
+        bool take(int64_t now) noexcept ;
+    } ;
+    
+    std::vector<IpRule> rules_ ;
+    IpAction default_action_ ;
+    std::vector<Interval> intervals_ ;                  // Sorted by first, disjoint
+    std::unique_ptr<TokenBucket[]> buckets_ ;           // One per rule (only Limit rules use theirs)
+} ;
+
+/**
+ * @brief Connection admission check with lock-free reload
+ * 
+ * The accept loops call admit() before a connection is queued; reload()
+ * swaps in a new rule set atomically, so lookups never wait and a check in
+ * progress finishes on the set it started with. Each thread caches the
+ * snapshot it last used, so a check is a generation load plus the lookup;
+ * a replaced set is freed once every thread has moved past it.
+ */
+class IpFilter {
+public:
+    IpFilter() ;
+    explicit IpFilter(std::shared_ptr<const IpRuleSet> rules) ;
+    
+    IpFilter(const IpFilter&) = delete ;
+    IpFilter& operator=(const IpFilter&) = delete ;
+    
+    [[nodiscard]] bool admit(const IPv4& address) noexcept ;
+    
+    void reload(std::shared_ptr<const IpRuleSet> rules) noexcept ;
+    
+    // Parse `path` and swap it in; on error the current rules stay
+    bool reloadFile(const std::filesystem::path& path, std::string* error = nullptr) ;
+    
+    [[nodiscard]] std::shared_ptr<const IpRuleSet> rules() const noexcept { return rules_.load() ; }
+    
+    [[nodiscard]] uint64_t admitted() const noexcept { return admitted_.load(std::memory_order_relaxed) ; }
+    [[nodiscard]] uint64_t rejected() const noexcept { return rejected_.load(std::memory_order_relaxed) ; }
+
+private:
+    std::atomic<std::shared_ptr<const IpRuleSet>> rules_ ;  // Empty: admit everything
+    std::atomic<uint64_t> generation_ ;                     // Unique across filters, renewed by reload()
+    std::atomic<uint64_t> admitted_{0} ;
+    std::atomic<uint64_t> rejected_{0} ;
+} ;
+
+} // namespace frqs::net
@@ -12,10 +12,16 @@
  */
 
 #include "sockaddr.hpp"
+#include "tls.hpp"
+#include "utils/coro.hpp"
+#include <memory>
 #include <utility>
 #include <vector>
+#include <optional>
+#include <span>
 #include <string_view>
 #include <cstddef>
+#include <cstdint>
 
 #ifdef _WIN32
     #include <winsock2.h>
@@ -27,6 +33,45 @@
 
 namespace frqs::net {
 
+class IoService ;
+
+/**
+ * @brief TCP tuning for listening sockets and the connections they accept
+ *
+ * Zero (or false) leaves the kernel default. Options the platform lacks
+ * are skipped; Socket::configureListener() names them.
+ */
+struct SocketOptions {
+    /// listen() backlog: connections the kernel queues until accept()
+    int backlog = SOMAXCONN ;
+
+    /// TCP_NODELAY on accepted connections: small writes go out at once
+    /// instead of waiting for the previous segment's ACK (Nagle)
+    bool no_delay = false ;
+
+    /// Cork (TCP_CORK on Linux, TCP_NOPUSH on BSD/macOS) while a response's
+    /// headers and file body are written, so they leave in full segments
+    bool cork = false ;
+
+    /// TCP_FASTOPEN queue length on listeners: clients holding a cookie
+    /// send their request in the SYN, saving a round trip
+    int fast_open_queue = 0 ;
+
+    /// TCP_DEFER_ACCEPT (Linux): accept() only returns a connection once it
+    /// has sent data, or after this many seconds
+    int defer_accept_seconds = 0 ;
+
+    /// SO_RCVBUF / SO_SNDBUF in bytes. Set on listeners before listen(), so
+    /// accepted connections inherit them and window scaling accounts for them
+    int receive_buffer = 0 ;
+    int send_buffer = 0 ;
+
+    /// SO_BUSY_POLL (Linux) on accepted connections: blocking reads spin on
+    /// the device queue this many microseconds before sleeping. Raising it
+    /// above net.core.busy_read needs CAP_NET_ADMIN.
+    int busy_poll_us = 0 ;
+} ;
+
 class Socket {
 public:
 #ifdef _WIN32
@@ -39,17 +84,20 @@ public:
 
     Socket() ;
     ~Socket() ;
-
+    
     Socket(const Socket&) = delete ;
     Socket& operator=(const Socket&) = delete ;
-
+    
     Socket(Socket&& other) noexcept ;
     Socket& operator=(Socket&& other) noexcept ;
-
+    
     void bind(const SockAddr& addr) ;
     void listen(int backlog = SOMAXCONN) ;
     void connect(const SockAddr& addr) ;
     
+    // Connect, giving up after timeout_ms; leaves the socket non-blocking
+    void connect(const SockAddr& addr, int timeout_ms) ;
+    
     [[nodiscard]] Socket accept(SockAddr* out_client_addr = nullptr) ;
     
     size_t send(const void* data, size_t size) ;
@@ -58,6 +106,114 @@ public:
     size_t receive(void* buffer, size_t size) ;
     [[nodiscard]] std::vector<char> receive(size_t max_size = 4096) ;
     
+    // Send the whole buffer, retrying partial writes (waits for writability on
+    // non-blocking sockets)
+    void sendAll(std::string_view data) ;
+    
+    // Scatter-gather variant: sends the buffers in order without joining them
+    void sendAll(std::span<const std::string_view> buffers) ;
+    
+    // ========== NON-BLOCKING I/O ==========
+    // The try* variants return std::nullopt when the call would block.
+    
+    void setNonBlocking(bool enabled) ;
+    
+    // SO_REUSEPORT (SO_REUSEPORT_LB on FreeBSD): lets several listeners bind
+    // the same port, with the kernel spreading connections over them. Must be
+    // set before bind(); returns false where unsupported (e.g. Windows).
+    [[nodiscard]] bool setReusePort(bool enabled) ;
+    
+    // TCP_DEFER_ACCEPT (Linux): accept() only returns a connection once the
+    // client has sent data, or after `seconds`. Returns false where unsupported.
+    bool setDeferAccept(int seconds) ;
+    
+    // ========== TCP OPTIONS ==========
+    // Each returns false where the option is unsupported or refused
+    
+    bool setNoDelay(bool enabled) ;
+    
+    // TCP_CORK (Linux) / TCP_NOPUSH (BSD, macOS): hold partial segments
+    // while set; clearing it sends what is held
+    bool setCork(bool enabled) ;
+    
+    // TCP_FASTOPEN on a listener; macOS wants it before listen()
+    bool setFastOpen(int queue_length) ;
+    
+    bool setReceiveBuffer(int bytes) ;
+    bool setSendBuffer(int bytes) ;
+    
+    // SO_BUSY_POLL (Linux)
+    bool setBusyPoll(int microseconds) ;
+    
+    // Listener options (buffers, fast open, defer accept); call before
+    // listen(options.backlog). Returns the names of those not applied.
+    [[nodiscard]] std::vector<std::string_view> configureListener(const SocketOptions& options) ;
+    
+    // Connection options (no delay, busy poll) for an accepted socket;
+    // failures are ignored, the connection works without them
+    void configureAccepted(const SocketOptions& options) ;
+    
+    [[nodiscard]] std::optional<Socket> tryAccept(SockAddr* out_client_addr = nullptr) ;
+    [[nodiscard]] std::optional<size_t> tryReceive(void* buffer, size_t size) ;
+    
+    // Like tryReceive, but the bytes stay queued for the next receive (MSG_PEEK)
+    [[nodiscard]] std::optional<size_t> tryPeek(void* buffer, size_t size) ;
+    [[nodiscard]] std::optional<size_t> trySend(const void* data, size_t size) ;
+    
+    // writev/WSASend over up to MAX_IOV buffers; returns total bytes written
+    [[nodiscard]] std::optional<size_t> trySendv(std::span<const std::string_view> buffers) ;
+    
+    static constexpr size_t MAX_IOV = 16 ;
+    
+    // ========== ZERO-COPY FILE SEND ==========
+
+#ifdef _WIN32
+    using native_file_t = void* ;  // HANDLE
+#else
+    using native_file_t = int ;
+#endif
+
+    // sendfile()/TransmitFile() up to `count` bytes of `file` starting at
+    // `offset`; returns bytes sent, nullopt if the call would block
+    [[nodiscard]] std::optional<size_t> trySendFile(native_file_t file, uint64_t offset, size_t count) ;
+    
+    // Send `length` bytes of `file` from `offset`, waiting on partial writes
+    void sendFile(native_file_t file, uint64_t offset, uint64_t length) ;
+    
+    // Wait until the socket is readable/writable (-1 = no timeout)
+    // Returns false on timeout
+    bool waitReadable(int timeout_ms = -1) ;
+    bool waitWritable(int timeout_ms = -1) ;
+    
+    // ========== TLS ==========
+    // After startTls() (server side) every receive, send and sendfile goes
+    // through the TLS stream, or straight to the kernel once it encrypts
+    // the records itself (kTLS)
+    
+    void startTls(const TlsContext& context) ;
+    
+    // One non-blocking handshake step: None once it is done (or for plain TCP)
+    [[nodiscard]] TlsWant tryHandshake() ;
+    
+    // Non-blocking sockets: handshake, waiting up to timeout_ms in total
+    void handshake(int timeout_ms) ;
+    
+    [[nodiscard]] const TlsStream* tls() const noexcept { return tls_.get() ; }
+    
+    // ========== COROUTINE I/O ==========
+    // Non-blocking sockets only: each call retries the try* variant and
+    // parks the coroutine on `io` while it would block. timeout_ms bounds
+    // each wait (-1 = none); running out throws std::runtime_error.
+    
+    [[nodiscard]] coro::Task<size_t> asyncReceive(IoService& io, void* buffer, size_t size, int timeout_ms = -1) ;
+    
+    // Send the whole buffer
+    [[nodiscard]] coro::Task<void> asyncSend(IoService& io, std::string_view data, int timeout_ms = -1) ;
+    
+    // Switches the socket to non-blocking and connects (`addr` is copied
+    // into the coroutine, the buffers above are not)
+    [[nodiscard]] coro::Task<void> asyncConnect(IoService& io, SockAddr addr, int timeout_ms = -1) ;
+    
     void close() ;
     void shutdown(int how = 2) ;
     
@@ -66,7 +222,12 @@ public:
 
 private:
     explicit Socket(native_handle_t h) ;
+    
+    // TLS whose records OpenSSL still encrypts (no kTLS send side)
+    [[nodiscard]] bool userSpaceTls() const noexcept { return tls_ && !tls_->sendsInKernel() ; }
+    
     native_handle_t handle_ = invalid_handle ;
+    std::unique_ptr<TlsStream> tls_ ;
 } ;
 
 // Network initialization (Windows WSA)
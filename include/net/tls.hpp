@@ -0,0 +1,132 @@
+#pragma once
+
+/**
+ * @file net/tls.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief TLS termination (OpenSSL) with kernel TLS offload
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// OpenSSL handles, kept opaque so only tls.cpp needs its headers
+struct ssl_st ;
+struct ssl_ctx_st ;
+
+namespace frqs::net {
+
+struct TlsOptions {
+    std::string certificate_file ;      // PEM, leaf first, then the chain
+    std::string private_key_file ;      // PEM
+
+    // Hand record encryption to the kernel after the handshake (Linux
+    // kTLS), so responses can still go out with sendfile() and writev()
+    bool kernel_offload = true ;
+
+    // TLS 1.3 session tickets issued per full handshake (0 = none). The
+    // ticket keys live in the context, so every listener shares them.
+    uint32_t session_tickets = 2 ;
+
+    // Server-side cache of TLS 1.2 session ids (0 = off)
+    size_t session_cache_size = 20480 ;
+
+    // Protocols offered with ALPN, most preferred first; "h2" is HTTP/2.
+    // Clients that offer none of them (or no ALPN at all) get HTTP/1.1.
+    std::vector<std::string> alpn = {"h2", "http/1.1"} ;
+} ;
+
+// What the handshake (or a read/write) waits for before it can go on
+enum class TlsWant : uint8_t { None, Read, Write } ;
+
+/**
+ * @brief Server certificate, key and session state shared by connections
+ *
+ * Built once and handed to ServerOptions::tls. create() throws
+ * std::runtime_error when the certificate or key cannot be loaded, and
+ * when the build has no OpenSSL (FRQS_WITH_OPENSSL=OFF or not found).
+ */
+class TlsContext {
+public:
+    [[nodiscard]] static std::shared_ptr<TlsContext> create(const TlsOptions& options) ;
+
+    // Whether this build links OpenSSL at all
+    [[nodiscard]] static bool available() noexcept ;
+
+    ~TlsContext() ;
+
+    TlsContext(const TlsContext&) = delete ;
+    TlsContext& operator=(const TlsContext&) = delete ;
+
+    [[nodiscard]] ssl_ctx_st* native_handle() const noexcept { return ctx_ ; }
+
+private:
+    explicit TlsContext(ssl_ctx_st* ctx) noexcept : ctx_(ctx) {}
+
+    ssl_ctx_st* ctx_ ;
+    std::string alpn_ ;     // TlsOptions::alpn in wire format (length-prefixed)
+} ;
+
+/**
+ * @brief Server side of one TLS connection, owned by its Socket
+ *
+ * Non-blocking throughout: every call returns what it would have to wait
+ * for instead of waiting, so the reactor can re-arm the connection and a
+ * stalled handshake never holds a worker. A call that reported a wait
+ * must be retried with the same arguments.
+ *
+ * Once the kernel took over the send side (sendsInKernel()), the bytes
+ * written straight to the socket are encrypted by the kernel; Socket then
+ * bypasses this class for writes and sendfile().
+ */
+class TlsStream {
+public:
+    TlsStream(const TlsContext& context, int fd) ;
+    ~TlsStream() ;
+
+    TlsStream(const TlsStream&) = delete ;
+    TlsStream& operator=(const TlsStream&) = delete ;
+
+    // Throws std::runtime_error when the handshake fails
+    [[nodiscard]] TlsWant handshake() ;
+    [[nodiscard]] bool established() const noexcept { return established_ ; }
+
+    // nullopt while the call would block; 0 once the peer closed
+    [[nodiscard]] std::optional<size_t> read(void* buffer, size_t size) ;
+    [[nodiscard]] std::optional<size_t> peek(void* buffer, size_t size) ;
+    [[nodiscard]] std::optional<size_t> write(const void* data, size_t size) ;
+
+    // Small buffers join into one record instead of a record each
+    [[nodiscard]] std::optional<size_t> writev(std::span<const std::string_view> buffers) ;
+
+    // Decrypted bytes buffered in user space, which poll() cannot see
+    [[nodiscard]] bool pending() const noexcept ;
+
+    [[nodiscard]] bool sendsInKernel() const noexcept { return kernel_send_ ; }
+    [[nodiscard]] bool receivesInKernel() const noexcept { return kernel_receive_ ; }
+    [[nodiscard]] bool resumed() const noexcept ;
+
+    // Protocol chosen with ALPN ("h2", "http/1.1"), empty if none
+    [[nodiscard]] std::string_view alpn() const noexcept ;
+
+    // Best-effort close_notify
+    void shutdown() noexcept ;
+
+private:
+    ssl_st* ssl_ = nullptr ;
+    bool established_ = false ;
+    bool kernel_send_ = false ;
+    bool kernel_receive_ = false ;
+} ;
+
+} // namespace frqs::net
@@ -0,0 +1,136 @@
+#pragma once
+
+/**
+ * @file net/uring_poller.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief io_uring readiness engine behind EventLoop (Linux)
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#if defined(__linux__)
+
+#include "event_loop.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace frqs::net {
+
+/**
+ * @brief EventLoop backend on io_uring poll requests
+ *
+ * Every registration is an IORING_OP_POLL_ADD: one-shot for one-shot
+ * registrations, multishot (IORING_POLL_ADD_MULTI) for the rest, so a
+ * listener stays armed without being re-submitted. add/rearm/remove only
+ * record the change; the loop thread writes them all to the submission
+ * queue and submits them with the same io_uring_enter() that waits for
+ * completions. A loop that re-arms a batch of connections therefore
+ * makes one syscall per wakeup instead of one epoll_ctl() per connection
+ * plus the epoll_wait().
+ *
+ * Only the loop thread touches the rings (IORING_SETUP_SINGLE_ISSUER,
+ * with completion work deferred to its waits). Changes made from other
+ * threads wake it through an eventfd read kept in flight on the ring.
+ *
+ * Needs Linux 6.1 or later; create() returns null where the kernel (or
+ * seccomp, or kernel.io_uring_disabled) refuses.
+ */
+class UringPoller {
+public:
+    using native_handle_t = Socket::native_handle_t ;
+
+    [[nodiscard]] static std::unique_ptr<UringPoller> create() ;
+
+    ~UringPoller() ;
+
+    UringPoller(const UringPoller&) = delete ;
+    UringPoller& operator=(const UringPoller&) = delete ;
+
+    void add(native_handle_t handle, uint32_t events, void* data, bool oneshot) ;
+    void rearm(native_handle_t handle, uint32_t events, void* data) ;
+    void remove(native_handle_t handle) noexcept ;
+
+    size_t wait(std::span<ReadyEvent> out, int timeout_ms) ;
+    void wakeup() noexcept ;
+
+private:
+    struct Registration {
+        void* data ;
+        uint32_t events ;
+        uint32_t generation ;   // Tags its poll request; stale completions do not match
+        bool oneshot ;
+        bool armed ;
+    } ;
+
+    // A submission the loop thread has yet to write
+    struct Change {
+        bool add ;              // POLL_ADD, else POLL_REMOVE of `user_data`
+        native_handle_t handle ;
+        uint32_t events ;
+        bool multishot ;
+        uint64_t user_data ;
+    } ;
+
+    UringPoller() = default ;
+
+    bool setup(unsigned entries) ;
+
+    // mutex_ held
+    void queueAdd(native_handle_t handle, Registration& registration) ;
+    void queueRemove(native_handle_t handle, const Registration& registration) ;
+    void notifyLoop() noexcept ;
+
+    // Loop thread only. With the SQ ring full and the kernel not taking
+    // more (EBUSY/EAGAIN until completions are reaped), nextSqe() returns
+    // nullptr and the changes not written wait for the next wait().
+    // writeChanges() returns false when it left some.
+    bool writeChanges(std::vector<Change>& changes) ;
+    void queueWakeupRead() ;
+    void* nextSqe() ;
+    void submit(unsigned min_complete, int timeout_ms) ;
+    size_t reap(std::span<ReadyEvent> out) ;
+
+    int ring_fd_ = -1 ;
+    int wakeup_fd_ = -1 ;
+    bool enabled_ = false ;             // IORING_SETUP_R_DISABLED until the loop's first wait
+    bool wakeup_armed_ = false ;
+    uint64_t wakeup_value_ = 0 ;        // eventfd read target
+
+    // Ring mappings
+    void* sq_map_ = nullptr ;
+    size_t sq_map_size_ = 0 ;
+    void* cq_map_ = nullptr ;
+    size_t cq_map_size_ = 0 ;
+    void* sqes_ = nullptr ;
+    size_t sqes_size_ = 0 ;
+    unsigned* sq_head_ = nullptr ;
+    unsigned* sq_tail_ = nullptr ;
+    unsigned sq_mask_ = 0 ;
+    unsigned sq_entries_ = 0 ;
+    unsigned* cq_head_ = nullptr ;
+    unsigned* cq_tail_ = nullptr ;
+    unsigned cq_mask_ = 0 ;
+    void* cqes_ = nullptr ;
+    unsigned unsubmitted_ = 0 ;         // SQEs written since the last enter
+
+    std::mutex mutex_ ;
+    std::unordered_map<native_handle_t, Registration> registry_ ;
+    std::vector<Change> changes_ ;
+    std::vector<Change> writing_ ;      // Loop thread's swap buffer
+    uint32_t next_generation_ = 1 ;
+    bool waiting_ = false ;             // Loop thread blocked in io_uring_enter()
+    std::atomic<std::thread::id> loop_thread_{} ;
+} ;
+
+} // namespace frqs::net
+
+#endif // __linux__
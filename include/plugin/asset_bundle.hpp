@@ -0,0 +1,412 @@
+#pragma once
+
+/**
+ * @file plugins/asset_bundle.hpp
+ * @brief Packed, memory-mapped static asset bundle
+ * @version 1.0.0
+ *
+ * A document root packed into one file by `frqs_pack`: a path index
+ * sorted by path, then every file's bytes with precomputed ETag,
+ * Last-Modified, MIME type and optional gzip/brotli variants. The server
+ * maps it once at startup; a lookup is a binary search over the mapped
+ * index, and the response body is a slice of the mapped pages.
+ *
+ * Layout (host byte order; a bundle from a machine of the other
+ * endianness is rejected):
+ *
+ *     BundleHeader
+ *     BundleEntry[entry_count]      sorted by path bytes
+ *     string table                  paths, MIME types, validators
+ *     bodies                        8-byte aligned
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include "http/compression.hpp"
+#include "utils/filesystem_utils.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace frqs::plugins {
+
+// ========== FORMAT ==========
+
+inline constexpr std::array<char, 8> BUNDLE_MAGIC = {'F', 'R', 'Q', 'S', 'P', 'A', 'K', '1'};
+inline constexpr uint32_t BUNDLE_BYTE_ORDER = 0x01020304;
+
+// Identity, gzip, brotli: indexed by http::ContentEncoding
+inline constexpr size_t BUNDLE_ENCODINGS = 3;
+
+/// Slice of the string table
+struct BundleString {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+};
+
+/// Slice of the file; offset 0 means absent (the header lives there)
+struct BundleBlob {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+struct BundleHeader {
+    std::array<char, 8> magic = BUNDLE_MAGIC;
+    uint32_t byte_order = BUNDLE_BYTE_ORDER;
+    uint32_t entry_count = 0;
+    uint64_t index_offset = 0;
+    uint64_t strings_offset = 0;
+    uint64_t strings_size = 0;
+    uint64_t file_size = 0;
+};
+
+struct BundleEntry {
+    BundleString path;              // Relative, '/'-separated, no leading '/'
+    BundleString mime_type;
+    BundleString last_modified;     // IMF-fixdate
+    int64_t modified_at = 0;        // Unix seconds
+    std::array<BundleString, BUNDLE_ENCODINGS> etag;
+    std::array<BundleBlob, BUNDLE_ENCODINGS> body;
+};
+
+static_assert(std::is_trivially_copyable_v<BundleHeader> && sizeof(BundleHeader) == 48);
+static_assert(std::is_trivially_copyable_v<BundleEntry> && sizeof(BundleEntry) == 104);
+
+// ========== READER ==========
+
+/**
+ * @brief A mapped bundle; lookups make no syscalls
+ *
+ * Hold it in a shared_ptr: responses keep it mapped (as their body's
+ * owner) until they are sent, even after the plugin switched bundles.
+ */
+class AssetBundle {
+public:
+    /// One representation of a packed file, pointing into the mapping
+    struct Representation {
+        std::string_view body;
+        std::string_view etag;
+        std::string_view content_encoding;  // "" for identity
+    };
+
+    /// A packed file
+    class Asset {
+    public:
+        Asset(const AssetBundle& bundle, const BundleEntry& entry) : bundle_(bundle), entry_(entry) {}
+
+        [[nodiscard]] std::string_view mimeType() const { return bundle_.string(entry_.mime_type); }
+        [[nodiscard]] std::string_view lastModified() const { return bundle_.string(entry_.last_modified); }
+        [[nodiscard]] std::chrono::system_clock::time_point modifiedAt() const {
+            return std::chrono::system_clock::time_point(std::chrono::seconds(entry_.modified_at));
+        }
+
+        [[nodiscard]] bool has(http::ContentEncoding encoding) const {
+            return entry_.body[static_cast<size_t>(encoding)].offset != 0;
+        }
+
+        /// The `encoding` variant; identity if there is none
+        [[nodiscard]] Representation get(http::ContentEncoding encoding) const {
+            auto index = static_cast<size_t>(has(encoding) ? encoding : http::ContentEncoding::Identity);
+            const auto& blob = entry_.body[index];
+            return {bundle_.bytes_.substr(static_cast<size_t>(blob.offset), static_cast<size_t>(blob.size)),
+                    bundle_.string(entry_.etag[index]),
+                    http::encodingToken(static_cast<http::ContentEncoding>(index))};
+        }
+
+    private:
+        const AssetBundle& bundle_;
+        const BundleEntry& entry_;
+    };
+
+    /**
+     * @brief Map and check a bundle
+     *
+     * Every offset in the index is checked against the file size here, so
+     * lookups can trust them.
+     *
+     * @throws std::runtime_error if the file cannot be mapped or is not a valid bundle
+     */
+    [[nodiscard]] static std::shared_ptr<const AssetBundle> open(const std::filesystem::path& path) {
+        std::error_code ec;
+        auto mtime = std::filesystem::last_write_time(path, ec);
+        auto mapped = utils::MappedFile::open(path);
+        if (!mapped || ec) {
+            throw std::runtime_error("cannot map asset bundle " + path.string());
+        }
+
+        auto bundle = std::shared_ptr<AssetBundle>(new AssetBundle(std::move(*mapped)));
+        bundle->path_ = path;
+        bundle->mtime_ = mtime;
+        if (auto problem = bundle->check()) {
+            throw std::runtime_error("invalid asset bundle " + path.string() + ": " + *problem);
+        }
+        return bundle;
+    }
+
+    /**
+     * @brief The file packed as `path` ("css/site.css"; a leading '/' is ignored)
+     */
+    [[nodiscard]] std::optional<Asset> find(std::string_view path) const {
+        if (path.starts_with('/')) {
+            path.remove_prefix(1);
+        }
+
+        auto it = std::lower_bound(entries_, entries_ + count_, path,
+                                   [this](const BundleEntry& entry, std::string_view key) {
+                                       return string(entry.path) < key;
+                                   });
+        if (it == entries_ + count_ || string(it->path) != path) {
+            return std::nullopt;
+        }
+        return Asset(*this, *it);
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return count_; }
+    [[nodiscard]] uint64_t bytes() const noexcept { return bytes_.size(); }
+    [[nodiscard]] const std::filesystem::path& path() const noexcept { return path_; }
+
+    /**
+     * @brief True if the file at path() is still the one that was mapped
+     *
+     * `frqs_pack` replaces a bundle with a rename, so a new bundle shows
+     * up as a new mtime or size.
+     */
+    [[nodiscard]] bool stillCurrent() const {
+        std::error_code ec;
+        auto mtime = std::filesystem::last_write_time(path_, ec);
+        if (ec || mtime != mtime_) return false;
+        auto size = std::filesystem::file_size(path_, ec);
+        return !ec && size == bytes_.size();
+    }
+
+private:
+    utils::MappedFile mapping_;
+    std::string_view bytes_;
+    std::filesystem::path path_;
+    std::filesystem::file_time_type mtime_;
+
+    const BundleEntry* entries_ = nullptr;
+    size_t count_ = 0;
+    std::string_view strings_;
+
+    explicit AssetBundle(utils::MappedFile mapping)
+        : mapping_(std::move(mapping)), bytes_(mapping_.bytes()) {}
+
+    [[nodiscard]] std::string_view string(BundleString slice) const {
+        return strings_.substr(slice.offset, slice.length);
+    }
+
+    // A description of what is wrong, or nullopt if the bundle is usable
+    [[nodiscard]] std::optional<std::string> check() {
+        BundleHeader header;
+        if (bytes_.size() < sizeof(header)) {
+            return "truncated header";
+        }
+        std::memcpy(&header, bytes_.data(), sizeof(header));
+
+        if (header.magic != BUNDLE_MAGIC) {
+            return "not a bundle";
+        }
+        if (header.byte_order != BUNDLE_BYTE_ORDER) {
+            return "packed on a machine of the other byte order";
+        }
+        if (header.file_size != bytes_.size()) {
+            return "truncated";
+        }
+
+        auto fits = [&](uint64_t offset, uint64_t size) {
+            return offset <= bytes_.size() && size <= bytes_.size() - offset;
+        };
+        uint64_t index_size = uint64_t{header.entry_count} * sizeof(BundleEntry);
+        if (header.index_offset % alignof(BundleEntry) != 0 || !fits(header.index_offset, index_size) ||
+            !fits(header.strings_offset, header.strings_size)) {
+            return "index out of bounds";
+        }
+
+        // The mapping is page aligned, so an aligned offset is an aligned address
+        entries_ = reinterpret_cast<const BundleEntry*>(bytes_.data() + header.index_offset);
+        count_ = header.entry_count;
+        strings_ = bytes_.substr(static_cast<size_t>(header.strings_offset),
+                                 static_cast<size_t>(header.strings_size));
+
+        auto valid = [&](BundleString slice) {
+            return uint64_t{slice.offset} + slice.length <= strings_.size();
+        };
+        for (size_t i = 0; i < count_; ++i) {
+            const auto& entry = entries_[i];
+            if (!valid(entry.path) || !valid(entry.mime_type) || !valid(entry.last_modified)) {
+                return "string out of bounds";
+            }
+            if (i > 0 && !(string(entries_[i - 1].path) < string(entry.path))) {
+                return "index not sorted";
+            }
+            if (entry.body[0].offset == 0) {
+                return "entry without an identity body";
+            }
+            for (size_t e = 0; e < BUNDLE_ENCODINGS; ++e) {
+                if (!valid(entry.etag[e]) || (entry.body[e].offset != 0 && !fits(entry.body[e].offset, entry.body[e].size))) {
+                    return "body out of bounds";
+                }
+            }
+        }
+        return std::nullopt;
+    }
+};
+
+// ========== WRITER ==========
+
+/**
+ * @brief Collects files in memory and writes them out as a bundle
+ *
+ * Used by `frqs_pack`. write() goes to a temporary file renamed over the
+ * target, so a server that has the old bundle mapped keeps valid pages.
+ */
+class AssetBundleWriter {
+public:
+    struct File {
+        std::string path;           // Relative, '/'-separated
+        std::string mime_type;
+        std::string last_modified;
+        int64_t modified_at = 0;
+        std::array<std::string, BUNDLE_ENCODINGS> etag;
+        std::array<std::optional<std::string>, BUNDLE_ENCODINGS> body;  // [0] is required
+    };
+
+    void add(File file) {
+        total_bytes_ += file.body[0] ? file.body[0]->size() : 0;
+        files_.push_back(std::move(file));
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return files_.size(); }
+
+    /**
+     * @throws std::runtime_error on I/O errors, duplicate paths or a file without an identity body
+     */
+    void write(const std::filesystem::path& target) {
+        std::sort(files_.begin(), files_.end(), [](const File& a, const File& b) { return a.path < b.path; });
+        for (size_t i = 0; i < files_.size(); ++i) {
+            if (!files_[i].body[0]) {
+                throw std::runtime_error("no body for " + files_[i].path);
+            }
+            if (i > 0 && files_[i - 1].path == files_[i].path) {
+                throw std::runtime_error("packed twice: " + files_[i].path);
+            }
+        }
+
+        // Strings first; MIME types and dates repeat, so those are shared
+        std::string strings;
+        auto append = [&](std::string_view text) {
+            if (strings.size() + text.size() > UINT32_MAX) {
+                throw std::runtime_error("string table too large");
+            }
+            BundleString slice{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(text.size())};
+            strings.append(text);
+            return slice;
+        };
+        std::unordered_map<std::string, BundleString> interned;
+        auto intern = [&](const std::string& text) {
+            auto [it, inserted] = interned.try_emplace(text);
+            if (inserted) {
+                it->second = append(text);
+            }
+            return it->second;
+        };
+
+        BundleHeader header;
+        header.entry_count = static_cast<uint32_t>(files_.size());
+        header.index_offset = sizeof(BundleHeader);
+
+        std::vector<BundleEntry> entries(files_.size());
+        for (size_t i = 0; i < files_.size(); ++i) {
+            const auto& file = files_[i];
+            auto& entry = entries[i];
+            entry.path = append(file.path);
+            entry.mime_type = intern(file.mime_type);
+            entry.last_modified = intern(file.last_modified);
+            entry.modified_at = file.modified_at;
+            for (size_t e = 0; e < BUNDLE_ENCODINGS; ++e) {
+                if (file.body[e]) {
+                    entry.etag[e] = append(file.etag[e]);
+                }
+            }
+        }
+
+        header.strings_offset = header.index_offset + entries.size() * sizeof(BundleEntry);
+        header.strings_size = strings.size();
+
+        // Then lay out the bodies after the strings
+        uint64_t at = align(header.strings_offset + header.strings_size);
+        for (size_t i = 0; i < files_.size(); ++i) {
+            for (size_t e = 0; e < BUNDLE_ENCODINGS; ++e) {
+                if (const auto& body = files_[i].body[e]) {
+                    entries[i].body[e] = {at, body->size()};
+                    at = align(at + body->size());
+                }
+            }
+        }
+        header.file_size = at;
+
+        auto temporary = target;
+        temporary += ".tmp";
+        auto out = utils::FileHandle::create(temporary);
+        if (!out) {
+            throw std::runtime_error("cannot create " + temporary.string());
+        }
+
+        uint64_t written = 0;
+        auto put = [&](const void* data, size_t size) {
+            if (!out->writeAll(data, size)) {
+                throw std::runtime_error("write failed: " + temporary.string());
+            }
+            written += size;
+        };
+        auto pad = [&]() {
+            static constexpr char zeros[8] = {};
+            put(zeros, static_cast<size_t>(align(written) - written));
+        };
+
+        put(&header, sizeof(header));
+        put(entries.data(), entries.size() * sizeof(BundleEntry));
+        put(strings.data(), strings.size());
+        for (const auto& file : files_) {
+            for (const auto& body : file.body) {
+                if (body) {
+                    pad();
+                    put(body->data(), body->size());
+                }
+            }
+        }
+        pad();
+        out->close();
+
+        std::error_code ec;
+        std::filesystem::rename(temporary, target, ec);
+        if (ec) {
+            std::filesystem::remove(temporary, ec);
+            throw std::runtime_error("cannot replace " + target.string());
+        }
+    }
+
+    [[nodiscard]] uint64_t totalBytes() const noexcept { return total_bytes_; }
+
+private:
+    std::vector<File> files_;
+    uint64_t total_bytes_ = 0;
+
+    static constexpr uint64_t align(uint64_t offset) noexcept {
+        return (offset + 7) & ~uint64_t{7};
+    }
+};
+
+} // namespace frqs::plugins
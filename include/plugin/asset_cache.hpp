@@ -0,0 +1,174 @@
+#pragma once
+
+/**
+ * @file plugins/asset_cache.hpp
+ * @brief Byte-bounded LRU cache of static assets
+ * @version 1.0.0
+ *
+ * Holds the body, MIME type and precomputed validator headers of hot
+ * static files so a hit costs one hash lookup instead of several
+ * filesystem syscalls and a read.
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include "http/date.hpp"
+#include "utils/filesystem_utils.hpp"
+#include "utils/lru_cache.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace frqs::plugins {
+
+/**
+ * @brief A static file ready to be served
+ *
+ * Exactly one of `body` (cached in memory) or `file` (streamed with
+ * sendfile) is set. Precompressed `.gz` / `.br` siblings found next to the
+ * file are attached as variants with their own body and validators.
+ */
+struct StaticAsset {
+    std::filesystem::path path;
+    std::shared_ptr<const std::string> body;
+    std::shared_ptr<const utils::FileHandle> file;
+    uint64_t size = 0;
+    
+    std::string mime_type;
+    std::string etag;               // Quoted strong validator
+    std::string last_modified;      // IMF-fixdate
+    std::filesystem::file_time_type mtime;
+    std::chrono::system_clock::time_point modified_at;  // Second precision
+    
+    /// Content-Encoding of this representation ("" for identity)
+    std::string_view content_encoding;
+    
+    /// Precompressed siblings of the identity representation
+    std::shared_ptr<const StaticAsset> gzip;
+    std::shared_ptr<const StaticAsset> brotli;
+    
+    /// Last time mtime/size were confirmed against the filesystem
+    mutable std::atomic<std::chrono::steady_clock::rep> validated_at{0};
+    
+    /**
+     * @brief Fill in the validators from the file's size and mtime
+     *
+     * In-memory bodies get a content hash as ETag; streamed files use
+     * size + mtime, which changes whenever the file is rewritten.
+     */
+    void computeValidators() {
+        modified_at = std::chrono::floor<std::chrono::seconds>(
+            std::chrono::file_clock::to_sys(mtime));
+        last_modified = http::formatHttpDate(modified_at);
+        
+        if (body) {
+            // FNV-1a 64
+            uint64_t hash = 14695981039346656037ull;
+            for (unsigned char c : *body) {
+                hash = (hash ^ c) * 1099511628211ull;
+            }
+            etag = std::format("\"{:016x}\"", hash);
+        } else {
+            etag = std::format("\"{:x}-{:x}\"", size,
+                               static_cast<uint64_t>(mtime.time_since_epoch().count()));
+        }
+    }
+    
+    /**
+     * @brief True if the file on disk still matches this asset
+     */
+    [[nodiscard]] bool stillCurrent() const {
+        std::error_code ec;
+        auto current_mtime = std::filesystem::last_write_time(path, ec);
+        if (ec || current_mtime != mtime) return false;
+        auto current_size = std::filesystem::file_size(path, ec);
+        if (ec || current_size != size) return false;
+        return (!gzip || gzip->stillCurrent()) && (!brotli || brotli->stillCurrent());
+    }
+    
+    /**
+     * @brief Bytes held in memory by this asset and its variants
+     */
+    [[nodiscard]] size_t memoryCost() const {
+        size_t cost = (body ? body->size() : 0) + path.native().size() + 
+                      mime_type.size() + etag.size() + last_modified.size();
+        if (gzip) cost += gzip->memoryCost();
+        if (brotli) cost += brotli->memoryCost();
+        return cost;
+    }
+};
+
+/**
+ * @brief LRU of StaticAsset keyed by request path, with TTL re-validation
+ * 
+ * Bounded by the total bytes of cached bodies (precompressed variants
+ * included). Entries older than the TTL are re-validated with a stat() on
+ * lookup and dropped if the file changed.
+ */
+class AssetCache {
+public:
+    AssetCache(size_t max_bytes, std::chrono::milliseconds ttl)
+        : entries_(max_bytes), ttl_(toTicks(ttl)) {}
+    
+    [[nodiscard]] bool enabled() const noexcept { return entries_.enabled(); }
+    
+    /// Applies to the next lookup of every entry
+    void setTtl(std::chrono::milliseconds ttl) noexcept {
+        ttl_.store(toTicks(ttl), std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Cached, still-valid asset for `key`, or nullptr
+     */
+    [[nodiscard]] std::shared_ptr<const StaticAsset> lookup(std::string_view key) {
+        auto asset = entries_.find(key);
+        if (!asset) {
+            return nullptr;
+        }
+        
+        // Re-validate outside the cache lock; concurrent checks are harmless
+        auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        if (now - asset->validated_at.load(std::memory_order_relaxed) > ttl_.load(std::memory_order_relaxed)) {
+            if (!asset->stillCurrent()) {
+                entries_.erase(key, asset.get());
+                return nullptr;
+            }
+            asset->validated_at.store(now, std::memory_order_relaxed);
+        }
+        
+        return asset;
+    }
+    
+    /**
+     * @brief Insert or replace an asset that holds an in-memory body
+     */
+    void insert(std::string key, std::shared_ptr<const StaticAsset> asset) {
+        asset->validated_at.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                                  std::memory_order_relaxed);
+        size_t cost = asset->memoryCost();
+        entries_.insert(std::move(key), std::move(asset), cost);
+    }
+    
+    void clear() {
+        entries_.clear();
+    }
+    
+    [[nodiscard]] size_t usedBytes() const {
+        return entries_.usedBytes();
+    }
+
+private:
+    utils::LruCache<StaticAsset> entries_;
+    std::atomic<std::chrono::steady_clock::rep> ttl_;
+    
+    static std::chrono::steady_clock::rep toTicks(std::chrono::milliseconds ttl) noexcept {
+        return std::chrono::duration_cast<std::chrono::steady_clock::duration>(ttl).count();
+    }
+};
+
+} // namespace frqs::plugins
@@ -0,0 +1,242 @@
+#pragma once
+
+/**
+ * @file plugins/compression.hpp
+ * @brief On-the-fly gzip / brotli response compression
+ * @version 1.0.0
+ *
+ * Compresses text-like responses according to the client's
+ * Accept-Encoding. Responses carrying an ETag are compressed once per
+ * encoding; the encoded bytes are kept in an LRU keyed by that ETag so
+ * repeated requests only pay for a lookup.
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include "plugin.hpp"
+#include "core/server.hpp"
+#include "http/compression.hpp"
+#include "http/mime_types.hpp"
+#include "utils/logger.hpp"
+#include "utils/lru_cache.hpp"
+#include <memory>
+#include <string>
+
+namespace frqs::plugins {
+
+/**
+ * @brief Configuration for compression plugin
+ */
+struct CompressionConfig : PluginConfig {
+    /// Bodies smaller than this are sent as-is
+    size_t min_size = 1024;
+    
+    /// gzip level (1-9)
+    int gzip_level = 6;
+    
+    /// brotli quality (0-11); 5 is a good speed/ratio trade-off for dynamic content
+    int brotli_quality = 5;
+    
+    bool enable_gzip = true;
+    bool enable_brotli = true;
+    
+    /// Total bytes of encoded bodies kept for ETag-tagged responses (0 disables)
+    size_t cache_max_bytes = 16 * 1024 * 1024;  // 16MB
+    
+    void validate() const override {
+        if (gzip_level < 1 || gzip_level > 9) {
+            throw std::invalid_argument("gzip_level must be between 1 and 9");
+        }
+        if (brotli_quality < 0 || brotli_quality > 11) {
+            throw std::invalid_argument("brotli_quality must be between 0 and 11");
+        }
+    }
+};
+
+/**
+ * @brief Response compression plugin
+ *
+ * Runs after the handler and leaves the response alone unless it is a
+ * 200 with a compressible Content-Type, no Content-Encoding, no
+ * `Cache-Control: no-transform` and an in-memory body of at least
+ * `min_size` bytes. File bodies streamed with sendfile are skipped; serve
+ * `.gz` / `.br` siblings through StaticFilesPlugin for those.
+ *
+ * Middleware runs in registration order, so add this plugin before any
+ * plugin whose middleware rewrites the body.
+ *
+ * @example
+ * ```cpp
+ * server.addPlugin(std::make_unique<CompressionPlugin>());
+ * ```
+ */
+class CompressionPlugin : public Plugin {
+public:
+    CompressionPlugin() = default;
+    
+    explicit CompressionPlugin(CompressionConfig config)
+        : config_(std::move(config)) {}
+    
+    // ========== PLUGIN INTERFACE ==========
+    
+    [[nodiscard]] std::string name() const override {
+        return "Compression";
+    }
+    
+    [[nodiscard]] std::string version() const override {
+        return "1.0.0";
+    }
+    
+    [[nodiscard]] std::string description() const override {
+        return "Compresses responses with gzip or brotli based on Accept-Encoding";
+    }
+    
+    [[nodiscard]] bool initialize(core::Server& server) override {
+        (void)server;
+        try {
+            config_.validate();
+        } catch (const std::exception& e) {
+            utils::logError(std::format("Failed to initialize compression plugin: {}", e.what()));
+            return false;
+        }
+        
+        gzip_ = config_.enable_gzip && http::encoderAvailable(http::ContentEncoding::Gzip);
+        brotli_ = config_.enable_brotli && http::encoderAvailable(http::ContentEncoding::Brotli);
+        
+        utils::logInfo(std::format("Compression plugin initialized: gzip={}, brotli={}",
+            gzip_, brotli_));
+        return true;
+    }
+    
+    void shutdown() override {
+        cache_.clear();
+    }
+    
+    void registerMiddleware(core::Server& server) override {
+        if (!gzip_ && !brotli_) {
+            return;
+        }
+        
+        server.use([this](core::Context& ctx, core::Next next) {
+            next();
+            compressResponse(ctx);
+        });
+    }
+    
+    [[nodiscard]] int priority() const noexcept override {
+        return 600;  // Optional feature
+    }
+
+private:
+    CompressionConfig config_;
+    bool gzip_ = false;
+    bool brotli_ = false;
+    utils::LruCache<std::string> cache_{config_.cache_max_bytes};
+    
+    void compressResponse(core::Context& ctx) {
+        auto& response = ctx.response();
+        auto status = response.getStatus();
+        if (status != 200 && status != 304) {
+            return;
+        }
+        
+        auto accept = ctx.request().getHeader("Accept-Encoding");
+        auto encoding = http::negotiateEncoding(accept.value_or(""), gzip_, brotli_);
+        
+        if (status == 304) {
+            revalidated(ctx, encoding);
+            return;
+        }
+        
+        if (!compressible(response)) {
+            return;
+        }
+        
+        // Whether or not this client gets a compressed body, caches must key on it
+        addVary(response);
+        if (encoding == http::ContentEncoding::Identity) {
+            return;
+        }
+        
+        auto etag = response.getHeader("ETag");
+        auto token = http::encodingToken(encoding);
+        
+        std::string key;
+        std::shared_ptr<const std::string> encoded;
+        if (etag && cache_.enabled()) {
+            key.reserve(etag->size() + 1 + token.size());
+            key.append(*etag).append(1, ' ').append(token);
+            encoded = cache_.find(key);
+        }
+        
+        if (!encoded) {
+            int level = encoding == http::ContentEncoding::Brotli ? config_.brotli_quality
+                                                                  : config_.gzip_level;
+            auto result = http::compress(response.getBody(), encoding, level);
+            
+            // Not worth it (already dense data): keep identity
+            if (!result || result->size() >= response.getBody().size()) {
+                return;
+            }
+            
+            encoded = std::make_shared<const std::string>(std::move(*result));
+            if (!key.empty()) {
+                cache_.insert(std::move(key), encoded, encoded->size());
+            }
+        }
+        
+        if (etag) {
+            response.setHeader("ETag", http::encodedEtag(*etag, encoding));
+        }
+        response.setHeader("Content-Encoding", token);
+        response.setSharedBody(std::move(encoded));
+    }
+    
+    [[nodiscard]] bool compressible(const http::HTTPResponse& response) const {
+        if (response.getFileBody() || response.isStreaming() || response.getBody().size() < config_.min_size) {
+            return false;
+        }
+        if (response.getHeader("Content-Encoding")) {
+            return false;
+        }
+        if (auto cache_control = response.getHeader("Cache-Control");
+            cache_control && cache_control->find("no-transform") != std::string_view::npos) {
+            return false;
+        }
+        
+        auto type = response.getHeader("Content-Type");
+        return type && http::MimeTypes::isCompressible(*type);
+    }
+    
+    /**
+     * @brief Keep the ETag of a 304 consistent with the representation the client holds
+     *
+     * The handler compares If-None-Match against the identity tag; if the
+     * client actually cached our encoded variant, answer with that tag.
+     */
+    static void revalidated(core::Context& ctx, http::ContentEncoding encoding) {
+        auto& response = ctx.response();
+        auto etag = response.getHeader("ETag");
+        auto if_none_match = ctx.request().getHeader("If-None-Match");
+        if (!etag || !if_none_match || encoding == http::ContentEncoding::Identity) {
+            return;
+        }
+        
+        auto encoded = http::encodedEtag(*etag, encoding);
+        if (if_none_match->find(encoded) != std::string_view::npos) {
+            response.setHeader("ETag", encoded);
+            addVary(response);
+        }
+    }
+    
+    static void addVary(http::HTTPResponse& response) {
+        auto vary = response.getHeader("Vary");
+        if (!vary) {
+            response.setHeader("Vary", "Accept-Encoding");
+        } else if (vary->find("Accept-Encoding") == std::string_view::npos && *vary != "*") {
+            response.setHeader("Vary", std::string(*vary) + ", Accept-Encoding");
+        }
+    }
+};
+
+} // namespace frqs::plugins
@@ -0,0 +1,120 @@
+#pragma once
+
+/**
+ * @file plugins/metrics.hpp
+ * @brief Prometheus scrape endpoint for server metrics
+ * @version 1.0.0
+ *
+ * Exposes the server's request/connection counters, status-class latency
+ * histograms and per-route latency histograms in the Prometheus text
+ * format. Recording happens in the server itself; this plugin only
+ * renders a snapshot when the endpoint is scraped. Sampled request phase
+ * traces (ServerOptions::trace_sample_every) are served as Chrome trace
+ * JSON next to it.
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include "plugin.hpp"
+#include "core/server.hpp"
+#include "utils/logger.hpp"
+#include <string>
+
+namespace frqs::plugins {
+
+/**
+ * @brief Configuration for metrics plugin
+ */
+struct MetricsConfig : PluginConfig {
+    /// Path the scrape endpoint is served on
+    std::string path = "/metrics";
+    
+    /// Path the request phase traces are served on (empty = not served)
+    std::string trace_path = "/debug/trace";
+    
+    void validate() const override {
+        if (path.empty() || path[0] != '/') {
+            throw std::invalid_argument("Metrics path must start with '/'");
+        }
+        if (!trace_path.empty() && trace_path[0] != '/') {
+            throw std::invalid_argument("Trace path must start with '/'");
+        }
+    }
+};
+
+/**
+ * @brief Metrics endpoint plugin
+ *
+ * @example
+ * ```cpp
+ * server.addPlugin(std::make_unique<MetricsPlugin>());
+ * // curl http://localhost:8080/metrics
+ * // curl http://localhost:8080/debug/trace > trace.json  (open in ui.perfetto.dev)
+ * ```
+ */
+class MetricsPlugin : public Plugin {
+public:
+    MetricsPlugin() = default;
+    
+    explicit MetricsPlugin(MetricsConfig config)
+        : config_(std::move(config)) {}
+    
+    // ========== PLUGIN INTERFACE ==========
+    
+    [[nodiscard]] std::string name() const override {
+        return "Metrics";
+    }
+    
+    [[nodiscard]] std::string version() const override {
+        return "1.0.0";
+    }
+    
+    [[nodiscard]] std::string description() const override {
+        return "Serves request counters and latency histograms in Prometheus format";
+    }
+    
+    [[nodiscard]] bool initialize(core::Server& server) override {
+        try {
+            config_.validate();
+        } catch (const std::exception& e) {
+            utils::logError(std::format("Failed to initialize metrics plugin: {}", e.what()));
+            return false;
+        }
+        
+        server_ = &server;
+        utils::logInfo(std::format("Metrics plugin initialized: {}", config_.path));
+        return true;
+    }
+    
+    void shutdown() override {
+        server_ = nullptr;
+    }
+    
+    void registerRoutes(core::Router& router) override {
+        router.get(config_.path, [this](core::Context& ctx) {
+            ctx.status(200)
+                .header("Content-Type", "text/plain; version=0.0.4; charset=utf-8")
+                .header("Cache-Control", "no-store")
+                .body(server_ ? server_->renderMetrics() : std::string());
+        });
+        
+        if (!config_.trace_path.empty()) {
+            router.get(config_.trace_path, [this](core::Context& ctx) {
+                ctx.status(200)
+                    .header("Content-Type", "application/json")
+                    .header("Cache-Control", "no-store")
+                    .body(server_ ? server_->renderTrace() : std::string());
+            });
+        }
+    }
+    
+    [[nodiscard]] int priority() const noexcept override {
+        return 50;  // Monitoring
+    }
+
+private:
+    MetricsConfig config_;
+    core::Server* server_ = nullptr;
+};
+
+} // namespace frqs::plugins
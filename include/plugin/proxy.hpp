@@ -0,0 +1,565 @@
+#pragma once
+
+/**
+ * @file plugins/proxy.hpp
+ * @brief Reverse proxy / load balancer plugin
+ * @version 1.0.0
+ * 
+ * Forwards every request under a mount path to a pool of HTTP upstreams:
+ * - Round-robin, least-connections or consistent-hash balancing
+ * - Active health checks, plus passive marking on connect failures
+ * - Request and response bodies streamed in both directions
+ * - Keep-alive connections to each upstream (pooled HttpClient)
+ * 
+ * @copyright Copyright (c) 2025
+ */
+
+#include "plugin.hpp"
+#include "core/router.hpp"
+#include "core/context.hpp"
+#include "net/http_client.hpp"
+#include "utils/logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace frqs::plugins {
+
+/**
+ * @brief Configuration for proxy plugin
+ */
+struct ProxyConfig : PluginConfig {
+    enum class Balance : uint8_t {
+        RoundRobin,
+        LeastConnections,   // Fewest requests in flight
+        ConsistentHash      // Same key, same upstream (while it is healthy)
+    };
+    
+    /// URL prefix forwarded to the upstreams
+    std::string mount_path = "/api";
+    
+    /// Remove mount_path from the forwarded path
+    bool strip_prefix = false;
+    
+    /// Upstream origins, "http://host[:port]"
+    std::vector<std::string> upstreams;
+    
+    Balance balance = Balance::RoundRobin;
+    
+    /// Consistent-hash key header (e.g. "X-User-Id"); empty hashes the path
+    std::string hash_header;
+    
+    /// Forward the client's Host header instead of the upstream's
+    bool preserve_host = false;
+    
+    /// Path probed on every upstream; a 2xx/3xx answer means healthy
+    std::string health_path = "/health";
+    
+    /// Time between health checks (0 disables them, and passive marking)
+    std::chrono::milliseconds health_interval{2000};
+    
+    /// Timeout of one health check
+    int health_timeout_ms = 1000;
+    
+    /// Per-read/write timeout on upstream connections
+    int timeout_ms = 30'000;
+    
+    /// Idle keep-alive connections kept per upstream
+    size_t max_idle_per_upstream = 32;
+    
+    void validate() const override {
+        if (mount_path.empty() || !mount_path.starts_with('/')) {
+            throw std::invalid_argument("Mount path must start with /");
+        }
+        if (upstreams.empty()) {
+            throw std::invalid_argument("Proxy needs at least one upstream");
+        }
+        for (const auto& upstream : upstreams) {
+            if (!upstream.starts_with("http://")) {
+                throw std::invalid_argument("Upstream must be an http:// origin: " + upstream);
+            }
+        }
+        if (!health_path.starts_with('/')) {
+            throw std::invalid_argument("Health path must start with /");
+        }
+        if (timeout_ms <= 0 || health_timeout_ms <= 0) {
+            throw std::invalid_argument("Proxy timeouts must be positive");
+        }
+    }
+};
+
+/**
+ * @brief Reverse proxy plugin
+ * 
+ * Request heads are rebuilt straight from the parsed request's views
+ * (minus hop-by-hop headers, plus Via / X-Forwarded-*), and bodies are
+ * relayed piece by piece, so a proxied upload or download costs a constant
+ * amount of memory. A request whose connect fails moves on to the next
+ * upstream before any body byte is sent; with no healthy upstream left the
+ * answer is 503, and an upstream that fails mid-exchange gives 502.
+ * 
+ * @example
+ * ```cpp
+ * ProxyConfig config;
+ * config.mount_path = "/api";
+ * config.upstreams = {"http://10.0.0.1:9000", "http://10.0.0.2:9000"};
+ * config.balance = ProxyConfig::Balance::LeastConnections;
+ * server.addPlugin(std::make_unique<ProxyPlugin>(config));
+ * ```
+ */
+class ProxyPlugin : public Plugin {
+public:
+    explicit ProxyPlugin(ProxyConfig config)
+        : config_(std::move(config))
+        , client_(clientOptions(config_.timeout_ms, config_.max_idle_per_upstream))
+        , health_client_(clientOptions(config_.health_timeout_ms, 1)) {}
+    
+    ~ProxyPlugin() override {
+        stopHealthChecks();
+    }
+    
+    // ========== PLUGIN INTERFACE ==========
+    
+    [[nodiscard]] std::string name() const override {
+        return "Proxy";
+    }
+    
+    [[nodiscard]] std::string version() const override {
+        return "1.0.0";
+    }
+    
+    [[nodiscard]] std::string description() const override {
+        return "Reverse proxy with load balancing and health checks";
+    }
+    
+    [[nodiscard]] std::string author() const override {
+        return "FRQS Network Team";
+    }
+    
+    [[nodiscard]] bool initialize(core::Server& server) override {
+        (void)server;
+        try {
+            config_.validate();
+            
+            upstreams_.clear();
+            for (const auto& origin : config_.upstreams) {
+                auto upstream = std::make_unique<Upstream>();
+                upstream->origin = origin;
+                upstream->host = origin.substr(std::string_view("http://").size());
+                upstream->host = upstream->host.substr(0, upstream->host.find('/'));
+                upstreams_.push_back(std::move(upstream));
+            }
+            buildRing();
+            
+            utils::logInfo(std::format("Proxy plugin initialized: mount={}, upstreams={}",
+                config_.mount_path, upstreams_.size()));
+            return true;
+        
+        } catch (const std::exception& e) {
+            utils::logError(std::format("Failed to initialize proxy plugin: {}", e.what()));
+            return false;
+        }
+    }
+    
+    void shutdown() override {
+        stopHealthChecks();
+        client_.closeIdle();
+        utils::logInfo("Proxy plugin shutdown");
+    }
+    
+    void registerRoutes(core::Router& router) override {
+        std::string route_pattern = config_.mount_path;
+        if (!route_pattern.ends_with('/')) {
+            route_pattern += '/';
+        }
+        route_pattern += "*";
+        
+        // Every method the parser knows
+        for (uint8_t value = 0; value < static_cast<uint8_t>(http::Method::UNKNOWN); ++value) {
+            auto method = static_cast<http::Method>(value);
+            auto handler = [this](core::Context& ctx) { return forward(ctx); };
+            router.stream(method, route_pattern, handler);
+            if (config_.mount_path != "/" && !config_.mount_path.ends_with('/')) {
+                router.stream(method, config_.mount_path, handler);
+            }
+        }
+    }
+    
+    [[nodiscard]] bool onServerStart() override {
+        if (config_.health_interval.count() > 0) {
+            health_thread_ = std::jthread([this](std::stop_token stop) { runHealthChecks(stop); });
+        }
+        return true;
+    }
+    
+    void onServerStop() override {
+        stopHealthChecks();
+    }
+    
+    // ========== STATUS ==========
+    
+    /// Upstreams currently considered healthy
+    [[nodiscard]] size_t healthyUpstreams() const noexcept {
+        return static_cast<size_t>(std::count_if(upstreams_.begin(), upstreams_.end(),
+            [](const auto& upstream) { return upstream->healthy.load(std::memory_order_relaxed); }));
+    }
+
+private:
+    struct Upstream {
+        std::string origin;                 // "http://host:port"
+        std::string host;                   // "host:port", the forwarded Host
+        std::atomic<bool> healthy{true};
+        std::atomic<size_t> active{0};      // Requests in flight
+    };
+    
+    // One proxied request; keeps the upstream counted as busy until the
+    // response body has been relayed (or abandoned)
+    struct Exchange {
+        Upstream& upstream;
+        std::unique_ptr<net::HttpStream> stream;
+        
+        Exchange(Upstream& target, std::unique_ptr<net::HttpStream> opened)
+            : upstream(target), stream(std::move(opened)) {
+            upstream.active.fetch_add(1, std::memory_order_relaxed);
+        }
+        
+        ~Exchange() {
+            upstream.active.fetch_sub(1, std::memory_order_relaxed);
+        }
+        
+        Exchange(const Exchange&) = delete;
+        Exchange& operator=(const Exchange&) = delete;
+    };
+    
+    // Relays the client's body upstream, then hands over the upstream response
+    class ProxyBody : public core::BodyStream {
+    public:
+        ProxyBody(ProxyPlugin& plugin, std::shared_ptr<Exchange> exchange)
+            : plugin_(plugin), exchange_(std::move(exchange)) {}
+        
+        bool onData(std::string_view data) override {
+            upstream_ok_ = exchange_->stream->write(data);
+            return upstream_ok_;
+        }
+        
+        void onEnd(core::Context& ctx, bool complete) override {
+            if (!complete) {
+                if (upstream_ok_) {
+                    ctx.text("Incomplete request body").status(400);
+                } else {
+                    plugin_.badGateway(ctx, exchange_->upstream);
+                }
+                return;
+            }
+            plugin_.relayResponse(ctx, std::move(exchange_));
+        }
+    
+    private:
+        ProxyPlugin& plugin_;
+        std::shared_ptr<Exchange> exchange_;
+        bool upstream_ok_ = true;
+    };
+    
+    static constexpr size_t RING_REPLICAS = 100;    // Virtual nodes per upstream
+    
+    ProxyConfig config_;
+    net::HttpClient client_;
+    net::HttpClient health_client_;
+    std::vector<std::unique_ptr<Upstream>> upstreams_;
+    std::vector<std::pair<uint32_t, size_t>> ring_;  // (hash, upstream index), sorted
+    std::atomic<size_t> next_{0};
+    
+    std::jthread health_thread_;
+    std::mutex health_mutex_;
+    std::condition_variable_any health_wake_;
+    
+    [[nodiscard]] static net::HttpClient::Options clientOptions(int timeout_ms, size_t max_idle) {
+        net::HttpClient::Options options;
+        options.timeout_ms = timeout_ms;
+        options.max_idle_per_host = max_idle;
+        return options;
+    }
+    
+    [[nodiscard]] static uint32_t fnv1a(std::string_view data, uint32_t hash = 2166136261u) noexcept {
+        for (char c : data) {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+        }
+        return hash;
+    }
+    
+    [[nodiscard]] static bool hopByHop(const http::HeaderField& field, std::string_view connection) noexcept {
+        switch (field.id) {
+            case http::KnownHeader::Host:               // Rewritten
+            case http::KnownHeader::Connection:
+            case http::KnownHeader::TransferEncoding:   // Reframed
+            case http::KnownHeader::ContentLength:
+            case http::KnownHeader::Expect:             // Answered by this server
+            case http::KnownHeader::Upgrade:
+                return true;
+            default:
+                break;
+        }
+        for (std::string_view name : {"Keep-Alive", "Proxy-Connection", "Proxy-Authorization",
+                                      "TE", "Trailer"}) {
+            if (http::equalsIgnoreCase(field.name, name)) {
+                return true;
+            }
+        }
+        
+        // Headers the sender listed in Connection are hop-by-hop too
+        while (!connection.empty()) {
+            size_t comma = std::min(connection.find(','), connection.size());
+            std::string_view token = connection.substr(0, comma);
+            connection.remove_prefix(std::min(comma + 1, connection.size()));
+            while (!token.empty() && token.front() == ' ') token.remove_prefix(1);
+            while (!token.empty() && token.back() == ' ') token.remove_suffix(1);
+            if (http::equalsIgnoreCase(field.name, token)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    [[nodiscard]] static bool hopByHopResponse(std::string_view name) noexcept {
+        for (std::string_view hop : {"Connection", "Keep-Alive", "Transfer-Encoding", "Proxy-Connection",
+                                     "TE", "Trailer", "Upgrade"}) {
+            if (http::equalsIgnoreCase(name, hop)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    void buildRing() {
+        ring_.clear();
+        if (config_.balance != ProxyConfig::Balance::ConsistentHash) {
+            return;
+        }
+        ring_.reserve(upstreams_.size() * RING_REPLICAS);
+        for (size_t i = 0; i < upstreams_.size(); ++i) {
+            for (size_t replica = 0; replica < RING_REPLICAS; ++replica) {
+                ring_.emplace_back(fnv1a(std::format("{}#{}", upstreams_[i]->origin, replica)), i);
+            }
+        }
+        std::sort(ring_.begin(), ring_.end());
+    }
+    
+    // ========== BALANCING ==========
+    
+    [[nodiscard]] Upstream* pick(const http::HTTPRequest& request, size_t attempt) {
+        size_t count = upstreams_.size();
+        auto healthy = [](const Upstream& upstream) {
+            return upstream.healthy.load(std::memory_order_relaxed);
+        };
+        
+        switch (config_.balance) {
+            case ProxyConfig::Balance::ConsistentHash: {
+                std::string_view key = request.getPath();
+                if (!config_.hash_header.empty()) {
+                    key = request.getHeader(config_.hash_header).value_or(key);
+                }
+                
+                // Walk clockwise from the key's point; retries skip distinct upstreams
+                auto it = std::lower_bound(ring_.begin(), ring_.end(),
+                                           std::pair<uint32_t, size_t>(fnv1a(key), 0));
+                size_t skipped = 0;
+                for (size_t step = 0; step < ring_.size(); ++step, ++it) {
+                    if (it == ring_.end()) {
+                        it = ring_.begin();
+                    }
+                    Upstream& upstream = *upstreams_[it->second];
+                    if (healthy(upstream) && skipped++ == attempt) {
+                        return &upstream;
+                    }
+                }
+                return nullptr;
+            }
+            
+            case ProxyConfig::Balance::LeastConnections: {
+                // Rotating start, so ties spread instead of piling on the first
+                size_t start = next_.fetch_add(1, std::memory_order_relaxed);
+                Upstream* best = nullptr;
+                for (size_t i = 0; i < count; ++i) {
+                    Upstream& upstream = *upstreams_[(start + i) % count];
+                    if (healthy(upstream) && (!best ||
+                        upstream.active.load(std::memory_order_relaxed) < best->active.load(std::memory_order_relaxed))) {
+                        best = &upstream;
+                    }
+                }
+                return best;
+            }
+            
+            case ProxyConfig::Balance::RoundRobin:
+            default: {
+                for (size_t i = 0; i < count; ++i) {
+                    Upstream& upstream = *upstreams_[next_.fetch_add(1, std::memory_order_relaxed) % count];
+                    if (healthy(upstream)) {
+                        return &upstream;
+                    }
+                }
+                return nullptr;
+            }
+        }
+    }
+    
+    void markDown(Upstream& upstream) {
+        // Without health checks nothing would bring it back
+        if (config_.health_interval.count() > 0 && upstream.healthy.exchange(false)) {
+            utils::logWarn(std::format("Upstream {} marked unhealthy", upstream.origin));
+        }
+    }
+    
+    // ========== FORWARDING ==========
+    
+    void buildHead(std::string& head, const http::HTTPRequest& request, const Upstream& upstream,
+                   bool chunked) const {
+        std::string_view path = request.getPath();
+        if (config_.strip_prefix && config_.mount_path != "/" && path.starts_with(config_.mount_path)) {
+            path.remove_prefix(config_.mount_path.size());
+        }
+        
+        head.clear();
+        head.append(http::methodToString(request.getMethod())).append(" ");
+        if (!path.starts_with('/')) {
+            head += '/';
+        }
+        head.append(path);
+        if (!request.getQueryString().empty()) {
+            head.append("?").append(request.getQueryString());
+        }
+        head.append(" HTTP/1.1\r\n");
+        
+        auto client_host = request.getHeader(http::KnownHeader::Host);
+        head.append("Host: ").append(config_.preserve_host && client_host ? *client_host : upstream.host).append("\r\n");
+        
+        auto connection = request.getHeader(http::KnownHeader::Connection).value_or("");
+        for (const auto& field : request.getHeaders()) {
+            if (!hopByHop(field, connection)) {
+                head.append(field.name).append(": ").append(field.value).append("\r\n");
+            }
+        }
+        
+        if (chunked) {
+            head.append("Transfer-Encoding: chunked\r\n");
+        } else if (auto length = request.getHeader(http::KnownHeader::ContentLength)) {
+            head.append("Content-Length: ").append(*length).append("\r\n");
+        }
+        if (client_host) {
+            head.append("X-Forwarded-Host: ").append(*client_host).append("\r\n");
+        }
+        head.append("X-Forwarded-Proto: http\r\n");
+        head.append("Via: ").append(request.getVersion().substr(std::min<size_t>(5, request.getVersion().size())))
+            .append(" frqs\r\n\r\n");
+    }
+    
+    std::unique_ptr<core::BodyStream> forward(core::Context& ctx) {
+        const auto& request = ctx.request();
+        bool chunked = request.getHeader(http::KnownHeader::TransferEncoding).has_value();
+        
+        // Per-worker head buffer, built from the request's views
+        static thread_local std::string head;
+        
+        // Nothing has been sent yet, so a failed connect moves on to the next upstream
+        for (size_t attempt = 0; attempt < upstreams_.size(); ++attempt) {
+            Upstream* upstream = pick(request, attempt);
+            if (!upstream) {
+                break;
+            }
+            
+            buildHead(head, request, *upstream, chunked);
+            if (auto stream = client_.open(upstream->origin, head, chunked)) {
+                return std::make_unique<ProxyBody>(*this,
+                    std::make_shared<Exchange>(*upstream, std::move(stream)));
+            }
+            markDown(*upstream);
+        }
+        
+        ctx.text("No upstream available").status(503);
+        return nullptr;
+    }
+    
+    void badGateway(core::Context& ctx, Upstream& upstream) {
+        markDown(upstream);
+        ctx.text("Bad gateway").status(502);
+    }
+    
+    void relayResponse(core::Context& ctx, std::shared_ptr<Exchange> exchange) {
+        auto& stream = *exchange->stream;
+        const net::HttpResponse* upstream_response = stream.finish() ? stream.response() : nullptr;
+        if (!upstream_response) {
+            badGateway(ctx, exchange->upstream);
+            return;
+        }
+        
+        auto& response = ctx.response();
+        response.setStatus(static_cast<uint16_t>(upstream_response->status_code),
+                           upstream_response->status_message);
+        for (const auto& [name, value] : upstream_response->headers) {
+            if (!hopByHopResponse(name)) {
+                response.addHeader(name, value);  // Repeats (Set-Cookie) stay separate
+            }
+        }
+        
+        if (!http::HTTPResponse::statusAllowsBody(response.getStatus()) ||
+            ctx.request().getMethod() == http::Method::HEAD) {
+            return;  // No body follows; the exchange ends here
+        }
+        
+        // Relayed as the client socket accepts it; an upstream that breaks
+        // off mid-body aborts the client connection too, so the truncation shows
+        response.setStreamBody([exchange = std::move(exchange)](http::BodyWriter& out) {
+            while (true) {
+                auto piece = exchange->stream->read();
+                if (!piece) {
+                    throw std::runtime_error("Upstream response ended early: " + exchange->upstream.origin);
+                }
+                if (piece->empty() || !out.write(*piece)) {
+                    return;
+                }
+            }
+        });
+    }
+    
+    // ========== HEALTH CHECKS ==========
+    
+    void runHealthChecks(std::stop_token stop) {
+        while (!stop.stop_requested()) {
+            for (auto& upstream : upstreams_) {
+                net::ClientRequest probe;
+                probe.url = upstream->origin + config_.health_path;
+                auto result = health_client_.send(probe);
+                bool healthy = result && result->status_code >= 200 && result->status_code < 400;
+                
+                if (upstream->healthy.exchange(healthy) != healthy) {
+                    if (healthy) {
+                        utils::logInfo(std::format("Upstream {} is healthy again", upstream->origin));
+                    } else {
+                        utils::logWarn(std::format("Upstream {} failed its health check", upstream->origin));
+                    }
+                }
+            }
+            
+            std::unique_lock lock(health_mutex_);
+            health_wake_.wait_for(lock, stop, config_.health_interval, [] { return false; });
+        }
+    }
+    
+    void stopHealthChecks() {
+        if (health_thread_.joinable()) {
+            health_thread_.request_stop();
+            health_thread_.join();
+        }
+    }
+};
+
+} // namespace frqs::plugins
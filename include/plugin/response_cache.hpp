@@ -0,0 +1,385 @@
+#pragma once
+
+/**
+ * @file plugins/response_cache.hpp
+ * @brief Micro-cache for idempotent dynamic routes
+ * @version 1.0.0
+ * 
+ * Keeps finished responses of selected routes for a short TTL so a burst
+ * of identical requests runs the handler once:
+ * - Per-route policy (TTL, stale window, varying headers), given when the
+ *   route is registered
+ * - Request coalescing: concurrent misses for one key wait for a single
+ *   handler run instead of all computing the same payload
+ * - Stale-while-revalidate: while one request refreshes an expired entry,
+ *   the others are answered from the old one
+ * 
+ * @copyright Copyright (c) 2025
+ */
+
+#include "plugin.hpp"
+#include "core/context.hpp"
+#include "core/router.hpp"
+#include "utils/lru_cache.hpp"
+#include "utils/logger.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace frqs::plugins {
+
+/**
+ * @brief Configuration for response cache plugin
+ */
+struct ResponseCacheConfig : PluginConfig {
+    /// Total bytes of cached responses (bodies, headers and keys)
+    size_t max_bytes = 16 * 1024 * 1024;  // 16MB
+    
+    /// Larger bodies are never cached
+    size_t max_entry_bytes = 1024 * 1024;  // 1MB
+    
+    void validate() const override {
+        if (max_entry_bytes > max_bytes) {
+            throw std::invalid_argument("Cache entry limit exceeds the cache size");
+        }
+    }
+};
+
+/**
+ * @brief How one route is cached
+ */
+struct CachePolicy {
+    /// How long a response is served as fresh
+    std::chrono::milliseconds ttl{1000};
+    
+    /// After the TTL, how long the old response may still be served while
+    /// one request recomputes it (0 = expired entries are simply misses)
+    std::chrono::milliseconds stale_while_revalidate{0};
+    
+    /// Request headers whose values are part of the key (e.g. "Accept-Language")
+    std::vector<std::string> vary;
+    
+    /// How long a coalesced miss waits for the request computing the entry
+    /// before running the handler itself
+    std::chrono::milliseconds max_wait{5000};
+};
+
+/**
+ * @brief Response cache plugin
+ * 
+ * Routes opt in by wrapping their handler with cached(). The key is the
+ * method, path, query string and the policy's vary headers. Only
+ * in-memory responses with a cacheable status (200, 203, 204, 300, 301,
+ * 404, 410) and no Set-Cookie or `Cache-Control: no-store / private` are
+ * stored. Headers that middleware set before the handler ran are not
+ * part of the entry, since they are set again on every request.
+ * 
+ * A hit copies the status and headers into the response and shares the
+ * body (no copy); the server then frames it per connection as usual.
+ * 
+ * @example
+ * ```cpp
+ * auto cache = std::make_unique<ResponseCachePlugin>();
+ * auto& responses = *cache;
+ * server.addPlugin(std::move(cache));
+ * 
+ * api.get("/info", responses.cached({.ttl = 1s, .stale_while_revalidate = 5s}, infoHandler));
+ * ```
+ */
+class ResponseCachePlugin : public Plugin {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t stale_hits = 0;
+        uint64_t misses = 0;        // Handler runs that tried to fill the cache
+        uint64_t coalesced = 0;     // Misses answered by another request's run
+    };
+    
+    ResponseCachePlugin() : ResponseCachePlugin(ResponseCacheConfig{}) {}
+    
+    explicit ResponseCachePlugin(ResponseCacheConfig config)
+        : config_(std::move(config)), entries_(config_.max_bytes) {}
+    
+    // ========== PLUGIN INTERFACE ==========
+    
+    [[nodiscard]] std::string name() const override {
+        return "ResponseCache";
+    }
+    
+    [[nodiscard]] std::string version() const override {
+        return "1.0.0";
+    }
+    
+    [[nodiscard]] std::string description() const override {
+        return "Micro-caches dynamic responses with request coalescing";
+    }
+    
+    [[nodiscard]] std::string author() const override {
+        return "FRQS Network Team";
+    }
+    
+    [[nodiscard]] bool initialize(core::Server& server) override {
+        (void)server;
+        try {
+            config_.validate();
+            utils::logInfo(std::format("Response cache plugin initialized: {} KB",
+                config_.max_bytes / 1024));
+            return true;
+        
+        } catch (const std::exception& e) {
+            utils::logError(std::format("Failed to initialize response cache plugin: {}", e.what()));
+            return false;
+        }
+    }
+    
+    void shutdown() override {
+        clear();
+        utils::logInfo("Response cache plugin shutdown");
+    }
+    
+    // ========== ROUTE WRAPPING ==========
+    
+    /**
+     * @brief Handler that serves `handler`'s responses from the cache
+     *
+     * The plugin must outlive the routes using it (true once it has been
+     * added to the server).
+     */
+    [[nodiscard]] core::RouteHandler cached(CachePolicy policy, core::RouteHandler handler) {
+        return [this, policy = std::move(policy), handler = std::move(handler)](core::Context& ctx) {
+            serve(ctx, policy, handler);
+        };
+    }
+    
+    [[nodiscard]] core::RouteHandler cached(std::chrono::milliseconds ttl, core::RouteHandler handler) {
+        CachePolicy policy;
+        policy.ttl = ttl;
+        return cached(std::move(policy), std::move(handler));
+    }
+    
+    // ========== MANAGEMENT ==========
+    
+    void clear() {
+        entries_.clear();
+    }
+    
+    [[nodiscard]] size_t usedBytes() const {
+        return entries_.usedBytes();
+    }
+    
+    [[nodiscard]] Stats stats() const noexcept {
+        return {
+            hits_.load(std::memory_order_relaxed),
+            stale_hits_.load(std::memory_order_relaxed),
+            misses_.load(std::memory_order_relaxed),
+            coalesced_.load(std::memory_order_relaxed)
+        };
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    struct CachedResponse {
+        uint16_t status;
+        std::string status_message;
+        std::vector<std::pair<std::string, std::string>> headers;
+        std::shared_ptr<const std::string> body;
+        Clock::time_point stored_at;
+        Clock::time_point fresh_until;
+        Clock::time_point stale_until;
+        
+        [[nodiscard]] size_t memoryCost() const noexcept {
+            size_t cost = sizeof(*this) + status_message.size() + body->size();
+            for (const auto& [name, value] : headers) {
+                cost += name.size() + value.size() + 2 * sizeof(std::string);
+            }
+            return cost;
+        }
+    };
+    
+    // One handler run that other requests for the same key wait on
+    struct Flight {
+        std::mutex mutex;
+        std::condition_variable done_cv;
+        bool done = false;
+        std::shared_ptr<const CachedResponse> result;  // nullptr: not cacheable
+    };
+    
+    // Ends the flight even if the handler throws, so waiters stop waiting
+    class FlightGuard {
+    public:
+        FlightGuard(ResponseCachePlugin& cache, const std::string& key, std::shared_ptr<Flight> flight)
+            : cache_(cache), key_(key), flight_(std::move(flight)) {}
+        
+        ~FlightGuard() {
+            cache_.land(key_, *flight_, std::move(result_));
+        }
+        
+        FlightGuard(const FlightGuard&) = delete;
+        FlightGuard& operator=(const FlightGuard&) = delete;
+        
+        void publish(std::shared_ptr<const CachedResponse> result) {
+            result_ = std::move(result);
+        }
+    
+    private:
+        ResponseCachePlugin& cache_;
+        const std::string& key_;
+        std::shared_ptr<Flight> flight_;
+        std::shared_ptr<const CachedResponse> result_;
+    };
+    
+    ResponseCacheConfig config_;
+    utils::LruCache<CachedResponse> entries_;
+    
+    std::mutex flights_mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Flight>> flights_;
+    
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> stale_hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> coalesced_{0};
+    
+    [[nodiscard]] static bool cacheableStatus(uint16_t status) noexcept {
+        switch (status) {
+            case 200: case 203: case 204: case 300: case 301: case 404: case 410:
+                return true;
+            default:
+                return false;
+        }
+    }
+    
+    static void buildKey(std::string& key, const http::HTTPRequest& request, const CachePolicy& policy) {
+        key.clear();
+        key.append(http::methodToString(request.getMethod())).append(" ");
+        key.append(request.getPath());
+        if (!request.getQueryString().empty()) {
+            key.append("?").append(request.getQueryString());
+        }
+        for (const auto& name : policy.vary) {
+            key.append("\n").append(request.getHeader(name).value_or(""));
+        }
+    }
+    
+    static void replay(core::Context& ctx, const CachedResponse& entry) {
+        auto& response = ctx.response();
+        response.setStatus(entry.status, entry.status_message);
+        for (const auto& [name, value] : entry.headers) {
+            response.addHeader(name, value);
+        }
+        auto age = std::chrono::duration_cast<std::chrono::seconds>(Clock::now() - entry.stored_at);
+        response.setHeader("Age", ctx.format("{}", age.count()));
+        response.setSharedBody(entry.body);
+    }
+    
+    void serve(core::Context& ctx, const CachePolicy& policy, const core::RouteHandler& handler) {
+        // Per-worker key buffer; copied only when an entry is stored
+        static thread_local std::string key;
+        buildKey(key, ctx.request(), policy);
+        
+        auto now = Clock::now();
+        auto entry = entries_.find(key);
+        if (entry && now < entry->fresh_until) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            replay(ctx, *entry);
+            return;
+        }
+        
+        auto [flight, leader] = join(key);
+        if (!leader) {
+            // Someone is already computing this key: serve stale if allowed,
+            // otherwise wait for their result
+            if (entry && now < entry->stale_until) {
+                stale_hits_.fetch_add(1, std::memory_order_relaxed);
+                replay(ctx, *entry);
+                return;
+            }
+            if (auto result = wait(*flight, policy.max_wait)) {
+                coalesced_.fetch_add(1, std::memory_order_relaxed);
+                replay(ctx, *result);
+                return;
+            }
+            handler(ctx);  // Not cacheable (or too slow): answer on our own
+            return;
+        }
+        
+        std::string owned_key = key;
+        FlightGuard guard(*this, owned_key, std::move(flight));
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        
+        // Headers set so far come from middleware and are not cached
+        size_t preset_headers = ctx.response().getHeaders().size();
+        handler(ctx);
+        
+        if (auto stored = capture(ctx.response(), preset_headers, policy)) {
+            entries_.insert(owned_key, stored, stored->memoryCost());
+            guard.publish(std::move(stored));
+        }
+    }
+    
+    [[nodiscard]] std::shared_ptr<const CachedResponse> capture(const http::HTTPResponse& response,
+                                                                 size_t preset_headers,
+                                                                 const CachePolicy& policy) const {
+        if (!cacheableStatus(response.getStatus()) || response.isStreaming() || response.getFileBody() ||
+            response.getBody().size() > config_.max_entry_bytes || response.getHeader("Set-Cookie")) {
+            return nullptr;
+        }
+        auto cache_control = response.getHeader("Cache-Control").value_or("");
+        if (cache_control.find("no-store") != std::string_view::npos ||
+            cache_control.find("private") != std::string_view::npos) {
+            return nullptr;
+        }
+        
+        auto entry = std::make_shared<CachedResponse>();
+        entry->status = response.getStatus();
+        entry->status_message = response.getStatusMessage();
+        const auto& headers = response.getHeaders();
+        for (size_t i = preset_headers; i < headers.size(); ++i) {
+            entry->headers.emplace_back(headers[i].first, headers[i].second);
+        }
+        entry->body = std::make_shared<const std::string>(response.getBody());
+        entry->stored_at = Clock::now();
+        entry->fresh_until = entry->stored_at + policy.ttl;
+        entry->stale_until = entry->fresh_until + policy.stale_while_revalidate;
+        return entry;
+    }
+    
+    // The flight for `key`, and whether the caller started it
+    [[nodiscard]] std::pair<std::shared_ptr<Flight>, bool> join(const std::string& key) {
+        std::lock_guard<std::mutex> lock(flights_mutex_);
+        auto [it, inserted] = flights_.try_emplace(key);
+        if (inserted) {
+            it->second = std::make_shared<Flight>();
+        }
+        return {it->second, inserted};
+    }
+    
+    void land(const std::string& key, Flight& flight, std::shared_ptr<const CachedResponse> result) {
+        {
+            std::lock_guard<std::mutex> lock(flights_mutex_);
+            flights_.erase(key);
+        }
+        {
+            std::lock_guard<std::mutex> lock(flight.mutex);
+            flight.result = std::move(result);
+            flight.done = true;
+        }
+        flight.done_cv.notify_all();
+    }
+    
+    [[nodiscard]] static std::shared_ptr<const CachedResponse> wait(Flight& flight, std::chrono::milliseconds limit) {
+        std::unique_lock<std::mutex> lock(flight.mutex);
+        flight.done_cv.wait_for(lock, limit, [&flight] { return flight.done; });
+        return flight.result;
+    }
+};
+
+} // namespace frqs::plugins
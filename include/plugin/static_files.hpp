@@ -10,6 +10,12 @@
  * - MIME type detection
  * - Configurable default file (index.html)
  * - Optional directory listing
+ * - LRU cache of hot assets with ETag / Last-Modified and 304 responses
+ * - Precompressed `.br` / `.gz` siblings chosen by Accept-Encoding
+ * - Range / If-Range requests: 206 single ranges and multipart/byteranges,
+ *   read straight from the file (sendfile) or the mapped bundle
+ * - A packed asset bundle (`frqs_pack`) served from memory-mapped pages
+ * - Settings that can be replaced while serving (reconfigure())
  * 
  * @copyright Copyright (c) 2025
  */
@@ -19,7 +25,15 @@
 #include "utils/filesystem_utils.hpp"
 #include "utils/logger.hpp"
 #include "http/mime_types.hpp"
+#include "http/date.hpp"
+#include "http/compression.hpp"
+#include "http/range.hpp"
+#include "asset_bundle.hpp"
+#include "asset_cache.hpp"
+#include <chrono>
 #include <filesystem>
+#include <optional>
+#include <vector>
 
 namespace frqs::plugins {
 
@@ -42,14 +56,39 @@ struct StaticFilesConfig : PluginConfig {
     /// Cache-Control header value
     std::string cache_control = "public, max-age=3600";
     
-    /// Maximum file size to serve (bytes)
+    /// Most bytes sent in one response: larger files are refused whole (413)
+    /// but served in ranges, each answer cut down to this size
     size_t max_file_size = 100 * 1024 * 1024;  // 100MB
     
+    /// Total bytes of file bodies kept in memory (0 disables the cache)
+    size_t cache_max_bytes = 64 * 1024 * 1024;  // 64MB
+    
+    /// Larger files are never cached; they are streamed with sendfile
+    size_t cache_max_file_size = 1024 * 1024;  // 1MB
+    
+    /// How long a cached file is trusted before its mtime is checked again
+    std::chrono::milliseconds cache_ttl{1000};
+    
+    /// Send ETag / Last-Modified and answer conditional requests with 304
+    bool enable_validators = true;
+    
+    /// Serve `file.br` / `file.gz` in place of `file` when the client accepts them
+    bool precompressed = true;
+    
+    /// Bundle written by `frqs_pack`; when set, files are served from it
+    /// alone and `root` is not used. A re-packed bundle is mapped in
+    /// within `cache_ttl`.
+    std::filesystem::path bundle;
+    
     void validate() const override {
-        if (!std::filesystem::exists(root)) {
+        if (!bundle.empty()) {
+            if (!std::filesystem::is_regular_file(bundle)) {
+                throw std::invalid_argument("Asset bundle is not a file: " + bundle.string());
+            }
+        } else if (!std::filesystem::exists(root)) {
             throw std::invalid_argument("Document root does not exist: " + root.string());
         }
-        if (!std::filesystem::is_directory(root)) {
+        if (bundle.empty() && !std::filesystem::is_directory(root)) {
             throw std::invalid_argument("Document root is not a directory: " + root.string());
         }
         if (mount_path.empty()) {
@@ -75,6 +114,9 @@ struct StaticFilesConfig : PluginConfig {
  * config.mount_path = "/static";
  * config.cache_control = "public, max-age=86400";
  * server.addPlugin(std::make_unique<StaticFilesPlugin>(config));
+ * 
+ * // From a bundle packed offline: `frqs_pack public site.pak`
+ * config.bundle = "site.pak";
  * ```
  */
 class StaticFilesPlugin : public Plugin {
@@ -114,14 +156,24 @@ public:
         try {
             config_.validate();
             
+            if (!config_.bundle.empty()) {
+                auto bundle = AssetBundle::open(config_.bundle);
+                utils::logInfo(std::format("Static files plugin initialized: bundle={} ({} files, {} bytes), mount={}",
+                    config_.bundle.string(), bundle->size(), bundle->bytes(), config_.mount_path));
+                bundle_.store(std::move(bundle));
+                settings_.store(std::make_shared<const StaticFilesConfig>(config_));
+                return true;
+            }
+            
             // Canonicalize root path
             config_.root = std::filesystem::canonical(config_.root);
+            settings_.store(std::make_shared<const StaticFilesConfig>(config_));
             
             utils::logInfo(std::format("Static files plugin initialized: root={}, mount={}",
                 config_.root.string(), config_.mount_path));
             
             return true;
-            
+        
         } catch (const std::exception& e) {
             utils::logError(std::format("Failed to initialize static files plugin: {}", e.what()));
             return false;
@@ -129,6 +181,8 @@ public:
     }
     
     void shutdown() override {
+        cache_.clear();
+        bundle_.store(nullptr);
         utils::logInfo("Static files plugin shutdown");
     }
     
@@ -148,25 +202,109 @@ public:
     [[nodiscard]] int priority() const noexcept override {
         return 900;  // Load late (after dynamic routes)
     }
+    
+    /**
+     * @brief Replace the settings while serving (a config reload, say)
+     * 
+     * Requests already running finish with the settings they started with.
+     * The mount path and the cache budget are fixed once the plugin is
+     * loaded; changes to them are ignored. A new root drops the cache.
+     * The bundle is mapped again if its path changed or the file was
+     * replaced (re-packed) since it was mapped.
+     * 
+     * @return false if the new settings are invalid (the old ones stay)
+     */
+    bool reconfigure(StaticFilesConfig config) {
+        std::shared_ptr<const AssetBundle> bundle;
+        try {
+            config.validate();
+            if (!config.bundle.empty()) {
+                auto current = bundle_.load();
+                bundle = current && current->path() == config.bundle && current->stillCurrent()
+                    ? std::move(current)
+                    : AssetBundle::open(config.bundle);
+            } else {
+                config.root = std::filesystem::canonical(config.root);
+            }
+        } catch (const std::exception& e) {
+            utils::logWarn(std::format("Static files settings not applied: {}", e.what()));
+            return false;
+        }
+        
+        if (config.mount_path != config_.mount_path || config.cache_max_bytes != config_.cache_max_bytes) {
+            utils::logWarn("Static files: mount path and cache size only change on restart");
+            config.mount_path = config_.mount_path;
+            config.cache_max_bytes = config_.cache_max_bytes;
+        }
+        
+        auto previous = settings();
+        cache_.setTtl(config.cache_ttl);
+        if (config.root != previous->root || config.cache_max_file_size != previous->cache_max_file_size ||
+            config.precompressed != previous->precompressed) {
+            cache_.clear();
+        }
+        
+        // Bundle first: a request that sees the new settings sees their bundle
+        bundle_.store(std::move(bundle));
+        settings_.store(std::make_shared<const StaticFilesConfig>(std::move(config)));
+        return true;
+    }
+    
+    [[nodiscard]] std::shared_ptr<const StaticFilesConfig> settings() const {
+        return settings_.load();
+    }
 
 private:
-    StaticFilesConfig config_;
+    StaticFilesConfig config_;  // As loaded; mount path and cache budget come from here
+    std::atomic<std::shared_ptr<const StaticFilesConfig>> settings_{std::make_shared<const StaticFilesConfig>(config_)};
+    AssetCache cache_{config_.cache_max_bytes, config_.cache_ttl};
+    std::atomic<std::shared_ptr<const AssetBundle>> bundle_;  // Set while settings name a bundle
+    std::atomic<std::chrono::steady_clock::rep> bundle_checked_at_{0};
     
     void handleStaticFile(core::Context& ctx) {
-        std::string path(ctx.request().getPath());
+        // One snapshot per request, so a reconfigure() never mixes settings
+        auto settings = settings_.load();
+        const auto& config = *settings;
+        std::string_view relative = ctx.request().getPath();
         
         // Remove mount path prefix
-        if (path.starts_with(config_.mount_path)) {
-            path = path.substr(config_.mount_path.length());
+        if (relative.starts_with(config.mount_path)) {
+            relative.remove_prefix(config.mount_path.length());
         }
         
         // Default to index file for directories
-        if (path.empty() || path.ends_with('/')) {
-            path += config_.default_file;
+        std::string with_default;
+        if (relative.empty() || relative.ends_with('/')) {
+            with_default.reserve(relative.size() + config.default_file.size());
+            with_default.append(relative).append(config.default_file);
+            relative = with_default;
+        }
+        
+        // A bundle answers everything from memory; what it lacks does not exist
+        if (!config.bundle.empty()) {
+            auto bundle = currentBundle(config);
+            if (auto asset = bundle ? bundle->find(relative) : std::nullopt) {
+                serveBundled(ctx, config, bundle, *asset);
+            } else {
+                ctx.status(404)
+                   .header("Content-Type", "text/html")
+                   .body("<h1>404 Not Found</h1>");
+            }
+            return;
+        }
+        
+        // Fast path: hot assets skip every filesystem call
+        if (cache_.enabled()) {
+            if (auto asset = cache_.lookup(relative)) {
+                serveAsset(ctx, config, *asset);
+                return;
+            }
         }
         
+        std::string path(relative);
+        
         // Security: Resolve path safely
-        auto safe_path = utils::FileSystemUtils::securePath(config_.root, path);
+        auto safe_path = utils::FileSystemUtils::securePath(config.root, path);
         
         if (!safe_path) {
             utils::logWarn(std::format("Path traversal attempt blocked: {}", path));
@@ -186,7 +324,7 @@ private:
         
         // Check if it's a directory
         if (std::filesystem::is_directory(*safe_path)) {
-            if (config_.enable_directory_listing) {
+            if (config.enable_directory_listing) {
                 serveDirectoryListing(ctx, *safe_path);
             } else {
                 ctx.status(403)
@@ -204,34 +342,447 @@ private:
             return;
         }
         
-        // Check file size
-        auto file_size = std::filesystem::file_size(*safe_path);
-        if (file_size > config_.max_file_size) {
+        auto asset = loadAsset(config, *safe_path);
+        
+        if (!asset) {
+            ctx.status(500)
+               .header("Content-Type", "text/html")
+               .body("<h1>500 Internal Server Error</h1>");
+            return;
+        }
+        
+        if (asset->body) {
+            cache_.insert(std::move(path), asset);
+        }
+        
+        serveAsset(ctx, config, *asset);
+    }
+    
+    /**
+     * @brief The mapped bundle, re-mapped if it was re-packed
+     * 
+     * One request per `cache_ttl` pays a stat() to look; the others only
+     * load the pointer.
+     */
+    [[nodiscard]] std::shared_ptr<const AssetBundle> currentBundle(const StaticFilesConfig& config) {
+        auto bundle = bundle_.load();
+        auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        auto checked = bundle_checked_at_.load(std::memory_order_relaxed);
+        auto ttl = std::chrono::duration_cast<std::chrono::steady_clock::duration>(config.cache_ttl).count();
+        if (!bundle || now - checked <= ttl ||
+            !bundle_checked_at_.compare_exchange_strong(checked, now, std::memory_order_relaxed)) {
+            return bundle;
+        }
+        
+        if (!bundle->stillCurrent()) {
+            try {
+                auto fresh = AssetBundle::open(bundle->path());
+                utils::logInfo(std::format("Static files: bundle {} re-mapped ({} files)",
+                    fresh->path().string(), fresh->size()));
+                // A reconfigure() in between wins
+                if (bundle_.compare_exchange_strong(bundle, fresh)) {
+                    bundle = std::move(fresh);
+                }
+            } catch (const std::exception& e) {
+                utils::logWarn(std::format("Static files: keeping the mapped bundle: {}", e.what()));
+            }
+        }
+        return bundle;
+    }
+    
+    /**
+     * @brief Open a file and describe it, with any precompressed siblings
+     */
+    [[nodiscard]] std::shared_ptr<StaticAsset> loadAsset(const StaticFilesConfig& config,
+                                                         const std::filesystem::path& path) const {
+        auto mime_type = http::MimeTypes::fromPath(path);
+        auto asset = loadFile(config, path, mime_type);
+        if (!asset) {
+            return nullptr;
+        }
+        
+        if (config.precompressed && http::MimeTypes::isCompressible(mime_type)) {
+            asset->brotli = loadVariant(config, *asset, http::ContentEncoding::Brotli);
+            asset->gzip = loadVariant(config, *asset, http::ContentEncoding::Gzip);
+        }
+        return asset;
+    }
+    
+    /**
+     * @brief Load `path.br` / `path.gz` as an encoded representation of `identity`
+     */
+    [[nodiscard]] std::shared_ptr<const StaticAsset> loadVariant(const StaticFilesConfig& config,
+                                                                 const StaticAsset& identity,
+                                                                 http::ContentEncoding encoding) const {
+        auto token = http::encodingToken(encoding);
+        auto sibling = identity.path;
+        sibling += encoding == http::ContentEncoding::Brotli ? ".br" : ".gz";
+        
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(sibling, ec)) {
+            return nullptr;
+        }
+        
+        auto variant = loadFile(config, sibling, identity.mime_type);
+        if (!variant) {
+            return nullptr;
+        }
+        
+        // Tie the variant's validators to the identity file it was built from
+        variant->content_encoding = token;
+        variant->etag = http::encodedEtag(identity.etag, encoding);
+        variant->modified_at = identity.modified_at;
+        variant->last_modified = identity.last_modified;
+        return variant;
+    }
+    
+    /**
+     * @brief Open a file and describe it; small files are read into memory
+     */
+    [[nodiscard]] std::shared_ptr<StaticAsset> loadFile(const StaticFilesConfig& config,
+                                                        const std::filesystem::path& path,
+                                                        std::string_view mime_type) const {
+        auto file = utils::FileHandle::open(path);
+        if (!file) {
+            return nullptr;
+        }
+        
+        std::error_code ec;
+        auto mtime = std::filesystem::last_write_time(path, ec);
+        if (ec) {
+            return nullptr;
+        }
+        
+        auto asset = std::make_shared<StaticAsset>();
+        asset->path = path;
+        asset->size = file->size();
+        asset->mtime = mtime;
+        asset->mime_type = mime_type;
+        
+        if (cache_.enabled() && asset->size <= config.cache_max_file_size) {
+            std::string content(static_cast<size_t>(asset->size), '\0');
+            size_t done = 0;
+            while (done < content.size()) {
+                auto n = file->readAt(done, content.data() + done, content.size() - done);
+                if (!n) return nullptr;
+                if (*n == 0) break;
+                done += *n;
+            }
+            content.resize(done);
+            asset->size = done;
+            asset->body = std::make_shared<const std::string>(std::move(content));
+        } else {
+            // The server streams it with sendfile/TransmitFile
+            asset->file = std::make_shared<const utils::FileHandle>(std::move(*file));
+        }
+        
+        asset->computeValidators();
+        return asset;
+    }
+    
+    void serveAsset(core::Context& ctx, const StaticFilesConfig& config, const StaticAsset& identity) {
+        const StaticAsset* asset = &identity;
+        
+        if (identity.gzip || identity.brotli) {
+            auto accept = ctx.request().getHeader("Accept-Encoding");
+            auto encoding = http::negotiateEncoding(accept.value_or(""),
+                                                    identity.gzip != nullptr,
+                                                    identity.brotli != nullptr);
+            if (encoding == http::ContentEncoding::Brotli) {
+                asset = identity.brotli.get();
+            } else if (encoding == http::ContentEncoding::Gzip) {
+                asset = identity.gzip.get();
+            }
+            ctx.header("Vary", "Accept-Encoding");
+        }
+        
+        if (config.enable_validators) {
+            ctx.header("ETag", asset->etag)
+               .header("Last-Modified", asset->last_modified);
+            
+            if (notModified(ctx.request(), asset->etag, asset->modified_at)) {
+                ctx.status(304)
+                   .header("Cache-Control", config.cache_control);
+                return;
+            }
+        }
+        
+        Content content{
+            .mime_type = asset->mime_type,
+            .content_encoding = asset->content_encoding,
+            .etag = asset->etag,
+            .modified_at = asset->modified_at,
+            .size = asset->size,
+            .bytes = asset->body ? std::string_view(*asset->body) : std::string_view(),
+            .owner = asset->body,
+            .file = asset->body ? nullptr : asset->file,
+        };
+        sendContent(ctx, config, content);
+    }
+    
+    /**
+     * @brief Serve a packed file; the body points into the bundle's mapping
+     */
+    void serveBundled(core::Context& ctx, const StaticFilesConfig& config,
+                      const std::shared_ptr<const AssetBundle>& bundle, const AssetBundle::Asset& asset) {
+        auto encoding = http::ContentEncoding::Identity;
+        bool gzip = asset.has(http::ContentEncoding::Gzip);
+        bool brotli = asset.has(http::ContentEncoding::Brotli);
+        if (config.precompressed && (gzip || brotli)) {
+            auto accept = ctx.request().getHeader("Accept-Encoding");
+            encoding = http::negotiateEncoding(accept.value_or(""), gzip, brotli);
+            ctx.header("Vary", "Accept-Encoding");
+        }
+        auto representation = asset.get(encoding);
+        
+        if (config.enable_validators) {
+            ctx.header("ETag", representation.etag)
+               .header("Last-Modified", asset.lastModified());
+            
+            if (notModified(ctx.request(), representation.etag, asset.modifiedAt())) {
+                ctx.status(304)
+                   .header("Cache-Control", config.cache_control);
+                return;
+            }
+        }
+        
+        Content content{
+            .mime_type = asset.mimeType(),
+            .content_encoding = representation.content_encoding,
+            .etag = representation.etag,
+            .modified_at = asset.modifiedAt(),
+            .size = representation.body.size(),
+            .bytes = representation.body,
+            .owner = bundle,
+            .file = nullptr,
+        };
+        sendContent(ctx, config, content);
+    }
+    
+    static constexpr size_t MAX_RANGES = 16;
+    static constexpr size_t RANGE_READ_CHUNK = 64 * 1024;
+    
+    // One representation of a file and where its bytes are
+    struct Content {
+        std::string_view mime_type;
+        std::string_view content_encoding;
+        std::string_view etag;
+        std::chrono::system_clock::time_point modified_at;
+        uint64_t size = 0;
+        std::string_view bytes;                         // In memory (cached or mapped)...
+        std::shared_ptr<const void> owner;              // ...kept alive by this
+        std::shared_ptr<const utils::FileHandle> file;  // Or on disk, when bytes is unset
+    };
+    
+    /**
+     * @brief 200 with the whole representation, or 206 / 416 for a Range request
+     * 
+     * Ranges only pick bytes out of what is already there: a file slice
+     * goes out with sendfile from its offset, a cached or mapped one as a
+     * view, and several ranges of a file are read one by one while the
+     * multipart body is sent.
+     */
+    void sendContent(core::Context& ctx, const StaticFilesConfig& config, const Content& content) {
+        const auto& request = ctx.request();
+        ctx.header("Accept-Ranges", "bytes");
+        
+        // Range is defined for GET only (RFC 9110 section 14.2)
+        std::optional<std::vector<http::ByteRange>> ranges;
+        auto range = request.getHeader("Range");
+        if (range && request.getMethod() == http::Method::GET && ifRangeHolds(request, config, content)) {
+            ranges = http::parseRange(*range, content.size, MAX_RANGES);
+        }
+        
+        if (ranges && ranges->empty()) {
+            ctx.status(416)
+               .header("Content-Range", http::unsatisfiedRange(content.size))
+               .header("Content-Type", "text/html")
+               .body("<h1>416 Range Not Satisfiable</h1>");
+            return;
+        }
+        
+        if (!ranges && content.size > config.max_file_size) {
             ctx.status(413)
                .header("Content-Type", "text/html")
                .body("<h1>413 Payload Too Large</h1>");
             return;
         }
         
-        // Read file
-        auto content = utils::FileSystemUtils::readFile(*safe_path, config_.max_file_size);
+        ctx.header("Cache-Control", config.cache_control);
+        if (!content.content_encoding.empty()) {
+            ctx.header("Content-Encoding", content.content_encoding);
+        }
         
-        if (!content) {
-            ctx.status(500)
-               .header("Content-Type", "text/html")
-               .body("<h1>500 Internal Server Error</h1>");
+        if (!ranges) {
+            ctx.status(200)
+               .header("Content-Type", content.mime_type);
+            if (content.file) {
+                ctx.response().setFileBody(content.file);
+            } else {
+                ctx.response().setSharedBody(content.bytes, content.owner);
+            }
             return;
         }
         
-        // Determine MIME type
-        auto mime_type = http::MimeTypes::fromPath(*safe_path);
+        limitRanges(*ranges, config.max_file_size);
         
-        // Send response
-        ctx.status(200)
-           .header("Content-Type", mime_type)
-           .header("Cache-Control", config_.cache_control)
-           .header("Content-Length", std::to_string(content->size()))
-           .body(std::move(*content));
+        if (ranges->size() == 1) {
+            auto part = ranges->front();
+            ctx.status(206)
+               .header("Content-Type", content.mime_type)
+               .header("Content-Range", http::contentRange(part, content.size));
+            if (content.file) {
+                ctx.response().setFileBody(content.file, part.offset, part.length);
+            } else {
+                ctx.response().setSharedBody(content.bytes.substr(part.offset, part.length), content.owner);
+            }
+            return;
+        }
+        
+        auto boundary = http::byteRangesBoundary();
+        std::vector<std::string> heads;
+        heads.reserve(ranges->size());
+        uint64_t total = 0;
+        for (const auto& part : *ranges) {
+            heads.push_back(http::byteRangesPartHead(boundary, content.mime_type, part, content.size));
+            total += heads.back().size() + part.length;
+        }
+        auto tail = http::byteRangesTail(boundary);
+        total += tail.size();
+        
+        ctx.status(206)
+           .header("Content-Type", std::format("multipart/byteranges; boundary={}", boundary));
+        
+        if (!content.file) {
+            std::string body;
+            body.reserve(static_cast<size_t>(total));
+            for (size_t i = 0; i < ranges->size(); ++i) {
+                body.append(heads[i]).append(content.bytes.substr((*ranges)[i].offset, (*ranges)[i].length));
+            }
+            body.append(tail);
+            ctx.body(std::move(body));
+            return;
+        }
+        
+        // Framed by length, so the parts can be read from disk as they are sent
+        ctx.header("Content-Length", std::to_string(total));
+        ctx.response().setStreamBody([file = content.file, parts = std::move(*ranges),
+                                      heads = std::move(heads), tail = std::move(tail)](http::BodyWriter& out) {
+            std::string buffer(RANGE_READ_CHUNK, '\0');
+            for (size_t i = 0; i < parts.size(); ++i) {
+                if (!out.write(heads[i])) {
+                    return;
+                }
+                uint64_t done = 0;
+                while (done < parts[i].length) {
+                    auto want = static_cast<size_t>(std::min<uint64_t>(buffer.size(), parts[i].length - done));
+                    auto n = file->readAt(parts[i].offset + done, buffer.data(), want);
+                    if (!n || *n == 0 || !out.write(std::string_view(buffer.data(), *n))) {
+                        return;  // Truncated file: the client sees a short body
+                    }
+                    done += *n;
+                }
+            }
+            out.write(tail);
+        });
+    }
+    
+    // Keep one response within max_file_size: past it, only a prefix of
+    // the first range is sent and the client asks again for the rest
+    static void limitRanges(std::vector<http::ByteRange>& ranges, uint64_t limit) {
+        uint64_t total = 0;
+        for (const auto& range : ranges) {
+            total += range.length;
+        }
+        if (total <= limit) {
+            return;
+        }
+        ranges.resize(1);
+        ranges.front().length = std::min(ranges.front().length, std::max<uint64_t>(limit, 1));
+    }
+    
+    /**
+     * @brief If-Range evaluation (RFC 9110 section 13.1.5)
+     * 
+     * Ranges are only served if the client's partial copy is of this
+     * representation: a strong ETag match or the exact Last-Modified date.
+     * Otherwise the client gets the whole thing.
+     */
+    [[nodiscard]] static bool ifRangeHolds(const http::HTTPRequest& request, const StaticFilesConfig& config,
+                                           const Content& content) {
+        auto if_range = request.getHeader("If-Range");
+        if (!if_range) {
+            return true;
+        }
+        if (!config.enable_validators) {
+            return false;  // The client cannot hold validators we never sent
+        }
+        if (if_range->starts_with('"') || if_range->starts_with("W/")) {
+            return *if_range == content.etag;  // Strong comparison: weak tags never match
+        }
+        auto date = http::parseHttpDate(*if_range);
+        return date && *date == content.modified_at;
+    }
+    
+    /**
+     * @brief Conditional GET evaluation (RFC 9110 section 13.2.2)
+     * 
+     * If-None-Match takes precedence; If-Modified-Since is only consulted
+     * when it is absent.
+     */
+    [[nodiscard]] static bool notModified(const http::HTTPRequest& request, std::string_view etag,
+                                          std::chrono::system_clock::time_point modified_at) {
+        if (auto if_none_match = request.getHeader("If-None-Match")) {
+            return etagMatches(*if_none_match, etag);
+        }
+        
+        if (auto if_modified_since = request.getHeader("If-Modified-Since")) {
+            auto since = http::parseHttpDate(*if_modified_since);
+            return since && modified_at <= *since;
+        }
+        
+        return false;
+    }
+    
+    // Weak comparison, as If-None-Match requires: "W/" prefixes are ignored.
+    // A tag of another encoding of the same file also matches, since the
+    // client re-negotiates the encoding on the next full response anyway.
+    [[nodiscard]] static bool etagMatches(std::string_view header, std::string_view etag) {
+        auto trim = [](std::string_view s) {
+            while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+            while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+            return s;
+        };
+        
+        header = trim(header);
+        if (header == "*") {
+            return true;
+        }
+        
+        while (!header.empty()) {
+            auto comma = header.find(',');
+            auto candidate = trim(header.substr(0, comma));
+            if (candidate.starts_with("W/")) {
+                candidate.remove_prefix(2);
+            }
+            if (candidate == etag || sameFile(candidate, etag)) {
+                return true;
+            }
+            if (comma == std::string_view::npos) break;
+            header.remove_prefix(comma + 1);
+        }
+        return false;
+    }
+    
+    // "abc-gzip" vs "abc-br" vs "abc": equal once the encoding suffix is removed
+    [[nodiscard]] static bool sameFile(std::string_view a, std::string_view b) {
+        auto strip = [](std::string_view tag) {
+            if (tag.ends_with("-gzip\"")) tag.remove_suffix(6);
+            else if (tag.ends_with("-br\"")) tag.remove_suffix(4);
+            else if (tag.ends_with('"')) tag.remove_suffix(1);
+            return tag;
+        };
+        return strip(a) == strip(b);
     }
     
     void serveDirectoryListing(core::Context& ctx, const std::filesystem::path& dir) {
@@ -257,7 +808,7 @@ private:
     <p><a href="../">📁 Parent Directory</a></p>
     <ul>
 )HTML";
-        
+
         try {
             std::vector<std::filesystem::directory_entry> entries;
             for (const auto& entry : std::filesystem::directory_iterator(dir)) {
@@ -294,7 +845,7 @@ private:
                     css_class, name, icon, name, size_str
                 );
             }
-            
+        
         } catch (const std::exception& e) {
             html += std::format("<li>Error: {}</li>\n", e.what());
         }
@@ -304,7 +855,7 @@ private:
 </body>
 </html>
 )HTML";
-        
+
         ctx.status(200)
            .header("Content-Type", "text/html")
            .body(html);
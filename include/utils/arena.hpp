@@ -0,0 +1,88 @@
+#pragma once
+
+/**
+ * @file utils/arena.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Monotonic per-request memory arena
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace frqs::utils {
+
+/**
+ * @brief Bump allocator that is rewound, not freed, between requests
+ *
+ * Allocation moves a pointer forward; deallocation does nothing. reset()
+ * makes all memory reusable at once. The first INLINE_SIZE bytes live in
+ * the arena object itself; past that, chunks double in size and come from
+ * the upstream resource. On reset() only the largest chunk up to
+ * MAX_RETAINED_SIZE is kept, so a worker settles on one chunk big enough
+ * for its typical request without pinning memory for an outlier.
+ *
+ * Use it as a std::pmr::memory_resource. Anything allocated from it must
+ * be gone before reset() is called. Not thread-safe: one arena per worker.
+ *
+ * @example
+ * ```cpp
+ * utils::Arena arena ;
+ * std::pmr::vector<std::pmr::string> names(&arena) ;
+ * names.emplace_back("alice") ;
+ * // ...
+ * names.clear() ;
+ * arena.reset() ;
+ * ```
+ */
+class Arena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t INLINE_SIZE = 4 * 1024 ;
+    static constexpr size_t MIN_CHUNK_SIZE = 16 * 1024 ;
+    static constexpr size_t MAX_RETAINED_SIZE = 256 * 1024 ;
+
+    explicit Arena(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept ;
+    ~Arena() override ;
+
+    Arena(const Arena&) = delete ;
+    Arena& operator=(const Arena&) = delete ;
+
+    // Make every allocation reusable; keeps one chunk for the next request
+    void reset() noexcept ;
+
+    // Bytes handed out since the last reset (alignment padding included)
+    [[nodiscard]] size_t used() const noexcept { return used_ ; }
+
+    // Bytes the arena can hand out before it needs another chunk
+    [[nodiscard]] size_t capacity() const noexcept ;
+
+private:
+    struct Chunk {
+        Chunk* next ;
+        size_t size ;    // Usable bytes following the header
+    } ;
+
+    void* do_allocate(size_t bytes, size_t alignment) override ;
+    void do_deallocate(void*, size_t, size_t) noexcept override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other ;
+    }
+
+    void* allocateSlow(size_t bytes, size_t alignment) ;
+    void freeChunk(Chunk* chunk) noexcept ;
+
+    std::pmr::memory_resource* upstream_ ;
+    Chunk* chunks_ = nullptr ;      // In use since the last reset, newest first
+    Chunk* spare_ = nullptr ;       // Kept by reset(), used before allocating
+    char* cursor_ = nullptr ;
+    char* end_ = nullptr ;
+    size_t used_ = 0 ;
+
+    alignas(std::max_align_t) char inline_[INLINE_SIZE] ;
+} ;
+
+} // namespace frqs::utils
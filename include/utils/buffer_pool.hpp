@@ -0,0 +1,140 @@
+#pragma once
+
+/**
+ * @file utils/buffer_pool.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Slab-allocated, reference-counted I/O buffers
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace frqs::utils {
+
+namespace detail {
+    // Lives directly in front of the buffer bytes
+    struct alignas(64) BufferBlock {
+        std::atomic<uint32_t> refs{1} ;
+        bool pooled = false ;
+        size_t capacity = 0 ;
+
+        [[nodiscard]] char* bytes() noexcept { return reinterpret_cast<char*>(this + 1) ; }
+    } ;
+}
+
+/**
+ * @brief Handle to a buffer; copies share the bytes
+ *
+ * The buffer returns to its pool (or the heap, if it was too large to be
+ * pooled) when the last handle goes away. Sharing is not copy-on-write:
+ * writers check unique() before touching bytes another handle may read.
+ */
+class SharedBuffer {
+public:
+    SharedBuffer() noexcept = default ;
+
+    SharedBuffer(const SharedBuffer& other) noexcept : block_(other.block_) {
+        if (block_) {
+            block_->refs.fetch_add(1, std::memory_order_relaxed) ;
+        }
+    }
+
+    SharedBuffer(SharedBuffer&& other) noexcept : block_(std::exchange(other.block_, nullptr)) {}
+
+    SharedBuffer& operator=(const SharedBuffer& other) noexcept {
+        SharedBuffer(other).swap(*this) ;
+        return *this ;
+    }
+
+    SharedBuffer& operator=(SharedBuffer&& other) noexcept {
+        SharedBuffer(std::move(other)).swap(*this) ;
+        return *this ;
+    }
+
+    ~SharedBuffer() { reset() ; }
+
+    void reset() noexcept ;
+
+    void swap(SharedBuffer& other) noexcept { std::swap(block_, other.block_) ; }
+
+    [[nodiscard]] char* data() const noexcept { return block_ ? block_->bytes() : nullptr ; }
+    [[nodiscard]] size_t capacity() const noexcept { return block_ ? block_->capacity : 0 ; }
+
+    // No other handle shares the bytes
+    [[nodiscard]] bool unique() const noexcept {
+        return block_ && block_->refs.load(std::memory_order_acquire) == 1 ;
+    }
+
+    [[nodiscard]] explicit operator bool() const noexcept { return block_ != nullptr ; }
+
+private:
+    friend class BufferPool ;
+    explicit SharedBuffer(detail::BufferBlock* block) noexcept : block_(block) {}
+
+    detail::BufferBlock* block_ = nullptr ;
+} ;
+
+/**
+ * @brief Process-wide pool of fixed-size receive buffers
+ *
+ * Requests up to BLOCK_SIZE bytes are served from slabs of BLOCKS_PER_SLAB
+ * blocks carved out in one allocation. Each thread keeps a few free
+ * blocks of its own, so acquiring and releasing on the same thread does
+ * not take the pool lock. Larger buffers come straight from the heap and
+ * go back to it when released. Slabs are kept for the life of the
+ * process; their number follows the peak number of buffers in use.
+ */
+class BufferPool {
+public:
+    static constexpr size_t BLOCK_SIZE = 16 * 1024 ;
+    static constexpr size_t BLOCKS_PER_SLAB = 64 ;
+
+    struct Stats {
+        size_t slabs = 0 ;
+        size_t free_blocks = 0 ;    // In the shared free list (thread caches excluded)
+        size_t heap_buffers = 0 ;   // Oversized buffers currently alive
+    } ;
+
+    [[nodiscard]] static BufferPool& instance() ;
+
+    // Uninitialized buffer of at least `min_capacity` bytes
+    [[nodiscard]] SharedBuffer acquire(size_t min_capacity) ;
+
+    [[nodiscard]] Stats stats() const ;
+
+private:
+    friend class SharedBuffer ;
+
+    BufferPool() = default ;
+
+    void release(detail::BufferBlock* block) noexcept ;
+    detail::BufferBlock* takeBlock() ;
+    void allocateSlab() ;
+    void giveBack(std::vector<detail::BufferBlock*>& blocks) noexcept ;
+
+    mutable std::mutex mutex_ ;
+    std::vector<detail::BufferBlock*> free_ ;
+    std::vector<void*> slabs_ ;
+    std::atomic<size_t> heap_buffers_{0} ;
+
+    struct LocalCache ;
+    static LocalCache& localCache() ;
+} ;
+
+inline void SharedBuffer::reset() noexcept {
+    if (block_ && block_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        BufferPool::instance().release(block_) ;
+    }
+    block_ = nullptr ;
+}
+
+} // namespace frqs::utils
@@ -0,0 +1,36 @@
+#pragma once
+
+/**
+ * @file utils/byte_scan.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Vectorized search for the first of a few delimiter bytes
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * The implementation is picked once at startup: AVX2 (32 bytes per step)
+ * when the CPU has it, otherwise SSE2 on x86-64 or NEON on AArch64
+ * (16 bytes per step), with a scalar loop everywhere else and for tails.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <cstddef>
+#include <string_view>
+
+namespace frqs::utils {
+
+/**
+ * @brief Index of the first byte equal to `a`, `b` or `c`
+ * @return Offset into `data`, or `size` if none of them occurs
+ */
+[[nodiscard]] size_t findFirstOf(const char* data, size_t size, char a, char b, char c) noexcept ;
+
+[[nodiscard]] inline size_t findFirstOf(const char* data, size_t size, char a, char b) noexcept {
+    return findFirstOf(data, size, a, b, b) ;
+}
+
+// Name of the implementation in use ("avx2", "sse2", "neon" or "scalar")
+[[nodiscard]] std::string_view byteScanBackend() noexcept ;
+
+} // namespace frqs::utils
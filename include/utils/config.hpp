@@ -3,69 +3,196 @@
 /**
  * @file utils/config.hpp
  * @author zuudevs (zuudevs@gmail.com)
- * @brief 
- * @version 1.0.0
+ * @brief Key/value configuration with lock-free reads and hot reload
+ * @version 1.1.0
  * @date 2025-12-09
- * 
+ *
  * @copyright Copyright (c) 2025
- * 
+ *
  */
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
-#include <optional>
-#include <filesystem>
-#include <mutex>
+#include <vector>
 
 namespace frqs::utils {
 
+/**
+ * @brief Immutable configuration values as of one load
+ *
+ * Numbers and booleans are parsed once, when the snapshot is built, so
+ * typed reads are a hash lookup. Lookups take string_views without
+ * allocating a key.
+ */
+class ConfigSnapshot {
+public:
+    struct Value {
+        std::string text ;
+        std::optional<int> as_int ;   // Leading integer of the text, if any
+        bool as_bool = false ;        // "true", "1" or "yes" (any case)
+    } ;
+
+    ConfigSnapshot() = default ;
+    ConfigSnapshot(const std::unordered_map<std::string, std::string>& values, uint64_t version) ;
+
+    [[nodiscard]] const Value* find(std::string_view key) const noexcept ;
+
+    // Views stay valid as long as the snapshot does
+    [[nodiscard]] std::optional<std::string_view> get(std::string_view key) const noexcept ;
+    [[nodiscard]] std::optional<int> getInt(std::string_view key) const noexcept ;
+    [[nodiscard]] std::optional<bool> getBool(std::string_view key) const noexcept ;
+
+    // Whether `key` has a different value (or presence) in `other`
+    [[nodiscard]] bool differs(const ConfigSnapshot& other, std::string_view key) const noexcept ;
+
+    [[nodiscard]] uint64_t version() const noexcept { return version_ ; }
+    [[nodiscard]] size_t size() const noexcept { return values_.size() ; }
+
+private:
+    struct KeyHash {
+        using is_transparent = void ;
+        size_t operator()(std::string_view key) const noexcept { return std::hash<std::string_view>{}(key) ; }
+    } ;
+
+    std::unordered_map<std::string, Value, KeyHash, std::equal_to<>> values_ ;
+    uint64_t version_ = 0 ;
+} ;
+
+/**
+ * @brief Process-wide configuration (KEY=VALUE file)
+ *
+ * Values live in an immutable ConfigSnapshot that load(), reload() and
+ * set() replace as a whole (RCU style): readers never take a lock, and a
+ * reader in the middle of a request keeps the snapshot it started with.
+ * Each thread caches the snapshot it last used, so a read is a version
+ * load plus the lookup.
+ *
+ * A reload parses and validates the new file before swapping it in; a
+ * file that fails leaves the current values in place. Subscribers are
+ * then told about the keys that changed.
+ *
+ * @example
+ * ```cpp
+ * auto& config = Config::instance();
+ * config.load("frqs.conf");
+ * config.subscribe({"THREAD_COUNT"}, [&](const ConfigSnapshot& now) {
+ *     server.setThreadCount(static_cast<size_t>(now.getInt("THREAD_COUNT").value_or(4)));
+ * });
+ * config.watch();  // Reload when the file changes
+ * ```
+ */
 class Config {
 public:
+    // Checks a parsed snapshot before it is published; false (with a
+    // reason in `error`) keeps the current values
+    using Validator = std::function<bool(const ConfigSnapshot&, std::string& error)> ;
+
+    // Called after a reload changed one of the subscribed keys
+    using Callback = std::function<void(const ConfigSnapshot&)> ;
+
     static Config& instance() {
         static Config cfg ;
         return cfg ;
     }
-    
+
     Config(const Config&) = delete ;
     Config& operator=(const Config&) = delete ;
     Config(Config&&) = delete ;
     Config& operator=(Config&&) = delete ;
-    
-    // Load configuration from file
+
+    ~Config() ;
+
+    // Load configuration from file; it becomes the file reload() re-reads
     bool load(const std::filesystem::path& config_file) ;
-    
-    // Get configuration values
+
+    // Re-read the loaded file, validate it and swap it in
+    bool reload(std::string* error = nullptr) ;
+
+    // The current snapshot, for reading several values consistently
+    [[nodiscard]] std::shared_ptr<const ConfigSnapshot> snapshot() const noexcept { return snapshot_.load() ; }
+
+    // Get configuration values (lock-free)
     [[nodiscard]] std::optional<std::string> get(std::string_view key) const ;
-    [[nodiscard]] std::optional<int> getInt(std::string_view key) const ;
-    [[nodiscard]] std::optional<bool> getBool(std::string_view key) const ;
-    
+    [[nodiscard]] std::optional<int> getInt(std::string_view key) const noexcept ;
+    [[nodiscard]] std::optional<bool> getBool(std::string_view key) const noexcept ;
+
     // Convenience getters with defaults
-    [[nodiscard]] uint16_t getPort() const { return getInt("PORT").value_or(8080) ; }
+    [[nodiscard]] uint16_t getPort() const { return static_cast<uint16_t>(getInt("PORT").value_or(8080)) ; }
     [[nodiscard]] std::string getDocRoot() const { return get("DOC_ROOT").value_or("public") ; }
     [[nodiscard]] std::string getAuthToken() const { return get("AUTH_TOKEN").value_or("") ; }
     [[nodiscard]] int getFpsLimit() const { return getInt("FPS_LIMIT").value_or(15) ; }
     [[nodiscard]] int getScaleFactor() const { return getInt("SCALE_FACTOR").value_or(2) ; }
     [[nodiscard]] std::string getUploadDir() const { return get("UPLOAD_DIR").value_or("uploads") ; }
-    [[nodiscard]] size_t getMaxUploadSize() const { 
-        return static_cast<size_t>(getInt("MAX_UPLOAD_SIZE").value_or(50 * 1024 * 1024)) ; 
+    [[nodiscard]] size_t getMaxUploadSize() const {
+        return static_cast<size_t>(getInt("MAX_UPLOAD_SIZE").value_or(50 * 1024 * 1024)) ;
     }
-    [[nodiscard]] int getThreadCount() const { 
-        return getInt("THREAD_COUNT").value_or(static_cast<int>(std::thread::hardware_concurrency())) ; 
+    [[nodiscard]] int getThreadCount() const {
+        return getInt("THREAD_COUNT").value_or(static_cast<int>(std::thread::hardware_concurrency())) ;
     }
     [[nodiscard]] std::string getMasterServerUrl() const { return get("MASTER_SERVER_URL").value_or("") ; }
     [[nodiscard]] int getHeartbeatInterval() const { return getInt("HEARTBEAT_INTERVAL").value_or(30) ; }
-    
-    // Set values programmatically
+
+    // Set values programmatically; they survive reloads of the file
     void set(std::string_view key, std::string_view value) ;
 
+    // ========== HOT RELOAD ==========
+
+    void addValidator(Validator validator) ;
+
+    // `callback` runs on the reloading thread whenever one of `keys`
+    // changed (any key, if empty). It must not call load() or reload().
+    size_t subscribe(std::vector<std::string> keys, Callback callback) ;
+    void unsubscribe(size_t id) ;
+
+    // Poll the loaded file's modification time and reload when it changes
+    void watch(std::chrono::milliseconds interval = std::chrono::seconds(1)) ;
+    void stopWatching() ;
+
 private:
-    Config() = default ;
-    mutable std::mutex mutex_ ;
-    std::unordered_map<std::string, std::string> values_ ;
-    
-    void parseLine(std::string_view line) ;
+    struct Subscription {
+        size_t id ;
+        std::vector<std::string> keys ;
+        Callback callback ;
+    } ;
+
+    Config() ;
+
+    // Readers: the thread-local cached snapshot, renewed when version_ moved
+    [[nodiscard]] const ConfigSnapshot& current() const noexcept ;
+
+    // Build, validate and publish from file_values_ + overrides_ (reload_mutex_ held)
+    bool publish(std::unordered_map<std::string, std::string> file_values, std::string* error) ;
+
+    std::atomic<std::shared_ptr<const ConfigSnapshot>> snapshot_ ;
+    std::atomic<uint64_t> version_ ;
+
+    // Writers: loads, reloads and set() run one at a time, subscribers included
+    std::mutex reload_mutex_ ;
+    std::filesystem::path path_ ;
+    std::unordered_map<std::string, std::string> file_values_ ;
+    std::unordered_map<std::string, std::string> overrides_ ;
+
+    mutable std::mutex mutex_ ;   // Validators and subscriptions
+    std::vector<Validator> validators_ ;
+    std::vector<Subscription> subscribers_ ;
+    size_t next_subscription_ = 1 ;
+
+    std::jthread watcher_ ;
+
+    static bool parseFile(const std::filesystem::path& path,
+                          std::unordered_map<std::string, std::string>& values, std::string* error) ;
     static std::string trim(std::string_view str) ;
 } ;
 
-} // namespace frqs::utils
\ No newline at end of file
+} // namespace frqs::utils
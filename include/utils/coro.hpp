@@ -0,0 +1,400 @@
+#pragma once
+
+/**
+ * @file utils/coro.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Coroutine task type, executors, spawn() and syncWait()
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <array>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace frqs::coro {
+
+/**
+ * @brief Where a suspended coroutine continues once its wait is over
+ *
+ * Awaitables capture the executor current on the suspending thread (see
+ * currentExecutor()) and hand the coroutine back to it; with none the
+ * coroutine resumes on whichever thread completed the wait.
+ */
+class Executor {
+public:
+    virtual ~Executor() = default ;
+    virtual void post(std::coroutine_handle<> handle) = 0 ;
+} ;
+
+namespace detail {
+
+inline thread_local Executor* current_executor = nullptr ;
+
+/**
+ * @brief Per-thread free lists of coroutine frames by size class
+ *
+ * A handler that awaits creates a frame per call it makes; recycling them
+ * keeps that off the heap in steady state. A frame freed on another thread
+ * than the one that made it joins that thread's lists.
+ */
+class FrameCache {
+public:
+    static constexpr size_t HEADER = alignof(std::max_align_t) ;   // Holds the size class
+    static constexpr size_t MIN_BLOCK = 128 ;
+    static constexpr size_t CLASSES = 6 ;                           // 128 B .. 4 KiB
+    static constexpr size_t MAX_FREE = 64 ;                         // Per class
+
+    FrameCache() noexcept { state = State::Alive ; }
+    ~FrameCache() {
+        state = State::Destroyed ;
+        for (auto*& head : free_) {
+            while (head) {
+                ::operator delete(std::exchange(head, head->next)) ;
+            }
+        }
+    }
+
+    FrameCache(const FrameCache&) = delete ;
+    FrameCache& operator=(const FrameCache&) = delete ;
+
+    static void* allocate(size_t size) {
+        size_t total = size + HEADER ;
+        size_t size_class = 0 ;
+        while (size_class < CLASSES && (MIN_BLOCK << size_class) < total) {
+            ++size_class ;
+        }
+
+        void* block = nullptr ;
+        if (size_class < CLASSES && state != State::Destroyed) {
+            auto& cache = instance() ;
+            if (auto* head = cache.free_[size_class]) {
+                cache.free_[size_class] = head->next ;
+                --cache.count_[size_class] ;
+                block = head ;
+            }
+        }
+        if (!block) {
+            block = ::operator new(size_class < CLASSES ? MIN_BLOCK << size_class : total) ;
+        }
+        *static_cast<size_t*>(block) = size_class ;
+        return static_cast<std::byte*>(block) + HEADER ;
+    }
+
+    static void deallocate(void* frame) noexcept {
+        void* block = static_cast<std::byte*>(frame) - HEADER ;
+        size_t size_class = *static_cast<size_t*>(block) ;
+        if (size_class < CLASSES && state == State::Alive) {
+            auto& cache = instance() ;
+            if (cache.count_[size_class] < MAX_FREE) {
+                cache.free_[size_class] = ::new (block) Block{cache.free_[size_class]} ;
+                ++cache.count_[size_class] ;
+                return ;
+            }
+        }
+        ::operator delete(block) ;
+    }
+
+private:
+    struct Block {
+        Block* next ;
+    } ;
+
+    // Frames freed while the thread exits go straight back to the heap
+    enum class State : unsigned char { Unused, Alive, Destroyed } ;
+    static inline thread_local State state = State::Unused ;
+
+    static FrameCache& instance() noexcept {
+        static thread_local FrameCache cache ;
+        return cache ;
+    }
+
+    std::array<Block*, CLASSES> free_{} ;
+    std::array<size_t, CLASSES> count_{} ;
+} ;
+
+} // namespace detail
+
+[[nodiscard]] inline Executor* currentExecutor() noexcept {
+    return detail::current_executor ;
+}
+
+/**
+ * @brief Makes an executor current on this thread for the scope
+ */
+class ExecutorScope {
+public:
+    explicit ExecutorScope(Executor* executor) noexcept
+        : previous_(std::exchange(detail::current_executor, executor)) {}
+    ~ExecutorScope() { detail::current_executor = previous_ ; }
+
+    ExecutorScope(const ExecutorScope&) = delete ;
+    ExecutorScope& operator=(const ExecutorScope&) = delete ;
+
+private:
+    Executor* previous_ ;
+} ;
+
+// Hand `handle` to `executor`, or resume it right here without one
+inline void resumeOn(Executor* executor, std::coroutine_handle<> handle) {
+    if (executor) {
+        executor->post(handle) ;
+    } else {
+        handle.resume() ;
+    }
+}
+
+template<typename T = void>
+class Task ;
+
+namespace detail {
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine() ;
+    std::exception_ptr exception ;
+
+    // Continue the awaiting coroutine without growing the stack
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false ; }
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+            return handle.promise().continuation ;
+        }
+        void await_resume() const noexcept {}
+    } ;
+
+    std::suspend_always initial_suspend() const noexcept { return {} ; }
+    FinalAwaiter final_suspend() const noexcept { return {} ; }
+    void unhandled_exception() noexcept { exception = std::current_exception() ; }
+
+    static void* operator new(size_t size) { return FrameCache::allocate(size) ; }
+    static void operator delete(void* frame) noexcept { FrameCache::deallocate(frame) ; }
+} ;
+
+template<typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value ;
+
+    Task<T> get_return_object() noexcept ;
+
+    template<typename U>
+    void return_value(U&& result) { value.emplace(std::forward<U>(result)) ; }
+
+    T result() {
+        if (exception) {
+            std::rethrow_exception(exception) ;
+        }
+        return std::move(*value) ;
+    }
+} ;
+
+template<>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object() noexcept ;
+
+    void return_void() const noexcept {}
+
+    void result() const {
+        if (exception) {
+            std::rethrow_exception(exception) ;
+        }
+    }
+} ;
+
+} // namespace detail
+
+/**
+ * @brief Lazily started coroutine producing a T
+ *
+ * Nothing runs until the task is awaited; the awaiting coroutine resumes
+ * when it finishes, with the value or the exception it ended with. A
+ * chain of awaits runs by symmetric transfer, so it does not grow the
+ * stack. Frames come from a per-thread cache (detail::FrameCache).
+ *
+ * Use spawn() to start a task from plain code, or syncWait() to block on
+ * one.
+ *
+ * @example
+ * ```cpp
+ * coro::Task<int> answer(net::IoService& io) {
+ *     co_await io.sleepFor(std::chrono::milliseconds(10)) ;
+ *     co_return 42 ;
+ * }
+ * ```
+ */
+template<typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::Promise<T> ;
+
+    Task() noexcept = default ;
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy() ;
+            }
+            handle_ = std::exchange(other.handle_, {}) ;
+        }
+        return *this ;
+    }
+
+    ~Task() {
+        if (handle_) {
+            handle_.destroy() ;
+        }
+    }
+
+    [[nodiscard]] bool valid() const noexcept { return static_cast<bool>(handle_) ; }
+
+    auto operator co_await() const noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle ;
+
+            bool await_ready() const noexcept { return handle.done() ; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) const noexcept {
+                handle.promise().continuation = awaiting ;
+                return handle ;
+            }
+            T await_resume() const { return handle.promise().result() ; }
+        } ;
+        return Awaiter{handle_} ;
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_ ;
+} ;
+
+namespace detail {
+
+template<typename T>
+Task<T> Promise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this)) ;
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this)) ;
+}
+
+// Eagerly started, self-destroying root of a spawned task
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() const noexcept { return {} ; }
+        std::suspend_never initial_suspend() const noexcept { return {} ; }
+        std::suspend_never final_suspend() const noexcept { return {} ; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate() ; }   // `done` threw
+
+        static void* operator new(size_t size) { return FrameCache::allocate(size) ; }
+        static void operator delete(void* frame) noexcept { FrameCache::deallocate(frame) ; }
+    } ;
+} ;
+
+template<typename Done>
+Detached runDetached(Task<void> task, Done done) {
+    std::exception_ptr error ;
+    try {
+        co_await task ;
+    } catch (...) {
+        error = std::current_exception() ;
+    }
+    done(error) ;
+}
+
+template<typename T>
+Task<void> storeResult(Task<T> task, std::optional<T>& out) {
+    out.emplace(co_await task) ;
+}
+
+} // namespace detail
+
+/**
+ * @brief Start `task` now, on this thread, and forget it
+ *
+ * `done(std::exception_ptr)` runs once the task has finished, on the
+ * thread that ran its last part, with the exception it ended with (or
+ * null). It must not throw.
+ */
+template<typename Done>
+void spawn(Task<void> task, Done done) {
+    detail::runDetached(std::move(task), std::move(done)) ;
+}
+
+/**
+ * @brief Run `task` to completion, blocking this thread
+ *
+ * The task resumes on this thread after each wait: a local executor is
+ * current while it runs, so whatever it awaits hands it back here. For
+ * plain code that calls coroutine code (a synchronous middleware in
+ * front of an async handler, a test); the thread is busy the whole time.
+ */
+template<typename T>
+T syncWait(Task<T> task) {
+    struct LocalExecutor final : Executor {
+        std::mutex mutex ;
+        std::condition_variable wake ;
+        std::deque<std::coroutine_handle<>> ready ;
+        bool done = false ;
+
+        void post(std::coroutine_handle<> handle) override {
+            std::lock_guard<std::mutex> lock(mutex) ;
+            ready.push_back(handle) ;
+            wake.notify_one() ;
+        }
+    } local ;
+
+    std::exception_ptr error ;
+    std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> result ;
+
+    Task<void> root ;
+    if constexpr (std::is_void_v<T>) {
+        root = std::move(task) ;
+    } else {
+        root = detail::storeResult(std::move(task), result) ;
+    }
+
+    {
+        ExecutorScope scope(&local) ;
+        spawn(std::move(root), [&local, &error](std::exception_ptr e) {
+            error = e ;
+            std::lock_guard<std::mutex> lock(local.mutex) ;
+            local.done = true ;
+            local.wake.notify_one() ;
+        }) ;
+
+        std::unique_lock<std::mutex> lock(local.mutex) ;
+        while (true) {
+            local.wake.wait(lock, [&local] { return local.done || !local.ready.empty() ; }) ;
+            if (local.ready.empty()) {
+                break ;
+            }
+            auto handle = local.ready.front() ;
+            local.ready.pop_front() ;
+            lock.unlock() ;
+            handle.resume() ;
+            lock.lock() ;
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error) ;
+    }
+    if constexpr (!std::is_void_v<T>) {
+        return std::move(*result) ;
+    }
+}
+
+} // namespace frqs::coro
@@ -0,0 +1,89 @@
+#pragma once
+
+/**
+ * @file utils/cpu_dispatch.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Runtime choice between scalar, SSE2, AVX2 and NEON kernels
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * Defines FRQS_SIMD_X86 / FRQS_SIMD_AVX2 / FRQS_SIMD_NEON for the target
+ * (with the intrinsics headers), so kernels are compiled only where they
+ * can run. AVX2 kernels are compiled per function
+ * (`__attribute__((target("avx2")))`) and only picked after a CPU check.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <cstdint>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define FRQS_SIMD_X86 1
+    #include <immintrin.h>
+    #if defined(__GNUC__) || defined(__clang__)
+        #define FRQS_SIMD_AVX2 1
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define FRQS_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace frqs::utils {
+
+enum class SimdLevel : uint8_t {
+    Scalar,
+    Sse2,       // Baseline on x86-64
+    Avx2,
+    Neon        // Baseline on AArch64
+} ;
+
+// Best level this CPU runs, detected once
+[[nodiscard]] SimdLevel simdLevel() noexcept ;
+
+/**
+ * @brief One kernel per level; the ones not compiled for the target stay null
+ *
+ * @example
+ * ```cpp
+ * static const auto backend = selectKernel<ScanFn>({
+ *     .scalar = &scanScalar,
+ * #ifdef FRQS_SIMD_X86
+ *     .sse2 = &scanSse2,
+ * #endif
+ * }) ;
+ * backend.fn(data, size) ;
+ * ```
+ */
+template<typename Fn>
+struct SimdKernels {
+    Fn scalar = nullptr ;
+    Fn sse2 = nullptr ;
+    Fn avx2 = nullptr ;
+    Fn neon = nullptr ;
+} ;
+
+template<typename Fn>
+struct SimdKernel {
+    Fn fn ;
+    std::string_view name ;     // "avx2", "sse2", "neon" or "scalar"
+} ;
+
+// The widest kernel the CPU runs, falling back level by level
+template<typename Fn>
+[[nodiscard]] SimdKernel<Fn> selectKernel(const SimdKernels<Fn>& kernels) noexcept {
+    auto level = simdLevel() ;
+    if (level == SimdLevel::Avx2 && kernels.avx2) {
+        return {kernels.avx2, "avx2"} ;
+    }
+    if ((level == SimdLevel::Avx2 || level == SimdLevel::Sse2) && kernels.sse2) {
+        return {kernels.sse2, "sse2"} ;
+    }
+    if (level == SimdLevel::Neon && kernels.neon) {
+        return {kernels.neon, "neon"} ;
+    }
+    return {kernels.scalar, "scalar"} ;
+}
+
+} // namespace frqs::utils
@@ -11,12 +11,98 @@
  * 
  */
 
+#include <cstdint>
 #include <filesystem>
 #include <optional>
 #include <string>
+#include <string_view>
 
 namespace frqs::utils {
 
+/**
+ * @brief Owned OS file handle
+ * 
+ * Used for file-backed response bodies: the server hands native_handle()
+ * to sendfile()/TransmitFile() and never copies the contents into memory.
+ * create() opens a file for writing instead (streamed uploads).
+ */
+class FileHandle {
+public:
+#ifdef _WIN32
+    using native_t = void* ;  // HANDLE
+#else
+    using native_t = int ;
+#endif
+    
+    // Open for reading; nullopt if the file cannot be opened
+    [[nodiscard]] static std::optional<FileHandle> open(const std::filesystem::path& path) ;
+    
+    // Create (or truncate) for writing; nullopt if the file cannot be created
+    [[nodiscard]] static std::optional<FileHandle> create(const std::filesystem::path& path) ;
+    
+    FileHandle() = default ;
+    ~FileHandle() ;
+    
+    FileHandle(const FileHandle&) = delete ;
+    FileHandle& operator=(const FileHandle&) = delete ;
+    
+    FileHandle(FileHandle&& other) noexcept ;
+    FileHandle& operator=(FileHandle&& other) noexcept ;
+    
+    [[nodiscard]] bool valid() const noexcept { return handle_ != invalid_handle() ; }
+    [[nodiscard]] native_t native_handle() const noexcept { return handle_ ; }
+    
+    // Size at open time, plus bytes written through writeAll()
+    [[nodiscard]] uint64_t size() const noexcept { return size_ ; }
+    
+    // Positional read (no shared file offset); returns bytes read, 0 at EOF
+    [[nodiscard]] std::optional<size_t> readAt(uint64_t offset, void* buffer, size_t size) const noexcept ;
+    
+    // Append at the file offset until everything is written; false on error
+    [[nodiscard]] bool writeAll(const void* data, size_t size) noexcept ;
+    
+    void close() noexcept ;
+
+private:
+    [[nodiscard]] static native_t invalid_handle() noexcept ;
+    
+    native_t handle_ = invalid_handle() ;
+    uint64_t size_ = 0 ;
+} ;
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ * 
+ * The pages are shared with the page cache, so bytes() can be handed to a
+ * socket write without copying them first. The file must not be truncated
+ * while mapped: replace it with a rename instead.
+ */
+class MappedFile {
+public:
+    // Map for reading; nullopt if the file cannot be opened or mapped
+    [[nodiscard]] static std::optional<MappedFile> open(const std::filesystem::path& path) ;
+    
+    MappedFile() = default ;
+    ~MappedFile() ;
+    
+    MappedFile(const MappedFile&) = delete ;
+    MappedFile& operator=(const MappedFile&) = delete ;
+    
+    MappedFile(MappedFile&& other) noexcept ;
+    MappedFile& operator=(MappedFile&& other) noexcept ;
+    
+    [[nodiscard]] std::string_view bytes() const noexcept {
+        return {static_cast<const char*>(data_), size_} ;
+    }
+    [[nodiscard]] size_t size() const noexcept { return size_ ; }
+    
+    void close() noexcept ;
+
+private:
+    const void* data_ = nullptr ;
+    size_t size_ = 0 ;
+} ;
+
 class FileSystemUtils {
 public:
     // Securely resolve a path relative to a root directory
@@ -0,0 +1,49 @@
+#pragma once
+
+/**
+ * @file utils/input_buffer.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Receive space at the end of a protocol parser's input string
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+
+namespace frqs::utils {
+
+/**
+ * @brief Writable space of at least min_size bytes after `buffer[start, size)`
+ *
+ * The unparsed bytes `[start, size)` move to the front only when the
+ * space behind them is too small, and the buffer at least doubles when it
+ * grows. A drained buffer larger than max_idle is freed (after a big
+ * message) instead of being kept for the next one.
+ */
+[[nodiscard]] inline std::span<char> prepareInput(std::string& buffer, size_t& start, size_t& size,
+                                                  size_t min_size, size_t max_idle = SIZE_MAX) {
+    if (start == size) {
+        start = size = 0 ;
+        if (buffer.size() > max_idle) {
+            std::string().swap(buffer) ;
+        }
+    } else if (start > 0 && buffer.size() - size < min_size) {
+        std::memmove(buffer.data(), buffer.data() + start, size - start) ;
+        size -= start ;
+        start = 0 ;
+    }
+    if (buffer.size() - size < min_size) {
+        buffer.resize(size + std::max(min_size, size)) ;
+    }
+    return {buffer.data() + size, buffer.size() - size} ;
+}
+
+} // namespace frqs::utils
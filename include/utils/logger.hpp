@@ -3,10 +3,15 @@
 /**
  * @file utils/logger.hpp
  * @author zuudevs (zuudevs@gmail.com)
- * @brief 
- * @version 1.0.0
+ * @brief Asynchronous logger
+ * @version 1.1.0
  * @date 2025-12-08
  * 
+ * Logging threads copy the message into a per-thread lock-free ring; a
+ * background thread timestamps, formats and writes the entries in batches.
+ * Level filtering happens before any formatting: the format-string
+ * overloads of logInfo() & co. cost one relaxed load when filtered out.
+ * 
  * @copyright Copyright (c) 2025
  * 
  */
@@ -15,6 +20,7 @@
 	#undef ERROR
 #endif
 
+#include <atomic>
 #include <cstdint>
 #include <format>
 #include <string>
@@ -25,7 +31,31 @@ namespace frqs::utils {
 
 enum class Level : uint8_t {INFO, WARN, ERROR} ;
 
-[[nodiscard]] inline std::string CreateLog(Level level, std::string_view msg) noexcept {
+// What a logging thread does when its ring is full
+enum class OverflowPolicy : uint8_t {
+    Drop,   // Discard the entry (counted and reported by the writer thread)
+    Block   // Wait for the writer thread to make room
+} ;
+
+struct LogOptions {
+    /// Entries below this level are discarded before formatting
+    Level min_level = Level::INFO ;
+    
+    /// false: write synchronously on the calling thread (old behaviour)
+    bool async = true ;
+    
+    /// Ring capacity per logging thread (applies to rings created afterwards)
+    size_t buffer_entries = 1024 ;
+    
+    /// Longest time an entry waits in a ring before it is written and flushed
+    std::chrono::milliseconds flush_interval{100} ;
+    
+    OverflowPolicy overflow = OverflowPolicy::Drop ;
+} ;
+
+[[nodiscard]] inline std::string CreateLog(Level level, std::string_view msg,
+                                           std::chrono::system_clock::time_point now = 
+                                               std::chrono::system_clock::now()) noexcept {
     std::string_view level_str ;
     switch (level) {
         using enum Level ;
@@ -34,16 +64,55 @@ enum class Level : uint8_t {INFO, WARN, ERROR} ;
         case ERROR: level_str = "ERROR" ; break ;
     }
 
-    auto now = std::chrono::system_clock::now() ;
     auto local_time = std::chrono::zoned_time{std::chrono::current_zone(), now} ;
 
     return std::format("[{:%F %T}] [{:<5}] {}", local_time, level_str, msg) ;
 }
 
+namespace detail {
+    inline std::atomic<uint8_t> min_log_level{static_cast<uint8_t>(Level::INFO)} ;
+}
+
+[[nodiscard]] inline bool logEnabled(Level level) noexcept {
+    return static_cast<uint8_t>(level) >= detail::min_log_level.load(std::memory_order_relaxed) ;
+}
+
 // Helper functions for logging
+void logMessage(Level level, std::string_view message) ;
 void logInfo(std::string_view message) ;
 void logWarn(std::string_view message) ;
 void logError(std::string_view message) ;
 void enableFileLogging(const std::string& filename) ;
 
-} // namespace frqs::utils
\ No newline at end of file
+// Apply options (restarts nothing: the writer thread picks them up)
+void configureLogging(const LogOptions& options) ;
+
+// Block until every entry logged so far has been written and flushed
+void flushLogs() ;
+
+// Format only when the level is enabled: logInfo("{} {}", method, path)
+template<typename... Args>
+    requires (sizeof...(Args) > 0)
+void logInfo(std::format_string<Args...> fmt, Args&&... args) {
+    if (logEnabled(Level::INFO)) {
+        logMessage(Level::INFO, std::format(fmt, std::forward<Args>(args)...)) ;
+    }
+}
+
+template<typename... Args>
+    requires (sizeof...(Args) > 0)
+void logWarn(std::format_string<Args...> fmt, Args&&... args) {
+    if (logEnabled(Level::WARN)) {
+        logMessage(Level::WARN, std::format(fmt, std::forward<Args>(args)...)) ;
+    }
+}
+
+template<typename... Args>
+    requires (sizeof...(Args) > 0)
+void logError(std::format_string<Args...> fmt, Args&&... args) {
+    if (logEnabled(Level::ERROR)) {
+        logMessage(Level::ERROR, std::format(fmt, std::forward<Args>(args)...)) ;
+    }
+}
+
+} // namespace frqs::utils
@@ -0,0 +1,139 @@
+#pragma once
+
+/**
+ * @file utils/lru_cache.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Thread-safe, byte-bounded LRU cache with string keys
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace frqs::utils {
+
+/**
+ * @brief LRU map from string keys to shared immutable values
+ *
+ * Each entry is inserted with a caller-supplied cost (usually its size in
+ * bytes); least recently used entries are evicted once the total exceeds
+ * the budget. Values are handed out as shared_ptr, so an evicted value
+ * stays alive for requests still using it.
+ *
+ * @example
+ * ```cpp
+ * LruCache<std::string> cache(16 * 1024 * 1024);
+ * cache.insert("key", std::make_shared<const std::string>(data), data.size());
+ * if (auto hit = cache.find("key")) { ... }
+ * ```
+ */
+template<typename V>
+class LruCache {
+public:
+    explicit LruCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+    
+    LruCache(const LruCache&) = delete ;
+    LruCache& operator=(const LruCache&) = delete ;
+    
+    [[nodiscard]] bool enabled() const noexcept { return max_bytes_ > 0 ; }
+    [[nodiscard]] size_t maxBytes() const noexcept { return max_bytes_ ; }
+    
+    // Value for `key` (marked most recently used), or nullptr
+    [[nodiscard]] std::shared_ptr<const V> find(std::string_view key) {
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        auto it = index_.find(key) ;
+        if (it == index_.end()) {
+            return nullptr ;
+        }
+        lru_.splice(lru_.begin(), lru_, it->second) ;
+        return it->second->value ;
+    }
+    
+    // Insert or replace; values costing more than the whole budget are dropped
+    void insert(std::string key, std::shared_ptr<const V> value, size_t cost) {
+        cost += key.size() + ENTRY_OVERHEAD ;
+        if (cost > max_bytes_) {
+            return ;
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        
+        if (auto it = index_.find(key); it != index_.end()) {
+            removeLocked(it) ;
+        }
+        
+        lru_.push_front(Entry{std::move(key), std::move(value), cost}) ;
+        index_.emplace(lru_.front().key, lru_.begin()) ;
+        used_bytes_ += cost ;
+        
+        while (used_bytes_ > max_bytes_ && !lru_.empty()) {
+            removeLocked(index_.find(lru_.back().key)) ;
+        }
+    }
+    
+    // Drop `key`; if `expected` is set, only while it is still the cached value
+    void erase(std::string_view key, const V* expected = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        auto it = index_.find(key) ;
+        if (it != index_.end() && (!expected || it->second->value.get() == expected)) {
+            removeLocked(it) ;
+        }
+    }
+    
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        index_.clear() ;
+        lru_.clear() ;
+        used_bytes_ = 0 ;
+    }
+    
+    [[nodiscard]] size_t usedBytes() const {
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        return used_bytes_ ;
+    }
+    
+    [[nodiscard]] size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        return index_.size() ;
+    }
+
+private:
+    // Rough per-entry bookkeeping (list node, hash node, key header)
+    static constexpr size_t ENTRY_OVERHEAD = 128 ;
+    
+    struct Entry {
+        std::string key ;
+        std::shared_ptr<const V> value ;
+        size_t cost ;
+    } ;
+    
+    // Index keys are views into the list entries, which never move
+    using LruList = std::list<Entry> ;
+    using Index = std::unordered_map<std::string_view, typename LruList::iterator> ;
+    
+    void removeLocked(typename Index::iterator it) {
+        auto entry = it->second ;
+        used_bytes_ -= entry->cost ;
+        index_.erase(it) ;
+        lru_.erase(entry) ;
+    }
+    
+    size_t max_bytes_ ;
+    
+    mutable std::mutex mutex_ ;
+    LruList lru_ ;
+    Index index_ ;
+    size_t used_bytes_ = 0 ;
+} ;
+
+} // namespace frqs::utils
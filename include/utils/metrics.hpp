@@ -0,0 +1,136 @@
+#pragma once
+
+/**
+ * @file utils/metrics.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Sharded counters and log-linear latency histograms
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * Recording is a relaxed atomic add on a cache line owned (mostly) by the
+ * calling thread; reading sums the shards. Both types render themselves in
+ * the Prometheus text exposition format.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace frqs::utils {
+
+namespace detail {
+    inline constexpr size_t METRIC_SHARDS = 16 ;
+    
+    // Stable per-thread shard, assigned round-robin on first use
+    [[nodiscard]] size_t metricShard() noexcept ;
+}
+
+/**
+ * @brief Monotonic counter split over per-thread cache lines
+ *
+ * Threads adding concurrently touch different lines, so increments do
+ * not bounce one line between cores the way a single atomic does.
+ */
+class Counter {
+public:
+    void add(uint64_t n = 1) noexcept {
+        shards_[detail::metricShard()].value.fetch_add(n, std::memory_order_relaxed) ;
+    }
+    
+    [[nodiscard]] uint64_t value() const noexcept {
+        uint64_t total = 0 ;
+        for (const auto& shard : shards_) {
+            total += shard.value.load(std::memory_order_relaxed) ;
+        }
+        return total ;
+    }
+    
+    // HELP/TYPE header followed by the single sample
+    void writePrometheus(std::string& out, std::string_view name, std::string_view help) const ;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0} ;
+    } ;
+    
+    std::array<Shard, detail::METRIC_SHARDS> shards_ ;
+} ;
+
+/**
+ * @brief HDR-style histogram of durations in microseconds
+ *
+ * Buckets are log-linear: every power of two is split into eight equal
+ * sub-buckets, so any recorded value is known to within 12.5% from 1us to
+ * hours while the whole histogram stays a fixed array of counters per
+ * thread shard. Scrapes and percentile() sum the shards.
+ */
+class Histogram {
+public:
+    static constexpr unsigned SUB_BITS = 3 ;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BITS ;
+    static constexpr size_t BUCKETS = SUB_BUCKETS + (64 - SUB_BITS) * SUB_BUCKETS ;
+    
+    void record(uint64_t micros) noexcept {
+        auto& shard = shards_[detail::metricShard()] ;
+        shard.buckets[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed) ;
+        shard.sum.fetch_add(micros, std::memory_order_relaxed) ;
+    }
+    
+    [[nodiscard]] uint64_t count() const noexcept ;
+    [[nodiscard]] uint64_t sumMicros() const noexcept ;
+    
+    // Upper bound (microseconds) of the bucket holding quantile q in [0, 1]
+    [[nodiscard]] uint64_t percentile(double q) const noexcept ;
+    
+    /**
+     * @brief Append `name_bucket{labels,le=...}`, `_sum` and `_count` series
+     *
+     * Exported in seconds on a fixed set of `le` bounds so the series stay
+     * stable between scrapes. The caller writes the HELP/TYPE header once
+     * per metric family; `labels` is e.g. `route="/api",method="GET"`.
+     */
+    void writePrometheus(std::string& out, std::string_view name, std::string_view labels) const ;
+    
+    [[nodiscard]] static constexpr size_t bucketIndex(uint64_t v) noexcept {
+        if (v < SUB_BUCKETS) {
+            return static_cast<size_t>(v) ;
+        }
+        unsigned exponent = static_cast<unsigned>(std::bit_width(v)) - 1 ;
+        unsigned shift = exponent - SUB_BITS ;
+        size_t sub = static_cast<size_t>(v >> shift) & (SUB_BUCKETS - 1) ;
+        return SUB_BUCKETS + shift * SUB_BUCKETS + sub ;
+    }
+    
+    // Largest value that lands in bucket `index`
+    [[nodiscard]] static constexpr uint64_t bucketMax(size_t index) noexcept {
+        if (index < SUB_BUCKETS) {
+            return index ;
+        }
+        size_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS ;
+        uint64_t sub = (index - SUB_BUCKETS) % SUB_BUCKETS ;
+        uint64_t lowest = (SUB_BUCKETS + sub) << shift ;
+        return lowest + ((uint64_t(1) << shift) - 1) ;
+    }
+
+private:
+    // Buckets and sum per thread shard, like Counter: recording threads
+    // write their own lines. About 4 KiB a shard, 64 KiB a histogram.
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, BUCKETS> buckets{} ;
+        std::atomic<uint64_t> sum{0} ;
+    } ;
+    
+    std::array<Shard, detail::METRIC_SHARDS> shards_ ;
+    
+    // Bucket counts summed over the shards; returns their total
+    uint64_t collect(std::array<uint64_t, BUCKETS>& counts) const noexcept ;
+} ;
+
+} // namespace frqs::utils
@@ -0,0 +1,122 @@
+#pragma once
+
+/**
+ * @file utils/mpmc_queue.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Bounded lock-free multi-producer / multi-consumer queue
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace frqs::utils {
+
+/**
+ * @brief Dmitry Vyukov's bounded MPMC ring
+ *
+ * Every cell carries a sequence number that tells producers and consumers
+ * whose turn it is, so push and pop are a single CAS on the shared index
+ * in the uncontended case. Capacity is rounded up to a power of two.
+ */
+template<typename T>
+class MpmcQueue {
+public:
+    explicit MpmcQueue(size_t capacity) {
+        size_t size = 2 ;
+        while (size < capacity) {
+            size <<= 1 ;
+        }
+        mask_ = size - 1 ;
+        cells_ = std::make_unique<Cell[]>(size) ;
+        for (size_t i = 0 ; i < size ; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed) ;
+        }
+    }
+    
+    ~MpmcQueue() {
+        while (tryPop()) {}
+    }
+    
+    MpmcQueue(const MpmcQueue&) = delete ;
+    MpmcQueue& operator=(const MpmcQueue&) = delete ;
+    
+    // False if the queue is full; `value` is left untouched in that case
+    [[nodiscard]] bool tryPush(T& value) {
+        size_t pos = tail_.load(std::memory_order_relaxed) ;
+        while (true) {
+            Cell& cell = cells_[pos & mask_] ;
+            size_t seq = cell.sequence.load(std::memory_order_acquire) ;
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos) ;
+            
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    ::new (static_cast<void*>(cell.storage)) T(std::move(value)) ;
+                    cell.sequence.store(pos + 1, std::memory_order_release) ;
+                    return true ;
+                }
+            } else if (diff < 0) {
+                return false ;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed) ;
+            }
+        }
+    }
+    
+    [[nodiscard]] std::optional<T> tryPop() {
+        size_t pos = head_.load(std::memory_order_relaxed) ;
+        while (true) {
+            Cell& cell = cells_[pos & mask_] ;
+            size_t seq = cell.sequence.load(std::memory_order_acquire) ;
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1) ;
+            
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    T* slot = std::launder(reinterpret_cast<T*>(cell.storage)) ;
+                    std::optional<T> value(std::move(*slot)) ;
+                    slot->~T() ;
+                    cell.sequence.store(pos + mask_ + 1, std::memory_order_release) ;
+                    return value ;
+                }
+            } else if (diff < 0) {
+                return std::nullopt ;
+            } else {
+                pos = head_.load(std::memory_order_relaxed) ;
+            }
+        }
+    }
+    
+    // Approximate; exact only while no push/pop is in flight
+    [[nodiscard]] size_t sizeApprox() const noexcept {
+        size_t tail = tail_.load(std::memory_order_relaxed) ;
+        size_t head = head_.load(std::memory_order_relaxed) ;
+        return tail >= head ? tail - head : 0 ;
+    }
+    
+    [[nodiscard]] size_t capacity() const noexcept { return mask_ + 1 ; }
+
+private:
+    static constexpr size_t CACHE_LINE = 64 ;
+    
+    struct Cell {
+        std::atomic<size_t> sequence ;
+        alignas(T) unsigned char storage[sizeof(T)] ;
+    } ;
+    
+    std::unique_ptr<Cell[]> cells_ ;
+    size_t mask_ = 0 ;
+    
+    // Producers and consumers on separate cache lines
+    alignas(CACHE_LINE) std::atomic<size_t> tail_{0} ;
+    alignas(CACHE_LINE) std::atomic<size_t> head_{0} ;
+} ;
+
+} // namespace frqs::utils
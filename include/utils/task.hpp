@@ -0,0 +1,121 @@
+#pragma once
+
+/**
+ * @file utils/task.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Move-only `void()` callable with small-buffer storage
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace frqs::utils {
+
+/**
+ * @brief Type-erased, move-only replacement for std::function<void()>
+ *
+ * Callables up to INLINE_SIZE bytes (e.g. a lambda capturing a socket and
+ * a pointer) live inside the Task itself, so posting them to the thread
+ * pool does not allocate. Unlike std::function the callable does not have
+ * to be copyable.
+ */
+class Task {
+public:
+    static constexpr size_t INLINE_SIZE = 48 ;   // Task is one cache line
+    
+    Task() noexcept = default ;
+    
+    template<typename F,
+             typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+    Task(F&& f) {   // Implicit, like std::function
+        using Fn = std::decay_t<F> ;
+        if constexpr (fitsInline<Fn>()) {
+            ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(f)) ;
+            ops_ = &InlineOps<Fn>::table ;
+        } else {
+            ::new (static_cast<void*>(storage_)) Fn*(new Fn(std::forward<F>(f))) ;
+            ops_ = &HeapOps<Fn>::table ;
+        }
+    }
+    
+    Task(Task&& other) noexcept : ops_(std::exchange(other.ops_, nullptr)) {
+        if (ops_) {
+            ops_->move(storage_, other.storage_) ;
+        }
+    }
+    
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset() ;
+            ops_ = std::exchange(other.ops_, nullptr) ;
+            if (ops_) {
+                ops_->move(storage_, other.storage_) ;
+            }
+        }
+        return *this ;
+    }
+    
+    Task(const Task&) = delete ;
+    Task& operator=(const Task&) = delete ;
+    
+    ~Task() { reset() ; }
+    
+    void operator()() { ops_->invoke(storage_) ; }
+    
+    [[nodiscard]] explicit operator bool() const noexcept { return ops_ != nullptr ; }
+    
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(storage_) ;
+            ops_ = nullptr ;
+        }
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void* self) ;
+        void (*move)(void* dst, void* src) noexcept ;   // Move-construct dst, destroy src
+        void (*destroy)(void* self) noexcept ;
+    } ;
+    
+    template<typename Fn>
+    static constexpr bool fitsInline() {
+        return sizeof(Fn) <= INLINE_SIZE &&
+               alignof(Fn) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<Fn> ;
+    }
+    
+    template<typename Fn>
+    struct InlineOps {
+        static void invoke(void* self) { (*std::launder(static_cast<Fn*>(self)))() ; }
+        static void move(void* dst, void* src) noexcept {
+            auto* from = std::launder(static_cast<Fn*>(src)) ;
+            ::new (dst) Fn(std::move(*from)) ;
+            from->~Fn() ;
+        }
+        static void destroy(void* self) noexcept { std::launder(static_cast<Fn*>(self))->~Fn() ; }
+        static constexpr Ops table{&invoke, &move, &destroy} ;
+    } ;
+    
+    template<typename Fn>
+    struct HeapOps {
+        static Fn*& ptr(void* self) { return *std::launder(static_cast<Fn**>(self)) ; }
+        static void invoke(void* self) { (*ptr(self))() ; }
+        static void move(void* dst, void* src) noexcept { ::new (dst) Fn*(ptr(src)) ; }
+        static void destroy(void* self) noexcept { delete ptr(self) ; }
+        static constexpr Ops table{&invoke, &move, &destroy} ;
+    } ;
+    
+    alignas(std::max_align_t) unsigned char storage_[INLINE_SIZE] ;
+    const Ops* ops_ = nullptr ;
+} ;
+
+} // namespace frqs::utils
@@ -3,29 +3,53 @@
 /**
  * @file utils/thread_pool.hpp
  * @author zuudevs (zuudevs@gmail.com)
- * @brief 
- * @version 1.0.0
+ * @brief Work-stealing thread pool
+ * @version 1.1.0
  * @date 2025-12-08
  * 
  * @copyright Copyright (c) 2025
  * 
  */
 
-#include <vector>
-#include <queue>
-#include <thread>
-#include <mutex>
+#include "utils/mpmc_queue.hpp"
+#include "utils/task.hpp"
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 namespace frqs::utils {
 
+/**
+ * @brief Resizable pool with one lock-free queue per worker
+ * 
+ * Tasks posted from outside the pool are spread round-robin over the
+ * worker queues; tasks posted by a worker go to its own queue. An idle
+ * worker drains its own queue first and then steals from the others, so
+ * no single lock is shared by every submit. Workers park on a condition
+ * variable only after finding every queue empty.
+ * 
+ * Worker slots (queues) are allocated up front, up to capacity(); resize()
+ * starts or retires workers within them. A retired worker finishes the
+ * tasks in its own queue before it exits.
+ */
 class ThreadPool {
 public:
-    explicit ThreadPool(size_t num_threads = std::thread::hardware_concurrency()) ;
+    /**
+     * @param num_threads Worker count (0 is treated as 1)
+     * @param pin_threads Pin worker i to CPU i (mod core count) where supported
+     * @param max_threads Largest size resize() may grow to (0 = the larger
+     *                    of num_threads and the core count)
+     */
+    explicit ThreadPool(size_t num_threads = std::thread::hardware_concurrency(),
+                        bool pin_threads = false, size_t max_threads = 0) ;
     ~ThreadPool() ;
     
     // Delete copy and move operations
@@ -34,25 +58,64 @@ public:
     ThreadPool(ThreadPool&&) = delete ;
     ThreadPool& operator=(ThreadPool&&) = delete ;
     
-    // Submit a task to the pool
+    // Fire-and-forget: no future, no allocation for small callables
+    void post(Task task) ;
+    
+    // Submit a task to the pool and get its result through a future
     template<typename F, typename... Args>
     auto submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> ;
     
     // Get the number of threads
-    [[nodiscard]] size_t size() const noexcept { return workers_.size() ; }
+    [[nodiscard]] size_t size() const noexcept { return active_.load(std::memory_order_relaxed) ; }
+    [[nodiscard]] size_t capacity() const noexcept { return workers_.size() ; }
+    
+    // Start or retire workers; clamped to [1, capacity()]. Returns the new size.
+    size_t resize(size_t num_threads) ;
     
     // Get the number of pending tasks
     [[nodiscard]] size_t pendingTasks() const noexcept ;
+    
+    // Pin the calling thread to `cpu` (mod core count); no-op where unsupported
+    static void pinCurrentThread(size_t cpu) noexcept ;
 
 private:
-    std::vector<std::thread> workers_ ;
-    std::queue<std::function<void()>> tasks_ ;
+    // Per-worker queue depth before posts spill into the shared overflow list
+    static constexpr size_t QUEUE_CAPACITY = 1024 ;
+    
+    // Empty polls of every queue before a worker parks
+    static constexpr int SPIN_LIMIT = 64 ;
+    
+    enum class WorkerState : uint8_t { Stopped, Running, Retiring } ;
+    
+    struct Worker {
+        MpmcQueue<Task> queue{QUEUE_CAPACITY} ;
+        std::thread thread ;
+        std::atomic<WorkerState> state{WorkerState::Stopped} ;
+    } ;
     
-    mutable std::mutex queue_mutex_ ;
+    // Never reallocated, so workers steal without synchronizing with resize()
+    std::vector<std::unique_ptr<Worker>> workers_ ;
+    std::atomic<size_t> active_{0} ;
+    bool pin_threads_ ;
+    std::mutex resize_mutex_ ;
+    
+    // Only used when a worker queue is full
+    std::mutex overflow_mutex_ ;
+    std::deque<Task> overflow_ ;
+    std::atomic<size_t> overflow_size_{0} ;
+    
+    std::atomic<size_t> pending_{0} ;
+    std::atomic<size_t> next_queue_{0} ;
+    
+    std::mutex sleep_mutex_ ;
     std::condition_variable condition_ ;
-    bool stop_ = false ;
+    std::atomic<size_t> sleepers_{0} ;
+    std::atomic<bool> stop_{false} ;
     
-    void workerThread() ;
+    void startWorker(size_t index) ;
+    void workerThread(size_t index) ;
+    void runTask(Task& task) ;
+    [[nodiscard]] bool takeTask(size_t index, Task& task) ;
 } ;
 
 // Template implementation must be in header
@@ -62,24 +125,14 @@ auto ThreadPool::submit(F&& f, Args&&... args)
     
     using return_type = std::invoke_result_t<F, Args...> ;
     
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
+    // packaged_task is move-only, which Task allows: no shared_ptr wrapper
+    std::packaged_task<return_type()> task(
         std::bind(std::forward<F>(f), std::forward<Args>(args)...)
     ) ;
     
-    std::future<return_type> result = task->get_future() ;
-    
-    {
-        std::lock_guard<std::mutex> lock(queue_mutex_) ;
-        
-        if (stop_) {
-            throw std::runtime_error("ThreadPool is stopped") ;
-        }
-        
-        tasks_.emplace([task]() { (*task)() ; }) ;
-    }
-    
-    condition_.notify_one() ;
+    std::future<return_type> result = task.get_future() ;
+    post(std::move(task)) ;
     return result ;
 }
 
-} // namespace frqs::utils
\ No newline at end of file
+} // namespace frqs::utils
@@ -0,0 +1,174 @@
+#pragma once
+
+/**
+ * @file utils/timer_wheel.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Hierarchical timer wheel for connection and request timeouts
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace frqs::utils {
+
+/**
+ * @brief Timers in slots by expiry, cascaded down levels as time nears
+ *
+ * Four levels of 64 slots: level 0 holds the next 64 ticks one slot per
+ * tick, each level above covers 64 times the span of the one below. A
+ * timer sits in the coarsest level it fits and moves down (cascades)
+ * when its level's slot comes round, so scheduling, cancelling and
+ * rescheduling are O(1) and advancing costs nothing per idle timer.
+ * Timers further out than the wheel spans (64^4 ticks: 4.6 hours at
+ * 1 ms) wait at the far end and are placed again when that comes round.
+ *
+ * Timers are intrusive: the owner embeds a Timer (for example in its
+ * connection) and the wheel links it in; nothing is allocated. A Timer
+ * must be cancelled (or have fired) before it is destroyed.
+ *
+ * Expiry is rounded up to the tick, so a timer never fires early and
+ * fires at most one tick late (plus however late advance() is called).
+ * Not thread-safe: the owner serializes access.
+ *
+ * @example
+ * ```cpp
+ * utils::TimerWheel wheel(std::chrono::milliseconds(10)) ;
+ * wheel.schedule(conn.timer, now + 5s, &conn) ;
+ * // ...
+ * wheel.advance(TimerWheel::clock::now(), [](TimerWheel::Timer& timer) {
+ *     close(static_cast<Connection*>(timer.data)) ;
+ * }) ;
+ * ```
+ */
+class TimerWheel {
+public:
+    using clock = std::chrono::steady_clock ;
+
+    static constexpr size_t LEVELS = 4 ;
+    static constexpr size_t SLOTS = 64 ;
+
+    class Timer {
+    public:
+        Timer() = default ;
+        Timer(const Timer&) = delete ;
+        Timer& operator=(const Timer&) = delete ;
+
+        [[nodiscard]] bool scheduled() const noexcept { return level_ != UNLINKED ; }
+
+        void* data = nullptr ;      // Set by schedule(), for the expiry callback
+
+    private:
+        friend class TimerWheel ;
+
+        Timer* prev_ = nullptr ;
+        Timer* next_ = nullptr ;
+        uint64_t tick_ = 0 ;        // Expiry, in ticks since the wheel started
+        uint8_t level_ = UNLINKED ;
+        uint8_t slot_ = 0 ;
+    } ;
+
+    explicit TimerWheel(clock::duration resolution = std::chrono::milliseconds(1),
+                        clock::time_point start = clock::now()) noexcept ;
+
+    TimerWheel(const TimerWheel&) = delete ;
+    TimerWheel& operator=(const TimerWheel&) = delete ;
+
+    // Arm (or re-arm) timer to fire at the first advance() at or after expires
+    void schedule(Timer& timer, clock::time_point expires, void* data = nullptr) noexcept ;
+
+    // Disarm; does nothing if the timer is not scheduled
+    void cancel(Timer& timer) noexcept ;
+
+    /**
+     * @brief Fire every timer due by now, in expiry order (within a tick, any order)
+     *
+     * Each timer is unlinked before on_expired(Timer&) runs, so the
+     * callback may schedule it again, or schedule and cancel any other
+     * timer, including ones due in this same call.
+     */
+    template<typename F>
+    void advance(clock::time_point now, F&& on_expired) {
+        uint64_t target = tickAt(now) ;
+        while (current_ <= target) {
+            if (count_ == 0) {
+                current_ = target + 1 ;
+                break ;
+            }
+            uint64_t tick = current_ ;
+            if ((tick & SLOT_MASK) == 0) {
+                cascade(tick) ;
+            } else {
+                // Nothing to cascade before the next block: skip to the next timer
+                uint64_t pending = occupied_[0] >> (tick & SLOT_MASK) ;
+                if (pending == 0) {
+                    current_ = std::min((tick | SLOT_MASK) + 1, target + 1) ;
+                    continue ;
+                }
+                tick += static_cast<uint64_t>(std::countr_zero(pending)) ;
+                if (tick > target) {
+                    current_ = target + 1 ;
+                    break ;
+                }
+            }
+            current_ = tick + 1 ;
+            collect(tick) ;
+            while (Timer* timer = expiring_) {
+                unlink(*timer) ;
+                if (timer->tick_ > tick) {
+                    insert(*timer) ;    // Was beyond the wheel's span
+                } else {
+                    on_expired(*timer) ;
+                }
+            }
+        }
+    }
+
+    // When the earliest timer may fire (never later than it will); nullopt if none
+    [[nodiscard]] std::optional<clock::time_point> nextExpiry() const noexcept ;
+
+    // Disarm every timer
+    void clear() noexcept ;
+
+    [[nodiscard]] size_t size() const noexcept { return count_ ; }
+    [[nodiscard]] bool empty() const noexcept { return count_ == 0 ; }
+    [[nodiscard]] clock::duration resolution() const noexcept { return resolution_ ; }
+
+private:
+    static constexpr uint8_t UNLINKED = 0xff ;
+    static constexpr uint8_t EXPIRING = LEVELS ;    // In expiring_, about to fire
+    static constexpr unsigned SLOT_BITS = 6 ;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1 ;
+    static constexpr uint64_t SPAN = uint64_t(1) << (SLOT_BITS * LEVELS) ;
+
+    [[nodiscard]] uint64_t tickAt(clock::time_point time) const noexcept ;
+    [[nodiscard]] uint64_t tickFor(clock::time_point expires) const noexcept ;
+
+    void insert(Timer& timer) noexcept ;
+    void unlink(Timer& timer) noexcept ;
+    void link(Timer*& head, Timer& timer) noexcept ;
+
+    // Move a level's slot for this tick down the wheel
+    void cascade(uint64_t tick) noexcept ;
+    // Move level 0's slot for this tick to expiring_
+    void collect(uint64_t tick) noexcept ;
+
+    clock::duration resolution_ ;
+    clock::time_point start_ ;
+    uint64_t current_ = 0 ;         // Next tick to process
+    size_t count_ = 0 ;
+    std::array<std::array<Timer*, SLOTS>, LEVELS> slots_{} ;
+    std::array<uint64_t, LEVELS> occupied_{} ;     // Bit per non-empty slot
+    Timer* expiring_ = nullptr ;
+} ;
+
+} // namespace frqs::utils
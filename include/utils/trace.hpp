@@ -0,0 +1,89 @@
+#pragma once
+
+/**
+ * @file utils/trace.hpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Sampled request phase traces, exported as Chrome trace JSON
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace frqs::utils {
+
+/**
+ * @brief When each phase of one request ended
+ *
+ * Phases run back to back: connect (accepted to first byte, the first
+ * request of a connection only), read headers, read body and queue, handler,
+ * send (to the last byte written).
+ */
+struct RequestTrace {
+    using time_point = std::chrono::steady_clock::time_point ;
+
+    time_point accepted ;           // first_byte after the first request
+    time_point first_byte ;
+    time_point headers_parsed ;
+    time_point handler_started ;
+    time_point handler_finished ;
+    time_point last_byte ;
+
+    uint64_t connection = 0 ;       // Any key unique among open connections
+    std::string name ;              // "GET /path 200"
+} ;
+
+/**
+ * @brief Keeps the newest sampled traces and renders them for a trace viewer
+ *
+ * sample() is a per-thread countdown, so deciding not to trace costs no
+ * shared write; record() takes a lock, which only sampled requests pay.
+ * The JSON loads in chrome://tracing or ui.perfetto.dev, one row per
+ * connection.
+ *
+ * @example
+ * ```cpp
+ * tracer.configure(100, 4096) ;   // One request in 100
+ * if (tracer.sample()) {
+ *     tracer.record(std::move(trace)) ;
+ * }
+ * std::string json = tracer.renderChromeTrace() ;
+ * ```
+ */
+class RequestTracer {
+public:
+    // Trace one request in sample_every on each thread (0 = off), keeping
+    // the newest `capacity`. Not thread-safe: call before requests run.
+    void configure(uint32_t sample_every, size_t capacity) ;
+
+    [[nodiscard]] bool enabled() const noexcept { return sample_every_ != 0 ; }
+
+    // Whether the calling thread traces the request it is finishing
+    [[nodiscard]] bool sample() noexcept ;
+
+    void record(RequestTrace trace) ;
+
+    // {"traceEvents": [...]}, oldest trace first; times in microseconds
+    [[nodiscard]] std::string renderChromeTrace() const ;
+
+    [[nodiscard]] size_t size() const ;
+
+private:
+    uint32_t sample_every_ = 0 ;
+    size_t capacity_ = 0 ;
+    std::chrono::steady_clock::time_point epoch_ = std::chrono::steady_clock::now() ;
+
+    mutable std::mutex mutex_ ;
+    std::vector<RequestTrace> traces_ ;     // Ring once full
+    size_t next_ = 0 ;                      // Oldest, once full
+} ;
+
+} // namespace frqs::utils
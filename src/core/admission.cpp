@@ -0,0 +1,127 @@
+/**
+ * @file core/admission.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Adaptive concurrency limit and load shedding
+ * @version 1.1.1
+ * @date 2025-12-15
+ * @copyright Copyright (c) 2025
+ */
+
+#include "core/admission.hpp"
+#include <algorithm>
+#include <format>
+
+namespace frqs::core {
+
+namespace {
+
+int64_t steadyNanos() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template<typename T>
+void raiseTo(std::atomic<T>& target, T value) noexcept {
+    T current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+template<typename T>
+void lowerTo(std::atomic<T>& target, T value) noexcept {
+    T current = target.load(std::memory_order_relaxed);
+    while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+} // namespace
+
+void AdmissionController::configure(const AdmissionOptions& options, size_t workers) {
+    workers = std::max<size_t>(workers, 1);
+    
+    enabled_ = options.enabled;
+    max_queue_ = std::max<size_t>(options.max_queue, 1);
+    min_limit_ = options.min_limit > 0 ? options.min_limit : workers;
+    max_limit_ = std::max(options.max_limit > 0 ? options.max_limit : workers + max_queue_, min_limit_);
+    target_ns_ = static_cast<int64_t>(std::max(options.target_queue_ms, 0)) * 1'000'000;
+    backoff_ = std::clamp(options.backoff, 0.1, 1.0);
+    priority_paths_ = options.priority_paths;
+    retry_after_s_ = std::max(options.retry_after_s, 0);
+    
+    constexpr std::string_view body = "Service Unavailable\n";
+    shed_response_ = std::format(
+        "HTTP/1.1 503 Service Unavailable\r\n"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: {}\r\n"
+        "Retry-After: {}\r\n"
+        "Connection: close\r\n"
+        "\r\n{}", body.size(), retry_after_s_, body);
+    
+    // Start open; the first overloaded windows bring the limit down quickly
+    limit_.store(max_limit_, std::memory_order_relaxed);
+    window_start_.store(steadyNanos(), std::memory_order_relaxed);
+}
+
+bool AdmissionController::admit(std::string_view path, std::chrono::nanoseconds queue_delay) noexcept {
+    if (!enabled_) {
+        return true;
+    }
+    if (isPriority(path)) {
+        return true;
+    }
+    record(queue_delay);
+    return in_flight_.load(std::memory_order_relaxed) <= limit_.load(std::memory_order_relaxed);
+}
+
+bool AdmissionController::isPriority(std::string_view path) const noexcept {
+    for (const auto& pattern : priority_paths_) {
+        std::string_view view = pattern;
+        if (view.ends_with('*') ? path.starts_with(view.substr(0, view.size() - 1)) : path == view) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AdmissionController::isPriorityRequest(std::string_view head) const noexcept {
+    // "METHOD SP request-target SP ..."; the query is not part of the path
+    size_t method_end = head.find(' ');
+    if (method_end == std::string_view::npos) {
+        return false;
+    }
+    auto target = head.substr(method_end + 1);
+    size_t target_end = target.find_first_of(" ?");
+    if (target_end == std::string_view::npos) {
+        return false;  // Request line not complete
+    }
+    return isPriority(target.substr(0, target_end));
+}
+
+void AdmissionController::record(std::chrono::nanoseconds queue_delay) noexcept {
+    lowerTo<int64_t>(window_min_delay_, queue_delay.count());
+    raiseTo(window_peak_, in_flight_.load(std::memory_order_relaxed));
+    
+    int64_t now = steadyNanos();
+    int64_t start = window_start_.load(std::memory_order_relaxed);
+    if (now - start < std::chrono::nanoseconds(WINDOW).count()) {
+        return;
+    }
+    // One caller closes the window; the others keep recording into the next
+    if (!window_start_.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+        return;
+    }
+    
+    int64_t min_delay = window_min_delay_.exchange(INT64_MAX, std::memory_order_relaxed);
+    size_t peak = window_peak_.exchange(0, std::memory_order_relaxed);
+    size_t limit = limit_.load(std::memory_order_relaxed);
+    
+    if (min_delay == INT64_MAX) {
+        return;  // No samples
+    }
+    if (min_delay > target_ns_) {
+        limit = std::max(min_limit_, static_cast<size_t>(static_cast<double>(limit) * backoff_));
+    } else if (peak >= limit) {
+        limit = std::min(max_limit_, limit + 1);
+    }
+    limit_.store(limit, std::memory_order_relaxed);
+}
+
+} // namespace frqs::core
@@ -6,91 +6,372 @@
  */
 
 #include "core/router.hpp"
+#include "http/websocket.hpp"
+#include <algorithm>
 #include <format>
+#include <stdexcept>
 
 namespace frqs::core {
 
-void Router::addRoute(http::Method method, std::string_view path, RouteHandler handler) {
+namespace {
+
+struct PatternPart {
+    enum Kind : uint8_t { Static, Param, Wildcard } kind;
+    std::string_view text;      // Static text, or the name without ':' / '*'
+};
+
+// Split a pattern into static runs, :params and a trailing *wildcard
+// /users/:id/files/*path -> "/users/" :id "/files/" *path
+std::vector<PatternPart> splitPattern(std::string_view pattern) {
+    std::vector<PatternPart> parts;
+    size_t params = 0;
+    std::string_view rest = pattern;
+    
+    while (!rest.empty()) {
+        if (rest.front() == ':') {
+            size_t end = rest.find('/');
+            std::string_view name = rest.substr(1, end == std::string_view::npos ? end : end - 1);
+            if (name.empty()) {
+                throw std::runtime_error(std::format("Invalid route pattern '{}': unnamed parameter", pattern));
+            }
+            parts.push_back({PatternPart::Param, name});
+            ++params;
+            rest.remove_prefix(name.size() + 1);
+        
+        } else if (rest.front() == '*') {
+            std::string_view name = rest.substr(1);
+            if (name.find('/') != std::string_view::npos) {
+                throw std::runtime_error(std::format("Invalid route pattern '{}': wildcard must be last", pattern));
+            }
+            parts.push_back({PatternPart::Wildcard, name});
+            ++params;
+            rest = {};
+        
+        } else {
+            size_t end = rest.find_first_of(":*");
+            std::string_view text = rest.substr(0, end);
+            parts.push_back({PatternPart::Static, text});
+            rest.remove_prefix(text.size());
+        }
+    }
+    
+    if (params > Router::MAX_PARAMS) {
+        throw std::runtime_error(std::format("Invalid route pattern '{}': more than {} parameters", 
+                                             pattern, Router::MAX_PARAMS));
+    }
+    return parts;
+}
+
+} // namespace
+
+Router::Node* Router::addRoute(http::Method method, std::string_view path, RouteHandler handler) {
     std::string full_path = prefix_ + std::string(path);
     
-    // Convert path to regex pattern
-    // /users/:id/:action -> ^/users/([^/]+)/([^/]+)$
+    if (root_) {
+        return root_->insert(method, full_path, std::move(handler), nullptr, middlewares_);
+    }
+    return insert(method, full_path, std::move(handler), nullptr, middlewares_);
+}
+
+void Router::addAsyncRoute(http::Method method, std::string_view path, AsyncHandler handler) {
+    std::string full_path = prefix_ + std::string(path);
+    Router& root = root_ ? *root_ : *this;
+    root.insert(method, full_path, nullptr, std::move(handler), middlewares_);
+}
+
+Router::Node* Router::insert(http::Method method, std::string_view pattern, RouteHandler handler,
+                    AsyncHandler async_handler, const std::vector<PipelineStage>& middlewares) {
+    if (method == http::Method::UNKNOWN) {
+        throw std::runtime_error(std::format("Invalid method for route '{}'", pattern));
+    }
+    
+    // Checked whole before the tree changes, so a rejected pattern leaves
+    // no nodes (or split edges) behind
+    auto parts = splitPattern(pattern);
+    
+    auto& tree = trees_[static_cast<size_t>(method)];
+    if (!tree) {
+        tree = std::make_unique<Node>();
+    }
+    
     std::vector<std::string> param_names;
-    std::string pattern_str = "^";
-    
-    size_t pos = 0;
-    while (pos < full_path.size()) {
-        if (full_path[pos] == ':') {
-            // Found parameter
-            size_t end = full_path.find('/', pos);
-            if (end == std::string::npos) end = full_path.size();
-            
-            std::string param_name = full_path.substr(pos + 1, end - pos - 1);
-            param_names.push_back(param_name);
-            
-            pattern_str += "([^/]+)";
-            pos = end;
+    Node* node = tree.get();
+    for (const auto& part : parts) {
+        switch (part.kind) {
+            case PatternPart::Static:
+                node = insertStatic(node, part.text);
+                break;
+            case PatternPart::Param:
+                if (!node->param) {
+                    node->param = std::make_unique<Node>();
+                }
+                node = node->param.get();
+                param_names.emplace_back(part.text);
+                break;
+            case PatternPart::Wildcard:
+                if (!node->wildcard) {
+                    node->wildcard = std::make_unique<Node>();
+                }
+                node = node->wildcard.get();
+                param_names.emplace_back(part.text.empty() ? "*" : part.text);
+                break;
+        }
+    }
+    
+    if (node->terminal()) {
+        throw std::runtime_error(std::format("Route already registered: {} {}", 
+                                             http::methodToString(method), pattern));
+    }
+    
+    node->handler = std::move(handler);
+    node->async_handler = std::move(async_handler);
+    if (!middlewares.empty()) {
+        // Nodes never move once created (edge splits move the unique_ptr)
+        if (node->async_handler) {
+            node->pipeline = std::make_unique<Pipeline>(middlewares, 
+                AsyncHandler([node](Context& ctx) { return node->async_handler(ctx); }));
         } else {
-            // Regular character - escape special regex chars
-            char c = full_path[pos];
-            if (c == '.' || c == '+' || c == '*' || c == '?' || 
-                c == '^' || c == '$' || c == '(' || c == ')' ||
-                c == '[' || c == ']' || c == '{' || c == '}' || c == '|' || c == '\\') {
-                pattern_str += '\\';
+            node->pipeline = std::make_unique<Pipeline>(middlewares, 
+                Pipeline::Handler([node](Context& ctx) { node->handler(ctx); }));
+        }
+    }
+    node->async = node->async_handler || (node->pipeline && node->pipeline->async());
+    if (node->async) {
+        async_routes_++;
+    }
+    node->param_names = std::move(param_names);
+    node->info = std::make_unique<RouteInfo>();
+    node->info->method = method;
+    node->info->pattern = pattern;
+    return node;
+}
+
+Router::Node* Router::insertStatic(Node* node, std::string_view text) {
+    while (!text.empty()) {
+        auto index = node->indices.find(text.front());
+        
+        if (index == std::string::npos) {
+            auto child = std::make_unique<Node>();
+            child->label = text;
+            node->indices.push_back(text.front());
+            node->children.push_back(std::move(child));
+            return node->children.back().get();
+        }
+        
+        auto& slot = node->children[index];
+        std::string_view label = slot->label;
+        
+        size_t common = 0;
+        while (common < label.size() && common < text.size() && label[common] == text[common]) {
+            ++common;
+        }
+        
+        // Split the edge: "users" + "ers/" -> "u" { "sers", "ers/" }
+        if (common < label.size()) {
+            auto mid = std::make_unique<Node>();
+            mid->label = label.substr(0, common);
+            slot->label.erase(0, common);
+            mid->indices.push_back(slot->label.front());
+            mid->children.push_back(std::move(slot));
+            slot = std::move(mid);
+        }
+        
+        node = slot.get();
+        text.remove_prefix(common);
+    }
+    return node;
+}
+
+const Router::Node* Router::match(const Node& node, std::string_view path, Captures& captures) noexcept {
+    if (path.empty()) {
+        if (node.terminal()) {
+            return &node;
+        }
+        // "/static/*" also matches "/static/" with an empty remainder
+        if (node.wildcard) {
+            captures.values[captures.size++] = path;
+            return node.wildcard.get();
+        }
+        return nullptr;
+    }
+    
+    // 1. Static child (edges have distinct first bytes)
+    auto index = node.indices.find(path.front());
+    if (index != std::string::npos) {
+        const Node& child = *node.children[index];
+        if (path.starts_with(child.label)) {
+            if (auto* found = match(child, path.substr(child.label.size()), captures)) {
+                return found;
             }
-            pattern_str += c;
-            pos++;
         }
     }
     
-    pattern_str += "$";
+    // 2. Parameter: one non-empty segment
+    if (node.param) {
+        size_t end = std::min(path.find('/'), path.size());
+        if (end > 0) {
+            size_t mark = captures.size;
+            captures.values[captures.size++] = path.substr(0, end);
+            if (auto* found = match(*node.param, path.substr(end), captures)) {
+                return found;
+            }
+            captures.size = mark;
+        }
+    }
     
-    try {
-        routes_.push_back({
-            method,
-            std::string(path),
-            std::regex(pattern_str),
-            std::move(param_names),
-            std::move(handler)
-        });
-    } catch (const std::regex_error& e) {
-        // Log error but don't crash
-        throw std::runtime_error(std::format("Invalid route pattern '{}': {}", path, e.what()));
+    // 3. Wildcard: the rest of the path
+    if (node.wildcard) {
+        captures.values[captures.size++] = path;
+        return node.wildcard.get();
     }
+    
+    return nullptr;
 }
 
-bool Router::route(Context& ctx) {
-    auto path = ctx.request().getPath();
+const Router::Node* Router::find(Context& ctx) const noexcept {
     auto method = ctx.request().getMethod();
+    if (method == http::Method::UNKNOWN) {
+        return nullptr;
+    }
     
-    for (auto& route_entry : routes_) {
-        if (route_entry.method != method) continue;
-        
-        std::smatch matches;
-        std::string path_str(path);
+    Captures captures;
+    const Node* found = nullptr;
+    
+    if (const auto& tree = trees_[static_cast<size_t>(method)]) {
+        found = match(*tree, ctx.request().getPath(), captures);
+    }
+    
+    // HEAD falls back to the GET route; the server drops the body
+    if (!found && method == http::Method::HEAD) {
+        if (const auto& tree = trees_[static_cast<size_t>(http::Method::GET)]) {
+            captures.size = 0;
+            found = match(*tree, ctx.request().getPath(), captures);
+        }
+    }
+    
+    if (!found) {
+        return nullptr;  // No route found
+    }
+    
+    // Extract path parameters
+    for (size_t i = 0; i < captures.size; ++i) {
+        ctx.setParam(found->param_names[i], captures.values[i]);
+    }
+    ctx.setRoute(found->info.get());
+    return found;
+}
+
+bool Router::route(Context& ctx) {
+    const Node* found = find(ctx);
+    if (!found) {
+        return false;
+    }
+    
+    // Execute handler (behind the group's middleware, if it has any)
+    if (found->pipeline) {
+        found->pipeline->run(ctx);
+    } else if (found->async_handler) {
+        coro::syncWait(found->async_handler(ctx));
+    } else {
+        found->handler(ctx);
+    }
+    return true;
+}
+
+coro::Task<bool> Router::routeAsync(Context& ctx) {
+    const Node* found = find(ctx);
+    if (!found) {
+        co_return false;
+    }
+    
+    if (found->pipeline) {
+        co_await found->pipeline->runAsync(ctx);
+    } else if (found->async_handler) {
+        co_await found->async_handler(ctx);
+    } else {
+        found->handler(ctx);
+    }
+    co_return true;
+}
+
+void Router::forEachRoute(const std::function<void(const RouteInfo&)>& visit) const {
+    const Router& root = root_ ? *root_ : *this;
+    
+    // Depth-first; static children before :param before *wildcard
+    std::vector<const Node*> stack;
+    for (const auto& tree : root.trees_) {
+        if (tree) {
+            stack.push_back(tree.get());
+        }
         
-        if (std::regex_match(path_str, matches, route_entry.pattern)) {
-            // Extract path parameters
-            for (size_t i = 1; i < matches.size(); ++i) {
-                ctx.setParam(route_entry.param_names[i - 1], matches[i].str());
+        while (!stack.empty()) {
+            const Node* node = stack.back();
+            stack.pop_back();
+            
+            if (node->info) {
+                visit(*node->info);
             }
             
-            // Execute handler
-            route_entry.handler(ctx);
-            return true;
+            if (node->wildcard) stack.push_back(node->wildcard.get());
+            if (node->param) stack.push_back(node->param.get());
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+                stack.push_back(it->get());
+            }
         }
     }
+}
+
+bool Router::streams(http::Method method, std::string_view path) const noexcept {
+    const Router& root = root_ ? *root_ : *this;
+    if (root.stream_routes_ == 0 || method == http::Method::UNKNOWN) {
+        return false;
+    }
     
-    return false;  // No route found
+    Captures captures;
+    const auto& tree = root.trees_[static_cast<size_t>(method)];
+    const Node* found = tree ? match(*tree, path, captures) : nullptr;
+    return found && found->streams_body;
+}
+
+bool Router::hasStreamRoutes() const noexcept {
+    return (root_ ? root_->stream_routes_ : stream_routes_) > 0;
+}
+
+bool Router::isAsync(http::Method method, std::string_view path) const noexcept {
+    const Router& root = root_ ? *root_ : *this;
+    if (root.async_routes_ == 0 || method == http::Method::UNKNOWN) {
+        return false;
+    }
+    
+    Captures captures;
+    const auto& tree = root.trees_[static_cast<size_t>(method)];
+    const Node* found = tree ? match(*tree, path, captures) : nullptr;
+    
+    // HEAD falls back to the GET route, as in route()
+    if (!found && method == http::Method::HEAD) {
+        const auto& get_tree = root.trees_[static_cast<size_t>(http::Method::GET)];
+        captures.size = 0;
+        found = get_tree ? match(*get_tree, path, captures) : nullptr;
+    }
+    return found && found->async;
+}
+
+bool Router::hasAsyncRoutes() const noexcept {
+    return (root_ ? root_->async_routes_ : async_routes_) > 0;
 }
 
 Router Router::group(std::string_view prefix) {
     Router child;
     child.prefix_ = prefix_ + std::string(prefix);
-    child.parent_ = this;
+    child.middlewares_ = middlewares_;
+    child.root_ = root_ ? root_ : this;
     return child;
 }
 
+void Router::use(Middleware middleware) {
+    middlewares_.push_back(std::move(middleware));
+}
+
 void Router::get(std::string_view path, RouteHandler handler) {
     addRoute(http::Method::GET, path, std::move(handler));
 }
@@ -119,4 +400,38 @@ void Router::head(std::string_view path, RouteHandler handler) {
     addRoute(http::Method::HEAD, path, std::move(handler));
 }
 
-} // namespace frqs::core
\ No newline at end of file
+void Router::stream(http::Method method, std::string_view path, StreamHandler handler) {
+    Node* node = addRoute(method, path, [handler = std::move(handler)](Context& ctx) {
+        ctx.setBodyStream(handler(ctx));
+    });
+    node->streams_body = true;
+    (root_ ? root_->stream_routes_ : stream_routes_)++;
+}
+
+void Router::websocket(std::string_view path, WebSocketHandler handler) {
+    addRoute(http::Method::GET, path, [handler = std::move(handler)](Context& ctx) {
+        const auto& request = ctx.request();
+        if (!http::isWebSocketUpgrade(request)) {
+            ctx.status(426)
+               .header("Upgrade", "websocket")
+               .header("Sec-WebSocket-Version", "13")
+               .header("Content-Type", "text/plain")
+               .body("WebSocket upgrade required\n");
+            return;
+        }
+        
+        auto listener = handler(ctx);
+        if (!listener) {
+            return;  // Answered by the handler
+        }
+        
+        // The server switches the connection over once this 101 is sent
+        ctx.status(101)
+           .header("Upgrade", "websocket")
+           .header("Connection", "Upgrade")
+           .header("Sec-WebSocket-Accept", http::webSocketAccept(request.getHeader("Sec-WebSocket-Key").value_or("")));
+        ctx.setWebSocket(std::move(listener));
+    });
+}
+
+} // namespace frqs::core
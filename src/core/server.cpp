@@ -8,15 +8,218 @@
 #include "core/server.hpp"
 #include "plugin/plugin.hpp"
 #include "utils/logger.hpp"
+#include "utils/arena.hpp"
 #include <format>
 #include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <utility>
 
 namespace frqs::core {
 
+namespace {
+
+// Minimum free space per recv() call. The parser hands out everything left
+// in its buffer, so a call usually gets more; keeping this below the pool's
+// block size lets a partially received request stay in its pooled buffer.
+constexpr size_t RECV_CHUNK = 4096;
+
+// Reactor wait timeout; bounds how long stop() takes to be noticed
+constexpr int REACTOR_POLL_MS = 250;
+
+// Blocking-mode WebSocket connections: how long a wait for client bytes
+// may leave frames that other threads queued unsent
+constexpr int WEBSOCKET_POLL_MS = 20;
+
+/**
+ * @brief Case-insensitive search for a token in a comma-separated header value
+ */
+bool hasToken(std::string_view value, std::string_view token) {
+    while (!value.empty()) {
+        auto comma = value.find(',');
+        std::string_view item = value.substr(0, comma);
+        
+        while (!item.empty() && (item.front() == ' ' || item.front() == '\t')) item.remove_prefix(1);
+        while (!item.empty() && (item.back() == ' ' || item.back() == '\t')) item.remove_suffix(1);
+        
+        if (std::equal(item.begin(), item.end(), token.begin(), token.end(),
+                [](char a, char b) {
+                    return std::tolower(static_cast<unsigned char>(a)) == 
+                           std::tolower(static_cast<unsigned char>(b));
+                })) {
+            return true;
+        }
+        
+        if (comma == std::string_view::npos) break;
+        value.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+/**
+ * @brief Persistence as requested by the client (RFC 9112 section 9.3)
+ */
+bool wantsKeepAlive(const http::HTTPRequest& request) {
+    auto connection = request.getHeader("Connection").value_or("");
+    
+    if (request.getVersion() == "HTTP/1.0") {
+        return hasToken(connection, "keep-alive");
+    }
+    return !hasToken(connection, "close");
+}
+
+// Recycled coroutine request states per thread (AsyncRequest is ~8 KiB)
+constexpr size_t MAX_SPARE_ASYNC_REQUESTS = 16;
+thread_local std::vector<std::unique_ptr<AsyncRequest>> spare_async_requests;
+
+std::unique_ptr<AsyncRequest> takeAsyncRequest() {
+    if (spare_async_requests.empty()) {
+        return std::make_unique<AsyncRequest>();
+    }
+    auto request = std::move(spare_async_requests.back());
+    spare_async_requests.pop_back();
+    return request;
+}
+
+/**
+ * @brief A request has started arriving, or a new connection awaits its first
+ *
+ * Closing such a connection on a timeout is a read timeout (counted);
+ * closing one idle between requests is ordinary keep-alive expiry.
+ */
+bool midRequest(const Connection& conn) {
+    if (conn.ws || conn.h2) {
+        return false;
+    }
+    return conn.requests_served == 0 || conn.stream || 
+           conn.parser.hasBufferedData() || conn.parser.headersComplete();
+}
+
+void recycleAsyncRequest(std::unique_ptr<AsyncRequest> request) {
+    request->context.reset();
+    request->response.reset();
+    request->arena.reset();
+    request->error = nullptr;
+    request->handoff.store(false, std::memory_order_relaxed);
+    if (spare_async_requests.size() < MAX_SPARE_ASYNC_REQUESTS) {
+        spare_async_requests.push_back(std::move(request));
+    }
+}
+
+/**
+ * @brief BodyWriter over a client socket
+ * 
+ * Coalesces writes up to STREAM_CHUNK bytes, then sends the buffer and the
+ * write that overflowed it as one chunk with a single gathered send. The
+ * serialized headers go out with the first chunk. Send errors are
+ * remembered and reported as false, so the producer can stop.
+ */
+class SocketBodyWriter : public http::BodyWriter {
+public:
+    static constexpr size_t STREAM_CHUNK = 16 * 1024;
+    
+    SocketBodyWriter(net::Socket& socket, std::string_view head, bool chunked, utils::Counter& bytes_sent)
+        : socket_(socket), head_(head), chunked_(chunked), bytes_sent_(bytes_sent) {
+        buffer_.reserve(STREAM_CHUNK);
+    }
+    
+    bool write(std::string_view data) override {
+        if (failed_) {
+            return false;
+        }
+        if (buffer_.size() + data.size() < STREAM_CHUNK) {
+            buffer_ += data;
+            return true;
+        }
+        return send(data, false);
+    }
+    
+    bool flush() override {
+        return !failed_ && send({}, false);
+    }
+    
+    // Send the rest and, when chunked, the last-chunk marker
+    bool finish() {
+        return !failed_ && send({}, true);
+    }
+
+private:
+    bool send(std::string_view data, bool last) {
+        size_t length = buffer_.size() + data.size();
+        
+        // "<hex length>\r\n" ... "\r\n", then "0\r\n\r\n" after the last chunk
+        char size_line[20];
+        size_t size_length = 0;
+        if (chunked_ && length > 0) {
+            auto end = std::to_chars(size_line, size_line + sizeof(size_line) - 2, length, 16).ptr;
+            *end++ = '\r';
+            *end++ = '\n';
+            size_length = static_cast<size_t>(end - size_line);
+        }
+        std::string_view chunk_end = chunked_ && length > 0 ? "\r\n" : "";
+        std::string_view trailer = chunked_ && last ? "0\r\n\r\n" : "";
+        
+        const std::string_view parts[] = {
+            head_, {size_line, size_length}, buffer_, data, chunk_end, trailer
+        };
+        size_t total = 0;
+        for (auto part : parts) {
+            total += part.size();
+        }
+        if (total == 0) {
+            return true;
+        }
+        
+        try {
+            socket_.sendAll(parts);
+        } catch (const std::exception&) {
+            failed_ = true;  // Client went away
+            return false;
+        }
+        bytes_sent_.add(total);
+        head_ = {};
+        buffer_.clear();
+        return true;
+    }
+    
+    net::Socket& socket_;
+    std::string_view head_;
+    bool chunked_;
+    bool failed_ = false;
+    utils::Counter& bytes_sent_;
+    std::string buffer_;
+};
+
+/**
+ * @brief Holds a response's segments back while it is written in several calls
+ * 
+ * Headers sent before a sendfile() body would otherwise leave as a
+ * segment of their own; corked, they fill the first segment with the
+ * body. Uncorking, also on a failed send, flushes the rest.
+ */
+class Cork {
+public:
+    Cork(net::Socket& socket, bool enabled)
+        : socket_(enabled && socket.setCork(true) ? &socket : nullptr) {}
+    
+    ~Cork() {
+        if (socket_) {
+            socket_->setCork(false);
+        }
+    }
+    
+    Cork(const Cork&) = delete;
+    Cork& operator=(const Cork&) = delete;
+
+private:
+    net::Socket* socket_;
+};
+
+} // namespace
+
 Server::Server(uint16_t port, size_t thread_count)
     : port_(port)
     , thread_count_(thread_count)
-    , thread_pool_(std::make_unique<utils::ThreadPool>(thread_count))
 {
     utils::logInfo(std::format("Server initialized on port {} with {} threads", 
                                 port_, thread_count));
@@ -24,6 +227,10 @@ Server::Server(uint16_t port, size_t thread_count)
 
 Server::~Server() {
     stop();
+    
+    // Join workers before the router/plugins they use are destroyed
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    thread_pool_.reset();
 }
 
 bool Server::addPlugin(std::unique_ptr<plugins::Plugin> plugin) {
@@ -65,7 +272,7 @@ bool Server::addPlugin(std::unique_ptr<plugins::Plugin> plugin) {
             });
         
         return true;
-        
+    
     } catch (const std::exception& e) {
         utils::logError(std::format("Exception loading plugin: {}", e.what()));
         return false;
@@ -94,7 +301,37 @@ plugins::Plugin* Server::getPlugin(std::string_view name) const {
 }
 
 void Server::use(Middleware middleware) {
-    middlewares_.push_back(std::move(middleware));
+    addStage(std::move(middleware));
+}
+
+void Server::addStage(PipelineStage stage) {
+    if (running_) {
+        throw std::runtime_error("Middleware must be registered before start()");
+    }
+    middlewares_.push_back(std::move(stage));
+}
+
+size_t Server::setThreadCount(size_t thread_count) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    if (!thread_pool_) {
+        thread_count_ = std::max<size_t>(thread_count, 1);
+        return thread_count_;
+    }
+    
+    size_t before = thread_pool_->size();
+    thread_count_ = thread_pool_->resize(thread_count);
+    if (thread_count_ != before) {
+        utils::logInfo(std::format("Worker threads: {} -> {}", before, thread_count_));
+    }
+    if (thread_count_ != thread_count) {
+        utils::logWarn(std::format("Worker threads limited to {} (requested {})", thread_count_, thread_count));
+    }
+    return thread_count_;
+}
+
+size_t Server::threadCount() const {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    return thread_pool_ ? thread_pool_->size() : thread_count_;
 }
 
 void Server::start() {
@@ -112,11 +349,50 @@ void Server::start() {
             }
         }
         
-        server_socket_ = std::make_unique<net::Socket>();
+        // Freeze the middleware list; requests never look at middlewares_
+        pipeline_ = Pipeline(middlewares_, Pipeline::Handler([this](Context& ctx) { routeOrNotFound(ctx); }));
+        has_async_ = pipeline_.async() || router_.hasAsyncRoutes();
+        if (has_async_) {
+            async_pipeline_ = Pipeline(middlewares_, 
+                AsyncHandler([this](Context& ctx) { return routeOrNotFoundAsync(ctx); }));
+        }
+        
+        bool shared_nothing = options_.reuse_port_listeners > 0;
+        
+        // Created here rather than in the constructor so options can pin the workers.
+        // Shared-nothing loops serve inline and never hand work to the pool.
+        if (!thread_pool_ && !shared_nothing) {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            thread_pool_ = std::make_unique<utils::ThreadPool>(thread_count_, options_.pin_worker_threads);
+        }
+        pool_executor_.pool = thread_pool_.get();
+        
+        AdmissionOptions admission = options_.admission;
+        admission.enabled = admission.enabled && thread_pool_;
+        admission_.configure(admission, thread_pool_ ? thread_pool_->size() : 1);
+        
+        tracer_.configure(options_.trace_sample_every, options_.trace_capacity);
         
         net::SockAddr bind_addr(net::IPv4(0u), port_);
-        server_socket_->bind(bind_addr);
-        server_socket_->listen();
+        reactors_.clear();
+        
+        if (shared_nothing) {
+            openReusePortListeners(bind_addr);
+        } else {
+            server_socket_ = std::make_unique<net::Socket>();
+            listenOn(*server_socket_, bind_addr, true);
+            
+            if (options_.reactor) {
+                auto reactor = std::make_unique<Reactor>();
+                reactor->listener = server_socket_.get();
+                reactors_.push_back(std::move(reactor));
+            }
+        }
+        
+        auto backend = options_.io_uring ? net::LoopBackend::IoUring : net::LoopBackend::Native;
+        for (auto& reactor : reactors_) {
+            reactor->loop = std::make_unique<net::EventLoop>(backend);
+        }
         
         running_ = true;
         
@@ -124,8 +400,12 @@ void Server::start() {
         utils::logInfo(std::format("Loaded plugins: {}", plugins_.size()));
         utils::logInfo(std::format("Registered middleware: {}", middlewares_.size()));
         
-        acceptLoop();
-        
+        if (!reactors_.empty()) {
+            runReactors();
+        } else {
+            acceptLoop();
+        }
+    
     } catch (const std::exception& e) {
         utils::logError(std::format("Server error: {}", e.what()));
         running_ = false;
@@ -140,6 +420,12 @@ void Server::stop() {
     
     running_ = false;
     
+    for (auto& reactor : reactors_) {
+        if (reactor->loop) {
+            reactor->loop->wakeup();
+        }
+    }
+    
     // Call onServerStop for all plugins
     for (auto& plugin : plugins_) {
         plugin->onServerStop();
@@ -150,7 +436,12 @@ void Server::stop() {
         plugin->shutdown();
     }
     
+    // Pending awaits end as timeouts, so parked requests finish
+    io_.stop();
+    
     if (server_socket_) {
+        // shutdown() is what wakes a thread blocked in accept(); close() alone does not on Linux
+        server_socket_->shutdown();
         server_socket_->close();
     }
     
@@ -159,17 +450,27 @@ void Server::stop() {
 
 void Server::acceptLoop() {
     while (running_) {
+        waitWhileOverloaded();
+        
         try {
             net::SockAddr client_addr;
             net::Socket client = server_socket_->accept(&client_addr);
             
+            if (!admitted(client_addr) || shedAtAccept(client)) {
+                continue;  // Closed as `client` goes out of scope
+            }
+            
             active_connections_++;
+            metrics_.connections_accepted.add();
             
-            thread_pool_->submit([this, client = std::move(client), client_addr]() mutable {
-                handleClient(std::move(client), client_addr);
+            admission_.enqueued();
+            thread_pool_->post([this, client = std::move(client), client_addr, 
+                                queued_at = std::chrono::steady_clock::now()]() mutable {
+                handleClient(std::move(client), client_addr, queued_at);
+                admission_.finished();
                 active_connections_--;
             });
-            
+        
         } catch (const std::exception& e) {
             if (running_) {
                 utils::logError(std::format("Accept error: {}", e.what()));
@@ -178,68 +479,1425 @@ void Server::acceptLoop() {
     }
 }
 
-void Server::handleClient(net::Socket client, net::SockAddr client_addr) {
+bool Server::admitted(const net::SockAddr& client_addr) {
+    const auto& filter = options_.ip_filter;
+    if (!filter || filter->admit(client_addr.getAddress())) {
+        return true;
+    }
+    metrics_.connections_rejected.add();
+    return false;
+}
+
+void Server::waitWhileOverloaded() {
+    if (!admission_.enabled() || !admission_.queueOverloaded(thread_pool_->pendingTasks())) {
+        return;
+    }
+    
+    // Even shedding cannot keep the queue bounded: leave new connections
+    // in the listen backlog until the workers are back under the limit
+    metrics_.accept_pauses.add();
+    while (running_ && !admission_.queueDrained(thread_pool_->pendingTasks())) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+bool Server::shedAtAccept(net::Socket& client) {
+    if (!admission_.enabled() || admission_.queueHasRoom(thread_pool_->pendingTasks())) {
+        return false;
+    }
+    
+    // No 503 can be written before a handshake, nor a priority path seen:
+    // an HTTPS client only sees the close
+    if (options_.tls) {
+        metrics_.requests_shed.add();
+        return true;
+    }
+    
     try {
-        static thread_local std::vector<char> buffer(16384);
-        buffer.resize(16384);
+        client.setNonBlocking(true);
         
-        size_t received = client.receive(buffer.data(), buffer.size());
+        // A request already waiting for a priority path is queued anyway
+        char head[512];
+        if (auto peeked = client.tryPeek(head, sizeof(head)); 
+            peeked && admission_.isPriorityRequest({head, *peeked})) {
+            client.setNonBlocking(false);
+            return false;
+        }
         
-        if (received == 0) {
+        // Consume what arrived so closing does not reset the connection
+        // before the client has read the 503
+        char discard[4096];
+        for (int i = 0; i < 4; ++i) {
+            auto received = client.tryReceive(discard, sizeof(discard));
+            if (!received || *received < sizeof(discard)) {
+                break;
+            }
+        }
+        auto response = admission_.shedResponse();
+        if (client.trySend(response.data(), response.size())) {
+            metrics_.bytes_sent.add(response.size());
+        }
+        client.shutdown(1);  // SHUT_WR / SD_SEND
+    } catch (const std::exception&) {
+        // Dropped either way
+    }
+    metrics_.requests_shed.add();
+    return true;
+}
+
+void Server::countHandshake(const net::TlsStream& tls) {
+    metrics_.tls_handshakes.add();
+    if (tls.resumed()) {
+        metrics_.tls_resumed.add();
+    }
+    if (tls.sendsInKernel()) {
+        metrics_.tls_kernel_offload.add();
+    }
+}
+
+bool Server::admitRequest(Connection& conn, std::string_view path) {
+    // Only the first request served by a task waited in the queue
+    auto queue_delay = std::exchange(conn.queue_delay, std::chrono::nanoseconds{0});
+    if (admission_.admit(path, queue_delay)) {
+        return true;
+    }
+    
+    metrics_.requests_shed.add();
+    auto response = admission_.shedResponse();
+    try {
+        conn.socket.sendAll(response);
+        metrics_.bytes_sent.add(response.size());
+    } catch (const std::exception&) {
+        // Closing anyway
+    }
+    return false;
+}
+
+void Server::handleClient(net::Socket client, net::SockAddr client_addr, 
+                          std::chrono::steady_clock::time_point queued_at) {
+    Connection conn(std::move(client), client_addr);
+    conn.parser.setPauseBeforeBody(router_.hasStreamRoutes());
+    conn.queue_delay = std::chrono::steady_clock::now() - queued_at;
+    conn.accepted_at = queued_at;
+    conn.socket.configureAccepted(options_.socket);
+    
+    if (options_.tls) {
+        // The blocking path gives the worker to the connection anyway; the
+        // handshake only has to fit in the wait for the first request
+        try {
+            conn.socket.startTls(*options_.tls);
+            conn.socket.setNonBlocking(true);
+            conn.socket.handshake(options_.header_timeout_ms);
+            conn.socket.setNonBlocking(false);
+        } catch (const std::exception&) {
+            metrics_.tls_handshake_failures.add();
             return;
         }
+        countHandshake(*conn.socket.tls());
+        if (conn.socket.tls()->alpn() == "h2") {
+            startHttp2(conn);
+        }
+    }
+    
+    try {
+        while (running_) {
+            if (conn.ws) {
+                runWebSocket(conn);
+                return;
+            }
+            
+            // Nothing pending: the receive buffer waits in the pool, not on this connection
+            conn.parser.releaseBuffer();
+            
+            // Idle or stalled connections give the worker back after the
+            // timeout for what they are in the middle of (see readDeadline)
+            auto left = std::chrono::ceil<std::chrono::milliseconds>(
+                readDeadline(conn) - std::chrono::steady_clock::now()).count();
+            if (left <= 0 || !conn.socket.waitReadable(static_cast<int>(std::min<int64_t>(left, INT32_MAX)))) {
+                if (midRequest(conn)) {
+                    metrics_.read_timeouts.add();
+                }
+                return;
+            }
+            
+            // Receive straight into the parser's (or HTTP/2 session's) buffer
+            auto space = conn.receiveSpace(RECV_CHUNK);
+            size_t received = conn.socket.receive(space.data(), space.size());
+            if (received == 0) {
+                return;
+            }
+            metrics_.bytes_received.add(received);
+            conn.markReceived(std::chrono::steady_clock::now());
+            conn.commitReceived(received);
+            
+            if (!serveBuffered(conn)) {
+                return;
+            }
+        }
+    
+    } catch (const std::exception& e) {
+        utils::logError(std::format("Error handling client {}: {}", 
+                                   client_addr.toString(), 
+                                   e.what()));
+    }
+}
+
+bool Server::serveBuffered(Connection& conn) {
+    auto& parser = conn.parser;
+    
+    if (conn.ws) {
+        return serveWebSocket(conn);
+    }
+    if (conn.h2) {
+        return serveHttp2(conn);
+    }
+    
+    // h2c with prior knowledge: the first bytes are the HTTP/2 preface,
+    // which no HTTP/1 request starts with ("PRI" is not a method we serve)
+    if (conn.requests_served == 0 && options_.http2.cleartext && !conn.socket.tls() && !conn.stream) {
+        auto buffered = parser.buffered();
+        auto preface = http::Http2Session::PREFACE;
+        if (buffered.size() < preface.size() && preface.starts_with(buffered)) {
+            return true;  // Could still be either
+        }
+        if (buffered.starts_with(preface)) {
+            startHttp2(conn);
+            conn.h2->feed(buffered);
+            parser.reset();
+            parser.releaseBuffer();
+            return serveHttp2(conn);
+        }
+    }
+    
+    // Serve pipelined requests in arrival order
+    while (true) {
+        if (tracer_.enabled() && parser.headersComplete() && conn.headers_parsed < conn.first_byte) {
+            conn.headers_parsed = std::chrono::steady_clock::now();
+        }
         
-        http::HTTPRequest request;
-        std::string_view raw_request(buffer.data(), received);
+        if (conn.stream) {
+            if (!pumpStream(conn)) {
+                return false;
+            }
+            if (conn.stream) {
+                break;  // Body still arriving
+            }
+            continue;
+        }
         
-        if (!request.parse(raw_request)) {
-            utils::logWarn(std::format("Invalid request from {}: {}", 
-                                      client_addr.toString(), 
-                                      request.getError()));
-            
-            auto response = http::HTTPResponse().badRequest();
-            client.send(response.build());
-            return;
+        // Headers are in and the parser waits to learn where the body goes
+        if (parser.bodyPending()) {
+            if (!startBody(conn)) {
+                return false;
+            }
+            continue;
         }
         
-        total_requests_++;
+        if (parser.status() != http::ParseStatus::Complete) {
+            break;
+        }
         
-        // Process request through middleware & router
-        http::HTTPResponse response;
-        processRequest(request, response);
+        bool keep_alive = serveRequest(conn, parser.request());
+        if (conn.pending) {
+            return true;  // Coroutine request; the reactor runs it (serveReady)
+        }
+        conn.last_activity = std::chrono::steady_clock::now();
         
-        client.send(response.build());
+        if (!keep_alive) {
+            return false;
+        }
         
-    } catch (const std::exception& e) {
-        utils::logError(std::format("Error handling client {}: {}", 
-                                   client_addr.toString(), 
-                                   e.what()));
+        parser.next();
+        conn.continue_sent = false;
+        if (conn.ws) {
+            return serveWebSocket(conn);  // Upgraded; what follows are frames
+        }
+    }
+    
+    if (parser.status() == http::ParseStatus::Error) {
+        rejectRequest(conn);
+        return false;
+    }
+    
+    // Headers are in and the client waits for permission to send the body
+    if (parser.headersComplete() && parser.expectsContinue() && !conn.continue_sent) {
+        conn.socket.sendAll("HTTP/1.1 100 Continue\r\n\r\n");
+        conn.continue_sent = true;
     }
+    
+    return true;  // Need more bytes
 }
 
-void Server::processRequest(const http::HTTPRequest& request, http::HTTPResponse& response) {
-    Context ctx(request, response);
+void Server::rejectRequest(Connection& conn) {
+    metrics_.parse_errors.add();
+    utils::logWarn(std::format("Invalid request from {}: {}", 
+                              conn.address.toString(), 
+                              conn.parser.error()));
     
-    // Execute middleware chain + router
-    executeMiddlewareChain(ctx, 0);
+    http::HTTPResponse response;
+    response.setStatus(conn.parser.errorStatus())
+            .setContentType("text/html")
+            .setBody(std::format("<html><body><h1>{} {}</h1></body></html>",
+                                 response.getStatus(), response.getStatusMessage()))
+            .setHeader("Connection", "close");
+    sendResponse(conn, response, false);
 }
 
-void Server::executeMiddlewareChain(Context& ctx, size_t index) {
-    if (index < middlewares_.size()) {
-        // Execute current middleware
-        middlewares_[index](ctx, [this, &ctx, index]() {
-            // Next middleware
-            executeMiddlewareChain(ctx, index + 1);
-        });
-    } else {
-        // End of middleware chain - try routing
-        if (!router_.route(ctx)) {
-            // No route found - 404
-            ctx.status(404)
-               .header("Content-Type", "text/html")
-               .body("<h1>404 - Not Found</h1><p>The requested resource was not found.</p>");
+bool Server::serveRequest(Connection& conn, const http::HTTPRequest& request) {
+    if (!admitRequest(conn, request.getPath())) {
+        return false;
+    }
+    
+    // Reactor connections run coroutine requests detached from this call;
+    // blocking ones wait for them in processRequest()
+    if (has_async_ && !reactors_.empty() && needsAsync(request)) {
+        conn.pending = takeAsyncRequest();
+        auto& pending = *conn.pending;
+        pending.started = std::chrono::steady_clock::now();
+        pending.response.emplace(&pending.arena);
+        pending.context.emplace(request, *pending.response, &pending.arena);
+        pending.context->setIo(&io_);
+        pending.context->setDeadline(handlerDeadline());
+        return true;
+    }
+    
+    // Per-worker arena for response headers, context state and handler
+    // scratch. Rewinding it here, not after the send, also covers a
+    // previous request that ended in an exception.
+    static thread_local utils::Arena arena;
+    arena.reset();
+    
+    // Process request through middleware & router
+    auto started = std::chrono::steady_clock::now();
+    http::HTTPResponse response(&arena);
+    RouteInfo* route = processRequest(request, response, &arena, &conn);
+    return finishRequest(conn, request, response, route, started);
+}
+
+bool Server::startBody(Connection& conn) {
+    auto& parser = conn.parser;
+    
+    // Regular routes get the body buffered, under the parser's body limit
+    if (!router_.streams(parser.method(), parser.path())) {
+        parser.resume();
+        return true;
+    }
+    if (!admitRequest(conn, parser.path())) {
+        return false;
+    }
+    
+    if (parser.streamBody(options_.max_streamed_body_bytes) == http::ParseStatus::Error) {
+        return true;  // Rejected by the caller
+    }
+    
+    // The route runs now; its handler returns the consumer for the body
+    auto stream = std::make_unique<StreamedRequest>(parser.request());
+    stream->context.setIo(&io_);
+    stream->context.setDeadline(handlerDeadline());
+    pipeline_.run(stream->context);
+    
+    if (!stream->context.bodyStream()) {
+        // Answered without reading the body (a middleware refused it, say),
+        // so the connection cannot be reused
+        stream->response.setHeader("Connection", "close");
+        finishRequest(conn, stream->request, stream->response, stream->context.route(), stream->started);
+        return false;
+    }
+    
+    conn.stream = std::move(stream);
+    return true;
+}
+
+bool Server::pumpStream(Connection& conn) {
+    auto& parser = conn.parser;
+    auto& context = conn.stream->context;
+    
+    auto data = parser.takeBody();
+    bool wanted = data.empty() || context.bodyStream()->onData(data);
+    
+    if (parser.status() == http::ParseStatus::Error) {
+        conn.stream.reset();  // Destroyed without onEnd(); the parser error is sent instead
+        return true;
+    }
+    if (wanted && parser.status() == http::ParseStatus::NeedMore) {
+        return true;
+    }
+    
+    bool complete = wanted && parser.status() == http::ParseStatus::Complete;
+    context.bodyStream()->onEnd(context, complete);
+    if (!complete) {
+        conn.stream->response.setHeader("Connection", "close");  // Rest of the body is unread
+    }
+    
+    auto stream = std::move(conn.stream);
+    bool keep_alive = finishRequest(conn, stream->request, stream->response, 
+                                    stream->context.route(), stream->started);
+    conn.last_activity = std::chrono::steady_clock::now();
+    
+    if (!keep_alive) {
+        return false;
+    }
+    
+    parser.next();
+    conn.continue_sent = false;
+    return true;
+}
+
+bool Server::finishRequest(Connection& conn, const http::HTTPRequest& request, http::HTTPResponse& response,
+                           RouteInfo* route, std::chrono::steady_clock::time_point started) {
+    auto first_byte = conn.first_byte;  // countRequest() moves on to the next request
+    countRequest(conn, response, route, started);
+    auto handled = conn.request_started;
+    
+    // Accepted WebSocket upgrade, unless a middleware answered otherwise
+    if (conn.upgrade) {
+        if (response.getStatus() == 101) {
+            if (!sendResponse(conn, response, false)) {
+                return false;
+            }
+            startWebSocket(conn);
+            return true;
+        }
+        conn.upgrade.reset();
+    }
+    
+    // A streamed body of unknown length is chunked; HTTP/1.0 has no
+    // chunked coding, so there the end of the body is the end of the connection
+    bool close_delimited = false;
+    if (response.isStreaming() && !response.getHeader("Content-Length")) {
+        if (request.getVersion() == "HTTP/1.0") {
+            close_delimited = true;
+        } else {
+            response.setHeader("Transfer-Encoding", "chunked");
         }
     }
+    
+    bool keep_alive = options_.keep_alive
+        && !close_delimited
+        && wantsKeepAlive(request)
+        && !hasToken(response.getHeader("Connection").value_or(""), "close")
+        && (options_.max_keep_alive_requests == 0 || 
+            conn.requests_served < options_.max_keep_alive_requests);
+    
+    if (keep_alive) {
+        response.setHeader("Connection", "keep-alive");
+        response.setHeader("Keep-Alive", std::format("timeout={}", 
+            std::max(options_.keep_alive_timeout_ms / 1000, 1)));
+    } else {
+        response.setHeader("Connection", "close");
+    }
+    
+    bool sent = sendResponse(conn, response, request.getMethod() == http::Method::HEAD);
+    if (tracer_.enabled() && tracer_.sample()) {
+        traceRequest(conn, request, response, first_byte, started, handled);
+    }
+    return keep_alive && sent;
+}
+
+void Server::countRequest(Connection& conn, const http::HTTPResponse& response, RouteInfo* route,
+                          std::chrono::steady_clock::time_point started) {
+    total_requests_++;
+    metrics_.requests.add();
+    conn.requests_served++;
+    
+    // Pipelined bytes after this request are the next one, begun by now
+    auto now = std::chrono::steady_clock::now();
+    conn.request_started = now;
+    conn.first_byte = now;
+    
+    if (options_.handler_timeout_ms > 0 && now - started >= std::chrono::milliseconds(options_.handler_timeout_ms)) {
+        metrics_.handler_timeouts.add();
+    }
+    
+    auto micros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        now - started).count());
+    if (route) {
+        route->latency.record(micros);
+    }
+    if (auto status_class = response.getStatus() / 100; status_class >= 1 && status_class <= 5) {
+        metrics_.latency_by_class[status_class - 1].record(micros);
+    }
+}
+
+std::chrono::steady_clock::time_point Server::readDeadline(const Connection& conn) const {
+    using std::chrono::milliseconds;
+    if (conn.h2) {
+        return conn.last_activity + milliseconds(options_.keep_alive_timeout_ms);
+    }
+    
+    // A body is bounded per read, so a large upload on a slow link is not
+    if (conn.stream || conn.parser.headersComplete()) {
+        return conn.last_activity + milliseconds(options_.body_timeout_ms);
+    }
+    
+    // Headers are bounded as a whole: trickling a byte at a time does not extend them
+    if (conn.requests_served == 0 || conn.parser.hasBufferedData()) {
+        return conn.request_started + milliseconds(options_.header_timeout_ms);
+    }
+    return conn.last_activity + milliseconds(options_.keep_alive_timeout_ms);
+}
+
+std::chrono::steady_clock::time_point Server::handlerDeadline() const noexcept {
+    if (options_.handler_timeout_ms <= 0) {
+        return std::chrono::steady_clock::time_point::max();
+    }
+    return std::chrono::steady_clock::now() + std::chrono::milliseconds(options_.handler_timeout_ms);
+}
+
+bool Server::sendResponse(Connection& conn, const http::HTTPResponse& response, bool head_only) {
+    // Per-worker header buffer: keeps its capacity, so steady state allocates nothing
+    static thread_local std::string head;
+    head.clear();
+    response.serializeHeaders(head);
+    
+    // HEAD responses carry the GET headers (including Content-Length) but
+    // no body; 1xx, 204 and 304 responses have no body to send either
+    bool body_allowed = !head_only && http::HTTPResponse::statusAllowsBody(response.getStatus());
+    
+    // Streamed body: produced now, paced by the socket
+    if (response.isStreaming() && body_allowed) {
+        SocketBodyWriter writer(conn.socket, head, 
+                                response.getHeader("Transfer-Encoding").has_value(), metrics_.bytes_sent);
+        response.getStreamBody()(writer);
+        return writer.finish();
+    }
+    
+    const auto& file = response.getFileBody();
+    if (!body_allowed || file) {
+        bool body = body_allowed && file->length > 0;
+        Cork cork(conn.socket, body && options_.socket.cork);
+        conn.socket.sendAll(head);
+        metrics_.bytes_sent.add(head.size());
+        if (body) {
+            conn.socket.sendFile(file->file->native_handle(), file->offset, file->length);
+            metrics_.bytes_sent.add(file->length);
+        }
+        return true;
+    }
+    
+    const std::string_view parts[] = {head, response.getBody()};
+    conn.socket.sendAll(parts);
+    metrics_.bytes_sent.add(head.size() + response.getBody().size());
+    return true;
+}
+
+void Server::traceRequest(const Connection& conn, const http::HTTPRequest& request, const http::HTTPResponse& response,
+                          std::chrono::steady_clock::time_point first_byte,
+                          std::chrono::steady_clock::time_point started,
+                          std::chrono::steady_clock::time_point handled) {
+    utils::RequestTrace trace;
+    trace.accepted = conn.requests_served == 1 ? conn.accepted_at : first_byte;
+    trace.first_byte = first_byte;
+    // Kept between its neighbours if serveBuffered() missed the stamp
+    trace.headers_parsed = std::max(first_byte, std::min(conn.headers_parsed, started));
+    trace.handler_started = started;
+    trace.handler_finished = handled;
+    trace.last_byte = std::chrono::steady_clock::now();
+    trace.connection = reinterpret_cast<uintptr_t>(&conn);
+    trace.name = std::format("{} {} {}", http::methodToString(request.getMethod()),
+                             request.getPath(), response.getStatus());
+    tracer_.record(std::move(trace));
+}
+
+// ========== HTTP/2 ==========
+
+void Server::startHttp2(Connection& conn) {
+    conn.h2 = std::make_unique<http::Http2Session>(options_.http2);
+    metrics_.http2_connections.add();
+}
+
+bool Server::serveHttp2(Connection& conn) {
+    auto& session = *conn.h2;
+    bool healthy = session.process();
+    
+    // Complete requests, most urgent first. Each response is queued as
+    // soon as it is ready; the frames go out, interleaved by priority and
+    // within the client's windows, below (and as WINDOW_UPDATEs arrive).
+    while (healthy) {
+        auto next = session.nextRequest();
+        if (!next) {
+            break;
+        }
+        const auto& request = next->request;
+        
+        static thread_local utils::Arena arena;
+        arena.reset();
+        
+        auto started = std::chrono::steady_clock::now();
+        http::HTTPResponse response(&arena);
+        RouteInfo* route = nullptr;
+        
+        // Only the first request served by a task waited in the queue
+        auto queue_delay = std::exchange(conn.queue_delay, std::chrono::nanoseconds{0});
+        if (!admission_.admit(request.getPath(), queue_delay)) {
+            metrics_.requests_shed.add();
+            response.setStatus(503)
+                    .setContentType("text/plain")
+                    .setHeader("Retry-After", std::to_string(admission_.retryAfterSeconds()))
+                    .setBody("Service Unavailable\n");
+        } else {
+            try {
+                route = processRequest(request, response, &arena, nullptr);
+            } catch (const std::exception& e) {
+                // Only this stream fails; the others on the connection go on
+                utils::logError(std::format("Error handling client {} (HTTP/2 stream {}): {}", 
+                                           conn.address.toString(), next->stream_id, e.what()));
+                response = http::HTTPResponse(&arena);
+                response.internalError();
+            }
+        }
+        
+        countRequest(conn, response, route, started);
+        bool streamed = session.respond(next->stream_id, response, request.getMethod() == http::Method::HEAD);
+        if (streamed && !streamHttp2(conn, next->stream_id, response.getStreamBody())) {
+            return false;  // Client gone, stalled, or broke the protocol
+        }
+        
+        if (options_.max_keep_alive_requests != 0 && conn.requests_served >= options_.max_keep_alive_requests) {
+            session.goAway();
+        }
+    }
+    
+    if (!running_) {
+        session.goAway();
+    }
+    flushHttp2(conn);
+    conn.last_activity = std::chrono::steady_clock::now();
+    return healthy && !session.done();
+}
+
+void Server::flushHttp2(Connection& conn) {
+    auto& session = *conn.h2;
+    static thread_local std::vector<std::string_view> bytes;
+    
+    // Runs of frame bytes go out gathered; file-backed DATA payloads with sendfile()
+    while (true) {
+        auto segments = session.output();
+        if (segments.empty()) {
+            return;
+        }
+        
+        uint64_t total = 0;
+        bytes.clear();
+        for (const auto& segment : segments) {
+            if (!segment.file) {
+                bytes.push_back(segment.bytes);
+                total += segment.bytes.size();
+                continue;
+            }
+            if (!bytes.empty()) {
+                conn.socket.sendAll(bytes);
+                bytes.clear();
+            }
+            conn.socket.sendFile(segment.file->native_handle(), segment.offset, segment.length);
+            total += segment.length;
+        }
+        if (!bytes.empty()) {
+            conn.socket.sendAll(bytes);
+        }
+        metrics_.bytes_sent.add(total);
+        session.sent();
+    }
+}
+
+bool Server::streamHttp2(Connection& conn, uint32_t stream_id, const http::StreamBody& producer) {
+    // The producer fills the stream's buffer. A full buffer goes out as
+    // DATA frames; once the client's windows are spent, the producer waits
+    // here for its WINDOW_UPDATEs. The other streams' frames go out
+    // meanwhile, but requests that arrive wait until the producer returns.
+    class Writer : public http::BodyWriter {
+    public:
+        Writer(Server& server, Connection& conn, uint32_t stream_id)
+            : server_(server), conn_(conn), stream_id_(stream_id) {}
+        
+        bool write(std::string_view data) override {
+            auto& session = *conn_.h2;
+            if (failed_ || !session.streamBody(stream_id_, data)) {
+                return false;
+            }
+            while (!failed_ && full()) {
+                send();
+                if (!failed_ && full()) {
+                    receive();
+                }
+            }
+            return !failed_;
+        }
+        
+        bool flush() override {
+            if (!failed_) {
+                send();
+            }
+            return !failed_;
+        }
+        
+        [[nodiscard]] bool failed() const noexcept { return failed_; }
+    
+    private:
+        [[nodiscard]] bool full() const {
+            return conn_.h2->streamBuffered(stream_id_) >= http::Http2Session::STREAM_BUFFER;
+        }
+        
+        void send() {
+            try {
+                server_.flushHttp2(conn_);
+            } catch (const std::exception&) {
+                failed_ = true;  // Client went away
+            }
+        }
+        
+        // One read of what the client sent: WINDOW_UPDATE, RST_STREAM, new requests
+        void receive() {
+            try {
+                if (!conn_.socket.waitReadable(server_.options_.body_timeout_ms)) {
+                    server_.metrics_.read_timeouts.add();
+                    failed_ = true;
+                    return;
+                }
+                auto received = conn_.tryReceive(conn_.receiveSpace(RECV_CHUNK));
+                if (!received) {
+                    return;  // Part of a TLS record
+                }
+                if (*received == 0) {
+                    failed_ = true;
+                    return;
+                }
+                server_.metrics_.bytes_received.add(*received);
+                conn_.commitReceived(*received);
+            } catch (const std::exception&) {
+                failed_ = true;
+                return;
+            }
+            if (!conn_.h2->process()) {
+                send();  // The GOAWAY
+                failed_ = true;
+            }
+        }
+        
+        Server& server_;
+        Connection& conn_;
+        uint32_t stream_id_;
+        bool failed_ = false;
+    };
+    
+    Writer writer(*this, conn, stream_id);
+    producer(writer);
+    conn.h2->endStream(stream_id);
+    return !writer.failed();
+}
+
+// ========== WEBSOCKET ==========
+
+void Server::startWebSocket(Connection& conn) {
+    conn.ws = std::make_shared<WebSocket>(conn.socket, conn.address, std::move(conn.upgrade), 
+                                          options_.websocket, &metrics_.bytes_sent);
+    metrics_.websocket_connections.add();
+    conn.ws->open();
+}
+
+bool Server::serveWebSocket(Connection& conn) {
+    auto& ws = *conn.ws;
+    
+    // Frames the client sent right behind the handshake
+    if (auto early = conn.parser.buffered(); !early.empty()) {
+        ws.feed(early);
+        conn.parser.reset();
+        conn.parser.releaseBuffer();
+    }
+    
+    bool open = ws.process();
+    conn.last_activity = std::chrono::steady_clock::now();
+    return open;
+}
+
+void Server::runWebSocket(Connection& conn) {
+    // Nothing wakes this worker when another thread queues a frame, so
+    // waits for client bytes are short and the queue is flushed between them
+    auto& ws = *conn.ws;
+    auto timeout = std::chrono::milliseconds(std::max(options_.websocket.idle_timeout_ms, 1));
+    conn.socket.setNonBlocking(true);
+    
+    while (running_ && ws.flush() && !ws.done()) {
+        if (!conn.socket.waitReadable(WEBSOCKET_POLL_MS)) {
+            auto idle = std::chrono::steady_clock::now() - conn.last_activity;
+            if (idle >= timeout) {
+                return;  // Closed with 1001 (WebSocket::detach)
+            }
+            if (idle >= timeout / 2) {
+                ws.ping();
+            }
+            continue;
+        }
+        
+        while (true) {
+            auto space = conn.receiveSpace(RECV_CHUNK);
+            auto received = conn.tryReceive(space);
+            if (!received) {
+                break;
+            }
+            if (*received == 0) {
+                return;
+            }
+            metrics_.bytes_received.add(*received);
+            conn.commitReceived(*received);
+        }
+        
+        if (!serveWebSocket(conn)) {
+            return;
+        }
+    }
+}
+
+// ========== REACTOR MODE ==========
+
+void Server::listenOn(net::Socket& socket, const net::SockAddr& bind_addr, bool report) {
+    auto skipped = socket.configureListener(options_.socket);
+    socket.bind(bind_addr);
+    socket.listen(options_.socket.backlog);
+    
+    if (report && !skipped.empty()) {
+        std::string names;
+        for (auto name : skipped) {
+            names.append(names.empty() ? "" : ", ").append(name);
+        }
+        utils::logWarn(std::format("Socket options not applied (unsupported or not permitted): {}", names));
+    }
+}
+
+void Server::openReusePortListeners(const net::SockAddr& bind_addr) {
+    size_t count = options_.reuse_port_listeners;
+    
+    for (size_t i = 0; i < count; ++i) {
+        auto socket = std::make_unique<net::Socket>();
+        if (!socket->setReusePort(true)) {
+            if (i == 0) {
+                break;  // Unsupported: fall back to one shared listener
+            }
+            throw std::runtime_error("Failed to set SO_REUSEPORT");
+        }
+        listenOn(*socket, bind_addr, i == 0);
+        
+        auto reactor = std::make_unique<Reactor>();
+        reactor->listener = socket.get();
+        reactor->own_listener = std::move(socket);
+        reactor->serve_inline = true;
+        reactors_.push_back(std::move(reactor));
+    }
+    
+    if (!reactors_.empty()) {
+        return;
+    }
+    
+    utils::logWarn("SO_REUSEPORT unavailable; event loops will share one listener");
+    server_socket_ = std::make_unique<net::Socket>();
+    listenOn(*server_socket_, bind_addr, true);
+    
+    for (size_t i = 0; i < count; ++i) {
+        auto reactor = std::make_unique<Reactor>();
+        reactor->listener = server_socket_.get();
+        reactor->serve_inline = true;
+        reactors_.push_back(std::move(reactor));
+    }
+}
+
+void Server::runReactors() {
+    utils::logInfo(std::format("Reactor mode enabled ({} backend, {} loop{})", 
+                               reactors_.front()->loop->backend(), reactors_.size(),
+                               reactors_.size() == 1 ? "" : "s"));
+    
+    bool pin = options_.pin_worker_threads && reactors_.front()->serve_inline;
+    
+    // Loop 0 runs on the calling thread, like the single reactor always did
+    std::vector<std::thread> threads;
+    threads.reserve(reactors_.size() - 1);
+    for (size_t i = 1; i < reactors_.size(); ++i) {
+        threads.emplace_back([this, i, pin] {
+            if (pin) {
+                utils::ThreadPool::pinCurrentThread(i);
+            }
+            reactorLoop(*reactors_[i]);
+        });
+    }
+    
+    if (pin) {
+        utils::ThreadPool::pinCurrentThread(0);
+    }
+    reactorLoop(*reactors_.front());
+    
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void Server::reactorLoop(Reactor& reactor) {
+    auto& loop = *reactor.loop;
+    
+    // The listener is registered level-triggered with a null tag
+    reactor.listener->setNonBlocking(true);
+    loop.add(reactor.listener->native_handle(), net::IoEvent::Read, nullptr);
+    
+    std::vector<net::ReadyEvent> events(std::max<size_t>(options_.max_events, 1));
+    
+    while (running_) {
+        // Sleep until the next timeout is due, if that comes first
+        int wait_ms = REACTOR_POLL_MS;
+        {
+            std::lock_guard<std::mutex> lock(reactor.timers_mutex);
+            if (auto next = reactor.timers.nextExpiry()) {
+                auto ms = std::chrono::ceil<std::chrono::milliseconds>(*next - std::chrono::steady_clock::now()).count();
+                wait_ms = static_cast<int>(std::clamp<int64_t>(ms, 0, wait_ms));
+            }
+        }
+        
+        size_t ready = 0;
+        try {
+            // While accepting is paused, poll often enough to resume promptly
+            ready = loop.wait(events, reactor.accepting ? wait_ms : 1);
+        } catch (const std::exception& e) {
+            utils::logError(std::format("Event loop error: {}", e.what()));
+            continue;
+        }
+        
+        for (size_t i = 0; i < ready; ++i) {
+            if (events[i].data == nullptr) {
+                acceptReady(reactor);
+                continue;
+            }
+            
+            // One-shot registration: this connection is now owned by one worker.
+            // A WebSocket send may re-arm it while owned; that event is
+            // dropped here, and the owner re-arms when it is done.
+            auto conn = static_cast<Connection*>(events[i].data)->shared_from_this();
+            if (conn->busy.exchange(true)) {
+                continue;
+            }
+            watchHandler(reactor, *conn);
+            if (reactor.serve_inline) {
+                onReadable(reactor, conn);
+            } else {
+                conn->queued_at = std::chrono::steady_clock::now();
+                admission_.enqueued();
+                thread_pool_->post([this, &reactor, conn = std::move(conn)]() {
+                    conn->queue_delay = std::chrono::steady_clock::now() - conn->queued_at;
+                    onReadable(reactor, conn);
+                    admission_.finished();
+                });
+            }
+        }
+        
+        // Resume accepting once the workers caught up (see acceptReady)
+        if (!reactor.accepting && admission_.queueDrained(thread_pool_->pendingTasks())) {
+            loop.add(reactor.listener->native_handle(), net::IoEvent::Read, nullptr);
+            reactor.accepting = true;
+        }
+        
+        fireTimers(reactor);
+    }
+    
+    // Drop idle connections still waiting in the loop
+    std::lock_guard<std::mutex> lock(reactor.connections_mutex);
+    {
+        std::lock_guard<std::mutex> timers_lock(reactor.timers_mutex);
+        reactor.timers.clear();
+    }
+    for (auto& [ptr, conn] : reactor.connections) {
+        {
+            std::lock_guard<std::mutex> arm_lock(conn->arm_mutex);
+            conn->closed = true;
+        }
+        loop.remove(conn->socket.native_handle());
+    }
+    active_connections_ -= reactor.connections.size();
+    reactor.connections.clear();
+}
+
+void Server::acceptReady(Reactor& reactor) {
+    while (running_) {
+        // See waitWhileOverloaded()
+        if (admission_.enabled() && admission_.queueOverloaded(thread_pool_->pendingTasks())) {
+            reactor.loop->remove(reactor.listener->native_handle());
+            reactor.accepting = false;
+            metrics_.accept_pauses.add();
+            return;
+        }
+        
+        net::SockAddr client_addr;
+        std::optional<net::Socket> client;
+        
+        try {
+            client = reactor.listener->tryAccept(&client_addr);
+        } catch (const std::exception& e) {
+            if (running_) {
+                utils::logError(std::format("Accept error: {}", e.what()));
+            }
+            return;
+        }
+        
+        if (!client) {
+            return;  // Backlog drained (or another loop sharing the listener won)
+        }
+        if (!admitted(client_addr) || shedAtAccept(*client)) {
+            continue;
+        }
+        
+        try {
+            client->setNonBlocking(true);
+            client->configureAccepted(options_.socket);
+            if (options_.tls) {
+                client->startTls(*options_.tls);
+            }
+            
+            auto conn = std::make_shared<Connection>(std::move(*client), client_addr);
+            conn->parser.setPauseBeforeBody(router_.hasStreamRoutes());
+            {
+                std::lock_guard<std::mutex> lock(reactor.connections_mutex);
+                reactor.connections.emplace(conn.get(), conn);
+            }
+            active_connections_++;
+            metrics_.connections_accepted.add();
+            
+            reactor.loop->add(conn->socket.native_handle(), net::IoEvent::Read, conn.get(), true);
+            {
+                std::lock_guard<std::mutex> lock(reactor.timers_mutex);
+                reactor.timers.schedule(conn->timer, readDeadline(*conn), conn.get());
+            }
+        
+        } catch (const std::exception& e) {
+            utils::logError(std::format("Failed to register client {}: {}", 
+                                       client_addr.toString(), e.what()));
+        }
+    }
+}
+
+void Server::onReadable(Reactor& reactor, const std::shared_ptr<Connection>& conn) {
+    try {
+        if (auto* tls = conn->socket.tls(); tls && !tls->established()) {
+            net::TlsWant want;
+            try {
+                want = conn->socket.tryHandshake();
+            } catch (const std::exception&) {
+                // Scanners and plain-HTTP clients: counted, not logged
+                metrics_.tls_handshake_failures.add();
+                closeConnection(reactor, conn);
+                return;
+            }
+            
+            if (want != net::TlsWant::None) {
+                // Parked under the header timeout, which counts from accept,
+                // so a trickled handshake is bounded too
+                park(reactor, conn, want == net::TlsWant::Read ? net::IoEvent::Read : net::IoEvent::Write);
+                return;
+            }
+            countHandshake(*tls);
+            if (tls->alpn() == "h2") {
+                startHttp2(*conn);
+            }
+        }
+        
+        // Woken (also) for writability: send what queued up first
+        if (conn->ws && !conn->ws->flush()) {
+            closeConnection(reactor, conn);
+            return;
+        }
+        
+        // Drain everything the kernel has buffered, serving as requests complete
+        while (true) {
+            auto space = conn->receiveSpace(RECV_CHUNK);
+            auto received = conn->tryReceive(space);
+            if (!received) {
+                break;
+            }
+            if (*received == 0) {
+                // Requests fully received before a half-close were answered above
+                closeConnection(reactor, conn);
+                return;
+            }
+            conn->markReceived(std::chrono::steady_clock::now());
+            metrics_.bytes_received.add(*received);
+            conn->commitReceived(*received);
+            
+            auto progress = serveReady(reactor, conn);
+            if (progress == Progress::Parked) {
+                return;
+            }
+            if (progress == Progress::Close) {
+                closeConnection(reactor, conn);
+                return;
+            }
+        }
+        
+        if (conn->ws) {
+            parkWebSocket(reactor, conn);
+            return;
+        }
+        
+        // Keep-alive or partial request: wait for more bytes. An idle
+        // connection does not hold on to a receive buffer meanwhile.
+        conn->parser.releaseBuffer();
+        park(reactor, conn, net::IoEvent::Read);
+    
+    } catch (const std::exception& e) {
+        utils::logError(std::format("Error handling client {}: {}", 
+                                   conn->address.toString(), e.what()));
+        closeConnection(reactor, conn);
+    }
+}
+
+void Server::closeConnection(Reactor& reactor, const std::shared_ptr<Connection>& conn) {
+    {
+        std::lock_guard<std::mutex> lock(conn->arm_mutex);
+        conn->closed = true;  // No more re-arming by WebSocket senders
+    }
+    reactor.loop->remove(conn->socket.native_handle());
+    
+    std::lock_guard<std::mutex> lock(reactor.connections_mutex);
+    {
+        std::lock_guard<std::mutex> timers_lock(reactor.timers_mutex);
+        reactor.timers.cancel(conn->timer);
+    }
+    if (reactor.connections.erase(conn.get()) > 0) {
+        active_connections_--;
+    }
+}
+
+void Server::park(Reactor& reactor, const std::shared_ptr<Connection>& conn, uint32_t events) {
+    // Arming the timeout and giving the connection up happen together
+    // under arm_mutex, which expireConnection() takes too
+    std::lock_guard<std::mutex> lock(conn->arm_mutex);
+    if (conn->closed) {
+        return;  // Dropped by a stopping reactor
+    }
+    auto deadline = readDeadline(*conn);
+    if (conn->ws) {
+        // Pinged halfway through the idle timeout, closed at its end
+        deadline = conn->last_activity + std::chrono::milliseconds(std::max(options_.websocket.idle_timeout_ms, 1)) / 2;
+    }
+    {
+        std::lock_guard<std::mutex> timers_lock(reactor.timers_mutex);
+        reactor.timers.schedule(conn->timer, deadline, conn.get());
+    }
+    conn->busy = false;
+    reactor.loop->rearm(conn->socket.native_handle(), events, conn.get());
+}
+
+void Server::watchHandler(Reactor& reactor, Connection& conn) {
+    // While a worker owns the connection there is nothing to read, so its
+    // timer watches the handler instead (or rests)
+    std::lock_guard<std::mutex> lock(reactor.timers_mutex);
+    if (options_.handler_timeout_ms > 0) {
+        reactor.timers.schedule(conn.timer, handlerDeadline(), &conn);
+    } else {
+        reactor.timers.cancel(conn.timer);
+    }
+}
+
+void Server::fireTimers(Reactor& reactor) {
+    // Collected under the lock, handled outside it: closing takes other locks
+    static thread_local std::vector<std::shared_ptr<Connection>> expired;
+    {
+        std::lock_guard<std::mutex> lock(reactor.timers_mutex);
+        reactor.timers.advance(std::chrono::steady_clock::now(), [](utils::TimerWheel::Timer& timer) {
+            // Still registered: closeConnection() cancels the timer first
+            expired.push_back(static_cast<Connection*>(timer.data)->shared_from_this());
+        });
+    }
+    for (auto& conn : expired) {
+        expireConnection(reactor, conn);
+    }
+    expired.clear();
+}
+
+void Server::expireConnection(Reactor& reactor, const std::shared_ptr<Connection>& conn) {
+    bool ping = false;
+    {
+        std::lock_guard<std::mutex> lock(conn->arm_mutex);
+        std::lock_guard<std::mutex> timers_lock(reactor.timers_mutex);
+        if (conn->closed || conn->timer.scheduled()) {
+            return;  // Closed, or re-armed since it fired
+        }
+        if (conn->busy) {
+            utils::logWarn(std::format("Request from {} still running after the {} ms handler timeout", 
+                                      conn->address.toString(), options_.handler_timeout_ms));
+            return;
+        }
+        if (conn->ws) {
+            auto timeout = std::chrono::milliseconds(std::max(options_.websocket.idle_timeout_ms, 1));
+            if (std::chrono::steady_clock::now() - conn->last_activity < timeout) {
+                reactor.timers.schedule(conn->timer, conn->last_activity + timeout, conn.get());
+                ping = true;
+            }
+        }
+    }
+    
+    // Outside arm_mutex: a ping that has to queue re-arms the connection
+    if (ping) {
+        conn->ws->ping();
+        return;
+    }
+    
+    if (auto* tls = conn->socket.tls(); tls && !tls->established()) {
+        metrics_.tls_handshake_failures.add();
+    } else if (midRequest(*conn)) {
+        metrics_.read_timeouts.add();
+    }
+    closeConnection(reactor, conn);
+}
+
+void Server::parkWebSocket(Reactor& reactor, const std::shared_ptr<Connection>& conn) {
+    auto& ws = *conn->ws;
+    if (ws.done()) {
+        closeConnection(reactor, conn);
+        return;
+    }
+    
+    // A send from another thread that had to queue arms the connection
+    // for writing, unless a worker owns it (which re-arms below)
+    if (!ws.hasWriteWaiter()) {
+        ws.setWriteWaiter([&reactor, weak = std::weak_ptr<Connection>(conn)] {
+            auto locked = weak.lock();
+            if (!locked) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(locked->arm_mutex);
+            if (locked->closed || locked->busy) {
+                return;
+            }
+            try {
+                reactor.loop->rearm(locked->socket.native_handle(), 
+                                    net::IoEvent::Read | net::IoEvent::Write, locked.get());
+            } catch (const std::exception&) {
+                // Being closed; its timeout or the owner drops it
+            }
+        });
+    }
+    
+    park(reactor, conn, ws.wantsWrite() ? net::IoEvent::Read | net::IoEvent::Write : net::IoEvent::Read);
+}
+
+// ========== COROUTINE REQUESTS ==========
+
+void Server::PoolExecutor::post(std::coroutine_handle<> handle) {
+    pool->post([this, handle] {
+        coro::ExecutorScope scope(this);
+        handle.resume();
+    });
+}
+
+bool Server::needsAsync(const http::HTTPRequest& request) const noexcept {
+    return pipeline_.async() || router_.isAsync(request.getMethod(), request.getPath());
+}
+
+coro::Executor* Server::executorFor(const Reactor& reactor) noexcept {
+    // Shared-nothing loops have no pool; their coroutines resume on the I/O thread
+    return reactor.serve_inline ? nullptr : &pool_executor_;
+}
+
+Server::Progress Server::serveReady(Reactor& reactor, const std::shared_ptr<Connection>& conn) {
+    if (!serveBuffered(*conn)) {
+        return Progress::Close;
+    }
+    while (conn->pending) {
+        auto progress = runPending(reactor, conn);
+        if (progress != Progress::Continue) {
+            return progress;
+        }
+        if (!serveBuffered(*conn)) {
+            return Progress::Close;
+        }
+    }
+    return Progress::Continue;
+}
+
+Server::Progress Server::runPending(Reactor& reactor, const std::shared_ptr<Connection>& conn) {
+    AsyncRequest* pending = conn->pending.get();
+    
+    // Runs here until the first wait that cannot complete at once
+    {
+        coro::ExecutorScope scope(executorFor(reactor));
+        coro::spawn(async_pipeline_.runAsync(*pending->context), 
+            [this, &reactor, conn, pending](std::exception_ptr error) {
+                pending->error = error;
+                if (pending->handoff.exchange(true, std::memory_order_acq_rel)) {
+                    completePending(reactor, conn);
+                }
+            });
+    }
+    
+    if (!pending->handoff.exchange(true, std::memory_order_acq_rel)) {
+        return Progress::Parked;  // The completion finishes the request
+    }
+    return finishPending(*conn) ? Progress::Continue : Progress::Close;
+}
+
+bool Server::finishPending(Connection& conn) {
+    auto pending = std::move(conn.pending);
+    if (pending->error) {
+        std::rethrow_exception(pending->error);  // Like a throwing plain handler: the connection closes
+    }
+    
+    conn.upgrade = pending->context->takeWebSocket();
+    bool keep_alive = finishRequest(conn, conn.parser.request(), *pending->response, 
+                                    pending->context->route(), pending->started);
+    recycleAsyncRequest(std::move(pending));
+    conn.last_activity = std::chrono::steady_clock::now();
+    
+    if (!keep_alive) {
+        return false;
+    }
+    conn.parser.next();
+    conn.continue_sent = false;
+    return true;
+}
+
+void Server::completePending(Reactor& reactor, const std::shared_ptr<Connection>& conn) {
+    try {
+        auto progress = finishPending(*conn) ? serveReady(reactor, conn) : Progress::Close;
+        if (progress == Progress::Parked) {
+            return;
+        }
+        if (progress == Progress::Close) {
+            closeConnection(reactor, conn);
+            return;
+        }
+    } catch (const std::exception& e) {
+        utils::logError(std::format("Error handling client {}: {}", 
+                                   conn->address.toString(), e.what()));
+        closeConnection(reactor, conn);
+        return;
+    }
+    
+    // A request that outlived stop() has no loop to go back to
+    if (!running_) {
+        closeConnection(reactor, conn);
+        return;
+    }
+    
+    // Back to reading, as after any other request
+    onReadable(reactor, conn);
+}
+
+RouteInfo* Server::processRequest(const http::HTTPRequest& request, http::HTTPResponse& response,
+                                  std::pmr::memory_resource* arena, Connection* conn) {
+    Context ctx(request, response, arena);
+    ctx.setIo(&io_);
+    ctx.setDeadline(handlerDeadline());
+    
+    // Execute middleware pipeline + router
+    if (has_async_ && needsAsync(request)) {
+        coro::syncWait(async_pipeline_.runAsync(ctx));
+    } else {
+        pipeline_.run(ctx);
+    }
+    
+    // A stream() route whose body came in with the headers (or was empty)
+    if (auto* stream = ctx.bodyStream()) {
+        auto body = request.getBody();
+        stream->onEnd(ctx, body.empty() || stream->onData(body));
+    }
+    
+    // An accepted WebSocket upgrade goes with the connection; HTTP/2
+    // streams (no connection) have no upgrade, and the router refuses them
+    if (auto listener = ctx.takeWebSocket(); listener && conn) {
+        conn->upgrade = std::move(listener);
+    }
+    return ctx.route();
+}
+
+std::string Server::renderTrace() const {
+    return tracer_.renderChromeTrace();
+}
+
+std::string Server::renderMetrics() const {
+    std::string out;
+    out.reserve(16 * 1024);
+    
+    metrics_.requests.writePrometheus(out, "frqs_http_requests_total", "HTTP requests served");
+    metrics_.parse_errors.writePrometheus(out, "frqs_http_parse_errors_total", 
+                                          "Requests rejected by the parser");
+    metrics_.read_timeouts.writePrometheus(out, "frqs_http_read_timeouts_total", 
+                                           "Connections closed waiting for request headers or body");
+    metrics_.handler_timeouts.writePrometheus(out, "frqs_http_handler_timeouts_total", 
+                                              "Requests whose handler ran past the handler timeout");
+    metrics_.connections_accepted.writePrometheus(out, "frqs_connections_accepted_total", 
+                                                  "Client connections accepted");
+    metrics_.connections_rejected.writePrometheus(out, "frqs_connections_rejected_total", 
+                                                  "Client connections refused by the IP filter");
+    metrics_.requests_shed.writePrometheus(out, "frqs_http_requests_shed_total", 
+                                           "Requests answered 503 by admission control");
+    metrics_.accept_pauses.writePrometheus(out, "frqs_accept_pauses_total", 
+                                           "Times accepting paused on a full worker queue");
+    if (options_.tls) {
+        metrics_.tls_handshakes.writePrometheus(out, "frqs_tls_handshakes_total", 
+                                                "TLS handshakes completed");
+        metrics_.tls_handshake_failures.writePrometheus(out, "frqs_tls_handshake_failures_total", 
+                                                        "TLS handshakes that failed or timed out");
+        metrics_.tls_resumed.writePrometheus(out, "frqs_tls_sessions_resumed_total", 
+                                             "TLS handshakes that resumed a session");
+        metrics_.tls_kernel_offload.writePrometheus(out, "frqs_tls_kernel_offload_total", 
+                                                    "TLS connections encrypted by the kernel (kTLS)");
+    }
+    metrics_.http2_connections.writePrometheus(out, "frqs_http2_connections_total", 
+                                               "Client connections that switched to HTTP/2");
+    metrics_.websocket_connections.writePrometheus(out, "frqs_websocket_connections_total", 
+                                                   "Client connections upgraded to WebSocket");
+    metrics_.bytes_received.writePrometheus(out, "frqs_bytes_received_total", "Bytes read from clients");
+    metrics_.bytes_sent.writePrometheus(out, "frqs_bytes_sent_total", "Bytes written to clients");
+    
+    out += std::format("# HELP frqs_connections_active Open client connections\n"
+                       "# TYPE frqs_connections_active gauge\n"
+                       "frqs_connections_active {}\n", active_connections_.load());
+    out += std::format("# HELP frqs_worker_queue_depth Tasks waiting for a worker thread\n"
+                       "# TYPE frqs_worker_queue_depth gauge\n"
+                       "frqs_worker_queue_depth {}\n", thread_pool_ ? thread_pool_->pendingTasks() : 0);
+    if (admission_.enabled()) {
+        out += std::format("# HELP frqs_admission_limit Adaptive limit on tasks in flight\n"
+                           "# TYPE frqs_admission_limit gauge\n"
+                           "frqs_admission_limit {}\n"
+                           "# HELP frqs_admission_in_flight Worker tasks queued or running\n"
+                           "# TYPE frqs_admission_in_flight gauge\n"
+                           "frqs_admission_in_flight {}\n", admission_.limit(), admission_.inFlight());
+    }
+    
+    out += "# HELP frqs_http_request_duration_seconds Request latency by status class\n"
+           "# TYPE frqs_http_request_duration_seconds histogram\n";
+    for (size_t i = 0; i < metrics_.latency_by_class.size(); ++i) {
+        metrics_.latency_by_class[i].writePrometheus(out, "frqs_http_request_duration_seconds", 
+                                                     std::format("class=\"{}xx\"", i + 1));
+    }
+    
+    out += "# HELP frqs_http_route_duration_seconds Request latency by matched route\n"
+           "# TYPE frqs_http_route_duration_seconds histogram\n";
+    router_.forEachRoute([&out](const RouteInfo& route) {
+        // Label values escape backslash, quote and newline
+        std::string pattern;
+        for (char c : route.pattern) {
+            if (c == '\\' || c == '"') pattern += '\\';
+            if (c == '\n') { pattern += "\\n"; continue; }
+            pattern += c;
+        }
+        route.latency.writePrometheus(out, "frqs_http_route_duration_seconds",
+            std::format("method=\"{}\",route=\"{}\"", http::methodToString(route.method), pattern));
+    });
+    
+    return out;
+}
+
+void Server::routeOrNotFound(Context& ctx) {
+    if (!router_.route(ctx)) {
+        // No route found - 404
+        ctx.status(404)
+           .header("Content-Type", "text/html")
+           .body("<h1>404 - Not Found</h1><p>The requested resource was not found.</p>");
+    }
+}
+
+coro::Task<> Server::routeOrNotFoundAsync(Context& ctx) {
+    bool found = co_await router_.routeAsync(ctx);
+    if (!found) {
+        ctx.status(404)
+           .header("Content-Type", "text/html")
+           .body("<h1>404 - Not Found</h1><p>The requested resource was not found.</p>");
+    }
 }
 
 } // namespace frqs::core
\ No newline at end of file
@@ -0,0 +1,369 @@
+/**
+ * @file core/websocket.cpp
+ * @brief WebSocket send queue, message dispatch and broadcast groups
+ * @version 1.1.1
+ * @copyright Copyright (c) 2025
+ */
+
+#include "core/websocket.hpp"
+#include "utils/logger.hpp"
+#include <array>
+#include <format>
+
+namespace frqs::core {
+
+namespace {
+
+WebSocket::Frame controlFrame(http::WsOpcode opcode, std::string_view payload) {
+    return std::make_shared<const std::string>(http::encodeWebSocketFrame(opcode, payload));
+}
+
+WebSocket::Frame closeFrame(uint16_t code, std::string_view reason) {
+    // Control payloads are at most 125 bytes: the code and 123 of reason
+    std::string payload;
+    payload += static_cast<char>(code >> 8);
+    payload += static_cast<char>(code & 0xFF);
+    payload += reason.substr(0, 123);
+    return controlFrame(http::WsOpcode::Close, payload);
+}
+
+} // namespace
+
+WebSocket::Frame WebSocket::makeFrame(std::string_view payload, bool binary) {
+    return std::make_shared<const std::string>(
+        http::encodeWebSocketFrame(binary ? http::WsOpcode::Binary : http::WsOpcode::Text, payload));
+}
+
+WebSocket::WebSocket(net::Socket& socket, const net::SockAddr& address, std::unique_ptr<WebSocketListener> listener,
+                     const WebSocketOptions& options, utils::Counter* bytes_sent)
+    : address_(address)
+    , listener_(std::move(listener))
+    , options_(options)
+    , bytes_sent_(bytes_sent)
+    , parser_(options.max_message_bytes)
+    , socket_(&socket)
+{
+}
+
+// ========== SENDING ==========
+
+bool WebSocket::sendText(std::string_view text) {
+    return send(makeFrame(text, false));
+}
+
+bool WebSocket::sendBinary(std::string_view data) {
+    return send(makeFrame(data, true));
+}
+
+bool WebSocket::send(Frame frame) {
+    if (!frame || !isOpen()) {
+        return false;
+    }
+    return enqueue(std::move(frame), false);
+}
+
+void WebSocket::close(uint16_t code, std::string_view reason) {
+    sendClose(code, reason);
+}
+
+void WebSocket::ping() {
+    if (!ping_sent_.exchange(true, std::memory_order_relaxed)) {
+        enqueue(controlFrame(http::WsOpcode::Ping, {}), true);
+    }
+}
+
+void WebSocket::sendClose(uint16_t code, std::string_view reason) {
+    auto frame = closeFrame(code, reason);
+    
+    std::function<void()> waiter;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!socket_ || failed_ || close_sent_) {
+            return;
+        }
+        close_sent_ = true;
+        open_.store(false, std::memory_order_release);
+        
+        queue_.push_back({std::move(frame), 0});
+        queued_bytes_.fetch_add(queue_.back().frame->size(), std::memory_order_release);
+        if (writeLocked() && !queue_.empty() && !write_waiting_ && write_waiter_) {
+            write_waiting_ = true;
+            waiter = write_waiter_;
+        }
+    }
+    if (waiter) {
+        waiter();
+    }
+}
+
+bool WebSocket::enqueue(Frame frame, bool control) {
+    // Called outside the lock: the waiter may drop the last reference to
+    // the connection, which detaches this socket
+    std::function<void()> waiter;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!socket_ || failed_ || close_sent_) {
+            return false;
+        }
+        
+        size_t size = frame->size();
+        if (!control && queued_bytes_.load(std::memory_order_relaxed) + size > options_.max_queued_bytes) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        
+        queue_.push_back({std::move(frame), 0});
+        queued_bytes_.fetch_add(size, std::memory_order_release);
+        if (!writeLocked()) {
+            return false;
+        }
+        if (!queue_.empty() && !write_waiting_ && write_waiter_) {
+            write_waiting_ = true;
+            waiter = write_waiter_;
+        }
+    }
+    if (waiter) {
+        waiter();
+    }
+    return true;
+}
+
+bool WebSocket::writeLocked() {
+    // A TLS write that would block must be retried with the same bytes, so
+    // behind OpenSSL frames go out one at a time; new ones may be queued
+    // before the retry
+    const auto* tls = socket_->tls();
+    const size_t limit = tls && !tls->sendsInKernel() ? 1 : net::Socket::MAX_IOV;
+    std::array<std::string_view, net::Socket::MAX_IOV> parts;
+    
+    while (!queue_.empty()) {
+        size_t count = 0;
+        for (const auto& queued : queue_) {
+            parts[count++] = std::string_view(*queued.frame).substr(queued.offset);
+            if (count == limit) {
+                break;
+            }
+        }
+        
+        std::optional<size_t> sent;
+        try {
+            sent = socket_->trySendv({parts.data(), count});
+        } catch (const std::exception&) {
+            // Client went away; the owner closes the connection
+            failed_ = true;
+            open_.store(false, std::memory_order_release);
+            queue_.clear();
+            queued_bytes_.store(0, std::memory_order_release);
+            return false;
+        }
+        if (!sent || *sent == 0) {
+            return true;  // Send buffer full
+        }
+        
+        if (bytes_sent_) {
+            bytes_sent_->add(*sent);
+        }
+        queued_bytes_.fetch_sub(*sent, std::memory_order_release);
+        for (size_t left = *sent; left > 0;) {
+            auto& front = queue_.front();
+            size_t rest = front.frame->size() - front.offset;
+            if (left < rest) {
+                front.offset += left;
+                break;
+            }
+            left -= rest;
+            queue_.pop_front();
+        }
+    }
+    return true;
+}
+
+// ========== SERVER SIDE ==========
+
+void WebSocket::open() {
+    if (listener_) {
+        listener_->onOpen(shared_from_this());
+    }
+}
+
+std::optional<size_t> WebSocket::tryReceive(std::span<char> out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!socket_) {
+        return 0;
+    }
+    return socket_->tryReceive(out.data(), out.size());
+}
+
+bool WebSocket::process() {
+    ping_sent_.store(false, std::memory_order_relaxed);
+    
+    http::WebSocketParser::Message message;
+    while (!close_received_) {
+        auto status = parser_.next(message);
+        if (status == http::WebSocketParser::Status::NeedMore) {
+            break;
+        }
+        
+        if (status == http::WebSocketParser::Status::Error) {
+            utils::logWarn(std::format("Invalid WebSocket frame from {}: {}",
+                                      address_.toString(), parser_.error()));
+            close_code_ = parser_.errorCode();
+            close_received_ = true;  // Nothing after it is read
+            sendClose(parser_.errorCode(), parser_.error());
+            break;
+        }
+        
+        switch (message.opcode) {
+            case http::WsOpcode::Text:
+            case http::WsOpcode::Binary:
+                if (listener_) {
+                    listener_->onMessage(*this, message.payload, message.opcode == http::WsOpcode::Binary);
+                }
+                break;
+            
+            case http::WsOpcode::Ping:
+                enqueue(controlFrame(http::WsOpcode::Pong, message.payload), true);
+                break;
+            
+            case http::WsOpcode::Close: {
+                close_received_ = true;
+                close_code_ = http::WsCloseCode::NoStatus;
+                if (message.payload.size() >= 2) {
+                    close_code_ = static_cast<uint16_t>(static_cast<uint8_t>(message.payload[0]) << 8 |
+                                                        static_cast<uint8_t>(message.payload[1]));
+                }
+                // Echo the code; a no-op if this side started the close
+                sendClose(close_code_ == http::WsCloseCode::NoStatus ? http::WsCloseCode::Normal : close_code_, {});
+                break;
+            }
+            
+            default:
+                break;  // Pong
+        }
+    }
+    return !done();
+}
+
+bool WebSocket::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_waiting_ = false;
+    if (!socket_ || failed_) {
+        return false;
+    }
+    return writeLocked();
+}
+
+bool WebSocket::done() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !socket_ || failed_ || (close_sent_ && close_received_ && queue_.empty());
+}
+
+void WebSocket::setWriteWaiter(std::function<void()> waiter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_waiter_ = std::move(waiter);
+}
+
+bool WebSocket::hasWriteWaiter() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<bool>(write_waiter_);
+}
+
+void WebSocket::detach() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!socket_) {
+            return;
+        }
+        
+        // Tell a client that is still there why the connection ends, if a
+        // frame is not half sent
+        if (!close_sent_ && !failed_ && queue_.empty()) {
+            auto frame = http::encodeWebSocketFrame(http::WsOpcode::Close,
+                std::string_view("\x03\xE9", 2));  // 1001 Going Away
+            try {
+                (void)socket_->trySend(frame.data(), frame.size());
+            } catch (const std::exception&) {
+                // Gone already
+            }
+        }
+        
+        socket_ = nullptr;
+        open_.store(false, std::memory_order_release);
+        queue_.clear();
+        queued_bytes_.store(0, std::memory_order_release);
+        write_waiter_ = nullptr;
+    }
+    
+    // Dropping the listener also breaks a cycle through a socket it kept
+    auto listener = std::move(listener_);
+    if (listener) {
+        try {
+            listener->onClose(*this, close_code_);
+        } catch (const std::exception& e) {
+            utils::logError(std::format("WebSocket onClose for {} threw: {}", address_.toString(), e.what()));
+        }
+    }
+}
+
+// ========== BROADCAST ==========
+
+void WebSocketGroup::add(std::shared_ptr<WebSocket> socket) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto members = std::make_shared<Members>(*members_);
+    members->push_back(std::move(socket));
+    members_ = std::move(members);
+}
+
+void WebSocketGroup::remove(const WebSocket& socket) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto members = std::make_shared<Members>();
+    members->reserve(members_->size());
+    for (const auto& member : *members_) {
+        if (member.get() != &socket) {
+            members->push_back(member);
+        }
+    }
+    members_ = std::move(members);
+}
+
+size_t WebSocketGroup::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return members_->size();
+}
+
+size_t WebSocketGroup::broadcast(std::string_view payload, bool binary) {
+    return broadcast(WebSocket::makeFrame(payload, binary));
+}
+
+size_t WebSocketGroup::broadcast(const WebSocket::Frame& frame) {
+    std::shared_ptr<const Members> members;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        members = members_;
+    }
+    
+    size_t accepted = 0;
+    bool closed = false;
+    for (const auto& member : *members) {
+        if (member->send(frame)) {
+            ++accepted;
+        } else if (!member->isOpen()) {
+            closed = true;
+        }
+    }
+    
+    if (closed) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto live = std::make_shared<Members>();
+        live->reserve(members_->size());
+        for (const auto& member : *members_) {
+            if (member->isOpen()) {
+                live->push_back(member);
+            }
+        }
+        members_ = std::move(live);
+    }
+    return accepted;
+}
+
+} // namespace frqs::core
@@ -0,0 +1,191 @@
+/**
+ * @file http/compression.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Content-Encoding negotiation and gzip/brotli encoders
+ * @version 1.0.0
+ * @date 2025-12-15
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "http/compression.hpp"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+
+#ifdef FRQS_HAVE_ZLIB
+    #include <zlib.h>
+#endif
+
+#ifdef FRQS_HAVE_BROTLI
+    #include <brotli/encode.h>
+#endif
+
+namespace frqs::http {
+
+namespace {
+
+std::string_view trim(std::string_view s) noexcept {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) noexcept {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+        [](char ca, char cb) {
+            return std::tolower(static_cast<unsigned char>(ca)) == 
+                   std::tolower(static_cast<unsigned char>(cb));
+        });
+}
+
+// q-value in thousandths (RFC 9110 "qvalue"); malformed values count as 1
+int parseQuality(std::string_view params) noexcept {
+    while (!params.empty()) {
+        auto semi = params.find(';');
+        auto param = trim(params.substr(0, semi));
+        
+        if (param.size() >= 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+            auto value = param.substr(2);
+            if (value.empty() || (value[0] != '0' && value[0] != '1')) return 1000;
+            
+            int quality = (value[0] - '0') * 1000;
+            if (value.size() > 2 && value[1] == '.') {
+                int scale = 100;
+                for (char c : value.substr(2, 3)) {
+                    if (c < '0' || c > '9') break;
+                    quality += (c - '0') * scale;
+                    scale /= 10;
+                }
+            }
+            return std::min(quality, 1000);
+        }
+        
+        if (semi == std::string_view::npos) break;
+        params.remove_prefix(semi + 1);
+    }
+    return 1000;
+}
+
+} // namespace
+
+bool encoderAvailable(ContentEncoding encoding) noexcept {
+    switch (encoding) {
+        case ContentEncoding::Identity: return true;
+#ifdef FRQS_HAVE_ZLIB
+        case ContentEncoding::Gzip: return true;
+#endif
+#ifdef FRQS_HAVE_BROTLI
+        case ContentEncoding::Brotli: return true;
+#endif
+        default: return false;
+    }
+}
+
+ContentEncoding negotiateEncoding(std::string_view accept_encoding, 
+                                  bool allow_gzip, bool allow_brotli) noexcept {
+    int gzip_q = -1;
+    int brotli_q = -1;
+    int wildcard_q = -1;
+    
+    while (!accept_encoding.empty()) {
+        auto comma = accept_encoding.find(',');
+        auto item = trim(accept_encoding.substr(0, comma));
+        
+        auto semi = item.find(';');
+        auto coding = trim(item.substr(0, semi));
+        int quality = semi == std::string_view::npos ? 1000 : parseQuality(item.substr(semi + 1));
+        
+        if (equalsIgnoreCase(coding, "gzip") || equalsIgnoreCase(coding, "x-gzip")) {
+            gzip_q = quality;
+        } else if (equalsIgnoreCase(coding, "br")) {
+            brotli_q = quality;
+        } else if (coding == "*") {
+            wildcard_q = quality;
+        }
+        
+        if (comma == std::string_view::npos) break;
+        accept_encoding.remove_prefix(comma + 1);
+    }
+    
+    // Codings not listed explicitly inherit the wildcard's preference
+    if (gzip_q < 0) gzip_q = wildcard_q;
+    if (brotli_q < 0) brotli_q = wildcard_q;
+    
+    if (!allow_gzip) gzip_q = 0;
+    if (!allow_brotli) brotli_q = 0;
+    
+    if (brotli_q > 0 && brotli_q >= gzip_q) return ContentEncoding::Brotli;
+    if (gzip_q > 0) return ContentEncoding::Gzip;
+    return ContentEncoding::Identity;
+}
+
+std::optional<std::string> compress(std::string_view data, ContentEncoding encoding, int level) {
+    switch (encoding) {
+#ifdef FRQS_HAVE_ZLIB
+        case ContentEncoding::Gzip: {
+            if (data.size() > UINT_MAX) return std::nullopt;
+            
+            z_stream stream{};
+            // windowBits 15 + 16 selects the gzip wrapper
+            if (deflateInit2(&stream, std::clamp(level, 1, 9), Z_DEFLATED, 15 + 16, 8, 
+                             Z_DEFAULT_STRATEGY) != Z_OK) {
+                return std::nullopt;
+            }
+            
+            std::string out(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+            stream.avail_in = static_cast<uInt>(data.size());
+            stream.next_out = reinterpret_cast<Bytef*>(out.data());
+            stream.avail_out = static_cast<uInt>(out.size());
+            
+            int rc = deflate(&stream, Z_FINISH);
+            out.resize(stream.total_out);
+            deflateEnd(&stream);
+            
+            if (rc != Z_STREAM_END) return std::nullopt;
+            return out;
+        }
+#endif
+#ifdef FRQS_HAVE_BROTLI
+        case ContentEncoding::Brotli: {
+            size_t encoded_size = BrotliEncoderMaxCompressedSize(data.size());
+            if (encoded_size == 0) return std::nullopt;
+            
+            std::string out(encoded_size, '\0');
+            if (!BrotliEncoderCompress(std::clamp(level, 0, 11), BROTLI_DEFAULT_WINDOW, 
+                                       BROTLI_MODE_GENERIC, data.size(),
+                                       reinterpret_cast<const uint8_t*>(data.data()),
+                                       &encoded_size, reinterpret_cast<uint8_t*>(out.data()))) {
+                return std::nullopt;
+            }
+            out.resize(encoded_size);
+            return out;
+        }
+#endif
+        default:
+            (void)data;
+            (void)level;
+            return std::nullopt;
+    }
+}
+
+std::string encodedEtag(std::string_view etag, ContentEncoding encoding) {
+    std::string suffix;
+    if (encoding != ContentEncoding::Identity) {
+        suffix = "-";
+        suffix += encodingToken(encoding);
+    }
+    
+    // Keep the suffix inside the quotes: "abc" -> "abc-gzip"
+    if (etag.size() >= 2 && etag.back() == '"') {
+        std::string out(etag.substr(0, etag.size() - 1));
+        out += suffix;
+        out += '"';
+        return out;
+    }
+    return std::string(etag) + suffix;
+}
+
+} // namespace frqs::http
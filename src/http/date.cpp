@@ -0,0 +1,101 @@
+/**
+ * @file http/date.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief HTTP-date formatting and parsing
+ * @version 1.0.0
+ * @date 2025-12-15
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "http/date.hpp"
+#include <array>
+
+namespace frqs::http {
+
+namespace {
+
+constexpr std::array<std::string_view, 7> DAYS = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+constexpr std::array<std::string_view, 12> MONTHS = {
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+
+void appendTwoDigits(std::string& out, unsigned value) {
+    out += static_cast<char>('0' + value / 10);
+    out += static_cast<char>('0' + value % 10);
+}
+
+bool parseDigits(std::string_view text, size_t pos, size_t count, int& out) noexcept {
+    out = 0;
+    for (size_t i = 0; i < count; ++i) {
+        char c = text[pos + i];
+        if (c < '0' || c > '9') return false;
+        out = out * 10 + (c - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+std::string formatHttpDate(std::chrono::system_clock::time_point time) {
+    using namespace std::chrono;
+    
+    auto seconds = floor<std::chrono::seconds>(time);
+    auto day = floor<days>(seconds);
+    year_month_day ymd{day};
+    hh_mm_ss hms{seconds - day};
+    weekday wd{day};
+    
+    std::string out;
+    out.reserve(29);
+    out += DAYS[wd.c_encoding()];
+    out += ", ";
+    appendTwoDigits(out, static_cast<unsigned>(ymd.day()));
+    out += ' ';
+    out += MONTHS[static_cast<unsigned>(ymd.month()) - 1];
+    out += ' ';
+    out += std::to_string(static_cast<int>(ymd.year()));
+    out += ' ';
+    appendTwoDigits(out, static_cast<unsigned>(hms.hours().count()));
+    out += ':';
+    appendTwoDigits(out, static_cast<unsigned>(hms.minutes().count()));
+    out += ':';
+    appendTwoDigits(out, static_cast<unsigned>(hms.seconds().count()));
+    out += " GMT";
+    return out;
+}
+
+std::optional<std::chrono::system_clock::time_point> parseHttpDate(std::string_view text) noexcept {
+    using namespace std::chrono;
+    
+    // "Sun, 06 Nov 1994 08:49:37 GMT"
+    //  0123456789012345678901234567
+    if (text.size() != 29 || text.substr(3, 2) != ", " || text[7] != ' ' || 
+        text[11] != ' ' || text[16] != ' ' || text[19] != ':' || text[22] != ':' ||
+        text.substr(25) != " GMT") {
+        return std::nullopt;
+    }
+    
+    int d = 0, y = 0, hh = 0, mm = 0, ss = 0;
+    if (!parseDigits(text, 5, 2, d) || !parseDigits(text, 12, 4, y) ||
+        !parseDigits(text, 17, 2, hh) || !parseDigits(text, 20, 2, mm) || 
+        !parseDigits(text, 23, 2, ss)) {
+        return std::nullopt;
+    }
+    
+    unsigned m = 0;
+    while (m < MONTHS.size() && MONTHS[m] != text.substr(8, 3)) ++m;
+    if (m == MONTHS.size() || hh > 23 || mm > 59 || ss > 60) {
+        return std::nullopt;
+    }
+    
+    year_month_day ymd{year{y}, month{m + 1}, day{static_cast<unsigned>(d)}};
+    if (!ymd.ok()) {
+        return std::nullopt;
+    }
+    
+    return sys_days{ymd} + hours{hh} + minutes{mm} + seconds{ss};
+}
+
+} // namespace frqs::http
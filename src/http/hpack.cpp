@@ -0,0 +1,570 @@
+/**
+ * @file http/hpack.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief HPACK header compression for HTTP/2 (RFC 7541)
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "http/hpack.hpp"
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace frqs::http::hpack {
+
+namespace {
+
+// ========== STATIC TABLE ==========
+
+struct StaticEntry {
+    std::string_view name ;
+    std::string_view value ;
+} ;
+
+constexpr std::array<StaticEntry, STATIC_TABLE_SIZE> STATIC_TABLE = {{
+    {":authority", ""},
+    {":method", "GET"},
+    {":method", "POST"},
+    {":path", "/"},
+    {":path", "/index.html"},
+    {":scheme", "http"},
+    {":scheme", "https"},
+    {":status", "200"},
+    {":status", "204"},
+    {":status", "206"},
+    {":status", "304"},
+    {":status", "400"},
+    {":status", "404"},
+    {":status", "500"},
+    {"accept-charset", ""},
+    {"accept-encoding", "gzip, deflate"},
+    {"accept-language", ""},
+    {"accept-ranges", ""},
+    {"accept", ""},
+    {"access-control-allow-origin", ""},
+    {"age", ""},
+    {"allow", ""},
+    {"authorization", ""},
+    {"cache-control", ""},
+    {"content-disposition", ""},
+    {"content-encoding", ""},
+    {"content-language", ""},
+    {"content-length", ""},
+    {"content-location", ""},
+    {"content-range", ""},
+    {"content-type", ""},
+    {"cookie", ""},
+    {"date", ""},
+    {"etag", ""},
+    {"expect", ""},
+    {"expires", ""},
+    {"from", ""},
+    {"host", ""},
+    {"if-match", ""},
+    {"if-modified-since", ""},
+    {"if-none-match", ""},
+    {"if-range", ""},
+    {"if-unmodified-since", ""},
+    {"last-modified", ""},
+    {"link", ""},
+    {"location", ""},
+    {"max-forwards", ""},
+    {"proxy-authenticate", ""},
+    {"proxy-authorization", ""},
+    {"range", ""},
+    {"referer", ""},
+    {"refresh", ""},
+    {"retry-after", ""},
+    {"server", ""},
+    {"set-cookie", ""},
+    {"strict-transport-security", ""},
+    {"transfer-encoding", ""},
+    {"user-agent", ""},
+    {"vary", ""},
+    {"via", ""},
+    {"www-authenticate", ""},
+}} ;
+
+// First static index carrying `name` (entries with one name are adjacent), 0 if none
+size_t staticNameIndex(std::string_view name) {
+    static const auto index = [] {
+        std::unordered_map<std::string_view, uint8_t> map ;
+        for (size_t i = STATIC_TABLE.size() ; i-- > 0 ;) {
+            map[STATIC_TABLE[i].name] = static_cast<uint8_t>(i + 1) ;
+        }
+        return map ;
+    }() ;
+    auto it = index.find(name) ;
+    return it == index.end() ? 0 : it->second ;
+}
+
+// ========== HUFFMAN TABLES ==========
+
+// Code length of each symbol, 256 = EOS. The code is canonical: codes
+// follow from the lengths, assigned in (length, symbol) order.
+constexpr std::array<uint8_t, 257> CODE_LENGTHS = {
+    13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+    28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    6, 10, 10, 12, 13, 6, 8, 11, 10, 10, 8, 11, 8, 6, 6, 6,
+    5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 8, 15, 6, 12, 10,
+    13, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 8, 13, 19, 13, 14, 6,
+    15, 5, 6, 5, 6, 5, 6, 6, 6, 5, 7, 7, 6, 6, 6, 5,
+    6, 7, 6, 5, 5, 6, 7, 7, 7, 7, 7, 15, 11, 14, 13, 28,
+    20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+    24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+    22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+    21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+    26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+    19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+    20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+    26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+    30,
+} ;
+
+constexpr unsigned EOS = 256 ;
+constexpr unsigned MAX_CODE_LENGTH = 30 ;
+
+// Codes up to this long decode with a single table lookup
+constexpr unsigned PRIMARY_BITS = 9 ;
+
+struct HuffmanTables {
+    std::array<uint32_t, 257> codes{} ;
+    std::array<uint16_t, 257> by_code{} ;                       // Symbols in code order
+    std::array<uint32_t, MAX_CODE_LENGTH + 1> first_code{} ;    // Per length
+    std::array<uint16_t, MAX_CODE_LENGTH + 1> first_rank{} ;    // Position in by_code
+    std::array<uint16_t, MAX_CODE_LENGTH + 1> count{} ;
+
+    // (symbol << 4) | length for codes of PRIMARY_BITS or fewer, 0 otherwise
+    std::array<uint16_t, 1u << PRIMARY_BITS> primary{} ;
+} ;
+
+constexpr HuffmanTables buildHuffmanTables() {
+    HuffmanTables t ;
+    for (unsigned symbol = 0 ; symbol <= EOS ; ++symbol) {
+        t.count[CODE_LENGTHS[symbol]]++ ;
+    }
+
+    uint32_t code = 0 ;
+    uint16_t rank = 0 ;
+    for (unsigned length = 1 ; length <= MAX_CODE_LENGTH ; ++length) {
+        t.first_code[length] = code ;
+        t.first_rank[length] = rank ;
+        for (unsigned symbol = 0 ; symbol <= EOS ; ++symbol) {
+            if (CODE_LENGTHS[symbol] == length) {
+                t.codes[symbol] = code++ ;
+                t.by_code[rank++] = static_cast<uint16_t>(symbol) ;
+            }
+        }
+        code <<= 1 ;
+    }
+
+    for (unsigned symbol = 0 ; symbol <= EOS ; ++symbol) {
+        unsigned length = CODE_LENGTHS[symbol] ;
+        if (length > PRIMARY_BITS) {
+            continue ;
+        }
+        // Every PRIMARY_BITS-bit pattern that starts with this code
+        uint32_t base = t.codes[symbol] << (PRIMARY_BITS - length) ;
+        for (uint32_t fill = 0 ; fill < (1u << (PRIMARY_BITS - length)) ; ++fill) {
+            t.primary[base + fill] = static_cast<uint16_t>((symbol << 4) | length) ;
+        }
+    }
+    return t ;
+}
+
+constexpr HuffmanTables HUFFMAN = buildHuffmanTables() ;
+
+// ========== PRIMITIVES (RFC 7541 §5) ==========
+
+void encodeInteger(std::string& out, uint8_t flags, unsigned prefix_bits, uint64_t value) {
+    uint64_t max_prefix = (1u << prefix_bits) - 1 ;
+    if (value < max_prefix) {
+        out.push_back(static_cast<char>(flags | value)) ;
+        return ;
+    }
+    out.push_back(static_cast<char>(flags | max_prefix)) ;
+    value -= max_prefix ;
+    while (value >= 128) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80)) ;
+        value >>= 7 ;
+    }
+    out.push_back(static_cast<char>(value)) ;
+}
+
+// Values past 2^32 are treated as malformed; nothing legitimate is that large
+bool decodeInteger(const uint8_t*& p, const uint8_t* end, unsigned prefix_bits, uint64_t& value) {
+    if (p == end) {
+        return false ;
+    }
+    uint64_t max_prefix = (1u << prefix_bits) - 1 ;
+    value = *p++ & max_prefix ;
+    if (value < max_prefix) {
+        return true ;
+    }
+    for (unsigned shift = 0 ; p != end ; shift += 7) {
+        uint8_t byte = *p++ ;
+        value += static_cast<uint64_t>(byte & 0x7F) << shift ;
+        if (value > UINT32_MAX) {
+            return false ;
+        }
+        if ((byte & 0x80) == 0) {
+            return true ;
+        }
+    }
+    return false ;
+}
+
+void encodeString(std::string& out, std::string_view data) {
+    size_t huffman = huffmanLength(data) ;
+    if (huffman < data.size()) {
+        encodeInteger(out, 0x80, 7, huffman) ;
+        huffmanEncode(data, out) ;
+    } else {
+        encodeInteger(out, 0x00, 7, data.size()) ;
+        out += data ;
+    }
+}
+
+bool decodeString(const uint8_t*& p, const uint8_t* end, std::string& out) {
+    if (p == end) {
+        return false ;
+    }
+    bool huffman = (*p & 0x80) != 0 ;
+    uint64_t length = 0 ;
+    if (!decodeInteger(p, end, 7, length) || length > static_cast<uint64_t>(end - p)) {
+        return false ;
+    }
+    std::string_view data(reinterpret_cast<const char*>(p), static_cast<size_t>(length)) ;
+    p += length ;
+    if (huffman) {
+        return huffmanDecode(data, out) ;
+    }
+    out += data ;
+    return true ;
+}
+
+} // namespace
+
+// ============================================================================
+// Huffman
+// ============================================================================
+
+size_t huffmanLength(std::string_view data) noexcept {
+    size_t bits = 0 ;
+    for (unsigned char c : data) {
+        bits += CODE_LENGTHS[c] ;
+    }
+    return (bits + 7) / 8 ;
+}
+
+void huffmanEncode(std::string_view data, std::string& out) {
+    uint64_t bits = 0 ;
+    unsigned pending = 0 ;      // Low bits of `bits` not written yet (< 8 between symbols)
+    for (unsigned char c : data) {
+        bits = (bits << CODE_LENGTHS[c]) | HUFFMAN.codes[c] ;
+        pending += CODE_LENGTHS[c] ;
+        while (pending >= 8) {
+            pending -= 8 ;
+            out.push_back(static_cast<char>(bits >> pending)) ;
+        }
+    }
+    if (pending > 0) {
+        // Pad with the most significant bits of EOS (all ones)
+        out.push_back(static_cast<char>((bits << (8 - pending)) | (0xFFu >> pending))) ;
+    }
+}
+
+bool huffmanDecode(std::string_view data, std::string& out) {
+    uint64_t bits = 0 ;         // Unconsumed bits, most significant first
+    unsigned available = 0 ;
+    size_t pos = 0 ;
+
+    while (true) {
+        while (available <= 56 && pos < data.size()) {
+            bits |= static_cast<uint64_t>(static_cast<uint8_t>(data[pos++])) << (56 - available) ;
+            available += 8 ;
+        }
+        if (available == 0) {
+            break ;
+        }
+
+        unsigned symbol = 0 ;
+        unsigned length = 0 ;
+        if (uint16_t entry = HUFFMAN.primary[bits >> (64 - PRIMARY_BITS)] ; entry != 0) {
+            symbol = entry >> 4 ;
+            length = entry & 0xF ;
+        } else {
+            for (unsigned l = PRIMARY_BITS + 1 ; l <= MAX_CODE_LENGTH && l <= available ; ++l) {
+                auto code = static_cast<uint32_t>(bits >> (64 - l)) ;
+                if (code - HUFFMAN.first_code[l] < HUFFMAN.count[l]) {
+                    symbol = HUFFMAN.by_code[HUFFMAN.first_rank[l] + code - HUFFMAN.first_code[l]] ;
+                    length = l ;
+                    break ;
+                }
+            }
+        }
+        if (length == 0 || length > available) {
+            break ;  // The rest is padding, checked below
+        }
+        if (symbol == EOS) {
+            return false ;
+        }
+
+        out.push_back(static_cast<char>(symbol)) ;
+        bits <<= length ;
+        available -= length ;
+    }
+
+    // Padding: fewer than 8 bits, all ones (a prefix of EOS)
+    if (available >= 8) {
+        return false ;
+    }
+    uint64_t mask = available == 0 ? 0 : ~uint64_t{0} << (64 - available) ;
+    return (bits & mask) == mask ;
+}
+
+// ============================================================================
+// Dynamic table
+// ============================================================================
+
+void DynamicTable::insert(std::string_view name, std::string_view value) {
+    size_t entry_size = name.size() + value.size() + ENTRY_OVERHEAD ;
+    inserted_++ ;
+
+    // An entry larger than the table empties it and is not added (§4.4)
+    if (entry_size > max_size_) {
+        entries_.clear() ;
+        size_ = 0 ;
+        return ;
+    }
+
+    // Copy before evicting: `name` may point into an entry that goes
+    Entry entry{std::string(name), std::string(value)} ;
+    evict(entry_size) ;
+    entries_.push_front(std::move(entry)) ;
+    size_ += entry_size ;
+}
+
+void DynamicTable::setMaxSize(size_t max_size) {
+    max_size_ = max_size ;
+    evict(0) ;
+}
+
+void DynamicTable::evict(size_t room) {
+    while (size_ + room > max_size_ && !entries_.empty()) {
+        const auto& oldest = entries_.back() ;
+        size_ -= oldest.name.size() + oldest.value.size() + ENTRY_OVERHEAD ;
+        entries_.pop_back() ;
+    }
+}
+
+// ============================================================================
+// Decoder
+// ============================================================================
+
+Decoder::Result Decoder::decode(std::string_view block, std::string& bytes,
+                                std::vector<Field>& fields, size_t max_list_size) {
+    auto* p = reinterpret_cast<const uint8_t*>(block.data()) ;
+    auto* end = p + block.size() ;
+    size_t list_size = 0 ;
+    bool too_large = false ;
+    bool field_seen = false ;
+
+    // Records the field appended at [name_start, ...) or drops it once over the limit
+    auto emit = [&](size_t name_start, size_t name_length) {
+        field_seen = true ;
+        size_t value_length = bytes.size() - name_start - name_length ;
+        list_size += name_length + value_length + ENTRY_OVERHEAD ;
+        if (too_large || list_size > max_list_size) {
+            too_large = true ;
+            bytes.resize(name_start) ;
+            return ;
+        }
+        fields.push_back({static_cast<uint32_t>(name_start), static_cast<uint32_t>(name_length),
+                          static_cast<uint32_t>(name_start + name_length), static_cast<uint32_t>(value_length)}) ;
+    } ;
+
+    // Name of a literal: indexed (static or dynamic) or a string
+    auto appendName = [&](uint64_t index) {
+        if (index == 0) {
+            return decodeString(p, end, bytes) ;
+        }
+        if (index <= STATIC_TABLE_SIZE) {
+            bytes += STATIC_TABLE[index - 1].name ;
+            return true ;
+        }
+        const auto* entry = table_.get(index - STATIC_TABLE_SIZE) ;
+        if (!entry) {
+            return false ;
+        }
+        bytes += entry->name ;
+        return true ;
+    } ;
+
+    while (p < end) {
+        uint8_t first = *p ;
+        size_t start = bytes.size() ;
+
+        if (first & 0x80) {
+            // Indexed field
+            uint64_t index = 0 ;
+            if (!decodeInteger(p, end, 7, index) || index == 0) {
+                return Result::Malformed ;
+            }
+            if (index <= STATIC_TABLE_SIZE) {
+                bytes += STATIC_TABLE[index - 1].name ;
+                bytes += STATIC_TABLE[index - 1].value ;
+                emit(start, STATIC_TABLE[index - 1].name.size()) ;
+            } else {
+                const auto* entry = table_.get(index - STATIC_TABLE_SIZE) ;
+                if (!entry) {
+                    return Result::Malformed ;
+                }
+                bytes += entry->name ;
+                bytes += entry->value ;
+                emit(start, entry->name.size()) ;
+            }
+            continue ;
+        }
+
+        if ((first & 0xE0) == 0x20) {
+            // Table size update: only before the first field, within our limit
+            uint64_t size = 0 ;
+            if (field_seen || !decodeInteger(p, end, 5, size) || size > limit_) {
+                return Result::Malformed ;
+            }
+            table_.setMaxSize(static_cast<size_t>(size)) ;
+            continue ;
+        }
+
+        // Literal: with incremental indexing (01), without (0000) or never indexed (0001)
+        bool indexed = (first & 0xC0) == 0x40 ;
+        uint64_t name_index = 0 ;
+        if (!decodeInteger(p, end, indexed ? 6 : 4, name_index) || !appendName(name_index)) {
+            return Result::Malformed ;
+        }
+        size_t name_length = bytes.size() - start ;
+        if (!decodeString(p, end, bytes)) {
+            return Result::Malformed ;
+        }
+        if (indexed) {
+            std::string_view field(bytes.data() + start, bytes.size() - start) ;
+            table_.insert(field.substr(0, name_length), field.substr(name_length)) ;
+        }
+        emit(start, name_length) ;
+    }
+
+    return too_large ? Result::TooLarge : Result::Ok ;
+}
+
+// ============================================================================
+// Encoder
+// ============================================================================
+
+void Encoder::setMaxTableSize(size_t size) {
+    size = std::min(size, DEFAULT_TABLE_SIZE) ;  // Never use more than the default
+    if (size != table_.maxSize()) {
+        table_.setMaxSize(size) ;
+        pending_size_update_ = size ;
+    }
+}
+
+void Encoder::begin(std::string& out) {
+    if (pending_size_update_ != SIZE_MAX) {
+        encodeInteger(out, 0x20, 5, pending_size_update_) ;
+        pending_size_update_ = SIZE_MAX ;
+    }
+}
+
+void Encoder::encodeStatus(std::string& out, uint16_t status) {
+    // 200, 204, 206, 304, 400, 404 and 500 are static entries 8-14
+    switch (status) {
+    case 200: out.push_back(static_cast<char>(0x80 | 8)) ; return ;
+    case 204: out.push_back(static_cast<char>(0x80 | 9)) ; return ;
+    case 206: out.push_back(static_cast<char>(0x80 | 10)) ; return ;
+    case 304: out.push_back(static_cast<char>(0x80 | 11)) ; return ;
+    case 400: out.push_back(static_cast<char>(0x80 | 12)) ; return ;
+    case 404: out.push_back(static_cast<char>(0x80 | 13)) ; return ;
+    case 500: out.push_back(static_cast<char>(0x80 | 14)) ; return ;
+    default: break ;
+    }
+    char digits[3] = {
+        static_cast<char>('0' + status / 100 % 10),
+        static_cast<char>('0' + status / 10 % 10),
+        static_cast<char>('0' + status % 10),
+    } ;
+    encode(out, ":status", {digits, 3}) ;
+}
+
+void Encoder::encode(std::string& out, std::string_view name, std::string_view value, Indexing indexing) {
+    // Exact static match
+    size_t name_index = staticNameIndex(name) ;
+    if (name_index != 0) {
+        for (size_t i = name_index ; i <= STATIC_TABLE_SIZE && STATIC_TABLE[i - 1].name == name ; ++i) {
+            if (!STATIC_TABLE[i - 1].value.empty() && STATIC_TABLE[i - 1].value == value) {
+                encodeInteger(out, 0x80, 7, i) ;
+                return ;
+            }
+        }
+    }
+
+    // Exact dynamic match; an id older than the live entries was evicted
+    uint64_t oldest_live = table_.inserted() - table_.entries() ;
+    if (indexing == Indexing::Incremental) {
+        key_.assign(name) ;
+        key_.push_back('\0') ;
+        key_ += value ;
+        if (auto it = by_field_.find(key_) ; it != by_field_.end() && it->second >= oldest_live) {
+            encodeInteger(out, 0x80, 7, STATIC_TABLE_SIZE + table_.inserted() - it->second) ;
+            return ;
+        }
+    }
+    if (name_index == 0) {
+        if (auto it = by_name_.find(std::string(name)) ; it != by_name_.end() && it->second >= oldest_live) {
+            name_index = STATIC_TABLE_SIZE + table_.inserted() - it->second ;
+        }
+    }
+
+    switch (indexing) {
+    case Indexing::Incremental: encodeInteger(out, 0x40, 6, name_index) ; break ;
+    case Indexing::None: encodeInteger(out, 0x00, 4, name_index) ; break ;
+    case Indexing::Never: encodeInteger(out, 0x10, 4, name_index) ; break ;
+    }
+    if (name_index == 0) {
+        encodeString(out, name) ;
+    }
+    encodeString(out, value) ;
+
+    if (indexing == Indexing::Incremental) {
+        insert(name, value) ;
+    }
+}
+
+void Encoder::insert(std::string_view name, std::string_view value) {
+    table_.insert(name, value) ;
+    uint64_t id = table_.inserted() - 1 ;
+    if (table_.entries() == 0 || id < table_.inserted() - table_.entries()) {
+        return ;  // Too large for the table
+    }
+    by_field_[key_] = id ;
+    by_name_[std::string(name)] = id ;
+
+    // Stale ids pile up as entries are evicted (dates, say): rebuild from the live entries
+    if (by_field_.size() > 4 * table_.entries() + 64) {
+        by_field_.clear() ;
+        by_name_.clear() ;
+        for (size_t index = table_.entries() ; index >= 1 ; --index) {
+            const auto* entry = table_.get(index) ;
+            uint64_t entry_id = table_.inserted() - index ;
+            by_field_[entry->name + '\0' + entry->value] = entry_id ;
+            by_name_[entry->name] = entry_id ;
+        }
+    }
+}
+
+} // namespace frqs::http::hpack
@@ -0,0 +1,1055 @@
+/**
+ * @file http/http2.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief HTTP/2 connection state machine (RFC 9113) with RFC 9218 priorities
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "http/http2.hpp"
+#include "utils/buffer_pool.hpp"
+#include "utils/input_buffer.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <format>
+
+namespace frqs::http {
+
+namespace {
+
+// Frame types (RFC 9113 §6, RFC 9218 §7.1)
+constexpr uint8_t FRAME_DATA = 0x0 ;
+constexpr uint8_t FRAME_HEADERS = 0x1 ;
+constexpr uint8_t FRAME_PRIORITY = 0x2 ;
+constexpr uint8_t FRAME_RST_STREAM = 0x3 ;
+constexpr uint8_t FRAME_SETTINGS = 0x4 ;
+constexpr uint8_t FRAME_PUSH_PROMISE = 0x5 ;
+constexpr uint8_t FRAME_PING = 0x6 ;
+constexpr uint8_t FRAME_GOAWAY = 0x7 ;
+constexpr uint8_t FRAME_WINDOW_UPDATE = 0x8 ;
+constexpr uint8_t FRAME_CONTINUATION = 0x9 ;
+constexpr uint8_t FRAME_PRIORITY_UPDATE = 0x10 ;
+
+// Flags
+constexpr uint8_t FLAG_ACK = 0x1 ;
+constexpr uint8_t FLAG_END_STREAM = 0x1 ;
+constexpr uint8_t FLAG_END_HEADERS = 0x4 ;
+constexpr uint8_t FLAG_PADDED = 0x8 ;
+constexpr uint8_t FLAG_PRIORITY = 0x20 ;
+
+// SETTINGS parameters
+constexpr uint16_t SETTINGS_HEADER_TABLE_SIZE = 0x1 ;
+constexpr uint16_t SETTINGS_ENABLE_PUSH = 0x2 ;
+constexpr uint16_t SETTINGS_MAX_CONCURRENT_STREAMS = 0x3 ;
+constexpr uint16_t SETTINGS_INITIAL_WINDOW_SIZE = 0x4 ;
+constexpr uint16_t SETTINGS_MAX_FRAME_SIZE = 0x5 ;
+constexpr uint16_t SETTINGS_MAX_HEADER_LIST_SIZE = 0x6 ;
+
+constexpr size_t FRAME_HEADER_SIZE = 9 ;
+constexpr uint32_t DEFAULT_WINDOW = 65535 ;
+constexpr int64_t MAX_WINDOW = 0x7FFFFFFF ;
+
+// The largest frame we accept: SETTINGS_MAX_FRAME_SIZE is left at its default
+constexpr size_t MAX_FRAME_SIZE = 16384 ;
+
+// DATA bytes scheduled per output() call, so a large window does not turn
+// into one enormous batch of segments
+constexpr uint64_t OUTPUT_BUDGET = 256 * 1024 ;
+
+uint32_t readUint32(const char* p) noexcept {
+    auto* u = reinterpret_cast<const uint8_t*>(p) ;
+    return (uint32_t{u[0]} << 24) | (uint32_t{u[1]} << 16) | (uint32_t{u[2]} << 8) | u[3] ;
+}
+
+void appendUint32(std::string& out, uint32_t value) {
+    out.push_back(static_cast<char>(value >> 24)) ;
+    out.push_back(static_cast<char>(value >> 16)) ;
+    out.push_back(static_cast<char>(value >> 8)) ;
+    out.push_back(static_cast<char>(value)) ;
+}
+
+void appendSetting(std::string& out, uint16_t id, uint32_t value) {
+    out.push_back(static_cast<char>(id >> 8)) ;
+    out.push_back(static_cast<char>(id)) ;
+    appendUint32(out, value) ;
+}
+
+// Drops the Pad Length byte and the padding of a PADDED frame
+bool stripPadding(uint8_t flags, std::string_view& payload) noexcept {
+    if (!(flags & FLAG_PADDED)) {
+        return true ;
+    }
+    if (payload.empty()) {
+        return false ;
+    }
+    auto padding = static_cast<uint8_t>(payload.front()) ;
+    if (padding >= payload.size()) {
+        return false ;
+    }
+    payload = payload.substr(1, payload.size() - 1 - padding) ;
+    return true ;
+}
+
+// RFC 7540 weight (1-256) onto an RFC 9218 urgency: 225-256 is 0, 1-32 is 7
+uint8_t urgencyFromWeight(uint32_t weight) noexcept {
+    return static_cast<uint8_t>(7 - (weight - 1) / 32) ;
+}
+
+// `priority` field value (RFC 9218 §4): "u=<0-7>" and "i" among
+// dictionary members; anything else is ignored
+void parsePriority(std::string_view value, uint8_t& urgency, bool& incremental) noexcept {
+    while (!value.empty()) {
+        auto comma = value.find(',') ;
+        std::string_view member = value.substr(0, comma) ;
+        while (!member.empty() && (member.front() == ' ' || member.front() == '\t')) member.remove_prefix(1) ;
+        while (!member.empty() && (member.back() == ' ' || member.back() == '\t')) member.remove_suffix(1) ;
+
+        if (member.size() == 3 && member.starts_with("u=") && member[2] >= '0' && member[2] <= '7') {
+            urgency = static_cast<uint8_t>(member[2] - '0') ;
+        } else if (member == "i" || member == "i=?1") {
+            incremental = true ;
+        } else if (member == "i=?0") {
+            incremental = false ;
+        }
+
+        if (comma == std::string_view::npos) break ;
+        value.remove_prefix(comma + 1) ;
+    }
+}
+
+// Fields only meaningful for one HTTP/1 hop (RFC 9113 §8.2.2)
+bool isConnectionSpecific(std::string_view name) noexcept {
+    return name == "connection" || name == "keep-alive" || name == "proxy-connection" ||
+           name == "transfer-encoding" || name == "upgrade" ;
+}
+
+// Response fields whose values change from one response to the next are
+// not worth a dynamic table entry
+hpack::Encoder::Indexing indexingFor(std::string_view name) noexcept {
+    if (name == "content-length" || name == "date" || name == "etag" || name == "last-modified" ||
+        name == "content-range" || name == "expires" || name == "age" || name == "set-cookie") {
+        return hpack::Encoder::Indexing::None ;
+    }
+    return hpack::Encoder::Indexing::Incremental ;
+}
+
+} // namespace
+
+Http2Session::Http2Session(const Http2Options& options)
+    : options_(options) {
+    options_.initial_window_size = std::clamp<uint32_t>(options_.initial_window_size, 1, MAX_WINDOW) ;
+    options_.connection_window_size = std::clamp<uint32_t>(options_.connection_window_size, DEFAULT_WINDOW, MAX_WINDOW) ;
+
+    std::string settings ;
+    appendSetting(settings, SETTINGS_MAX_CONCURRENT_STREAMS, options_.max_concurrent_streams) ;
+    appendSetting(settings, SETTINGS_INITIAL_WINDOW_SIZE, options_.initial_window_size) ;
+    appendSetting(settings, SETTINGS_MAX_HEADER_LIST_SIZE, static_cast<uint32_t>(options_.max_header_list_size)) ;
+    writeFrame(FRAME_SETTINGS, 0, 0, settings) ;
+
+    if (options_.connection_window_size > DEFAULT_WINDOW) {
+        writeWindowUpdate(0, options_.connection_window_size - DEFAULT_WINDOW) ;
+        receive_window_ = options_.connection_window_size ;
+    }
+}
+
+// ============================================================================
+// Input
+// ============================================================================
+
+std::span<char> Http2Session::prepare(size_t min_size) {
+    return utils::prepareInput(in_, in_start_, in_size_, min_size) ;
+}
+
+void Http2Session::commit(size_t n) {
+    in_size_ += n ;
+}
+
+void Http2Session::feed(std::string_view data) {
+    auto space = prepare(data.size()) ;
+    std::memcpy(space.data(), data.data(), data.size()) ;
+    commit(data.size()) ;
+}
+
+bool Http2Session::process() {
+    if (failed_) {
+        return false ;
+    }
+
+    if (!preface_received_) {
+        size_t n = std::min(in_size_ - in_start_, PREFACE.size()) ;
+        if (std::string_view(in_.data() + in_start_, n) != PREFACE.substr(0, n)) {
+            return connectionError(Http2Error::ProtocolError) ;
+        }
+        if (n < PREFACE.size()) {
+            return true ;
+        }
+        in_start_ += n ;
+        preface_received_ = true ;
+    }
+
+    while (in_size_ - in_start_ >= FRAME_HEADER_SIZE) {
+        const char* header = in_.data() + in_start_ ;
+        auto* u = reinterpret_cast<const uint8_t*>(header) ;
+        size_t length = (size_t{u[0]} << 16) | (size_t{u[1]} << 8) | u[2] ;
+        if (length > MAX_FRAME_SIZE) {
+            return connectionError(Http2Error::FrameSizeError) ;
+        }
+        if (in_size_ - in_start_ < FRAME_HEADER_SIZE + length) {
+            break ;
+        }
+
+        uint32_t stream_id = readUint32(header + 5) & 0x7FFFFFFF ;
+        std::string_view payload(header + FRAME_HEADER_SIZE, length) ;
+        in_start_ += FRAME_HEADER_SIZE + length ;
+
+        if (!parseFrame(u[3], u[4], stream_id, payload)) {
+            return false ;
+        }
+    }
+    return true ;
+}
+
+bool Http2Session::parseFrame(uint8_t type, uint8_t flags, uint32_t stream_id, std::string_view payload) {
+    // A header block is contiguous: nothing may come between its frames
+    if (continuation_stream_ != 0 && type != FRAME_CONTINUATION) {
+        return connectionError(Http2Error::ProtocolError) ;
+    }
+
+    switch (type) {
+    case FRAME_DATA:
+        return onData(flags, stream_id, payload) ;
+
+    case FRAME_HEADERS:
+        return onHeaders(flags, stream_id, payload) ;
+
+    case FRAME_CONTINUATION:
+        return onContinuation(flags, stream_id, payload) ;
+
+    case FRAME_PRIORITY: {
+        if (stream_id == 0) {
+            return connectionError(Http2Error::ProtocolError) ;
+        }
+        if (payload.size() != 5) {
+            resetStream(stream_id, Http2Error::FrameSizeError) ;
+            return true ;
+        }
+        auto it = streams_.find(stream_id) ;
+        if (it != streams_.end() && !it->second.priority_set) {
+            it->second.urgency = urgencyFromWeight(static_cast<uint8_t>(payload[4]) + 1u) ;
+        }
+        return true ;
+    }
+
+    case FRAME_RST_STREAM:
+        if (stream_id == 0 || stream_id > last_stream_id_) {
+            return connectionError(Http2Error::ProtocolError) ;
+        }
+        if (payload.size() != 4) {
+            return connectionError(Http2Error::FrameSizeError) ;
+        }
+        closeStream(stream_id) ;  // Whatever it still had to send is dropped
+        return true ;
+
+    case FRAME_SETTINGS:
+        return onSettings(flags, stream_id, payload) ;
+
+    case FRAME_PUSH_PROMISE:
+        return connectionError(Http2Error::ProtocolError) ;  // Clients cannot push
+
+    case FRAME_PING:
+        if (stream_id != 0) {
+            return connectionError(Http2Error::ProtocolError) ;
+        }
+        if (payload.size() != 8) {
+            return connectionError(Http2Error::FrameSizeError) ;
+        }
+        if (!(flags & FLAG_ACK)) {
+            writeFrame(FRAME_PING, FLAG_ACK, 0, payload) ;
+        }
+        return true ;
+
+    case FRAME_GOAWAY:
+        if (stream_id != 0) {
+            return connectionError(Http2Error::ProtocolError) ;
+        }
+        if (payload.size() < 8) {
+            return connectionError(Http2Error::FrameSizeError) ;
+        }
+        goaway_received_ = true ;  // Open streams still get their responses
+        return true ;
+
+    case FRAME_WINDOW_UPDATE:
+        return onWindowUpdate(stream_id, payload) ;
+
+    case FRAME_PRIORITY_UPDATE:
+        if (stream_id != 0) {
+            return connectionError(Http2Error::ProtocolError) ;
+        }
+        return onPriorityUpdate(payload) ;
+
+    default:
+        return true ;  // Unknown frame types are ignored (§5.5)
+    }
+}
+
+bool Http2Session::onData(uint8_t flags, uint32_t stream_id, std::string_view payload) {
+    if (stream_id == 0) {
+        return connectionError(Http2Error::ProtocolError) ;
+    }
+
+    // The whole frame counts against the windows, padding included
+    auto frame_length = static_cast<int64_t>(payload.size()) ;
+    if (!stripPadding(flags, payload)) {
+        return connectionError(Http2Error::ProtocolError) ;
+    }
+    receive_window_ -= frame_length ;
+    if (receive_window_ < 0) {
+        return connectionError(Http2Error::FlowControlError) ;
+    }
+    if (receive_window_ <= options_.connection_window_size / 2) {
+        writeWindowUpdate(0, static_cast<uint32_t>(options_.connection_window_size - receive_window_)) ;
+        receive_window_ = options_.connection_window_size ;
+    }
+
+    auto it = streams_.find(stream_id) ;
+    if (it == streams_.end()) {
+        if (stream_id > last_stream_id_) {
+            return connectionError(Http2Error::ProtocolError) ;  // Idle stream
+        }
+        return true ;  // Reset or answered already; the client has yet to notice
+    }
+
+    auto& stream = it->second ;
+    if (stream.end_received) {
+        resetStream(stream_id, Http2Error::StreamClosed) ;
+        return true ;
+    }
+    stream.receive_window -= frame_length ;
+    if (stream.receive_window < 0) {
+        resetStream(stream_id, Http2Error::FlowControlError) ;
+        return true ;
+    }
+
+    bool end_stream = flags & FLAG_END_STREAM ;
+    if (!stream.responded) {
+        if (stream.body.size() + payload.size() > options_.max_body_bytes) {
+            stream.end_received = end_stream ;
+            reject(stream_id, 413) ;
+            return true ;
+        }
+        stream.body.append(payload) ;
+    }
+
+    if (end_stream) {
+        onRequestEnd(stream_id, stream) ;
+    } else if (!stream.responded && stream.receive_window <= options_.initial_window_size / 2) {
+        writeWindowUpdate(stream_id, static_cast<uint32_t>(options_.initial_window_size - stream.receive_window)) ;
+        stream.receive_window = options_.initial_window_size ;
+    }
+    return true ;
+}
+
+bool Http2Session::onHeaders(uint8_t flags, uint32_t stream_id, std::string_view payload) {
+    if (stream_id == 0 || stream_id % 2 == 0) {
+        return connectionError(Http2Error::ProtocolError) ;
+    }
+    if (!stripPadding(flags, payload)) {
+        return connectionError(Http2Error::ProtocolError) ;
+    }
+
+    block_urgency_ = NO_URGENCY ;
+    if (flags & FLAG_PRIORITY) {
+        if (payload.size() < 5) {
+            return connectionError(Http2Error::FrameSizeError) ;
+        }
+        if ((readUint32(payload.data()) & 0x7FFFFFFF) == stream_id) {
+            return connectionError(Http2Error::ProtocolError) ;  // Depends on itself
+        }
+        block_urgency_ = urgencyFromWeight(static_cast<uint8_t>(payload[4]) + 1u) ;
+        payload.remove_prefix(5) ;
+    }
+
+    header_block_.assign(payload) ;
+    continuation_end_stream_ = flags & FLAG_END_STREAM ;
+    if (!(flags & FLAG_END_HEADERS)) {
+        continuation_stream_ = stream_id ;
+        return true ;
+    }
+    return onHeaderBlock(stream_id, continuation_end_stream_) ;
+}
+
+bool Http2Session::onContinuation(uint8_t flags, uint32_t stream_id, std::string_view payload) {
+    if (continuation_stream_ == 0 || stream_id != continuation_stream_) {
+        return connectionError(Http2Error::ProtocolError) ;
+    }
+
+    // A block this far over the list limit is not a request worth decoding
+    header_block_.append(payload) ;
+    if (header_block_.size() > 4 * options_.max_header_list_size + MAX_FRAME_SIZE) {
+        return connectionError(Http2Error::EnhanceYourCalm) ;
+    }
+
+    if (!(flags & FLAG_END_HEADERS)) {
+        return true ;
+    }
+    continuation_stream_ = 0 ;
+    return onHeaderBlock(stream_id, continuation_end_stream_) ;
+}
+
+bool Http2Session::discardHeaderBlock() {
+    discarded_.clear() ;
+    discarded_fields_.clear() ;
+    if (decoder_.decode(header_block_, discarded_, discarded_fields_, 0) == hpack::Decoder::Result::Malformed) {
+        return connectionError(Http2Error::CompressionError) ;
+    }
+    return true ;
+}
+
+bool Http2Session::onHeaderBlock(uint32_t stream_id, bool end_stream) {
+    // Every block goes through the decoder, even one that is then refused:
+    // the dynamic table must stay in step with the client's encoder
+
+    if (auto it = streams_.find(stream_id) ; it != streams_.end()) {
+        // Trailers: they end the request, and are not passed on
+        if (!discardHeaderBlock()) {
+            return false ;
+        }
+        if (!end_stream || it->second.end_received) {
+            resetStream(stream_id, Http2Error::ProtocolError) ;
+            return true ;
+        }
+        onRequestEnd(stream_id, it->second) ;
+        return true ;
+    }
+
+    if (stream_id <= last_stream_id_) {
+        return discardHeaderBlock() && connectionError(Http2Error::StreamClosed) ;
+    }
+    last_stream_id_ = stream_id ;
+
+    if (going_away_ || goaway_received_ || streams_.size() >= options_.max_concurrent_streams) {
+        if (!discardHeaderBlock()) {
+            return false ;
+        }
+        resetStream(stream_id, Http2Error::RefusedStream) ;
+        return true ;
+    }
+
+    auto& stream = streams_[stream_id] ;
+    stream.headers_done = true ;
+    stream.send_window = peer_initial_window_ ;
+    stream.receive_window = options_.initial_window_size ;
+    if (block_urgency_ != NO_URGENCY) {
+        stream.urgency = block_urgency_ ;
+    }
+
+    auto result = decoder_.decode(header_block_, stream.bytes, stream.fields, options_.max_header_list_size) ;
+    if (result == hpack::Decoder::Result::Malformed) {
+        return connectionError(Http2Error::CompressionError) ;
+    }
+
+    for (const auto& field : stream.fields) {
+        if (std::string_view(stream.bytes).substr(field.name_offset, field.name_length) == "priority") {
+            parsePriority(std::string_view(stream.bytes).substr(field.value_offset, field.value_length),
+                          stream.urgency, stream.incremental) ;
+            stream.priority_set = true ;
+        }
+    }
+
+    if (result == hpack::Decoder::Result::TooLarge) {
+        stream.end_received = end_stream ;
+        reject(stream_id, 431) ;
+        return true ;
+    }
+    if (end_stream) {
+        onRequestEnd(stream_id, stream) ;
+    }
+    return true ;
+}
+
+void Http2Session::onRequestEnd(uint32_t stream_id, Stream& stream) {
+    stream.end_received = true ;
+    if (!stream.responded) {
+        stream.ready = true ;
+        ready_.push_back(stream_id) ;
+    }
+    // Otherwise a rejection is on its way and closes the stream when done
+}
+
+bool Http2Session::onSettings(uint8_t flags, uint32_t stream_id, std::string_view payload) {
+    if (stream_id != 0) {
+        return connectionError(Http2Error::ProtocolError) ;
+    }
+    if (flags & FLAG_ACK) {
+        return payload.empty() || connectionError(Http2Error::FrameSizeError) ;
+    }
+    if (payload.size() % 6 != 0) {
+        return connectionError(Http2Error::FrameSizeError) ;
+    }
+
+    for (size_t pos = 0 ; pos < payload.size() ; pos += 6) {
+        auto id = static_cast<uint16_t>((static_cast<uint8_t>(payload[pos]) << 8) | static_cast<uint8_t>(payload[pos + 1])) ;
+        uint32_t value = readUint32(payload.data() + pos + 2) ;
+
+        switch (id) {
+        case SETTINGS_HEADER_TABLE_SIZE:
+            encoder_.setMaxTableSize(value) ;
+            break ;
+        case SETTINGS_ENABLE_PUSH:
+            if (value > 1) {
+                return connectionError(Http2Error::ProtocolError) ;
+            }
+            break ;  // Never pushes anyway
+        case SETTINGS_INITIAL_WINDOW_SIZE: {
+            if (value > MAX_WINDOW) {
+                return connectionError(Http2Error::FlowControlError) ;
+            }
+            // Applies to the windows of open streams too (§6.9.2)
+            int64_t delta = static_cast<int64_t>(value) - peer_initial_window_ ;
+            for (auto& entry : streams_) {
+                entry.second.send_window += delta ;
+                if (entry.second.send_window > MAX_WINDOW) {
+                    return connectionError(Http2Error::FlowControlError) ;
+                }
+            }
+            peer_initial_window_ = value ;
+            break ;
+        }
+        case SETTINGS_MAX_FRAME_SIZE:
+            if (value < 16384 || value > 16777215) {
+                return connectionError(Http2Error::ProtocolError) ;
+            }
+            peer_max_frame_size_ = value ;
+            break ;
+        default:
+            break ;  // MAX_CONCURRENT_STREAMS and MAX_HEADER_LIST_SIZE: we never push, send small lists
+        }
+    }
+
+    writeFrame(FRAME_SETTINGS, FLAG_ACK, 0, {}) ;
+    return true ;
+}
+
+bool Http2Session::onWindowUpdate(uint32_t stream_id, std::string_view payload) {
+    if (payload.size() != 4) {
+        return connectionError(Http2Error::FrameSizeError) ;
+    }
+    uint32_t increment = readUint32(payload.data()) & 0x7FFFFFFF ;
+
+    if (stream_id == 0) {
+        if (increment == 0) {
+            return connectionError(Http2Error::ProtocolError) ;
+        }
+        send_window_ += increment ;
+        return send_window_ <= MAX_WINDOW || connectionError(Http2Error::FlowControlError) ;
+    }
+
+    auto it = streams_.find(stream_id) ;
+    if (it == streams_.end()) {
+        return stream_id <= last_stream_id_ || connectionError(Http2Error::ProtocolError) ;
+    }
+    if (increment == 0) {
+        resetStream(stream_id, Http2Error::ProtocolError) ;
+        return true ;
+    }
+    it->second.send_window += increment ;
+    if (it->second.send_window > MAX_WINDOW) {
+        resetStream(stream_id, Http2Error::FlowControlError) ;
+    }
+    return true ;
+}
+
+bool Http2Session::onPriorityUpdate(std::string_view payload) {
+    if (payload.size() < 4) {
+        return connectionError(Http2Error::FrameSizeError) ;
+    }
+    uint32_t stream_id = readUint32(payload.data()) & 0x7FFFFFFF ;
+    if (stream_id == 0) {
+        return connectionError(Http2Error::ProtocolError) ;
+    }
+
+    // Streams not open yet keep the priority their HEADERS bring
+    if (auto it = streams_.find(stream_id) ; it != streams_.end()) {
+        auto& stream = it->second ;
+        stream.urgency = 3 ;
+        stream.incremental = false ;
+        parsePriority(payload.substr(4), stream.urgency, stream.incremental) ;
+        stream.priority_set = true ;
+    }
+    return true ;
+}
+
+// ============================================================================
+// Requests
+// ============================================================================
+
+std::optional<Http2Session::Request> Http2Session::nextRequest() {
+    while (!ready_.empty()) {
+        // Most urgent first, then in the order the streams were opened
+        auto best = ready_.begin() ;
+        for (auto it = ready_.begin() ; it != ready_.end() ; ++it) {
+            const auto& stream = streams_.at(*it) ;
+            const auto& current = streams_.at(*best) ;
+            if (stream.urgency < current.urgency || (stream.urgency == current.urgency && *it < *best)) {
+                best = it ;
+            }
+        }
+        uint32_t stream_id = *best ;
+        ready_.erase(best) ;
+
+        auto& stream = streams_.at(stream_id) ;
+        stream.ready = false ;
+        auto request = buildRequest(stream) ;
+        if (!request) {
+            resetStream(stream_id, Http2Error::ProtocolError) ;
+            continue ;
+        }
+
+        // The request holds its own copy now
+        std::string().swap(stream.bytes) ;
+        std::vector<hpack::Field>().swap(stream.fields) ;
+        std::string().swap(stream.body) ;
+        return Request{stream_id, std::move(*request)} ;
+    }
+    return std::nullopt ;
+}
+
+std::optional<HTTPRequest> Http2Session::buildRequest(Stream& stream) {
+    std::string_view bytes = stream.bytes ;
+    auto name = [bytes](const hpack::Field& f) { return bytes.substr(f.name_offset, f.name_length) ; } ;
+    auto value = [bytes](const hpack::Field& f) { return bytes.substr(f.value_offset, f.value_length) ; } ;
+
+    // Validate (§8.3): pseudo-header fields first, each once, lowercase
+    // names, no connection-specific fields
+    std::string_view method, scheme, path, authority ;
+    bool regular_seen = false ;
+    bool has_host = false ;
+    size_t cookies = 0 ;
+    size_t cookie_bytes = 0 ;
+    std::optional<std::string_view> content_length ;
+
+    for (const auto& field : stream.fields) {
+        auto n = name(field) ;
+        auto v = value(field) ;
+        if (n.empty() || std::any_of(n.begin(), n.end(), [](char c) { return c >= 'A' && c <= 'Z' ; })) {
+            return std::nullopt ;
+        }
+
+        if (n.front() == ':') {
+            std::string_view* target = n == ":method" ? &method
+                                     : n == ":scheme" ? &scheme
+                                     : n == ":path" ? &path
+                                     : n == ":authority" ? &authority
+                                     : nullptr ;
+            if (regular_seen || !target || !target->empty() || v.empty()) {
+                return std::nullopt ;
+            }
+            *target = v ;
+            continue ;
+        }
+
+        regular_seen = true ;
+        if (isConnectionSpecific(n) || (n == "te" && v != "trailers")) {
+            return std::nullopt ;
+        }
+        if (n == "host") {
+            has_host = true ;
+        } else if (n == "cookie") {
+            cookies++ ;
+            cookie_bytes += v.size() + 2 ;
+        } else if (n == "content-length") {
+            content_length = v ;
+        }
+    }
+
+    // CONNECT (no :scheme or :path) is not served
+    if (method.empty() || scheme.empty() || path.empty()) {
+        return std::nullopt ;
+    }
+    if (content_length) {
+        uint64_t length = 0 ;
+        auto [end, ec] = std::from_chars(content_length->data(), content_length->data() + content_length->size(), length) ;
+        if (ec != std::errc() || end != content_length->data() + content_length->size() || length != stream.body.size()) {
+            return std::nullopt ;
+        }
+    }
+
+    // One pooled buffer behind every view: the decoded fields, the body and
+    // the cookie crumbs joined back into one field (§8.2.3)
+    size_t total = bytes.size() + stream.body.size() + (cookies > 1 ? cookie_bytes : 0) ;
+    auto storage = utils::BufferPool::instance().acquire(std::max<size_t>(total, 1)) ;
+    char* base = storage.data() ;
+    std::memcpy(base, bytes.data(), bytes.size()) ;
+    std::memcpy(base + bytes.size(), stream.body.data(), stream.body.size()) ;
+    auto rebase = [base, bytes](std::string_view v) {
+        return std::string_view(base + (v.data() - bytes.data()), v.size()) ;
+    } ;
+
+    HTTPRequest request ;
+    request.storage_ = storage ;
+    request.method_ = parseMethod(method) ;
+    request.version_ = "HTTP/2" ;
+
+    std::string_view target = rebase(path) ;
+    auto query_start = target.find('?') ;
+    if (query_start != std::string_view::npos) {
+        request.path_ = target.substr(0, query_start) ;
+        request.query_string_ = target.substr(query_start + 1) ;
+    } else {
+        request.path_ = target ;
+    }
+
+    char* cookie_out = base + bytes.size() + stream.body.size() ;
+    char* cookie_start = cookie_out ;
+    for (const auto& field : stream.fields) {
+        auto n = name(field) ;
+        if (n.front() == ':') {
+            continue ;
+        }
+        if (n == "cookie" && cookies > 1) {
+            if (cookie_out != cookie_start) {
+                *cookie_out++ = ';' ;
+                *cookie_out++ = ' ' ;
+            }
+            auto v = value(field) ;
+            std::memcpy(cookie_out, v.data(), v.size()) ;
+            cookie_out += v.size() ;
+            continue ;
+        }
+        request.headers_.add(rebase(n), rebase(value(field))) ;
+    }
+    if (cookies > 1) {
+        request.headers_.add("cookie", std::string_view(cookie_start, static_cast<size_t>(cookie_out - cookie_start))) ;
+    }
+    if (!has_host && !authority.empty()) {
+        request.headers_.add("host", rebase(authority), KnownHeader::Host) ;
+    }
+
+    request.body_ = std::string_view(base + bytes.size(), stream.body.size()) ;
+    request.parseQueryString() ;
+    request.is_valid_ = true ;
+    return request ;
+}
+
+void Http2Session::reject(uint32_t stream_id, uint16_t status) {
+    auto& stream = streams_.at(stream_id) ;
+    std::string().swap(stream.body) ;
+
+    HTTPResponse response ;
+    response.setStatus(status)
+            .setContentType("text/html")
+            .setBody(std::format("<html><body><h1>{} {}</h1></body></html>",
+                                 response.getStatus(), response.getStatusMessage())) ;
+    respond(stream_id, response, false) ;
+}
+
+// ============================================================================
+// Responses
+// ============================================================================
+
+bool Http2Session::respond(uint32_t stream_id, HTTPResponse& response, bool head_only) {
+    auto it = streams_.find(stream_id) ;
+    if (it == streams_.end() || it->second.responded) {
+        return false ;  // The client reset the stream meanwhile
+    }
+    auto& stream = it->second ;
+    stream.responded = true ;
+
+    uint16_t status = response.getStatus() ;
+    bool body_allowed = !head_only && HTTPResponse::statusAllowsBody(status) ;
+
+    // Take the body over; a streamed one comes later, through streamBody()
+    SharedBody body ;
+    std::optional<FileBody> file ;
+    bool streamed = response.isStreaming() ;
+    if (!streamed && response.getFileBody()) {
+        file = response.getFileBody() ;
+    } else if (!streamed) {
+        body = response.releaseBody() ;
+    }
+    uint64_t length = file ? file->length : body.bytes.size() ;
+
+    block_.clear() ;
+    encoder_.begin(block_) ;
+    encoder_.encodeStatus(block_, status) ;
+
+    bool has_length = false ;
+    for (const auto& [header, value] : response.getHeaders()) {
+        name_.assign(header) ;
+        std::transform(name_.begin(), name_.end(), name_.begin(),
+                       [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c + 32) : c ; }) ;
+        if (isConnectionSpecific(name_)) {
+            continue ;
+        }
+        if (name_ == "content-length") {
+            has_length = true ;
+        }
+        encoder_.encode(block_, name_, value, indexingFor(name_)) ;
+    }
+
+    // A HEAD response carries the GET length; a streamed one has none to
+    // tell unless the handler set it
+    if (!has_length && !streamed && HTTPResponse::statusAllowsBody(status)) {
+        char digits[24] ;
+        auto end = std::to_chars(digits, digits + sizeof(digits), length).ptr ;
+        encoder_.encode(block_, "content-length", {digits, static_cast<size_t>(end - digits)},
+                        hpack::Encoder::Indexing::None) ;
+    }
+
+    bool end_stream = !body_allowed || (!streamed && length == 0) ;
+    writeHeaders(stream_id, block_, end_stream) ;
+    if (end_stream) {
+        finishStream(stream_id, stream) ;
+        return false ;
+    }
+
+    stream.body_out = std::move(body) ;
+    stream.file_out = std::move(file) ;
+    stream.streamed = streamed ;
+    stream.producing = streamed ;
+    stream.out_offset = stream.file_out ? stream.file_out->offset : 0 ;
+    stream.out_remaining = length ;
+    sending_.push_back(stream_id) ;
+    return streamed ;
+}
+
+bool Http2Session::streamBody(uint32_t stream_id, std::string_view data) {
+    auto it = streams_.find(stream_id) ;
+    if (it == streams_.end() || !it->second.producing) {
+        return false ;
+    }
+    auto& stream = it->second ;
+
+    // Framed bytes are dropped once they are a buffer's worth, so the
+    // buffer stays bounded without moving the rest on every write
+    if (stream.out_offset >= STREAM_BUFFER) {
+        stream.stream_out.erase(0, stream.out_offset) ;
+        stream.out_offset = 0 ;
+    }
+    stream.stream_out += data ;
+    stream.out_remaining += data.size() ;
+    return true ;
+}
+
+size_t Http2Session::streamBuffered(uint32_t stream_id) const {
+    auto it = streams_.find(stream_id) ;
+    return it != streams_.end() && it->second.streamed ? it->second.out_remaining : 0 ;
+}
+
+void Http2Session::endStream(uint32_t stream_id) {
+    auto it = streams_.find(stream_id) ;
+    if (it == streams_.end() || !it->second.producing) {
+        return ;
+    }
+    auto& stream = it->second ;
+    stream.producing = false ;
+
+    // Nothing left for scheduleData() to end the stream with
+    if (stream.out_remaining == 0) {
+        writeFrame(FRAME_DATA, FLAG_END_STREAM, stream_id, {}) ;
+        finishStream(stream_id, stream) ;
+    }
+}
+
+void Http2Session::scheduleData() {
+    uint64_t budget = OUTPUT_BUDGET ;
+
+    while (budget > 0 && send_window_ > 0 && !failed_) {
+        // Most urgent stream that may send: not incremental ones in stream
+        // order first, then the incremental ones in turn (sending_ rotates)
+        auto best = sending_.end() ;
+        const Stream* best_stream = nullptr ;
+        for (auto it = sending_.begin() ; it != sending_.end() ; ++it) {
+            const auto& stream = streams_.at(*it) ;
+            if (stream.send_window <= 0 || stream.out_remaining == 0) {
+                continue ;  // Out of window, or a producer has not caught up
+            }
+            if (!best_stream || stream.urgency < best_stream->urgency ||
+                (stream.urgency == best_stream->urgency &&
+                 ((!stream.incremental && best_stream->incremental) ||
+                  (!stream.incremental && !best_stream->incremental && *it < *best)))) {
+                best = it ;
+                best_stream = &stream ;
+            }
+        }
+        if (!best_stream) {
+            break ;  // Every stream waits for a WINDOW_UPDATE
+        }
+
+        uint32_t stream_id = *best ;
+        auto& stream = streams_.at(stream_id) ;
+        uint64_t n = std::min({stream.out_remaining, uint64_t{peer_max_frame_size_}, budget,
+                               static_cast<uint64_t>(send_window_), static_cast<uint64_t>(stream.send_window)}) ;
+        bool last = n == stream.out_remaining && !stream.producing ;
+        uint8_t flags = last ? FLAG_END_STREAM : 0 ;
+
+        if (stream.streamed) {
+            // Copied: the producer goes on appending to stream_out
+            writeFrame(FRAME_DATA, flags, stream_id,
+                       std::string_view(stream.stream_out).substr(stream.out_offset, n)) ;
+        } else if (stream.file_out) {
+            writeFrameHeader(n, FRAME_DATA, flags, stream_id) ;
+            appendPiece({nullptr, stream.file_out->file.get(), stream.out_offset, n}) ;
+            sending_bodies_.push_back(stream.file_out->file) ;
+        } else {
+            writeFrameHeader(n, FRAME_DATA, flags, stream_id) ;
+            appendPiece({stream.body_out.bytes.data() + stream.out_offset, nullptr, 0, n}) ;
+            sending_bodies_.push_back(stream.body_out.owner) ;
+        }
+
+        stream.out_offset += n ;
+        stream.out_remaining -= n ;
+        stream.send_window -= static_cast<int64_t>(n) ;
+        send_window_ -= static_cast<int64_t>(n) ;
+        budget -= n ;
+        if (stream.streamed && stream.out_remaining == 0) {
+            stream.stream_out.clear() ;     // Caught up with the producer
+            stream.out_offset = 0 ;
+        }
+
+        if (last) {
+            sending_.erase(best) ;
+            finishStream(stream_id, stream) ;
+        } else if (stream.incremental) {
+            std::rotate(best, best + 1, sending_.end()) ;
+        }
+    }
+}
+
+void Http2Session::finishStream(uint32_t stream_id, const Stream& stream) {
+    // A response may end before the request does (a rejected upload):
+    // RST_STREAM(NO_ERROR) tells the client to stop sending (§8.1)
+    if (stream.end_received) {
+        closeStream(stream_id) ;
+    } else {
+        resetStream(stream_id, Http2Error::NoError) ;
+    }
+}
+
+std::span<const Http2Session::Segment> Http2Session::output() {
+    scheduleData() ;
+
+    segments_.clear() ;
+    for (const auto& piece : pieces_) {
+        if (piece.file) {
+            segments_.push_back({{}, piece.file, piece.offset, piece.length}) ;
+        } else if (piece.data) {
+            segments_.push_back({{piece.data, static_cast<size_t>(piece.length)}}) ;
+        } else {
+            segments_.push_back({std::string_view(out_).substr(piece.offset, piece.length)}) ;
+        }
+    }
+    return segments_ ;
+}
+
+void Http2Session::sent() {
+    out_.clear() ;
+    pieces_.clear() ;
+    segments_.clear() ;
+    sending_bodies_.clear() ;
+}
+
+bool Http2Session::done() const noexcept {
+    return failed_ || ((going_away_ || goaway_received_) && streams_.empty()) ;
+}
+
+void Http2Session::goAway() {
+    if (going_away_) {
+        return ;
+    }
+    going_away_ = true ;
+
+    std::string payload ;
+    appendUint32(payload, last_stream_id_) ;
+    appendUint32(payload, static_cast<uint32_t>(Http2Error::NoError)) ;
+    writeFrame(FRAME_GOAWAY, 0, 0, payload) ;
+}
+
+// ============================================================================
+// Errors and frame writing
+// ============================================================================
+
+bool Http2Session::connectionError(Http2Error error) {
+    if (!failed_) {
+        std::string payload ;
+        appendUint32(payload, last_stream_id_) ;
+        appendUint32(payload, static_cast<uint32_t>(error)) ;
+        writeFrame(FRAME_GOAWAY, 0, 0, payload) ;
+        going_away_ = true ;
+        failed_ = true ;
+    }
+    return false ;
+}
+
+void Http2Session::resetStream(uint32_t stream_id, Http2Error error) {
+    std::string payload ;
+    appendUint32(payload, static_cast<uint32_t>(error)) ;
+    writeFrame(FRAME_RST_STREAM, 0, stream_id, payload) ;
+    closeStream(stream_id) ;
+}
+
+void Http2Session::closeStream(uint32_t stream_id) {
+    if (streams_.erase(stream_id) == 0) {
+        return ;
+    }
+    std::erase(ready_, stream_id) ;
+    std::erase(sending_, stream_id) ;
+}
+
+void Http2Session::writeFrameHeader(size_t length, uint8_t type, uint8_t flags, uint32_t stream_id) {
+    size_t start = out_.size() ;
+    out_.push_back(static_cast<char>(length >> 16)) ;
+    out_.push_back(static_cast<char>(length >> 8)) ;
+    out_.push_back(static_cast<char>(length)) ;
+    out_.push_back(static_cast<char>(type)) ;
+    out_.push_back(static_cast<char>(flags)) ;
+    appendUint32(out_, stream_id) ;
+    appendPiece({nullptr, nullptr, start, FRAME_HEADER_SIZE}) ;
+}
+
+void Http2Session::writeFrame(uint8_t type, uint8_t flags, uint32_t stream_id, std::string_view payload) {
+    writeFrameHeader(payload.size(), type, flags, stream_id) ;
+    size_t start = out_.size() ;
+    out_ += payload ;
+    appendPiece({nullptr, nullptr, start, payload.size()}) ;
+}
+
+void Http2Session::writeHeaders(uint32_t stream_id, std::string_view block, bool end_stream) {
+    // HEADERS, then CONTINUATION frames for what does not fit
+    uint8_t type = FRAME_HEADERS ;
+    uint8_t flags = end_stream ? FLAG_END_STREAM : 0 ;
+    do {
+        auto fragment = block.substr(0, peer_max_frame_size_) ;
+        block.remove_prefix(fragment.size()) ;
+        writeFrame(type, block.empty() ? flags | FLAG_END_HEADERS : flags, stream_id, fragment) ;
+        type = FRAME_CONTINUATION ;
+        flags = 0 ;
+    } while (!block.empty()) ;
+}
+
+void Http2Session::writeWindowUpdate(uint32_t stream_id, uint32_t increment) {
+    std::string payload ;
+    appendUint32(payload, increment) ;
+    writeFrame(FRAME_WINDOW_UPDATE, 0, stream_id, payload) ;
+}
+
+void Http2Session::appendPiece(const Piece& piece) {
+    if (piece.length == 0) {
+        return ;
+    }
+    // Consecutive bytes of out_ are one segment
+    if (!piece.data && !piece.file && !pieces_.empty()) {
+        auto& last = pieces_.back() ;
+        if (!last.data && !last.file && last.offset + last.length == piece.offset) {
+            last.length += piece.length ;
+            return ;
+        }
+    }
+    pieces_.push_back(piece) ;
+}
+
+} // namespace frqs::http
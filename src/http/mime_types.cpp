@@ -10,64 +10,131 @@
  */
 
 #include "http/mime_types.hpp"
-#include <unordered_map>
+#include "http/static_map.hpp"
 
 namespace frqs::http {
 
-std::string_view MimeTypes::fromExtension(std::string_view ext) noexcept {
-    static const std::unordered_map<std::string_view, std::string_view> types = {
-        // Text
-        {".html", "text/html"},
-        {".htm", "text/html"},
-        {".css", "text/css"},
-        {".js", "application/javascript"},
-        {".json", "application/json"},
-        {".xml", "application/xml"},
-        {".txt", "text/plain"},
-        {".csv", "text/csv"},
-        
-        // Images
-        {".png", "image/png"},
-        {".jpg", "image/jpeg"},
-        {".jpeg", "image/jpeg"},
-        {".gif", "image/gif"},
-        {".svg", "image/svg+xml"},
-        {".ico", "image/x-icon"},
-        {".webp", "image/webp"},
-        
-        // Fonts
-        {".woff", "font/woff"},
-        {".woff2", "font/woff2"},
-        {".ttf", "font/ttf"},
-        {".otf", "font/otf"},
-        
-        // Archives
-        {".zip", "application/zip"},
-        {".tar", "application/x-tar"},
-        {".gz", "application/gzip"},
-        
-        // Documents
-        {".pdf", "application/pdf"},
-        
-        // Video
-        {".mp4", "video/mp4"},
-        {".webm", "video/webm"},
-        
-        // Audio
-        {".mp3", "audio/mpeg"},
-        {".wav", "audio/wav"},
-        {".ogg", "audio/ogg"}
-    };
+namespace {
+
+// Extensions are matched ignoring case (".PNG" is ".png")
+constexpr StaticMap<std::string_view, 34, KeyCase::Insensitive> TYPES({{
+    // Text
+    {".html", "text/html"},
+    {".htm", "text/html"},
+    {".css", "text/css"},
+    {".js", "application/javascript"},
+    {".mjs", "application/javascript"},
+    {".json", "application/json"},
+    {".xml", "application/xml"},
+    {".txt", "text/plain"},
+    {".csv", "text/csv"},
+    
+    // Images
+    {".png", "image/png"},
+    {".jpg", "image/jpeg"},
+    {".jpeg", "image/jpeg"},
+    {".gif", "image/gif"},
+    {".svg", "image/svg+xml"},
+    {".ico", "image/x-icon"},
+    {".webp", "image/webp"},
+    {".avif", "image/avif"},
+    
+    // Fonts
+    {".woff", "font/woff"},
+    {".woff2", "font/woff2"},
+    {".ttf", "font/ttf"},
+    {".otf", "font/otf"},
+    
+    // Archives
+    {".zip", "application/zip"},
+    {".tar", "application/x-tar"},
+    {".gz", "application/gzip"},
+    
+    // Documents
+    {".pdf", "application/pdf"},
+    
+    // Code
+    {".wasm", "application/wasm"},
     
-    auto it = types.find(ext);
-    return (it != types.end()) ? it->second : defaultType();
+    // Video
+    {".mp4", "video/mp4"},
+    {".webm", "video/webm"},
+    
+    // Audio
+    {".mp3", "audio/mpeg"},
+    {".wav", "audio/wav"},
+    {".ogg", "audio/ogg"},
+    {".oga", "audio/ogg"},
+    {".m4a", "audio/mp4"},
+    {".flac", "audio/flac"}
+}});
+
+// Longest extension in the table, dot included; anything longer is unknown
+constexpr size_t MAX_EXTENSION = 6;
+
+} // namespace
+
+std::string_view MimeTypes::fromExtension(std::string_view ext) noexcept {
+    return TYPES.get(ext, defaultType());
 }
 
 std::string_view MimeTypes::fromPath(const std::filesystem::path& path) noexcept {
-    if (!path.has_extension()) {
+    // Read the extension straight off the native string, where
+    // path.extension().string() would build two temporaries
+    const auto& native = path.native();
+    
+    size_t name_start = native.find_last_of(std::filesystem::path::preferred_separator);
+#ifdef _WIN32
+    // '/' separates too on Windows
+    size_t slash = native.find_last_of(L'/');
+    if (slash != native.npos && (name_start == native.npos || slash > name_start)) {
+        name_start = slash;
+    }
+#endif
+    name_start = name_start == native.npos ? 0 : name_start + 1;
+    
+    // As path::extension(): the last dot, unless it starts the name (".bashrc")
+    size_t dot = native.find_last_of('.');
+    if (dot == native.npos || dot <= name_start || native.size() - dot > MAX_EXTENSION) {
         return defaultType();
     }
-    return fromExtension(path.extension().string());
+    
+    // Narrow into a small buffer (wide paths on Windows); non-ASCII never matches
+    char ext[MAX_EXTENSION];
+    size_t length = native.size() - dot;
+    for (size_t i = 0; i < length; ++i) {
+        auto c = native[dot + i];
+        if (static_cast<unsigned>(c) > 0x7F) {
+            return defaultType();
+        }
+        ext[i] = static_cast<char>(c);
+    }
+    return fromExtension(std::string_view(ext, length));
+}
+
+bool MimeTypes::isCompressible(std::string_view mime_type) noexcept {
+    // Strip parameters ("text/html; charset=utf-8")
+    mime_type = mime_type.substr(0, mime_type.find(';'));
+    while (!mime_type.empty() && mime_type.back() == ' ') {
+        mime_type.remove_suffix(1);
+    }
+    
+    if (mime_type.starts_with("text/")) {
+        return true;
+    }
+    
+    // Structured syntax suffixes (application/ld+json, image/svg+xml, ...)
+    if (mime_type.ends_with("+json") || mime_type.ends_with("+xml")) {
+        return true;
+    }
+    
+    return mime_type == "application/json" ||
+           mime_type == "application/javascript" ||
+           mime_type == "application/xml" ||
+           mime_type == "application/wasm" ||
+           mime_type == "image/x-icon" ||
+           mime_type == "font/ttf" ||
+           mime_type == "font/otf";
 }
 
 } // namespace frqs::http
\ No newline at end of file
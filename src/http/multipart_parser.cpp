@@ -1,7 +1,7 @@
 /**
  * @file http/multipart_parser.cpp
  * @author zuudevs (zuudevs@gmail.com)
- * @brief 
+ * @brief
  * @version 1.0.0
  * @date 2025-12-09
  * 
@@ -10,85 +10,69 @@
  */
 
 #include "http/multipart_parser.hpp"
+#include "http/header_map.hpp"
+#include "utils/filesystem_utils.hpp"
 #include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <memory>
+#include <system_error>
 
 namespace frqs::http {
 
-bool MultipartParser::parse(std::string_view body, std::string_view boundary) {
-    parts_.clear();
+namespace {
+
+std::string trim(std::string_view str) {
+    auto start = std::find_if_not(str.begin(), str.end(),
+        [](unsigned char ch) { return std::isspace(ch); });
     
-    if (boundary.empty()) {
-        return false;
-    }
+    auto end = std::find_if_not(str.rbegin(), str.rend(),
+        [](unsigned char ch) { return std::isspace(ch); }).base();
     
-    // Build boundary markers
-    std::string boundary_start = "--" + std::string(boundary);
-    std::string boundary_end = "--" + std::string(boundary) + "--";
+    return (start < end) ? std::string(start, end) : std::string();
+}
+
+void parseContentDisposition(std::string_view value, MultipartPart& part) {
+    // Format: form-data; name="field"; filename="file.txt"
     
     size_t pos = 0;
-    
-    // Find first boundary
-    size_t start = body.find(boundary_start, pos);
-    if (start == std::string_view::npos) {
-        return false;
-    }
-    
-    start += boundary_start.length();
-    
-    while (start < body.size()) {
-        // Skip CRLF after boundary
-        if (start < body.size() - 1 && body[start] == '\r' && body[start + 1] == '\n') {
-            start += 2;
-        }
-        
-        // Find next boundary
-        size_t next_boundary = body.find(boundary_start, start);
-        if (next_boundary == std::string_view::npos) {
-            break;
+    while (pos < value.size()) {
+        // Skip whitespace and semicolons
+        while (pos < value.size() && (std::isspace(static_cast<unsigned char>(value[pos])) || value[pos] == ';')) {
+            ++pos;
         }
         
-        // Extract part (between boundaries)
-        std::string_view part_data = body.substr(start, next_boundary - start);
-        
-        // Find headers/body separator (double CRLF)
-        size_t header_end = part_data.find("\r\n\r\n");
-        if (header_end == std::string_view::npos) {
-            start = next_boundary + boundary_start.length();
-            continue;
+        // Find next semicolon or end
+        size_t end = value.find(';', pos);
+        if (end == std::string_view::npos) {
+            end = value.size();
         }
         
-        MultipartPart part;
+        std::string param = trim(value.substr(pos, end - pos));
         
-        // Parse headers
-        std::string_view headers_section = part_data.substr(0, header_end);
-        parsePartHeaders(headers_section, part);
-        
-        // Extract body (remove trailing CRLF before boundary)
-        std::string_view body_section = part_data.substr(header_end + 4);
-        while (!body_section.empty() && 
-               (body_section.back() == '\r' || body_section.back() == '\n')) {
-            body_section.remove_suffix(1);
+        // Parse key=value
+        size_t eq = param.find('=');
+        if (eq != std::string::npos) {
+            std::string key = trim(std::string_view(param).substr(0, eq));
+            std::string val = trim(std::string_view(param).substr(eq + 1));
+            
+            // Remove quotes
+            if (val.size() >= 2 && val.front() == '"' && val.back() == '"') {
+                val = val.substr(1, val.size() - 2);
+            }
+            
+            if (key == "name") {
+                part.name = val;
+            } else if (key == "filename") {
+                part.filename = val;
+            }
         }
         
-        // Copy binary data
-        part.data.assign(body_section.begin(), body_section.end());
-        
-        parts_.push_back(std::move(part));
-        
-        // Move to next part
-        start = next_boundary + boundary_start.length();
-        
-        // Check for end boundary
-        if (body.substr(next_boundary, boundary_end.length()) == boundary_end) {
-            break;
-        }
+        pos = end;
     }
-    
-    return !parts_.empty();
 }
 
-void MultipartParser::parsePartHeaders(std::string_view header_section, MultipartPart& part) {
+void parsePartHeaders(std::string_view header_section, MultipartPart& part) {
     size_t pos = 0;
     
     while (pos < header_section.size()) {
@@ -106,9 +90,7 @@ void MultipartParser::parsePartHeaders(std::string_view header_section, Multipar
                 std::string value = trim(line.substr(colon + 1));
                 
                 // Convert header name to lowercase
-                std::transform(name.begin(), name.end(), name.begin(), ::tolower);
-                
-                part.headers[name] = value;
+                std::transform(name.begin(), name.end(), name.begin(), asciiLower);
                 
                 // Parse Content-Disposition
                 if (name == "content-disposition") {
@@ -118,6 +100,8 @@ void MultipartParser::parsePartHeaders(std::string_view header_section, Multipar
                 else if (name == "content-type") {
                     part.content_type = value;
                 }
+                
+                part.headers[std::move(name)] = std::move(value);
             }
         }
         
@@ -125,73 +109,338 @@ void MultipartParser::parsePartHeaders(std::string_view header_section, Multipar
     }
 }
 
-void MultipartParser::parseContentDisposition(std::string_view value, MultipartPart& part) {
-    // Format: form-data; name="field"; filename="file.txt"
+} // namespace
+
+// ============================================================================
+// Sinks and helpers
+// ============================================================================
+
+PartSink fileSink(const std::filesystem::path& path) {
+    struct Output {
+        utils::FileHandle file;
+        std::filesystem::path path;
+        bool complete = false;
+        
+        ~Output() {
+            if (!complete) {
+                file.close();
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+            }
+        }
+    };
     
-    size_t pos = 0;
-    while (pos < value.size()) {
-        // Skip whitespace and semicolons
-        while (pos < value.size() && (std::isspace(value[pos]) || value[pos] == ';')) {
-            ++pos;
+    auto file = utils::FileHandle::create(path);
+    if (!file) {
+        return {};
+    }
+    
+    auto output = std::make_shared<Output>();
+    output->file = std::move(*file);
+    output->path = path;
+    
+    return [output](std::string_view data, bool last) {
+        if (!data.empty() && !output->file.writeAll(data.data(), data.size())) {
+            return false;
         }
+        if (last) {
+            output->file.close();
+            output->complete = true;
+        }
+        return true;
+    };
+}
+
+std::optional<std::string_view> multipartBoundary(std::string_view content_type) noexcept {
+    auto semicolon = content_type.find(';');
+    std::string_view type = content_type.substr(0, semicolon);
+    while (!type.empty() && (type.back() == ' ' || type.back() == '\t')) type.remove_suffix(1);
+    if (!equalsIgnoreCase(type, "multipart/form-data") || semicolon == std::string_view::npos) {
+        return std::nullopt;
+    }
+    
+    std::string_view params = content_type.substr(semicolon + 1);
+    while (!params.empty()) {
+        auto end = params.find(';');
+        std::string_view param = params.substr(0, end);
+        params = end == std::string_view::npos ? std::string_view() : params.substr(end + 1);
         
-        // Find next semicolon or end
-        size_t end = value.find(';', pos);
-        if (end == std::string_view::npos) {
-            end = value.size();
+        while (!param.empty() && (param.front() == ' ' || param.front() == '\t')) param.remove_prefix(1);
+        auto eq = param.find('=');
+        if (eq == std::string_view::npos || !equalsIgnoreCase(param.substr(0, eq), "boundary")) {
+            continue;
+        }
+        
+        std::string_view value = param.substr(eq + 1);
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) value.remove_suffix(1);
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+            value = value.substr(1, value.size() - 2);
+        }
+        // RFC 2046: 1 to 70 characters
+        if (value.empty() || value.size() > 70) {
+            return std::nullopt;
+        }
+        return value;
+    }
+    return std::nullopt;
+}
+
+// ============================================================================
+// Streaming parser
+// ============================================================================
+
+void MultipartStreamParser::Searcher::build(std::string_view needle) {
+    pattern = needle;
+    skip.fill(pattern.size());
+    for (size_t i = 0; i + 1 < pattern.size(); ++i) {
+        skip[static_cast<unsigned char>(pattern[i])] = pattern.size() - 1 - i;
+    }
+}
+
+size_t MultipartStreamParser::Searcher::find(std::string_view text) const noexcept {
+    const size_t m = pattern.size();
+    if (text.size() < m) {
+        return std::string_view::npos;
+    }
+    
+    // Compare the last byte first; on a mismatch skip by that byte's shift
+    const char* p = text.data();
+    const char last = pattern[m - 1];
+    for (size_t pos = 0; pos <= text.size() - m;) {
+        char c = p[pos + m - 1];
+        if (c == last && std::memcmp(p + pos, pattern.data(), m - 1) == 0) {
+            return pos;
+        }
+        pos += skip[static_cast<unsigned char>(c)];
+    }
+    return std::string_view::npos;
+}
+
+MultipartStreamParser::MultipartStreamParser(std::string_view boundary, PartSinkFactory factory)
+    : MultipartStreamParser(boundary, std::move(factory), Limits{}) {}
+
+MultipartStreamParser::MultipartStreamParser(std::string_view boundary, PartSinkFactory factory, Limits limits)
+    : factory_(std::move(factory)), limits_(limits) {
+    delimiter_.build("\r\n--" + std::string(boundary));
+    
+    // The first boundary may open the body without a preceding CRLF
+    carry_ = "\r\n";
+    
+    if (boundary.empty()) {
+        fail("Empty multipart boundary");
+    }
+}
+
+MultipartStreamParser::Status MultipartStreamParser::feed(std::string_view data) {
+    while (!data.empty() && status_ == Status::NeedMore) {
+        switch (state_) {
+            case State::Preamble:
+            case State::Body:
+                data = consumeBody(data);
+                break;
+            case State::AfterBoundary:
+                data = consumeAfterBoundary(data);
+                break;
+            case State::Headers:
+                data = consumeHeaders(data);
+                break;
+            case State::Done:
+                return status_;
+        }
+    }
+    return status_;
+}
+
+std::string_view MultipartStreamParser::consumeBody(std::string_view data) {
+    const size_t m = delimiter_.pattern.size();
+    
+    // A delimiter may start in the carried tail: search the tail plus
+    // enough of the new bytes to complete one
+    if (!carry_.empty()) {
+        size_t take = std::min(data.size(), m - 1);
+        window_.assign(carry_);
+        window_.append(data.substr(0, take));
+        
+        size_t hit = std::string_view(window_).find(delimiter_.pattern);
+        if (hit != std::string_view::npos) {
+            if (!emit(std::string_view(window_).substr(0, hit))) return {};
+            size_t consumed = hit + m - carry_.size();
+            carry_.clear();
+            if (!endPart()) return {};
+            return data.substr(consumed);
         }
         
-        std::string_view param = trim(value.substr(pos, end - pos));
+        if (take == data.size()) {
+            // Everything is in the window: keep a tail that may still grow into a delimiter
+            size_t keep = std::min(window_.size(), m - 1);
+            if (!emit(std::string_view(window_).substr(0, window_.size() - keep))) return {};
+            carry_.assign(window_, window_.size() - keep, keep);
+            return {};
+        }
         
-        // Parse key=value
-        size_t eq = param.find('=');
-        if (eq != std::string_view::npos) {
-            std::string key = trim(param.substr(0, eq));
-            std::string val = trim(param.substr(eq + 1));
-            
-            // Remove quotes
-            if (val.size() >= 2 && val.front() == '"' && val.back() == '"') {
-                val = val.substr(1, val.size() - 2);
+        // No delimiter starts in the tail
+        if (!emit(carry_)) return {};
+        carry_.clear();
+    }
+    
+    size_t hit = delimiter_.find(data);
+    if (hit != std::string_view::npos) {
+        if (!emit(data.substr(0, hit))) return {};
+        if (!endPart()) return {};
+        return data.substr(hit + m);
+    }
+    
+    size_t keep = std::min(data.size(), m - 1);
+    if (!emit(data.substr(0, data.size() - keep))) return {};
+    carry_.assign(data.substr(data.size() - keep));
+    return {};
+}
+
+std::string_view MultipartStreamParser::consumeAfterBoundary(std::string_view data) {
+    // "--" closes the body; otherwise transport padding, then CRLF
+    while (!data.empty()) {
+        char c = data.front();
+        data.remove_prefix(1);
+        after_.push_back(c);
+        
+        if (after_ == "--") {
+            state_ = State::Done;
+            status_ = Status::Complete;
+            return {};
+        }
+        if (c == '\n') {
+            if (after_.size() < 2 || after_[after_.size() - 2] != '\r') {
+                fail("Malformed multipart boundary");
+                return {};
             }
-            
-            if (key == "name") {
-                part.name = val;
-            } else if (key == "filename") {
-                part.filename = val;
+            after_.clear();
+            if (part_count_ == limits_.max_parts) {
+                fail("Too many multipart parts");
+                return {};
             }
+            header_buf_.clear();
+            state_ = State::Headers;
+            return data;
+        }
+        if (after_.size() > 256 || (c != ' ' && c != '\t' && c != '\r' && c != '-')) {
+            fail("Malformed multipart boundary");
+            return {};
         }
-        
-        pos = end;
     }
+    return data;
 }
 
-std::string MultipartParser::trim(std::string_view str) {
-    auto start = std::find_if_not(str.begin(), str.end(), 
-        [](unsigned char ch) { return std::isspace(ch); });
+std::string_view MultipartStreamParser::consumeHeaders(std::string_view data) {
+    size_t before = header_buf_.size();
+    size_t room = limits_.max_header_bytes + 4 - before;
+    header_buf_.append(data.substr(0, std::min(data.size(), room)));
     
-    auto end = std::find_if_not(str.rbegin(), str.rend(), 
-        [](unsigned char ch) { return std::isspace(ch); }).base();
+    // A part without headers starts with the blank line itself
+    size_t end = std::string_view::npos;
+    size_t terminator = 4;
+    if (header_buf_.starts_with("\r\n")) {
+        end = 0;
+        terminator = 2;
+    } else {
+        end = header_buf_.find("\r\n\r\n", before >= 3 ? before - 3 : 0);
+    }
     
-    return (start < end) ? std::string(start, end) : std::string();
+    if (end == std::string::npos) {
+        if (header_buf_.size() > limits_.max_header_bytes) {
+            fail("Multipart part headers too large");
+        }
+        return {};
+    }
+    
+    size_t consumed = end + terminator - before;
+    
+    part_ = MultipartPart{};
+    parsePartHeaders(std::string_view(header_buf_).substr(0, end), part_);
+    ++part_count_;
+    sink_ = factory_ ? factory_(part_) : PartSink{};
+    
+    state_ = State::Body;
+    return data.substr(consumed);
+}
+
+bool MultipartStreamParser::emit(std::string_view data) {
+    if (state_ != State::Body || data.empty() || !sink_) {
+        return true;  // Preamble, or a discarded part
+    }
+    if (!sink_(data, false)) {
+        fail("Multipart part rejected by its sink");
+        return false;
+    }
+    return true;
+}
+
+bool MultipartStreamParser::endPart() {
+    if (state_ == State::Body && sink_) {
+        if (!sink_({}, true)) {
+            fail("Multipart part rejected by its sink");
+            return false;
+        }
+    }
+    sink_ = {};
+    state_ = State::AfterBoundary;
+    after_.clear();
+    return true;
+}
+
+MultipartStreamParser::Status MultipartStreamParser::fail(std::string_view message) noexcept {
+    status_ = Status::Error;
+    error_ = message;
+    sink_ = {};
+    return status_;
+}
+
+// ============================================================================
+// Buffered parser
+// ============================================================================
+
+bool MultipartParser::parse(std::string_view body, std::string_view boundary) {
+    parts_.clear();
+    
+    if (boundary.empty()) {
+        return false;
+    }
+    
+    size_t complete = 0;
+    MultipartStreamParser parser(boundary, [this, &complete](const MultipartPart& part) -> PartSink {
+        parts_.push_back(part);
+        size_t index = parts_.size() - 1;
+        return [this, index, &complete](std::string_view bytes, bool last) {
+            auto& data = parts_[index].data;
+            data.insert(data.end(), bytes.begin(), bytes.end());
+            complete += last ? 1 : 0;
+            return true;
+        };
+    });
+    
+    // A part is only kept once its closing delimiter was seen
+    auto status = parser.feed(body);
+    parts_.resize(complete);
+    
+    return status != MultipartStreamParser::Status::Error && !parts_.empty();
 }
 
-std::optional<MultipartPart> MultipartParser::findPart(std::string_view name) const {
+const MultipartPart* MultipartParser::findPart(std::string_view name) const noexcept {
     for (const auto& part : parts_) {
         if (part.name == name) {
-            return part;
+            return &part;
         }
     }
-    return std::nullopt;
+    return nullptr;
 }
 
-std::vector<MultipartPart> MultipartParser::getFileParts() const {
-    std::vector<MultipartPart> files;
+std::vector<const MultipartPart*> MultipartParser::getFileParts() const {
+    std::vector<const MultipartPart*> files;
     for (const auto& part : parts_) {
         if (!part.filename.empty()) {
-            files.push_back(part);
+            files.push_back(&part);
         }
     }
     return files;
 }
 
-} // namespace frqs::http
\ No newline at end of file
+} // namespace frqs::http
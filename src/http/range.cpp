@@ -0,0 +1,153 @@
+/**
+ * @file http/range.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Range requests: byte-range parsing and multipart/byteranges framing
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "http/range.hpp"
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <random>
+
+namespace frqs::http {
+
+namespace {
+
+std::string_view trim(std::string_view s) noexcept {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1) ;
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1) ;
+    return s ;
+}
+
+bool parseNumber(std::string_view text, uint64_t& value) noexcept {
+    if (text.empty()) {
+        return false ;
+    }
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value) ;
+    return ec == std::errc{} && ptr == text.data() + text.size() ;
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) noexcept {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return (x | 0x20) == (y | 0x20) ;
+    }) ;
+}
+
+} // namespace
+
+std::optional<std::vector<ByteRange>> parseRange(std::string_view header, uint64_t size, size_t max_ranges) {
+    header = trim(header) ;
+    auto equals = header.find('=') ;
+    if (equals == std::string_view::npos || !equalsIgnoreCase(trim(header.substr(0, equals)), "bytes")) {
+        return std::nullopt ;
+    }
+    header.remove_prefix(equals + 1) ;
+
+    std::vector<ByteRange> ranges ;
+    size_t specs = 0 ;
+    while (!header.empty()) {
+        auto comma = header.find(',') ;
+        auto spec = trim(header.substr(0, comma)) ;
+        header.remove_prefix(comma == std::string_view::npos ? header.size() : comma + 1) ;
+        if (spec.empty()) {
+            continue ;      // Empty list elements are allowed
+        }
+        if (++specs > max_ranges) {
+            return std::nullopt ;
+        }
+
+        auto dash = spec.find('-') ;
+        if (dash == std::string_view::npos) {
+            return std::nullopt ;
+        }
+        auto first_text = spec.substr(0, dash) ;
+        auto last_text = spec.substr(dash + 1) ;
+
+        if (first_text.empty()) {
+            // "-500": the last 500 bytes
+            uint64_t suffix = 0 ;
+            if (!parseNumber(last_text, suffix)) {
+                return std::nullopt ;
+            }
+            if (suffix > 0 && size > 0) {
+                auto length = std::min(suffix, size) ;
+                ranges.push_back({size - length, length}) ;
+            }
+            continue ;
+        }
+
+        uint64_t first = 0 ;
+        if (!parseNumber(first_text, first)) {
+            return std::nullopt ;
+        }
+        uint64_t last = UINT64_MAX ;
+        if (!last_text.empty()) {
+            if (!parseNumber(last_text, last) || last < first) {
+                return std::nullopt ;
+            }
+        }
+        if (first < size) {
+            last = std::min(last, size - 1) ;
+            ranges.push_back({first, last - first + 1}) ;
+        }
+    }
+
+    if (specs == 0) {
+        return std::nullopt ;
+    }
+
+    // Kept in the client's order unless two touch, then merged in offset order
+    auto sorted = ranges ;
+    std::sort(sorted.begin(), sorted.end(), [](const ByteRange& a, const ByteRange& b) {
+        return a.offset < b.offset ;
+    }) ;
+    bool touching = false ;
+    for (size_t i = 1 ; i < sorted.size() && !touching ; ++i) {
+        touching = sorted[i].offset <= sorted[i - 1].last() + 1 ;
+    }
+    if (!touching) {
+        return ranges ;
+    }
+
+    std::vector<ByteRange> merged ;
+    for (const auto& range : sorted) {
+        if (!merged.empty() && range.offset <= merged.back().last() + 1) {
+            auto end = std::max(merged.back().last(), range.last()) ;
+            merged.back().length = end - merged.back().offset + 1 ;
+        } else {
+            merged.push_back(range) ;
+        }
+    }
+    return merged ;
+}
+
+std::string contentRange(ByteRange range, uint64_t size) {
+    return std::format("bytes {}-{}/{}", range.offset, range.last(), size) ;
+}
+
+std::string unsatisfiedRange(uint64_t size) {
+    return std::format("bytes */{}", size) ;
+}
+
+std::string byteRangesBoundary() {
+    static thread_local std::mt19937_64 random{std::random_device{}()} ;
+    return std::format("frqs-{:016x}", random()) ;
+}
+
+std::string byteRangesPartHead(std::string_view boundary, std::string_view content_type,
+                               ByteRange range, uint64_t size) {
+    return std::format("\r\n--{}\r\nContent-Type: {}\r\nContent-Range: {}\r\n\r\n",
+                       boundary, content_type, contentRange(range, size)) ;
+}
+
+std::string byteRangesTail(std::string_view boundary) {
+    return std::format("\r\n--{}--\r\n", boundary) ;
+}
+
+} // namespace frqs::http
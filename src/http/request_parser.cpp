@@ -0,0 +1,612 @@
+/**
+ * @file http/request_parser.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Incremental HTTP/1.x request parser
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "http/request_parser.hpp"
+#include "utils/byte_scan.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace frqs::http {
+
+namespace {
+
+// Buffers above this size are shrunk back once they are drained
+constexpr size_t SHRINK_THRESHOLD = 256 * 1024 ;
+constexpr size_t DEFAULT_CAPACITY = 16 * 1024 ;
+
+bool isOws(char c) noexcept {
+    return c == ' ' || c == '\t' ;
+}
+
+std::string_view trimOws(std::string_view value) noexcept {
+    while (!value.empty() && isOws(value.front())) value.remove_prefix(1) ;
+    while (!value.empty() && isOws(value.back())) value.remove_suffix(1) ;
+    return value ;
+}
+
+} // namespace
+
+// ============================================================================
+// Input
+// ============================================================================
+
+ParseStatus RequestParser::feed(std::string_view data) {
+    auto space = prepare(data.size()) ;
+    if (!data.empty()) {
+        std::memcpy(space.data(), data.data(), data.size()) ;
+    }
+    return commit(data.size()) ;
+}
+
+std::span<char> RequestParser::prepare(size_t min_size) {
+    // Streamed body bytes the caller has taken make room for new ones
+    if (streaming_ && body_taken_ > body_dropped_ && status_ == ParseStatus::NeedMore) {
+        dropTakenBody() ;
+    }
+
+    size_t capacity = buffer_.capacity() ;
+    if (capacity - size_ < min_size) {
+        size_t wanted = std::max({size_ + min_size, capacity * 2, DEFAULT_CAPACITY}) ;
+
+        // A declared body gets a buffer sized for it once, instead of
+        // being copied again at every doubling
+        if (state_ == State::Body && !streaming_) {
+            wanted = std::max(size_ + min_size, body_start_ + *content_length_) ;
+        }
+        regrow(wanted) ;
+    }
+    return {buffer_.data() + size_, buffer_.capacity() - size_} ;
+}
+
+ParseStatus RequestParser::commit(size_t n) {
+    size_ += std::min(n, buffer_.capacity() - size_) ;
+    if (status_ != ParseStatus::NeedMore || paused_) {
+        return status_ ;  // Bytes stay buffered for the next message (or the body decision)
+    }
+    return parse() ;
+}
+
+ParseStatus RequestParser::next() {
+    if (status_ != ParseStatus::Complete) {
+        return status_ ;
+    }
+
+    size_t leftover = size_ - message_end_ ;
+    request_.storage_.reset() ;
+
+    // Pipelined bytes go to the front; they have not been scanned yet. If a
+    // copy of the finished request still reads this buffer (or it grew
+    // large), they move to a fresh one instead.
+    if (!buffer_.unique() || (buffer_.capacity() > SHRINK_THRESHOLD && leftover < DEFAULT_CAPACITY)) {
+        auto fresh = utils::BufferPool::instance().acquire(std::max(leftover, DEFAULT_CAPACITY)) ;
+        if (leftover > 0) {
+            std::memcpy(fresh.data(), buffer_.data() + message_end_, leftover) ;
+        }
+        buffer_ = std::move(fresh) ;
+    } else if (leftover > 0) {
+        std::memmove(buffer_.data(), buffer_.data() + message_end_, leftover) ;
+    }
+
+    reset() ;
+    size_ = leftover ;
+
+    return size_ > 0 ? parse() : status_ ;
+}
+
+void RequestParser::reset() noexcept {
+    // Never write over bytes a copied request still points into
+    request_.storage_.reset() ;
+    if (buffer_ && !buffer_.unique()) {
+        buffer_.reset() ;
+    }
+
+    size_ = 0 ;
+    message_start_ = 0 ;
+    message_end_ = 0 ;
+    scan_pos_ = 0 ;
+    line_scan_ = 0 ;
+    line_colon_ = NO_COLON ;
+    state_ = State::RequestLine ;
+    status_ = ParseStatus::NeedMore ;
+    method_ = {} ;
+    target_ = {} ;
+    version_ = {} ;
+    headers_.clear() ;
+    content_length_.reset() ;
+    chunked_ = false ;
+    expect_continue_ = false ;
+    body_start_ = 0 ;
+    body_length_ = 0 ;
+    body_limit_ = limits_.max_body_bytes ;
+    chunk_remaining_ = 0 ;
+    trailer_bytes_ = 0 ;
+    paused_ = false ;
+    streaming_ = false ;
+    body_taken_ = 0 ;
+    body_dropped_ = 0 ;
+    error_ = {} ;
+    error_status_ = 400 ;
+}
+
+void RequestParser::releaseBuffer() noexcept {
+    if (size_ == 0 && state_ == State::RequestLine) {
+        request_.storage_.reset() ;
+        buffer_.reset() ;
+    }
+}
+
+Method RequestParser::method() const noexcept {
+    return parseMethod(std::string_view(buffer_.data() + method_.offset, method_.length)) ;
+}
+
+std::string_view RequestParser::path() const noexcept {
+    std::string_view target(buffer_.data() + target_.offset, target_.length) ;
+    return target.substr(0, target.find('?')) ;
+}
+
+// ============================================================================
+// Body streaming
+// ============================================================================
+
+ParseStatus RequestParser::resume() {
+    if (!paused_) {
+        return status_ ;
+    }
+    paused_ = false ;
+    if (content_length_ && *content_length_ > body_limit_) {
+        return fail("Request too large", 413) ;
+    }
+    return parse() ;
+}
+
+ParseStatus RequestParser::streamBody(size_t max_bytes) {
+    if (!paused_) {
+        return status_ ;
+    }
+    paused_ = false ;
+    streaming_ = true ;
+    body_limit_ = max_bytes > 0 ? max_bytes : SIZE_MAX ;
+    if (content_length_ && *content_length_ > body_limit_) {
+        return fail("Request too large", 413) ;
+    }
+
+    // Request line and headers stay where they are; only bytes after
+    // body_start_ are ever moved while streaming
+    materialize(request_) ;
+    return parse() ;
+}
+
+std::string_view RequestParser::takeBody() noexcept {
+    if (!streaming_) {
+        return {} ;
+    }
+    size_t begin = body_start_ + (body_taken_ - body_dropped_) ;
+    size_t end = body_start_ + (body_length_ - body_dropped_) ;
+    body_taken_ = body_length_ ;
+    return {buffer_.data() + begin, end - begin} ;
+}
+
+void RequestParser::dropTakenBody() noexcept {
+    char* base = buffer_.data() ;
+
+    // Decoded bytes not handed out yet, then undecoded input, move down to body_start_
+    size_t keep = body_length_ - body_taken_ ;
+    size_t decoded_end = body_start_ + (body_length_ - body_dropped_) ;
+    if (keep > 0) {
+        std::memmove(base + body_start_, base + decoded_end - keep, keep) ;
+    }
+
+    size_t raw = size_ - scan_pos_ ;
+    size_t raw_dest = body_start_ + keep ;
+    if (raw > 0) {
+        std::memmove(base + raw_dest, base + scan_pos_, raw) ;
+    }
+
+    size_t shift = scan_pos_ - raw_dest ;
+    line_scan_ = line_scan_ > scan_pos_ ? line_scan_ - shift : raw_dest ;
+    scan_pos_ = raw_dest ;
+    size_ = raw_dest + raw ;
+    body_dropped_ = body_taken_ ;
+}
+
+void RequestParser::regrow(size_t capacity) {
+    auto fresh = utils::BufferPool::instance().acquire(capacity) ;
+    if (size_ > 0) {
+        std::memcpy(fresh.data(), buffer_.data(), size_) ;
+    }
+    buffer_ = std::move(fresh) ;
+}
+
+// ============================================================================
+// State machine
+// ============================================================================
+
+std::optional<RequestParser::Line> RequestParser::nextLine(bool find_colon) {
+    line_scan_ = std::max(line_scan_, scan_pos_) ;
+    const char* begin = buffer_.data() ;
+
+    while (line_scan_ < size_) {
+        size_t remaining = size_ - line_scan_ ;
+
+        // Only the first colon matters; values may contain more
+        size_t hit = (find_colon && line_colon_ == NO_COLON)
+            ? utils::findFirstOf(begin + line_scan_, remaining, '\r', '\n', ':')
+            : utils::findFirstOf(begin + line_scan_, remaining, '\r', '\n') ;
+        if (hit == remaining) {
+            break ;
+        }
+
+        size_t pos = line_scan_ + hit ;
+        if (begin[pos] == ':') {
+            line_colon_ = pos - scan_pos_ ;
+            line_scan_ = pos + 1 ;
+            continue ;
+        }
+
+        size_t next = pos + 1 ;
+        if (begin[pos] == '\r') {
+            if (next == size_) {
+                line_scan_ = pos ;  // LF not received yet
+                return std::nullopt ;
+            }
+            if (begin[next] != '\n') {
+                fail("Bare CR in request", 400) ;
+                return std::nullopt ;
+            }
+            ++next ;
+        }
+
+        Line line{std::string_view(begin + scan_pos_, pos - scan_pos_), line_colon_} ;
+        scan_pos_ = line_scan_ = next ;
+        line_colon_ = NO_COLON ;
+        return line ;
+    }
+
+    line_scan_ = size_ ;  // Resume here once more bytes arrive
+    return std::nullopt ;
+}
+
+ParseStatus RequestParser::parse() {
+    while (true) {
+        switch (state_) {
+            case State::RequestLine:
+            case State::Headers: {
+                auto line = nextLine(state_ == State::Headers) ;
+                if (status_ == ParseStatus::Error) {
+                    return status_ ;
+                }
+
+                size_t head_bytes = (line ? scan_pos_ : size_) - message_start_ ;
+                if (head_bytes > limits_.max_header_bytes) {
+                    return fail("Request header fields too large", 431) ;
+                }
+                if (!line) {
+                    return ParseStatus::NeedMore ;
+                }
+
+                size_t offset = static_cast<size_t>(line->text.data() - buffer_.data()) ;
+
+                if (state_ == State::RequestLine) {
+                    if (line->text.empty()) {
+                        message_start_ = scan_pos_ ;  // Ignore leading CRLFs (RFC 9112 2.2)
+                        continue ;
+                    }
+                    if (!onRequestLine(line->text, offset)) return status_ ;
+                    state_ = State::Headers ;
+                } else if (line->text.empty()) {
+                    if (!onHeadersEnd()) return status_ ;
+                    if (state_ == State::Done) return finish() ;
+                    if (paused_) return ParseStatus::NeedMore ;
+                } else if (!onHeaderLine(*line, offset)) {
+                    return status_ ;
+                }
+                break ;
+            }
+
+            case State::Body: {
+                size_t wanted = *content_length_ - body_length_ ;
+                size_t take = std::min(wanted, size_ - scan_pos_) ;
+                body_length_ += take ;
+                scan_pos_ += take ;
+                if (body_length_ < *content_length_) {
+                    return ParseStatus::NeedMore ;
+                }
+                return finish() ;
+            }
+
+            case State::ChunkSize: {
+                auto line = nextLine(false) ;
+                if (status_ == ParseStatus::Error) {
+                    return status_ ;
+                }
+                if (!line) {
+                    if (size_ - scan_pos_ > 1024) {
+                        return fail("Malformed chunk size", 400) ;
+                    }
+                    return ParseStatus::NeedMore ;
+                }
+                if (!onChunkSize(line->text)) return status_ ;
+                break ;
+            }
+
+            case State::ChunkData: {
+                if (chunk_remaining_ > 0) {
+                    size_t take = std::min(chunk_remaining_, size_ - scan_pos_) ;
+                    size_t dest = body_start_ + body_length_ - body_dropped_ ;
+
+                    // Decode in place: the body always trails the encoded input
+                    if (dest != scan_pos_ && take > 0) {
+                        std::memmove(buffer_.data() + dest, buffer_.data() + scan_pos_, take) ;
+                    }
+
+                    body_length_ += take ;
+                    scan_pos_ += take ;
+                    chunk_remaining_ -= take ;
+                    if (chunk_remaining_ > 0) {
+                        return ParseStatus::NeedMore ;
+                    }
+                }
+
+                // Chunk data is followed by CRLF
+                auto line = nextLine(false) ;
+                if (status_ == ParseStatus::Error) {
+                    return status_ ;
+                }
+                if (!line) {
+                    if (size_ - scan_pos_ >= 2) {
+                        return fail("Malformed chunk terminator", 400) ;
+                    }
+                    return ParseStatus::NeedMore ;
+                }
+                if (!line->text.empty()) {
+                    return fail("Malformed chunk terminator", 400) ;
+                }
+                state_ = State::ChunkSize ;
+                break ;
+            }
+
+            case State::ChunkTrailers: {
+                auto line = nextLine(false) ;
+                if (status_ == ParseStatus::Error) {
+                    return status_ ;
+                }
+                size_t pending = line ? line->text.size() + 2 : size_ - scan_pos_ ;
+                if (trailer_bytes_ + pending > limits_.max_header_bytes) {
+                    return fail("Request trailers too large", 431) ;
+                }
+                if (!line) {
+                    return ParseStatus::NeedMore ;
+                }
+                if (line->text.empty()) {
+                    return finish() ;
+                }
+                trailer_bytes_ += pending ;
+                break ;  // Trailer fields are not exposed
+            }
+
+            case State::Done:
+                return ParseStatus::Complete ;
+        }
+    }
+}
+
+bool RequestParser::onRequestLine(std::string_view line, size_t offset) {
+    // Format: METHOD SP request-target SP HTTP-version
+    auto method_end = line.find(' ') ;
+    if (method_end == std::string_view::npos || method_end == 0) {
+        fail("Invalid request line: no method", 400) ;
+        return false ;
+    }
+
+    auto target_end = line.find(' ', method_end + 1) ;
+    if (target_end == std::string_view::npos || target_end == method_end + 1) {
+        fail("Invalid request line: no URI", 400) ;
+        return false ;
+    }
+
+    std::string_view version = line.substr(target_end + 1) ;
+
+    if (parseMethod(line.substr(0, method_end)) == Method::UNKNOWN) {
+        fail("Unsupported HTTP method", 501) ;
+        return false ;
+    }
+    if (version != "HTTP/1.1" && version != "HTTP/1.0") {
+        fail("Unsupported HTTP version", 505) ;
+        return false ;
+    }
+
+    method_ = {offset, method_end} ;
+    target_ = {offset + method_end + 1, target_end - method_end - 1} ;
+    version_ = {offset + target_end + 1, version.size()} ;
+    return true ;
+}
+
+bool RequestParser::onHeaderLine(const Line& line, size_t offset) {
+    std::string_view text = line.text ;
+    if (isOws(text.front())) {
+        fail("Obsolete header line folding", 400) ;
+        return false ;
+    }
+
+    size_t colon = line.colon ;
+    if (colon == NO_COLON || colon == 0 || isOws(text[colon - 1])) {
+        fail("Malformed header field", 400) ;
+        return false ;
+    }
+
+    std::string_view name = text.substr(0, colon) ;
+    std::string_view value = trimOws(text.substr(colon + 1)) ;
+    size_t value_offset = value.empty() ? offset + colon + 1
+                                        : static_cast<size_t>(value.data() - buffer_.data()) ;
+
+    KnownHeader id = knownHeader(name) ;
+    headers_.push_back({{offset, name.size()}, {value_offset, value.size()}, id}) ;
+
+    // Framing headers are interpreted while they stream past
+    switch (id) {
+        case KnownHeader::ContentLength: {
+            if (value.empty()) {
+                fail("Invalid Content-Length", 400) ;
+                return false ;
+            }
+            size_t length = 0 ;
+            for (char c : value) {
+                if (c < '0' || c > '9' || length > (SIZE_MAX - 9) / 10) {
+                    fail("Invalid Content-Length", 400) ;
+                    return false ;
+                }
+                length = length * 10 + static_cast<size_t>(c - '0') ;
+            }
+            if (content_length_ && *content_length_ != length) {
+                fail("Conflicting Content-Length headers", 400) ;
+                return false ;
+            }
+            content_length_ = length ;
+            break ;
+        }
+        case KnownHeader::TransferEncoding:
+            // Only a lone chunked is decoded: under "gzip, chunked" (or a
+            // second Transfer-Encoding line) the body would reach the
+            // handler still coded
+            if (chunked_ || !equalsIgnoreCase(value, "chunked")) {
+                fail("Unsupported transfer encoding", 501) ;
+                return false ;
+            }
+            chunked_ = true ;
+            break ;
+        case KnownHeader::Expect:
+            expect_continue_ = equalsIgnoreCase(value, "100-continue") ;
+            break ;
+        default:
+            break ;
+    }
+
+    return true ;
+}
+
+bool RequestParser::onHeadersEnd() {
+    body_start_ = scan_pos_ ;
+
+    if (chunked_) {
+        // Both framings at once is how requests are smuggled past a proxy
+        // that reads the other one (RFC 9112 6.1, 6.3); refused, and the
+        // connection closes with the error
+        if (content_length_) {
+            fail("Both Content-Length and Transfer-Encoding", 400) ;
+            return false ;
+        }
+        state_ = State::ChunkSize ;
+        paused_ = pause_before_body_ ;
+        return true ;
+    }
+
+    if (content_length_ && *content_length_ > 0) {
+        state_ = State::Body ;
+        if (pause_before_body_) {
+            paused_ = true ;  // The size limit depends on resume() or streamBody()
+            return true ;
+        }
+        if (*content_length_ > body_limit_) {
+            fail("Request too large", 413) ;
+            return false ;
+        }
+        return true ;
+    }
+
+    state_ = State::Done ;
+    return true ;
+}
+
+bool RequestParser::onChunkSize(std::string_view line) {
+    // chunk-size [ ; chunk-ext ]
+    auto ext = line.find(';') ;
+    std::string_view digits = trimOws(line.substr(0, ext)) ;
+    if (digits.empty()) {
+        fail("Malformed chunk size", 400) ;
+        return false ;
+    }
+
+    size_t size = 0 ;
+    for (char c : digits) {
+        int v = (c >= '0' && c <= '9') ? c - '0'
+              : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+              : (c >= 'A' && c <= 'F') ? c - 'A' + 10
+              : -1 ;
+        if (v < 0 || size > (SIZE_MAX >> 4)) {
+            fail("Malformed chunk size", 400) ;
+            return false ;
+        }
+        size = (size << 4) | static_cast<size_t>(v) ;
+    }
+
+    if (size == 0) {
+        state_ = State::ChunkTrailers ;
+        return true ;
+    }
+
+    if (size > body_limit_ - body_length_) {
+        fail("Request too large", 413) ;
+        return false ;
+    }
+
+    chunk_remaining_ = size ;
+    state_ = State::ChunkData ;
+    return true ;
+}
+
+ParseStatus RequestParser::fail(std::string_view message, uint16_t status) noexcept {
+    status_ = ParseStatus::Error ;
+    error_ = message ;
+    error_status_ = status ;
+    return status_ ;
+}
+
+ParseStatus RequestParser::finish() {
+    state_ = State::Done ;
+    message_end_ = scan_pos_ ;
+    materialize(request_) ;
+    status_ = ParseStatus::Complete ;
+    return status_ ;
+}
+
+void RequestParser::materialize(HTTPRequest& out) const {
+    std::string_view base(buffer_.data(), size_) ;
+    auto view = [base](Span s) { return base.substr(s.offset, s.length) ; } ;
+
+    out.storage_ = buffer_ ;
+    out.method_ = parseMethod(view(method_)) ;
+    out.version_ = view(version_) ;
+
+    std::string_view target = view(target_) ;
+    auto query_start = target.find('?') ;
+    if (query_start != std::string_view::npos) {
+        out.path_ = target.substr(0, query_start) ;
+        out.query_string_ = target.substr(query_start + 1) ;
+    } else {
+        out.path_ = target ;
+        out.query_string_ = {} ;
+    }
+
+    out.headers_.clear() ;
+    for (const auto& field : headers_) {
+        out.headers_.add(view(field.name), view(field.value), field.id) ;
+    }
+
+    out.body_ = streaming_ ? std::string_view() : base.substr(body_start_, body_length_) ;
+
+    out.query_params_.clear() ;
+    out.parseQueryString() ;
+
+    out.is_valid_ = true ;
+    out.error_message_ = {} ;
+}
+
+} // namespace frqs::http
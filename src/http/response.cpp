@@ -10,28 +10,90 @@
  */
 
 #include "http/response.hpp"
-#include <sstream>
+#include "http/header_map.hpp"
+#include "http/status.hpp"
+#include <algorithm>
+#include <charconv>
 
 namespace frqs::http {
 
 HTTPResponse& HTTPResponse::setStatus(uint16_t code, std::string_view message) {
     status_code_ = code;
-    status_message_ = message.empty() ? 
-        std::string(getDefaultStatusMessage(code)) : 
-        std::string(message);
+    status_message_ = message.empty() ? getDefaultStatusMessage(code) : message;
     return *this;
 }
 
 HTTPResponse& HTTPResponse::setHeader(std::string_view name, std::string_view value) {
-    headers_[std::string(name)] = value;
+    auto same = [name](const auto& header) { return equalsIgnoreCase(header.first, name); };
+    auto it = std::find_if(headers_.begin(), headers_.end(), same);
+    if (it == headers_.end()) {
+        headers_.emplace_back(name, value);
+        return *this;
+    }
+    it->second = value;
+    
+    // Repeats added with addHeader() go too
+    headers_.erase(std::remove_if(std::next(it), headers_.end(), same), headers_.end());
+    return *this;
+}
+
+HTTPResponse& HTTPResponse::addHeader(std::string_view name, std::string_view value) {
+    headers_.emplace_back(name, value);
     return *this;
 }
 
 HTTPResponse& HTTPResponse::setBody(std::string body) {
     body_ = std::move(body);
+    file_body_.reset();
+    shared_body_ = {};
+    stream_body_ = nullptr;
+    return *this;
+}
+
+HTTPResponse& HTTPResponse::setSharedBody(std::shared_ptr<const std::string> body) {
+    std::string_view bytes = body ? std::string_view(*body) : std::string_view();
+    return setSharedBody(bytes, std::move(body));
+}
+
+HTTPResponse& HTTPResponse::setSharedBody(std::string_view bytes, std::shared_ptr<const void> owner) {
+    body_.clear();
+    file_body_.reset();
+    stream_body_ = nullptr;
+    shared_body_ = owner ? SharedBody{bytes, std::move(owner)} : SharedBody{};
+    return *this;
+}
+
+SharedBody HTTPResponse::releaseBody() {
+    if (!shared_body_.owner) {
+        auto owned = std::make_shared<const std::string>(std::move(body_));
+        body_.clear();
+        shared_body_ = {*owned, std::move(owned)};
+    }
+    return std::exchange(shared_body_, SharedBody{});
+}
+
+HTTPResponse& HTTPResponse::setStreamBody(StreamBody producer) {
+    body_.clear();
+    file_body_.reset();
+    shared_body_ = {};
+    stream_body_ = std::move(producer);
     return *this;
 }
 
+HTTPResponse& HTTPResponse::setFileBody(std::shared_ptr<const utils::FileHandle> file,
+                                        uint64_t offset, uint64_t length) {
+    body_.clear();
+    shared_body_ = {};
+    stream_body_ = nullptr;
+    file_body_ = FileBody{std::move(file), offset, length};
+    return *this;
+}
+
+HTTPResponse& HTTPResponse::setFileBody(std::shared_ptr<const utils::FileHandle> file) {
+    uint64_t length = file ? file->size() : 0;
+    return setFileBody(std::move(file), 0, length);
+}
+
 HTTPResponse& HTTPResponse::setContentType(std::string_view type) {
     return setHeader("Content-Type", type);
 }
@@ -85,52 +147,82 @@ HTTPResponse& HTTPResponse::forbidden(std::string body) {
 }
 
 std::string HTTPResponse::build() const {
-    std::ostringstream oss;
+    std::string out;
+    out.reserve(256 + static_cast<size_t>(bodySize()));
+    serializeHeaders(out);
     
+    if (file_body_) {
+        // Materialize the file range (build() callers want one string)
+        size_t start = out.size();
+        out.resize(start + static_cast<size_t>(file_body_->length));
+        size_t done = 0;
+        while (done < file_body_->length) {
+            auto n = file_body_->file->readAt(file_body_->offset + done, out.data() + start + done,
+                                              static_cast<size_t>(file_body_->length) - done);
+            if (!n || *n == 0) break;
+            done += *n;
+        }
+        out.resize(start + done);
+    } else {
+        out += getBody();
+    }
+    return out;
+}
+
+void HTTPResponse::serializeHeaders(std::string& out) const {
     // Status line
-    oss << "HTTP/1.1 " << status_code_ << " " << status_message_ << "\r\n";
+    auto status_line = defaultStatusLine(status_code_);
+    if (!status_line.empty() && status_line.substr(13, status_line.size() - 15) == status_message_) {
+        out += status_line;
+    } else {
+        char code[8];
+        auto end = std::to_chars(code, code + sizeof(code), status_code_).ptr;
+        out += "HTTP/1.1 ";
+        out.append(code, end);
+        out += ' ';
+        out += status_message_;
+        out += "\r\n";
+    }
     
-    // Add Content-Length if not already set
-    bool has_content_length = headers_.contains("Content-Length");
-    if (!has_content_length && !body_.empty()) {
-        oss << "Content-Length: " << body_.size() << "\r\n";
+    // Always frame the body so persistent connections can find the next
+    // response; a streamed body is framed by the server (chunked or close)
+    bool has_content_length = getHeader("Content-Length").has_value();
+    if (!has_content_length && !stream_body_ && statusAllowsBody(status_code_)) {
+        char length[24];
+        auto end = std::to_chars(length, length + sizeof(length), bodySize()).ptr;
+        out += "Content-Length: ";
+        out.append(length, end);
+        out += "\r\n";
     }
     
     // Headers
     for (const auto& [name, value] : headers_) {
-        oss << name << ": " << value << "\r\n";
+        out += name;
+        out += ": ";
+        out += value;
+        out += "\r\n";
     }
     
     // End of headers
-    oss << "\r\n";
-    
-    // Body
-    if (!body_.empty()) {
-        oss << body_;
+    out += "\r\n";
+}
+
+std::optional<std::string_view> HTTPResponse::getHeader(std::string_view name) const noexcept {
+    for (const auto& [existing, value] : headers_) {
+        if (equalsIgnoreCase(existing, name)) {
+            return value;
+        }
     }
-    
-    return oss.str();
+    return std::nullopt;
 }
 
 std::string_view HTTPResponse::getDefaultStatusMessage(uint16_t code) noexcept {
-    switch (code) {
-        case 200: return "OK";
-        case 201: return "Created";
-        case 204: return "No Content";
-        case 301: return "Moved Permanently";
-        case 302: return "Found";
-        case 304: return "Not Modified";
-        case 400: return "Bad Request";
-        case 401: return "Unauthorized";
-        case 403: return "Forbidden";
-        case 404: return "Not Found";
-        case 405: return "Method Not Allowed";
-        case 500: return "Internal Server Error";
-        case 501: return "Not Implemented";
-        case 502: return "Bad Gateway";
-        case 503: return "Service Unavailable";
-        default: return "Unknown";
-    }
+    auto reason = statusReason(code);
+    return reason.empty() ? "Unknown" : reason;
+}
+
+std::string_view HTTPResponse::defaultStatusLine(uint16_t code) noexcept {
+    return statusLine(code);
 }
 
 } // namespace frqs::http
\ No newline at end of file
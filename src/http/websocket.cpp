@@ -0,0 +1,520 @@
+/**
+ * @file http/websocket.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief WebSocket handshake, SIMD unmasking and the client frame parser
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "http/websocket.hpp"
+#include "utils/cpu_dispatch.hpp"
+#include "utils/input_buffer.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace frqs::http {
+
+namespace {
+
+constexpr std::string_view HANDSHAKE_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11" ;
+
+// An empty receive buffer larger than this is freed (after a big message)
+constexpr size_t MAX_IDLE_BUFFER = 256 * 1024 ;
+
+// ========== HANDSHAKE ==========
+
+std::array<uint8_t, 20> sha1(std::string_view data) noexcept {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0} ;
+
+    auto block = [&h](const uint8_t* chunk) {
+        uint32_t w[80] ;
+        for (int i = 0 ; i < 16 ; ++i) {
+            w[i] = static_cast<uint32_t>(chunk[4 * i]) << 24 | static_cast<uint32_t>(chunk[4 * i + 1]) << 16 |
+                   static_cast<uint32_t>(chunk[4 * i + 2]) << 8 | static_cast<uint32_t>(chunk[4 * i + 3]) ;
+        }
+        for (int i = 16 ; i < 80 ; ++i) {
+            w[i] = std::rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1) ;
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4] ;
+        for (int i = 0 ; i < 80 ; ++i) {
+            uint32_t f, k ;
+            if (i < 20) {
+                f = (b & c) | (~b & d) ;
+                k = 0x5A827999 ;
+            } else if (i < 40) {
+                f = b ^ c ^ d ;
+                k = 0x6ED9EBA1 ;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d) ;
+                k = 0x8F1BBCDC ;
+            } else {
+                f = b ^ c ^ d ;
+                k = 0xCA62C1D6 ;
+            }
+            uint32_t t = std::rotl(a, 5) + f + e + k + w[i] ;
+            e = d ;
+            d = c ;
+            c = std::rotl(b, 30) ;
+            b = a ;
+            a = t ;
+        }
+        h[0] += a ;
+        h[1] += b ;
+        h[2] += c ;
+        h[3] += d ;
+        h[4] += e ;
+    } ;
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data.data()) ;
+    size_t full = data.size() / 64 * 64 ;
+    for (size_t i = 0 ; i < full ; i += 64) {
+        block(bytes + i) ;
+    }
+
+    // Padding: 0x80, zeros, then the length in bits (big-endian)
+    uint8_t tail[128] = {} ;
+    size_t rest = data.size() - full ;
+    std::memcpy(tail, bytes + full, rest) ;
+    tail[rest] = 0x80 ;
+    size_t tail_size = rest + 9 <= 64 ? 64 : 128 ;
+    uint64_t bits = static_cast<uint64_t>(data.size()) * 8 ;
+    for (int i = 0 ; i < 8 ; ++i) {
+        tail[tail_size - 1 - static_cast<size_t>(i)] = static_cast<uint8_t>(bits >> (8 * i)) ;
+    }
+    block(tail) ;
+    if (tail_size == 128) {
+        block(tail + 64) ;
+    }
+
+    std::array<uint8_t, 20> digest ;
+    for (size_t i = 0 ; i < 5 ; ++i) {
+        for (size_t j = 0 ; j < 4 ; ++j) {
+            digest[4 * i + j] = static_cast<uint8_t>(h[i] >> (24 - 8 * j)) ;
+        }
+    }
+    return digest ;
+}
+
+std::string base64(std::span<const uint8_t> data) {
+    static constexpr char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" ;
+
+    std::string out ;
+    out.reserve((data.size() + 2) / 3 * 4) ;
+    for (size_t i = 0 ; i < data.size() ; i += 3) {
+        uint32_t n = static_cast<uint32_t>(data[i]) << 16 ;
+        if (i + 1 < data.size()) n |= static_cast<uint32_t>(data[i + 1]) << 8 ;
+        if (i + 2 < data.size()) n |= data[i + 2] ;
+
+        out += ALPHABET[(n >> 18) & 63] ;
+        out += ALPHABET[(n >> 12) & 63] ;
+        out += i + 1 < data.size() ? ALPHABET[(n >> 6) & 63] : '=' ;
+        out += i + 2 < data.size() ? ALPHABET[n & 63] : '=' ;
+    }
+    return out ;
+}
+
+std::string_view trim(std::string_view value) noexcept {
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) value.remove_prefix(1) ;
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) value.remove_suffix(1) ;
+    return value ;
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) noexcept {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) {
+        return (x | 0x20) == (y | 0x20) ;
+    }) ;
+}
+
+// Case-insensitive token in a comma-separated header value
+bool hasToken(std::string_view value, std::string_view token) noexcept {
+    while (!value.empty()) {
+        auto comma = value.find(',') ;
+        if (equalsIgnoreCase(trim(value.substr(0, comma)), token)) {
+            return true ;
+        }
+        if (comma == std::string_view::npos) {
+            break ;
+        }
+        value.remove_prefix(comma + 1) ;
+    }
+    return false ;
+}
+
+// ========== PAYLOAD CHECKS ==========
+
+bool validUtf8(std::string_view text) noexcept {
+    const auto* p = reinterpret_cast<const unsigned char*>(text.data()) ;
+    size_t n = text.size() ;
+    size_t i = 0 ;
+
+    while (i < n) {
+        // ASCII runs, 8 bytes at a time
+        if (i + 8 <= n) {
+            uint64_t word ;
+            std::memcpy(&word, p + i, sizeof(word)) ;
+            if ((word & 0x8080808080808080ull) == 0) {
+                i += 8 ;
+                continue ;
+            }
+        }
+
+        unsigned char c = p[i] ;
+        if (c < 0x80) {
+            ++i ;
+            continue ;
+        }
+
+        size_t length ;
+        uint32_t cp ;
+        if ((c & 0xE0) == 0xC0) {
+            length = 2 ;
+            cp = c & 0x1F ;
+        } else if ((c & 0xF0) == 0xE0) {
+            length = 3 ;
+            cp = c & 0x0F ;
+        } else if ((c & 0xF8) == 0xF0) {
+            length = 4 ;
+            cp = c & 0x07 ;
+        } else {
+            return false ;
+        }
+        if (i + length > n) {
+            return false ;
+        }
+        for (size_t k = 1 ; k < length ; ++k) {
+            if ((p[i + k] & 0xC0) != 0x80) {
+                return false ;
+            }
+            cp = cp << 6 | (p[i + k] & 0x3F) ;
+        }
+
+        // Overlong forms, surrogates and code points past U+10FFFF
+        if ((length == 2 && cp < 0x80) || (length == 3 && cp < 0x800) ||
+            (length == 4 && (cp < 0x10000 || cp > 0x10FFFF)) || (cp >= 0xD800 && cp <= 0xDFFF)) {
+            return false ;
+        }
+        i += length ;
+    }
+    return true ;
+}
+
+// Codes a peer may send in a Close frame (RFC 6455 §7.4, IANA registry)
+bool validCloseCode(uint16_t code) noexcept {
+    if (code >= 3000 && code <= 4999) {
+        return true ;
+    }
+    return code >= 1000 && code <= 1014 && code != 1004 && code != 1005 && code != 1006 ;
+}
+
+// ========== MASKING ==========
+
+using MaskFn = void (*)(char*, size_t, const uint8_t*) noexcept ;
+
+// `pattern` holds the key repeated (rotated to the payload's phase), at
+// least 32 bytes, so every block starts on a multiple of the key length
+void maskScalar(char* data, size_t size, const uint8_t* pattern) noexcept {
+    uint64_t key ;
+    std::memcpy(&key, pattern, sizeof(key)) ;
+
+    size_t i = 0 ;
+    for (; i + 8 <= size ; i += 8) {
+        uint64_t word ;
+        std::memcpy(&word, data + i, sizeof(word)) ;
+        word ^= key ;
+        std::memcpy(data + i, &word, sizeof(word)) ;
+    }
+    for (; i < size ; ++i) {
+        data[i] = static_cast<char>(data[i] ^ static_cast<char>(pattern[i & 3])) ;
+    }
+}
+
+#ifdef FRQS_SIMD_X86
+void maskSse2(char* data, size_t size, const uint8_t* pattern) noexcept {
+    const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern)) ;
+
+    size_t i = 0 ;
+    for (; i + 16 <= size ; i += 16) {
+        auto* p = reinterpret_cast<__m128i*>(data + i) ;
+        _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), key)) ;
+    }
+    maskScalar(data + i, size - i, pattern) ;
+}
+#endif
+
+#ifdef FRQS_SIMD_AVX2
+__attribute__((target("avx2")))
+void maskAvx2(char* data, size_t size, const uint8_t* pattern) noexcept {
+    const __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern)) ;
+
+    size_t i = 0 ;
+    for (; i + 64 <= size ; i += 64) {
+        auto* p = reinterpret_cast<__m256i*>(data + i) ;
+        _mm256_storeu_si256(p, _mm256_xor_si256(_mm256_loadu_si256(p), key)) ;
+        _mm256_storeu_si256(p + 1, _mm256_xor_si256(_mm256_loadu_si256(p + 1), key)) ;
+    }
+    for (; i + 32 <= size ; i += 32) {
+        auto* p = reinterpret_cast<__m256i*>(data + i) ;
+        _mm256_storeu_si256(p, _mm256_xor_si256(_mm256_loadu_si256(p), key)) ;
+    }
+    maskSse2(data + i, size - i, pattern) ;
+}
+#endif
+
+#ifdef FRQS_SIMD_NEON
+void maskNeon(char* data, size_t size, const uint8_t* pattern) noexcept {
+    const uint8x16_t key = vld1q_u8(pattern) ;
+
+    size_t i = 0 ;
+    for (; i + 16 <= size ; i += 16) {
+        auto* p = reinterpret_cast<uint8_t*>(data + i) ;
+        vst1q_u8(p, veorq_u8(vld1q_u8(p), key)) ;
+    }
+    maskScalar(data + i, size - i, pattern) ;
+}
+#endif
+
+const utils::SimdKernel<MaskFn>& maskBackend() noexcept {
+    static const utils::SimdKernel<MaskFn> selected = utils::selectKernel<MaskFn>({
+        .scalar = &maskScalar,
+#ifdef FRQS_SIMD_X86
+        .sse2 = &maskSse2,
+#endif
+#ifdef FRQS_SIMD_AVX2
+        .avx2 = &maskAvx2,
+#endif
+#ifdef FRQS_SIMD_NEON
+        .neon = &maskNeon,
+#endif
+    }) ;
+    return selected ;
+}
+
+} // namespace
+
+// ========== HANDSHAKE ==========
+
+bool isWebSocketUpgrade(const HTTPRequest& request) noexcept {
+    if (request.getMethod() != Method::GET || request.getVersion() != "HTTP/1.1") {
+        return false ;
+    }
+    if (!hasToken(request.getHeader("Upgrade").value_or(""), "websocket") ||
+        !hasToken(request.getHeader("Connection").value_or(""), "upgrade") ||
+        trim(request.getHeader("Sec-WebSocket-Version").value_or("")) != "13") {
+        return false ;
+    }
+
+    // base64 of 16 bytes: 22 characters and "=="
+    auto key = trim(request.getHeader("Sec-WebSocket-Key").value_or("")) ;
+    if (key.size() != 24 || !key.ends_with("==")) {
+        return false ;
+    }
+    return std::all_of(key.begin(), key.end() - 2, [](char c) {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '+' || c == '/' ;
+    }) ;
+}
+
+std::string webSocketAccept(std::string_view key) {
+    std::string input(trim(key)) ;
+    input += HANDSHAKE_GUID ;
+    auto digest = sha1(input) ;
+    return base64(digest) ;
+}
+
+// ========== FRAMING ==========
+
+void applyWebSocketMask(char* data, size_t size, std::array<uint8_t, 4> key, size_t phase) noexcept {
+    alignas(32) uint8_t pattern[32] ;
+    for (size_t i = 0 ; i < sizeof(pattern) ; ++i) {
+        pattern[i] = key[(i + phase) & 3] ;
+    }
+
+    // Too short to amortize a vector load
+    if (size < 16) {
+        maskScalar(data, size, pattern) ;
+        return ;
+    }
+    maskBackend().fn(data, size, pattern) ;
+}
+
+std::string_view webSocketMaskBackend() noexcept {
+    return maskBackend().name ;
+}
+
+size_t writeWebSocketHeader(std::span<char, 10> out, WsOpcode opcode, uint64_t length, bool fin) noexcept {
+    out[0] = static_cast<char>((fin ? 0x80 : 0x00) | static_cast<uint8_t>(opcode)) ;
+
+    if (length < 126) {
+        out[1] = static_cast<char>(length) ;
+        return 2 ;
+    }
+    if (length <= 0xFFFF) {
+        out[1] = 126 ;
+        out[2] = static_cast<char>(length >> 8) ;
+        out[3] = static_cast<char>(length) ;
+        return 4 ;
+    }
+    out[1] = 127 ;
+    for (size_t i = 0 ; i < 8 ; ++i) {
+        out[2 + i] = static_cast<char>(length >> (56 - 8 * i)) ;
+    }
+    return 10 ;
+}
+
+std::string encodeWebSocketFrame(WsOpcode opcode, std::string_view payload) {
+    std::array<char, 10> header ;
+    size_t header_size = writeWebSocketHeader(header, opcode, payload.size()) ;
+
+    std::string frame ;
+    frame.reserve(header_size + payload.size()) ;
+    frame.append(header.data(), header_size) ;
+    frame.append(payload) ;
+    return frame ;
+}
+
+// ========== PARSER ==========
+
+std::span<char> WebSocketParser::prepare(size_t min_size) {
+    return utils::prepareInput(in_, in_start_, in_size_, min_size, MAX_IDLE_BUFFER) ;
+}
+
+void WebSocketParser::commit(size_t n) {
+    in_size_ += n ;
+}
+
+void WebSocketParser::feed(std::string_view data) {
+    auto space = prepare(data.size()) ;
+    std::memcpy(space.data(), data.data(), data.size()) ;
+    commit(data.size()) ;
+}
+
+WebSocketParser::Status WebSocketParser::next(Message& out) {
+    if (error_code_ != 0) {
+        return Status::Error ;
+    }
+
+    while (true) {
+        size_t available = in_size_ - in_start_ ;
+        if (available < 2) {
+            return Status::NeedMore ;
+        }
+        const auto* p = reinterpret_cast<const uint8_t*>(in_.data() + in_start_) ;
+
+        bool fin = (p[0] & 0x80) != 0 ;
+        auto opcode = static_cast<WsOpcode>(p[0] & 0x0F) ;
+        bool control = (p[0] & 0x08) != 0 ;
+        uint64_t length = p[1] & 0x7F ;
+        size_t header = 2 ;
+
+        if (length == 126) {
+            if (available < 4) {
+                return Status::NeedMore ;
+            }
+            length = static_cast<uint64_t>(p[2]) << 8 | p[3] ;
+            header = 4 ;
+        } else if (length == 127) {
+            if (available < 10) {
+                return Status::NeedMore ;
+            }
+            length = 0 ;
+            for (size_t i = 0 ; i < 8 ; ++i) {
+                length = length << 8 | p[2 + i] ;
+            }
+            header = 10 ;
+        }
+
+        // No extensions are negotiated, so no reserved bit may be set
+        if ((p[0] & 0x70) != 0) {
+            return fail(WsCloseCode::ProtocolError, "reserved bits set") ;
+        }
+        if ((p[1] & 0x80) == 0) {
+            return fail(WsCloseCode::ProtocolError, "unmasked client frame") ;
+        }
+        if (control) {
+            if (opcode != WsOpcode::Close && opcode != WsOpcode::Ping && opcode != WsOpcode::Pong) {
+                return fail(WsCloseCode::ProtocolError, "unknown control opcode") ;
+            }
+            if (!fin || length > 125) {
+                return fail(WsCloseCode::ProtocolError, "fragmented or oversized control frame") ;
+            }
+        } else if (opcode == WsOpcode::Continuation) {
+            if (!fragmented_) {
+                return fail(WsCloseCode::ProtocolError, "continuation outside a message") ;
+            }
+        } else if (opcode != WsOpcode::Text && opcode != WsOpcode::Binary) {
+            return fail(WsCloseCode::ProtocolError, "unknown data opcode") ;
+        } else if (fragmented_) {
+            return fail(WsCloseCode::ProtocolError, "new message inside a fragmented one") ;
+        }
+
+        // Refused before its payload is buffered
+        uint64_t message_size = length + (opcode == WsOpcode::Continuation ? fragments_.size() : 0) ;
+        if (!control && message_size > max_message_size_) {
+            return fail(WsCloseCode::MessageTooBig, "message too big") ;
+        }
+
+        header += 4 ;
+        if (available < header || available - header < length) {
+            return Status::NeedMore ;
+        }
+
+        std::array<uint8_t, 4> key = {p[header - 4], p[header - 3], p[header - 2], p[header - 1]} ;
+        char* payload = in_.data() + in_start_ + header ;
+        auto size = static_cast<size_t>(length) ;
+        applyWebSocketMask(payload, size, key) ;
+        in_start_ += header + size ;
+        std::string_view data(payload, size) ;
+
+        if (control) {
+            if (opcode == WsOpcode::Close && !data.empty()) {
+                if (data.size() == 1) {
+                    return fail(WsCloseCode::ProtocolError, "truncated close code") ;
+                }
+                auto code = static_cast<uint16_t>(static_cast<uint8_t>(data[0]) << 8 | static_cast<uint8_t>(data[1])) ;
+                if (!validCloseCode(code)) {
+                    return fail(WsCloseCode::ProtocolError, "invalid close code") ;
+                }
+                if (!validUtf8(data.substr(2))) {
+                    return fail(WsCloseCode::InvalidPayload, "close reason is not UTF-8") ;
+                }
+            }
+            out = {opcode, data} ;
+            return Status::Message ;
+        }
+
+        if (!fin) {
+            if (opcode != WsOpcode::Continuation) {
+                fragmented_ = true ;
+                fragment_opcode_ = opcode ;
+                fragments_.assign(data) ;
+            } else {
+                fragments_.append(data) ;
+            }
+            continue ;
+        }
+
+        if (opcode == WsOpcode::Continuation) {
+            fragments_.append(data) ;
+            data = fragments_ ;
+            opcode = fragment_opcode_ ;
+            fragmented_ = false ;
+        }
+        if (opcode == WsOpcode::Text && !validUtf8(data)) {
+            return fail(WsCloseCode::InvalidPayload, "text message is not UTF-8") ;
+        }
+        out = {opcode, data} ;
+        return Status::Message ;
+    }
+}
+
+WebSocketParser::Status WebSocketParser::fail(uint16_t code, std::string_view why) noexcept {
+    error_code_ = code ;
+    error_ = why ;
+    return Status::Error ;
+}
+
+} // namespace frqs::http
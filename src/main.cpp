@@ -6,11 +6,23 @@
  */
 
 #include "frqs-net.hpp"
+#include "core/multipart_upload.hpp"
 #include "plugin/static_files.hpp"
+#include "plugin/compression.hpp"
+#include "plugin/metrics.hpp"
+#include "plugin/proxy.hpp"
+#include "plugin/response_cache.hpp"
 #include "utils/config.hpp"
+#include <algorithm>
+#include <charconv>
 #include <iostream>
 #include <csignal>
 #include <fstream>
+#include <ranges>
+#include <condition_variable>
+#include <mutex>
+#include <stop_token>
+#include <thread>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -31,7 +43,7 @@ void SetupConsole() {}
 
 namespace {
     frqs::core::Server* g_server = nullptr;
-
+    
     void signalHandler(int signal) {
         if (signal == SIGINT || signal == SIGTERM) {
             frqs::utils::logInfo("\n🛑 Shutdown signal received...");
@@ -283,7 +295,7 @@ namespace {
     </script>
 </body>
 </html>)HTML";
-    
+
     void createDefaultConfig(const std::filesystem::path& config_path) {
         std::ofstream config(config_path);
         config << "# FRQS Network Configuration v2.0\n"
@@ -291,7 +303,87 @@ namespace {
                << "# Server Settings\n"
                << "PORT=8080\n"
                << "DOC_ROOT=public\n"
-               << "THREAD_COUNT=4\n\n"
+               << "THREAD_COUNT=4\n"
+               << "# Re-read this file when it changes (DOC_ROOT, THREAD_COUNT and\n"
+               << "# STATIC_CACHE_* apply live; the rest on restart)\n"
+               << "CONFIG_WATCH=true\n"
+               << "# Event-driven I/O (epoll/kqueue/WSAPoll)\n"
+               << "REACTOR=false\n"
+               << "# Reactor loops on io_uring instead of epoll (Linux 6.1+)\n"
+               << "IO_URING=false\n"
+               << "# Shared-nothing: N SO_REUSEPORT listeners, one event loop each (0 = off)\n"
+               << "REUSE_PORT_LISTENERS=0\n"
+               << "# Pin worker threads to CPU cores\n"
+               << "PIN_WORKERS=false\n\n"
+               << "# TCP tuning (0/false = kernel default): listen backlog, TCP_NODELAY,\n"
+               << "# cork headers with sendfile bodies, TCP_FASTOPEN queue, TCP_DEFER_ACCEPT\n"
+               << "# seconds, socket buffer bytes, SO_BUSY_POLL microseconds\n"
+               << "LISTEN_BACKLOG=4096\n"
+               << "TCP_NODELAY=true\n"
+               << "TCP_CORK=true\n"
+               << "TCP_FASTOPEN=0\n"
+               << "TCP_DEFER_ACCEPT=0\n"
+               << "SOCKET_RCVBUF=0\n"
+               << "SOCKET_SNDBUF=0\n"
+               << "BUSY_POLL_US=0\n\n"
+               << "# Trace one request in N per worker as Chrome trace JSON at /debug/trace\n"
+               << "# (0 = off)\n"
+               << "TRACE_SAMPLE_EVERY=0\n\n"
+               << "# Timeouts (ms): request headers, from their first byte (from accept on a\n"
+               << "# new connection, TLS handshake included); each wait for body bytes; and\n"
+               << "# the handler deadline behind Context::deadline() (0 = none)\n"
+               << "HEADER_TIMEOUT_MS=10000\n"
+               << "BODY_TIMEOUT_MS=30000\n"
+               << "HANDLER_TIMEOUT_MS=0\n\n"
+               << "# Overload protection: pause accepting when the worker queue is full,\n"
+               << "# 503 requests beyond an adaptive limit steered by queue time\n"
+               << "# (/api/health and /metrics are never shed)\n"
+               << "ADMISSION_CONTROL=false\n"
+               << "ADMISSION_MAX_QUEUE=1024\n"
+               << "ADMISSION_TARGET_MS=10\n\n"
+               << "# Static file cache (in-memory LRU, mtime re-checked after TTL)\n"
+               << "STATIC_CACHE_MB=64\n"
+               << "STATIC_CACHE_TTL_MS=1000\n"
+               << "STATIC_CACHE_CONTROL=public, max-age=3600\n"
+               << "# Serve from a bundle packed with frqs_pack instead of DOC_ROOT (empty = off;\n"
+               << "# a re-packed bundle is picked up within STATIC_CACHE_TTL_MS)\n"
+               << "STATIC_BUNDLE=\n\n"
+               << "# gzip/brotli for text responses (Accept-Encoding)\n"
+               << "COMPRESSION=true\n\n"
+               << "# Prometheus metrics at /metrics\n"
+               << "METRICS=true\n\n"
+               << "# Streamed multipart uploads to POST /api/upload (empty = off)\n"
+               << "UPLOAD_DIR=\n"
+               << "UPLOAD_MAX_MB=1024\n\n"
+               << "# Allow/deny/limit rules by CIDR block, re-read on change (empty = off)\n"
+               << "IP_FILTER_FILE=\n\n"
+               << "# HTTPS: PEM certificate chain and key (empty = plain HTTP);\n"
+               << "# TLS_KTLS hands record encryption to the kernel where it can\n"
+               << "TLS_CERT=\n"
+               << "TLS_KEY=\n"
+               << "TLS_KTLS=true\n"
+               << "TLS_SESSION_TICKETS=2\n\n"
+               << "# HTTP/2: ALPN \"h2\" over TLS, prior-knowledge h2c over plain HTTP\n"
+               << "HTTP2=true\n"
+               << "HTTP2_MAX_STREAMS=128\n\n"
+               << "# WebSocket: per-connection send queue (slow clients drop frames\n"
+               << "# past it) and idle timeout (a ping goes out halfway)\n"
+               << "WEBSOCKET_MAX_QUEUE_KB=8192\n"
+               << "WEBSOCKET_IDLE_MS=60000\n\n"
+               << "# Micro-cache for /api/health and /api/info (0 = off)\n"
+               << "API_CACHE_MS=1000\n\n"
+               << "# Reverse proxy: comma-separated http:// upstreams (empty = off)\n"
+               << "# PROXY_BALANCE: round_robin, least_connections or consistent_hash\n"
+               << "# (PROXY_HASH_HEADER keys the hash; empty = request path)\n"
+               << "PROXY_UPSTREAMS=\n"
+               << "PROXY_MOUNT=/proxy\n"
+               << "PROXY_BALANCE=round_robin\n"
+               << "PROXY_HASH_HEADER=\n\n"
+               << "# Logging (INFO, WARN, ERROR); async writer flushes every LOG_FLUSH_MS\n"
+               << "LOG_LEVEL=INFO\n"
+               << "LOG_ASYNC=true\n"
+               << "LOG_FLUSH_MS=100\n"
+               << "LOG_BLOCK_WHEN_FULL=false\n\n"
                << "# Security (if using auth plugin)\n"
                << "AUTH_TOKEN=change_this_secure_token\n\n";
         
@@ -327,7 +419,7 @@ int main(int argc, char* argv[]) {
 ║                                                           ║
 ╚═══════════════════════════════════════════════════════════╝
 )" << std::endl;
-    
+
     try {
         // Setup logging
         utils::enableFileLogging("frqs_server.log");
@@ -354,11 +446,25 @@ int main(int argc, char* argv[]) {
             utils::logInfo("✅ Configuration loaded from: " + config_file.string());
         }
         
+        // Logging options
+        utils::LogOptions log_options;
+        if (auto level = config.get("LOG_LEVEL")) {
+            if (*level == "WARN") log_options.min_level = utils::Level::WARN;
+            else if (*level == "ERROR") log_options.min_level = utils::Level::ERROR;
+        }
+        log_options.async = config.getBool("LOG_ASYNC").value_or(true);
+        log_options.flush_interval = std::chrono::milliseconds(
+            config.getInt("LOG_FLUSH_MS").value_or(100));
+        if (config.getBool("LOG_BLOCK_WHEN_FULL").value_or(false)) {
+            log_options.overflow = utils::OverflowPolicy::Block;
+        }
+        utils::configureLogging(log_options);
+        
         // Setup directories
         std::filesystem::path doc_root = std::filesystem::absolute(config.getDocRoot()); 
 
 		frqs::utils::logInfo("📂 Static Root Absolute Path: " + doc_root.string());
-        
+
         // Create FRQS landing page if no index.html exists
         if (!std::filesystem::exists(doc_root / "index.html")) {
             utils::logInfo("📄 Creating default FRQS landing page...");
@@ -383,26 +489,239 @@ int main(int argc, char* argv[]) {
         core::Server server(port, threads);
         g_server = &server;
         
+        core::ServerOptions server_options;
+        server_options.reactor = config.getBool("REACTOR").value_or(false);
+        server_options.io_uring = config.getBool("IO_URING").value_or(false);
+        server_options.keep_alive_timeout_ms = config.getInt("KEEP_ALIVE_TIMEOUT_MS").value_or(5000);
+        server_options.max_keep_alive_requests = static_cast<size_t>(
+            config.getInt("KEEP_ALIVE_MAX_REQUESTS").value_or(1000));
+        server_options.keep_alive = server_options.keep_alive_timeout_ms > 0;
+        server_options.header_timeout_ms = config.getInt("HEADER_TIMEOUT_MS").value_or(10000);
+        server_options.body_timeout_ms = config.getInt("BODY_TIMEOUT_MS").value_or(30000);
+        server_options.handler_timeout_ms = config.getInt("HANDLER_TIMEOUT_MS").value_or(0);
+        server_options.pin_worker_threads = config.getBool("PIN_WORKERS").value_or(false);
+        server_options.reuse_port_listeners = static_cast<size_t>(
+            config.getInt("REUSE_PORT_LISTENERS").value_or(0));
+        server_options.socket.backlog = config.getInt("LISTEN_BACKLOG").value_or(SOMAXCONN);
+        server_options.socket.no_delay = config.getBool("TCP_NODELAY").value_or(false);
+        server_options.socket.cork = config.getBool("TCP_CORK").value_or(false);
+        server_options.socket.fast_open_queue = config.getInt("TCP_FASTOPEN").value_or(0);
+        server_options.socket.defer_accept_seconds = config.getInt("TCP_DEFER_ACCEPT").value_or(0);
+        server_options.socket.receive_buffer = config.getInt("SOCKET_RCVBUF").value_or(0);
+        server_options.socket.send_buffer = config.getInt("SOCKET_SNDBUF").value_or(0);
+        server_options.socket.busy_poll_us = config.getInt("BUSY_POLL_US").value_or(0);
+        server_options.trace_sample_every = static_cast<uint32_t>(
+            std::max(config.getInt("TRACE_SAMPLE_EVERY").value_or(0), 0));
+        server_options.max_streamed_body_bytes = static_cast<size_t>(
+            config.getInt("UPLOAD_MAX_MB").value_or(1024)) * 1024 * 1024;
+        server_options.admission.enabled = config.getBool("ADMISSION_CONTROL").value_or(false);
+        server_options.admission.max_queue = static_cast<size_t>(
+            config.getInt("ADMISSION_MAX_QUEUE").value_or(1024));
+        server_options.admission.target_queue_ms = config.getInt("ADMISSION_TARGET_MS").value_or(10);
+        
+        bool http2 = config.getBool("HTTP2").value_or(true);
+        server_options.http2.cleartext = http2;
+        server_options.http2.max_concurrent_streams = static_cast<uint32_t>(
+            std::max(config.getInt("HTTP2_MAX_STREAMS").value_or(128), 1));
+        
+        server_options.websocket.max_queued_bytes = static_cast<size_t>(
+            std::max(config.getInt("WEBSOCKET_MAX_QUEUE_KB").value_or(8192), 1)) * 1024;
+        server_options.websocket.idle_timeout_ms = config.getInt("WEBSOCKET_IDLE_MS").value_or(60000);
+        
+        // Connection filter: rules re-read whenever the file changes
+        std::jthread ip_filter_watch;
+        if (auto rules_path = config.get("IP_FILTER_FILE"); rules_path && !rules_path->empty()) {
+            auto filter = std::make_shared<net::IpFilter>();
+            std::string error;
+            if (!filter->reloadFile(*rules_path, &error)) {
+                throw std::runtime_error(std::format("IP filter {}: {}", *rules_path, error));
+            }
+            server_options.ip_filter = filter;
+            
+            ip_filter_watch = std::jthread([filter, path = std::filesystem::path(*rules_path)](std::stop_token stop) {
+                std::mutex mutex;
+                std::condition_variable_any wake;
+                std::error_code ec;
+                auto seen = std::filesystem::last_write_time(path, ec);
+                while (!stop.stop_requested()) {
+                    std::unique_lock lock(mutex);
+                    if (wake.wait_for(lock, stop, std::chrono::seconds(1), [] { return false; }) || stop.stop_requested()) {
+                        break;
+                    }
+                    auto modified = std::filesystem::last_write_time(path, ec);
+                    if (ec || modified == seen) {
+                        continue;
+                    }
+                    seen = modified;
+                    std::string reload_error;
+                    if (filter->reloadFile(path, &reload_error)) {
+                        utils::logInfo(std::format("IP filter reloaded: {} rules", filter->rules()->rules().size()));
+                    } else {
+                        utils::logWarn(std::format("IP filter not reloaded: {}", reload_error));
+                    }
+                }
+            });
+        }
+        
+        if (auto cert = config.get("TLS_CERT"); cert && !cert->empty()) {
+            net::TlsOptions tls_options;
+            tls_options.certificate_file = *cert;
+            tls_options.private_key_file = config.get("TLS_KEY").value_or(*cert);
+            tls_options.kernel_offload = config.getBool("TLS_KTLS").value_or(true);
+            tls_options.session_tickets = static_cast<uint32_t>(
+                std::max(config.getInt("TLS_SESSION_TICKETS").value_or(2), 0));
+            if (!http2) {
+                tls_options.alpn = {"http/1.1"};
+            }
+            server_options.tls = net::TlsContext::create(tls_options);
+        }
+        server.setOptions(server_options);
+        
         // ========== ADD PLUGINS ==========
         
+        // Compression plugin (first, so its middleware sees every final body)
+        if (config.getBool("COMPRESSION").value_or(true)) {
+            server.addPlugin(std::make_unique<plugins::CompressionPlugin>());
+        }
+        
+        // Metrics endpoint
+        if (config.getBool("METRICS").value_or(true)) {
+            server.addPlugin(std::make_unique<plugins::MetricsPlugin>());
+        }
+        
+        // Response micro-cache (routes opt in below)
+        plugins::ResponseCachePlugin* response_cache = nullptr;
+        if (config.getInt("API_CACHE_MS").value_or(1000) > 0) {
+            auto plugin = std::make_unique<plugins::ResponseCachePlugin>();
+            response_cache = plugin.get();
+            server.addPlugin(std::move(plugin));
+        }
+        
+        // Reverse proxy
+        if (auto upstreams = config.get("PROXY_UPSTREAMS"); upstreams && !upstreams->empty()) {
+            plugins::ProxyConfig proxy_config;
+            proxy_config.mount_path = config.get("PROXY_MOUNT").value_or("/proxy");
+            proxy_config.strip_prefix = true;
+            proxy_config.hash_header = config.get("PROXY_HASH_HEADER").value_or("");
+            for (auto part : std::views::split(std::string_view(*upstreams), ',')) {
+                std::string_view origin(part.begin(), part.end());
+                if (!origin.empty()) {
+                    proxy_config.upstreams.emplace_back(origin);
+                }
+            }
+            auto balance = config.get("PROXY_BALANCE").value_or("round_robin");
+            if (balance == "least_connections") {
+                proxy_config.balance = plugins::ProxyConfig::Balance::LeastConnections;
+            } else if (balance == "consistent_hash") {
+                proxy_config.balance = plugins::ProxyConfig::Balance::ConsistentHash;
+            }
+            server.addPlugin(std::make_unique<plugins::ProxyPlugin>(std::move(proxy_config)));
+        }
+        
         // Static files plugin
-        plugins::StaticFilesConfig static_config;
-        static_config.root = doc_root;
-        static_config.mount_path = "/";
-        static_config.default_file = "index.html";
-        static_config.cache_control = "public, max-age=3600";
-
-        server.addPlugin(std::make_unique<plugins::StaticFilesPlugin>(std::move(static_config)));
+        auto static_settings = [](const utils::ConfigSnapshot& values) {
+            plugins::StaticFilesConfig static_config;
+            static_config.root = std::filesystem::absolute(values.get("DOC_ROOT").value_or("public"));
+            static_config.mount_path = "/";
+            static_config.default_file = "index.html";
+            static_config.cache_control = values.get("STATIC_CACHE_CONTROL").value_or("public, max-age=3600");
+            static_config.cache_max_bytes = static_cast<size_t>(
+                values.getInt("STATIC_CACHE_MB").value_or(64)) * 1024 * 1024;
+            static_config.cache_ttl = std::chrono::milliseconds(
+                values.getInt("STATIC_CACHE_TTL_MS").value_or(1000));
+            if (auto bundle = values.get("STATIC_BUNDLE"); bundle && !bundle->empty()) {
+                static_config.bundle = std::filesystem::absolute(*bundle);
+            }
+            return static_config;
+        };
+        
+        auto static_plugin = std::make_unique<plugins::StaticFilesPlugin>(static_settings(*config.snapshot()));
+        auto* static_files = static_plugin.get();
+        if (!server.addPlugin(std::move(static_plugin))) {
+            static_files = nullptr;
+        }
+        
+        // ========== CONFIG RELOAD ==========
+        
+        config.addValidator([](const utils::ConfigSnapshot& values, std::string& error) {
+            if (auto thread_count = values.getInt("THREAD_COUNT"); thread_count && *thread_count < 1) {
+                error = "THREAD_COUNT must be at least 1";
+                return false;
+            }
+            if (auto root = values.get("DOC_ROOT"); root && !std::filesystem::is_directory(*root)) {
+                error = std::format("DOC_ROOT {} is not a directory", *root);
+                return false;
+            }
+            if (auto bundle = values.get("STATIC_BUNDLE"); bundle && !bundle->empty() &&
+                !std::filesystem::is_regular_file(*bundle)) {
+                error = std::format("STATIC_BUNDLE {} is not a file", *bundle);
+                return false;
+            }
+            return true;
+        });
+        
+        config.subscribe({"THREAD_COUNT"}, [&server](const utils::ConfigSnapshot& values) {
+            server.setThreadCount(static_cast<size_t>(
+                values.getInt("THREAD_COUNT").value_or(static_cast<int>(std::thread::hardware_concurrency()))));
+        });
+        
+        if (static_files) {
+            config.subscribe({"DOC_ROOT", "STATIC_CACHE_TTL_MS", "STATIC_CACHE_CONTROL", "STATIC_BUNDLE"},
+                [static_files, static_settings](const utils::ConfigSnapshot& values) {
+                    static_files->reconfigure(static_settings(values));
+                });
+        }
+        
+        // Stops the watcher, and with it the callbacks above, before the
+        // server and its plugins go away
+        struct StopWatching {
+            ~StopWatching() { utils::Config::instance().stopWatching(); }
+        } stop_watching;
+        if (config.getBool("CONFIG_WATCH").value_or(true)) {
+            config.watch();
+        }
         
         // ========== ADD CUSTOM ROUTES ==========
         
+        auto api = server.router().group("/api");
+        
+        // CORS middleware: API routes only, static files don't need it
+        api.use([](auto& ctx, auto next) {
+            ctx.response().setHeader("Access-Control-Allow-Origin", "*");
+            ctx.response().setHeader("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
+            ctx.response().setHeader("Access-Control-Allow-Headers", "Content-Type, Authorization");
+            
+            // Handle preflight
+            if (ctx.request().getMethod() == http::Method::OPTIONS) {
+                ctx.status(204).body("");
+                return;
+            }
+            
+            next();
+        });
+        
+        // API: Preflight for any API path (answered by the CORS middleware)
+        api.options("/*", [](auto&) {});
+        
+        // Micro-cache: identical API hits within the TTL share one handler run
+        auto api_cache_ttl = std::chrono::milliseconds(config.getInt("API_CACHE_MS").value_or(1000));
+        auto cached = [&](core::RouteHandler handler) -> core::RouteHandler {
+            if (!response_cache || api_cache_ttl.count() <= 0) {
+                return handler;
+            }
+            plugins::CachePolicy policy;
+            policy.ttl = api_cache_ttl;
+            policy.stale_while_revalidate = api_cache_ttl * 5;
+            return response_cache->cached(std::move(policy), std::move(handler));
+        };
+        
         // API: Health check
-        server.router().get("/api/health", [](auto& ctx) {
+        api.get("/health", cached([](auto& ctx) {
             ctx.json(R"({"status":"healthy","version":"2.0.0"})");
-        });
+        }));
         
         // API: Server info
-        server.router().get("/api/info", [&server](auto& ctx) {
+        api.get("/info", cached([&server](auto& ctx) {
             auto info = std::format(
                 R"({{"server":"FRQS Network","version":"2.0.0","port":{},"connections":{},"requests":{}}})",
                 server.getPort(),
@@ -410,8 +729,66 @@ int main(int argc, char* argv[]) {
                 server.totalRequests()
             );
             ctx.json(info);
+        }));
+        
+        // API: Coroutine handler; a waiting request holds no worker thread
+        api.get("/delay", [](core::Context& ctx) -> coro::Task<> {
+            int ms = 0;
+            if (auto value = ctx.request().getQueryParam("ms")) {
+                std::from_chars(value->data(), value->data() + value->size(), ms);
+            }
+            auto duration = std::chrono::milliseconds(std::clamp(ms, 0, 10'000));
+            co_await ctx.io().sleepFor(duration);
+            ctx.json(std::format(R"({{"slept_ms":{}}})", duration.count()));
+        });
+        
+        // API: WebSocket room; every message goes to all connected clients,
+        // serialized once
+        auto room = std::make_shared<core::WebSocketGroup>();
+        struct RoomMember : core::WebSocketListener {
+            std::shared_ptr<core::WebSocketGroup> room;
+            
+            void onOpen(const std::shared_ptr<core::WebSocket>& socket) override {
+                room->add(socket);
+            }
+            void onMessage(core::WebSocket&, std::string_view data, bool binary) override {
+                room->broadcast(data, binary);
+            }
+            void onClose(core::WebSocket& socket, uint16_t) override {
+                room->remove(socket);
+            }
+        };
+        api.websocket("/ws", [room](auto&) {
+            auto member = std::make_unique<RoomMember>();
+            member->room = room;
+            return member;
         });
         
+        // API: Streamed uploads, written straight to UPLOAD_DIR
+        if (auto dir = config.get("UPLOAD_DIR"); dir && !dir->empty()) {
+            std::filesystem::path upload_dir = std::filesystem::absolute(*dir);
+            std::filesystem::create_directories(upload_dir);
+            
+            api.stream(http::Method::POST, "/upload", [upload_dir](auto& request_ctx) {
+                return core::MultipartUpload::create(request_ctx,
+                    [upload_dir](const http::MultipartPart& part) -> http::PartSink {
+                        // Keep only the last path component: no "../" escapes
+                        auto name = std::filesystem::path(part.filename).filename();
+                        if (name.empty() || name == "." || name == "..") {
+                            return {};  // Form fields and nameless files are dropped
+                        }
+                        return http::fileSink(upload_dir / name);
+                    },
+                    [](core::Context& ctx, const http::MultipartStreamParser& parser, bool ok) {
+                        if (ok) {
+                            ctx.json(std::format(R"({{"parts":{}}})", parser.partCount())).status(201);
+                        } else {
+                            ctx.text(parser.error().empty() ? "Upload incomplete" : parser.error()).status(400);
+                        }
+                    });
+            });
+        }
+        
         // ========== ADD MIDDLEWARE ==========
         
         // Logging middleware
@@ -423,28 +800,15 @@ int main(int argc, char* argv[]) {
             auto duration = std::chrono::steady_clock::now() - start;
             auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
             
-            utils::logInfo(std::format("{} {} - {} - {}ms", 
+            // Format-string overload: nothing is formatted if INFO is filtered out
+            utils::logInfo("{} {} - {} - {}ms", 
                 http::methodToString(ctx.request().getMethod()),
                 ctx.request().getPath(),
                 ctx.response().getStatus(),
                 ms
-            ));
+            );
         });
         
-        // CORS middleware (if needed)
-        server.use([](auto& ctx, auto next) {
-            ctx.response().setHeader("Access-Control-Allow-Origin", "*");
-            ctx.response().setHeader("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-            ctx.response().setHeader("Access-Control-Allow-Headers", "Content-Type, Authorization");
-            
-            // Handle preflight
-            if (ctx.request().getMethod() == http::Method::OPTIONS) {
-                ctx.status(204).body("");
-                return;
-            }
-            
-            next();
-        });
         
         // Signal handlers
         std::signal(SIGINT, signalHandler);
@@ -455,13 +819,16 @@ int main(int argc, char* argv[]) {
         std::cout << "│  🌐 Server is running!              │" << std::endl;
         std::cout << "├─────────────────────────────────────┤" << std::endl;
         std::cout << "│                                     │" << std::endl;
-        std::cout << "│  Local:   http://localhost:" << port << "     │" << std::endl;
-        std::cout << "│  Network: http://[YOUR_IP]:" << port << "  │" << std::endl;
+        std::string_view scheme = server_options.tls ? "https" : "http";
+        std::string pad(5 - (scheme.size() - 4), ' ');
+        std::cout << "│  Local:   " << scheme << "://localhost:" << port << pad << "│" << std::endl;
+        std::cout << "│  Network: " << scheme << "://[YOUR_IP]:" << port << pad.substr(3) << "│" << std::endl;
         std::cout << "│                                     │" << std::endl;
         std::cout << "│  Routes:                            │" << std::endl;
         std::cout << "│  • GET  /                           │" << std::endl;
         std::cout << "│  • GET  /api/health                 │" << std::endl;
         std::cout << "│  • GET  /api/info                   │" << std::endl;
+        std::cout << "│  • GET  /api/delay?ms=              │" << std::endl;
         std::cout << "│                                     │" << std::endl;
         std::cout << "│  Press Ctrl+C to stop               │" << std::endl;
         std::cout << "└─────────────────────────────────────┘\n" << std::endl;
@@ -472,10 +839,12 @@ int main(int argc, char* argv[]) {
         server.start();
         
         utils::logInfo("👋 Server shutdown complete");
+        utils::flushLogs();
         std::cout << "\n✅ Goodbye!\n" << std::endl;
-        
+    
     } catch (const std::exception& e) {
         utils::logError("❌ Fatal error: " + std::string(e.what()));
+        utils::flushLogs();
         std::cerr << "\n❌ Error: " << e.what() << std::endl;
         return 1;
     }
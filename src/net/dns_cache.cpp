@@ -0,0 +1,70 @@
+/**
+ * @file net/dns_cache.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief 
+ * @version 1.0.0
+ * @date 2025-12-15
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "net/dns_cache.hpp"
+#include "net/socket.hpp"
+
+#ifdef _WIN32
+    #include <ws2tcpip.h>
+#else
+    #include <netdb.h>
+    #include <netinet/in.h>
+#endif
+
+namespace frqs::net {
+
+std::optional<IPv4> DnsCache::resolve(std::string_view host) {
+    std::string key(host) ;
+    auto now = std::chrono::steady_clock::now() ;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        auto it = entries_.find(key) ;
+        if (it != entries_.end() && it->second.expires > now) {
+            return it->second.address ;
+        }
+    }
+    
+    auto address = lookup(key) ;
+    
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    entries_[key] = Entry{address, now + (address ? ttl_ : NEGATIVE_TTL)} ;
+    return address ;
+}
+
+void DnsCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    entries_.clear() ;
+}
+
+size_t DnsCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    return entries_.size() ;
+}
+
+std::optional<IPv4> DnsCache::lookup(const std::string& host) {
+    addrinfo hints{} ;
+    hints.ai_family = AF_INET ;
+    hints.ai_socktype = SOCK_STREAM ;
+    
+    addrinfo* result = nullptr ;
+    if (::getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || !result) {
+        return std::nullopt ;
+    }
+    
+    // sin_addr is in network byte order; IPv4 takes a host-order value
+    auto* in = reinterpret_cast<const sockaddr_in*>(result->ai_addr) ;
+    IPv4 address(static_cast<uint32_t>(ntohl(in->sin_addr.s_addr))) ;
+    ::freeaddrinfo(result) ;
+    return address ;
+}
+
+} // namespace frqs::net
@@ -0,0 +1,412 @@
+/**
+ * @file net/event_loop.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief epoll / kqueue / WSAPoll backends for EventLoop (io_uring: uring_poller.cpp)
+ * @version 1.0.0
+ * @date 2025-12-14
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "net/event_loop.hpp"
+#include <array>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#if defined(__linux__)
+    #define FRQS_EVENT_LOOP_EPOLL 1
+    #include "net/uring_poller.hpp"
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <errno.h>
+    #include <cstring>
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+    #define FRQS_EVENT_LOOP_KQUEUE 1
+    #include <sys/types.h>
+    #include <sys/event.h>
+    #include <sys/time.h>
+    #include <errno.h>
+    #include <cstring>
+#elif defined(_WIN32)
+    #define FRQS_EVENT_LOOP_WSAPOLL 1
+    #include <ws2tcpip.h>
+#endif
+
+namespace frqs::net {
+
+namespace {
+
+// Events drained per wait() call into a stack buffer
+constexpr size_t MAX_BATCH = 256 ;
+
+[[noreturn]] void throwLoopError(const char* what) {
+#ifdef _WIN32
+    throw std::runtime_error(std::string(what) + ". Error: " + std::to_string(WSAGetLastError())) ;
+#else
+    throw std::runtime_error(std::string(what) + ": " + std::string(strerror(errno))) ;
+#endif
+}
+
+} // namespace
+
+#if defined(FRQS_EVENT_LOOP_EPOLL)
+
+// ============================================================================
+// epoll backend
+// ============================================================================
+
+namespace {
+
+uint32_t toNative(uint32_t events, bool oneshot) noexcept {
+    uint32_t native = EPOLLRDHUP ;
+    if (events & IoEvent::Read) native |= EPOLLIN ;
+    if (events & IoEvent::Write) native |= EPOLLOUT ;
+    if (oneshot) native |= EPOLLONESHOT ;
+    return native ;
+}
+
+uint32_t fromNative(uint32_t native) noexcept {
+    uint32_t events = IoEvent::None ;
+    if (native & EPOLLIN) events |= IoEvent::Read ;
+    if (native & EPOLLOUT) events |= IoEvent::Write ;
+    if (native & (EPOLLHUP | EPOLLERR | EPOLLRDHUP)) events |= IoEvent::Closed ;
+    return events ;
+}
+
+} // namespace
+
+EventLoop::EventLoop(LoopBackend backend) {
+    if (backend == LoopBackend::IoUring) {
+        uring_ = UringPoller::create() ;
+        if (uring_) {
+            return ;
+        }
+    }
+
+    poll_fd_ = ::epoll_create1(EPOLL_CLOEXEC) ;
+    if (poll_fd_ < 0) {
+        throwLoopError("Failed to create epoll instance") ;
+    }
+
+    wakeup_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) ;
+    if (wakeup_fd_ < 0) {
+        ::close(poll_fd_) ;
+        throwLoopError("Failed to create eventfd") ;
+    }
+
+    epoll_event ev{} ;
+    ev.events = EPOLLIN ;
+    ev.data.ptr = &wakeup_fd_ ;
+    if (::epoll_ctl(poll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &ev) != 0) {
+        ::close(wakeup_fd_) ;
+        ::close(poll_fd_) ;
+        throwLoopError("Failed to register eventfd") ;
+    }
+}
+
+EventLoop::~EventLoop() {
+    if (!uring_) {
+        ::close(wakeup_fd_) ;
+        ::close(poll_fd_) ;
+    }
+}
+
+void EventLoop::add(native_handle_t handle, uint32_t events, void* data, bool oneshot) {
+    if (uring_) {
+        return uring_->add(handle, events, data, oneshot) ;
+    }
+
+    epoll_event ev{} ;
+    ev.events = toNative(events, oneshot) ;
+    ev.data.ptr = data ;
+    if (::epoll_ctl(poll_fd_, EPOLL_CTL_ADD, handle, &ev) != 0) {
+        throwLoopError("epoll_ctl(ADD) failed") ;
+    }
+}
+
+void EventLoop::rearm(native_handle_t handle, uint32_t events, void* data) {
+    if (uring_) {
+        return uring_->rearm(handle, events, data) ;
+    }
+
+    epoll_event ev{} ;
+    ev.events = toNative(events, true) ;
+    ev.data.ptr = data ;
+    if (::epoll_ctl(poll_fd_, EPOLL_CTL_MOD, handle, &ev) != 0) {
+        throwLoopError("epoll_ctl(MOD) failed") ;
+    }
+}
+
+void EventLoop::remove(native_handle_t handle) noexcept {
+    if (uring_) {
+        return uring_->remove(handle) ;
+    }
+    ::epoll_ctl(poll_fd_, EPOLL_CTL_DEL, handle, nullptr) ;
+}
+
+size_t EventLoop::wait(std::span<ReadyEvent> out, int timeout_ms) {
+    if (uring_) {
+        return uring_->wait(out, timeout_ms) ;
+    }
+
+    std::array<epoll_event, MAX_BATCH> native{} ;
+    int capacity = static_cast<int>(std::min(out.size(), native.size())) ;
+
+    int n = ::epoll_wait(poll_fd_, native.data(), capacity, timeout_ms) ;
+    if (n < 0) {
+        if (errno == EINTR) return 0 ;
+        throwLoopError("epoll_wait failed") ;
+    }
+
+    size_t count = 0 ;
+    for (int i = 0 ; i < n ; ++i) {
+        if (native[static_cast<size_t>(i)].data.ptr == &wakeup_fd_) {
+            uint64_t drained ;
+            while (::read(wakeup_fd_, &drained, sizeof(drained)) > 0) {}
+            continue ;
+        }
+        out[count++] = {
+            native[static_cast<size_t>(i)].data.ptr,
+            fromNative(native[static_cast<size_t>(i)].events)
+        } ;
+    }
+    return count ;
+}
+
+void EventLoop::wakeup() noexcept {
+    if (uring_) {
+        return uring_->wakeup() ;
+    }
+    uint64_t one = 1 ;
+    [[maybe_unused]] auto r = ::write(wakeup_fd_, &one, sizeof(one)) ;
+}
+
+std::string_view EventLoop::backend() const noexcept {
+    return uring_ ? "io_uring" : "epoll" ;
+}
+
+#elif defined(FRQS_EVENT_LOOP_KQUEUE)
+
+// ============================================================================
+// kqueue backend
+// ============================================================================
+
+EventLoop::EventLoop(LoopBackend) {
+    poll_fd_ = ::kqueue() ;
+    if (poll_fd_ < 0) {
+        throwLoopError("Failed to create kqueue") ;
+    }
+
+    struct kevent ev ;
+    EV_SET(&ev, 0, EVFILT_USER, EV_ADD | EV_CLEAR, 0, 0, nullptr) ;
+    if (::kevent(poll_fd_, &ev, 1, nullptr, 0, nullptr) != 0) {
+        ::close(poll_fd_) ;
+        throwLoopError("Failed to register EVFILT_USER") ;
+    }
+}
+
+EventLoop::~EventLoop() {
+    ::close(poll_fd_) ;
+}
+
+void EventLoop::add(native_handle_t handle, uint32_t events, void* data, bool oneshot) {
+    std::array<struct kevent, 2> changes ;
+    int n = 0 ;
+    unsigned short flags = EV_ADD | EV_ENABLE | (oneshot ? EV_ONESHOT : 0) ;
+
+    if (events & IoEvent::Read) {
+        EV_SET(&changes[static_cast<size_t>(n++)], handle, EVFILT_READ, flags, 0, 0, data) ;
+    }
+    if (events & IoEvent::Write) {
+        EV_SET(&changes[static_cast<size_t>(n++)], handle, EVFILT_WRITE, flags, 0, 0, data) ;
+    }
+
+    if (n > 0 && ::kevent(poll_fd_, changes.data(), n, nullptr, 0, nullptr) != 0) {
+        throwLoopError("kevent(EV_ADD) failed") ;
+    }
+}
+
+void EventLoop::rearm(native_handle_t handle, uint32_t events, void* data) {
+    add(handle, events, data, true) ;
+}
+
+void EventLoop::remove(native_handle_t handle) noexcept {
+    struct kevent ev ;
+    EV_SET(&ev, handle, EVFILT_READ, EV_DELETE, 0, 0, nullptr) ;
+    ::kevent(poll_fd_, &ev, 1, nullptr, 0, nullptr) ;
+    EV_SET(&ev, handle, EVFILT_WRITE, EV_DELETE, 0, 0, nullptr) ;
+    ::kevent(poll_fd_, &ev, 1, nullptr, 0, nullptr) ;
+}
+
+size_t EventLoop::wait(std::span<ReadyEvent> out, int timeout_ms) {
+    std::array<struct kevent, MAX_BATCH> native ;
+    int capacity = static_cast<int>(std::min(out.size(), native.size())) ;
+
+    timespec ts{} ;
+    timespec* tsp = nullptr ;
+    if (timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000 ;
+        ts.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1'000'000L ;
+        tsp = &ts ;
+    }
+
+    int n = ::kevent(poll_fd_, nullptr, 0, native.data(), capacity, tsp) ;
+    if (n < 0) {
+        if (errno == EINTR) return 0 ;
+        throwLoopError("kevent wait failed") ;
+    }
+
+    size_t count = 0 ;
+    for (int i = 0 ; i < n ; ++i) {
+        const auto& ev = native[static_cast<size_t>(i)] ;
+        if (ev.filter == EVFILT_USER) {
+            continue ;
+        }
+
+        uint32_t events = (ev.filter == EVFILT_READ) ? IoEvent::Read : IoEvent::Write ;
+        if (ev.flags & (EV_EOF | EV_ERROR)) {
+            events |= IoEvent::Closed ;
+        }
+        out[count++] = {ev.udata, events} ;
+    }
+    return count ;
+}
+
+void EventLoop::wakeup() noexcept {
+    struct kevent ev ;
+    EV_SET(&ev, 0, EVFILT_USER, 0, NOTE_TRIGGER, 0, nullptr) ;
+    ::kevent(poll_fd_, &ev, 1, nullptr, 0, nullptr) ;
+}
+
+std::string_view EventLoop::backend() const noexcept {
+    return "kqueue" ;
+}
+
+#elif defined(FRQS_EVENT_LOOP_WSAPOLL)
+
+// ============================================================================
+// WSAPoll backend
+// ============================================================================
+//
+// IOCP is completion-based and does not map onto a readiness interface, so
+// Windows uses WSAPoll over the registered set. A connected loopback UDP
+// socket serves as the wakeup channel so re-armed handles are picked up
+// without waiting for the poll timeout.
+
+EventLoop::EventLoop(LoopBackend) {
+    wakeup_socket_ = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP) ;
+    if (wakeup_socket_ == INVALID_SOCKET) {
+        throwLoopError("Failed to create wakeup socket") ;
+    }
+
+    sockaddr_in addr{} ;
+    addr.sin_family = AF_INET ;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK) ;
+    addr.sin_port = 0 ;
+
+    int len = sizeof(addr) ;
+    if (::bind(wakeup_socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::getsockname(wakeup_socket_, reinterpret_cast<sockaddr*>(&addr), &len) != 0 ||
+        ::connect(wakeup_socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::closesocket(wakeup_socket_) ;
+        throwLoopError("Failed to set up wakeup socket") ;
+    }
+
+    u_long non_blocking = 1 ;
+    ::ioctlsocket(wakeup_socket_, FIONBIO, &non_blocking) ;
+}
+
+EventLoop::~EventLoop() {
+    ::closesocket(wakeup_socket_) ;
+}
+
+void EventLoop::add(native_handle_t handle, uint32_t events, void* data, bool oneshot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        registry_[handle] = {events, data, oneshot, true} ;
+    }
+    wakeup() ;
+}
+
+void EventLoop::rearm(native_handle_t handle, uint32_t events, void* data) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        auto it = registry_.find(handle) ;
+        if (it == registry_.end()) {
+            throw std::runtime_error("rearm: handle is not registered") ;
+        }
+        it->second = {events, data, true, true} ;
+    }
+    wakeup() ;
+}
+
+void EventLoop::remove(native_handle_t handle) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    registry_.erase(handle) ;
+}
+
+size_t EventLoop::wait(std::span<ReadyEvent> out, int timeout_ms) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        poll_set_.clear() ;
+        poll_set_.push_back({wakeup_socket_, POLLRDNORM, 0}) ;
+        for (const auto& [handle, reg] : registry_) {
+            if (!reg.armed) continue ;
+            SHORT wanted = 0 ;
+            if (reg.events & IoEvent::Read) wanted |= POLLRDNORM ;
+            if (reg.events & IoEvent::Write) wanted |= POLLWRNORM ;
+            poll_set_.push_back({handle, wanted, 0}) ;
+        }
+    }
+
+    int n = ::WSAPoll(poll_set_.data(), static_cast<ULONG>(poll_set_.size()), timeout_ms) ;
+    if (n == SOCKET_ERROR) {
+        throwLoopError("WSAPoll failed") ;
+    }
+    if (n == 0) {
+        return 0 ;
+    }
+
+    if (poll_set_[0].revents != 0) {
+        char drain[64] ;
+        while (::recv(wakeup_socket_, drain, sizeof(drain), 0) > 0) {}
+    }
+
+    size_t count = 0 ;
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    for (size_t i = 1 ; i < poll_set_.size() && count < out.size() ; ++i) {
+        const auto& pfd = poll_set_[i] ;
+        if (pfd.revents == 0) continue ;
+
+        auto it = registry_.find(pfd.fd) ;
+        if (it == registry_.end() || !it->second.armed) continue ;
+
+        uint32_t events = IoEvent::None ;
+        if (pfd.revents & POLLRDNORM) events |= IoEvent::Read ;
+        if (pfd.revents & POLLWRNORM) events |= IoEvent::Write ;
+        if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) events |= IoEvent::Closed ;
+
+        if (it->second.oneshot) {
+            it->second.armed = false ;
+        }
+        out[count++] = {it->second.data, events} ;
+    }
+    return count ;
+}
+
+void EventLoop::wakeup() noexcept {
+    char byte = 0 ;
+    ::send(wakeup_socket_, &byte, 1, 0) ;
+}
+
+std::string_view EventLoop::backend() const noexcept {
+    return "wsapoll" ;
+}
+
+#else
+    #error "EventLoop: no readiness backend for this platform"
+#endif
+
+} // namespace frqs::net
@@ -10,12 +10,84 @@
  */
 
 #include "net/http_client.hpp"
-#include "net/ipv4.hpp"
+#include "net/io_service.hpp"
 #include <format>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <thread>
 
 namespace frqs::net {
 
+namespace {
+
+// Minimum free buffer space per receive call
+constexpr size_t RECV_CHUNK = 16 * 1024;
+
+// Spare receive buffer per thread, handed from one stream to the next
+thread_local std::string spare_buffer;
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) noexcept {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+bool containsIgnoreCase(std::string_view haystack, std::string_view needle) noexcept {
+    if (needle.size() > haystack.size()) {
+        return false;
+    }
+    for (size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
+        if (equalsIgnoreCase(haystack.substr(i, needle.size()), needle)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string_view trim(std::string_view s) noexcept {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+bool idempotent(std::string_view method) noexcept {
+    return method == "GET" || method == "HEAD" || method == "PUT" ||
+           method == "DELETE" || method == "OPTIONS";
+}
+
+} // namespace
+
+// ========== HTTP RESPONSE ==========
+
+std::optional<std::string_view> HttpResponse::header(std::string_view name) const noexcept {
+    for (const auto& [field, value] : headers) {
+        if (equalsIgnoreCase(field, name)) {
+            return value;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<std::string_view> HttpResponse::headerValues(std::string_view name) const {
+    std::vector<std::string_view> values;
+    for (const auto& [field, value] : headers) {
+        if (equalsIgnoreCase(field, name)) {
+            values.push_back(value);
+        }
+    }
+    return values;
+}
+
+// ========== HTTP CLIENT ==========
+
+HttpClient::HttpClient() : HttpClient(Options{}) {}
+
+HttpClient::HttpClient(Options options)
+    : options_(options), dns_(options.dns_ttl) {}
+
 std::optional<HttpClient::UrlParts> HttpClient::parseUrl(std::string_view url) {
     // Simple parser for http://host:port/path
     if (!url.starts_with("http://")) {
@@ -29,37 +101,40 @@ std::optional<HttpClient::UrlParts> HttpClient::parseUrl(std::string_view url) {
     
     // Find path separator
     size_t path_pos = url.find('/');
-    std::string_view host_port = (path_pos != std::string_view::npos) 
-        ? url.substr(0, path_pos) 
+    std::string_view host_port = (path_pos != std::string_view::npos)
+        ? url.substr(0, path_pos)
         : url;
     
-    parts.path = (path_pos != std::string_view::npos) 
-        ? std::string(url.substr(path_pos)) 
+    parts.path = (path_pos != std::string_view::npos)
+        ? std::string(url.substr(path_pos))
         : "/";
     
     // Parse host and port
     size_t colon_pos = host_port.find(':');
     if (colon_pos != std::string_view::npos) {
         parts.host = std::string(host_port.substr(0, colon_pos));
-        try {
-            parts.port = static_cast<uint16_t>(std::stoi(std::string(host_port.substr(colon_pos + 1))));
-        } catch (...) {
+        auto port = host_port.substr(colon_pos + 1);
+        auto [end, ec] = std::from_chars(port.data(), port.data() + port.size(), parts.port);
+        if (ec != std::errc{} || end != port.data() + port.size()) {
             return std::nullopt;
         }
     } else {
         parts.host = std::string(host_port);
     }
     
+    if (parts.host.empty()) {
+        return std::nullopt;
+    }
     return parts;
 }
 
 std::optional<HttpResponse> HttpClient::get(std::string_view url, std::string_view auth_token) {
-    auto url_parts = parseUrl(url);
-    if (!url_parts) {
-        return std::nullopt;
+    ClientRequest request;
+    request.url = url;
+    if (!auth_token.empty()) {
+        request.headers.emplace_back("Authorization", std::format("Bearer {}", auth_token));
     }
-    
-    return sendRequest("GET", *url_parts, "", "", auth_token);
+    return send(request);
 }
 
 std::optional<HttpResponse> HttpClient::post(
@@ -68,147 +143,669 @@ std::optional<HttpResponse> HttpClient::post(
     std::string_view content_type,
     std::string_view auth_token
 ) {
-    auto url_parts = parseUrl(url);
+    ClientRequest request;
+    request.method = "POST";
+    request.url = url;
+    request.body = body;
+    request.content_type = content_type;
+    if (!auth_token.empty()) {
+        request.headers.emplace_back("Authorization", std::format("Bearer {}", auth_token));
+    }
+    return send(request);
+}
+
+std::optional<HttpResponse> HttpClient::send(const ClientRequest& request) {
+    auto deadline = Clock::now() + std::chrono::milliseconds(options_.timeout_ms);
+    
+    auto url_parts = parseUrl(request.url);
     if (!url_parts) {
         return std::nullopt;
     }
     
-    return sendRequest("POST", *url_parts, body, content_type, auth_token);
-}
-
-std::optional<HttpResponse> HttpClient::sendRequest(
-    std::string_view method,
-    const UrlParts& url_parts,
-    std::string_view body,
-    std::string_view content_type,
-    std::string_view auth_token
-) {
-    try {
-        // Resolve host (simplified - assumes numeric IP or localhost)
-        IPv4 ip;
-        if (url_parts.host == "localhost") {
-            ip = IPv4({127, 0, 0, 1});
-        } else {
-            ip = IPv4(url_parts.host);
+    // Build HTTP request (per-thread buffer, reused across calls)
+    static thread_local std::string head;
+    head.clear();
+    formatRequest(head, request, *url_parts);
+    
+    // A pooled connection may have been closed under us; one retry on a
+    // fresh connection covers that for requests that are safe to repeat
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        std::unique_ptr<HttpStream> stream;
+        try {
+            stream = start(*url_parts, head, false, deadline);
+        } catch (...) {
+            return std::nullopt;
         }
         
-        SockAddr addr(ip, url_parts.port);
-        
-        Socket socket;
-        socket.connect(addr);
-        
-        // Build HTTP request
-        std::string request = std::format("{} {} HTTP/1.1\r\n", method, url_parts.path);
-        request += std::format("Host: {}\r\n", url_parts.host);
-        request += "Connection: close\r\n";
-        
-        if (!auth_token.empty()) {
-            request += std::format("Authorization: Bearer {}\r\n", auth_token);
+        const HttpResponse* head_response = stream->response();
+        if (!head_response) {
+            if (stream->reused_ && !stream->received_any_ && idempotent(request.method) && 
+                Clock::now() < deadline) {
+                continue;
+            }
+            return std::nullopt;
         }
         
-        if (!body.empty()) {
-            request += std::format("Content-Type: {}\r\n", content_type);
-            request += std::format("Content-Length: {}\r\n", body.size());
+        HttpResponse response = *head_response;
+        while (true) {
+            auto piece = stream->read();
+            if (!piece) {
+                return std::nullopt;
+            }
+            if (piece->empty()) {
+                break;
+            }
+            if (response.body.size() + piece->size() > options_.max_response_bytes) {
+                return std::nullopt;
+            }
+            response.body += *piece;
         }
-        
-        request += "\r\n";
-        
-        if (!body.empty()) {
-            request += body;
+        return response;
+    }
+    return std::nullopt;
+}
+
+coro::Task<std::optional<HttpResponse>> HttpClient::fetch(IoService& io, ClientRequest request) {
+    auto deadline = Clock::now() + std::chrono::milliseconds(options_.timeout_ms);
+    
+    auto url_parts = parseUrl(request.url);
+    if (!url_parts) {
+        co_return std::nullopt;
+    }
+    
+    // Owned, not per-thread: the coroutine may resume on another thread
+    std::string head;
+    formatRequest(head, request, *url_parts);
+    
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        std::unique_ptr<HttpStream> stream;
+        try {
+            stream = co_await startAsync(io, *url_parts, head, deadline);
+        } catch (...) {
+            co_return std::nullopt;
         }
         
-        // Send request
-        socket.send(request);
-        
-        // Receive response (simplified - reads until connection closes)
-        std::string response_data;
+        // Each step runs until it needs bytes that have not arrived, then
+        // is repeated once the socket is readable
+        const HttpResponse* head_response = nullptr;
         while (true) {
-            auto chunk = socket.receive(4096);
-            if (chunk.empty()) {
+            try {
+                head_response = stream->response();
                 break;
+            } catch (const HttpStream::WouldBlock&) {}
+            if (!co_await io.readable(stream->socket_, stream->waitMs())) {
+                co_return std::nullopt;
             }
-            response_data.append(chunk.begin(), chunk.end());
+        }
+        if (!head_response) {
+            if (stream->reused_ && !stream->received_any_ && idempotent(request.method) && 
+                Clock::now() < deadline) {
+                continue;
+            }
+            co_return std::nullopt;
         }
         
-        return parseResponse(response_data);
-        
+        HttpResponse response = *head_response;
+        while (true) {
+            std::optional<std::string_view> piece;
+            bool blocked = false;
+            try {
+                piece = stream->read();
+            } catch (const HttpStream::WouldBlock&) {
+                blocked = true;
+            }
+            if (blocked) {
+                if (!co_await io.readable(stream->socket_, stream->waitMs())) {
+                    co_return std::nullopt;
+                }
+                continue;
+            }
+            if (!piece) {
+                co_return std::nullopt;
+            }
+            if (piece->empty()) {
+                break;
+            }
+            if (response.body.size() + piece->size() > options_.max_response_bytes) {
+                co_return std::nullopt;
+            }
+            response.body += *piece;
+        }
+        co_return response;
+    }
+    co_return std::nullopt;
+}
+
+void HttpClient::formatRequest(std::string& out, const ClientRequest& request, const UrlParts& url) {
+    std::format_to(std::back_inserter(out), "{} {} HTTP/1.1\r\n", request.method, url.path);
+    if (url.port == 80) {
+        std::format_to(std::back_inserter(out), "Host: {}\r\n", url.host);
+    } else {
+        std::format_to(std::back_inserter(out), "Host: {}:{}\r\n", url.host, url.port);
+    }
+    for (const auto& [name, value] : request.headers) {
+        std::format_to(std::back_inserter(out), "{}: {}\r\n", name, value);
+    }
+    if (!request.body.empty()) {
+        if (!request.content_type.empty()) {
+            std::format_to(std::back_inserter(out), "Content-Type: {}\r\n", request.content_type);
+        }
+        std::format_to(std::back_inserter(out), "Content-Length: {}\r\n", request.body.size());
+    }
+    out += "\r\n";
+    out += request.body;
+}
+
+std::unique_ptr<HttpStream> HttpClient::open(std::string_view origin, std::string_view head, bool chunked_body) {
+    auto url_parts = parseUrl(origin);
+    if (!url_parts) {
+        return nullptr;
+    }
+    try {
+        return start(*url_parts, head, chunked_body, Clock::time_point::max());
     } catch (...) {
-        return std::nullopt;
+        return nullptr;
     }
 }
 
-std::optional<HttpResponse> HttpClient::parseResponse(std::string_view raw_response) {
-    // Find status line
-    size_t first_line_end = raw_response.find("\r\n");
-    if (first_line_end == std::string_view::npos) {
-        return std::nullopt;
+std::unique_ptr<HttpStream> HttpClient::start(const UrlParts& url, std::string_view head,
+                                              bool chunked_body, Clock::time_point deadline) {
+    std::string key = std::format("{}:{}", url.host, url.port);
+    
+    // Pooled connections first; a send failure there means the server
+    // closed it, so fall through to a fresh one
+    while (auto pooled = acquire(key)) {
+        std::unique_ptr<HttpStream> stream(
+            new HttpStream(*this, key, std::move(*pooled), true, chunked_body, deadline));
+        stream->head_request_ = head.starts_with("HEAD ");
+        try {
+            stream->sendParts(std::span<const std::string_view>(&head, 1));
+            return stream;
+        } catch (const std::exception&) {
+            continue;
+        }
+    }
+    
+    auto ip = dns_.resolve(url.host);
+    if (!ip) {
+        throw std::runtime_error(std::format("Cannot resolve {}", url.host));
     }
     
-    std::string_view status_line = raw_response.substr(0, first_line_end);
+    Socket socket;
+    socket.connect(SockAddr(*ip, url.port), connectWaitMs(deadline));
     
-    // Parse status line: HTTP/1.1 200 OK
-    size_t first_space = status_line.find(' ');
-    if (first_space == std::string_view::npos) {
-        return std::nullopt;
+    std::unique_ptr<HttpStream> stream(
+        new HttpStream(*this, std::move(key), std::move(socket), false, chunked_body, deadline));
+    stream->head_request_ = head.starts_with("HEAD ");
+    stream->sendParts(std::span<const std::string_view>(&head, 1));
+    return stream;
+}
+
+coro::Task<std::unique_ptr<HttpStream>> HttpClient::startAsync(IoService& io, const UrlParts& url,
+                                                                std::string_view head, Clock::time_point deadline) {
+    std::string key = std::format("{}:{}", url.host, url.port);
+    
+    while (auto pooled = acquire(key)) {
+        std::unique_ptr<HttpStream> stream(
+            new HttpStream(*this, key, std::move(*pooled), true, false, deadline));
+        stream->head_request_ = head.starts_with("HEAD ");
+        stream->async_ = true;
+        bool sent = true;
+        try {
+            co_await stream->socket_.asyncSend(io, head, stream->waitMs());
+        } catch (const std::exception&) {
+            sent = false;
+        }
+        if (sent) {
+            co_return stream;
+        }
     }
     
-    size_t second_space = status_line.find(' ', first_space + 1);
-    if (second_space == std::string_view::npos) {
-        return std::nullopt;
+    auto ip = dns_.resolve(url.host);
+    if (!ip) {
+        throw std::runtime_error(std::format("Cannot resolve {}", url.host));
     }
     
-    HttpResponse response;
+    Socket socket;
+    co_await socket.asyncConnect(io, SockAddr(*ip, url.port), connectWaitMs(deadline));
     
-    try {
-        response.status_code = std::stoi(std::string(
-            status_line.substr(first_space + 1, second_space - first_space - 1)
-        ));
-    } catch (...) {
-        return std::nullopt;
+    std::unique_ptr<HttpStream> stream(
+        new HttpStream(*this, std::move(key), std::move(socket), false, false, deadline));
+    stream->head_request_ = head.starts_with("HEAD ");
+    stream->async_ = true;
+    co_await stream->socket_.asyncSend(io, head, stream->waitMs());
+    co_return stream;
+}
+
+int HttpClient::connectWaitMs(Clock::time_point deadline) const {
+    int limit = options_.connect_timeout_ms > 0
+        ? std::min(options_.connect_timeout_ms, options_.timeout_ms)
+        : options_.timeout_ms;
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+    return static_cast<int>(std::clamp<int64_t>(left, 0, limit));
+}
+
+// ========== HTTP STREAM ==========
+
+HttpStream::HttpStream(HttpClient& client, std::string key, Socket socket, bool reused,
+                       bool chunked_body, Clock::time_point deadline)
+    : client_(client)
+    , key_(std::move(key))
+    , socket_(std::move(socket))
+    , reused_(reused)
+    , chunked_body_(chunked_body)
+    , deadline_(deadline)
+    , buffer_(std::move(spare_buffer)) {
+    spare_buffer = std::string();
+}
+
+HttpStream::~HttpStream() {
+    if (body_ == Body::Done && persistent_ && begin_ == size_) {
+        client_.release(key_, std::move(socket_));
+    }
+    if (spare_buffer.capacity() < buffer_.capacity()) {
+        spare_buffer = std::move(buffer_);
     }
+}
+
+int HttpStream::waitMs() const {
+    const auto& options = client_.options_;
+    int limit_ms = options.read_timeout_ms > 0
+        ? std::min(options.read_timeout_ms, options.timeout_ms)
+        : options.timeout_ms;
+    auto limit = std::chrono::milliseconds(limit_ms);
+    auto left = deadline_ - Clock::now();
+    if (left < limit) {
+        return static_cast<int>(std::max<int64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(left).count(), 0));
+    }
+    return limit_ms;
+}
+
+void HttpStream::sendParts(std::span<const std::string_view> parts) {
+    std::array<std::string_view, 4> window{};
+    size_t count = std::min(parts.size(), window.size());
+    std::copy_n(parts.begin(), count, window.begin());
+    std::span<std::string_view> pending(window.data(), count);
     
-    response.status_message = std::string(status_line.substr(second_space + 1));
+    while (!pending.empty()) {
+        auto sent = socket_.trySendv(pending);
+        if (!sent) {
+            if (!socket_.waitWritable(waitMs())) {
+                throw std::runtime_error("Send timed out");
+            }
+            continue;
+        }
+        
+        size_t n = *sent;
+        while (!pending.empty()) {
+            if (n >= pending.front().size()) {
+                n -= pending.front().size();
+                pending = pending.subspan(1);
+            } else {
+                pending.front().remove_prefix(n);
+                break;
+            }
+        }
+    }
+}
+
+bool HttpStream::write(std::string_view data) {
+    if (body_ == Body::Failed || data.empty()) {
+        return body_ != Body::Failed;
+    }
+    try {
+        if (!chunked_body_) {
+            sendParts(std::span<const std::string_view>(&data, 1));
+            return true;
+        }
+        char size_line[20];
+        auto end = std::to_chars(size_line, size_line + sizeof(size_line) - 2, data.size(), 16).ptr;
+        *end++ = '\r';
+        *end++ = '\n';
+        const std::string_view parts[] = {
+            {size_line, static_cast<size_t>(end - size_line)}, data, "\r\n"
+        };
+        sendParts(parts);
+        return true;
+    } catch (const std::exception&) {
+        body_ = Body::Failed;
+        return false;
+    }
+}
+
+bool HttpStream::finish() {
+    if (body_ == Body::Failed) {
+        return false;
+    }
+    if (!chunked_body_) {
+        return true;
+    }
+    try {
+        std::string_view last = "0\r\n\r\n";
+        sendParts(std::span<const std::string_view>(&last, 1));
+        return true;
+    } catch (const std::exception&) {
+        body_ = Body::Failed;
+        return false;
+    }
+}
+
+bool HttpStream::receiveMore() {
+    // Unconsumed bytes move to the front before the buffer grows
+    if (begin_ > 0) {
+        std::copy(buffer_.begin() + static_cast<ptrdiff_t>(begin_), 
+                  buffer_.begin() + static_cast<ptrdiff_t>(size_), buffer_.begin());
+        size_ -= begin_;
+        begin_ = 0;
+    }
+    if (size_ + RECV_CHUNK > buffer_.size()) {
+        buffer_.resize(std::max(size_ + RECV_CHUNK, buffer_.size() * 2));
+    }
     
-    // Find headers end
-    size_t headers_end = raw_response.find("\r\n\r\n");
-    if (headers_end == std::string_view::npos) {
+    while (true) {
+        auto received = socket_.tryReceive(buffer_.data() + size_, buffer_.size() - size_);
+        if (!received) {
+            if (async_) {
+                throw WouldBlock{};
+            }
+            if (!socket_.waitReadable(waitMs())) {
+                throw std::runtime_error("Receive timed out");
+            }
+            continue;
+        }
+        if (*received == 0) {
+            return false;
+        }
+        size_ += *received;
+        received_any_ = true;
+        return true;
+    }
+}
+
+std::optional<std::string_view> HttpStream::nextLine() {
+    std::string_view pending(buffer_.data() + begin_, size_ - begin_);
+    size_t eol = pending.find("\r\n");
+    if (eol == std::string_view::npos) {
+        if (pending.size() > client_.options_.max_response_bytes) {
+            throw std::runtime_error("Response line too long");
+        }
         return std::nullopt;
     }
-    
-    // Parse headers
-    std::string_view headers_section = raw_response.substr(
-        first_line_end + 2, 
-        headers_end - first_line_end - 2
-    );
-    
-    size_t pos = 0;
-    while (pos < headers_section.size()) {
-        size_t line_end = headers_section.find("\r\n", pos);
-        if (line_end == std::string_view::npos) {
-            line_end = headers_section.size();
+    begin_ += eol + 2;
+    return pending.substr(0, eol);
+}
+
+void HttpStream::readHead() {
+    // Status line and headers; interim 1xx responses are skipped
+    std::string_view pending;
+    size_t headers_end;
+    while (true) {
+        while ((headers_end = (pending = std::string_view(buffer_.data() + begin_, size_ - begin_)).find("\r\n\r\n"))
+               == std::string_view::npos) {
+            if (pending.size() > client_.options_.max_response_bytes) {
+                throw std::runtime_error("Response headers too large");
+            }
+            if (!receiveMore()) {
+                throw std::runtime_error("Connection closed before response headers");
+            }
+        }
+        
+        std::string_view block = pending.substr(0, headers_end);
+        size_t line_end = block.find("\r\n");
+        std::string_view status_line = block.substr(0, line_end);
+        
+        // Parse status line: HTTP/1.1 200 OK
+        size_t first_space = status_line.find(' ');
+        if (first_space == std::string_view::npos || !status_line.starts_with("HTTP/")) {
+            throw std::runtime_error("Malformed status line");
+        }
+        bool http10 = status_line.substr(0, first_space) == "HTTP/1.0";
+        auto code = status_line.substr(first_space + 1, 3);
+        auto [end, ec] = std::from_chars(code.data(), code.data() + code.size(), response_.status_code);
+        if (ec != std::errc{} || end != code.data() + code.size()) {
+            throw std::runtime_error("Malformed status code");
+        }
+        size_t second_space = status_line.find(' ', first_space + 1);
+        response_.status_message = second_space == std::string_view::npos
+            ? std::string() : std::string(status_line.substr(second_space + 1));
+        
+        begin_ += headers_end + 4;
+        if (response_.status_code >= 100 && response_.status_code < 200) {
+            continue;
+        }
+        
+        // Parse headers
+        std::optional<size_t> content_length;
+        bool chunked = false;
+        bool close = false;
+        std::string_view rest = line_end == std::string_view::npos ? std::string_view() : block.substr(line_end + 2);
+        while (!rest.empty()) {
+            size_t eol = std::min(rest.find("\r\n"), rest.size());
+            std::string_view line = rest.substr(0, eol);
+            rest.remove_prefix(std::min(eol + 2, rest.size()));
+            
+            size_t colon = line.find(':');
+            if (colon == std::string_view::npos) {
+                continue;
+            }
+            std::string_view name = trim(line.substr(0, colon));
+            std::string_view value = trim(line.substr(colon + 1));
+            
+            if (equalsIgnoreCase(name, "Content-Length")) {
+                size_t length = 0;
+                auto [vend, vec] = std::from_chars(value.data(), value.data() + value.size(), length);
+                if (vec != std::errc{} || vend != value.data() + value.size()) {
+                    throw std::runtime_error("Malformed Content-Length");
+                }
+                content_length = length;
+            } else if (equalsIgnoreCase(name, "Transfer-Encoding")) {
+                chunked = containsIgnoreCase(value, "chunked");
+            } else if (equalsIgnoreCase(name, "Connection")) {
+                close = containsIgnoreCase(value, "close");
+                if (http10 && containsIgnoreCase(value, "keep-alive")) {
+                    http10 = false;  // Persistent after all
+                }
+            }
+            response_.headers.emplace_back(name, value);
         }
         
-        std::string_view line = headers_section.substr(pos, line_end - pos);
+        persistent_ = !close && !http10;
+        if (head_request_ || response_.status_code == 204 || response_.status_code == 304) {
+            body_ = Body::Done;
+        } else if (chunked) {
+            body_ = Body::ChunkSize;
+        } else if (content_length) {
+            remaining_ = *content_length;
+            body_ = remaining_ > 0 ? Body::Length : Body::Done;
+        } else {
+            body_ = Body::UntilClose;
+            persistent_ = false;
+        }
+        return;
+    }
+}
+
+std::string_view HttpStream::readBody() {
+    while (true) {
+        size_t buffered = size_ - begin_;
         
-        size_t colon = line.find(':');
-        if (colon != std::string_view::npos) {
-            std::string name(line.substr(0, colon));
-            std::string value(line.substr(colon + 1));
+        switch (body_) {
+            case Body::Length:
+            case Body::ChunkData: {
+                if (buffered == 0 && !receiveMore()) {
+                    throw std::runtime_error("Connection closed before the end of the body");
+                }
+                size_t take = std::min(remaining_, size_ - begin_);
+                std::string_view piece(buffer_.data() + begin_, take);
+                begin_ += take;
+                remaining_ -= take;
+                if (remaining_ == 0) {
+                    body_ = body_ == Body::Length ? Body::Done : Body::ChunkEnd;
+                }
+                return piece;
+            }
             
-            // Trim whitespace
-            value.erase(0, value.find_first_not_of(" \t"));
-            value.erase(value.find_last_not_of(" \t") + 1);
+            case Body::UntilClose: {
+                if (buffered == 0 && !receiveMore()) {
+                    body_ = Body::Done;
+                    return {};
+                }
+                std::string_view piece(buffer_.data() + begin_, size_ - begin_);
+                begin_ = size_;
+                return piece;
+            }
+            
+            case Body::ChunkSize: {
+                auto line = nextLine();
+                if (!line) {
+                    if (!receiveMore()) throw std::runtime_error("Connection closed inside a chunked body");
+                    break;
+                }
+                auto size_text = line->substr(0, line->find(';'));
+                size_t chunk = 0;
+                auto [end, ec] = std::from_chars(size_text.data(), size_text.data() + size_text.size(), chunk, 16);
+                if (ec != std::errc{} || size_text.empty()) {
+                    throw std::runtime_error("Malformed chunk size");
+                }
+                remaining_ = chunk;
+                body_ = chunk > 0 ? Body::ChunkData : Body::Trailers;
+                break;
+            }
             
-            response.headers[name] = value;
+            case Body::ChunkEnd: {
+                if (buffered < 2) {
+                    if (!receiveMore()) throw std::runtime_error("Connection closed inside a chunked body");
+                    break;
+                }
+                begin_ += 2;
+                body_ = Body::ChunkSize;
+                break;
+            }
+            
+            case Body::Trailers: {
+                auto line = nextLine();
+                if (!line) {
+                    if (!receiveMore()) throw std::runtime_error("Connection closed inside chunked trailers");
+                    break;
+                }
+                if (line->empty()) {
+                    body_ = Body::Done;
+                }
+                break;
+            }
+            
+            case Body::Done:
+                return {};
+            
+            case Body::Unknown:
+            case Body::Failed:
+                throw std::runtime_error("Response not readable");
         }
+    }
+}
+
+const HttpResponse* HttpStream::response() {
+    if (body_ == Body::Failed) {
+        return nullptr;
+    }
+    if (body_ == Body::Unknown) {
+        try {
+            readHead();
+        } catch (const std::exception&) {
+            body_ = Body::Failed;
+            return nullptr;
+        }
+    }
+    return &response_;
+}
+
+std::optional<std::string_view> HttpStream::read() {
+    if (!response()) {
+        return std::nullopt;
+    }
+    try {
+        return readBody();
+    } catch (const std::exception&) {
+        body_ = Body::Failed;
+        return std::nullopt;
+    }
+}
+
+std::optional<Socket> HttpClient::acquire(const std::string& key) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    auto it = idle_.find(key);
+    if (it == idle_.end()) {
+        return std::nullopt;
+    }
+    
+    auto& connections = it->second;
+    auto oldest_allowed = Clock::now() - options_.idle_timeout;
+    while (!connections.empty()) {
+        // Most recently used first: the least likely to have been closed
+        IdleConnection candidate = std::move(connections.back());
+        connections.pop_back();
         
-        pos = line_end + 2;
+        // A readable idle connection is at EOF (or has stray bytes): unusable
+        if (candidate.since >= oldest_allowed && !candidate.socket.waitReadable(0)) {
+            return std::move(candidate.socket);
+        }
+    }
+    return std::nullopt;
+}
+
+void HttpClient::release(const std::string& key, Socket socket) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    auto& connections = idle_[key];
+    if (connections.size() >= options_.max_idle_per_host) {
+        connections.erase(connections.begin());  // Drop the oldest
     }
+    connections.push_back({std::move(socket), Clock::now()});
+}
+
+size_t HttpClient::idleConnections() const {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    size_t count = 0;
+    for (const auto& [key, connections] : idle_) {
+        count += connections.size();
+    }
+    return count;
+}
+
+void HttpClient::closeIdle() {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    idle_.clear();
+}
+
+std::future<std::optional<HttpResponse>> HttpClient::sendAsync(ClientRequest request) {
+    return std::async(std::launch::async, [this, request = std::move(request)] {
+        return send(request);
+    });
+}
+
+std::vector<std::optional<HttpResponse>> HttpClient::sendBatch(
+    std::span<const ClientRequest> requests, size_t parallelism) {
+    std::vector<std::optional<HttpResponse>> results(requests.size());
+    std::atomic<size_t> next{0};
     
-    // Extract body
-    response.body = std::string(raw_response.substr(headers_end + 4));
+    // Each worker takes the next unsent request; connections return to the
+    // pool between requests, so workers share them
+    auto work = [&] {
+        for (size_t i = next.fetch_add(1); i < requests.size(); i = next.fetch_add(1)) {
+            results[i] = send(requests[i]);
+        }
+    };
+    
+    size_t workers = std::clamp<size_t>(parallelism, 1, std::max<size_t>(requests.size(), 1));
+    std::vector<std::jthread> threads;
+    threads.reserve(workers - 1);
+    for (size_t i = 1; i < workers; ++i) {
+        threads.emplace_back(work);
+    }
+    work();  // The caller is worker 0
+    threads.clear();  // Join
     
-    return response;
+    return results;
 }
 
-} // namespace frqs::net
\ No newline at end of file
+} // namespace frqs::net
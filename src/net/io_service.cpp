@@ -0,0 +1,190 @@
+/**
+ * @file net/io_service.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief I/O thread behind the awaitable socket waits
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "net/io_service.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+namespace frqs::net {
+
+namespace {
+
+constexpr size_t MAX_EVENTS = 256 ;
+
+struct Resumption {
+    coro::Executor* executor ;
+    std::coroutine_handle<> coroutine ;
+} ;
+
+} // namespace
+
+IoService::~IoService() {
+    stop() ;
+}
+
+IoService::WaitAwaiter IoService::readable(const Socket& socket, int timeout_ms) noexcept {
+    return WaitAwaiter(*this, socket.native_handle(), IoEvent::Read, timeout_ms) ;
+}
+
+IoService::WaitAwaiter IoService::writable(const Socket& socket, int timeout_ms) noexcept {
+    return WaitAwaiter(*this, socket.native_handle(), IoEvent::Write, timeout_ms) ;
+}
+
+IoService::WaitAwaiter IoService::sleepFor(std::chrono::milliseconds duration) noexcept {
+    auto ms = std::max<int64_t>(duration.count(), 0) ;
+    return WaitAwaiter(*this, Socket::invalid_handle, IoEvent::None,
+                       static_cast<int>(std::min<int64_t>(ms, INT32_MAX))) ;
+}
+
+bool IoService::WaitAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    coroutine_ = handle ;
+    executor_ = coro::currentExecutor() ;
+    if (!io_.arm(*this)) {
+        timed_out_ = true ;
+        return false ;
+    }
+    return true ;
+}
+
+bool IoService::arm(WaitAwaiter& waiter) {
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    if (stopping_) {
+        return false ;
+    }
+    if (!thread_.joinable()) {
+        thread_ = std::thread([this] { run() ; }) ;
+    }
+
+    uint64_t id = next_id_++ ;
+    waiter.id_ = id ;
+    pending_.emplace(id, &waiter) ;
+
+    bool earliest = false ;
+    if (waiter.timeout_ms_ >= 0) {
+        auto when = clock::now() + std::chrono::milliseconds(waiter.timeout_ms_) ;
+        auto next = timers_.nextExpiry() ;
+        earliest = !next || when < *next ;
+        timers_.schedule(waiter.timer_, when, &waiter) ;
+    }
+
+    if (waiter.handle_ != Socket::invalid_handle) {
+        try {
+            // The id, not the awaiter, travels through the loop: an event
+            // is only acted on while its wait is still in pending_
+            loop_.add(waiter.handle_, waiter.events_, std::bit_cast<void*>(static_cast<uintptr_t>(id)), true) ;
+        } catch (...) {
+            pending_.erase(id) ;
+            timers_.cancel(waiter.timer_) ;
+            throw ;
+        }
+    }
+
+    // The I/O thread only needs waking when its current sleep is too long
+    if (earliest) {
+        loop_.wakeup() ;
+    }
+    return true ;
+}
+
+void IoService::run() {
+    std::array<ReadyEvent, MAX_EVENTS> events ;
+    std::vector<Resumption> ready ;
+
+    while (true) {
+        int timeout_ms = -1 ;
+        {
+            std::lock_guard<std::mutex> lock(mutex_) ;
+            if (stopping_) {
+                break ;
+            }
+            if (auto next = timers_.nextExpiry()) {
+                auto wait = *next - clock::now() ;
+                // Round up so a timer is never woken for early
+                auto ms = std::chrono::ceil<std::chrono::milliseconds>(wait).count() ;
+                timeout_ms = static_cast<int>(std::clamp<int64_t>(ms, 0, INT32_MAX)) ;
+            }
+        }
+
+        size_t n = loop_.wait(events, timeout_ms) ;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_) ;
+            for (size_t i = 0 ; i < n ; ++i) {
+                auto id = static_cast<uint64_t>(std::bit_cast<uintptr_t>(events[i].data)) ;
+                auto it = pending_.find(id) ;
+                if (it == pending_.end()) {
+                    continue ;
+                }
+                auto* waiter = it->second ;
+                pending_.erase(it) ;
+                timers_.cancel(waiter->timer_) ;
+                loop_.remove(waiter->handle_) ;
+                ready.push_back({waiter->executor_, waiter->coroutine_}) ;
+            }
+
+            timers_.advance(clock::now(), [&](utils::TimerWheel::Timer& timer) {
+                auto* waiter = static_cast<WaitAwaiter*>(timer.data) ;
+                pending_.erase(waiter->id_) ;
+                if (waiter->handle_ != Socket::invalid_handle) {
+                    loop_.remove(waiter->handle_) ;
+                }
+                waiter->timed_out_ = true ;
+                ready.push_back({waiter->executor_, waiter->coroutine_}) ;
+            }) ;
+        }
+
+        // Outside the lock: an inline resume may start the next wait
+        for (auto& resumption : ready) {
+            coro::resumeOn(resumption.executor, resumption.coroutine) ;
+        }
+        ready.clear() ;
+    }
+
+    // Stopping: every wait still pending ends as a timeout
+    {
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        for (auto& [id, waiter] : pending_) {
+            if (waiter->handle_ != Socket::invalid_handle) {
+                loop_.remove(waiter->handle_) ;
+            }
+            waiter->timed_out_ = true ;
+            ready.push_back({waiter->executor_, waiter->coroutine_}) ;
+        }
+        pending_.clear() ;
+        timers_.clear() ;
+    }
+    for (auto& resumption : ready) {
+        coro::resumeOn(resumption.executor, resumption.coroutine) ;
+    }
+}
+
+void IoService::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        if (stopping_) {
+            return ;
+        }
+        stopping_ = true ;
+    }
+    loop_.wakeup() ;
+    if (thread_.joinable()) {
+        thread_.join() ;
+    }
+}
+
+size_t IoService::pendingWaits() const {
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    return pending_.size() ;
+}
+
+} // namespace frqs::net
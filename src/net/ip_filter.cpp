@@ -0,0 +1,340 @@
+/**
+ * @file net/ip_filter.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Allow/deny and rate-limit table of IPv4 CIDR blocks
+ * @version 1.0.0
+ * @date 2025-12-15
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "net/ip_filter.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <sstream>
+
+namespace frqs::net {
+
+namespace {
+
+std::string_view trim(std::string_view text) noexcept {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1) ;
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1) ;
+    return text ;
+}
+
+// Next whitespace-separated word of `text`, consumed
+std::string_view nextWord(std::string_view& text) noexcept {
+    text = trim(text) ;
+    size_t end = std::min(text.find_first_of(" \t"), text.size()) ;
+    auto word = text.substr(0, end) ;
+    text.remove_prefix(end) ;
+    return word ;
+}
+
+std::optional<double> parseNumber(std::string_view text) noexcept {
+    double value = 0 ;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value) ;
+    if (ec != std::errc{} || end != text.data() + text.size() || !std::isfinite(value) || value < 0) {
+        return std::nullopt ;
+    }
+    return value ;
+}
+
+// Process-wide, so a snapshot cached for one filter never matches another
+// allocated at the same address
+uint64_t nextGeneration() noexcept {
+    static std::atomic<uint64_t> counter{0} ;
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1 ;
+}
+
+int64_t steadyNanos() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count() ;
+}
+
+} // namespace
+
+// ========== CIDR BLOCK ==========
+
+std::optional<CidrBlock> CidrBlock::parse(std::string_view text) noexcept {
+    std::string_view address = text ;
+    uint8_t prefix = 32 ;
+    
+    if (size_t slash = text.find('/') ; slash != std::string_view::npos) {
+        address = text.substr(0, slash) ;
+        auto bits = text.substr(slash + 1) ;
+        unsigned value = 0 ;
+        auto [end, ec] = std::from_chars(bits.data(), bits.data() + bits.size(), value) ;
+        if (bits.empty() || ec != std::errc{} || end != bits.data() + bits.size() || value > 32) {
+            return std::nullopt ;
+        }
+        prefix = static_cast<uint8_t>(value) ;
+    }
+    
+    uint32_t bits = 0 ;
+    for (int octet = 0 ; octet < 4 ; ++octet) {
+        if (octet > 0) {
+            if (address.empty() || address.front() != '.') {
+                return std::nullopt ;
+            }
+            address.remove_prefix(1) ;
+        }
+        unsigned value = 0 ;
+        auto [end, ec] = std::from_chars(address.data(), address.data() + address.size(), value) ;
+        size_t digits = static_cast<size_t>(end - address.data()) ;
+        if (ec != std::errc{} || digits == 0 || digits > 3 || value > 255) {
+            return std::nullopt ;
+        }
+        bits = (bits << 8) | value ;
+        address.remove_prefix(digits) ;
+    }
+    if (!address.empty()) {
+        return std::nullopt ;
+    }
+    
+    return CidrBlock{IPv4(bits) & IPv4::mask(prefix), prefix} ;
+}
+
+std::string CidrBlock::toString() const {
+    return std::format("{}/{}", network.toString(), prefix) ;
+}
+
+// ========== RULE SET ==========
+
+IpRuleSet::IpRuleSet(std::vector<IpRule> rules, IpAction default_action)
+    : rules_(std::move(rules))
+    , default_action_(default_action)
+    , buckets_(std::make_unique<TokenBucket[]>(rules_.size())) {
+    
+    int64_t now = steadyNanos() ;
+    for (size_t i = 0 ; i < rules_.size() ; ++i) {
+        const auto& rule = rules_[i] ;
+        if (rule.action == IpAction::Limit) {
+            auto& bucket = buckets_[i] ;
+            bucket.per_second = static_cast<int64_t>(rule.rate * 1000) ;
+            bucket.capacity = std::max<int64_t>(static_cast<int64_t>((rule.burst > 0 ? rule.burst : rule.rate) * 1000), 1000) ;
+            bucket.tokens.store(bucket.capacity, std::memory_order_relaxed) ;
+            bucket.refilled_at.store(now, std::memory_order_relaxed) ;
+        }
+    }
+    
+    // Flatten the nested blocks into disjoint intervals. CIDR blocks either
+    // nest or do not overlap, so a sweep in (start, broadest first) order
+    // with a stack of enclosing blocks assigns every address its innermost
+    // rule in O(n log n).
+    std::vector<uint32_t> order(rules_.size()) ;
+    for (uint32_t i = 0 ; i < order.size() ; ++i) order[i] = i ;
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        const auto& x = rules_[a].block ;
+        const auto& y = rules_[b].block ;
+        return x.first() != y.first() ? x.first() < y.first() : x.prefix < y.prefix ;
+    }) ;
+    
+    uint64_t cursor = 0 ;   // First address not yet assigned (64-bit: may pass 0xFFFFFFFF)
+    std::vector<uint32_t> open ;
+    auto emit = [&](uint64_t upto, uint32_t rule) {
+        if (cursor <= upto) {
+            intervals_.push_back({static_cast<uint32_t>(cursor), static_cast<uint32_t>(upto), rule}) ;
+            cursor = upto + 1 ;
+        }
+    } ;
+    
+    for (uint32_t index : order) {
+        uint64_t first = rules_[index].block.first() ;
+        while (!open.empty() && rules_[open.back()].block.last() < first) {
+            emit(rules_[open.back()].block.last(), open.back()) ;
+            open.pop_back() ;
+        }
+        if (!open.empty() && first > 0) {
+            emit(first - 1, open.back()) ;
+        }
+        cursor = std::max(cursor, first) ;
+        open.push_back(index) ;
+    }
+    while (!open.empty()) {
+        emit(rules_[open.back()].block.last(), open.back()) ;
+        open.pop_back() ;
+    }
+}
+
+std::shared_ptr<const IpRuleSet> IpRuleSet::parse(std::string_view text, std::string* error) {
+    std::vector<IpRule> rules ;
+    IpAction default_action = IpAction::Allow ;
+    
+    auto fail = [error](size_t line, std::string_view message) -> std::shared_ptr<const IpRuleSet> {
+        if (error) {
+            *error = std::format("line {}: {}", line, message) ;
+        }
+        return nullptr ;
+    } ;
+    
+    size_t line_number = 0 ;
+    while (!text.empty()) {
+        ++line_number ;
+        size_t eol = std::min(text.find('\n'), text.size()) ;
+        std::string_view line = text.substr(0, eol) ;
+        text.remove_prefix(std::min(eol + 1, text.size())) ;
+        
+        line = trim(line.substr(0, line.find('#'))) ;
+        if (line.empty()) {
+            continue ;
+        }
+        
+        auto verb = nextWord(line) ;
+        auto target = nextWord(line) ;
+        
+        if (verb == "default") {
+            if (target == "allow") default_action = IpAction::Allow ;
+            else if (target == "deny") default_action = IpAction::Deny ;
+            else return fail(line_number, "default must be allow or deny") ;
+            continue ;
+        }
+        
+        IpRule rule ;
+        if (verb == "allow") rule.action = IpAction::Allow ;
+        else if (verb == "deny") rule.action = IpAction::Deny ;
+        else if (verb == "limit") rule.action = IpAction::Limit ;
+        else return fail(line_number, "expected allow, deny, limit or default") ;
+        
+        auto block = CidrBlock::parse(target) ;
+        if (!block) {
+            return fail(line_number, "invalid CIDR block") ;
+        }
+        rule.block = *block ;
+        
+        if (rule.action == IpAction::Limit) {
+            auto rate = parseNumber(nextWord(line)) ;
+            if (!rate || *rate == 0) {
+                return fail(line_number, "limit needs a positive rate") ;
+            }
+            rule.rate = *rate ;
+            if (auto burst_text = nextWord(line) ; !burst_text.empty()) {
+                auto burst = parseNumber(burst_text) ;
+                if (!burst) {
+                    return fail(line_number, "invalid burst") ;
+                }
+                rule.burst = *burst ;
+            }
+        }
+        if (!trim(line).empty()) {
+            return fail(line_number, "unexpected text after the rule") ;
+        }
+        rules.push_back(rule) ;
+    }
+    
+    return std::make_shared<const IpRuleSet>(std::move(rules), default_action) ;
+}
+
+std::shared_ptr<const IpRuleSet> IpRuleSet::load(const std::filesystem::path& path, std::string* error) {
+    std::ifstream file(path, std::ios::binary) ;
+    if (!file) {
+        if (error) {
+            *error = "cannot open " + path.string() ;
+        }
+        return nullptr ;
+    }
+    std::ostringstream content ;
+    content << file.rdbuf() ;
+    return parse(content.str(), error) ;
+}
+
+const IpRule* IpRuleSet::match(const IPv4& address) const noexcept {
+    uint32_t value = address.toUint32() ;
+    auto it = std::upper_bound(intervals_.begin(), intervals_.end(), value,
+                               [](uint32_t v, const Interval& interval) { return v < interval.first ; }) ;
+    if (it == intervals_.begin()) {
+        return nullptr ;
+    }
+    --it ;
+    return value <= it->last ? &rules_[it->rule] : nullptr ;
+}
+
+bool IpRuleSet::admit(const IPv4& address) const noexcept {
+    const IpRule* rule = match(address) ;
+    if (!rule) {
+        return default_action_ == IpAction::Allow ;
+    }
+    switch (rule->action) {
+        case IpAction::Allow: return true ;
+        case IpAction::Deny: return false ;
+        case IpAction::Limit: return buckets_[static_cast<size_t>(rule - rules_.data())].take(steadyNanos()) ;
+    }
+    return false ;
+}
+
+bool IpRuleSet::TokenBucket::take(int64_t now) noexcept {
+    // Whoever advances the refill timestamp adds the tokens for that span.
+    // It only moves by whole millitokens, so frequent calls still refill.
+    int64_t last = refilled_at.load(std::memory_order_relaxed) ;
+    int64_t elapsed = now - last ;
+    if (elapsed > 0 && per_second > 0) {
+        constexpr int64_t MAX_SPAN = 3600LL * 1'000'000'000LL ;   // Keeps the products in range
+        int64_t span = std::min(elapsed, MAX_SPAN) ;
+        auto add = static_cast<int64_t>(static_cast<double>(span) * static_cast<double>(per_second) / 1e9) ;
+        if (add > 0) {
+            int64_t advanced = elapsed > MAX_SPAN 
+                ? now : last + static_cast<int64_t>(static_cast<double>(add) * 1e9 / static_cast<double>(per_second)) ;
+            if (refilled_at.compare_exchange_strong(last, advanced, std::memory_order_relaxed)) {
+                int64_t current = tokens.load(std::memory_order_relaxed) ;
+                while (!tokens.compare_exchange_weak(current, std::min(capacity, current + add), 
+                                                     std::memory_order_relaxed)) {}
+            }
+        }
+    }
+    
+    int64_t current = tokens.load(std::memory_order_relaxed) ;
+    while (current >= 1000) {
+        if (tokens.compare_exchange_weak(current, current - 1000, std::memory_order_relaxed)) {
+            return true ;
+        }
+    }
+    return false ;
+}
+
+// ========== FILTER ==========
+
+IpFilter::IpFilter() : generation_(nextGeneration()) {}
+
+IpFilter::IpFilter(std::shared_ptr<const IpRuleSet> rules)
+    : rules_(std::move(rules))
+    , generation_(nextGeneration()) {}
+
+void IpFilter::reload(std::shared_ptr<const IpRuleSet> rules) noexcept {
+    rules_.store(std::move(rules)) ;
+    generation_.store(nextGeneration(), std::memory_order_release) ;
+}
+
+bool IpFilter::admit(const IPv4& address) noexcept {
+    // The accept threads keep the last snapshot they saw and only reload it
+    // (a reference-count round trip) after the generation moved
+    struct Snapshot {
+        uint64_t generation = 0 ;
+        std::shared_ptr<const IpRuleSet> rules ;
+    } ;
+    static thread_local Snapshot snapshot ;
+    
+    uint64_t generation = generation_.load(std::memory_order_acquire) ;
+    if (snapshot.generation != generation) {
+        snapshot = {generation, rules_.load()} ;
+    }
+    const IpRuleSet* rules = snapshot.rules.get() ;
+    bool allowed = !rules || rules->admit(address) ;
+    (allowed ? admitted_ : rejected_).fetch_add(1, std::memory_order_relaxed) ;
+    return allowed ;
+}
+
+bool IpFilter::reloadFile(const std::filesystem::path& path, std::string* error) {
+    auto rules = IpRuleSet::load(path, error) ;
+    if (!rules) {
+        return false ;
+    }
+    reload(std::move(rules)) ;
+    return true ;
+}
+
+} // namespace frqs::net
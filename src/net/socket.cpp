@@ -5,19 +5,107 @@
  */
 
 #include "net/socket.hpp"
+#include "net/io_service.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <stdexcept>
 #include <string>
 
 #ifdef _WIN32
     #include <ws2tcpip.h>
+    #include <mswsock.h>
 #else
     #include <errno.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+    #if defined(__linux__)
+        #include <sys/sendfile.h>
+    #elif defined(__APPLE__) || defined(__FreeBSD__)
+        #include <sys/types.h>
+    #endif
     #include <netinet/in.h>
+    #include <netinet/tcp.h>
     #include <cstring>
 #endif
 
 namespace frqs::net {
 
+namespace {
+
+#if defined(MSG_NOSIGNAL)
+    // A peer that disconnects mid-response must not raise SIGPIPE
+    constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+    constexpr int SEND_FLAGS = 0;
+#endif
+
+bool wouldBlock() noexcept {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+bool interrupted() noexcept {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEINTR;
+#else
+    return errno == EINTR;
+#endif
+}
+
+std::string lastError() {
+#ifdef _WIN32
+    return "Error: " + std::to_string(WSAGetLastError());
+#else
+    return std::string(strerror(errno));
+#endif
+}
+
+bool pollHandle(Socket::native_handle_t handle, short events, int timeout_ms) {
+#ifdef _WIN32
+    WSAPOLLFD pfd{handle, events, 0};
+    int rc = ::WSAPoll(&pfd, 1, timeout_ms);
+#else
+    pollfd pfd{handle, events, 0};
+    int rc;
+    do {
+        rc = ::poll(&pfd, 1, timeout_ms);
+    } while (rc < 0 && errno == EINTR);
+#endif
+    if (rc < 0) {
+        throw std::runtime_error("Poll failed: " + lastError());
+    }
+    return rc > 0;
+}
+
+// Positioned read for the paths that cannot hand the file to the kernel
+size_t readAt(Socket::native_file_t file, void* buffer, size_t size, uint64_t offset) {
+#ifdef _WIN32
+    OVERLAPPED position{};
+    position.Offset = static_cast<DWORD>(offset);
+    position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD n = 0;
+    if (!::ReadFile(file, buffer, static_cast<DWORD>(size), &n, &position) && 
+        ::GetLastError() != ERROR_HANDLE_EOF) {
+        throw std::runtime_error("ReadFile failed: " + std::to_string(::GetLastError()));
+    }
+    return n;
+#else
+    auto n = ::pread(file, buffer, size, static_cast<off_t>(offset));
+    if (n < 0) {
+        throw std::runtime_error("pread failed: " + lastError());
+    }
+    return static_cast<size_t>(n);
+#endif
+}
+
+} // namespace
+
 NetworkInit::NetworkInit() {
 #ifdef _WIN32
     WSADATA wsaData;
@@ -59,7 +147,7 @@ Socket::Socket() {
         throw std::runtime_error("Failed to set SO_REUSEADDR: " + std::string(strerror(errno)));
 #endif
     }
-    
+
 #ifdef _WIN32
     // Windows-specific: Disable exclusive address use
     BOOL bOptVal = FALSE;
@@ -77,12 +165,14 @@ Socket::~Socket() {
 }
 
 Socket::Socket(Socket&& other) noexcept
-    : handle_(std::exchange(other.handle_, invalid_handle)) {}
+    : handle_(std::exchange(other.handle_, invalid_handle)), 
+      tls_(std::move(other.tls_)) {}
 
 Socket& Socket::operator=(Socket&& other) noexcept {
     if (this != &other) {
         close();
         handle_ = std::exchange(other.handle_, invalid_handle);
+        tls_ = std::move(other.tls_);
     }
     return *this;
 }
@@ -95,7 +185,7 @@ void Socket::bind(const SockAddr& addr) {
         
         // ✅ IMPROVED ERROR MESSAGE with detailed information
         std::string error_msg = "Bind failed on " + addr.toString();
-        
+
 #ifdef _WIN32
         int error_code = WSAGetLastError();
         
@@ -145,7 +235,7 @@ void Socket::bind(const SockAddr& addr) {
                 error_msg += " - " + std::string(strerror(error_code));
         }
 #endif
-        
+
         throw std::runtime_error(error_msg);
     }
 }
@@ -176,6 +266,41 @@ void Socket::connect(const SockAddr& addr) {
     }
 }
 
+void Socket::connect(const SockAddr& addr, int timeout_ms) {
+    setNonBlocking(true);
+    
+    auto native_addr = addr.native();
+    if (::connect(handle_, reinterpret_cast<const sockaddr*>(&native_addr), 
+                  sizeof(native_addr)) == 0) {
+        return;
+    }
+#ifdef _WIN32
+    if (WSAGetLastError() != WSAEWOULDBLOCK) {
+#else
+    if (errno != EINPROGRESS) {
+#endif
+        throw std::runtime_error("Connect to " + addr.toString() + " failed: " + lastError());
+    }
+    
+    if (!waitWritable(timeout_ms)) {
+        throw std::runtime_error("Connect to " + addr.toString() + " timed out");
+    }
+    
+    // Writable means the handshake finished; SO_ERROR says how
+    int error = 0;
+    socklen_t length = sizeof(error);
+    ::getsockopt(handle_, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &length);
+    if (error != 0) {
+#ifdef _WIN32
+        throw std::runtime_error("Connect to " + addr.toString() + 
+                               " failed. Error: " + std::to_string(error));
+#else
+        throw std::runtime_error("Connect to " + addr.toString() + 
+                               " failed: " + std::string(strerror(error)));
+#endif
+    }
+}
+
 Socket Socket::accept(SockAddr* out_client_addr) {
     SockAddr::native_t client_native{};
     socklen_t len = sizeof(client_native);
@@ -208,8 +333,17 @@ Socket Socket::accept(SockAddr* out_client_addr) {
 }
 
 size_t Socket::send(const void* data, size_t size) {
+    if (userSpaceTls()) {
+        while (true) {
+            if (auto sent = tls_->write(data, size)) {
+                return *sent;
+            }
+            waitWritable();
+        }
+    }
+    
     auto sent = ::send(handle_, static_cast<const char*>(data), 
-                       static_cast<int>(size), 0);
+                       static_cast<int>(size), SEND_FLAGS);
     if (sent < 0) {
 #ifdef _WIN32
         int err = WSAGetLastError();
@@ -226,6 +360,15 @@ size_t Socket::send(std::string_view data) {
 }
 
 size_t Socket::receive(void* buffer, size_t size) {
+    if (tls_) {
+        while (true) {
+            if (auto received = tls_->read(buffer, size)) {
+                return *received;
+            }
+            waitReadable();
+        }
+    }
+    
     auto received = ::recv(handle_, static_cast<char*>(buffer), 
                           static_cast<int>(size), 0);
     if (received < 0) {
@@ -246,7 +389,503 @@ std::vector<char> Socket::receive(size_t max_size) {
     return buffer;
 }
 
+void Socket::sendAll(std::string_view data) {
+    while (!data.empty()) {
+        auto sent = trySend(data.data(), data.size());
+        if (!sent) {
+            waitWritable();
+            continue;
+        }
+        data.remove_prefix(*sent);
+    }
+}
+
+void Socket::sendAll(std::span<const std::string_view> buffers) {
+    std::array<std::string_view, MAX_IOV> window;
+    
+    while (!buffers.empty()) {
+        size_t count = std::min(buffers.size(), MAX_IOV);
+        std::copy_n(buffers.begin(), count, window.begin());
+        buffers = buffers.subspan(count);
+        
+        std::span<std::string_view> pending(window.data(), count);
+        while (!pending.empty()) {
+            auto sent = trySendv(pending);
+            if (!sent) {
+                waitWritable();
+                continue;
+            }
+            
+            // Drop fully written buffers, trim the partially written one
+            size_t n = *sent;
+            while (!pending.empty()) {
+                if (n >= pending.front().size()) {
+                    n -= pending.front().size();
+                    pending = pending.subspan(1);
+                } else {
+                    pending.front().remove_prefix(n);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void Socket::setNonBlocking(bool enabled) {
+#ifdef _WIN32
+    u_long mode = enabled ? 1 : 0;
+    if (::ioctlsocket(handle_, FIONBIO, &mode) != 0) {
+        throw std::runtime_error("Failed to set non-blocking mode. " + lastError());
+    }
+#else
+    int flags = ::fcntl(handle_, F_GETFL, 0);
+    if (flags < 0) {
+        throw std::runtime_error("fcntl(F_GETFL) failed: " + lastError());
+    }
+    flags = enabled ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    if (::fcntl(handle_, F_SETFL, flags) != 0) {
+        throw std::runtime_error("fcntl(F_SETFL) failed: " + lastError());
+    }
+#endif
+}
+
+bool Socket::setReusePort(bool enabled) {
+#if defined(SO_REUSEPORT_LB)
+    // FreeBSD: plain SO_REUSEPORT only allows the bind; _LB also balances
+    constexpr int option = SO_REUSEPORT_LB;
+#elif defined(SO_REUSEPORT)
+    constexpr int option = SO_REUSEPORT;
+#else
+    constexpr int option = -1;
+#endif
+
+    if constexpr (option < 0) {
+        // Windows has no equivalent: several listeners on one port only
+        // works with SO_REUSEADDR, which does not balance connections
+        (void)enabled;
+        return false;
+    } else {
+        int opt = enabled ? 1 : 0;
+        return ::setsockopt(handle_, SOL_SOCKET, option,
+                            reinterpret_cast<const char*>(&opt), sizeof(opt)) == 0;
+    }
+}
+
+bool Socket::setDeferAccept(int seconds) {
+#if defined(TCP_DEFER_ACCEPT)
+    int opt = std::max(seconds, 0);
+    return ::setsockopt(handle_, IPPROTO_TCP, TCP_DEFER_ACCEPT,
+                        reinterpret_cast<const char*>(&opt), sizeof(opt)) == 0;
+#else
+    (void)seconds;
+    return false;
+#endif
+}
+
+bool Socket::setNoDelay(bool enabled) {
+    int opt = enabled ? 1 : 0;
+    return ::setsockopt(handle_, IPPROTO_TCP, TCP_NODELAY,
+                        reinterpret_cast<const char*>(&opt), sizeof(opt)) == 0;
+}
+
+bool Socket::setCork(bool enabled) {
+#if defined(TCP_CORK)
+    constexpr int option = TCP_CORK;
+#elif defined(TCP_NOPUSH)
+    constexpr int option = TCP_NOPUSH;
+#else
+    constexpr int option = -1;
+#endif
+
+    if constexpr (option < 0) {
+        (void)enabled;
+        return false;
+    } else {
+        int opt = enabled ? 1 : 0;
+        return ::setsockopt(handle_, IPPROTO_TCP, option,
+                            reinterpret_cast<const char*>(&opt), sizeof(opt)) == 0;
+    }
+}
+
+bool Socket::setFastOpen(int queue_length) {
+#if defined(TCP_FASTOPEN)
+#if defined(__APPLE__)
+    int opt = queue_length > 0 ? 1 : 0;  // An on/off switch; the queue is sized by sysctl
+#else
+    int opt = std::max(queue_length, 0);
+#endif
+    return ::setsockopt(handle_, IPPROTO_TCP, TCP_FASTOPEN,
+                        reinterpret_cast<const char*>(&opt), sizeof(opt)) == 0;
+#else
+    (void)queue_length;
+    return false;
+#endif
+}
+
+bool Socket::setReceiveBuffer(int bytes) {
+    return ::setsockopt(handle_, SOL_SOCKET, SO_RCVBUF,
+                        reinterpret_cast<const char*>(&bytes), sizeof(bytes)) == 0;
+}
+
+bool Socket::setSendBuffer(int bytes) {
+    return ::setsockopt(handle_, SOL_SOCKET, SO_SNDBUF,
+                        reinterpret_cast<const char*>(&bytes), sizeof(bytes)) == 0;
+}
+
+bool Socket::setBusyPoll(int microseconds) {
+#if defined(SO_BUSY_POLL)
+    int opt = std::max(microseconds, 0);
+    return ::setsockopt(handle_, SOL_SOCKET, SO_BUSY_POLL,
+                        reinterpret_cast<const char*>(&opt), sizeof(opt)) == 0;
+#else
+    (void)microseconds;
+    return false;
+#endif
+}
+
+std::vector<std::string_view> Socket::configureListener(const SocketOptions& options) {
+    std::vector<std::string_view> skipped;
+    if (options.receive_buffer > 0 && !setReceiveBuffer(options.receive_buffer)) {
+        skipped.push_back("SO_RCVBUF");
+    }
+    if (options.send_buffer > 0 && !setSendBuffer(options.send_buffer)) {
+        skipped.push_back("SO_SNDBUF");
+    }
+    if (options.fast_open_queue > 0 && !setFastOpen(options.fast_open_queue)) {
+        skipped.push_back("TCP_FASTOPEN");
+    }
+    if (options.defer_accept_seconds > 0 && !setDeferAccept(options.defer_accept_seconds)) {
+        skipped.push_back("TCP_DEFER_ACCEPT");
+    }
+    if (options.busy_poll_us > 0 && !setBusyPoll(options.busy_poll_us)) {
+        skipped.push_back("SO_BUSY_POLL");  // Tried here too, so a refusal is reported once
+    }
+    return skipped;
+}
+
+void Socket::configureAccepted(const SocketOptions& options) {
+    if (options.no_delay) {
+        setNoDelay(true);
+    }
+    if (options.busy_poll_us > 0) {
+        setBusyPoll(options.busy_poll_us);
+    }
+}
+
+std::optional<Socket> Socket::tryAccept(SockAddr* out_client_addr) {
+    SockAddr::native_t client_native{};
+    socklen_t len = sizeof(client_native);
+    
+    native_handle_t client_fd = ::accept(
+        handle_, 
+        reinterpret_cast<sockaddr*>(&client_native), 
+        &len
+    );
+    
+    if (client_fd == invalid_handle) {
+#ifdef _WIN32
+        int err = WSAGetLastError();
+        if (err == WSAEWOULDBLOCK || err == WSAEINTR || err == WSAECONNRESET) {
+            return std::nullopt;
+        }
+#else
+        // The peer may reset the connection between readiness and accept()
+        if (wouldBlock() || errno == EINTR || errno == ECONNABORTED) {
+            return std::nullopt;
+        }
+#endif
+        throw std::runtime_error("Accept failed: " + lastError());
+    }
+    
+    if (out_client_addr) {
+        *out_client_addr = SockAddr(client_native);
+    }
+    
+    return Socket(client_fd);
+}
+
+std::optional<size_t> Socket::tryReceive(void* buffer, size_t size) {
+    if (tls_) {
+        return tls_->read(buffer, size);
+    }
+    while (true) {
+        auto received = ::recv(handle_, static_cast<char*>(buffer), 
+                              static_cast<int>(size), 0);
+        if (received >= 0) {
+            return static_cast<size_t>(received);
+        }
+        if (interrupted()) continue;
+        if (wouldBlock()) return std::nullopt;
+        throw std::runtime_error("Receive failed: " + lastError());
+    }
+}
+
+std::optional<size_t> Socket::tryPeek(void* buffer, size_t size) {
+    if (tls_) {
+        return tls_->peek(buffer, size);
+    }
+    while (true) {
+        auto received = ::recv(handle_, static_cast<char*>(buffer), 
+                              static_cast<int>(size), MSG_PEEK);
+        if (received >= 0) {
+            return static_cast<size_t>(received);
+        }
+        if (interrupted()) continue;
+        if (wouldBlock()) return std::nullopt;
+        throw std::runtime_error("Receive failed: " + lastError());
+    }
+}
+
+std::optional<size_t> Socket::trySend(const void* data, size_t size) {
+    if (userSpaceTls()) {
+        return tls_->write(data, size);
+    }
+    while (true) {
+        auto sent = ::send(handle_, static_cast<const char*>(data), 
+                           static_cast<int>(size), SEND_FLAGS);
+        if (sent >= 0) {
+            return static_cast<size_t>(sent);
+        }
+        if (interrupted()) continue;
+        if (wouldBlock()) return std::nullopt;
+        throw std::runtime_error("Send failed: " + lastError());
+    }
+}
+
+std::optional<size_t> Socket::trySendv(std::span<const std::string_view> buffers) {
+    if (userSpaceTls()) {
+        return tls_->writev(buffers);
+    }
+    
+    size_t count = std::min(buffers.size(), MAX_IOV);
+
+#ifdef _WIN32
+    std::array<WSABUF, MAX_IOV> bufs;
+    for (size_t i = 0; i < count; ++i) {
+        bufs[i].buf = const_cast<char*>(buffers[i].data());
+        bufs[i].len = static_cast<ULONG>(buffers[i].size());
+    }
+    
+    while (true) {
+        DWORD sent = 0;
+        if (::WSASend(handle_, bufs.data(), static_cast<DWORD>(count), &sent, 0, nullptr, nullptr) == 0) {
+            return static_cast<size_t>(sent);
+        }
+        if (interrupted()) continue;
+        if (wouldBlock()) return std::nullopt;
+        throw std::runtime_error("Send failed: " + lastError());
+    }
+#else
+    std::array<iovec, MAX_IOV> iov;
+    for (size_t i = 0; i < count; ++i) {
+        iov[i].iov_base = const_cast<char*>(buffers[i].data());
+        iov[i].iov_len = buffers[i].size();
+    }
+    
+    // sendmsg rather than writev so SEND_FLAGS (MSG_NOSIGNAL) applies
+    msghdr msg{};
+    msg.msg_iov = iov.data();
+    msg.msg_iovlen = count;
+    
+    while (true) {
+        auto sent = ::sendmsg(handle_, &msg, SEND_FLAGS);
+        if (sent >= 0) {
+            return static_cast<size_t>(sent);
+        }
+        if (interrupted()) continue;
+        if (wouldBlock()) return std::nullopt;
+        throw std::runtime_error("Send failed: " + lastError());
+    }
+#endif
+}
+
+std::optional<size_t> Socket::trySendFile(native_file_t file, uint64_t offset, size_t count) {
+    // Per-call cap keeps the int/DWORD-sized kernel interfaces happy
+    count = std::min<size_t>(count, 0x7FFF0000);
+    
+    if (userSpaceTls()) {
+        // The bytes have to pass through OpenSSL: one record per call, so
+        // a retry re-reads exactly what the pending record was built from
+        static thread_local std::array<char, 16 * 1024> record;
+        size_t n = readAt(file, record.data(), std::min(count, record.size()), offset);
+        return n == 0 ? 0 : tls_->write(record.data(), n);
+    }
+
+#ifdef _WIN32
+    LARGE_INTEGER position;
+    position.QuadPart = static_cast<LONGLONG>(offset);
+    if (!::SetFilePointerEx(file, position, nullptr, FILE_BEGIN)) {
+        throw std::runtime_error("TransmitFile seek failed: " + std::to_string(::GetLastError()));
+    }
+    if (::TransmitFile(handle_, file, static_cast<DWORD>(count), 0, nullptr, nullptr, 0)) {
+        return count;
+    }
+    if (wouldBlock()) return std::nullopt;
+    throw std::runtime_error("TransmitFile failed: " + lastError());
+#elif defined(__linux__)
+    while (true) {
+        off_t position = static_cast<off_t>(offset);
+        auto sent = ::sendfile(handle_, file, &position, count);
+        if (sent >= 0) {
+            return static_cast<size_t>(sent);
+        }
+        if (interrupted()) continue;
+        if (wouldBlock()) return std::nullopt;
+        throw std::runtime_error("sendfile failed: " + lastError());
+    }
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+    while (true) {
+    #if defined(__APPLE__)
+        off_t sent = static_cast<off_t>(count);
+        int rc = ::sendfile(file, handle_, static_cast<off_t>(offset), &sent, nullptr, 0);
+    #else
+        off_t sent = 0;
+        int rc = ::sendfile(file, handle_, static_cast<off_t>(offset), count, nullptr, &sent, 0);
+    #endif
+        // EAGAIN/EINTR may still report a partial transfer
+        if (rc == 0 || sent > 0) {
+            return static_cast<size_t>(sent);
+        }
+        if (interrupted()) continue;
+        if (wouldBlock()) return std::nullopt;
+        throw std::runtime_error("sendfile failed: " + lastError());
+    }
+#else
+    // No sendfile: bounce through a per-thread buffer
+    static thread_local std::array<char, 64 * 1024> bounce;
+    size_t n = readAt(file, bounce.data(), std::min(count, bounce.size()), offset);
+    return trySend(bounce.data(), n);
+#endif
+}
+
+void Socket::sendFile(native_file_t file, uint64_t offset, uint64_t length) {
+    while (length > 0) {
+        auto sent = trySendFile(file, offset, static_cast<size_t>(std::min<uint64_t>(length, SIZE_MAX)));
+        if (!sent) {
+            waitWritable();
+            continue;
+        }
+        if (*sent == 0) {
+            throw std::runtime_error("sendfile: file shorter than expected");
+        }
+        offset += *sent;
+        length -= *sent;
+    }
+}
+
+bool Socket::waitReadable(int timeout_ms) {
+    // Bytes already decrypted never show up in poll()
+    if (tls_ && tls_->pending()) {
+        return true;
+    }
+#ifdef _WIN32
+    return pollHandle(handle_, POLLRDNORM, timeout_ms);
+#else
+    return pollHandle(handle_, POLLIN, timeout_ms);
+#endif
+}
+
+bool Socket::waitWritable(int timeout_ms) {
+#ifdef _WIN32
+    return pollHandle(handle_, POLLWRNORM, timeout_ms);
+#else
+    return pollHandle(handle_, POLLOUT, timeout_ms);
+#endif
+}
+
+void Socket::startTls(const TlsContext& context) {
+    tls_ = std::make_unique<TlsStream>(context, static_cast<int>(handle_));
+}
+
+TlsWant Socket::tryHandshake() {
+    return tls_ ? tls_->handshake() : TlsWant::None;
+}
+
+void Socket::handshake(int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    
+    while (true) {
+        auto want = tryHandshake();
+        if (want == TlsWant::None) {
+            return;
+        }
+        
+        int remaining = -1;
+        if (timeout_ms >= 0) {
+            auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            remaining = static_cast<int>(std::max<int64_t>(left.count(), 0));
+        }
+        bool ready = want == TlsWant::Read ? waitReadable(remaining) : waitWritable(remaining);
+        if (!ready) {
+            throw std::runtime_error("TLS handshake timed out");
+        }
+    }
+}
+
+coro::Task<size_t> Socket::asyncReceive(IoService& io, void* buffer, size_t size, int timeout_ms) {
+    while (true) {
+        if (auto received = tryReceive(buffer, size)) {
+            co_return *received;
+        }
+        if (!co_await io.readable(*this, timeout_ms)) {
+            throw std::runtime_error("Receive timed out");
+        }
+    }
+}
+
+coro::Task<void> Socket::asyncSend(IoService& io, std::string_view data, int timeout_ms) {
+    while (!data.empty()) {
+        auto sent = trySend(data.data(), data.size());
+        if (!sent) {
+            if (!co_await io.writable(*this, timeout_ms)) {
+                throw std::runtime_error("Send timed out");
+            }
+            continue;
+        }
+        data.remove_prefix(*sent);
+    }
+}
+
+coro::Task<void> Socket::asyncConnect(IoService& io, SockAddr addr, int timeout_ms) {
+    setNonBlocking(true);
+    
+    auto native_addr = addr.native();
+    if (::connect(handle_, reinterpret_cast<const sockaddr*>(&native_addr), 
+                  sizeof(native_addr)) == 0) {
+        co_return;
+    }
+#ifdef _WIN32
+    if (WSAGetLastError() != WSAEWOULDBLOCK) {
+#else
+    if (errno != EINPROGRESS) {
+#endif
+        throw std::runtime_error("Connect to " + addr.toString() + " failed: " + lastError());
+    }
+    
+    if (!co_await io.writable(*this, timeout_ms)) {
+        throw std::runtime_error("Connect to " + addr.toString() + " timed out");
+    }
+    
+    int error = 0;
+    socklen_t length = sizeof(error);
+    ::getsockopt(handle_, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &length);
+    if (error != 0) {
+#ifdef _WIN32
+        throw std::runtime_error("Connect to " + addr.toString() + 
+                               " failed. Error: " + std::to_string(error));
+#else
+        throw std::runtime_error("Connect to " + addr.toString() + 
+                               " failed: " + std::string(strerror(error)));
+#endif
+    }
+}
+
 void Socket::close() {
+    if (tls_) {
+        // Best-effort close_notify: tells the client the response was not cut short
+        tls_->shutdown();
+        tls_.reset();
+    }
     if (handle_ != invalid_handle) {
 #ifdef _WIN32
         ::closesocket(handle_);
@@ -0,0 +1,321 @@
+/**
+ * @file net/tls.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief TLS termination (OpenSSL) with kernel TLS offload
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "net/tls.hpp"
+#include <stdexcept>
+
+#ifdef FRQS_HAVE_OPENSSL
+    #include <openssl/err.h>
+    #include <openssl/ssl.h>
+    #include <cerrno>
+    #include <cstring>
+#endif
+
+namespace frqs::net {
+
+#ifdef FRQS_HAVE_OPENSSL
+
+namespace {
+
+constexpr size_t MAX_RECORD = 16 * 1024 ;   // Largest TLS record payload
+
+// Appends the oldest queued OpenSSL error, then empties the queue (every
+// SSL_* call must start with an empty queue for SSL_get_error to hold)
+std::string sslError(std::string_view what) {
+    std::string message(what) ;
+    if (unsigned long code = ERR_get_error() ; code != 0) {
+        char text[256] ;
+        ERR_error_string_n(code, text, sizeof(text)) ;
+        message += ": " ;
+        message += text ;
+    }
+    ERR_clear_error() ;
+    return message ;
+}
+
+// Before each SSL_* call: SSL_get_error reads both the queue and errno
+void clearErrors() noexcept {
+    ERR_clear_error() ;
+    errno = 0 ;
+}
+
+// Result of a failed SSL_read_ex/SSL_write_ex: nullopt to retry later,
+// 0 once the peer closed
+std::optional<size_t> ioFailure(ssl_st* ssl, std::string_view what) {
+    switch (SSL_get_error(ssl, 0)) {
+    case SSL_ERROR_WANT_READ:
+    case SSL_ERROR_WANT_WRITE:
+        return std::nullopt ;
+    case SSL_ERROR_ZERO_RETURN:
+        return 0 ;
+    case SSL_ERROR_SYSCALL: {
+        int error = errno ;
+        ERR_clear_error() ;
+        if (error == 0) {
+            return 0 ;  // EOF without close_notify
+        }
+        throw std::runtime_error(std::string(what) + ": " + strerror(error)) ;
+    }
+    default:
+        throw std::runtime_error(sslError(what)) ;
+    }
+}
+
+// Picks our most preferred protocol the client offers (`arg` is the
+// context's wire-format list, which outlives every connection)
+int selectAlpn(SSL*, const unsigned char** out, unsigned char* out_length,
+               const unsigned char* offered, unsigned int offered_length, void* arg) {
+    const auto* ours = static_cast<const std::string*>(arg) ;
+    unsigned char* selected = nullptr ;
+    unsigned char selected_length = 0 ;
+    if (SSL_select_next_proto(&selected, &selected_length,
+                              reinterpret_cast<const unsigned char*>(ours->data()),
+                              static_cast<unsigned int>(ours->size()),
+                              offered, offered_length) != OPENSSL_NPN_NEGOTIATED) {
+        return SSL_TLSEXT_ERR_NOACK ;
+    }
+    *out = selected ;
+    *out_length = selected_length ;
+    return SSL_TLSEXT_ERR_OK ;
+}
+
+} // namespace
+
+std::shared_ptr<TlsContext> TlsContext::create(const TlsOptions& options) {
+    SSL_CTX* ctx = SSL_CTX_new(TLS_server_method()) ;
+    if (!ctx) {
+        throw std::runtime_error(sslError("SSL_CTX_new failed")) ;
+    }
+    std::shared_ptr<TlsContext> context(new TlsContext(ctx)) ;
+
+    SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION) ;
+
+    // Partial writes, retried from wherever the caller keeps the bytes,
+    // give TLS the semantics of a plain non-blocking send(); idle
+    // keep-alive connections hand their record buffers back
+    SSL_CTX_set_mode(ctx, SSL_MODE_ENABLE_PARTIAL_WRITE |
+                          SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER |
+                          SSL_MODE_RELEASE_BUFFERS) ;
+
+    // Clients that just drop the connection read as a close, not an error
+    SSL_CTX_set_options(ctx, SSL_OP_IGNORE_UNEXPECTED_EOF | SSL_OP_NO_RENEGOTIATION) ;
+
+    if (SSL_CTX_use_certificate_chain_file(ctx, options.certificate_file.c_str()) != 1) {
+        throw std::runtime_error(sslError("Cannot load TLS certificate " + options.certificate_file)) ;
+    }
+    if (SSL_CTX_use_PrivateKey_file(ctx, options.private_key_file.c_str(), SSL_FILETYPE_PEM) != 1) {
+        throw std::runtime_error(sslError("Cannot load TLS private key " + options.private_key_file)) ;
+    }
+    if (SSL_CTX_check_private_key(ctx) != 1) {
+        throw std::runtime_error(sslError("TLS private key does not match the certificate")) ;
+    }
+
+    // Session resumption: stateless tickets (TLS 1.3, and 1.2 clients
+    // that support them) and the session id cache for the rest
+    static constexpr unsigned char session_id_context[] = "frqs" ;
+    SSL_CTX_set_session_id_context(ctx, session_id_context, sizeof(session_id_context) - 1) ;
+    if (options.session_cache_size > 0) {
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER) ;
+        SSL_CTX_sess_set_cache_size(ctx, static_cast<long>(options.session_cache_size)) ;
+    } else {
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF) ;
+    }
+    SSL_CTX_set_num_tickets(ctx, options.session_tickets) ;
+    if (options.session_tickets == 0) {
+        SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET) ;
+    }
+
+    for (const auto& protocol : options.alpn) {
+        if (protocol.empty() || protocol.size() > 255) {
+            throw std::runtime_error("Invalid ALPN protocol name: '" + protocol + "'") ;
+        }
+        context->alpn_.push_back(static_cast<char>(protocol.size())) ;
+        context->alpn_ += protocol ;
+    }
+    if (!context->alpn_.empty()) {
+        SSL_CTX_set_alpn_select_cb(ctx, selectAlpn, &context->alpn_) ;
+    }
+
+#ifdef SSL_OP_ENABLE_KTLS
+    // OpenSSL switches the socket to kTLS when the negotiated cipher and
+    // the kernel allow it, and keeps doing the crypto itself otherwise
+    if (options.kernel_offload) {
+        SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS) ;
+    }
+#endif
+
+    return context ;
+}
+
+bool TlsContext::available() noexcept {
+    return true ;
+}
+
+TlsContext::~TlsContext() {
+    SSL_CTX_free(ctx_) ;
+}
+
+TlsStream::TlsStream(const TlsContext& context, int fd)
+    : ssl_(SSL_new(context.native_handle())) {
+    if (!ssl_) {
+        throw std::runtime_error(sslError("SSL_new failed")) ;
+    }
+    if (SSL_set_fd(ssl_, fd) != 1) {
+        SSL_free(ssl_) ;
+        throw std::runtime_error(sslError("SSL_set_fd failed")) ;
+    }
+    SSL_set_accept_state(ssl_) ;
+}
+
+TlsStream::~TlsStream() {
+    SSL_free(ssl_) ;
+}
+
+TlsWant TlsStream::handshake() {
+    if (established_) {
+        return TlsWant::None ;
+    }
+
+    clearErrors() ;
+    int rc = SSL_do_handshake(ssl_) ;
+    if (rc == 1) {
+        established_ = true ;
+        kernel_send_ = BIO_get_ktls_send(SSL_get_wbio(ssl_)) != 0 ;
+        kernel_receive_ = BIO_get_ktls_recv(SSL_get_rbio(ssl_)) != 0 ;
+        return TlsWant::None ;
+    }
+
+    switch (SSL_get_error(ssl_, rc)) {
+    case SSL_ERROR_WANT_READ:
+        return TlsWant::Read ;
+    case SSL_ERROR_WANT_WRITE:
+        return TlsWant::Write ;
+    case SSL_ERROR_SYSCALL: {
+        std::string reason = errno != 0 ? strerror(errno) : "connection closed" ;
+        ERR_clear_error() ;
+        throw std::runtime_error("TLS handshake failed: " + reason) ;
+    }
+    default:
+        throw std::runtime_error(sslError("TLS handshake failed")) ;
+    }
+}
+
+std::optional<size_t> TlsStream::read(void* buffer, size_t size) {
+    clearErrors() ;
+    size_t n = 0 ;
+    if (SSL_read_ex(ssl_, buffer, size, &n) == 1) {
+        return n ;
+    }
+    return ioFailure(ssl_, "TLS receive failed") ;
+}
+
+std::optional<size_t> TlsStream::peek(void* buffer, size_t size) {
+    clearErrors() ;
+    size_t n = 0 ;
+    if (SSL_peek_ex(ssl_, buffer, size, &n) == 1) {
+        return n ;
+    }
+    return ioFailure(ssl_, "TLS receive failed") ;
+}
+
+std::optional<size_t> TlsStream::write(const void* data, size_t size) {
+    if (size == 0) {
+        return 0 ;
+    }
+    clearErrors() ;
+    size_t n = 0 ;
+    if (SSL_write_ex(ssl_, data, size, &n) == 1) {
+        return n ;
+    }
+    auto result = ioFailure(ssl_, "TLS send failed") ;
+    if (result && *result == 0) {
+        throw std::runtime_error("TLS send failed: connection closed") ;
+    }
+    return result ;
+}
+
+std::optional<size_t> TlsStream::writev(std::span<const std::string_view> buffers) {
+    if (buffers.empty()) {
+        return 0 ;
+    }
+    if (buffers.size() == 1 || buffers.front().size() >= MAX_RECORD) {
+        return write(buffers.front().data(), buffers.front().size()) ;
+    }
+
+    // Gather up to one record. A retry after a wait gets the same buffers
+    // back, so it rebuilds the same bytes, as SSL_write requires.
+    static thread_local std::string record ;
+    record.clear() ;
+    for (auto buffer : buffers) {
+        size_t room = MAX_RECORD - record.size() ;
+        record.append(buffer.substr(0, room)) ;
+        if (buffer.size() >= room) {
+            break ;
+        }
+    }
+    return write(record.data(), record.size()) ;
+}
+
+bool TlsStream::pending() const noexcept {
+    return SSL_has_pending(ssl_) == 1 ;
+}
+
+bool TlsStream::resumed() const noexcept {
+    return SSL_session_reused(ssl_) == 1 ;
+}
+
+std::string_view TlsStream::alpn() const noexcept {
+    const unsigned char* protocol = nullptr ;
+    unsigned int length = 0 ;
+    SSL_get0_alpn_selected(ssl_, &protocol, &length) ;
+    return {reinterpret_cast<const char*>(protocol), length} ;
+}
+
+void TlsStream::shutdown() noexcept {
+    if (established_) {
+        ERR_clear_error() ;
+        SSL_shutdown(ssl_) ;
+        ERR_clear_error() ;
+    }
+}
+
+#else // !FRQS_HAVE_OPENSSL
+
+std::shared_ptr<TlsContext> TlsContext::create(const TlsOptions&) {
+    throw std::runtime_error("TLS unavailable: built without OpenSSL (FRQS_WITH_OPENSSL)") ;
+}
+
+bool TlsContext::available() noexcept {
+    return false ;
+}
+
+TlsContext::~TlsContext() = default ;
+
+// No TlsContext can exist, so neither can a stream
+TlsStream::TlsStream(const TlsContext&, int) {
+    throw std::runtime_error("TLS unavailable: built without OpenSSL (FRQS_WITH_OPENSSL)") ;
+}
+
+TlsStream::~TlsStream() = default ;
+
+TlsWant TlsStream::handshake() { return TlsWant::None ; }
+std::optional<size_t> TlsStream::read(void*, size_t) { return 0 ; }
+std::optional<size_t> TlsStream::peek(void*, size_t) { return 0 ; }
+std::optional<size_t> TlsStream::write(const void*, size_t size) { return size ; }
+std::optional<size_t> TlsStream::writev(std::span<const std::string_view>) { return 0 ; }
+bool TlsStream::pending() const noexcept { return false ; }
+bool TlsStream::resumed() const noexcept { return false ; }
+std::string_view TlsStream::alpn() const noexcept { return {} ; }
+void TlsStream::shutdown() noexcept {}
+
+#endif // FRQS_HAVE_OPENSSL
+
+} // namespace frqs::net
@@ -0,0 +1,425 @@
+/**
+ * @file net/uring_poller.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief io_uring readiness engine behind EventLoop (Linux)
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "net/uring_poller.hpp"
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <errno.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if __has_include(<linux/io_uring.h>)
+    #include <linux/io_uring.h>
+#endif
+
+// Everything the engine relies on first shipped in Linux 6.1
+#if defined(IORING_SETUP_DEFER_TASKRUN) && defined(IORING_ENTER_EXT_ARG) && defined(__NR_io_uring_setup)
+    #define FRQS_HAVE_IO_URING 1
+#endif
+
+namespace frqs::net {
+
+#if defined(FRQS_HAVE_IO_URING)
+
+namespace {
+
+constexpr unsigned SQ_ENTRIES = 1024 ;
+constexpr unsigned CQ_ENTRIES = 8 * SQ_ENTRIES ;   // Overflow beyond this is kept (IORING_FEAT_NODROP)
+
+// user_data of internal requests: generation 0, never used by a registration
+constexpr uint64_t REMOVE_TAG = 1 ;
+constexpr uint64_t WAKEUP_TAG = 2 ;
+
+uint64_t userData(int handle, uint32_t generation) noexcept {
+    return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(handle) ;
+}
+
+uint32_t toPoll(uint32_t events) noexcept {
+    uint32_t mask = POLLRDHUP ;
+    if (events & IoEvent::Read) mask |= POLLIN ;
+    if (events & IoEvent::Write) mask |= POLLOUT ;
+    return mask ;
+}
+
+uint32_t fromPoll(uint32_t mask) noexcept {
+    uint32_t events = IoEvent::None ;
+    if (mask & POLLIN) events |= IoEvent::Read ;
+    if (mask & POLLOUT) events |= IoEvent::Write ;
+    if (mask & (POLLERR | POLLHUP | POLLRDHUP | POLLNVAL)) events |= IoEvent::Closed ;
+    return events ;
+}
+
+int ioUringSetup(unsigned entries, io_uring_params* params) noexcept {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params)) ;
+}
+
+int ioUringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+                 const void* arg, size_t arg_size) noexcept {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size)) ;
+}
+
+int ioUringRegister(int fd, unsigned opcode, const void* arg, unsigned count) noexcept {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, count)) ;
+}
+
+template<typename T>
+T* at(void* base, uint32_t offset) noexcept {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset) ;
+}
+
+// Ring indices are shared with the kernel
+unsigned loadAcquire(unsigned* p) noexcept {
+    return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire) ;
+}
+
+void storeRelease(unsigned* p, unsigned value) noexcept {
+    std::atomic_ref<unsigned>(*p).store(value, std::memory_order_release) ;
+}
+
+} // namespace
+
+std::unique_ptr<UringPoller> UringPoller::create() {
+    std::unique_ptr<UringPoller> poller(new UringPoller()) ;
+    if (!poller->setup(SQ_ENTRIES)) {
+        return nullptr ;
+    }
+    return poller ;
+}
+
+bool UringPoller::setup(unsigned entries) {
+    io_uring_params params{} ;
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP | IORING_SETUP_SUBMIT_ALL |
+                   IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN | IORING_SETUP_R_DISABLED ;
+    params.cq_entries = CQ_ENTRIES ;
+
+    ring_fd_ = ioUringSetup(entries, &params) ;
+    if (ring_fd_ < 0) {
+        return false ;  // ENOSYS, EPERM (disabled / seccomp), EINVAL (kernel older than 6.1)
+    }
+
+    constexpr uint32_t required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG ;
+    if ((params.features & required) != required) {
+        return false ;
+    }
+
+    sq_map_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned) ;
+    cq_map_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe) ;
+    sq_map_size_ = cq_map_size_ = std::max(sq_map_size_, cq_map_size_) ;    // One mapping serves both
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe) ;
+
+    sq_map_ = ::mmap(nullptr, sq_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     ring_fd_, IORING_OFF_SQ_RING) ;
+    if (sq_map_ == MAP_FAILED) {
+        sq_map_ = nullptr ;
+        return false ;
+    }
+    cq_map_ = sq_map_ ;
+    sqes_ = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   ring_fd_, IORING_OFF_SQES) ;
+    if (sqes_ == MAP_FAILED) {
+        sqes_ = nullptr ;
+        return false ;
+    }
+
+    sq_head_ = at<unsigned>(sq_map_, params.sq_off.head) ;
+    sq_tail_ = at<unsigned>(sq_map_, params.sq_off.tail) ;
+    sq_mask_ = *at<unsigned>(sq_map_, params.sq_off.ring_mask) ;
+    sq_entries_ = *at<unsigned>(sq_map_, params.sq_off.ring_entries) ;
+    cq_head_ = at<unsigned>(cq_map_, params.cq_off.head) ;
+    cq_tail_ = at<unsigned>(cq_map_, params.cq_off.tail) ;
+    cq_mask_ = *at<unsigned>(cq_map_, params.cq_off.ring_mask) ;
+    cqes_ = at<io_uring_cqe>(cq_map_, params.cq_off.cqes) ;
+
+    // SQE i always sits in slot i
+    auto* array = at<unsigned>(sq_map_, params.sq_off.array) ;
+    for (unsigned i = 0 ; i < sq_entries_ ; ++i) {
+        array[i] = i ;
+    }
+
+    wakeup_fd_ = ::eventfd(0, EFD_CLOEXEC) ;
+    return wakeup_fd_ >= 0 ;
+}
+
+UringPoller::~UringPoller() {
+    if (sqes_) ::munmap(sqes_, sqes_size_) ;
+    if (sq_map_) ::munmap(sq_map_, sq_map_size_) ;
+    if (ring_fd_ >= 0) ::close(ring_fd_) ;    // Cancels whatever is still in flight
+    if (wakeup_fd_ >= 0) ::close(wakeup_fd_) ;
+}
+
+// ============================================================================
+// Registration (any thread)
+// ============================================================================
+
+void UringPoller::add(native_handle_t handle, uint32_t events, void* data, bool oneshot) {
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    auto [it, inserted] = registry_.try_emplace(handle, Registration{data, events, 0, oneshot, false}) ;
+    if (!inserted) {
+        throw std::runtime_error("io_uring add: handle " + std::to_string(handle) + " already registered") ;
+    }
+    queueAdd(handle, it->second) ;
+    notifyLoop() ;
+}
+
+void UringPoller::rearm(native_handle_t handle, uint32_t events, void* data) {
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    auto it = registry_.find(handle) ;
+    if (it == registry_.end()) {
+        throw std::runtime_error("io_uring rearm: handle " + std::to_string(handle) + " is not registered") ;
+    }
+    auto& registration = it->second ;
+    if (registration.armed) {
+        queueRemove(handle, registration) ;  // Replaced, as EPOLL_CTL_MOD would
+    }
+    registration.data = data ;
+    registration.events = events ;
+    registration.oneshot = true ;
+    queueAdd(handle, registration) ;
+    notifyLoop() ;
+}
+
+void UringPoller::remove(native_handle_t handle) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    auto it = registry_.find(handle) ;
+    if (it == registry_.end()) {
+        return ;
+    }
+    // The poll request holds a reference to the socket: a close() right
+    // after this only takes effect once the removal is submitted
+    if (it->second.armed) {
+        queueRemove(handle, it->second) ;
+        notifyLoop() ;
+    }
+    registry_.erase(it) ;
+}
+
+void UringPoller::queueAdd(native_handle_t handle, Registration& registration) {
+    registration.generation = next_generation_++ ;
+    if (next_generation_ == 0) {
+        next_generation_ = 1 ;  // 0 tags internal requests
+    }
+    registration.armed = true ;
+    changes_.push_back({true, handle, toPoll(registration.events), !registration.oneshot,
+                        userData(handle, registration.generation)}) ;
+}
+
+void UringPoller::queueRemove(native_handle_t handle, const Registration& registration) {
+    changes_.push_back({false, handle, 0, false, userData(handle, registration.generation)}) ;
+}
+
+void UringPoller::notifyLoop() noexcept {
+    // Only a blocked loop needs waking, and only once per wait
+    if (waiting_ && loop_thread_.load(std::memory_order_relaxed) != std::this_thread::get_id()) {
+        waiting_ = false ;
+        wakeup() ;
+    }
+}
+
+void UringPoller::wakeup() noexcept {
+    uint64_t one = 1 ;
+    [[maybe_unused]] auto r = ::write(wakeup_fd_, &one, sizeof(one)) ;
+}
+
+// ============================================================================
+// Loop thread
+// ============================================================================
+
+size_t UringPoller::wait(std::span<ReadyEvent> out, int timeout_ms) {
+    if (!enabled_) {
+        // The thread that enables the ring becomes its only submitter
+        if (ioUringRegister(ring_fd_, IORING_REGISTER_ENABLE_RINGS, nullptr, 0) < 0) {
+            throw std::runtime_error("io_uring enable failed: " + std::string(strerror(errno))) ;
+        }
+        enabled_ = true ;
+        loop_thread_.store(std::this_thread::get_id(), std::memory_order_relaxed) ;
+    }
+    if (!wakeup_armed_) {
+        queueWakeupRead() ;
+    }
+
+    bool ready = loadAcquire(cq_tail_) != *cq_head_ ;
+    {
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        writing_.swap(changes_) ;
+        waiting_ = !ready && timeout_ms != 0 ;
+    }
+    bool written = writeChanges(writing_) ;
+
+    // Completions already queued need no wait; submit only if there is
+    // anything to. Changes left over return at once, to be written once
+    // reap() has made room.
+    if (!ready || unsubmitted_ > 0) {
+        submit(ready || !written ? 0 : 1, timeout_ms) ;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        waiting_ = false ;
+    }
+    return reap(out) ;
+}
+
+bool UringPoller::writeChanges(std::vector<Change>& changes) {
+    size_t written = 0 ;
+    for (; written < changes.size() ; ++written) {
+        const auto& change = changes[written] ;
+        auto* sqe = static_cast<io_uring_sqe*>(nextSqe()) ;
+        if (!sqe) {
+            break ;
+        }
+        if (change.add) {
+            sqe->opcode = IORING_OP_POLL_ADD ;
+            sqe->fd = change.handle ;
+            sqe->poll32_events = change.events ;
+            sqe->len = change.multishot ? IORING_POLL_ADD_MULTI : 0 ;
+            sqe->user_data = change.user_data ;
+        } else {
+            sqe->opcode = IORING_OP_POLL_REMOVE ;
+            sqe->fd = -1 ;
+            sqe->addr = change.user_data ;
+            sqe->user_data = REMOVE_TAG ;
+        }
+    }
+
+    bool all = written == changes.size() ;
+    if (!all) {
+        // Ahead of the changes queued since, so the order holds
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        changes_.insert(changes_.begin(), changes.begin() + static_cast<ptrdiff_t>(written), changes.end()) ;
+    }
+    changes.clear() ;
+    return all ;
+}
+
+void UringPoller::queueWakeupRead() {
+    auto* sqe = static_cast<io_uring_sqe*>(nextSqe()) ;
+    if (!sqe) {
+        return ;  // Armed by a later wait()
+    }
+    sqe->opcode = IORING_OP_READ ;
+    sqe->fd = wakeup_fd_ ;
+    sqe->addr = reinterpret_cast<uint64_t>(&wakeup_value_) ;
+    sqe->len = sizeof(wakeup_value_) ;
+    sqe->off = static_cast<uint64_t>(-1) ;    // Current position (eventfds have none)
+    sqe->user_data = WAKEUP_TAG ;
+    wakeup_armed_ = true ;
+}
+
+void* UringPoller::nextSqe() {
+    unsigned tail = *sq_tail_ ;
+    if (tail - loadAcquire(sq_head_) == sq_entries_) {
+        submit(0, 0) ;  // Full: hand the kernel what is there (it consumes SQEs at once)
+        if (tail - loadAcquire(sq_head_) == sq_entries_) {
+            return nullptr ;  // Refused until completions are reaped; the slot at tail is still unsubmitted
+        }
+    }
+    auto* sqe = static_cast<io_uring_sqe*>(sqes_) + (tail & sq_mask_) ;
+    std::memset(sqe, 0, sizeof(*sqe)) ;
+    storeRelease(sq_tail_, tail + 1) ;
+    ++unsubmitted_ ;
+    return sqe ;
+}
+
+void UringPoller::submit(unsigned min_complete, int timeout_ms) {
+    __kernel_timespec ts{} ;
+    io_uring_getevents_arg arg{} ;
+    arg.sigmask_sz = _NSIG / 8 ;
+    if (timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000 ;
+        ts.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1'000'000LL ;
+        arg.ts = reinterpret_cast<uint64_t>(&ts) ;
+    }
+
+    unsigned flags = IORING_ENTER_EXT_ARG ;
+    if (min_complete > 0) {
+        flags |= IORING_ENTER_GETEVENTS ;
+    }
+
+    int submitted = ioUringEnter(ring_fd_, unsubmitted_, min_complete, flags, &arg, sizeof(arg)) ;
+    if (submitted >= 0) {
+        unsubmitted_ -= std::min(unsubmitted_, static_cast<unsigned>(submitted)) ;
+        return ;
+    }
+    // ETIME: timed out; EINTR: signal; EBUSY/EAGAIN: completions to reap first
+    if (errno != ETIME && errno != EINTR && errno != EBUSY && errno != EAGAIN) {
+        throw std::runtime_error("io_uring_enter failed: " + std::string(strerror(errno))) ;
+    }
+}
+
+size_t UringPoller::reap(std::span<ReadyEvent> out) {
+    unsigned head = *cq_head_ ;
+    unsigned tail = loadAcquire(cq_tail_) ;
+    size_t count = 0 ;
+
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    while (head != tail && count < out.size()) {
+        const auto& cqe = static_cast<const io_uring_cqe*>(cqes_)[head & cq_mask_] ;
+        ++head ;
+
+        if (cqe.user_data == WAKEUP_TAG) {
+            wakeup_armed_ = false ;   // Re-armed by the next wait()
+            continue ;
+        }
+        if (cqe.user_data == REMOVE_TAG) {
+            continue ;
+        }
+
+        auto handle = static_cast<native_handle_t>(static_cast<uint32_t>(cqe.user_data)) ;
+        auto generation = static_cast<uint32_t>(cqe.user_data >> 32) ;
+        auto it = registry_.find(handle) ;
+        if (it == registry_.end() || it->second.generation != generation) {
+            continue ;  // Removed or re-armed since (includes the -ECANCELED of a removal)
+        }
+
+        auto& registration = it->second ;
+        bool more = (cqe.flags & IORING_CQE_F_MORE) != 0 ;
+        if (!more) {
+            registration.armed = false ;
+            if (!registration.oneshot && cqe.res >= 0) {
+                queueAdd(handle, registration) ;  // Multishot ended (e.g. overflow): resubmit
+            }
+        }
+        uint32_t events = cqe.res < 0 ? IoEvent::Closed : fromPoll(static_cast<uint32_t>(cqe.res)) ;
+        out[count++] = {registration.data, events} ;
+    }
+    storeRelease(cq_head_, head) ;
+    return count ;
+}
+
+#else // !FRQS_HAVE_IO_URING
+
+// Headers older than Linux 6.1: the engine is never available
+std::unique_ptr<UringPoller> UringPoller::create() {
+    return nullptr ;
+}
+
+UringPoller::~UringPoller() = default ;
+
+void UringPoller::add(native_handle_t, uint32_t, void*, bool) {}
+void UringPoller::rearm(native_handle_t, uint32_t, void*) {}
+void UringPoller::remove(native_handle_t) noexcept {}
+size_t UringPoller::wait(std::span<ReadyEvent>, int) { return 0 ; }
+void UringPoller::wakeup() noexcept {}
+
+#endif // FRQS_HAVE_IO_URING
+
+} // namespace frqs::net
+
+#endif // __linux__
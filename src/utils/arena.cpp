@@ -0,0 +1,106 @@
+/**
+ * @file utils/arena.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Monotonic per-request memory arena
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "utils/arena.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace frqs::utils {
+
+namespace {
+
+constexpr size_t CHUNK_ALIGN = alignof(std::max_align_t) ;
+
+char* alignUp(char* p, size_t alignment) noexcept {
+    auto address = reinterpret_cast<uintptr_t>(p) ;
+    auto aligned = (address + alignment - 1) & ~(uintptr_t(alignment) - 1) ;
+    return p + (aligned - address) ;
+}
+
+} // namespace
+
+Arena::Arena(std::pmr::memory_resource* upstream) noexcept
+    : upstream_(upstream), cursor_(inline_), end_(inline_ + INLINE_SIZE) {}
+
+Arena::~Arena() {
+    reset() ;
+    if (spare_) {
+        freeChunk(spare_) ;
+    }
+}
+
+void Arena::reset() noexcept {
+    // Keep the largest chunk that is not oversized (the spare included)
+    Chunk* keep = spare_ ;
+    for (Chunk* chunk = chunks_ ; chunk ;) {
+        Chunk* next = chunk->next ;
+        if (chunk->size <= MAX_RETAINED_SIZE && (!keep || chunk->size > keep->size)) {
+            std::swap(keep, chunk) ;
+        }
+        if (chunk) {
+            freeChunk(chunk) ;
+        }
+        chunk = next ;
+    }
+
+    chunks_ = nullptr ;
+    spare_ = keep ;
+    cursor_ = inline_ ;
+    end_ = inline_ + INLINE_SIZE ;
+    used_ = 0 ;
+}
+
+size_t Arena::capacity() const noexcept {
+    return static_cast<size_t>(end_ - cursor_) + (spare_ ? spare_->size : 0) ;
+}
+
+void* Arena::do_allocate(size_t bytes, size_t alignment) {
+    char* p = alignUp(cursor_, alignment) ;
+    if (bytes <= static_cast<size_t>(end_ - cursor_) && p <= end_ - bytes) {
+        used_ += static_cast<size_t>(p + bytes - cursor_) ;
+        cursor_ = p + bytes ;
+        return p ;
+    }
+    return allocateSlow(bytes, alignment) ;
+}
+
+void* Arena::allocateSlow(size_t bytes, size_t alignment) {
+    size_t needed = bytes + (alignment > CHUNK_ALIGN ? alignment : 0) ;
+
+    Chunk* chunk = nullptr ;
+    if (spare_ && spare_->size >= needed) {
+        chunk = std::exchange(spare_, nullptr) ;
+    } else {
+        // Double on each new chunk so a large request needs few of them
+        size_t doubled = chunks_ ? std::min(chunks_->size * 2, MAX_RETAINED_SIZE) : 0 ;
+        size_t size = std::max({MIN_CHUNK_SIZE, needed, doubled}) ;
+        void* memory = upstream_->allocate(sizeof(Chunk) + size, CHUNK_ALIGN) ;
+        chunk = ::new (memory) Chunk{nullptr, size} ;
+    }
+
+    chunk->next = chunks_ ;
+    chunks_ = chunk ;
+    cursor_ = reinterpret_cast<char*>(chunk + 1) ;
+    end_ = cursor_ + chunk->size ;
+
+    char* p = alignUp(cursor_, alignment) ;
+    used_ += static_cast<size_t>(p + bytes - cursor_) ;
+    cursor_ = p + bytes ;
+    return p ;
+}
+
+void Arena::freeChunk(Chunk* chunk) noexcept {
+    upstream_->deallocate(chunk, sizeof(Chunk) + chunk->size, CHUNK_ALIGN) ;
+}
+
+} // namespace frqs::utils
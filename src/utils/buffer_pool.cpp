@@ -0,0 +1,136 @@
+/**
+ * @file utils/buffer_pool.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Slab-allocated, reference-counted I/O buffers
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "utils/buffer_pool.hpp"
+#include <new>
+
+namespace frqs::utils {
+
+namespace {
+
+constexpr size_t BLOCK_STRIDE = sizeof(detail::BufferBlock) + BufferPool::BLOCK_SIZE ;
+constexpr std::align_val_t BLOCK_ALIGN{alignof(detail::BufferBlock)} ;
+
+// Free blocks a thread keeps before handing them to the shared list
+constexpr size_t LOCAL_CACHE_LIMIT = 32 ;
+
+} // namespace
+
+struct BufferPool::LocalCache {
+    std::vector<detail::BufferBlock*> blocks ;
+
+    ~LocalCache() {
+        BufferPool::instance().giveBack(blocks) ;
+    }
+} ;
+
+BufferPool::LocalCache& BufferPool::localCache() {
+    thread_local LocalCache cache ;
+    return cache ;
+}
+
+BufferPool& BufferPool::instance() {
+    // Never destroyed: buffers may be released from static destructors
+    static BufferPool* pool = new BufferPool() ;
+    return *pool ;
+}
+
+SharedBuffer BufferPool::acquire(size_t min_capacity) {
+    if (min_capacity > BLOCK_SIZE) {
+        // Round to pages so a growing buffer is not re-acquired per byte
+        size_t capacity = (min_capacity + 4095) & ~size_t(4095) ;
+        void* memory = ::operator new(sizeof(detail::BufferBlock) + capacity, BLOCK_ALIGN) ;
+        auto* block = ::new (memory) detail::BufferBlock() ;
+        block->capacity = capacity ;
+        heap_buffers_.fetch_add(1, std::memory_order_relaxed) ;
+        return SharedBuffer(block) ;
+    }
+
+    detail::BufferBlock* block = nullptr ;
+    auto& cache = localCache().blocks ;
+    if (!cache.empty()) {
+        block = cache.back() ;
+        cache.pop_back() ;
+    } else {
+        block = takeBlock() ;
+    }
+
+    block->refs.store(1, std::memory_order_relaxed) ;
+    return SharedBuffer(block) ;
+}
+
+BufferPool::Stats BufferPool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    return {slabs_.size(), free_.size(), heap_buffers_.load(std::memory_order_relaxed)} ;
+}
+
+void BufferPool::release(detail::BufferBlock* block) noexcept {
+    if (!block->pooled) {
+        block->~BufferBlock() ;
+        ::operator delete(static_cast<void*>(block), BLOCK_ALIGN) ;
+        heap_buffers_.fetch_sub(1, std::memory_order_relaxed) ;
+        return ;
+    }
+
+    auto& cache = localCache().blocks ;
+    if (cache.size() < LOCAL_CACHE_LIMIT) {
+        try {
+            cache.push_back(block) ;
+            return ;
+        } catch (...) {
+            // Fall through to the shared list
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    try {
+        free_.push_back(block) ;
+    } catch (...) {
+        // Capacity for every block is reserved when its slab is created
+    }
+}
+
+detail::BufferBlock* BufferPool::takeBlock() {
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    if (free_.empty()) {
+        allocateSlab() ;
+    }
+    auto* block = free_.back() ;
+    free_.pop_back() ;
+    return block ;
+}
+
+// Caller holds mutex_
+void BufferPool::allocateSlab() {
+    free_.reserve((slabs_.size() + 1) * BLOCKS_PER_SLAB) ;
+    slabs_.reserve(slabs_.size() + 1) ;
+
+    void* slab = ::operator new(BLOCK_STRIDE * BLOCKS_PER_SLAB, BLOCK_ALIGN) ;
+    slabs_.push_back(slab) ;
+
+    auto* base = static_cast<char*>(slab) ;
+    for (size_t i = BLOCKS_PER_SLAB ; i-- > 0 ;) {
+        auto* block = ::new (base + i * BLOCK_STRIDE) detail::BufferBlock() ;
+        block->pooled = true ;
+        block->capacity = BLOCK_SIZE ;
+        free_.push_back(block) ;
+    }
+}
+
+void BufferPool::giveBack(std::vector<detail::BufferBlock*>& blocks) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    for (auto* block : blocks) {
+        free_.push_back(block) ;    // Fits: capacity reserved per slab
+    }
+    blocks.clear() ;
+}
+
+} // namespace frqs::utils
@@ -0,0 +1,124 @@
+/**
+ * @file utils/byte_scan.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief SSE2 / AVX2 / NEON delimiter scanners with runtime dispatch
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "utils/byte_scan.hpp"
+#include "utils/cpu_dispatch.hpp"
+#include <bit>
+#include <cstdint>
+
+namespace frqs::utils {
+
+namespace {
+
+using ScanFn = size_t (*)(const char*, size_t, char, char, char) noexcept ;
+
+size_t scanScalar(const char* data, size_t size, char a, char b, char c) noexcept {
+    for (size_t i = 0 ; i < size ; ++i) {
+        char ch = data[i] ;
+        if (ch == a || ch == b || ch == c) {
+            return i ;
+        }
+    }
+    return size ;
+}
+
+#ifdef FRQS_SIMD_X86
+size_t scanSse2(const char* data, size_t size, char a, char b, char c) noexcept {
+    const __m128i va = _mm_set1_epi8(a) ;
+    const __m128i vb = _mm_set1_epi8(b) ;
+    const __m128i vc = _mm_set1_epi8(c) ;
+
+    size_t i = 0 ;
+    for (; i + 16 <= size ; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)) ;
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb)),
+                                    _mm_cmpeq_epi8(chunk, vc)) ;
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(hits)) ;
+        if (mask != 0) {
+            return i + static_cast<size_t>(std::countr_zero(mask)) ;
+        }
+    }
+    return i + scanScalar(data + i, size - i, a, b, c) ;
+}
+#endif
+
+#ifdef FRQS_SIMD_AVX2
+__attribute__((target("avx2")))
+size_t scanAvx2(const char* data, size_t size, char a, char b, char c) noexcept {
+    const __m256i va = _mm256_set1_epi8(a) ;
+    const __m256i vb = _mm256_set1_epi8(b) ;
+    const __m256i vc = _mm256_set1_epi8(c) ;
+
+    size_t i = 0 ;
+    for (; i + 32 <= size ; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)) ;
+        __m256i hits = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, va), _mm256_cmpeq_epi8(chunk, vb)),
+                                       _mm256_cmpeq_epi8(chunk, vc)) ;
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits)) ;
+        if (mask != 0) {
+            return i + static_cast<size_t>(std::countr_zero(mask)) ;
+        }
+    }
+    return i + scanSse2(data + i, size - i, a, b, c) ;
+}
+#endif
+
+#ifdef FRQS_SIMD_NEON
+size_t scanNeon(const char* data, size_t size, char a, char b, char c) noexcept {
+    const uint8x16_t va = vdupq_n_u8(static_cast<uint8_t>(a)) ;
+    const uint8x16_t vb = vdupq_n_u8(static_cast<uint8_t>(b)) ;
+    const uint8x16_t vc = vdupq_n_u8(static_cast<uint8_t>(c)) ;
+
+    size_t i = 0 ;
+    for (; i + 16 <= size ; i += 16) {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i)) ;
+        uint8x16_t hits = vorrq_u8(vorrq_u8(vceqq_u8(chunk, va), vceqq_u8(chunk, vb)), vceqq_u8(chunk, vc)) ;
+        // Narrow to 4 bits per byte: NEON has no movemask
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits), 4)), 0) ;
+        if (mask != 0) {
+            return i + static_cast<size_t>(std::countr_zero(mask) >> 2) ;
+        }
+    }
+    return i + scanScalar(data + i, size - i, a, b, c) ;
+}
+#endif
+
+const SimdKernel<ScanFn>& backend() noexcept {
+    static const SimdKernel<ScanFn> selected = selectKernel<ScanFn>({
+        .scalar = &scanScalar,
+#ifdef FRQS_SIMD_X86
+        .sse2 = &scanSse2,
+#endif
+#ifdef FRQS_SIMD_AVX2
+        .avx2 = &scanAvx2,
+#endif
+#ifdef FRQS_SIMD_NEON
+        .neon = &scanNeon,
+#endif
+    }) ;
+    return selected ;
+}
+
+} // namespace
+
+size_t findFirstOf(const char* data, size_t size, char a, char b, char c) noexcept {
+    // Too short to amortize a vector load
+    if (size < 16) {
+        return scanScalar(data, size, a, b, c) ;
+    }
+    return backend().fn(data, size, a, b, c) ;
+}
+
+std::string_view byteScanBackend() noexcept {
+    return backend().name ;
+}
+
+} // namespace frqs::utils
@@ -1,137 +1,375 @@
 /**
  * @file utils/config.cpp
  * @author zuudevs (zuudevs@gmail.com)
- * @brief 
- * @version 1.0.0
+ * @brief
+ * @version 1.1.0
  * @date 2025-12-09
- * 
+ *
  * @copyright Copyright (c) 2025
- * 
+ *
  */
 
 #include "utils/config.hpp"
+#include "utils/logger.hpp"
 #include <fstream>
 #include <algorithm>
 #include <cctype>
-#include <iostream>
+#include <charconv>
+#include <condition_variable>
+#include <format>
+#include <utility>
 
 namespace frqs::utils {
 
+namespace {
+
+std::optional<int> parseInt(std::string_view text) noexcept {
+    // Like std::stoi: a leading integer, trailing text ignored ("30s" is 30)
+    if (text.starts_with('+')) {
+        text.remove_prefix(1);
+    }
+    int value = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{}) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+bool parseBool(std::string_view text) noexcept {
+    auto is = [text](std::string_view word) {
+        return std::equal(text.begin(), text.end(), word.begin(), word.end(), [](char a, char b) {
+            return std::tolower(static_cast<unsigned char>(a)) == b;
+        });
+    };
+    return is("true") || is("1") || is("yes");
+}
+
+} // namespace
+
+// ========== SNAPSHOT ==========
+
+ConfigSnapshot::ConfigSnapshot(const std::unordered_map<std::string, std::string>& values, uint64_t version)
+    : version_(version) {
+    values_.reserve(values.size());
+    for (const auto& [key, text] : values) {
+        values_.emplace(key, Value{text, parseInt(text), parseBool(text)});
+    }
+}
+
+const ConfigSnapshot::Value* ConfigSnapshot::find(std::string_view key) const noexcept {
+    auto it = values_.find(key);
+    return it != values_.end() ? &it->second : nullptr;
+}
+
+std::optional<std::string_view> ConfigSnapshot::get(std::string_view key) const noexcept {
+    if (const auto* value = find(key)) {
+        return value->text;
+    }
+    return std::nullopt;
+}
+
+std::optional<int> ConfigSnapshot::getInt(std::string_view key) const noexcept {
+    const auto* value = find(key);
+    return value ? value->as_int : std::nullopt;
+}
+
+std::optional<bool> ConfigSnapshot::getBool(std::string_view key) const noexcept {
+    if (const auto* value = find(key)) {
+        return value->as_bool;
+    }
+    return std::nullopt;
+}
+
+bool ConfigSnapshot::differs(const ConfigSnapshot& other, std::string_view key) const noexcept {
+    const auto* mine = find(key);
+    const auto* theirs = other.find(key);
+    if (!mine || !theirs) {
+        return mine != theirs;
+    }
+    return mine->text != theirs->text;
+}
+
+// ========== CONFIG ==========
+
+Config::Config()
+    : snapshot_(std::make_shared<const ConfigSnapshot>())
+    , version_(0) {}
+
+Config::~Config() {
+    stopWatching();
+}
+
+const ConfigSnapshot& Config::current() const noexcept {
+    // Renewing the cached snapshot is a reference-count round trip, so it
+    // only happens after a reload moved the version
+    static thread_local std::shared_ptr<const ConfigSnapshot> cached;
+
+    uint64_t version = version_.load(std::memory_order_acquire);
+    if (!cached || cached->version() != version) {
+        cached = snapshot_.load();
+    }
+    return *cached;
+}
+
+std::optional<std::string> Config::get(std::string_view key) const {
+    if (auto value = current().get(key)) {
+        return std::string(*value);
+    }
+    return std::nullopt;
+}
+
+std::optional<int> Config::getInt(std::string_view key) const noexcept {
+    return current().getInt(key);
+}
+
+std::optional<bool> Config::getBool(std::string_view key) const noexcept {
+    return current().getBool(key);
+}
+
 bool Config::load(const std::filesystem::path& config_file) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    std::cout << "\n🔍 Attempting to load config from: " << config_file << std::endl;
-    std::cout << "   Absolute path: " << std::filesystem::absolute(config_file) << std::endl;
-    std::cout << "   File exists: " << (std::filesystem::exists(config_file) ? "YES" : "NO") << std::endl;
-    
-    std::ifstream file(config_file);
+    std::lock_guard<std::mutex> lock(reload_mutex_);
+
+    std::unordered_map<std::string, std::string> values;
+    std::string error;
+    if (!parseFile(config_file, values, &error)) {
+        logError(std::format("Config {}: {}", config_file.string(), error));
+        return false;
+    }
+
+    // Values loaded earlier stay unless the file sets them again
+    auto merged = file_values_;
+    for (auto& [key, value] : values) {
+        merged[key] = std::move(value);
+    }
+
+    if (!publish(std::move(merged), &error)) {
+        logError(std::format("Config {} rejected: {}", config_file.string(), error));
+        return false;
+    }
+    path_ = config_file;  // Reloads read the file only once it was accepted
+    return true;
+}
+
+bool Config::reload(std::string* error) {
+    std::lock_guard<std::mutex> lock(reload_mutex_);
+
+    std::string reason;
+    auto fail = [&](std::string why) {
+        if (error) {
+            *error = std::move(why);
+        }
+        return false;
+    };
+
+    if (path_.empty()) {
+        return fail("no config file loaded");
+    }
+
+    std::unordered_map<std::string, std::string> values;
+    if (!parseFile(path_, values, &reason)) {
+        return fail(std::move(reason));
+    }
+
+    // Most likely caught mid-write by an editor; finishing the write retries
+    if (values.empty() && !file_values_.empty()) {
+        return fail("file has no values");
+    }
+
+    if (!publish(std::move(values), &reason)) {
+        return fail(std::move(reason));
+    }
+    return true;
+}
+
+bool Config::publish(std::unordered_map<std::string, std::string> file_values, std::string* error) {
+    auto merged = file_values;
+    for (const auto& [key, value] : overrides_) {
+        merged[key] = value;
+    }
+
+    auto previous = snapshot_.load();
+    auto next = std::make_shared<const ConfigSnapshot>(merged, previous->version() + 1);
+
+    std::vector<Subscription> notify;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& validator : validators_) {
+            std::string reason;
+            if (!validator(*next, reason)) {
+                if (error) {
+                    *error = reason.empty() ? "validation failed" : std::move(reason);
+                }
+                return false;
+            }
+        }
+
+        for (const auto& subscription : subscribers_) {
+            bool changed = subscription.keys.empty()
+                ? true
+                : std::any_of(subscription.keys.begin(), subscription.keys.end(), [&](const auto& key) {
+                      return next->differs(*previous, key);
+                  });
+            if (changed) {
+                notify.push_back(subscription);
+            }
+        }
+    }
+
+    file_values_ = std::move(file_values);
+    snapshot_.store(next);
+    version_.store(next->version(), std::memory_order_release);
+
+    // The first load has nobody to tell yet: subscribers read their
+    // starting values themselves
+    if (previous->version() == 0) {
+        return true;
+    }
+    for (const auto& subscription : notify) {
+        try {
+            subscription.callback(*next);
+        } catch (const std::exception& e) {
+            logError(std::format("Config subscriber failed: {}", e.what()));
+        }
+    }
+    return true;
+}
+
+bool Config::parseFile(const std::filesystem::path& path,
+                       std::unordered_map<std::string, std::string>& values, std::string* error) {
+    std::ifstream file(path);
     if (!file) {
-        std::cerr << "❌ FAILED to open config file!" << std::endl;
+        if (error) {
+            *error = "cannot open file";
+        }
         return false;
     }
-    
-    std::cout << "✅ Config file opened successfully\n" << std::endl;
-    
+
     std::string line;
     int line_num = 0;
     while (std::getline(file, line)) {
         line_num++;
-        
-        // FIXED: Trim in-place before displaying
+
+        // Skip comments and empty lines
         std::string trimmed = trim(line);
-        
-        if (!trimmed.empty() && !trimmed.starts_with('#')) {
-            std::cout << "  Line " << line_num << ": [" << trimmed << "]" << std::endl;
+        if (trimmed.empty() || trimmed.starts_with('#')) {
+            continue;
         }
-        
-        // FIXED: Parse the trimmed string
-        parseLine(trimmed);
-    }
-    
-    // Print loaded values
-    std::cout << "\n📋 Loaded configuration values:" << std::endl;
-    std::cout << "   ┌─────────────────────────────────────┐" << std::endl;
-    for (const auto& [key, value] : values_) {
-        std::cout << "   │ " << key;
-        // Pad to 20 chars
-        for (size_t i = key.length(); i < 20; ++i) std::cout << " ";
-        std::cout << "= " << value << std::endl;
-    }
-    std::cout << "   └─────────────────────────────────────┘\n" << std::endl;
-    
-    return true;
-}
 
-void Config::parseLine(std::string_view line) {
-    // FIXED: Don't re-trim, line is already trimmed
-    // Skip comments and empty lines
-    if (line.empty() || line.starts_with('#')) {
-        return;
-    }
-    
-    // Find equals sign
-    auto eq_pos = line.find('=');
-    if (eq_pos == std::string_view::npos) {
-        return;
+        auto eq_pos = trimmed.find('=');
+        std::string key = eq_pos == std::string::npos ? std::string() : trim(std::string_view(trimmed).substr(0, eq_pos));
+        if (key.empty()) {
+            logWarn(std::format("Config {}:{}: ignored, not KEY=VALUE", path.string(), line_num));
+            continue;
+        }
+        values[std::move(key)] = trim(std::string_view(trimmed).substr(eq_pos + 1));
     }
-    
-    // FIXED: Create std::string for key and value to avoid dangling
-    std::string key = trim(line.substr(0, eq_pos));
-    std::string value = trim(line.substr(eq_pos + 1));
-    
-    if (!key.empty()) {
-        values_[key] = value;
+
+    if (file.bad()) {
+        if (error) {
+            *error = "read error";
+        }
+        return false;
     }
+    return true;
 }
 
 std::string Config::trim(std::string_view str) {
-    auto start = std::find_if_not(str.begin(), str.end(), 
+    auto start = std::find_if_not(str.begin(), str.end(),
         [](unsigned char ch) { return std::isspace(ch); });
-    
-    auto end = std::find_if_not(str.rbegin(), str.rend(), 
+
+    auto end = std::find_if_not(str.rbegin(), str.rend(),
         [](unsigned char ch) { return std::isspace(ch); }).base();
-    
+
     return (start < end) ? std::string(start, end) : std::string();
 }
 
-std::optional<std::string> Config::get(std::string_view key) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = values_.find(std::string(key));
-    if (it != values_.end()) {
-        return it->second;
+void Config::set(std::string_view key, std::string_view value) {
+    std::lock_guard<std::mutex> lock(reload_mutex_);
+    auto [it, added] = overrides_.try_emplace(std::string(key), value);
+    std::optional<std::string> previous;
+    if (!added) {
+        previous = std::exchange(it->second, std::string(value));
     }
-    return std::nullopt;
-}
 
-std::optional<int> Config::getInt(std::string_view key) const {
-    auto value = get(key);
-    if (!value) {
-        return std::nullopt;
-    }
-    
-    try {
-        return std::stoi(*value);
-    } catch (...) {
-        return std::nullopt;
+    std::string error;
+    if (!publish(file_values_, &error)) {
+        // An override accepted earlier stays in force
+        if (previous) {
+            it->second = std::move(*previous);
+        } else {
+            overrides_.erase(it);
+        }
+        logWarn(std::format("Config value {} rejected: {}", key, error));
     }
 }
 
-std::optional<bool> Config::getBool(std::string_view key) const {
-    auto value = get(key);
-    if (!value) {
-        return std::nullopt;
-    }
-    
-    std::string lower = *value;
-    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-    
-    return (lower == "true" || lower == "1" || lower == "yes");
+// ========== HOT RELOAD ==========
+
+void Config::addValidator(Validator validator) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    validators_.push_back(std::move(validator));
 }
 
-void Config::set(std::string_view key, std::string_view value) {
+size_t Config::subscribe(std::vector<std::string> keys, Callback callback) {
     std::lock_guard<std::mutex> lock(mutex_);
-    values_[std::string(key)] = std::string(value);
+    size_t id = next_subscription_++;
+    subscribers_.push_back({id, std::move(keys), std::move(callback)});
+    return id;
+}
+
+void Config::unsubscribe(size_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::erase_if(subscribers_, [id](const Subscription& subscription) { return subscription.id == id; });
+}
+
+void Config::watch(std::chrono::milliseconds interval) {
+    stopWatching();
+
+    std::filesystem::path path;
+    {
+        std::lock_guard<std::mutex> lock(reload_mutex_);
+        path = path_;
+    }
+    if (path.empty()) {
+        logWarn("Config watch: no config file loaded");
+        return;
+    }
+
+    watcher_ = std::jthread([this, path, interval](std::stop_token stop) {
+        std::mutex mutex;
+        std::condition_variable_any wake;
+        std::error_code ec;
+        auto seen = std::filesystem::last_write_time(path, ec);
+
+        while (!stop.stop_requested()) {
+            std::unique_lock lock(mutex);
+            if (wake.wait_for(lock, stop, interval, [] { return false; }) || stop.stop_requested()) {
+                break;
+            }
+            auto modified = std::filesystem::last_write_time(path, ec);
+            if (ec || modified == seen) {
+                continue;
+            }
+
+            seen = modified;
+            
+            // A rejected file is not retried until it changes again
+            std::string error;
+            if (reload(&error)) {
+                logInfo(std::format("Config reloaded from {} (version {})", path.string(), snapshot()->version()));
+            } else {
+                logWarn(std::format("Config not reloaded: {}", error));
+            }
+        }
+    });
+}
+
+void Config::stopWatching() {
+    if (watcher_.joinable()) {
+        watcher_.request_stop();
+        watcher_.join();
+    }
 }
 
 } // namespace frqs::utils
\ No newline at end of file
@@ -0,0 +1,40 @@
+/**
+ * @file utils/cpu_dispatch.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Runtime choice between scalar, SSE2, AVX2 and NEON kernels
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "utils/cpu_dispatch.hpp"
+
+namespace frqs::utils {
+
+namespace {
+
+SimdLevel detectSimdLevel() noexcept {
+#ifdef FRQS_SIMD_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::Avx2 ;
+    }
+#endif
+#if defined(FRQS_SIMD_X86)
+    return SimdLevel::Sse2 ;
+#elif defined(FRQS_SIMD_NEON)
+    return SimdLevel::Neon ;
+#else
+    return SimdLevel::Scalar ;
+#endif
+}
+
+} // namespace
+
+SimdLevel simdLevel() noexcept {
+    static const SimdLevel level = detectSimdLevel() ;
+    return level ;
+}
+
+} // namespace frqs::utils
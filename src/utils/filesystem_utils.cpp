@@ -11,11 +11,232 @@
 
 #include "utils/filesystem_utils.hpp"
 #include <fstream>
-#include <sstream>
 #include <algorithm>
+#include <cerrno>
+#include <utility>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
 
 namespace frqs::utils {
 
+// ========== FILE HANDLE ==========
+
+FileHandle::native_t FileHandle::invalid_handle() noexcept {
+#ifdef _WIN32
+    return INVALID_HANDLE_VALUE ;
+#else
+    return -1 ;
+#endif
+}
+
+std::optional<FileHandle> FileHandle::open(const std::filesystem::path& path) {
+    FileHandle file ;
+    
+#ifdef _WIN32
+    file.handle_ = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                 nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr) ;
+    if (!file.valid()) {
+        return std::nullopt ;
+    }
+    
+    LARGE_INTEGER size ;
+    if (!::GetFileSizeEx(file.handle_, &size)) {
+        return std::nullopt ;
+    }
+    file.size_ = static_cast<uint64_t>(size.QuadPart) ;
+#else
+    file.handle_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC) ;
+    if (!file.valid()) {
+        return std::nullopt ;
+    }
+    
+    struct stat st ;
+    if (::fstat(file.handle_, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return std::nullopt ;
+    }
+    file.size_ = static_cast<uint64_t>(st.st_size) ;
+#endif
+    
+    return file ;
+}
+
+std::optional<FileHandle> FileHandle::create(const std::filesystem::path& path) {
+    FileHandle file ;
+    
+#ifdef _WIN32
+    file.handle_ = ::CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                                 FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr) ;
+#else
+    file.handle_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) ;
+#endif
+    if (!file.valid()) {
+        return std::nullopt ;
+    }
+    
+    return file ;
+}
+
+bool FileHandle::writeAll(const void* data, size_t size) noexcept {
+    auto* bytes = static_cast<const char*>(data) ;
+    
+    while (size > 0) {
+#ifdef _WIN32
+        DWORD written = 0 ;
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 0x7FFFFFFF)) ;
+        if (!::WriteFile(handle_, bytes, chunk, &written, nullptr)) {
+            return false ;
+        }
+#else
+        auto written = ::write(handle_, bytes, size) ;
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue ;
+            }
+            return false ;
+        }
+#endif
+        bytes += written ;
+        size -= static_cast<size_t>(written) ;
+        size_ += static_cast<uint64_t>(written) ;
+    }
+    return true ;
+}
+
+FileHandle::~FileHandle() {
+    close() ;
+}
+
+FileHandle::FileHandle(FileHandle&& other) noexcept
+    : handle_(std::exchange(other.handle_, invalid_handle()))
+    , size_(std::exchange(other.size_, 0)) {}
+
+FileHandle& FileHandle::operator=(FileHandle&& other) noexcept {
+    if (this != &other) {
+        close() ;
+        handle_ = std::exchange(other.handle_, invalid_handle()) ;
+        size_ = std::exchange(other.size_, 0) ;
+    }
+    return *this ;
+}
+
+std::optional<size_t> FileHandle::readAt(uint64_t offset, void* buffer, size_t size) const noexcept {
+#ifdef _WIN32
+    OVERLAPPED ov{} ;
+    ov.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFu) ;
+    ov.OffsetHigh = static_cast<DWORD>(offset >> 32) ;
+    
+    DWORD read = 0 ;
+    DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 0x7FFFFFFF)) ;
+    if (!::ReadFile(handle_, buffer, chunk, &read, &ov)) {
+        return ::GetLastError() == ERROR_HANDLE_EOF ? std::optional<size_t>(0) : std::nullopt ;
+    }
+    return static_cast<size_t>(read) ;
+#else
+    while (true) {
+        auto n = ::pread(handle_, buffer, size, static_cast<off_t>(offset)) ;
+        if (n >= 0) {
+            return static_cast<size_t>(n) ;
+        }
+        if (errno != EINTR) {
+            return std::nullopt ;
+        }
+    }
+#endif
+}
+
+void FileHandle::close() noexcept {
+    if (!valid()) {
+        return ;
+    }
+#ifdef _WIN32
+    ::CloseHandle(handle_) ;
+#else
+    ::close(handle_) ;
+#endif
+    handle_ = invalid_handle() ;
+    size_ = 0 ;
+}
+
+// ========== MAPPED FILE ==========
+
+std::optional<MappedFile> MappedFile::open(const std::filesystem::path& path) {
+    auto file = FileHandle::open(path) ;
+    if (!file) {
+        return std::nullopt ;
+    }
+    
+    MappedFile mapped ;
+    if (file->size() == 0) {
+        return mapped ;  // Nothing to map; bytes() is empty
+    }
+    auto size = static_cast<size_t>(file->size()) ;
+    if (size != file->size()) {
+        return std::nullopt ;  // Larger than the address space (32-bit)
+    }
+    
+#ifdef _WIN32
+    HANDLE mapping = ::CreateFileMappingW(file->native_handle(), nullptr, PAGE_READONLY, 0, 0, nullptr) ;
+    if (!mapping) {
+        return std::nullopt ;
+    }
+    // The view keeps the mapping object alive
+    const void* data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) ;
+    ::CloseHandle(mapping) ;
+    if (!data) {
+        return std::nullopt ;
+    }
+#else
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, file->native_handle(), 0) ;
+    if (data == MAP_FAILED) {
+        return std::nullopt ;
+    }
+#endif
+    
+    // The mapping outlives the descriptor
+    mapped.data_ = data ;
+    mapped.size_ = size ;
+    return mapped ;
+}
+
+MappedFile::~MappedFile() {
+    close() ;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close() ;
+        data_ = std::exchange(other.data_, nullptr) ;
+        size_ = std::exchange(other.size_, 0) ;
+    }
+    return *this ;
+}
+
+void MappedFile::close() noexcept {
+    if (!data_) {
+        return ;
+    }
+#ifdef _WIN32
+    ::UnmapViewOfFile(data_) ;
+#else
+    ::munmap(const_cast<void*>(data_), size_) ;
+#endif
+    data_ = nullptr ;
+    size_ = 0 ;
+}
+
+// ========== PATH UTILITIES ==========
+
 std::optional<std::filesystem::path> FileSystemUtils::securePath(
     const std::filesystem::path& root,
     std::string_view requested_path
@@ -96,9 +317,11 @@ std::optional<std::string> FileSystemUtils::readFile(
             return std::nullopt ;
         }
         
-        std::ostringstream oss ;
-        oss << file.rdbuf() ;
-        return oss.str() ;
+        // Read straight into a string of the right size (no stream copy)
+        std::string content(static_cast<size_t>(file_size), '\0') ;
+        file.read(content.data(), static_cast<std::streamsize>(content.size())) ;
+        content.resize(static_cast<size_t>(file.gcount())) ;
+        return content ;
         
     } catch (const std::filesystem::filesystem_error&) {
         return std::nullopt ;
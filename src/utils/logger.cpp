@@ -1,75 +1,326 @@
 /**
  * @file utils/logger.cpp
  * @author zuudevs (zuudevs@gmail.com)
- * @brief 
- * @version 1.0.0
+ * @brief
+ * @version 1.1.0
  * @date 2025-12-08
- * 
+ *
  * @copyright Copyright (c) 2025
- * 
+ *
  */
 
 #include "utils/logger.hpp"
-#include <iostream>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 namespace frqs::utils {
 
+namespace {
+
+// Messages up to this size are copied into the ring slot without allocating
+constexpr size_t INLINE_TEXT = 200 ;
+
+struct Record {
+    std::chrono::system_clock::time_point time ;
+    Level level = Level::INFO ;
+    uint32_t length = 0 ;
+    char text[INLINE_TEXT] ;
+    std::string long_text ;
+
+    [[nodiscard]] std::string_view message() const noexcept {
+        return length <= INLINE_TEXT ? std::string_view(text, length) : std::string_view(long_text) ;
+    }
+} ;
+
+/**
+ * @brief Single-producer / single-consumer ring owned by one logging thread
+ */
+class Ring {
+public:
+    explicit Ring(size_t capacity) {
+        size_t size = 2 ;
+        while (size < capacity) {
+            size <<= 1 ;
+        }
+        slots_ = std::make_unique<Record[]>(size) ;
+        mask_ = size - 1 ;
+    }
+
+    [[nodiscard]] bool tryPush(Level level, std::string_view message) {
+        size_t tail = tail_.load(std::memory_order_relaxed) ;
+        if (tail - head_.load(std::memory_order_acquire) > mask_) {
+            return false ;
+        }
+
+        Record& slot = slots_[tail & mask_] ;
+        slot.time = std::chrono::system_clock::now() ;
+        slot.level = level ;
+        slot.length = static_cast<uint32_t>(message.size()) ;
+        if (message.size() <= INLINE_TEXT) {
+            std::memcpy(slot.text, message.data(), message.size()) ;
+        } else {
+            slot.long_text.assign(message) ;
+        }
+
+        tail_.store(tail + 1, std::memory_order_release) ;
+        return true ;
+    }
+
+    // Consumer side: hand every published record to `fn`
+    template<typename Fn>
+    void drain(Fn&& fn) {
+        size_t head = head_.load(std::memory_order_relaxed) ;
+        size_t tail = tail_.load(std::memory_order_acquire) ;
+        for (; head != tail ; ++head) {
+            fn(slots_[head & mask_]) ;
+        }
+        head_.store(head, std::memory_order_release) ;
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire) ;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept { return mask_ + 1 ; }
+
+private:
+    std::unique_ptr<Record[]> slots_ ;
+    size_t mask_ = 0 ;
+
+    alignas(64) std::atomic<size_t> head_{0} ;
+    alignas(64) std::atomic<size_t> tail_{0} ;
+} ;
+
+} // namespace
+
 class Logger {
 public:
     static Logger& instance() {
         static Logger logger ;
         return logger ;
     }
-    
+
+    ~Logger() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_) ;
+            stop_ = true ;
+        }
+        wake_.notify_one() ;
+        if (writer_.joinable()) {
+            writer_.join() ;
+        }
+    }
+
     void log(Level level, std::string_view message) {
-        std::lock_guard<std::mutex> lock(mutex_) ;
-        
-        auto log_entry = CreateLog(level, message) ;
-        
-        // Write to console
-        if (level == Level::ERROR) {
-            std::cerr << log_entry << '\n' ;
-        } else {
-            std::cout << log_entry << '\n' ;
+        if (!async_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(output_mutex_) ;
+            write(level, CreateLog(level, message)) ;
+            flushOutputs() ;
+            return ;
         }
-        
-        // Write to file if enabled
-        if (log_file_.is_open()) {
-            log_file_ << log_entry << '\n' ;
-            log_file_.flush() ;
+
+        Ring& ring = localRing() ;
+        while (!ring.tryPush(level, message)) {
+            if (overflow_.load(std::memory_order_relaxed) == OverflowPolicy::Drop) {
+                dropped_.fetch_add(1, std::memory_order_relaxed) ;
+                return ;
+            }
+            wake_.notify_one() ;
+            std::this_thread::yield() ;
+        }
+
+        // Wake the writer early instead of waiting out the interval
+        if (ring.size() == ring.capacity() / 2) {
+            wake_.notify_one() ;
         }
     }
-    
+
     void enableFileLogging(const std::string& filename) {
-        std::lock_guard<std::mutex> lock(mutex_) ;
+        std::lock_guard<std::mutex> lock(output_mutex_) ;
         if (log_file_.is_open()) {
             log_file_.close() ;
         }
         log_file_.open(filename, std::ios::app) ;
     }
-    
+
+    void configure(const LogOptions& options) {
+        detail::min_log_level.store(static_cast<uint8_t>(options.min_level), std::memory_order_relaxed) ;
+        ring_capacity_.store(std::max<size_t>(options.buffer_entries, 2), std::memory_order_relaxed) ;
+        flush_interval_ms_.store(std::max<int64_t>(options.flush_interval.count(), 1), std::memory_order_relaxed) ;
+        overflow_.store(options.overflow, std::memory_order_relaxed) ;
+
+        if (async_.exchange(options.async) && !options.async) {
+            // Leaving async mode: write out what is still queued
+            flush() ;
+        }
+    }
+
+    void flush() {
+        std::unique_lock<std::mutex> lock(wake_mutex_) ;
+        uint64_t ticket = ++flush_requests_ ;
+        wake_.notify_one() ;
+        flushed_cv_.wait(lock, [&] { return flushed_ >= ticket || stop_ ; }) ;
+    }
+
 private:
-    Logger() = default ;
-    std::mutex mutex_ ;
+    Logger() : writer_([this] { writerLoop() ; }) {}
+
+    Ring& localRing() {
+        thread_local std::shared_ptr<Ring> ring ;
+        if (!ring) {
+            ring = std::make_shared<Ring>(ring_capacity_.load(std::memory_order_relaxed)) ;
+            std::lock_guard<std::mutex> lock(rings_mutex_) ;
+            rings_.push_back(ring) ;
+        }
+        return *ring ;
+    }
+
+    void writerLoop() {
+        std::unique_lock<std::mutex> lock(wake_mutex_) ;
+        while (true) {
+            auto interval = std::chrono::milliseconds(flush_interval_ms_.load(std::memory_order_relaxed)) ;
+            wake_.wait_for(lock, interval, [&] { return stop_ || flush_requests_ > flushed_ ; }) ;
+
+            bool stopping = stop_ ;
+            uint64_t ticket = flush_requests_ ;
+
+            lock.unlock() ;
+            writeBatch() ;
+            lock.lock() ;
+
+            flushed_ = ticket ;
+            flushed_cv_.notify_all() ;
+
+            if (stopping) {
+                return ;
+            }
+        }
+    }
+
+    // Drain every ring, order entries by time across threads, write them in one go
+    void writeBatch() {
+        std::vector<std::shared_ptr<Ring>> rings ;
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex_) ;
+            // Rings of exited threads are only referenced here; drop them once empty
+            std::erase_if(rings_, [](const auto& ring) { return ring.use_count() == 1 && ring->size() == 0 ; }) ;
+            rings = rings_ ;
+        }
+
+        batch_.clear() ;
+        for (auto& ring : rings) {
+            ring->drain([this](const Record& record) {
+                batch_.push_back({record.time, record.level, CreateLog(record.level, record.message(), record.time)}) ;
+            }) ;
+        }
+
+        if (auto dropped = dropped_.exchange(0, std::memory_order_relaxed)) {
+            auto now = std::chrono::system_clock::now() ;
+            batch_.push_back({now, Level::WARN,
+                CreateLog(Level::WARN, std::format("Logger dropped {} entries (ring full)", dropped), now)}) ;
+        }
+
+        if (batch_.empty()) {
+            return ;
+        }
+
+        std::stable_sort(batch_.begin(), batch_.end(),
+            [](const Entry& a, const Entry& b) { return a.time < b.time ; }) ;
+
+        std::lock_guard<std::mutex> lock(output_mutex_) ;
+        for (const auto& entry : batch_) {
+            write(entry.level, entry.line) ;
+        }
+        flushOutputs() ;
+    }
+
+    // Caller holds output_mutex_
+    void write(Level level, const std::string& line) {
+        std::FILE* console = level == Level::ERROR ? stderr : stdout ;
+        std::fwrite(line.data(), 1, line.size(), console) ;
+        std::fputc('\n', console) ;
+
+        if (log_file_.is_open()) {
+            log_file_ << line << '\n' ;
+        }
+    }
+
+    void flushOutputs() {
+        std::fflush(stdout) ;
+        std::fflush(stderr) ;
+        if (log_file_.is_open()) {
+            log_file_.flush() ;
+        }
+    }
+
+    struct Entry {
+        std::chrono::system_clock::time_point time ;
+        Level level ;
+        std::string line ;
+    } ;
+
+    // Settings
+    std::atomic<bool> async_{true} ;
+    std::atomic<size_t> ring_capacity_{LogOptions{}.buffer_entries} ;
+    std::atomic<int64_t> flush_interval_ms_{LogOptions{}.flush_interval.count()} ;
+    std::atomic<OverflowPolicy> overflow_{LogOptions{}.overflow} ;
+    std::atomic<uint64_t> dropped_{0} ;
+
+    // Producer rings
+    std::mutex rings_mutex_ ;
+    std::vector<std::shared_ptr<Ring>> rings_ ;
+
+    // Outputs (writer thread, or callers in synchronous mode)
+    std::mutex output_mutex_ ;
     std::ofstream log_file_ ;
+    std::vector<Entry> batch_ ;     // Writer thread only
+
+    // Writer thread signalling
+    std::mutex wake_mutex_ ;
+    std::condition_variable wake_ ;
+    std::condition_variable flushed_cv_ ;
+    uint64_t flush_requests_ = 0 ;
+    uint64_t flushed_ = 0 ;
+    bool stop_ = false ;
+
+    std::thread writer_ ;   // Last: starts after everything above is constructed
 } ;
 
+void logMessage(Level level, std::string_view message) {
+    if (logEnabled(level)) {
+        Logger::instance().log(level, message) ;
+    }
+}
+
 void logInfo(std::string_view message) {
-    Logger::instance().log(Level::INFO, message) ;
+    logMessage(Level::INFO, message) ;
 }
 
 void logWarn(std::string_view message) {
-    Logger::instance().log(Level::WARN, message) ;
+    logMessage(Level::WARN, message) ;
 }
 
 void logError(std::string_view message) {
-    Logger::instance().log(Level::ERROR, message) ;
+    logMessage(Level::ERROR, message) ;
 }
 
 void enableFileLogging(const std::string& filename) {
     Logger::instance().enableFileLogging(filename) ;
 }
 
-} // namespace frqs::utils
\ No newline at end of file
+void configureLogging(const LogOptions& options) {
+    Logger::instance().configure(options) ;
+}
+
+void flushLogs() {
+    Logger::instance().flush() ;
+}
+
+} // namespace frqs::utils
@@ -0,0 +1,149 @@
+/**
+ * @file utils/metrics.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Sharded counters and log-linear latency histograms
+ * @version 1.0.0
+ * @date 2025-12-15
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "utils/metrics.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <format>
+
+namespace frqs::utils {
+
+namespace {
+
+// Standard Prometheus-style latency bounds, in microseconds
+constexpr std::array<uint64_t, 16> EXPORT_BOUNDS_US = {
+    100, 250, 500, 1'000, 2'500, 5'000, 10'000, 25'000, 50'000,
+    100'000, 250'000, 500'000, 1'000'000, 2'500'000, 5'000'000, 10'000'000
+};
+
+void appendNumber(std::string& out, uint64_t value) {
+    char buffer[24];
+    auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    out.append(buffer, end);
+}
+
+void appendSeries(std::string& out, std::string_view name, std::string_view suffix,
+                  std::string_view labels, std::string_view extra_label) {
+    out += name;
+    out += suffix;
+    if (!labels.empty() || !extra_label.empty()) {
+        out += '{';
+        out += labels;
+        if (!labels.empty() && !extra_label.empty()) {
+            out += ',';
+        }
+        out += extra_label;
+        out += '}';
+    }
+    out += ' ';
+}
+
+} // namespace
+
+size_t detail::metricShard() noexcept {
+    static std::atomic<size_t> next{0};
+    thread_local size_t shard = next.fetch_add(1, std::memory_order_relaxed) % METRIC_SHARDS;
+    return shard;
+}
+
+void Counter::writePrometheus(std::string& out, std::string_view name, std::string_view help) const {
+    out += std::format("# HELP {} {}\n# TYPE {} counter\n", name, help, name);
+    out += name;
+    out += ' ';
+    appendNumber(out, value());
+    out += '\n';
+}
+
+uint64_t Histogram::collect(std::array<uint64_t, BUCKETS>& counts) const noexcept {
+    counts.fill(0);
+    for (const auto& shard : shards_) {
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            counts[i] += shard.buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+    uint64_t total = 0;
+    for (uint64_t n : counts) {
+        total += n;
+    }
+    return total;
+}
+
+uint64_t Histogram::count() const noexcept {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        for (const auto& bucket : shard.buckets) {
+            total += bucket.load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+uint64_t Histogram::sumMicros() const noexcept {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.sum.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+uint64_t Histogram::percentile(double q) const noexcept {
+    std::array<uint64_t, BUCKETS> counts;
+    uint64_t total = collect(counts);
+    if (total == 0) {
+        return 0;
+    }
+    
+    q = std::clamp(q, 0.0, 1.0);
+    auto rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(total)));
+    rank = std::max<uint64_t>(rank, 1);
+    
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return bucketMax(i);
+        }
+    }
+    return bucketMax(BUCKETS - 1);
+}
+
+void Histogram::writePrometheus(std::string& out, std::string_view name, std::string_view labels) const {
+    // A bucket counts toward `le` only if every value it can hold is <= le
+    size_t bucket = 0;
+    uint64_t cumulative = 0;
+    std::array<uint64_t, BUCKETS> counts;
+    uint64_t total = collect(counts);
+    
+    for (uint64_t bound : EXPORT_BOUNDS_US) {
+        while (bucket < BUCKETS && bucketMax(bucket) <= bound) {
+            cumulative += counts[bucket++];
+        }
+        appendSeries(out, name, "_bucket", labels, 
+                     std::format("le=\"{}\"", static_cast<double>(bound) / 1e6));
+        appendNumber(out, cumulative);
+        out += '\n';
+    }
+    
+    appendSeries(out, name, "_bucket", labels, "le=\"+Inf\"");
+    appendNumber(out, total);
+    out += '\n';
+    
+    appendSeries(out, name, "_sum", labels, "");
+    out += std::format("{}", static_cast<double>(sumMicros()) / 1e6);
+    out += '\n';
+    
+    appendSeries(out, name, "_count", labels, "");
+    appendNumber(out, total);
+    out += '\n';
+}
+
+} // namespace frqs::utils
@@ -2,7 +2,7 @@
  * @file utils/thread_pool.cpp
  * @author zuudevs (zuudevs@gmail.com)
  * @brief 
- * @version 1.0.0
+ * @version 1.1.0
  * @date 2025-12-08
  * 
  * @copyright Copyright (c) 2025
@@ -10,66 +10,245 @@
  */
 
 #include "utils/thread_pool.hpp"
+#include "utils/logger.hpp"
+#include <algorithm>
+
+#ifdef _WIN32
+    #include <windows.h>
+#elif defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
 
 namespace frqs::utils {
 
-ThreadPool::ThreadPool(size_t num_threads) {
+namespace {
+
+// Which pool the current thread works for, so post() can use its own queue
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local size_t current_index = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t num_threads, bool pin_threads, size_t max_threads)
+    : pin_threads_(pin_threads) {
     if (num_threads == 0) {
         num_threads = 1;
     }
+    if (max_threads == 0) {
+        max_threads = std::max<size_t>(num_threads, std::thread::hardware_concurrency());
+    }
+    max_threads = std::max(max_threads, num_threads);
     
-    workers_.reserve(num_threads);
+    workers_.reserve(max_threads);
+    for (size_t i = 0; i < max_threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
     
+    // Start threads only once every queue exists; workers steal from all of them
+    active_.store(num_threads);
     for (size_t i = 0; i < num_threads; ++i) {
-        workers_.emplace_back([this] { workerThread(); });
+        startWorker(i);
     }
 }
 
 ThreadPool::~ThreadPool() {
     {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
         stop_ = true;
     }
     
     condition_.notify_all();
     
-    for (std::thread& worker : workers_) {
-        if (worker.joinable()) {
-            worker.join();
+    // Workers drain the remaining tasks before exiting
+    std::lock_guard<std::mutex> lock(resize_mutex_);
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
         }
     }
 }
 
-void ThreadPool::workerThread() {
-    while (true) {
-        std::function<void()> task;
-        
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            
-            condition_.wait(lock, [this] {
-                return stop_ || !tasks_.empty();
-            });
+void ThreadPool::startWorker(size_t index) {
+    auto& worker = *workers_[index];
+    worker.state.store(WorkerState::Running);
+    worker.thread = std::thread([this, index] { workerThread(index); });
+}
+
+size_t ThreadPool::resize(size_t num_threads) {
+    std::lock_guard<std::mutex> lock(resize_mutex_);
+    num_threads = std::clamp<size_t>(num_threads, 1, workers_.size());
+    size_t current = active_.load();
+    
+    if (num_threads < current) {
+        // New posts skip the retired queues from here on
+        active_.store(num_threads);
+        for (size_t i = num_threads; i < current; ++i) {
+            workers_[i]->state.store(WorkerState::Retiring);
+        }
+    } else {
+        for (size_t i = current; i < num_threads; ++i) {
+            auto& worker = *workers_[i];
             
-            if (stop_ && tasks_.empty()) {
-                return;
+            // Retired but not gone yet: it simply keeps running
+            auto expected = WorkerState::Retiring;
+            if (worker.state.compare_exchange_strong(expected, WorkerState::Running)) {
+                continue;
             }
-            
-            if (!tasks_.empty()) {
-                task = std::move(tasks_.front());
-                tasks_.pop();
+            if (worker.thread.joinable()) {
+                worker.thread.join();
+            }
+            startWorker(i);
+        }
+        active_.store(num_threads);
+    }
+    
+    // Parked workers re-check whether they were retired
+    {
+        std::lock_guard<std::mutex> sleep_lock(sleep_mutex_);
+        condition_.notify_all();
+    }
+    return num_threads;
+}
+
+void ThreadPool::post(Task task) {
+    // Workers may still post while the destructor drains the queues
+    if (stop_.load(std::memory_order_relaxed) && current_pool != this) {
+        throw std::runtime_error("ThreadPool is stopped");
+    }
+    
+    // Count before publishing so a parked worker never misses the task
+    pending_.fetch_add(1);
+    
+    size_t target = current_pool == this 
+        ? current_index 
+        : next_queue_.fetch_add(1, std::memory_order_relaxed) % active_.load(std::memory_order_relaxed);
+    
+    if (!workers_[target]->queue.tryPush(task)) {
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        overflow_.push_back(std::move(task));
+        overflow_size_.fetch_add(1, std::memory_order_release);
+    }
+    
+    if (sleepers_.load() > 0) {
+        // Taking the lock orders this notify after a sleeper's predicate check
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        condition_.notify_one();
+    }
+}
+
+bool ThreadPool::takeTask(size_t index, Task& task) {
+    if (auto own = workers_[index]->queue.tryPop()) {
+        task = std::move(*own);
+        return true;
+    }
+    
+    if (overflow_size_.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        if (!overflow_.empty()) {
+            task = std::move(overflow_.front());
+            overflow_.pop_front();
+            overflow_size_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    
+    // Steal, starting with the next worker so victims are spread out. Retired
+    // queues are included: a post may have picked one just before resize()
+    for (size_t offset = 1; offset < workers_.size(); ++offset) {
+        size_t victim = (index + offset) % workers_.size();
+        if (auto stolen = workers_[victim]->queue.tryPop()) {
+            task = std::move(*stolen);
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+void ThreadPool::runTask(Task& task) {
+    pending_.fetch_sub(1);
+    try {
+        task();
+    } catch (const std::exception& e) {
+        logError(std::format("Unhandled exception in pool task: {}", e.what()));
+    } catch (...) {
+        logError("Unhandled exception in pool task");
+    }
+}
+
+void ThreadPool::workerThread(size_t index) {
+    current_pool = this;
+    current_index = index;
+    
+    if (pin_threads_) {
+        pinCurrentThread(index);
+    }
+    
+    auto& worker = *workers_[index];
+    int idle_polls = 0;
+    
+    while (true) {
+        if (worker.state.load(std::memory_order_relaxed) == WorkerState::Retiring) {
+            while (auto own = worker.queue.tryPop()) {
+                runTask(*own);
+            }
+            // Unless resize() took it back meanwhile
+            auto expected = WorkerState::Retiring;
+            if (worker.state.compare_exchange_strong(expected, WorkerState::Stopped)) {
+                return;
             }
         }
         
-        if (task) {
-            task();
+        Task task;
+        if (takeTask(index, task)) {
+            idle_polls = 0;
+            runTask(task);
+            continue;
+        }
+        
+        if (++idle_polls < SPIN_LIMIT) {
+            std::this_thread::yield();
+            continue;
         }
+        idle_polls = 0;
+        
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        if (stop_ && pending_.load() == 0) {
+            return;
+        }
+        
+        sleepers_.fetch_add(1);
+        condition_.wait(lock, [this, &worker] {
+            return stop_ || pending_.load() > 0 || worker.state.load() == WorkerState::Retiring;
+        });
+        sleepers_.fetch_sub(1);
     }
 }
 
 size_t ThreadPool::pendingTasks() const noexcept {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    return tasks_.size();
+    return pending_.load(std::memory_order_relaxed);
+}
+
+void ThreadPool::pinCurrentThread(size_t cpu) noexcept {
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    cpu %= cores;
+    
+#ifdef _WIN32
+    if (cpu < sizeof(DWORD_PTR) * 8) {
+        ::SetThreadAffinityMask(::GetCurrentThread(), DWORD_PTR(1) << cpu);
+    }
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) != 0) {
+        logWarn(std::format("Failed to pin worker thread to CPU {}", cpu));
+    }
+#else
+    // No portable affinity API (e.g. macOS); the scheduler decides
+    (void)cpu;
+#endif
 }
 
-} // namespace frqs::utils
\ No newline at end of file
+} // namespace frqs::utils
@@ -0,0 +1,202 @@
+/**
+ * @file utils/timer_wheel.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Hierarchical timer wheel for connection and request timeouts
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "utils/timer_wheel.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace frqs::utils {
+
+TimerWheel::TimerWheel(clock::duration resolution, clock::time_point start) noexcept
+    : resolution_(std::max(resolution, clock::duration(1)))
+    , start_(start) {}
+
+uint64_t TimerWheel::tickAt(clock::time_point time) const noexcept {
+    if (time <= start_) {
+        return 0 ;
+    }
+    return static_cast<uint64_t>((time - start_) / resolution_) ;
+}
+
+uint64_t TimerWheel::tickFor(clock::time_point expires) const noexcept {
+    // Rounded up: the tick is processed only once its whole span has passed
+    if (expires <= start_) {
+        return 0 ;
+    }
+    auto elapsed = expires - start_ ;
+    return static_cast<uint64_t>((elapsed + resolution_ - clock::duration(1)) / resolution_) ;
+}
+
+void TimerWheel::schedule(Timer& timer, clock::time_point expires, void* data) noexcept {
+    if (timer.scheduled()) {
+        unlink(timer) ;
+    }
+    timer.data = data ;
+    timer.tick_ = tickFor(expires) ;
+    insert(timer) ;
+}
+
+void TimerWheel::cancel(Timer& timer) noexcept {
+    if (timer.scheduled()) {
+        unlink(timer) ;
+    }
+}
+
+void TimerWheel::insert(Timer& timer) noexcept {
+    // Overdue timers go in the slot processed next
+    uint64_t delta = timer.tick_ > current_ ? timer.tick_ - current_ : 0 ;
+    uint64_t at = current_ + std::min(delta, SPAN - 1) ;
+    delta = at - current_ ;
+
+    size_t level = 0 ;
+    while (level + 1 < LEVELS && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+        ++level ;
+    }
+    auto slot = static_cast<size_t>((at >> (SLOT_BITS * level)) & SLOT_MASK) ;
+
+    timer.level_ = static_cast<uint8_t>(level) ;
+    timer.slot_ = static_cast<uint8_t>(slot) ;
+    link(slots_[level][slot], timer) ;
+    occupied_[level] |= uint64_t(1) << slot ;
+    ++count_ ;
+}
+
+void TimerWheel::link(Timer*& head, Timer& timer) noexcept {
+    timer.prev_ = nullptr ;
+    timer.next_ = head ;
+    if (head) {
+        head->prev_ = &timer ;
+    }
+    head = &timer ;
+}
+
+void TimerWheel::unlink(Timer& timer) noexcept {
+    if (timer.prev_) {
+        timer.prev_->next_ = timer.next_ ;
+    } else if (timer.level_ == EXPIRING) {
+        expiring_ = timer.next_ ;
+    } else {
+        auto& head = slots_[timer.level_][timer.slot_] ;
+        head = timer.next_ ;
+        if (!head) {
+            occupied_[timer.level_] &= ~(uint64_t(1) << timer.slot_) ;
+        }
+    }
+    if (timer.next_) {
+        timer.next_->prev_ = timer.prev_ ;
+    }
+    timer.prev_ = nullptr ;
+    timer.next_ = nullptr ;
+    timer.level_ = UNLINKED ;
+    --count_ ;
+}
+
+void TimerWheel::cascade(uint64_t tick) noexcept {
+    // Level n's slot comes round when the n levels below wrap to zero
+    for (size_t level = 1 ; level < LEVELS ; ++level) {
+        if ((tick & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) != 0) {
+            break ;
+        }
+        auto slot = static_cast<size_t>((tick >> (SLOT_BITS * level)) & SLOT_MASK) ;
+        Timer* timer = slots_[level][slot] ;
+        slots_[level][slot] = nullptr ;
+        occupied_[level] &= ~(uint64_t(1) << slot) ;
+
+        while (timer) {
+            Timer* next = timer->next_ ;
+            --count_ ;
+            insert(*timer) ;
+            timer = next ;
+        }
+    }
+}
+
+void TimerWheel::collect(uint64_t tick) noexcept {
+    auto slot = static_cast<size_t>(tick & SLOT_MASK) ;
+    Timer* timer = slots_[0][slot] ;
+    if (!timer) {
+        return ;
+    }
+    slots_[0][slot] = nullptr ;
+    occupied_[0] &= ~(uint64_t(1) << slot) ;
+
+    // Callbacks may run between these and cancel any of them
+    Timer* tail = timer ;
+    while (true) {
+        tail->level_ = EXPIRING ;
+        if (!tail->next_) {
+            break ;
+        }
+        tail = tail->next_ ;
+    }
+    tail->next_ = expiring_ ;
+    if (expiring_) {
+        expiring_->prev_ = tail ;
+    }
+    expiring_ = timer ;
+}
+
+std::optional<TimerWheel::clock::time_point> TimerWheel::nextExpiry() const noexcept {
+    if (count_ == 0) {
+        return std::nullopt ;
+    }
+    if (expiring_) {
+        return start_ + static_cast<clock::rep>(current_) * resolution_ ;
+    }
+
+    // Level 0: the timer's own tick. Higher levels: when the slot cascades,
+    // which is no later than any timer in it fires.
+    uint64_t earliest = UINT64_MAX ;
+    for (size_t level = 0 ; level < LEVELS ; ++level) {
+        if (occupied_[level] == 0) {
+            continue ;
+        }
+        unsigned shift = SLOT_BITS * static_cast<unsigned>(level) ;
+        uint64_t block = current_ >> shift ;
+        auto position = static_cast<unsigned>(block & SLOT_MASK) ;
+        uint64_t pending = std::rotr(occupied_[level], static_cast<int>(position)) ;
+
+        // A higher level's current slot has already cascaded unless the
+        // block starts right now; what is left in it is a lap away
+        bool aligned = (current_ & ((uint64_t(1) << shift) - 1)) == 0 ;
+        if (level > 0 && !aligned) {
+            pending &= ~uint64_t(1) ;
+        }
+        uint64_t distance = pending != 0 ? static_cast<uint64_t>(std::countr_zero(pending)) : SLOTS ;
+        uint64_t tick = level == 0 ? current_ + distance : (block + distance) << shift ;
+        earliest = std::min(earliest, tick) ;
+    }
+    return start_ + static_cast<clock::rep>(earliest) * resolution_ ;
+}
+
+void TimerWheel::clear() noexcept {
+    auto release = [](Timer* timer) {
+        while (timer) {
+            Timer* next = timer->next_ ;
+            timer->prev_ = nullptr ;
+            timer->next_ = nullptr ;
+            timer->level_ = UNLINKED ;
+            timer = next ;
+        }
+    } ;
+    for (auto& level : slots_) {
+        for (auto& head : level) {
+            release(head) ;
+            head = nullptr ;
+        }
+    }
+    release(expiring_) ;
+    expiring_ = nullptr ;
+    occupied_ = {} ;
+    count_ = 0 ;
+}
+
+} // namespace frqs::utils
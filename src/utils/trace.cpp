@@ -0,0 +1,131 @@
+/**
+ * @file utils/trace.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief Sampled request phase traces, exported as Chrome trace JSON
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "utils/trace.hpp"
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <unordered_map>
+
+namespace frqs::utils {
+
+namespace {
+
+void appendJsonString(std::string& out, std::string_view text) {
+    out += '"' ;
+    for (char c : text) {
+        switch (c) {
+            case '"':  out += "\\\"" ; break ;
+            case '\\': out += "\\\\" ; break ;
+            case '\n': out += "\\n" ; break ;
+            case '\r': out += "\\r" ; break ;
+            case '\t': out += "\\t" ; break ;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    std::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<unsigned>(c)) ;
+                } else {
+                    out += c ;
+                }
+        }
+    }
+    out += '"' ;
+}
+
+} // namespace
+
+void RequestTracer::configure(uint32_t sample_every, size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    sample_every_ = capacity > 0 ? sample_every : 0 ;
+    capacity_ = capacity ;
+    traces_.clear() ;
+    traces_.shrink_to_fit() ;
+    next_ = 0 ;
+}
+
+bool RequestTracer::sample() noexcept {
+    static thread_local uint32_t countdown = 0 ;
+    if (countdown > 0) {
+        --countdown ;
+        return false ;
+    }
+    countdown = sample_every_ - 1 ;
+    return true ;
+}
+
+void RequestTracer::record(RequestTrace trace) {
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    if (traces_.size() < capacity_) {
+        traces_.push_back(std::move(trace)) ;
+        return ;
+    }
+    traces_[next_] = std::move(trace) ;
+    next_ = (next_ + 1) % capacity_ ;
+}
+
+size_t RequestTracer::size() const {
+    std::lock_guard<std::mutex> lock(mutex_) ;
+    return traces_.size() ;
+}
+
+std::string RequestTracer::renderChromeTrace() const {
+    std::vector<RequestTrace> traces ;
+    {
+        std::lock_guard<std::mutex> lock(mutex_) ;
+        traces.reserve(traces_.size()) ;
+        traces.insert(traces.end(), traces_.begin() + static_cast<ptrdiff_t>(next_), traces_.end()) ;
+        traces.insert(traces.end(), traces_.begin(), traces_.begin() + static_cast<ptrdiff_t>(next_)) ;
+    }
+
+    auto micros = [this](RequestTrace::time_point time) {
+        return std::chrono::duration<double, std::micro>(time - epoch_).count() ;
+    } ;
+
+    // One row per connection, numbered in order of appearance
+    std::unordered_map<uint64_t, size_t> rows ;
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" ;
+    bool first = true ;
+    auto event = [&](std::string_view name, std::string_view category, size_t row,
+                     RequestTrace::time_point begin, RequestTrace::time_point end) {
+        out += first ? "\n" : ",\n" ;
+        first = false ;
+        out += "{\"name\":" ;
+        appendJsonString(out, name) ;
+        std::format_to(std::back_inserter(out),
+                       ",\"cat\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                       category, row, micros(begin), micros(std::max(end, begin)) - micros(begin)) ;
+    } ;
+
+    for (const auto& trace : traces) {
+        auto [it, added] = rows.try_emplace(trace.connection, rows.size() + 1) ;
+        size_t row = it->second ;
+        if (added) {
+            out += first ? "\n" : ",\n" ;
+            first = false ;
+            std::format_to(std::back_inserter(out),
+                           "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                           "\"args\":{{\"name\":\"connection {}\"}}}}", row, row) ;
+        }
+
+        event(trace.name, "request", row, trace.accepted, trace.last_byte) ;
+        if (trace.accepted < trace.first_byte) {
+            event("connect", "phase", row, trace.accepted, trace.first_byte) ;
+        }
+        event("read headers", "phase", row, trace.first_byte, trace.headers_parsed) ;
+        event("read body, queue", "phase", row, trace.headers_parsed, trace.handler_started) ;
+        event("handler", "phase", row, trace.handler_started, trace.handler_finished) ;
+        event("send", "phase", row, trace.handler_finished, trace.last_byte) ;
+    }
+
+    out += "\n]}\n" ;
+    return out ;
+}
+
+} // namespace frqs::utils
@@ -0,0 +1,234 @@
+/**
+ * @file tools/frqs_pack.cpp
+ * @author zuudevs (zuudevs@gmail.com)
+ * @brief frqs_pack: pack a document root into a memory-mappable asset bundle
+ * @version 1.0.0
+ * @date 2025-12-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "plugin/asset_bundle.hpp"
+#include "http/compression.hpp"
+#include "http/date.hpp"
+#include "http/mime_types.hpp"
+#include <charconv>
+#include <cstdio>
+#include <exception>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using namespace frqs;
+
+constexpr std::string_view USAGE = R"(usage:
+  frqs_pack <root> <bundle> [--no-compress] [--min-size=256] [--max-file-size-mb=100]
+      Pack every regular file under <root> into <bundle>, for StaticFilesConfig::bundle
+      (STATIC_BUNDLE in frqs.conf).
+
+      Compressible files of at least --min-size bytes get gzip and brotli variants
+      (from file.gz / file.br siblings if present, else compressed here at the
+      highest level). A variant is kept only if it is smaller than the file.
+      Siblings used as variants are not packed on their own.
+
+      The bundle is written next to <bundle> and renamed over it, so a server
+      that has the old one mapped keeps serving it until it reloads.
+)";
+
+struct Options {
+    std::filesystem::path root;
+    std::filesystem::path bundle;
+    bool compress = true;
+    size_t min_size = 256;
+    uint64_t max_file_size = 100ull * 1024 * 1024;
+};
+
+std::optional<std::string> readAll(const std::filesystem::path& path) {
+    auto file = utils::FileHandle::open(path);
+    if (!file) {
+        return std::nullopt;
+    }
+    std::string content(static_cast<size_t>(file->size()), '\0');
+    size_t done = 0;
+    while (done < content.size()) {
+        auto n = file->readAt(done, content.data() + done, content.size() - done);
+        if (!n) return std::nullopt;
+        if (*n == 0) break;
+        done += *n;
+    }
+    content.resize(done);
+    return content;
+}
+
+// Same tag the plugin computes for files it reads into memory (FNV-1a 64),
+// so clients keep their cached copies when a site moves into a bundle
+std::string contentEtag(std::string_view body) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : body) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return std::format("\"{:016x}\"", hash);
+}
+
+// `file.gz` / `file.br` next to `file`, or a fresh encoding of `identity`
+std::optional<std::string> variantOf(const Options& options, const std::filesystem::path& path,
+                                     std::string_view identity, http::ContentEncoding encoding) {
+    auto sibling = path;
+    sibling += encoding == http::ContentEncoding::Brotli ? ".br" : ".gz";
+
+    std::optional<std::string> body;
+    std::error_code ec;
+    if (std::filesystem::is_regular_file(sibling, ec)) {
+        body = readAll(sibling);
+    } else if (options.compress) {
+        body = http::compress(identity, encoding, encoding == http::ContentEncoding::Brotli ? 11 : 9);
+    }
+    if (body && body->size() >= identity.size()) {
+        return std::nullopt;
+    }
+    return body;
+}
+
+bool isVariantSibling(const std::filesystem::path& path) {
+    auto extension = path.extension();
+    if (extension != ".gz" && extension != ".br") {
+        return false;
+    }
+    std::error_code ec;
+    auto base = path;
+    base.replace_extension();
+    return std::filesystem::is_regular_file(base, ec);
+}
+
+int pack(const Options& options) {
+    plugins::AssetBundleWriter writer;
+    size_t skipped = 0;
+    size_t variants = 0;
+
+    auto root = std::filesystem::canonical(options.root);
+    auto bundle = std::filesystem::weakly_canonical(options.bundle);
+    auto temporary = bundle;
+    temporary += ".tmp";
+
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+        if (!entry.is_regular_file() || isVariantSibling(entry.path())) {
+            continue;
+        }
+        if (entry.path() == bundle || entry.path() == temporary) {
+            continue;  // A bundle written into the root it packs
+        }
+        const auto& path = entry.path();
+        auto relative = path.lexically_relative(root).generic_string();
+
+        if (entry.file_size() > options.max_file_size) {
+            std::fprintf(stderr, "skipped (too large): %s\n", relative.c_str());
+            ++skipped;
+            continue;
+        }
+        auto body = readAll(path);
+        if (!body) {
+            std::fprintf(stderr, "skipped (unreadable): %s\n", relative.c_str());
+            ++skipped;
+            continue;
+        }
+
+        plugins::AssetBundleWriter::File file;
+        file.path = std::move(relative);
+        file.mime_type = http::MimeTypes::fromPath(path);
+
+        auto modified_at = std::chrono::floor<std::chrono::seconds>(
+            std::chrono::file_clock::to_sys(entry.last_write_time()));
+        file.modified_at = modified_at.time_since_epoch().count();
+        file.last_modified = http::formatHttpDate(modified_at);
+
+        auto identity = static_cast<size_t>(http::ContentEncoding::Identity);
+        file.etag[identity] = contentEtag(*body);
+
+        if (body->size() >= options.min_size && http::MimeTypes::isCompressible(file.mime_type)) {
+            for (auto encoding : {http::ContentEncoding::Gzip, http::ContentEncoding::Brotli}) {
+                if (auto variant = variantOf(options, path, *body, encoding)) {
+                    auto index = static_cast<size_t>(encoding);
+                    file.etag[index] = http::encodedEtag(file.etag[identity], encoding);
+                    file.body[index] = std::move(variant);
+                    ++variants;
+                }
+            }
+        }
+
+        file.body[identity] = std::move(body);
+        writer.add(std::move(file));
+    }
+
+    writer.write(options.bundle);
+
+    std::error_code ec;
+    auto size = std::filesystem::file_size(options.bundle, ec);
+    std::printf("%s: %zu files (%llu bytes), %zu precompressed variants, bundle %llu bytes",
+                options.bundle.string().c_str(), writer.size(),
+                static_cast<unsigned long long>(writer.totalBytes()), variants,
+                static_cast<unsigned long long>(size));
+    if (skipped > 0) {
+        std::printf(", %zu skipped", skipped);
+    }
+    std::printf("\n");
+    return 0;
+}
+
+template<typename T>
+bool parseNumber(std::string_view text, T& value) {
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc{} && ptr == text.data() + text.size();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    std::vector<std::string_view> positional;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            std::fputs(USAGE.data(), stdout);
+            return 0;
+        } else if (arg == "--no-compress") {
+            options.compress = false;
+        } else if (arg.starts_with("--min-size=")) {
+            if (!parseNumber(arg.substr(11), options.min_size)) {
+                std::fprintf(stderr, "invalid %s\n", argv[i]);
+                return 2;
+            }
+        } else if (arg.starts_with("--max-file-size-mb=")) {
+            uint64_t mb = 0;
+            if (!parseNumber(arg.substr(19), mb)) {
+                std::fprintf(stderr, "invalid %s\n", argv[i]);
+                return 2;
+            }
+            options.max_file_size = mb * 1024 * 1024;
+        } else if (arg.starts_with("--")) {
+            std::fprintf(stderr, "unknown option %s\n%s", argv[i], USAGE.data());
+            return 2;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.size() != 2) {
+        std::fputs(USAGE.data(), stderr);
+        return 2;
+    }
+    options.root = positional[0];
+    options.bundle = positional[1];
+
+    try {
+        return pack(options);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "frqs_pack: %s\n", e.what());
+        return 1;
+    }
+}